@@ -0,0 +1,1319 @@
+/*****************************************************************************
+ * bench_psi.c: libdvbpsi decoder and encoder benchmarks
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ * Drives synthetic and recorded transport streams through
+ * dvbpsi_packet_push() and reports one line per benchmark:
+ *
+ *   bench=<name> iterations=<n> packets=<n> sections=<n> elapsed_ns=<n>
+ *   pkts_per_sec=<f> sections_per_sec=<f> ns_per_section=<f>
+ *   allocs_per_section=<f|n/a> peak_rss_kb=<n>
+ *
+ * The field set and order are part of the output format; new fields are
+ * only ever appended and the "format=" value of the header line is bumped
+ * when existing fields change meaning.
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/descriptor.h"
+#include "../src/demux.h"
+#include "../src/packetizer.h"
+#include "../src/pipeline.h"
+#include "../src/tables/pat.h"
+#include "../src/tables/pmt.h"
+#include "../src/tables/sdt.h"
+#include "../src/tables/nit.h"
+#include "../src/tables/eit.h"
+#include "../src/descriptors/dr_41.h"
+#include "../src/descriptors/dr_43.h"
+#include "../src/descriptors/dr_48.h"
+#include "../src/descriptors/dr_4d.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/demux.h>
+#include <dvbpsi/packetizer.h>
+#include <dvbpsi/pipeline.h>
+#include <dvbpsi/pat.h>
+#include <dvbpsi/pmt.h>
+#include <dvbpsi/sdt.h>
+#include <dvbpsi/nit.h>
+#include <dvbpsi/eit.h>
+#include <dvbpsi/dr_41.h>
+#include <dvbpsi/dr_43.h>
+#include <dvbpsi/dr_48.h>
+#include <dvbpsi/dr_4d.h>
+#endif
+
+#define BENCH_FORMAT_VERSION 1
+#define TS_PACKET_SIZE       188
+
+/*****************************************************************************
+ * Allocation accounting
+ *****************************************************************************
+ * With glibc the allocator entry points are interposed so every allocation
+ * made by libdvbpsi is counted. Other C libraries, and the builds with the
+ * address sanitizer which interposes them itself, report "n/a". The counter
+ * is updated atomically as some benchmarks allocate from several threads.
+ *****************************************************************************/
+static uint64_t i_alloc_count = 0;
+#define bench_count_alloc() __atomic_fetch_add(&i_alloc_count, 1, __ATOMIC_RELAXED)
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define BENCH_HAVE_ALLOC_COUNT 1
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void  __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+    bench_count_alloc();
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+    bench_count_alloc();
+    return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    bench_count_alloc();
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+#endif
+
+/*****************************************************************************
+ * Benchmark settings
+ *****************************************************************************/
+static uint64_t i_min_time_ns = 500000000ULL; /* -t, per benchmark */
+static const char *psz_filter = NULL;         /* -b, name substring */
+
+static uint64_t bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static long bench_peak_rss(void)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) < 0)
+        return -1;
+    return usage.ru_maxrss; /* kilobytes on Linux */
+}
+
+/*****************************************************************************
+ * TS buffer: sections packetized into 188 byte packets
+ *****************************************************************************/
+typedef struct bench_ts_s
+{
+    uint8_t *p_data;
+    size_t   i_packets;
+    size_t   i_size;
+    size_t   i_sections;
+} bench_ts_t;
+
+static void bench_ts_add_sections(bench_ts_t *p_ts, uint16_t i_pid,
+                                  dvbpsi_psi_section_t *p_sections)
+{
+    size_t i_packets = p_ts->i_packets + dvbpsi_packetizer_count(p_sections, false);
+    dvbpsi_packetizer_t packetizer;
+
+    if (i_packets * TS_PACKET_SIZE > p_ts->i_size)
+    {
+        uint8_t *p_data = realloc(p_ts->p_data, i_packets * TS_PACKET_SIZE);
+        if (!p_data)
+        {
+            fprintf(stderr, "bench: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        p_ts->p_data = p_data;
+        p_ts->i_size = i_packets * TS_PACKET_SIZE;
+    }
+
+    /* continuity counters are rewritten when the packets are pushed */
+    dvbpsi_packetizer_init(&packetizer, i_pid, false);
+    dvbpsi_packetizer_set_sections(&packetizer, p_sections);
+    p_ts->i_packets += dvbpsi_packetize(&packetizer,
+                                        p_ts->p_data + p_ts->i_packets * TS_PACKET_SIZE,
+                                        i_packets - p_ts->i_packets);
+    for (dvbpsi_psi_section_t *p = p_sections; p; p = p->p_next)
+        p_ts->i_sections++;
+}
+
+static void bench_ts_clean(bench_ts_t *p_ts)
+{
+    free(p_ts->p_data);
+    memset(p_ts, 0, sizeof(bench_ts_t));
+}
+
+/*****************************************************************************
+ * Section counting
+ *****************************************************************************
+ * The decoder's gather callback is wrapped so sections reaching the
+ * decoders are counted for recorded streams too. The caller owned p_sys
+ * field of the handle carries the wrapper state.
+ *****************************************************************************/
+typedef struct bench_gather_s
+{
+    dvbpsi_callback_gather_t pf_gather;
+    uint64_t                *pi_sections;
+} bench_gather_t;
+
+static void bench_gather(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t *p_section)
+{
+    bench_gather_t *p_gather = (bench_gather_t *)p_dvbpsi->p_sys;
+    (*p_gather->pi_sections)++;
+    p_gather->pf_gather(p_dvbpsi, p_section);
+}
+
+static void bench_gather_wrap(dvbpsi_t *p_dvbpsi, bench_gather_t *p_gather,
+                              uint64_t *pi_sections)
+{
+    p_gather->pf_gather = p_dvbpsi->p_decoder->pf_gather;
+    p_gather->pi_sections = pi_sections;
+    p_dvbpsi->p_sys = p_gather;
+    p_dvbpsi->p_decoder->pf_gather = bench_gather;
+}
+
+/*****************************************************************************
+ * Runner
+ *****************************************************************************/
+typedef struct bench_count_s
+{
+    uint64_t i_packets;
+    uint64_t i_sections;
+} bench_count_t;
+
+typedef void (*bench_iteration_cb)(void *p_data, bench_count_t *p_count);
+
+static void bench_run(const char *psz_name, bench_iteration_cb pf_iteration,
+                      void *p_data)
+{
+    bench_count_t count = { 0, 0 };
+    uint64_t i_iterations = 0;
+    uint64_t i_start, i_elapsed, i_allocs;
+
+    if (psz_filter && !strstr(psz_name, psz_filter))
+        return;
+
+    /* warm up: first acquisition and allocator caches are not measured */
+    pf_iteration(p_data, &count);
+    count.i_packets = count.i_sections = 0;
+
+    i_allocs = i_alloc_count;
+    i_start = bench_now();
+    do
+    {
+        pf_iteration(p_data, &count);
+        i_iterations++;
+        i_elapsed = bench_now() - i_start;
+    } while (i_elapsed < i_min_time_ns);
+    i_allocs = i_alloc_count - i_allocs;
+
+    double f_sec = (double)i_elapsed / 1e9;
+    printf("bench=%s iterations=%"PRIu64" packets=%"PRIu64" sections=%"PRIu64
+           " elapsed_ns=%"PRIu64" pkts_per_sec=%.0f sections_per_sec=%.0f"
+           " ns_per_section=%.1f",
+           psz_name, i_iterations, count.i_packets, count.i_sections,
+           i_elapsed, (double)count.i_packets / f_sec,
+           (double)count.i_sections / f_sec,
+           count.i_sections ? (double)i_elapsed / (double)count.i_sections : 0.0);
+#ifdef BENCH_HAVE_ALLOC_COUNT
+    printf(" allocs_per_section=%.2f",
+           count.i_sections ? (double)i_allocs / (double)count.i_sections : 0.0);
+#else
+    (void)i_allocs;
+    printf(" allocs_per_section=n/a");
+#endif
+    printf(" peak_rss_kb=%ld\n", bench_peak_rss());
+    fflush(stdout);
+}
+
+/*****************************************************************************
+ * Synthetic tables
+ *****************************************************************************/
+#define BENCH_TSID      0x0001
+#define BENCH_ONID      0x2000
+#define BENCH_SERVICES  200
+#define BENCH_EVENTS    64
+
+static void bench_add_descriptor(dvbpsi_descriptor_t *p_descriptor,
+                                 dvbpsi_descriptor_t *(*pf_add)(void *, uint8_t,
+                                                               uint8_t, uint8_t *),
+                                 void *p_owner)
+{
+    if (p_descriptor)
+    {
+        pf_add(p_owner, p_descriptor->i_tag, p_descriptor->i_length,
+               p_descriptor->p_data);
+        dvbpsi_DeleteDescriptors(p_descriptor);
+    }
+}
+
+static dvbpsi_descriptor_t *sdt_service_dr_add(void *p_owner, uint8_t i_tag,
+                                               uint8_t i_length, uint8_t *p_data)
+{
+    return dvbpsi_sdt_service_descriptor_add(p_owner, i_tag, i_length, p_data);
+}
+
+static dvbpsi_descriptor_t *nit_ts_dr_add(void *p_owner, uint8_t i_tag,
+                                          uint8_t i_length, uint8_t *p_data)
+{
+    return dvbpsi_nit_ts_descriptor_add(p_owner, i_tag, i_length, p_data);
+}
+
+static dvbpsi_descriptor_t *eit_event_dr_add(void *p_owner, uint8_t i_tag,
+                                             uint8_t i_length, uint8_t *p_data)
+{
+    return dvbpsi_eit_event_descriptor_add(p_owner, i_tag, i_length, p_data);
+}
+
+static dvbpsi_pat_t *bench_pat_new(uint8_t i_version)
+{
+    dvbpsi_pat_t *p_pat = dvbpsi_pat_new(BENCH_TSID, i_version, true);
+    for (uint16_t i = 1; i <= BENCH_SERVICES; i++)
+        dvbpsi_pat_program_add(p_pat, i, 0x100 + i);
+    return p_pat;
+}
+
+static dvbpsi_pmt_t *bench_pmt_new(uint8_t i_version)
+{
+    static uint8_t lang[4] = { 'e', 'n', 'g', 0 };
+    dvbpsi_pmt_t *p_pmt = dvbpsi_pmt_new(1, i_version, true, 0x1000);
+    for (uint16_t i = 0; i < 16; i++)
+    {
+        dvbpsi_pmt_es_t *p_es = dvbpsi_pmt_es_add(p_pmt, i ? 0x04 : 0x1b,
+                                                  0x1000 + i);
+        if (i)
+            dvbpsi_pmt_es_descriptor_add(p_es, 0x0a, 4, lang);
+    }
+    return p_pmt;
+}
+
+static dvbpsi_sdt_t *bench_sdt_new(uint8_t i_table_id, uint16_t i_tsid,
+                                   uint8_t i_version)
+{
+    dvbpsi_sdt_t *p_sdt = dvbpsi_sdt_new(i_table_id, i_tsid, i_version, true,
+                                         BENCH_ONID);
+    for (uint16_t i = 1; i <= BENCH_SERVICES; i++)
+    {
+        dvbpsi_service_dr_t service;
+        dvbpsi_sdt_service_t *p_service;
+
+        memset(&service, 0, sizeof(service));
+        service.i_service_type = 0x01;
+        service.i_service_provider_name_length =
+            sprintf((char *)service.i_service_provider_name, "Provider");
+        service.i_service_name_length =
+            sprintf((char *)service.i_service_name, "Service %u", i);
+
+        p_service = dvbpsi_sdt_service_add(p_sdt, i, true, true, 4, false);
+        bench_add_descriptor(dvbpsi_GenServiceDr(&service, false),
+                             sdt_service_dr_add, p_service);
+    }
+    return p_sdt;
+}
+
+static dvbpsi_nit_t *bench_nit_new(uint8_t i_version)
+{
+    dvbpsi_nit_t *p_nit = dvbpsi_nit_new(0x40, BENCH_ONID, BENCH_ONID,
+                                         i_version, true);
+    for (uint16_t i = 1; i <= 64; i++)
+    {
+        dvbpsi_sat_deliv_sys_dr_t deliv;
+        dvbpsi_service_list_dr_t list;
+        dvbpsi_nit_ts_t *p_ts = dvbpsi_nit_ts_add(p_nit, i, BENCH_ONID);
+
+        memset(&deliv, 0, sizeof(deliv));
+        deliv.i_frequency = 0x01170000 + i;
+        deliv.i_orbital_position = 0x0192;
+        deliv.i_west_east_flag = 1;
+        deliv.i_modulation_type = 1;
+        deliv.i_symbol_rate = 0x0275000;
+        deliv.i_fec_inner = 3;
+        bench_add_descriptor(dvbpsi_GenSatDelivSysDr(&deliv, false),
+                             nit_ts_dr_add, p_ts);
+
+        memset(&list, 0, sizeof(list));
+        list.i_service_count = 8;
+        for (int j = 0; j < 8; j++)
+        {
+            list.i_service[j].i_service_id = i * 8 + j;
+            list.i_service[j].i_service_type = 0x01;
+        }
+        bench_add_descriptor(dvbpsi_GenServiceListDr(&list, false),
+                             nit_ts_dr_add, p_ts);
+    }
+    return p_nit;
+}
+
+static dvbpsi_eit_t *bench_eit_new(uint8_t i_table_id, uint16_t i_service_id,
+                                   uint8_t i_version, int i_events)
+{
+    dvbpsi_eit_t *p_eit = dvbpsi_eit_new(i_table_id, i_service_id, i_version,
+                                         true, BENCH_TSID, BENCH_ONID, 0,
+                                         i_table_id);
+    /* from 2026-01-01 00:00:00, one event every 30 minutes */
+    uint16_t i_mjd = 0xEE71;
+
+    for (int i = 0; i < i_events; i++)
+    {
+        dvbpsi_short_event_dr_t event;
+        dvbpsi_eit_event_t *p_event;
+        int i_hour = (i / 2) % 24;
+        uint64_t i_time = ((uint64_t)(i_mjd + i / 48) << 24)
+                        | ((uint64_t)((i_hour / 10) << 4 | (i_hour % 10)) << 16)
+                        | ((i & 1) ? 0x3000 : 0);
+
+        memset(&event, 0, sizeof(event));
+        memcpy(event.i_iso_639_code, "eng", 3);
+        event.i_event_name_length =
+            sprintf((char *)event.i_event_name, "Event %d of service %u",
+                    i, i_service_id);
+        event.i_text_length =
+            sprintf((char *)event.i_text, "A synthetic event used to measure"
+                    " EIT decoding and encoding throughput, number %d.", i);
+
+        p_event = dvbpsi_eit_event_add(p_eit, i + 1, i_time, 0x003000,
+                                       1, false, 0);
+        bench_add_descriptor(dvbpsi_GenShortEventDr(&event, false),
+                             eit_event_dr_add, p_event);
+    }
+    return p_eit;
+}
+
+/*****************************************************************************
+ * Decoder benchmarks
+ *****************************************************************************
+ * Two versions of the same table are packetized and pushed alternately so
+ * every table is fully decoded and delivered instead of being dropped as
+ * an unchanged repetition.
+ *****************************************************************************/
+typedef struct bench_decode_s
+{
+    dvbpsi_t      *p_dvbpsi;
+    bench_gather_t gather;
+    bench_ts_t     ts[2];
+    unsigned int   i_turn;
+    uint8_t        i_cc;
+    uint64_t       i_sections;
+    uint64_t       i_tables;
+} bench_decode_t;
+
+static void bench_decode_iteration(void *p_data, bench_count_t *p_count)
+{
+    bench_decode_t *p_bench = (bench_decode_t *)p_data;
+    bench_ts_t *p_ts = &p_bench->ts[p_bench->i_turn++ & 1];
+    uint8_t *p_packet = p_ts->p_data;
+    uint64_t i_sections = p_bench->i_sections;
+
+    for (size_t i = 0; i < p_ts->i_packets; i++, p_packet += TS_PACKET_SIZE)
+    {
+        p_packet[3] = 0x10 | (p_bench->i_cc++ & 0x0f);
+        dvbpsi_packet_push(p_bench->p_dvbpsi, p_packet);
+    }
+
+    p_count->i_packets += p_ts->i_packets;
+    p_count->i_sections += p_bench->i_sections - i_sections;
+}
+
+static void bench_pat_cb(void *p_data, dvbpsi_pat_t *p_pat)
+{
+    (*(uint64_t *)p_data)++;
+    dvbpsi_pat_delete(p_pat);
+}
+
+static void bench_pmt_cb(void *p_data, dvbpsi_pmt_t *p_pmt)
+{
+    (*(uint64_t *)p_data)++;
+    dvbpsi_pmt_delete(p_pmt);
+}
+
+static void bench_sdt_cb(void *p_data, dvbpsi_sdt_t *p_sdt)
+{
+    (*(uint64_t *)p_data)++;
+    dvbpsi_sdt_delete(p_sdt);
+}
+
+static void bench_nit_cb(void *p_data, dvbpsi_nit_t *p_nit)
+{
+    (*(uint64_t *)p_data)++;
+    dvbpsi_nit_delete(p_nit);
+}
+
+static void bench_eit_cb(void *p_data, dvbpsi_eit_t *p_eit)
+{
+    (*(uint64_t *)p_data)++;
+    dvbpsi_eit_delete(p_eit);
+}
+
+static void bench_new_subtable(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                               uint16_t i_extension, void *p_data)
+{
+    if (i_table_id == 0x42 || i_table_id == 0x46)
+        dvbpsi_sdt_attach(p_dvbpsi, i_table_id, i_extension, bench_sdt_cb, p_data);
+    else if (i_table_id == 0x40 || i_table_id == 0x41)
+        dvbpsi_nit_attach(p_dvbpsi, i_table_id, i_extension, bench_nit_cb, p_data);
+    else if (i_table_id >= 0x4e && i_table_id <= 0x6f)
+        dvbpsi_eit_attach(p_dvbpsi, i_table_id, i_extension, bench_eit_cb, p_data);
+}
+
+static void bench_decode_init(bench_decode_t *p_bench, bool b_demux)
+{
+    memset(p_bench, 0, sizeof(bench_decode_t));
+    p_bench->p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_ERROR);
+    if (!p_bench->p_dvbpsi)
+        exit(EXIT_FAILURE);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    if (b_demux &&
+        !dvbpsi_AttachDemux(p_bench->p_dvbpsi, bench_new_subtable,
+                            &p_bench->i_tables))
+        exit(EXIT_FAILURE);
+#pragma GCC diagnostic pop
+}
+
+static void bench_decode_run(const char *psz_name, bench_decode_t *p_bench)
+{
+    if (p_bench->p_dvbpsi->p_decoder)
+        bench_gather_wrap(p_bench->p_dvbpsi, &p_bench->gather,
+                          &p_bench->i_sections);
+    bench_run(psz_name, bench_decode_iteration, p_bench);
+}
+
+static void bench_decode_clean(bench_decode_t *p_bench, bool b_demux)
+{
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    if (b_demux)
+        dvbpsi_DetachDemux(p_bench->p_dvbpsi);
+#pragma GCC diagnostic pop
+    dvbpsi_delete(p_bench->p_dvbpsi);
+    bench_ts_clean(&p_bench->ts[0]);
+    bench_ts_clean(&p_bench->ts[1]);
+}
+
+static void bench_decode_pat(void)
+{
+    bench_decode_t bench;
+    bench_decode_init(&bench, false);
+    for (int i = 0; i < 2; i++)
+    {
+        dvbpsi_pat_t *p_pat = bench_pat_new(i);
+        dvbpsi_psi_section_t *p_sections =
+            dvbpsi_pat_sections_generate(bench.p_dvbpsi, p_pat, 253);
+        bench_ts_add_sections(&bench.ts[i], 0x00, p_sections);
+        dvbpsi_DeletePSISections(p_sections);
+        dvbpsi_pat_delete(p_pat);
+    }
+    dvbpsi_pat_attach(bench.p_dvbpsi, bench_pat_cb, &bench.i_tables);
+    bench_decode_run("decode_pat", &bench);
+    dvbpsi_pat_detach(bench.p_dvbpsi);
+    bench_decode_clean(&bench, false);
+}
+
+static void bench_decode_pmt(void)
+{
+    bench_decode_t bench;
+    bench_decode_init(&bench, false);
+    for (int i = 0; i < 2; i++)
+    {
+        dvbpsi_pmt_t *p_pmt = bench_pmt_new(i);
+        dvbpsi_psi_section_t *p_sections =
+            dvbpsi_pmt_sections_generate(bench.p_dvbpsi, p_pmt);
+        bench_ts_add_sections(&bench.ts[i], 0x100, p_sections);
+        dvbpsi_DeletePSISections(p_sections);
+        dvbpsi_pmt_delete(p_pmt);
+    }
+    dvbpsi_pmt_attach(bench.p_dvbpsi, 1, bench_pmt_cb, &bench.i_tables);
+    bench_decode_run("decode_pmt", &bench);
+    dvbpsi_pmt_detach(bench.p_dvbpsi);
+    bench_decode_clean(&bench, false);
+}
+
+static void bench_decode_sdt(void)
+{
+    bench_decode_t bench;
+    bench_decode_init(&bench, true);
+    for (int i = 0; i < 2; i++)
+    {
+        dvbpsi_sdt_t *p_sdt = bench_sdt_new(0x42, BENCH_TSID, i);
+        dvbpsi_psi_section_t *p_sections =
+            dvbpsi_sdt_sections_generate(bench.p_dvbpsi, p_sdt);
+        bench_ts_add_sections(&bench.ts[i], 0x11, p_sections);
+        dvbpsi_DeletePSISections(p_sections);
+        dvbpsi_sdt_delete(p_sdt);
+    }
+    bench_decode_run("decode_sdt", &bench);
+    bench_decode_clean(&bench, true);
+}
+
+static void bench_decode_nit(void)
+{
+    bench_decode_t bench;
+    bench_decode_init(&bench, true);
+    for (int i = 0; i < 2; i++)
+    {
+        dvbpsi_nit_t *p_nit = bench_nit_new(i);
+        dvbpsi_psi_section_t *p_sections =
+            dvbpsi_nit_sections_generate(bench.p_dvbpsi, p_nit, 0x40);
+        bench_ts_add_sections(&bench.ts[i], 0x10, p_sections);
+        dvbpsi_DeletePSISections(p_sections);
+        dvbpsi_nit_delete(p_nit);
+    }
+    bench_decode_run("decode_nit", &bench);
+    bench_decode_clean(&bench, true);
+}
+
+static void bench_decode_eit(void)
+{
+    bench_decode_t bench;
+    bench_decode_init(&bench, true);
+    for (int i = 0; i < 2; i++)
+    {
+        dvbpsi_eit_t *p_eit = bench_eit_new(0x50, 1, i, BENCH_EVENTS);
+        dvbpsi_psi_section_t *p_sections =
+            dvbpsi_eit_sections_generate(bench.p_dvbpsi, p_eit, 0x50);
+        bench_ts_add_sections(&bench.ts[i], 0x12, p_sections);
+        dvbpsi_DeletePSISections(p_sections);
+        dvbpsi_eit_delete(p_eit);
+    }
+    bench_decode_run("decode_eit_schedule", &bench);
+    bench_decode_clean(&bench, true);
+}
+
+/* EIT present/following for every service on one PID: exercises the
+ * subtable lookup of the demux with many attached decoders. */
+static void bench_decode_demux(void)
+{
+    bench_decode_t bench;
+    bench_decode_init(&bench, true);
+    for (int i = 0; i < 2; i++)
+    {
+        for (uint16_t i_service = 1; i_service <= BENCH_SERVICES; i_service++)
+        {
+            dvbpsi_eit_t *p_eit = bench_eit_new(0x4e, i_service, i, 2);
+            dvbpsi_psi_section_t *p_sections =
+                dvbpsi_eit_sections_generate(bench.p_dvbpsi, p_eit, 0x4e);
+            bench_ts_add_sections(&bench.ts[i], 0x12, p_sections);
+            dvbpsi_DeletePSISections(p_sections);
+            dvbpsi_eit_delete(p_eit);
+        }
+    }
+    bench_decode_run("decode_demux_eit_pf", &bench);
+    bench_decode_clean(&bench, true);
+}
+
+/*****************************************************************************
+ * Pipeline benchmark
+ *****************************************************************************
+ * PAT and SDT on one worker, EIT present/following of every service on
+ * another one, tables delivered back in stream order. Each iteration is
+ * pushed by 7 packets, as read from UDP, then flushed.
+ *****************************************************************************/
+#define BENCH_PIPELINE_PIDS 3
+
+typedef struct bench_pipeline_s
+{
+    dvbpsi_pipeline_t *p_pipeline;
+    dvbpsi_t          *p_dvbpsi[BENCH_PIPELINE_PIDS];
+    bench_gather_t     gather[BENCH_PIPELINE_PIDS];
+    uint64_t           i_sections[BENCH_PIPELINE_PIDS]; /* one per worker */
+    uint64_t           i_tables;
+    bench_ts_t         ts[2];
+    unsigned int       i_turn;
+    uint8_t            i_cc[0x20];
+} bench_pipeline_t;
+
+static bench_pipeline_t *p_bench_pipeline;
+
+static void bench_deliver_pat(void *p_data, void *p_pat)
+{
+    bench_pat_cb(p_data, p_pat);
+}
+
+static void bench_deliver_sdt(void *p_data, void *p_sdt)
+{
+    bench_sdt_cb(p_data, p_sdt);
+}
+
+static void bench_deliver_eit(void *p_data, void *p_eit)
+{
+    bench_eit_cb(p_data, p_eit);
+}
+
+static void bench_pipeline_pat_cb(void *p_data, dvbpsi_pat_t *p_pat)
+{
+    dvbpsi_pipeline_deliver(p_bench_pipeline->p_pipeline, bench_deliver_pat,
+                            p_data, p_pat);
+}
+
+static void bench_pipeline_sdt_cb(void *p_data, dvbpsi_sdt_t *p_sdt)
+{
+    dvbpsi_pipeline_deliver(p_bench_pipeline->p_pipeline, bench_deliver_sdt,
+                            p_data, p_sdt);
+}
+
+static void bench_pipeline_eit_cb(void *p_data, dvbpsi_eit_t *p_eit)
+{
+    dvbpsi_pipeline_deliver(p_bench_pipeline->p_pipeline, bench_deliver_eit,
+                            p_data, p_eit);
+}
+
+static void bench_pipeline_subtable(dvbpsi_t *p_dvbpsi, uint8_t i_table_id,
+                                    uint16_t i_extension, void *p_data)
+{
+    if (i_table_id == 0x42)
+        dvbpsi_sdt_attach(p_dvbpsi, i_table_id, i_extension,
+                          bench_pipeline_sdt_cb, p_data);
+    else if (i_table_id == 0x4e)
+        dvbpsi_eit_attach(p_dvbpsi, i_table_id, i_extension,
+                          bench_pipeline_eit_cb, p_data);
+}
+
+static void bench_pipeline_iteration(void *p_data, bench_count_t *p_count)
+{
+    bench_pipeline_t *p_bench = (bench_pipeline_t *)p_data;
+    bench_ts_t *p_ts = &p_bench->ts[p_bench->i_turn++ & 1];
+    uint8_t *p_packet = p_ts->p_data;
+    uint64_t i_sections = 0;
+    size_t i;
+
+    for (i = 0; i < p_ts->i_packets; i++, p_packet += TS_PACKET_SIZE)
+        p_packet[3] = 0x10 | (p_bench->i_cc[p_packet[2] & 0x1f]++ & 0x0f);
+
+    for (i = 0; i < p_ts->i_packets; i += 7)
+        dvbpsi_pipeline_push(p_bench->p_pipeline, p_ts->p_data + i * TS_PACKET_SIZE,
+                             p_ts->i_packets - i < 7 ? p_ts->i_packets - i : 7);
+    dvbpsi_pipeline_flush(p_bench->p_pipeline);
+
+    for (i = 0; i < BENCH_PIPELINE_PIDS; i++)
+    {
+        i_sections += p_bench->i_sections[i];
+        p_bench->i_sections[i] = 0;
+    }
+    p_count->i_packets += p_ts->i_packets;
+    p_count->i_sections += i_sections;
+}
+
+static void bench_pipeline(void)
+{
+    static const uint16_t pids[BENCH_PIPELINE_PIDS] = { 0x00, 0x11, 0x12 };
+    long i_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    unsigned int i_workers = i_cpus > 2 ? i_cpus : 2;
+    bench_pipeline_t bench;
+
+    memset(&bench, 0, sizeof(bench));
+    p_bench_pipeline = &bench;
+    bench.p_pipeline = dvbpsi_pipeline_new(i_workers, 0);
+    if (!bench.p_pipeline)
+    {
+        printf("# bench=decode_pipeline skipped: no thread support\n");
+        return;
+    }
+
+    for (int i = 0; i < 2; i++)
+    {
+        dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_ERROR);
+        dvbpsi_pat_t *p_pat = bench_pat_new(i);
+        dvbpsi_sdt_t *p_sdt = bench_sdt_new(0x42, BENCH_TSID, i);
+        dvbpsi_psi_section_t *p_sections;
+
+        p_sections = dvbpsi_pat_sections_generate(p_dvbpsi, p_pat, 253);
+        bench_ts_add_sections(&bench.ts[i], 0x00, p_sections);
+        dvbpsi_DeletePSISections(p_sections);
+        p_sections = dvbpsi_sdt_sections_generate(p_dvbpsi, p_sdt);
+        bench_ts_add_sections(&bench.ts[i], 0x11, p_sections);
+        dvbpsi_DeletePSISections(p_sections);
+        for (uint16_t i_service = 1; i_service <= BENCH_SERVICES; i_service++)
+        {
+            dvbpsi_eit_t *p_eit = bench_eit_new(0x4e, i_service, i, 2);
+            p_sections = dvbpsi_eit_sections_generate(p_dvbpsi, p_eit, 0x4e);
+            bench_ts_add_sections(&bench.ts[i], 0x12, p_sections);
+            dvbpsi_DeletePSISections(p_sections);
+            dvbpsi_eit_delete(p_eit);
+        }
+        dvbpsi_sdt_delete(p_sdt);
+        dvbpsi_pat_delete(p_pat);
+        dvbpsi_delete(p_dvbpsi);
+    }
+
+    for (int i = 0; i < BENCH_PIPELINE_PIDS; i++)
+    {
+        bench.p_dvbpsi[i] = dvbpsi_new(NULL, DVBPSI_MSG_ERROR);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        if (!bench.p_dvbpsi[i] ||
+            (i == 0 ? !dvbpsi_pat_attach(bench.p_dvbpsi[i], bench_pipeline_pat_cb,
+                                         &bench.i_tables)
+                    : !dvbpsi_AttachDemux(bench.p_dvbpsi[i], bench_pipeline_subtable,
+                                          &bench.i_tables)))
+            exit(EXIT_FAILURE);
+#pragma GCC diagnostic pop
+        bench_gather_wrap(bench.p_dvbpsi[i], &bench.gather[i], &bench.i_sections[i]);
+        /* the EIT on its own worker */
+        dvbpsi_pipeline_pid_add(bench.p_pipeline, pids[i], bench.p_dvbpsi[i],
+                                pids[i] == 0x12 ? 1 : 0);
+    }
+
+    bench_run("decode_pipeline", bench_pipeline_iteration, &bench);
+
+    /* flushed by bench_run(), the handles are not used any more */
+    dvbpsi_pipeline_delete(bench.p_pipeline);
+    dvbpsi_pat_detach(bench.p_dvbpsi[0]);
+    for (int i = 0; i < BENCH_PIPELINE_PIDS; i++)
+    {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        if (i)
+            dvbpsi_DetachDemux(bench.p_dvbpsi[i]);
+#pragma GCC diagnostic pop
+        dvbpsi_delete(bench.p_dvbpsi[i]);
+    }
+    bench_ts_clean(&bench.ts[0]);
+    bench_ts_clean(&bench.ts[1]);
+}
+
+/*****************************************************************************
+ * CRC benchmark
+ *****************************************************************************/
+typedef struct bench_crc_s
+{
+    dvbpsi_psi_section_t *p_sections;
+    uint64_t              i_sections;
+    uint64_t              i_valid;
+} bench_crc_t;
+
+static void bench_crc_iteration(void *p_data, bench_count_t *p_count)
+{
+    bench_crc_t *p_bench = (bench_crc_t *)p_data;
+    for (dvbpsi_psi_section_t *p = p_bench->p_sections; p; p = p->p_next)
+        p_bench->i_valid += dvbpsi_ValidPSISection(p);
+    p_count->i_sections += p_bench->i_sections;
+}
+
+static void bench_crc(void)
+{
+    bench_crc_t bench;
+    dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_ERROR);
+    dvbpsi_eit_t *p_eit = bench_eit_new(0x50, 1, 0, BENCH_EVENTS);
+
+    memset(&bench, 0, sizeof(bench));
+    bench.p_sections = dvbpsi_eit_sections_generate(p_dvbpsi, p_eit, 0x50);
+    for (dvbpsi_psi_section_t *p = bench.p_sections; p; p = p->p_next)
+        bench.i_sections++;
+
+    bench_run("crc32_eit_sections", bench_crc_iteration, &bench);
+
+    dvbpsi_DeletePSISections(bench.p_sections);
+    dvbpsi_eit_delete(p_eit);
+    dvbpsi_delete(p_dvbpsi);
+}
+
+/*****************************************************************************
+ * Encoder benchmarks
+ *****************************************************************************/
+typedef enum
+{
+    BENCH_ENCODE_PAT,
+    BENCH_ENCODE_PMT,
+    BENCH_ENCODE_SDT,
+    BENCH_ENCODE_NIT,
+    BENCH_ENCODE_EIT,
+    BENCH_ENCODE_EIT_UPDATE,
+    BENCH_ENCODE_EIT_NETWORK,
+} bench_encode_type_t;
+
+typedef struct bench_encode_s
+{
+    dvbpsi_t           *p_dvbpsi;
+    bench_encode_type_t i_type;
+    void               *p_table;
+
+    /* incremental generation: one event changes per iteration */
+    dvbpsi_sections_cache_t *p_cache;
+    dvbpsi_eit_event_t *p_event;
+
+    /* segmented schedules of every service of a network */
+    dvbpsi_eit_t      **pp_eits;
+    dvbpsi_psi_section_t **pp_sections;
+    unsigned int        i_threads;
+} bench_encode_t;
+
+static void bench_encode_iteration(void *p_data, bench_count_t *p_count)
+{
+    bench_encode_t *p_bench = (bench_encode_t *)p_data;
+    dvbpsi_psi_section_t *p_sections = NULL;
+
+    switch (p_bench->i_type)
+    {
+    case BENCH_ENCODE_PAT:
+        p_sections = dvbpsi_pat_sections_generate(p_bench->p_dvbpsi,
+                                                  p_bench->p_table, 253);
+        break;
+    case BENCH_ENCODE_PMT:
+        p_sections = dvbpsi_pmt_sections_generate(p_bench->p_dvbpsi,
+                                                  p_bench->p_table);
+        break;
+    case BENCH_ENCODE_SDT:
+        p_sections = dvbpsi_sdt_sections_generate(p_bench->p_dvbpsi,
+                                                  p_bench->p_table);
+        break;
+    case BENCH_ENCODE_NIT:
+        p_sections = dvbpsi_nit_sections_generate(p_bench->p_dvbpsi,
+                                                  p_bench->p_table, 0x40);
+        break;
+    case BENCH_ENCODE_EIT:
+        p_sections = dvbpsi_eit_sections_generate(p_bench->p_dvbpsi,
+                                                  p_bench->p_table, 0x50);
+        break;
+    case BENCH_ENCODE_EIT_UPDATE:
+        p_bench->p_event = p_bench->p_event->p_next ? p_bench->p_event->p_next
+                         : ((dvbpsi_eit_t *)p_bench->p_table)->p_first_event;
+        p_bench->p_event->i_duration ^= 0x000100;
+        p_sections = dvbpsi_eit_sections_update(p_bench->p_dvbpsi, p_bench->p_cache,
+                                                p_bench->p_table, 0x50);
+        for (dvbpsi_psi_section_t *p = p_sections; p; p = p->p_next)
+            p_count->i_sections++;
+        return;
+    case BENCH_ENCODE_EIT_NETWORK:
+        if (!dvbpsi_eit_schedules_generate(p_bench->p_dvbpsi, p_bench->pp_eits,
+                                           BENCH_SERVICES, 0x50, 0xEE71,
+                                           p_bench->i_threads, p_bench->pp_sections))
+            exit(EXIT_FAILURE);
+        for (int i = 0; i < BENCH_SERVICES; i++)
+        {
+            for (dvbpsi_psi_section_t *p = p_bench->pp_sections[i]; p; p = p->p_next)
+                p_count->i_sections++;
+            dvbpsi_DeletePSISections(p_bench->pp_sections[i]);
+        }
+        return;
+    }
+
+    for (dvbpsi_psi_section_t *p = p_sections; p; p = p->p_next)
+        p_count->i_sections++;
+    dvbpsi_DeletePSISections(p_sections);
+}
+
+static void bench_encode(void)
+{
+    bench_encode_t bench;
+    bench.p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_ERROR);
+    if (!bench.p_dvbpsi)
+        exit(EXIT_FAILURE);
+
+    bench.i_type = BENCH_ENCODE_PAT;
+    bench.p_table = bench_pat_new(0);
+    bench_run("encode_pat", bench_encode_iteration, &bench);
+    dvbpsi_pat_delete(bench.p_table);
+
+    bench.i_type = BENCH_ENCODE_PMT;
+    bench.p_table = bench_pmt_new(0);
+    bench_run("encode_pmt", bench_encode_iteration, &bench);
+    dvbpsi_pmt_delete(bench.p_table);
+
+    bench.i_type = BENCH_ENCODE_SDT;
+    bench.p_table = bench_sdt_new(0x42, BENCH_TSID, 0);
+    bench_run("encode_sdt", bench_encode_iteration, &bench);
+    dvbpsi_sdt_delete(bench.p_table);
+
+    bench.i_type = BENCH_ENCODE_NIT;
+    bench.p_table = bench_nit_new(0);
+    bench_run("encode_nit", bench_encode_iteration, &bench);
+    dvbpsi_nit_delete(bench.p_table);
+
+    bench.i_type = BENCH_ENCODE_EIT;
+    bench.p_table = bench_eit_new(0x50, 1, 0, BENCH_EVENTS);
+    bench_run("encode_eit_schedule", bench_encode_iteration, &bench);
+
+    /* the same table with one event changed per generation */
+    bench.i_type = BENCH_ENCODE_EIT_UPDATE;
+    bench.p_cache = dvbpsi_sections_cache_new();
+    bench.p_event = ((dvbpsi_eit_t *)bench.p_table)->p_first_event;
+    if (!bench.p_cache ||
+        !dvbpsi_eit_sections_update(bench.p_dvbpsi, bench.p_cache, bench.p_table, 0x50))
+        exit(EXIT_FAILURE);
+    bench_run("encode_eit_schedule_update", bench_encode_iteration, &bench);
+    dvbpsi_sections_cache_delete(bench.p_cache);
+    dvbpsi_eit_delete(bench.p_table);
+
+    /* 8 day segmented schedules of all the services, on one thread then
+     * on one thread per CPU */
+    bench.i_type = BENCH_ENCODE_EIT_NETWORK;
+    bench.pp_eits = malloc(BENCH_SERVICES * sizeof(dvbpsi_eit_t *));
+    bench.pp_sections = malloc(BENCH_SERVICES * sizeof(dvbpsi_psi_section_t *));
+    if (!bench.pp_eits || !bench.pp_sections)
+        exit(EXIT_FAILURE);
+    for (int i = 0; i < BENCH_SERVICES; i++)
+        bench.pp_eits[i] = bench_eit_new(0x50, i + 1, 0, 8 * 48);
+    bench.i_threads = 1;
+    bench_run("encode_eit_network_schedule", bench_encode_iteration, &bench);
+    long i_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    bench.i_threads = i_cpus > 1 ? i_cpus : 1;
+    bench_run("encode_eit_network_schedule_mt", bench_encode_iteration, &bench);
+    for (int i = 0; i < BENCH_SERVICES; i++)
+        dvbpsi_eit_delete(bench.pp_eits[i]);
+    free(bench.pp_eits);
+    free(bench.pp_sections);
+
+    dvbpsi_delete(bench.p_dvbpsi);
+}
+
+/*****************************************************************************
+ * Packetizer benchmarks
+ *****************************************************************************
+ * One full 8 day schedule worth of EIT sections packetized per iteration,
+ * copied into a packet buffer or described as iovecs.
+ *****************************************************************************/
+typedef struct bench_packetize_s
+{
+    dvbpsi_psi_section_t *p_sections;
+    uint64_t              i_sections;
+    size_t                i_packets;
+    uint8_t              *p_packets;
+    dvbpsi_ts_iovec_t    *p_iov;
+    dvbpsi_packetizer_t   packetizer;
+} bench_packetize_t;
+
+static void bench_packetize_iteration(void *p_data, bench_count_t *p_count)
+{
+    bench_packetize_t *p_bench = (bench_packetize_t *)p_data;
+
+    dvbpsi_packetizer_set_sections(&p_bench->packetizer, p_bench->p_sections);
+    if (p_bench->p_iov)
+        p_count->i_packets += dvbpsi_packetize_iovec(&p_bench->packetizer,
+                                                     p_bench->p_iov, p_bench->i_packets);
+    else
+        p_count->i_packets += dvbpsi_packetize(&p_bench->packetizer,
+                                               p_bench->p_packets, p_bench->i_packets);
+    p_count->i_sections += p_bench->i_sections;
+}
+
+static void bench_packetize(void)
+{
+    dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_ERROR);
+    dvbpsi_psi_section_t **pp_last;
+    bench_packetize_t bench;
+
+    memset(&bench, 0, sizeof(bench));
+    pp_last = &bench.p_sections;
+    for (uint16_t i_service = 1; i_service <= 16; i_service++)
+    {
+        dvbpsi_eit_t *p_eit = bench_eit_new(0x50, i_service, 0, BENCH_EVENTS);
+        *pp_last = dvbpsi_eit_sections_generate(p_dvbpsi, p_eit, 0x50);
+        while (*pp_last)
+        {
+            bench.i_sections++;
+            pp_last = &(*pp_last)->p_next;
+        }
+        dvbpsi_eit_delete(p_eit);
+    }
+
+    bench.i_packets = dvbpsi_packetizer_count(bench.p_sections, false);
+    bench.p_packets = malloc(bench.i_packets * TS_PACKET_SIZE);
+    if (!bench.p_packets)
+        exit(EXIT_FAILURE);
+
+    dvbpsi_packetizer_init(&bench.packetizer, 0x12, false);
+    bench_run("packetize_eit", bench_packetize_iteration, &bench);
+
+    dvbpsi_packetizer_init(&bench.packetizer, 0x12, true);
+    bench.i_packets = dvbpsi_packetizer_count(bench.p_sections, true);
+    bench_run("packetize_eit_packed", bench_packetize_iteration, &bench);
+
+    bench.p_iov = malloc(dvbpsi_packetizer_count(bench.p_sections, false)
+                         * sizeof(dvbpsi_ts_iovec_t));
+    if (!bench.p_iov)
+        exit(EXIT_FAILURE);
+    bench.i_packets = dvbpsi_packetizer_count(bench.p_sections, false);
+    bench_run("packetize_eit_iovec", bench_packetize_iteration, &bench);
+
+    free(bench.p_iov);
+    free(bench.p_packets);
+    dvbpsi_DeletePSISections(bench.p_sections);
+    dvbpsi_delete(p_dvbpsi);
+}
+
+/*****************************************************************************
+ * Recorded transport stream
+ *****************************************************************************
+ * The file is loaded in memory once. Each iteration starts from freshly
+ * attached decoders so every table in the recording is acquired, like a
+ * receiver tuning to the multiplex. PMT decoders are attached from the
+ * PAT callback.
+ *****************************************************************************/
+#define BENCH_SI_PIDS 4
+static const uint16_t bench_si_pids[BENCH_SI_PIDS] = { 0x10, 0x11, 0x12, 0x14 };
+
+typedef struct bench_file_s
+{
+    uint8_t       *p_data;
+    size_t         i_packets;
+
+    uint64_t       i_sections;
+    uint64_t       i_tables;
+
+    dvbpsi_t      *p_pat;
+    bench_gather_t pat_gather;
+    dvbpsi_t      *p_si[BENCH_SI_PIDS];
+    bench_gather_t si_gather[BENCH_SI_PIDS];
+    dvbpsi_t      *p_pmt[8192];
+    bench_gather_t pmt_gather[8192];
+} bench_file_t;
+
+static dvbpsi_t *bench_file_handle(bench_file_t *p_bench, uint16_t i_pid)
+{
+    if (i_pid == 0x00)
+        return p_bench->p_pat;
+    for (int i = 0; i < BENCH_SI_PIDS; i++)
+        if (bench_si_pids[i] == i_pid)
+            return p_bench->p_si[i];
+    return p_bench->p_pmt[i_pid];
+}
+
+static void bench_file_pat_cb(void *p_data, dvbpsi_pat_t *p_pat)
+{
+    bench_file_t *p_bench = (bench_file_t *)p_data;
+
+    for (dvbpsi_pat_program_t *p = p_pat->p_first_program; p; p = p->p_next)
+    {
+        if (p->i_number == 0 || p_bench->p_pmt[p->i_pid & 0x1fff])
+            continue;
+
+        dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+        if (!p_dvbpsi)
+            continue;
+        if (!dvbpsi_pmt_attach(p_dvbpsi, p->i_number, bench_pmt_cb,
+                               &p_bench->i_tables))
+        {
+            dvbpsi_delete(p_dvbpsi);
+            continue;
+        }
+        bench_gather_wrap(p_dvbpsi, &p_bench->pmt_gather[p->i_pid & 0x1fff],
+                          &p_bench->i_sections);
+        p_bench->p_pmt[p->i_pid & 0x1fff] = p_dvbpsi;
+    }
+    p_bench->i_tables++;
+    dvbpsi_pat_delete(p_pat);
+}
+
+static void bench_file_iteration(void *p_data, bench_count_t *p_count)
+{
+    bench_file_t *p_bench = (bench_file_t *)p_data;
+    uint64_t i_sections = p_bench->i_sections;
+    uint8_t *p_packet = p_bench->p_data;
+
+    p_bench->p_pat = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+    dvbpsi_pat_attach(p_bench->p_pat, bench_file_pat_cb, p_bench);
+    bench_gather_wrap(p_bench->p_pat, &p_bench->pat_gather, &p_bench->i_sections);
+    for (int i = 0; i < BENCH_SI_PIDS; i++)
+    {
+        p_bench->p_si[i] = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        dvbpsi_AttachDemux(p_bench->p_si[i], bench_new_subtable,
+                           &p_bench->i_tables);
+#pragma GCC diagnostic pop
+        bench_gather_wrap(p_bench->p_si[i], &p_bench->si_gather[i],
+                          &p_bench->i_sections);
+    }
+
+    for (size_t i = 0; i < p_bench->i_packets; i++, p_packet += TS_PACKET_SIZE)
+    {
+        uint16_t i_pid = ((uint16_t)(p_packet[1] & 0x1f) << 8) | p_packet[2];
+        dvbpsi_t *p_dvbpsi = bench_file_handle(p_bench, i_pid);
+        if (p_dvbpsi)
+            dvbpsi_packet_push(p_dvbpsi, p_packet);
+    }
+
+    dvbpsi_pat_detach(p_bench->p_pat);
+    dvbpsi_delete(p_bench->p_pat);
+    p_bench->p_pat = NULL;
+    for (int i = 0; i < BENCH_SI_PIDS; i++)
+    {
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        dvbpsi_DetachDemux(p_bench->p_si[i]);
+#pragma GCC diagnostic pop
+        dvbpsi_delete(p_bench->p_si[i]);
+        p_bench->p_si[i] = NULL;
+    }
+    for (int i = 0; i < 8192; i++)
+    {
+        if (!p_bench->p_pmt[i])
+            continue;
+        dvbpsi_pmt_detach(p_bench->p_pmt[i]);
+        dvbpsi_delete(p_bench->p_pmt[i]);
+        p_bench->p_pmt[i] = NULL;
+    }
+
+    p_count->i_packets += p_bench->i_packets;
+    p_count->i_sections += p_bench->i_sections - i_sections;
+}
+
+static bool bench_file(const char *psz_file)
+{
+    bench_file_t *p_bench = calloc(1, sizeof(bench_file_t));
+    FILE *p_file = fopen(psz_file, "rb");
+    uint8_t packet[TS_PACKET_SIZE];
+    size_t i_size = 0;
+
+    if (!p_bench || !p_file)
+    {
+        fprintf(stderr, "bench: cannot open %s\n", psz_file);
+        free(p_bench);
+        if (p_file)
+            fclose(p_file);
+        return false;
+    }
+
+    /* keep synchronized packets only */
+    while (fread(packet, TS_PACKET_SIZE, 1, p_file) == 1)
+    {
+        if (packet[0] != 0x47)
+            continue;
+        if ((p_bench->i_packets + 1) * TS_PACKET_SIZE > i_size)
+        {
+            i_size = i_size ? i_size * 2 : 1024 * TS_PACKET_SIZE;
+            uint8_t *p_data = realloc(p_bench->p_data, i_size);
+            if (!p_data)
+                break;
+            p_bench->p_data = p_data;
+        }
+        memcpy(p_bench->p_data + p_bench->i_packets++ * TS_PACKET_SIZE,
+               packet, TS_PACKET_SIZE);
+    }
+    fclose(p_file);
+
+    if (p_bench->i_packets)
+        bench_run("file_decode", bench_file_iteration, p_bench);
+
+    free(p_bench->p_data);
+    free(p_bench);
+    return true;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************/
+static void usage(const char *name)
+{
+    printf("Usage: %s [-f file.ts] [-t msec] [-b name] [-s]\n", name);
+    printf("  -f, --file     : also decode a recorded transport stream\n");
+    printf("  -t, --time     : minimum run time of each benchmark in ms (default 500)\n");
+    printf("  -b, --bench    : only run benchmarks whose name contains this string\n");
+    printf("  -s, --skip-synthetic : do not run the synthetic benchmarks\n");
+    printf("  -h, --help     : this help\n");
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option long_options[] =
+    {
+        { "file",           required_argument, NULL, 'f' },
+        { "time",           required_argument, NULL, 't' },
+        { "bench",          required_argument, NULL, 'b' },
+        { "skip-synthetic", no_argument,       NULL, 's' },
+        { "help",           no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char *psz_file = NULL;
+    bool b_synthetic = true;
+    int c;
+
+    while ((c = getopt_long(argc, argv, "f:t:b:sh", long_options, NULL)) != -1)
+    {
+        switch (c)
+        {
+            case 'f':
+                psz_file = optarg;
+                break;
+            case 't':
+                i_min_time_ns = strtoull(optarg, NULL, 0) * 1000000ULL;
+                break;
+            case 'b':
+                psz_filter = optarg;
+                break;
+            case 's':
+                b_synthetic = false;
+                break;
+            case 'h':
+            default:
+                usage(argv[0]);
+                return (c == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    printf("# libdvbpsi bench format=%d version=%s\n",
+           BENCH_FORMAT_VERSION, VERSION);
+
+    if (b_synthetic)
+    {
+        bench_decode_pat();
+        bench_decode_pmt();
+        bench_decode_sdt();
+        bench_decode_nit();
+        bench_decode_eit();
+        bench_decode_demux();
+        bench_pipeline();
+        bench_crc();
+        bench_encode();
+        bench_packetize();
+    }
+
+    if (psz_file && !bench_file(psz_file))
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
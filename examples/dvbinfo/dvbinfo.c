@@ -87,6 +87,8 @@ extern int daemon(int, int);
 #ifdef HAVE_SYS_SOCKET_H
 static const int   i_summary_mode[] = { SUM_BANDWIDTH, SUM_TABLE, SUM_PACKET, SUM_WIRE };
 static const char *psz_summary_mode[] = { "bandwidth", "table", "packet", "wire" };
+static const int   i_summary_format[] = { SUM_FORMAT_TEXT, SUM_FORMAT_JSON };
+static const char *psz_summary_format[] = { "text", "json" };
 #endif
 
 /*****************************************************************************
@@ -107,6 +109,31 @@ typedef struct dvbinfo_capture_s
     bool      b_alive;
 } dvbinfo_capture_t;
 
+/*****************************************************************************
+ * Summary reporter
+ *****************************************************************************
+ * The processing thread publishes statistics snapshots and a reporter thread
+ * writes them out. Three snapshots rotate between both threads: 'back' is
+ * filled by the processing thread, 'front' is written by the reporter and
+ * 'ready' is handed over under lock. The processing thread only uses
+ * pthread_mutex_trylock(), so it never waits for the reporter or file I/O.
+ *****************************************************************************/
+typedef struct dvbinfo_report_s
+{
+    pthread_mutex_t lock;
+    pthread_cond_t  wait;
+    bool     b_alive;
+    bool     b_ready;     /* 'ready' holds a snapshot not yet written */
+    bool     b_pending;   /* 'back' holds a snapshot not yet handed over */
+
+    ts_summary_t *back;   /* owned by processing thread */
+    ts_summary_t *ready;  /* protected by lock */
+    ts_summary_t *front;  /* owned by reporter thread */
+
+    char     *psz_temp;   /* temporary summary file (text format) */
+    params_t *params;
+} dvbinfo_report_t;
+
 /*****************************************************************************
  * Usage
  *****************************************************************************/
@@ -114,7 +141,8 @@ static void usage(void)
 {
 #ifdef HAVE_SYS_SOCKET_H
     printf("Usage: dvbinfo [-h] [-d <debug>] [-f <filename> | -m | -c <bufsize> | [[-u|-t] -a <mcast_interface> -i <ipaddress:port>] -o <outputfile>\n");
-    printf("               [-s [bandwidth|table|packet] --summary-file <file> --summary-period <ms>]\n");
+    printf("               [-s [bandwidth|table|packet] --summary-file <file> --summary-period <ms>\n");
+    printf("                --summary-format [text|json]]\n");
 #else
     printf("Usage: dvbinfo [-h] [-d <debug>] [-f|\n");
 #endif
@@ -139,6 +167,9 @@ static void usage(void)
 //    printf("                         wire = print arrival time per packet (wireshark like)\n");
     printf(" -j | --summary-file   : file to write summary information to (default: stdout)\n");
     printf(" -p | --summary-period : refresh summary file every n milliseconds (default: 1000ms)\n");
+    printf(" -F | --summary-format : summary file format (default: text):\n");
+    printf("                         text = human readable, file is replaced every period\n");
+    printf("                         json = one JSON object per line, appended every period\n");
     printf("\nTuning options: \n");
     printf(" -c | --capture buffer size : number of bytes in capture buffer (default: %d bytes)\n", FIFO_THRESHOLD_SIZE);
 #endif
@@ -208,6 +239,7 @@ static params_t *params_init(void)
     /* statistics */
     param->b_summary = false;
     param->summary.mode = SUM_BANDWIDTH;
+    param->summary.format = SUM_FORMAT_TEXT;
     param->summary.file = NULL;
     param->summary.fd = stdout;
     param->summary.period = 1000; /* in ms */
@@ -349,6 +381,174 @@ static void *dvbinfo_capture(void *data)
     return NULL;
 }
 
+static bool dvbinfo_report_write(dvbinfo_report_t *report, const ts_summary_t *sum)
+{
+    params_t *param = report->params;
+
+    if (param->summary.format == SUM_FORMAT_JSON)
+    {
+        if (param->summary.file && (param->summary.fd == stdout))
+        {
+            param->summary.fd = fopen(param->summary.file, "a");
+            if (param->summary.fd == NULL)
+            {
+                param->summary.fd = stdout;
+                libdvbpsi_log(param, DVBINFO_LOG_ERROR,
+                              "failed opening summary file (disabling summary logging)\n");
+                return false;
+            }
+        }
+        libdvbpsi_summary(param->summary.fd, sum, param->summary.mode, SUM_FORMAT_JSON);
+        fflush(param->summary.fd);
+        return true;
+    }
+
+    if (!param->summary.file)
+    {
+        libdvbpsi_summary(stdout, sum, param->summary.mode, SUM_FORMAT_TEXT);
+        fflush(stdout);
+        return true;
+    }
+
+    FILE *fd = fopen(report->psz_temp, "w+");
+    if (fd == NULL)
+    {
+        libdvbpsi_log(param, DVBINFO_LOG_ERROR,
+                      "failed opening summary file (disabling summary logging)\n");
+        return false;
+    }
+    libdvbpsi_summary(fd, sum, param->summary.mode, SUM_FORMAT_TEXT);
+    fflush(fd);
+    fclose(fd);
+    unlink(param->summary.file);
+    if (rename(report->psz_temp, param->summary.file) < 0)
+    {
+        libdvbpsi_log(param, DVBINFO_LOG_ERROR,
+                      "failed renming summary file (disabling summary logging)\n");
+        return false;
+    }
+    return true;
+}
+
+static void *dvbinfo_report(void *data)
+{
+    dvbinfo_report_t *report = (dvbinfo_report_t *)data;
+    bool b_error = false;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&report->lock);
+        while (!report->b_ready && report->b_alive)
+            pthread_cond_wait(&report->wait, &report->lock);
+        if (!report->b_ready)
+        {
+            pthread_mutex_unlock(&report->lock);
+            break;
+        }
+        ts_summary_t *sum = report->ready;
+        report->ready = report->front;
+        report->front = sum;
+        report->b_ready = false;
+        pthread_mutex_unlock(&report->lock);
+
+        if (!b_error)
+            b_error = !dvbinfo_report_write(report, report->front);
+    }
+    return NULL;
+}
+
+/* Called from the processing thread, never blocks */
+static void dvbinfo_report_publish(dvbinfo_report_t *report, ts_stream_t *stream, mtime_t date)
+{
+    if (!report->b_pending)
+    {
+        libdvbpsi_summary_snapshot(stream, report->back, date);
+        report->b_pending = true;
+    }
+
+    /* reporter is busy swapping, try again after the next buffer */
+    if (pthread_mutex_trylock(&report->lock) != 0)
+        return;
+
+    /* an unwritten snapshot in 'ready' is superseded by this one */
+    ts_summary_t *sum = report->ready;
+    report->ready = report->back;
+    report->back = sum;
+    report->b_ready = true;
+    report->b_pending = false;
+    pthread_cond_signal(&report->wait);
+    pthread_mutex_unlock(&report->lock);
+}
+
+static bool dvbinfo_report_start(dvbinfo_report_t *report, params_t *param, pthread_t *handle)
+{
+    memset(report, 0, sizeof(dvbinfo_report_t));
+    report->params = param;
+    if (param->summary.file &&
+        (asprintf(&report->psz_temp, "%s.part", param->summary.file) < 0))
+    {
+        libdvbpsi_log(param, DVBINFO_LOG_ERROR, "Could not create temporary summary file %s\n",
+                      param->summary.file);
+        return false;
+    }
+
+    report->back = libdvbpsi_summary_new();
+    report->ready = libdvbpsi_summary_new();
+    report->front = libdvbpsi_summary_new();
+    if (!report->back || !report->ready || !report->front)
+        goto error;
+
+    pthread_mutex_init(&report->lock, NULL);
+    pthread_cond_init(&report->wait, NULL);
+    report->b_alive = true;
+    if (pthread_create(handle, NULL, dvbinfo_report, (void *)report) != 0)
+    {
+        pthread_mutex_destroy(&report->lock);
+        pthread_cond_destroy(&report->wait);
+        goto error;
+    }
+    return true;
+
+error:
+    libdvbpsi_log(param, DVBINFO_LOG_ERROR, "failed starting summary reporter\n");
+    libdvbpsi_summary_delete(report->back);
+    libdvbpsi_summary_delete(report->ready);
+    libdvbpsi_summary_delete(report->front);
+    free(report->psz_temp);
+    return false;
+}
+
+/* Hand the last statistics over, the reporter writes them before exiting */
+static void dvbinfo_report_stop(dvbinfo_report_t *report, pthread_t handle, ts_stream_t *stream)
+{
+    libdvbpsi_summary_snapshot(stream, report->back, mdate());
+
+    pthread_mutex_lock(&report->lock);
+    ts_summary_t *sum = report->ready;
+    report->ready = report->back;
+    report->back = sum;
+    report->b_ready = true;
+    report->b_pending = false;
+    report->b_alive = false;
+    pthread_cond_signal(&report->wait);
+    pthread_mutex_unlock(&report->lock);
+
+    if (pthread_join(handle, NULL) != 0)
+        libdvbpsi_log(report->params, DVBINFO_LOG_ERROR, "error joining summary thread\n");
+
+    pthread_mutex_destroy(&report->lock);
+    pthread_cond_destroy(&report->wait);
+
+    libdvbpsi_summary_delete(report->back);
+    libdvbpsi_summary_delete(report->ready);
+    libdvbpsi_summary_delete(report->front);
+    free(report->psz_temp);
+
+    if (report->params->summary.fd != stdout)
+        fclose(report->params->summary.fd);
+    report->params->summary.fd = stdout;
+}
+
 static int dvbinfo_process(dvbinfo_capture_t *capture)
 {
     int err = -1;
@@ -356,23 +556,26 @@ static int dvbinfo_process(dvbinfo_capture_t *capture)
     params_t *param = capture->params;
     buffer_t *buffer = NULL;
 
-    char *psz_temp = NULL;
+    dvbinfo_report_t report;
+    pthread_t report_thread;
+    bool b_report = false;
     mtime_t deadline = 0;
+
+    ts_stream_t *stream = libdvbpsi_init(param->debug, &libdvbpsi_log, (void *)param);
+    if (!stream)
+        goto out;
+
     if (param->b_summary)
     {
-        if (asprintf(&psz_temp, "%s.part", param->summary.file) < 0)
+        b_report = dvbinfo_report_start(&report, param, &report_thread);
+        if (!b_report)
         {
-            libdvbpsi_log(param, DVBINFO_LOG_ERROR, "Could not create temporary summary file %s\n",
-                          param->summary.file);
-            return err;
+            libdvbpsi_exit(stream, true);
+            goto out;
         }
         deadline = mdate() + param->summary.period;
     }
 
-    ts_stream_t *stream = libdvbpsi_init(param->debug, &libdvbpsi_log, (void *)param);
-    if (!stream)
-        goto out;
-
     while (!b_error)
     {
         /* Wait till fifo has emptied */
@@ -404,33 +607,15 @@ static int dvbinfo_process(dvbinfo_capture_t *capture)
         if (!libdvbpsi_process(stream, buffer->p_data, buffer->i_size, buffer->i_date))
             b_error = true;
 
-        /* summary statistics */
-        if (param->b_summary)
+        /* summary statistics: hand a snapshot to the reporter thread */
+        if (b_report)
         {
-            if (mdate() >= deadline)
+            mtime_t now = mdate();
+            if (report.b_pending || (now >= deadline))
             {
-                FILE *fd = fopen(psz_temp, "w+");
-                if (fd)
-                {
-                    libdvbpsi_summary(fd, stream, param->summary.mode);
-                    fflush(fd);
-                    fclose(fd);
-                    unlink(param->summary.file);
-                    int ret = rename(psz_temp, param->summary.file);
-                    if (ret < 0)
-                    {
-                        libdvbpsi_log(param, DVBINFO_LOG_ERROR,
-                                      "failed renming summary file (disabling summary logging)\n");
-                        param->b_summary = false;
-                    }
-                }
-                else
-                {
-                    libdvbpsi_log(param, DVBINFO_LOG_ERROR,
-                                  "failed opening summary file (disabling summary logging)\n");
-                    param->b_summary = false;
-                }
-                deadline = mdate() + param->summary.period;
+                if (!report.b_pending)
+                    deadline = now + param->summary.period;
+                dvbinfo_report_publish(&report, stream, now);
             }
         }
 
@@ -449,7 +634,9 @@ static int dvbinfo_process(dvbinfo_capture_t *capture)
     }
 
     assert(fifo_count(capture->fifo) == 0);
-    libdvbpsi_exit(stream);
+    if (b_report)
+        dvbinfo_report_stop(&report, report_thread, stream);
+    libdvbpsi_exit(stream, !b_report);
     err = 0;
 
 out:
@@ -457,7 +644,6 @@ out:
         libdvbpsi_log(param, DVBINFO_LOG_ERROR, "error while processing\n" );
 
     if (buffer) buffer_free(buffer);
-    free(psz_temp);
     return err;
 }
 
@@ -508,13 +694,14 @@ int main(int argc, char **pp_argv)
         { "summary",        required_argument, NULL, 's' },
         { "summary-file",   required_argument, NULL, 'j' },
         { "summary-period", required_argument, NULL, 'p' },
+        { "summary-format", required_argument, NULL, 'F' },
         /* - tuning options - */
         { "capturesize",    required_argument, NULL, 'c' },
 #endif
         { NULL, 0, NULL, 0 }
     };
 #ifdef HAVE_SYS_SOCKET_H
-    while ((c = getopt_long(argc, pp_argv, "a:c:d:f:i:j:ho:p:ms:tu", long_options, NULL)) != -1)
+    while ((c = getopt_long(argc, pp_argv, "a:c:d:f:F:i:j:ho:p:ms:tu", long_options, NULL)) != -1)
 #else
     while ((c = getopt_long(argc, pp_argv, "d:f:h", long_options, NULL)) != -1)
 #endif
@@ -658,6 +845,30 @@ int main(int argc, char **pp_argv)
                 }
                 break;
 
+            case 'F':
+            {
+                bool b_found = false;
+                if (optarg)
+                {
+                    ssize_t size = ARRAY_SIZE(psz_summary_format);
+                    for (ssize_t i = 0; i < size; i++)
+                    {
+                        if (strcmp(optarg, psz_summary_format[i]) == 0)
+                        {
+                            param->summary.format = i_summary_format[i];
+                            b_found = true;
+                            break;
+                        }
+                    }
+                }
+                if (!b_found)
+                {
+                    fprintf(stderr, "Option --summary-format has invalid content %s\n", optarg);
+                    params_free(param);
+                    usage();
+                }
+                break;
+            }
             case 'p':
                 if (optarg)
                 {
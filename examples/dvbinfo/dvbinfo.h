@@ -60,6 +60,7 @@ typedef struct params_s
     bool b_summary; /* write summary */
     struct summary_s {
         int mode;       /* one of: i_summary_mode */
+        int format;     /* one of: i_summary_format */
         int64_t period; /* summary period in ms */
         char *file;     /* summary file name    */
         FILE *fd;       /* summary file descriptor */
@@ -374,7 +374,7 @@ static void ts_hexdump(FILE *fd, const uint8_t * const data, const uint32_t leng
     }
 }
 
-static void ts_header_dump(FILE *fd, ts_pid_t *ts)
+static void ts_header_dump(FILE *fd, const ts_pid_t *ts)
 {
     fprintf(fd, "\n\tPID 0x%x seen %s\n",
            ts->i_pid, ts->b_seen ? "yes" : "no");
@@ -474,10 +474,92 @@ static void ts_dump_packet_details(FILE *fd, ts_stream_t *stream, const uint8_t
     fprintf(fd, "\n\t---------------------------------------------------------\n");
 }
 
+/*****************************************************************************
+ * Summary snapshot
+ *****************************************************************************
+ * A copy of the statistics which can be written out by another thread while
+ * the packet thread keeps updating ts_stream_t.
+ *****************************************************************************/
+struct ts_summary_s
+{
+    mtime_t     i_date;         /* time the snapshot was taken */
+
+    /* statistics */
+    uint64_t    i_packets;
+    uint64_t    i_null_packets;
+    uint64_t    i_lost_bytes;
+
+    /* tables decoded */
+    bool        b_pat, b_cat, b_sdt, b_eit, b_tdt;
+
+    /* PMT pids */
+    int         i_pmt;
+    uint16_t    pmt[8192];
+
+    /* pid */
+    ts_pid_t    pid[8192];
+};
+
+ts_summary_t *libdvbpsi_summary_new(void)
+{
+    return (ts_summary_t *)calloc(1, sizeof(ts_summary_t));
+}
+
+void libdvbpsi_summary_delete(ts_summary_t *sum)
+{
+    free(sum);
+}
+
+void libdvbpsi_summary_snapshot(ts_stream_t *stream, ts_summary_t *sum, mtime_t date)
+{
+    sum->i_date = date;
+    sum->i_packets = stream->i_packets;
+    sum->i_null_packets = stream->i_null_packets;
+    sum->i_lost_bytes = stream->i_lost_bytes;
+
+    sum->b_pat = stream->pat.handle != NULL;
+    sum->b_cat = stream->cat.handle != NULL;
+    sum->b_sdt = stream->sdt.handle != NULL;
+    sum->b_eit = stream->eit.handle != NULL;
+    sum->b_tdt = stream->tdt.handle != NULL;
+
+    sum->i_pmt = 0;
+    ts_pmt_t *p_pmt = stream->pmt;
+    while (p_pmt && (sum->i_pmt < 8192))
+    {
+        if (p_pmt->handle)
+            sum->pmt[sum->i_pmt++] = p_pmt->pid_pmt->i_pid;
+        p_pmt = p_pmt->p_next;
+    }
+
+    /* the packet summary prints the pids not seen too */
+    memcpy(sum->pid, stream->pid, sizeof(sum->pid));
+}
+
 /*****************************************************************************
  * Summary: Bandwidth, Packet, Table
  *****************************************************************************/
-static void summary(FILE *fd, ts_stream_t *stream)
+static void summary_pcr_range(const ts_summary_t *sum, mtime_t *start, mtime_t *end)
+{
+    /* Find PCR PID and get pcr timestamps */
+    for (int i_pid = 0; i_pid < 8192; i_pid++)
+    {
+        if (sum->pid[i_pid].b_pcr)
+        {
+            *start = sum->pid[i_pid].i_first_pcr;
+            *end = sum->pid[i_pid].i_last_pcr;
+        }
+    }
+}
+
+static double summary_bitrate(const ts_pid_t *ts, mtime_t start, mtime_t end)
+{
+    if ((end - start) > 0)
+        return (double) (ts->i_packets * 188 * 8) / ((double)(end - start)/1000.0);
+    return 0;
+}
+
+static void summary(FILE *fd, const ts_summary_t *sum)
 {
     uint64_t i_packets = 0;
     mtime_t i_first_pcr = 0, i_last_pcr = 0;
@@ -486,40 +568,30 @@ static void summary(FILE *fd, ts_stream_t *stream)
     fprintf(fd, "\n---------------------------------------------------------\n");
     fprintf(fd, "\nSummary: Bandwidth\n");
 
-    /* Find PCR PID and get pcr timestamps */
+    summary_pcr_range(sum, &start, &end);
     for (int i_pid = 0; i_pid < 8192; i_pid++)
     {
-        if (stream->pid[i_pid].b_pcr)
+        if (sum->pid[i_pid].b_pcr && sum->pid[i_pid].b_discontinuity_indicator)
         {
-            start = stream->pid[i_pid].i_first_pcr;
-            end = stream->pid[i_pid].i_last_pcr;
-            if (stream->pid[i_pid].b_discontinuity_indicator)
-            {
-                fprintf(fd, "PCR discontinuity was signalled for PID: %4d (0x%4x)\n",
-                       i_pid, i_pid);
-            }
+            fprintf(fd, "PCR discontinuity was signalled for PID: %4d (0x%4x)\n",
+                   i_pid, i_pid);
         }
     }
 
     for (int i_pid = 0; i_pid < 8192; i_pid++)
     {
-        if (stream->pid[i_pid].b_seen)
+        if (sum->pid[i_pid].b_seen)
         {
             fprintf(fd, "Found PID: %4d (0x%4x), DRM: %s,", i_pid, i_pid,
-                   (stream->pid[i_pid].i_transport_scrambling_control != 0x00) ? "yes" : " no" );
+                   (sum->pid[i_pid].i_transport_scrambling_control != 0x00) ? "yes" : " no" );
 
-            double bitrate = 0;
-            if ((end - start) > 0)
-            {
-                bitrate = (double) (stream->pid[i_pid].i_packets * 188 * 8) /
-                                    ((double)(end - start)/1000.0);
-            }
+            double bitrate = summary_bitrate(&sum->pid[i_pid], start, end);
             fprintf(fd, " bitrate %0.4f kbit/s,", bitrate);
             fprintf(fd, " seen %"PRId64" packets",
-                   stream->pid[i_pid].i_packets);
+                   sum->pid[i_pid].i_packets);
             fprintf(fd, "\n");
 
-            i_packets += stream->pid[i_pid].i_packets;
+            i_packets += sum->pid[i_pid].i_packets;
             if (i_first_pcr == 0)
                 i_first_pcr = start;
             else
@@ -527,63 +599,175 @@ static void summary(FILE *fd, ts_stream_t *stream)
             i_last_pcr = (i_last_pcr > end) ? i_last_pcr : end;
         }
     }
-    double total_bitrate = (double)(((i_packets*188) + stream->i_lost_bytes) * 8)/((double)(i_last_pcr - i_first_pcr)/1000.0);
+    double total_bitrate = (double)(((i_packets*188) + sum->i_lost_bytes) * 8)/((double)(i_last_pcr - i_first_pcr)/1000.0);
     fprintf(fd, "\nTotal bitrate %0.4f kbits/s\n", total_bitrate);
 
     fprintf(fd, "Number of packets: %"PRId64", stuffing %"PRId64" packets, lost %"PRId64" bytes\n",
-            i_packets, stream->i_null_packets, stream->i_lost_bytes);
+            i_packets, sum->i_null_packets, sum->i_lost_bytes);
     fprintf(fd, "PCR first: %"PRId64", last: %"PRId64", duration: %"PRId64"\n",
             i_first_pcr, i_last_pcr, (mtime_t)(i_last_pcr - i_first_pcr));
     fprintf(fd, "\n---------------------------------------------------------\n");
 }
 
-static void summary_table(FILE *fd, ts_stream_t *stream)
+static void summary_table(FILE *fd, const ts_summary_t *sum)
 {
     fprintf(fd, "\n---------------------------------------------------------\n");
     fprintf(fd, "\nSummary: Table\n");
 
     fprintf(fd, "\nTable: PAT\n");
-    if (stream->pat.handle)
-        ts_header_dump(fd, stream->pat.pid);
+    if (sum->b_pat)
+        ts_header_dump(fd, &sum->pid[0x00]);
     fprintf(fd, "\nTable: PMT\n");
-    ts_pmt_t *p_pmt = stream->pmt;
-    while (p_pmt)
-    {
-        if (p_pmt->handle)
-            ts_header_dump(fd, p_pmt->pid_pmt);
-        p_pmt = p_pmt->p_next;
-    }
+    for (int i = 0; i < sum->i_pmt; i++)
+        ts_header_dump(fd, &sum->pid[sum->pmt[i]]);
     fprintf(fd, "\nTable: CAT\n");
-    if (stream->cat.handle)
-        ts_header_dump(fd, stream->cat.pid );
+    if (sum->b_cat)
+        ts_header_dump(fd, &sum->pid[0x01]);
     fprintf(fd, "\nTable: SDT\n");
-    if (stream->sdt.handle)
-        ts_header_dump(fd, stream->sdt.pid);
+    if (sum->b_sdt)
+        ts_header_dump(fd, &sum->pid[0x11]);
     fprintf(fd, "\nTable: EIT\n");
-    if (stream->eit.handle)
-        ts_header_dump(fd, stream->eit.pid);
+    if (sum->b_eit)
+        ts_header_dump(fd, &sum->pid[0x12]);
     fprintf(fd, "\nTable: TDT\n");
-    if (stream->tdt.handle)
-        ts_header_dump(fd, stream->tdt.pid);
+    if (sum->b_tdt)
+        ts_header_dump(fd, &sum->pid[0x14]);
 
     fprintf(fd, "\n---------------------------------------------------------\n");
 }
 
-static void summary_packet(FILE *fd, ts_stream_t *stream)
+static void summary_packet(FILE *fd, const ts_summary_t *sum)
 {
     fprintf(fd, "\n---------------------------------------------------------\n");
     fprintf(fd, "\nSummary: Packet\n");
 
-    /* Find PCR PID and get pcr timestamps */
     for (int i_pid = 0; i_pid < 8192; i_pid++)
     {
-        ts_pid_t *ts = &stream->pid[i_pid];
+        const ts_pid_t *ts = &sum->pid[i_pid];
         ts_header_dump(fd, ts);
     }
 
     fprintf(fd, "\n---------------------------------------------------------\n");
 }
 
+/*****************************************************************************
+ * Summary: JSON lines
+ *****************************************************************************
+ * One JSON object per line and per snapshot, so that the summary file can be
+ * tailed and parsed by monitoring tools.
+ *****************************************************************************/
+#define JSON_BOOL(b) ((b) ? "true" : "false")
+
+static void json_header_dump(FILE *fd, const int i_pid, const ts_pid_t *ts)
+{
+    fprintf(fd, "{\"pid\":%d,\"seen\":%s,\"cc\":%d,\"packets\":%"PRIu64","
+            "\"tei\":%s,\"pusi\":%s,\"scrambling\":%u",
+            i_pid, JSON_BOOL(ts->b_seen), ts->i_cc, ts->i_packets,
+            JSON_BOOL(ts->b_transport_error_indicator),
+            JSON_BOOL(ts->b_payload_unit_start_indicator),
+            ts->i_transport_scrambling_control);
+    fprintf(fd, ",\"received\":%"PRId64, ts->i_received);
+    if (ts->i_prev_received > 0)
+        fprintf(fd, ",\"interval\":%"PRId64, (mtime_t)(ts->i_received - ts->i_prev_received));
+    if (ts->b_adaptation_field)
+    {
+        fprintf(fd, ",\"af\":{\"discontinuity\":%s,\"random_access\":%s,"
+                "\"es_priority\":%s,\"splicing_point\":%s",
+                JSON_BOOL(ts->b_discontinuity_indicator),
+                JSON_BOOL(ts->b_random_access_indicator),
+                JSON_BOOL(ts->b_elementary_stream_priority_indicator),
+                JSON_BOOL(ts->b_splicing_point));
+        if (ts->b_splicing_point)
+            fprintf(fd, ",\"splice_countdown\":%d", ts->i_splice_countdown);
+        if (ts->b_transport_private_data)
+            fprintf(fd, ",\"private_data_length\":%u", ts->i_transport_private_data_length);
+        if (ts->b_pcr)
+            fprintf(fd, ",\"pcr\":%"PRId64, ts->i_pcr);
+        fprintf(fd, "}");
+    }
+    fprintf(fd, "}");
+}
+
+static void json_summary(FILE *fd, const ts_summary_t *sum)
+{
+    uint64_t i_packets = 0;
+    mtime_t start = 0, end = 0;
+    bool b_first = true;
+
+    summary_pcr_range(sum, &start, &end);
+
+    fprintf(fd, "{\"summary\":\"bandwidth\",\"date\":%"PRId64",\"pids\":[", sum->i_date);
+    for (int i_pid = 0; i_pid < 8192; i_pid++)
+    {
+        const ts_pid_t *ts = &sum->pid[i_pid];
+        if (!ts->b_seen)
+            continue;
+
+        fprintf(fd, "%s{\"pid\":%d,\"drm\":%s,\"bitrate\":%0.4f,\"packets\":%"PRIu64"%s}",
+                b_first ? "" : ",", i_pid,
+                JSON_BOOL(ts->i_transport_scrambling_control != 0x00),
+                summary_bitrate(ts, start, end), ts->i_packets,
+                (ts->b_pcr && ts->b_discontinuity_indicator) ? ",\"pcr_discontinuity\":true" : "");
+        b_first = false;
+        i_packets += ts->i_packets;
+    }
+
+    double total_bitrate = 0;
+    if ((end - start) > 0)
+        total_bitrate = (double)(((i_packets*188) + sum->i_lost_bytes) * 8)/((double)(end - start)/1000.0);
+    fprintf(fd, "],\"bitrate\":%0.4f,\"packets\":%"PRIu64",\"stuffing\":%"PRIu64","
+            "\"lost_bytes\":%"PRIu64",\"pcr_first\":%"PRId64",\"pcr_last\":%"PRId64"}\n",
+            total_bitrate, i_packets, sum->i_null_packets, sum->i_lost_bytes, start, end);
+}
+
+static void json_summary_table(FILE *fd, const ts_summary_t *sum)
+{
+    const struct { const char *name; uint16_t i_pid; bool b_present; } tables[] =
+    {
+        { "PAT", 0x00, sum->b_pat }, { "CAT", 0x01, sum->b_cat }, { "SDT", 0x11, sum->b_sdt },
+        { "EIT", 0x12, sum->b_eit }, { "TDT", 0x14, sum->b_tdt }
+    };
+    bool b_first = true;
+
+    fprintf(fd, "{\"summary\":\"table\",\"date\":%"PRId64",\"tables\":[", sum->i_date);
+    for (size_t i = 0; i < ARRAY_SIZE(tables); i++)
+    {
+        if (!tables[i].b_present)
+            continue;
+        fprintf(fd, "%s{\"table\":\"%s\",\"header\":", b_first ? "" : ",", tables[i].name);
+        json_header_dump(fd, tables[i].i_pid, &sum->pid[tables[i].i_pid]);
+        fprintf(fd, "}");
+        b_first = false;
+    }
+    for (int i = 0; i < sum->i_pmt; i++)
+    {
+        fprintf(fd, "%s{\"table\":\"PMT\",\"header\":", b_first ? "" : ",");
+        b_first = false;
+        json_header_dump(fd, sum->pmt[i], &sum->pid[sum->pmt[i]]);
+        fprintf(fd, "}");
+    }
+    fprintf(fd, "]}\n");
+}
+
+static void json_summary_packet(FILE *fd, const ts_summary_t *sum)
+{
+    bool b_first = true;
+
+    fprintf(fd, "{\"summary\":\"packet\",\"date\":%"PRId64",\"pids\":[", sum->i_date);
+    for (int i_pid = 0; i_pid < 8192; i_pid++)
+    {
+        const ts_pid_t *ts = &sum->pid[i_pid];
+        if (!ts->b_seen)
+            continue;
+        if (!b_first)
+            fprintf(fd, ",");
+        json_header_dump(fd, i_pid, ts);
+        b_first = false;
+    }
+    fprintf(fd, "]}\n");
+}
+#undef JSON_BOOL
+
 /*****************************************************************************
  * handle_subtable
  *****************************************************************************/
@@ -2432,9 +2616,15 @@ error:
     return NULL;
 }
 
-void libdvbpsi_exit(ts_stream_t *stream)
+void libdvbpsi_exit(ts_stream_t *stream, bool b_summary)
 {
-   summary(stdout, stream);
+   ts_summary_t *sum = b_summary ? libdvbpsi_summary_new() : NULL;
+   if (sum)
+   {
+       libdvbpsi_summary_snapshot(stream, sum, mdate());
+       summary(stdout, sum);
+       libdvbpsi_summary_delete(sum);
+   }
 
    if (dvbpsi_decoder_present(stream->pat.handle))
        dvbpsi_pat_detach(stream->pat.handle);
@@ -2772,24 +2962,43 @@ dump_packet:
     return true;
 }
 
-void libdvbpsi_summary(FILE *fd, ts_stream_t *stream, const int summary_mode)
+void libdvbpsi_summary(FILE *fd, const ts_summary_t *sum, const int summary_mode,
+                       const int summary_format)
 {
+    if (summary_format == SUM_FORMAT_JSON)
+    {
+        switch(summary_mode)
+        {
+            case SUM_TABLE:
+                json_summary_table(fd, sum);
+                break;
+            case SUM_PACKET:
+                json_summary_packet(fd, sum);
+                break;
+            case SUM_BANDWIDTH:
+            default:
+                json_summary(fd, sum);
+                break;
+        }
+        return;
+    }
+
     switch(summary_mode)
     {
         case SUM_TABLE:
-            summary_table(fd, stream);
+            summary_table(fd, sum);
             break;
         case SUM_PACKET:
-            summary_packet(fd, stream);
+            summary_packet(fd, sum);
             break;
 #if 0
         case SUM_WIRE:
-            summary_wire(fd, stream);
+            summary_wire(fd, sum);
             break;
 #endif
         case SUM_BANDWIDTH:
         default:
-            summary(fd, stream);
+            summary(fd, sum);
             break;
     }
 }
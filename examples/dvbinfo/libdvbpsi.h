@@ -35,14 +35,35 @@ mtime_t mdate(void);
 #define SUM_PACKET    2
 #define SUM_WIRE      3
 
+/* Summary output format */
+#define SUM_FORMAT_TEXT 0
+#define SUM_FORMAT_JSON 1
+
 /* MPEG-TS PSI decoders */
 typedef struct ts_stream_t ts_stream_t;
 typedef void (* ts_stream_log_cb)(void *data, const int level, const char *msg, ...);
 
+/* Statistics snapshot */
+typedef struct ts_summary_s ts_summary_t;
+
 /* */
 ts_stream_t *libdvbpsi_init(int debug, ts_stream_log_cb pf_log, void *cb_data);
 bool libdvbpsi_process(ts_stream_t *stream, uint8_t *buf, ssize_t length, mtime_t date);
-void libdvbpsi_summary(FILE *fd, ts_stream_t *stream, const int summary_mode);
-void libdvbpsi_exit(ts_stream_t *stream);
+/* b_summary: print the bandwidth summary on stdout, when no reporter
+ * thread wrote the last one */
+void libdvbpsi_exit(ts_stream_t *stream, bool b_summary);
+
+/* Summary:
+ * libdvbpsi_summary_new()      - allocate an empty statistics snapshot
+ * libdvbpsi_summary_delete()   - free a statistics snapshot
+ * libdvbpsi_summary_snapshot() - copy current statistics of stream into snapshot,
+ *                                must be called from the thread calling libdvbpsi_process()
+ * libdvbpsi_summary()          - write snapshot to fd, does not touch ts_stream_t
+ */
+ts_summary_t *libdvbpsi_summary_new(void);
+void libdvbpsi_summary_delete(ts_summary_t *sum);
+void libdvbpsi_summary_snapshot(ts_stream_t *stream, ts_summary_t *sum, mtime_t date);
+void libdvbpsi_summary(FILE *fd, const ts_summary_t *sum, const int summary_mode,
+                       const int summary_format);
 
 #endif
@@ -14,7 +14,10 @@
 #include "config.h"
 
 #include &lt;stdio.h&gt;
+#include &lt;stdlib.h&gt;
 #include &lt;stdbool.h&gt;
+#include &lt;string.h&gt;
+#include &lt;time.h&gt;
 
 #if defined(HAVE_INTTYPES_H)
 #include &lt;inttypes.h&gt;
@@ -22,6 +25,8 @@
 #include &lt;stdint.h&gt;
 #endif
 
+#include &lt;sys/types.h&gt;
+
 /* the libdvbpsi distribution defines DVBPSI_DIST */
 #ifdef DVBPSI_DIST
 #include "../src/dvbpsi.h"
@@ -37,12 +42,18 @@
 
   <xsl:apply-templates mode="code" />
 
+static const bozo_roundtrip_t p_roundtrips[] =
+{<xsl:apply-templates mode="table" />
+};
+
 /* main function */
 int main(void)
 {
   int i_err = 0;
   <xsl:apply-templates mode="main" />
 
+  i_err |= bozo_roundtrips(p_roundtrips, sizeof(p_roundtrips) / sizeof(p_roundtrips[0]));
+
   if(i_err)
     fprintf(stderr, "At least one test has FAILED !!!\n");
   else
@@ -74,8 +85,101 @@ static int main_<xsl:value-of select="@sname" />_<xsl:value-of select="@msuffix"
 }
 </xsl:template>
 
+<xsl:template match="roundtrip" mode="code">
+BOZO_ROUNDTRIP<xsl:if test="@duplicate = 'no'">_NODUP</xsl:if>(<xsl:value-of select="@sname" />, <xsl:value-of select="@fname" />)
+static void bozo_layout_<xsl:value-of select="@sname" />(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {<xsl:choose>
+    <xsl:when test="layout">
+      <xsl:for-each select="layout">
+  case <xsl:value-of select="position() - 1" />:<xsl:apply-templates mode="layout" />
+    break;</xsl:for-each>
+    </xsl:when>
+    <xsl:otherwise>
+  case 0:<xsl:apply-templates select="/dr/descriptor[@tag = current()/@tag and @generate = 'yes']/*" mode="layout" />
+    break;</xsl:otherwise>
+  </xsl:choose>
+  }
+}
+</xsl:template>
+
 <xsl:template match="text()" mode="code" priority="-1"/>
 
+<!--                 -->
+<!-- table templates -->
+<!--                 -->
+
+<xsl:template match="roundtrip" mode="table">
+  BOZO_ROUNDTRIP_ENTRY("<xsl:value-of select="@name" />", <xsl:value-of select="@tag" />, <xsl:value-of select="@sname" />, <xsl:choose>
+    <xsl:when test="layout"><xsl:value-of select="count(layout)" /></xsl:when>
+    <xsl:otherwise>1</xsl:otherwise>
+  </xsl:choose>)</xsl:template>
+
+<xsl:template match="text()" mode="table" priority="-1"/>
+
+<!--                  -->
+<!-- layout templates -->
+<!--                  -->
+
+<xsl:template match="integer" mode="layout">
+  <xsl:param name="indent" select="'    '" />
+  <xsl:text>&#10;</xsl:text>
+  <xsl:value-of select="$indent" />bozo_integer(p_w, <xsl:value-of select="@bitcount" />, <xsl:choose>
+    <xsl:when test="@min"><xsl:value-of select="@min" /></xsl:when>
+    <xsl:otherwise>0</xsl:otherwise>
+  </xsl:choose>, <xsl:choose>
+    <xsl:when test="@max"><xsl:value-of select="@max" /></xsl:when>
+    <xsl:otherwise>UINT64_MAX &gt;&gt; <xsl:value-of select="64 - @bitcount" /></xsl:otherwise>
+  </xsl:choose>);</xsl:template>
+
+<xsl:template match="boolean" mode="layout">
+  <xsl:param name="indent" select="'    '" />
+  <xsl:text>&#10;</xsl:text>
+  <xsl:value-of select="$indent" />bozo_integer(p_w, 1, 0, 1);</xsl:template>
+
+<xsl:template match="reserved" mode="layout">
+  <xsl:param name="indent" select="'    '" />
+  <xsl:text>&#10;</xsl:text>
+  <xsl:value-of select="$indent" />bozo_reserved(p_w, <xsl:value-of select="@bitcount" />);</xsl:template>
+
+<xsl:template match="bytes" mode="layout">
+  <xsl:param name="indent" select="'    '" />
+  <xsl:text>&#10;</xsl:text>
+  <xsl:value-of select="$indent" />bozo_bytes(p_w, <xsl:value-of select="@min" />, <xsl:value-of select="@max" />, <xsl:choose>
+    <xsl:when test="@lengthbits"><xsl:value-of select="@lengthbits" /></xsl:when>
+    <xsl:otherwise>0</xsl:otherwise>
+  </xsl:choose>);</xsl:template>
+
+<xsl:template match="loop" mode="layout">
+  <xsl:param name="indent" select="'    '" />
+  <xsl:variable name="i" select="concat('i', count(ancestor::loop))" />
+  <xsl:variable name="lengthbits">
+    <xsl:choose>
+      <xsl:when test="@lengthbits"><xsl:value-of select="@lengthbits" /></xsl:when>
+      <xsl:otherwise>0</xsl:otherwise>
+    </xsl:choose>
+  </xsl:variable>
+  <xsl:variable name="countbits">
+    <xsl:choose>
+      <xsl:when test="@countbits"><xsl:value-of select="@countbits" /></xsl:when>
+      <xsl:otherwise>0</xsl:otherwise>
+    </xsl:choose>
+  </xsl:variable>
+  <xsl:text>&#10;</xsl:text>
+  <xsl:value-of select="$indent" />{
+<xsl:value-of select="$indent" />  unsigned int <xsl:value-of select="$i" />_pos = bozo_begin(p_w, <xsl:value-of select="$lengthbits + $countbits" />);
+<xsl:value-of select="$indent" />  int <xsl:value-of select="$i" />_count = bozo_count(p_w, <xsl:value-of select="@min" />, <xsl:value-of select="@max" />);
+<xsl:value-of select="$indent" />  for(int <xsl:value-of select="$i" /> = 0; <xsl:value-of select="$i" /> &lt; <xsl:value-of select="$i" />_count; <xsl:value-of select="$i" />++)
+<xsl:value-of select="$indent" />  {<xsl:apply-templates mode="layout">
+    <xsl:with-param name="indent" select="concat($indent, '    ')" />
+  </xsl:apply-templates>
+<xsl:value-of select="$indent" />  }
+<xsl:value-of select="$indent" />  bozo_end(p_w, <xsl:value-of select="$i" />_pos, <xsl:value-of select="$lengthbits" />, <xsl:value-of select="$countbits" />, <xsl:value-of select="$i" />_count);
+<xsl:value-of select="$indent" />}</xsl:template>
+
+<xsl:template match="text()" mode="layout" priority="-1"/>
+
 <!--                -->
 <!-- init templates -->
 <!--                -->
@@ -99,7 +203,7 @@ static int main_<xsl:value-of select="@sname" />_<xsl:value-of select="@msuffix"
 <xsl:template match="integer" mode="check">
   /* check <xsl:value-of select="@name" /> */<xsl:apply-templates select=".." mode="init" />
   BOZO_begin_integer(<xsl:value-of select="@name" />, <xsl:value-of select="@bitcount" />)
-    BOZO_DOJOB(<xsl:value-of select="../@fname" />);
+    BOZO_DOJOB<xsl:if test="../@duplicate = 'no'">_NODUP</xsl:if>(<xsl:value-of select="../@fname" />);
     BOZO_check_integer(<xsl:value-of select="@name" />, <xsl:value-of select="@bitcount" />)
     BOZO_CLEAN();
   BOZO_end_integer(<xsl:value-of select="@name" />, <xsl:value-of select="@bitcount" />)
@@ -108,7 +212,7 @@ static int main_<xsl:value-of select="@sname" />_<xsl:value-of select="@msuffix"
 <xsl:template match="boolean" mode="check">
   /* check <xsl:value-of select="@name" /> */<xsl:apply-templates select=".." mode="init" />
   BOZO_begin_boolean(<xsl:value-of select="@name" />)
-    BOZO_DOJOB(<xsl:value-of select="../@fname" />);
+    BOZO_DOJOB<xsl:if test="../@duplicate = 'no'">_NODUP</xsl:if>(<xsl:value-of select="../@fname" />);
     BOZO_check_boolean(<xsl:value-of select="@name" />)
     BOZO_CLEAN();
   BOZO_end_boolean(<xsl:value-of select="@name" />)
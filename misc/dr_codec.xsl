@@ -0,0 +1,344 @@
+<?xml version="1.0" encoding="iso-8859-1" ?>
+<xsl:stylesheet xmlns:xsl="http://www.w3.org/1999/XSL/Transform" version="1.0">
+
+<xsl:output method="text" omit-xml-declaration="yes" indent="no" encoding="iso-8859-1" />
+
+<!--
+  Generates the decoder and the encoder of the descriptors marked with
+  generate="yes" in dr.xml. Their fields, reserved bits included, must
+  describe the whole payload: the code is straight-line, with a single
+  length check, each field being read and written with constant byte
+  offsets, masks and shifts.
+-->
+
+<!--             -->
+<!-- entry point -->
+<!--             -->
+
+<xsl:template match="/dr">/*****************************************************************************
+ * dr_gen.c
+ *
+ * This file is generated by applying the dr_codec.xsl stylesheet to the
+ * dr.xml description file. DO NOT EDIT !!!
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include &lt;stdio.h&gt;
+#include &lt;stdlib.h&gt;
+#include &lt;stdbool.h&gt;
+#include &lt;string.h&gt;
+
+#if defined(HAVE_INTTYPES_H)
+#include &lt;inttypes.h&gt;
+#elif defined(HAVE_STDINT_H)
+#include &lt;stdint.h&gt;
+#endif
+
+#include "../dvbpsi.h"
+#include "../dvbpsi_private.h"
+#include "../descriptor.h"
+<xsl:for-each select="descriptor[@generate = 'yes']">
+#include "dr_<xsl:value-of select="substring(@tag, 3)" />.h"</xsl:for-each>
+<xsl:text>
+</xsl:text>
+  <xsl:apply-templates select="descriptor[@generate = 'yes']" mode="code" />
+</xsl:template>
+
+<!--                -->
+<!-- code templates -->
+<!--                -->
+
+<xsl:template match="descriptor" mode="code">
+  <xsl:variable name="type" select="concat('dvbpsi_', @sname, '_dr_t')" />
+  <xsl:variable name="bits" select="sum(integer/@bitcount) + sum(reserved/@bitcount) + count(boolean)" />
+  <xsl:if test="$bits != 8 * @length">
+    <xsl:message terminate="yes">
+      <xsl:value-of select="@name" /> descriptor: <xsl:value-of select="$bits" /> bits for <xsl:value-of select="@length" /> bytes
+    </xsl:message>
+  </xsl:if>
+/*****************************************************************************
+ * dvbpsi_Decode<xsl:value-of select="@fname" />Dr
+ *****************************************************************************/
+<xsl:value-of select="$type" /> * dvbpsi_Decode<xsl:value-of select="@fname" />Dr(dvbpsi_descriptor_t * p_descriptor)
+{
+    <xsl:value-of select="$type" /> * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, <xsl:value-of select="@tag" />))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != <xsl:value-of select="@length" />)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (<xsl:value-of select="$type" />*)malloc(sizeof(<xsl:value-of select="$type" />));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;<xsl:apply-templates select="integer | boolean" mode="decode" />
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_Gen<xsl:value-of select="@fname" />Dr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_Gen<xsl:value-of select="@fname" />Dr(<xsl:value-of select="$type" /> * p_decoded<xsl:if test="not(@duplicate = 'no')">, bool b_duplicate</xsl:if>)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(<xsl:value-of select="@tag" />, <xsl:value-of select="@length" />, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;<xsl:call-template name="encode-bytes">
+      <xsl:with-param name="k" select="0" />
+    </xsl:call-template>
+<xsl:text>
+</xsl:text>
+<xsl:if test="not(@duplicate = 'no')">
+    if (b_duplicate)
+    {
+        /* Duplicate decoded data */
+        p_descriptor->p_decoded =
+                dvbpsi_DuplicateDecodedDescriptor(p_decoded,
+                                                  sizeof(<xsl:value-of select="$type" />));
+    }
+</xsl:if>
+    return p_descriptor;
+}
+</xsl:template>
+
+<!--                  -->
+<!-- decode templates -->
+<!--                  -->
+
+<xsl:template match="boolean" mode="decode">
+  <xsl:variable name="o">
+    <xsl:call-template name="offset" />
+  </xsl:variable>
+    p_decoded-&gt;<xsl:value-of select="@name" /> = (p_data[<xsl:value-of select="floor($o div 8)" />] &amp; <xsl:call-template name="hex">
+      <xsl:with-param name="v">
+        <xsl:call-template name="pow2"><xsl:with-param name="n" select="7 - $o mod 8" /></xsl:call-template>
+      </xsl:with-param>
+    </xsl:call-template>) ? true : false;</xsl:template>
+
+<xsl:template match="integer" mode="decode">
+  <xsl:variable name="o">
+    <xsl:call-template name="offset" />
+  </xsl:variable>
+  <xsl:variable name="n" select="@bitcount" />
+  <xsl:variable name="f" select="floor($o div 8)" />
+  <xsl:variable name="l" select="floor(($o + $n - 1) div 8)" />
+  <xsl:variable name="s" select="7 - ($o + $n - 1) mod 8" />
+    p_decoded-&gt;<xsl:value-of select="@name" /> = <xsl:choose>
+    <xsl:when test="$f = $l">
+      <xsl:variable name="m">
+        <xsl:call-template name="pow2"><xsl:with-param name="n" select="$n" /></xsl:call-template>
+      </xsl:variable>
+      <xsl:variable name="ps">
+        <xsl:call-template name="pow2"><xsl:with-param name="n" select="$s" /></xsl:call-template>
+      </xsl:variable>
+      <xsl:choose>
+        <xsl:when test="$n = 8">p_data[<xsl:value-of select="$f" />]</xsl:when>
+        <xsl:when test="$s = 0">p_data[<xsl:value-of select="$f" />] &amp; <xsl:call-template name="hex"><xsl:with-param name="v" select="$m - 1" /></xsl:call-template></xsl:when>
+        <xsl:otherwise>(p_data[<xsl:value-of select="$f" />] &amp; <xsl:call-template name="hex"><xsl:with-param name="v" select="($m - 1) * $ps" /></xsl:call-template>) &gt;&gt; <xsl:value-of select="$s" /></xsl:otherwise>
+      </xsl:choose>
+    </xsl:when>
+    <xsl:otherwise>
+      <xsl:call-template name="decode-bytes">
+        <xsl:with-param name="b" select="$f" />
+        <xsl:with-param name="f" select="$f" />
+        <xsl:with-param name="l" select="$l" />
+        <xsl:with-param name="o" select="$o" />
+        <xsl:with-param name="s" select="$s" />
+        <xsl:with-param name="ctype">
+          <xsl:choose>
+            <xsl:when test="$n &gt; 32">uint64_t</xsl:when>
+            <xsl:otherwise>uint32_t</xsl:otherwise>
+          </xsl:choose>
+        </xsl:with-param>
+      </xsl:call-template>
+    </xsl:otherwise>
+  </xsl:choose>;</xsl:template>
+
+<!-- one term per byte of a field spanning several bytes -->
+<xsl:template name="decode-bytes">
+  <xsl:param name="b" />
+  <xsl:param name="f" />
+  <xsl:param name="l" />
+  <xsl:param name="o" />
+  <xsl:param name="s" />
+  <xsl:param name="ctype" />
+  <xsl:variable name="byte">
+    <xsl:choose>
+      <xsl:when test="$b = $f and $o mod 8 != 0">(p_data[<xsl:value-of select="$b" />] &amp; <xsl:call-template name="hex">
+          <xsl:with-param name="v">
+            <xsl:call-template name="pow2"><xsl:with-param name="n" select="8 - $o mod 8" /></xsl:call-template>
+          </xsl:with-param>
+          <xsl:with-param name="minus" select="1" />
+        </xsl:call-template>)</xsl:when>
+      <xsl:otherwise>p_data[<xsl:value-of select="$b" />]</xsl:otherwise>
+    </xsl:choose>
+  </xsl:variable>
+  <xsl:if test="$b != $f"><xsl:text>
+            | </xsl:text></xsl:if>
+  <xsl:choose>
+    <xsl:when test="$b &lt; $l">((<xsl:value-of select="$ctype" />)<xsl:value-of select="$byte" /> &lt;&lt; <xsl:value-of select="8 * ($l - $b) - $s" />)</xsl:when>
+    <xsl:when test="$s != 0">(p_data[<xsl:value-of select="$b" />] &gt;&gt; <xsl:value-of select="$s" />)</xsl:when>
+    <xsl:otherwise><xsl:value-of select="$byte" /></xsl:otherwise>
+  </xsl:choose>
+  <xsl:if test="$b &lt; $l">
+    <xsl:call-template name="decode-bytes">
+      <xsl:with-param name="b" select="$b + 1" />
+      <xsl:with-param name="f" select="$f" />
+      <xsl:with-param name="l" select="$l" />
+      <xsl:with-param name="o" select="$o" />
+      <xsl:with-param name="s" select="$s" />
+      <xsl:with-param name="ctype" select="$ctype" />
+    </xsl:call-template>
+  </xsl:if>
+</xsl:template>
+
+<!--                  -->
+<!-- encode templates -->
+<!--                  -->
+
+<!-- one assignment per byte of the payload -->
+<xsl:template name="encode-bytes">
+  <xsl:param name="k" />
+  <xsl:variable name="terms">
+    <xsl:for-each select="integer | boolean | reserved">
+      <xsl:variable name="o">
+        <xsl:call-template name="offset" />
+      </xsl:variable>
+      <xsl:variable name="n">
+        <xsl:choose>
+          <xsl:when test="self::boolean">1</xsl:when>
+          <xsl:otherwise><xsl:value-of select="@bitcount" /></xsl:otherwise>
+        </xsl:choose>
+      </xsl:variable>
+      <xsl:if test="$o &lt; 8 * $k + 8 and $o + $n &gt; 8 * $k">
+        <xsl:call-template name="encode-term">
+          <xsl:with-param name="k" select="$k" />
+          <xsl:with-param name="o" select="$o" />
+          <xsl:with-param name="n" select="$n" />
+        </xsl:call-template>
+      </xsl:if>
+    </xsl:for-each>
+  </xsl:variable>
+    p_data[<xsl:value-of select="$k" />] = <xsl:value-of select="substring($terms, 18)" />;<xsl:if test="$k + 1 &lt; @length">
+    <xsl:call-template name="encode-bytes">
+      <xsl:with-param name="k" select="$k + 1" />
+    </xsl:call-template>
+  </xsl:if>
+</xsl:template>
+
+<!-- the bits of the current field in the byte k, after a "|" separator line -->
+<xsl:template name="encode-term">
+  <xsl:param name="k" />
+  <xsl:param name="o" />
+  <xsl:param name="n" />
+  <xsl:variable name="lo">
+    <xsl:choose>
+      <xsl:when test="$o &gt; 8 * $k"><xsl:value-of select="$o" /></xsl:when>
+      <xsl:otherwise><xsl:value-of select="8 * $k" /></xsl:otherwise>
+    </xsl:choose>
+  </xsl:variable>
+  <xsl:variable name="hi">
+    <xsl:choose>
+      <xsl:when test="$o + $n &lt; 8 * $k + 8"><xsl:value-of select="$o + $n" /></xsl:when>
+      <xsl:otherwise><xsl:value-of select="8 * $k + 8" /></xsl:otherwise>
+    </xsl:choose>
+  </xsl:variable>
+  <xsl:variable name="r" select="$o + $n - $hi" />
+  <xsl:variable name="left" select="8 * $k + 8 - $hi" />
+  <xsl:variable name="w">
+    <xsl:call-template name="pow2"><xsl:with-param name="n" select="$hi - $lo" /></xsl:call-template>
+  </xsl:variable>
+  <xsl:variable name="pl">
+    <xsl:call-template name="pow2"><xsl:with-param name="n" select="$left" /></xsl:call-template>
+  </xsl:variable>
+  <xsl:variable name="mask">
+    <xsl:call-template name="hex"><xsl:with-param name="v" select="($w - 1) * $pl" /></xsl:call-template>
+  </xsl:variable>
+  <xsl:variable name="v" select="concat('p_decoded->', @name)" />
+  <xsl:text>
+              | </xsl:text>
+  <xsl:choose>
+    <xsl:when test="self::reserved"><xsl:value-of select="$mask" /></xsl:when>
+    <xsl:when test="self::boolean">(<xsl:value-of select="$v" /> ? <xsl:value-of select="$mask" /> : 0)</xsl:when>
+    <xsl:when test="$hi - $lo = 8 and $r = 0">(uint8_t)<xsl:value-of select="$v" /></xsl:when>
+    <xsl:when test="$hi - $lo = 8">(uint8_t)(<xsl:value-of select="$v" /> &gt;&gt; <xsl:value-of select="$r" />)</xsl:when>
+    <xsl:when test="$r &gt; $left">((<xsl:value-of select="$v" /> &gt;&gt; <xsl:value-of select="$r - $left" />) &amp; <xsl:value-of select="$mask" />)</xsl:when>
+    <xsl:when test="$left &gt; $r">((<xsl:value-of select="$v" /> &lt;&lt; <xsl:value-of select="$left - $r" />) &amp; <xsl:value-of select="$mask" />)</xsl:when>
+    <xsl:otherwise>(<xsl:value-of select="$v" /> &amp; <xsl:value-of select="$mask" />)</xsl:otherwise>
+  </xsl:choose>
+</xsl:template>
+
+<!--                   -->
+<!-- utility templates -->
+<!--                   -->
+
+<!-- bit offset of the current field in the payload -->
+<xsl:template name="offset">
+  <xsl:value-of select="sum(preceding-sibling::integer/@bitcount)
+                        + sum(preceding-sibling::reserved/@bitcount)
+                        + count(preceding-sibling::boolean)" />
+</xsl:template>
+
+<xsl:template name="pow2">
+  <xsl:param name="n" />
+  <xsl:choose>
+    <xsl:when test="$n &lt;= 0">1</xsl:when>
+    <xsl:otherwise>
+      <xsl:variable name="p">
+        <xsl:call-template name="pow2"><xsl:with-param name="n" select="$n - 1" /></xsl:call-template>
+      </xsl:variable>
+      <xsl:value-of select="2 * $p" />
+    </xsl:otherwise>
+  </xsl:choose>
+</xsl:template>
+
+<!-- byte value as 0xhh, minus an optional constant -->
+<xsl:template name="hex">
+  <xsl:param name="v" />
+  <xsl:param name="minus" select="0" />
+  <xsl:variable name="x" select="$v - $minus" />
+  <xsl:value-of select="concat('0x', substring('0123456789abcdef', floor($x div 16) + 1, 1),
+                                     substring('0123456789abcdef', $x mod 16 + 1, 1))" />
+</xsl:template>
+
+<xsl:template match="text()" priority="-1"/>
+<xsl:template match="text()" mode="code" priority="-1"/>
+<xsl:template match="text()" mode="decode" priority="-1"/>
+
+</xsl:stylesheet>
@@ -0,0 +1,949 @@
+/*****************************************************************************
+ * gen_si.c: synthetic MPTS/SI transport stream generator
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ * Builds a multiplex description (services, PMTs, SDT actual/other, NIT with
+ * satellite delivery descriptors, BAT with logical channel numbers, EIT
+ * present/following and an 8 day EIT schedule with extended events) with
+ * the libdvbpsi encoders and plays it out as a constant bitrate transport
+ * stream through a libdvbpsi carousel. Every table has its own repetition
+ * interval, its sections are spread evenly over that interval and the
+ * remaining bandwidth is filled with null packets.
+ *
+ * The output only depends on the command line: the same options and seed
+ * produce the same file on every machine, errors included.
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <getopt.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/descriptor.h"
+#include "../src/carousel.h"
+#include "../src/tables/pat.h"
+#include "../src/tables/pmt.h"
+#include "../src/tables/sdt.h"
+#include "../src/tables/nit.h"
+#include "../src/tables/bat.h"
+#include "../src/tables/eit.h"
+#include "../src/descriptors/dr_40.h"
+#include "../src/descriptors/dr_41.h"
+#include "../src/descriptors/dr_43.h"
+#include "../src/descriptors/dr_48.h"
+#include "../src/descriptors/dr_4d.h"
+#include "../src/descriptors/dr_4e.h"
+#include "../src/descriptors/dr_83.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/carousel.h>
+#include <dvbpsi/pat.h>
+#include <dvbpsi/pmt.h>
+#include <dvbpsi/sdt.h>
+#include <dvbpsi/nit.h>
+#include <dvbpsi/bat.h>
+#include <dvbpsi/eit.h>
+#include <dvbpsi/dr_40.h>
+#include <dvbpsi/dr_41.h>
+#include <dvbpsi/dr_43.h>
+#include <dvbpsi/dr_48.h>
+#include <dvbpsi/dr_4d.h>
+#include <dvbpsi/dr_4e.h>
+#include <dvbpsi/dr_83.h>
+#endif
+
+#define TS_PACKET_SIZE      188
+
+#define GEN_NETWORK_ID      0x3001
+#define GEN_ONID            0x2000
+#define GEN_BOUQUET_ID      0x1000
+#define GEN_MAX_SERVICES    1000
+#define GEN_MAX_MUXES       32
+#define GEN_EIT_DAYS        8
+
+/*****************************************************************************
+ * Deterministic pseudo random numbers (xorshift64*)
+ *****************************************************************************/
+static uint64_t gen_rand(uint64_t *p_state)
+{
+    uint64_t x = *p_state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *p_state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static uint64_t gen_rand_seed(uint64_t i_seed, uint64_t i_key)
+{
+    uint64_t i_state = (i_seed ^ (i_key * 0x9E3779B97F4A7C15ULL)) | 1;
+    gen_rand(&i_state);
+    return i_state;
+}
+
+/*****************************************************************************
+ * Table carousels
+ *****************************************************************************/
+typedef enum
+{
+    GEN_PAT,
+    GEN_PMT,
+    GEN_NIT,
+    GEN_SDT_ACTUAL,
+    GEN_SDT_OTHER,
+    GEN_BAT,
+    GEN_EIT_PF,
+    GEN_EIT_SCHED_FIRST,    /* 0x50: days 1 to 4 */
+    GEN_EIT_SCHED_LATER,    /* 0x51: days 5 to 8 */
+    GEN_KINDS
+} gen_kind_t;
+
+static const char *const gen_kind_names[GEN_KINDS] =
+{
+    "pat", "pmt", "nit", "sdt", "sdto", "bat", "eitpf", "eits", "eitl"
+};
+
+/* Default repetition intervals in ms, see ETSI TS 101 211 */
+static const uint32_t gen_kind_intervals[GEN_KINDS] =
+{
+    100, 100, 2000, 2000, 10000, 10000, 2000, 10000, 30000
+};
+
+typedef struct gen_table_s
+{
+    gen_kind_t  i_kind;
+    size_t      i_index;        /* position in the table list */
+    uint16_t    i_pid;
+    uint16_t    i_key;          /* service id, mux index, ... */
+    uint8_t     i_version;
+
+    dvbpsi_carousel_table_t *p_carousel_table;
+} gen_table_t;
+
+typedef struct gen_s
+{
+    dvbpsi_t     *p_dvbpsi;
+
+    /* multiplex description */
+    uint64_t      i_seed;
+    int           i_services;   /* per mux */
+    int           i_muxes;      /* mux 0 is the actual one */
+    uint16_t      i_mjd;        /* start date of the schedule */
+
+    /* playout */
+    uint64_t      i_bitrate;
+    uint64_t      i_duration;   /* us */
+    uint32_t      intervals[GEN_KINDS];
+
+    /* error injection, 0 disables */
+    uint32_t      i_cc_error;   /* 1 in N packets */
+    uint32_t      i_crc_error;  /* 1 in N sections */
+    uint64_t      i_bump;       /* us between version bumps */
+    uint64_t      i_rand;
+
+    gen_table_t  *p_tables;
+    size_t        i_tables;
+
+    dvbpsi_carousel_t *p_carousel;
+    uint8_t       cc_skip[8192];  /* continuity_counter offset per PID */
+
+    /* statistics */
+    uint64_t      i_si_packets;
+    uint64_t      i_null_packets;
+    uint64_t      i_cc_errors;
+    uint64_t      i_crc_errors;
+    uint64_t      i_bumps;
+    uint64_t      i_max_late;
+} gen_t;
+
+static uint16_t gen_tsid(int i_mux)
+{
+    return 1 + i_mux;
+}
+
+static uint16_t gen_service_id(int i_mux, int i_service)
+{
+    return i_mux * GEN_MAX_SERVICES + 1 + i_service;
+}
+
+/*****************************************************************************
+ * Time helpers
+ *****************************************************************************/
+static uint8_t gen_bcd(unsigned int i_value)
+{
+    return ((i_value / 10) << 4) | (i_value % 10);
+}
+
+/* seconds relative to the schedule start to 40 bit MJD + BCD time */
+static uint64_t gen_start_time(const gen_t *p_gen, uint32_t i_seconds)
+{
+    uint64_t i_mjd = p_gen->i_mjd + i_seconds / 86400;
+    uint32_t i_day = i_seconds % 86400;
+
+    return (i_mjd << 24) | ((uint64_t)gen_bcd(i_day / 3600) << 16)
+                         | ((uint64_t)gen_bcd((i_day / 60) % 60) << 8)
+                         | gen_bcd(i_day % 60);
+}
+
+static uint32_t gen_duration(uint32_t i_seconds)
+{
+    return ((uint32_t)gen_bcd(i_seconds / 3600) << 16)
+         | ((uint32_t)gen_bcd((i_seconds / 60) % 60) << 8)
+         | gen_bcd(i_seconds % 60);
+}
+
+/*****************************************************************************
+ * Descriptor helpers
+ *****************************************************************************/
+static const char *const gen_words[] =
+{
+    "news", "weather", "live", "match", "final", "documentary", "history",
+    "science", "nature", "ocean", "mountain", "city", "travel", "kitchen",
+    "music", "concert", "drama", "comedy", "series", "episode", "season",
+    "interview", "report", "market", "studio", "classic", "family", "quiz"
+};
+#define GEN_WORDS (sizeof(gen_words) / sizeof(gen_words[0]))
+
+static int gen_text(uint64_t *p_rand, char *psz_text, int i_max)
+{
+    int i_len = 0;
+    while (i_len < i_max - 1)
+    {
+        const char *psz_word = gen_words[gen_rand(p_rand) % GEN_WORDS];
+        int i_word = strlen(psz_word);
+        if (i_len + i_word + 1 >= i_max)
+            break;
+        if (i_len)
+            psz_text[i_len++] = ' ';
+        memcpy(psz_text + i_len, psz_word, i_word);
+        i_len += i_word;
+    }
+    psz_text[i_len] = '\0';
+    return i_len;
+}
+
+typedef dvbpsi_descriptor_t *(*gen_descriptor_add_cb)(void *p_owner, uint8_t i_tag,
+                                                      uint8_t i_length, uint8_t *p_data);
+
+static void gen_add_descriptor(dvbpsi_descriptor_t *p_descriptor,
+                               gen_descriptor_add_cb pf_add, void *p_owner)
+{
+    if (!p_descriptor)
+        return;
+    pf_add(p_owner, p_descriptor->i_tag, p_descriptor->i_length,
+           p_descriptor->p_data);
+    dvbpsi_DeleteDescriptors(p_descriptor);
+}
+
+static dvbpsi_descriptor_t *gen_nit_dr_add(void *p_owner, uint8_t i_tag,
+                                           uint8_t i_length, uint8_t *p_data)
+{
+    return dvbpsi_nit_descriptor_add(p_owner, i_tag, i_length, p_data);
+}
+
+static dvbpsi_descriptor_t *gen_nit_ts_dr_add(void *p_owner, uint8_t i_tag,
+                                              uint8_t i_length, uint8_t *p_data)
+{
+    return dvbpsi_nit_ts_descriptor_add(p_owner, i_tag, i_length, p_data);
+}
+
+static dvbpsi_descriptor_t *gen_bat_ts_dr_add(void *p_owner, uint8_t i_tag,
+                                              uint8_t i_length, uint8_t *p_data)
+{
+    return dvbpsi_bat_ts_descriptor_add(p_owner, i_tag, i_length, p_data);
+}
+
+static dvbpsi_descriptor_t *gen_sdt_dr_add(void *p_owner, uint8_t i_tag,
+                                           uint8_t i_length, uint8_t *p_data)
+{
+    return dvbpsi_sdt_service_descriptor_add(p_owner, i_tag, i_length, p_data);
+}
+
+static dvbpsi_descriptor_t *gen_eit_dr_add(void *p_owner, uint8_t i_tag,
+                                           uint8_t i_length, uint8_t *p_data)
+{
+    return dvbpsi_eit_event_descriptor_add(p_owner, i_tag, i_length, p_data);
+}
+
+/* service_list_descriptors, 64 services each */
+static void gen_service_list(const gen_t *p_gen, int i_mux,
+                             gen_descriptor_add_cb pf_add, void *p_owner)
+{
+    for (int i = 0; i < p_gen->i_services; i += 64)
+    {
+        dvbpsi_service_list_dr_t list;
+        memset(&list, 0, sizeof(list));
+        for (int j = i; j < p_gen->i_services && j < i + 64; j++)
+        {
+            list.i_service[list.i_service_count].i_service_id =
+                gen_service_id(i_mux, j);
+            list.i_service[list.i_service_count].i_service_type = 0x01;
+            list.i_service_count++;
+        }
+        gen_add_descriptor(dvbpsi_GenServiceListDr(&list, false), pf_add, p_owner);
+    }
+}
+
+/*****************************************************************************
+ * Table builders
+ *****************************************************************************/
+static dvbpsi_psi_section_t *gen_pat(gen_t *p_gen, gen_table_t *p_table)
+{
+    dvbpsi_pat_t *p_pat = dvbpsi_pat_new(gen_tsid(0), p_table->i_version, true);
+    dvbpsi_psi_section_t *p_sections;
+
+    dvbpsi_pat_program_add(p_pat, 0, 0x10);
+    for (int i = 0; i < p_gen->i_services; i++)
+        dvbpsi_pat_program_add(p_pat, gen_service_id(0, i), 0x100 + i);
+
+    p_sections = dvbpsi_pat_sections_generate(p_gen->p_dvbpsi, p_pat, 253);
+    dvbpsi_pat_delete(p_pat);
+    return p_sections;
+}
+
+static dvbpsi_psi_section_t *gen_pmt(gen_t *p_gen, gen_table_t *p_table)
+{
+    static uint8_t iso639[2][4] = { { 'e', 'n', 'g', 0 }, { 'd', 'e', 'u', 0 } };
+    int i_service = p_table->i_key;
+    uint16_t i_pcr_pid = 0x1000 + 4 * i_service;
+    dvbpsi_pmt_t *p_pmt = dvbpsi_pmt_new(gen_service_id(0, i_service),
+                                         p_table->i_version, true, i_pcr_pid);
+    dvbpsi_psi_section_t *p_sections;
+
+    dvbpsi_pmt_es_add(p_pmt, 0x1b, i_pcr_pid);
+    for (int i = 0; i < 2; i++)
+    {
+        dvbpsi_pmt_es_t *p_es = dvbpsi_pmt_es_add(p_pmt, 0x04, i_pcr_pid + 1 + i);
+        dvbpsi_pmt_es_descriptor_add(p_es, 0x0a, 4, iso639[i]);
+    }
+    dvbpsi_pmt_es_add(p_pmt, 0x06, i_pcr_pid + 3);
+
+    p_sections = dvbpsi_pmt_sections_generate(p_gen->p_dvbpsi, p_pmt);
+    dvbpsi_pmt_delete(p_pmt);
+    return p_sections;
+}
+
+static dvbpsi_psi_section_t *gen_nit(gen_t *p_gen, gen_table_t *p_table)
+{
+    dvbpsi_nit_t *p_nit = dvbpsi_nit_new(0x40, GEN_NETWORK_ID, GEN_NETWORK_ID,
+                                         p_table->i_version, true);
+    dvbpsi_network_name_dr_t name;
+    dvbpsi_psi_section_t *p_sections;
+
+    memset(&name, 0, sizeof(name));
+    name.i_name_length = sprintf((char *)name.i_name_byte, "libdvbpsi synthetic");
+    gen_add_descriptor(dvbpsi_GenNetworkNameDr(&name, false), gen_nit_dr_add, p_nit);
+
+    for (int i_mux = 0; i_mux < p_gen->i_muxes; i_mux++)
+    {
+        dvbpsi_nit_ts_t *p_ts = dvbpsi_nit_ts_add(p_nit, gen_tsid(i_mux), GEN_ONID);
+        dvbpsi_sat_deliv_sys_dr_t deliv;
+
+        /* 11.7 GHz upwards in 19.5 MHz steps, 19.2E, 27.5 MS/s QPSK 3/4 */
+        memset(&deliv, 0, sizeof(deliv));
+        deliv.i_frequency = 0x01170000 + 0x1950 * i_mux;
+        deliv.i_orbital_position = 0x0192;
+        deliv.i_west_east_flag = 1;
+        deliv.i_polarization = i_mux & 1;
+        deliv.i_modulation_system = 0;
+        deliv.i_modulation_type = 1;
+        deliv.i_symbol_rate = 0x0275000;
+        deliv.i_fec_inner = 3;
+        gen_add_descriptor(dvbpsi_GenSatDelivSysDr(&deliv, false),
+                           gen_nit_ts_dr_add, p_ts);
+        gen_service_list(p_gen, i_mux, gen_nit_ts_dr_add, p_ts);
+    }
+
+    p_sections = dvbpsi_nit_sections_generate(p_gen->p_dvbpsi, p_nit, 0x40);
+    dvbpsi_nit_delete(p_nit);
+    return p_sections;
+}
+
+static dvbpsi_psi_section_t *gen_sdt(gen_t *p_gen, gen_table_t *p_table)
+{
+    int i_mux = p_table->i_key;
+    uint8_t i_table_id = i_mux ? 0x46 : 0x42;
+    dvbpsi_sdt_t *p_sdt = dvbpsi_sdt_new(i_table_id, gen_tsid(i_mux),
+                                         p_table->i_version, true, GEN_ONID);
+    dvbpsi_psi_section_t *p_sections;
+
+    for (int i = 0; i < p_gen->i_services; i++)
+    {
+        uint16_t i_sid = gen_service_id(i_mux, i);
+        dvbpsi_sdt_service_t *p_service;
+        dvbpsi_service_dr_t service;
+
+        memset(&service, 0, sizeof(service));
+        service.i_service_type = 0x01;
+        service.i_service_provider_name_length =
+            sprintf((char *)service.i_service_provider_name, "Provider %d", i_mux + 1);
+        service.i_service_name_length =
+            sprintf((char *)service.i_service_name, "Channel %u", i_sid);
+
+        /* EIT schedule is only carried for the actual multiplex */
+        p_service = dvbpsi_sdt_service_add(p_sdt, i_sid, i_mux == 0, i_mux == 0,
+                                           4, false);
+        gen_add_descriptor(dvbpsi_GenServiceDr(&service, false),
+                           gen_sdt_dr_add, p_service);
+    }
+
+    p_sections = dvbpsi_sdt_sections_generate(p_gen->p_dvbpsi, p_sdt);
+    dvbpsi_sdt_delete(p_sdt);
+    return p_sections;
+}
+
+static dvbpsi_psi_section_t *gen_bat(gen_t *p_gen, gen_table_t *p_table)
+{
+    dvbpsi_bat_t *p_bat = dvbpsi_bat_new(0x4a, GEN_BOUQUET_ID,
+                                         p_table->i_version, true);
+    dvbpsi_psi_section_t *p_sections;
+
+    for (int i_mux = 0; i_mux < p_gen->i_muxes; i_mux++)
+    {
+        dvbpsi_bat_ts_t *p_ts = dvbpsi_bat_ts_add(p_bat, gen_tsid(i_mux), GEN_ONID);
+
+        gen_service_list(p_gen, i_mux, gen_bat_ts_dr_add, p_ts);
+
+        /* logical_channel_descriptors, 63 entries of 4 bytes each */
+        for (int i = 0; i < p_gen->i_services; i += 63)
+        {
+            dvbpsi_lcn_dr_t lcn;
+            memset(&lcn, 0, sizeof(lcn));
+            for (int j = i; j < p_gen->i_services && j < i + 63; j++)
+            {
+                dvbpsi_lcn_entry_t *p_entry = &lcn.p_entries[lcn.i_number_of_entries++];
+                p_entry->i_service_id = gen_service_id(i_mux, j);
+                p_entry->b_visible_service_flag = 1;
+                p_entry->i_logical_channel_number = i_mux * p_gen->i_services + j + 1;
+            }
+            gen_add_descriptor(dvbpsi_GenLCNDr(&lcn, false), gen_bat_ts_dr_add, p_ts);
+        }
+    }
+
+    p_sections = dvbpsi_bat_sections_generate(p_gen->p_dvbpsi, p_bat);
+    dvbpsi_bat_delete(p_bat);
+    return p_sections;
+}
+
+/*****************************************************************************
+ * EIT
+ *****************************************************************************
+ * Events of a service are derived from the seed and the service id only, so
+ * a single subtable can be rebuilt without replaying the whole multiplex.
+ *****************************************************************************/
+typedef struct gen_event_s
+{
+    uint16_t i_event_id;
+    uint32_t i_start;       /* seconds from the schedule start */
+    uint32_t i_duration;    /* seconds */
+    uint64_t i_rand;        /* seeds the event texts */
+} gen_event_t;
+
+static const uint32_t gen_event_durations[] = { 1800, 2700, 3600, 5400, 7200 };
+
+static bool gen_event_next(uint64_t *p_rand, gen_event_t *p_event)
+{
+    uint32_t i_start = p_event->i_start + p_event->i_duration;
+    if (i_start >= GEN_EIT_DAYS * 86400)
+        return false;
+
+    p_event->i_event_id++;
+    p_event->i_start = i_start;
+    p_event->i_duration = gen_event_durations[gen_rand(p_rand) % 5];
+    p_event->i_rand = gen_rand(p_rand);
+    return true;
+}
+
+static void gen_event_add(const gen_t *p_gen, dvbpsi_eit_t *p_eit,
+                          const gen_event_t *p_event, uint8_t i_running,
+                          bool b_extended)
+{
+    uint64_t i_rand = p_event->i_rand;
+    dvbpsi_eit_event_t *p_eit_event;
+    dvbpsi_short_event_dr_t short_event;
+    char text[256];
+
+    p_eit_event = dvbpsi_eit_event_add(p_eit, p_event->i_event_id,
+                                       gen_start_time(p_gen, p_event->i_start),
+                                       gen_duration(p_event->i_duration),
+                                       i_running, false, 0);
+
+    memset(&short_event, 0, sizeof(short_event));
+    memcpy(short_event.i_iso_639_code, "eng", 3);
+    short_event.i_event_name_length = gen_text(&i_rand, (char *)short_event.i_event_name, 32);
+    short_event.i_text_length = gen_text(&i_rand, (char *)short_event.i_text, 80);
+    gen_add_descriptor(dvbpsi_GenShortEventDr(&short_event, false),
+                       gen_eit_dr_add, p_eit_event);
+
+    if (b_extended)
+    {
+        dvbpsi_extended_event_dr_t extended;
+        memset(&extended, 0, sizeof(extended));
+        memcpy(extended.i_iso_639_code, "eng", 3);
+        extended.i_text_length = gen_text(&i_rand, text, 200);
+        extended.i_text = (uint8_t *)text;
+        gen_add_descriptor(dvbpsi_GenExtendedEventDr(&extended, false),
+                           gen_eit_dr_add, p_eit_event);
+    }
+}
+
+/* Appends the sections of p_eit numbered from i_number and sets their
+ * segment_last_section_number. last_section_number is fixed by the caller
+ * once the whole subtable is known. */
+static dvbpsi_psi_section_t **gen_eit_segment(gen_t *p_gen, dvbpsi_eit_t *p_eit,
+                                              uint8_t i_number, uint8_t i_max,
+                                              dvbpsi_psi_section_t **pp_last)
+{
+    dvbpsi_psi_section_t *p_sections =
+        dvbpsi_eit_sections_generate(p_gen->p_dvbpsi, p_eit, p_eit->i_table_id);
+    dvbpsi_psi_section_t *p_section = p_sections;
+    uint8_t i_count = 0;
+
+    for (dvbpsi_psi_section_t *p = p_sections; p; p = p->p_next)
+        i_count++;
+    if (i_count > i_max)
+    {
+        fprintf(stderr, "gen_si: EIT segment of service 0x%04x needs %u sections\n",
+                p_eit->i_extension, i_count);
+        i_count = i_max;
+    }
+
+    for (uint8_t i = 0; i < i_count; i++, p_section = p_section->p_next)
+    {
+        p_section->i_number = i_number + i;
+        p_section->p_data[12] = i_number + i_count - 1;
+        *pp_last = p_section;
+        pp_last = &p_section->p_next;
+    }
+    /* drop what does not fit in the segment */
+    dvbpsi_DeletePSISections(*pp_last);
+    *pp_last = NULL;
+    return pp_last;
+}
+
+static void gen_eit_finish(gen_t *p_gen, dvbpsi_psi_section_t *p_sections)
+{
+    uint8_t i_last = 0;
+    for (dvbpsi_psi_section_t *p = p_sections; p; p = p->p_next)
+        i_last = p->i_number;
+    for (dvbpsi_psi_section_t *p = p_sections; p; p = p->p_next)
+    {
+        p->i_last_number = i_last;
+        dvbpsi_BuildPSISection(p_gen->p_dvbpsi, p);
+    }
+}
+
+static dvbpsi_psi_section_t *gen_eit_pf(gen_t *p_gen, gen_table_t *p_table)
+{
+    uint16_t i_sid = gen_service_id(0, p_table->i_key);
+    uint64_t i_rand = gen_rand_seed(p_gen->i_seed, i_sid);
+    dvbpsi_psi_section_t *p_sections = NULL, **pp_last = &p_sections;
+    gen_event_t event;
+
+    /* the playout starts with the first event of the schedule */
+    memset(&event, 0, sizeof(event));
+    for (int i = 0; i < 2 && gen_event_next(&i_rand, &event); i++)
+    {
+        dvbpsi_eit_t *p_eit = dvbpsi_eit_new(0x4e, i_sid, p_table->i_version, true,
+                                             gen_tsid(0), GEN_ONID, 0, 0x4e);
+        gen_event_add(p_gen, p_eit, &event, i ? 1 : 4, true);
+        pp_last = gen_eit_segment(p_gen, p_eit, i, 1, pp_last);
+        dvbpsi_eit_delete(p_eit);
+    }
+    gen_eit_finish(p_gen, p_sections);
+    return p_sections;
+}
+
+static dvbpsi_psi_section_t *gen_eit_schedule(gen_t *p_gen, gen_table_t *p_table)
+{
+    uint8_t i_table_id = p_table->i_kind == GEN_EIT_SCHED_FIRST ? 0x50 : 0x51;
+    uint16_t i_sid = gen_service_id(0, p_table->i_key);
+    uint64_t i_rand = gen_rand_seed(p_gen->i_seed, i_sid);
+    dvbpsi_psi_section_t *p_sections, *p_result = NULL, **pp_last = &p_result;
+    dvbpsi_eit_t *p_eit;
+    gen_event_t event;
+
+    p_eit = dvbpsi_eit_new(0x50, i_sid, p_table->i_version, true,
+                           gen_tsid(0), GEN_ONID, 0, 0x51);
+    if (!p_eit)
+        return NULL;
+
+    memset(&event, 0, sizeof(event));
+    while (gen_event_next(&i_rand, &event))
+        gen_event_add(p_gen, p_eit, &event, 1, true);
+
+    /* both sub-tables are generated, only the requested one is kept */
+    p_sections = dvbpsi_eit_schedule_generate(p_gen->p_dvbpsi, p_eit, 0x50,
+                                              p_gen->i_mjd);
+    dvbpsi_eit_delete(p_eit);
+
+    while (p_sections)
+    {
+        dvbpsi_psi_section_t *p_section = p_sections;
+        p_sections = p_section->p_next;
+        p_section->p_next = NULL;
+        if (p_section->i_table_id == i_table_id)
+        {
+            *pp_last = p_section;
+            pp_last = &p_section->p_next;
+        }
+        else
+            dvbpsi_DeletePSISections(p_section);
+    }
+    return p_result;
+}
+
+/*****************************************************************************
+ * Carousel
+ *****************************************************************************/
+static dvbpsi_psi_section_t *gen_table_build(gen_t *p_gen, gen_table_t *p_table)
+{
+    switch (p_table->i_kind)
+    {
+        case GEN_PAT:             return gen_pat(p_gen, p_table);
+        case GEN_PMT:             return gen_pmt(p_gen, p_table);
+        case GEN_NIT:             return gen_nit(p_gen, p_table);
+        case GEN_SDT_ACTUAL:
+        case GEN_SDT_OTHER:       return gen_sdt(p_gen, p_table);
+        case GEN_BAT:             return gen_bat(p_gen, p_table);
+        case GEN_EIT_PF:          return gen_eit_pf(p_gen, p_table);
+        case GEN_EIT_SCHED_FIRST:
+        case GEN_EIT_SCHED_LATER: return gen_eit_schedule(p_gen, p_table);
+        default:                  return NULL;
+    }
+}
+
+static bool gen_table_add(gen_t *p_gen, gen_kind_t i_kind, uint16_t i_pid, uint16_t i_key)
+{
+    gen_table_t *p_table = &p_gen->p_tables[p_gen->i_tables];
+    dvbpsi_psi_section_t *p_sections;
+
+    memset(p_table, 0, sizeof(gen_table_t));
+    p_table->i_kind = i_kind;
+    p_table->i_index = p_gen->i_tables;
+    p_table->i_pid = i_pid;
+    p_table->i_key = i_key;
+
+    p_sections = gen_table_build(p_gen, p_table);
+    if (p_sections)
+    {
+        uint64_t i_interval = (uint64_t)p_gen->intervals[i_kind] * 1000;
+        /* stagger the first cycles so the carousels do not start in a burst */
+        p_table->p_carousel_table = dvbpsi_carousel_add(p_gen->p_carousel, i_pid,
+                p_sections, i_interval, i_interval * (p_table->i_index % 16) / 16);
+        dvbpsi_DeletePSISections(p_sections);
+    }
+    if (!p_table->p_carousel_table)
+    {
+        fprintf(stderr, "gen_si: failed to build %s table %u\n",
+                gen_kind_names[i_kind], i_key);
+        return false;
+    }
+    p_gen->i_tables++;
+    return true;
+}
+
+static bool gen_table_bump(gen_t *p_gen, gen_table_t *p_table)
+{
+    dvbpsi_psi_section_t *p_sections;
+    bool b_ok;
+
+    p_table->i_version = (p_table->i_version + 1) & 0x1f;
+    p_sections = gen_table_build(p_gen, p_table);
+    b_ok = p_sections && dvbpsi_carousel_replace(p_gen->p_carousel,
+                                        p_table->p_carousel_table, p_sections);
+    dvbpsi_DeletePSISections(p_sections);
+    p_gen->i_bumps++;
+    return b_ok;
+}
+
+static bool gen_tables_new(gen_t *p_gen)
+{
+    size_t i_max = 3 + p_gen->i_muxes + 4 * p_gen->i_services;
+    bool b_ok = true;
+
+    p_gen->p_tables = calloc(i_max, sizeof(gen_table_t));
+    p_gen->p_carousel = dvbpsi_carousel_new();
+    if (!p_gen->p_tables || !p_gen->p_carousel)
+        return false;
+
+    b_ok &= gen_table_add(p_gen, GEN_PAT, 0x00, 0);
+    for (int i = 0; b_ok && i < p_gen->i_services; i++)
+        b_ok &= gen_table_add(p_gen, GEN_PMT, 0x100 + i, i);
+    b_ok = b_ok && gen_table_add(p_gen, GEN_NIT, 0x10, 0);
+    b_ok = b_ok && gen_table_add(p_gen, GEN_SDT_ACTUAL, 0x11, 0);
+    for (int i = 1; b_ok && i < p_gen->i_muxes; i++)
+        b_ok &= gen_table_add(p_gen, GEN_SDT_OTHER, 0x11, i);
+    b_ok = b_ok && gen_table_add(p_gen, GEN_BAT, 0x11, 0);
+    for (int i = 0; b_ok && i < p_gen->i_services; i++)
+        b_ok &= gen_table_add(p_gen, GEN_EIT_PF, 0x12, i);
+    for (int i = 0; b_ok && i < p_gen->i_services; i++)
+        b_ok &= gen_table_add(p_gen, GEN_EIT_SCHED_FIRST, 0x12, i);
+    for (int i = 0; b_ok && i < p_gen->i_services; i++)
+        b_ok &= gen_table_add(p_gen, GEN_EIT_SCHED_LATER, 0x12, i);
+    return b_ok;
+}
+
+static void gen_tables_delete(gen_t *p_gen)
+{
+    dvbpsi_carousel_delete(p_gen->p_carousel);
+    free(p_gen->p_tables);
+}
+
+/* error injection on a packet emitted by the carousel */
+static void gen_inject_errors(gen_t *p_gen, uint8_t *p_packet)
+{
+    uint16_t i_pid = ((p_packet[1] & 0x1f) << 8) | p_packet[2];
+
+    if (p_gen->i_cc_error && gen_rand(&p_gen->i_rand) % p_gen->i_cc_error == 0)
+    {
+        p_gen->cc_skip[i_pid]++;
+        p_gen->i_cc_errors++;
+    }
+    p_packet[3] = (p_packet[3] & 0xf0) | ((p_packet[3] + p_gen->cc_skip[i_pid]) & 0x0f);
+
+    /* corrupt the last section byte of the first packet, which is part
+     * of the CRC_32 for sections fitting in one packet. Sections are not
+     * packed so the pointer_field is 0. */
+    if ((p_packet[1] & 0x40) && p_gen->i_crc_error &&
+        gen_rand(&p_gen->i_rand) % p_gen->i_crc_error == 0)
+    {
+        size_t i_section_length = 3 + (((p_packet[6] & 0x0f) << 8) | p_packet[7]);
+        size_t i_last = i_section_length < 183 ? i_section_length : 183;
+        p_packet[4 + i_last] ^= 0x01;
+        p_gen->i_crc_errors++;
+    }
+}
+
+static bool gen_playout(gen_t *p_gen, FILE *p_out)
+{
+    static const uint8_t null_packet[4] = { 0x47, 0x1f, 0xff, 0x10 };
+    uint8_t null[TS_PACKET_SIZE];
+    uint8_t packet[TS_PACKET_SIZE];
+    uint64_t i_slots = p_gen->i_duration * p_gen->i_bitrate
+                       / (TS_PACKET_SIZE * 8 * 1000000ULL);
+    uint64_t i_next_bump = p_gen->i_bump;
+    size_t i_bump_table = 0;
+
+    memcpy(null, null_packet, 4);
+    memset(null + 4, 0xff, TS_PACKET_SIZE - 4);
+
+    for (uint64_t i_slot = 0; i_slot < i_slots; i_slot++)
+    {
+        uint64_t i_now = i_slot * TS_PACKET_SIZE * 8 * 1000000ULL / p_gen->i_bitrate;
+        uint64_t i_due;
+
+        /* version bumps walk through the tables in order */
+        if (p_gen->i_bump && i_now >= i_next_bump)
+        {
+            if (!gen_table_bump(p_gen, &p_gen->p_tables[i_bump_table]))
+                return false;
+            i_bump_table = (i_bump_table + 1) % p_gen->i_tables;
+            i_next_bump += p_gen->i_bump;
+        }
+
+        if (dvbpsi_carousel_next_due(p_gen->p_carousel, &i_due) && i_due <= i_now
+         && i_now - i_due > p_gen->i_max_late)
+            p_gen->i_max_late = i_now - i_due;
+
+        if (dvbpsi_carousel_emit(p_gen->p_carousel, i_now, packet, 1) == 0)
+        {
+            if (fwrite(null, TS_PACKET_SIZE, 1, p_out) != 1)
+                return false;
+            p_gen->i_null_packets++;
+            continue;
+        }
+
+        gen_inject_errors(p_gen, packet);
+        if (fwrite(packet, TS_PACKET_SIZE, 1, p_out) != 1)
+            return false;
+        p_gen->i_si_packets++;
+    }
+    return true;
+}
+
+/*****************************************************************************
+ * main
+ *****************************************************************************/
+static void message(dvbpsi_t *handle, const dvbpsi_msg_level_t level, const char* msg)
+{
+    (void)handle;
+    switch(level)
+    {
+        case DVBPSI_MSG_ERROR: fprintf(stderr, "Error: "); break;
+        case DVBPSI_MSG_WARN:  fprintf(stderr, "Warning: "); break;
+        case DVBPSI_MSG_DEBUG: fprintf(stderr, "Debug: "); break;
+        default: /* do nothing */
+            return;
+    }
+    fprintf(stderr, "%s\n", msg);
+}
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [options]\n", name);
+    printf("  -o, --output <file>     : output file (default stdout)\n");
+    printf("  -n, --services <n>      : services per multiplex (default 200, max %d)\n",
+           GEN_MAX_SERVICES);
+    printf("  -m, --muxes <n>         : multiplexes in the network (default 4, max %d)\n",
+           GEN_MAX_MUXES);
+    printf("  -b, --bitrate <bps>     : multiplex bitrate (default 38000000)\n");
+    printf("  -d, --duration <sec>    : playout duration (default 10)\n");
+    printf("  -s, --seed <n>          : seed for content and errors (default 1)\n");
+    printf("  -D, --mjd <n>           : schedule start date as MJD (default 61041, 2026-01-01)\n");
+    printf("  -r, --rate <table=ms>   : repetition interval of a table, tables are\n");
+    printf("                            pat, pmt, nit, sdt, sdto, bat, eitpf, eits (days 1-4)\n");
+    printf("                            and eitl (days 5-8)\n");
+    printf("  -c, --cc-errors <n>     : skip a continuity counter in 1 of n packets\n");
+    printf("  -e, --crc-errors <n>    : corrupt 1 of n sections\n");
+    printf("  -v, --version-bump <ms> : bump the version of one table every ms\n");
+    printf("  -h, --help              : this help\n");
+}
+
+static bool parse_rate(gen_t *p_gen, const char *psz_arg)
+{
+    const char *psz_value = strchr(psz_arg, '=');
+    if (!psz_value)
+        return false;
+
+    for (int i = 0; i < GEN_KINDS; i++)
+    {
+        if (strlen(gen_kind_names[i]) == (size_t)(psz_value - psz_arg) &&
+            !strncmp(gen_kind_names[i], psz_arg, psz_value - psz_arg))
+        {
+            p_gen->intervals[i] = strtoul(psz_value + 1, NULL, 0);
+            return p_gen->intervals[i] > 0;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option long_options[] =
+    {
+        { "output",       required_argument, NULL, 'o' },
+        { "services",     required_argument, NULL, 'n' },
+        { "muxes",        required_argument, NULL, 'm' },
+        { "bitrate",      required_argument, NULL, 'b' },
+        { "duration",     required_argument, NULL, 'd' },
+        { "seed",         required_argument, NULL, 's' },
+        { "mjd",          required_argument, NULL, 'D' },
+        { "rate",         required_argument, NULL, 'r' },
+        { "cc-errors",    required_argument, NULL, 'c' },
+        { "crc-errors",   required_argument, NULL, 'e' },
+        { "version-bump", required_argument, NULL, 'v' },
+        { "help",         no_argument,       NULL, 'h' },
+        { NULL, 0, NULL, 0 }
+    };
+    const char *psz_output = NULL;
+    FILE *p_out = stdout;
+    gen_t gen;
+    int c;
+
+    memset(&gen, 0, sizeof(gen));
+    gen.i_seed = 1;
+    gen.i_services = 200;
+    gen.i_muxes = 4;
+    gen.i_mjd = 61041;
+    gen.i_bitrate = 38000000;
+    gen.i_duration = 10 * 1000000ULL;
+    memcpy(gen.intervals, gen_kind_intervals, sizeof(gen.intervals));
+
+    while ((c = getopt_long(argc, argv, "o:n:m:b:d:s:D:r:c:e:v:h", long_options, NULL)) != -1)
+    {
+        switch (c)
+        {
+            case 'o': psz_output = optarg; break;
+            case 'n': gen.i_services = atoi(optarg); break;
+            case 'm': gen.i_muxes = atoi(optarg); break;
+            case 'b': gen.i_bitrate = strtoull(optarg, NULL, 0); break;
+            case 'd': gen.i_duration = strtoull(optarg, NULL, 0) * 1000000ULL; break;
+            case 's': gen.i_seed = strtoull(optarg, NULL, 0); break;
+            case 'D': gen.i_mjd = strtoul(optarg, NULL, 0); break;
+            case 'c': gen.i_cc_error = strtoul(optarg, NULL, 0); break;
+            case 'e': gen.i_crc_error = strtoul(optarg, NULL, 0); break;
+            case 'v': gen.i_bump = strtoull(optarg, NULL, 0) * 1000ULL; break;
+            case 'r':
+                if (!parse_rate(&gen, optarg))
+                {
+                    fprintf(stderr, "gen_si: invalid rate '%s'\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'h':
+            default:
+                usage(argv[0]);
+                return (c == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (gen.i_services < 1 || gen.i_services > GEN_MAX_SERVICES ||
+        gen.i_muxes < 1 || gen.i_muxes > GEN_MAX_MUXES || gen.i_bitrate < 100000)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    gen.i_rand = gen_rand_seed(gen.i_seed, 0);
+
+    gen.p_dvbpsi = dvbpsi_new(&message, DVBPSI_MSG_WARN);
+    if (!gen.p_dvbpsi)
+        return EXIT_FAILURE;
+
+    if (psz_output && !(p_out = fopen(psz_output, "wb")))
+    {
+        fprintf(stderr, "gen_si: cannot open %s\n", psz_output);
+        dvbpsi_delete(gen.p_dvbpsi);
+        return EXIT_FAILURE;
+    }
+
+    bool b_ok = gen_tables_new(&gen) && gen_playout(&gen, p_out);
+
+    fprintf(stderr, "gen_si: %"PRIu64" SI packets, %"PRIu64" null packets, "
+            "%"PRIu64" CC errors, %"PRIu64" CRC errors, %"PRIu64" version bumps, "
+            "max lateness %"PRIu64" ms\n",
+            gen.i_si_packets, gen.i_null_packets, gen.i_cc_errors,
+            gen.i_crc_errors, gen.i_bumps, gen.i_max_late / 1000);
+    if (gen.i_max_late > 1000000)
+        fprintf(stderr, "gen_si: warning: the SI does not fit in the bitrate, "
+                "raise -b or the repetition intervals\n");
+
+    gen_tables_delete(&gen);
+    if (p_out != stdout)
+        fclose(p_out);
+    dvbpsi_delete(gen.p_dvbpsi);
+    return b_ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
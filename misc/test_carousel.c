@@ -0,0 +1,144 @@
+/*****************************************************************************
+ * test_carousel.c: carousel timing after a late emit
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/tables/pat.h"
+#include "../src/packetizer.h"
+#include "../src/carousel.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/pat.h>
+#include <dvbpsi/packetizer.h>
+#include <dvbpsi/carousel.h>
+#endif
+
+#define INTERVAL 100
+#define BUDGET   64
+
+static uint8_t packets[BUDGET * DVBPSI_TS_PACKET_SIZE];
+
+/* Emit at i_now and compare the number of packets with the expected one */
+static int Emit(dvbpsi_carousel_t *p_carousel, uint64_t i_now, size_t i_expected)
+{
+    size_t i_packets = dvbpsi_carousel_emit(p_carousel, i_now, packets, BUDGET);
+
+    if (i_packets == i_expected)
+        return 0;
+    fprintf(stderr, "  %zu packets emitted at %"PRIu64" instead of %zu\n",
+            i_packets, i_now, i_expected);
+    return 1;
+}
+
+/* Generate a PAT of i_programs programs, in sections of at most 2 programs */
+static dvbpsi_psi_section_t *GeneratePat(dvbpsi_t *p_dvbpsi, int i_programs)
+{
+    dvbpsi_psi_section_t *p_sections;
+    dvbpsi_pat_t pat;
+
+    dvbpsi_pat_init(&pat, 1, 0, true);
+    for (int i = 0; i < i_programs; i++)
+        dvbpsi_pat_program_add(&pat, i + 1, 0x100 + i);
+    p_sections = dvbpsi_pat_sections_generate(p_dvbpsi, &pat, 2);
+    dvbpsi_pat_empty(&pat);
+    return p_sections;
+}
+
+int main(void)
+{
+    dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+    dvbpsi_carousel_t *p_carousel = dvbpsi_carousel_new();
+    dvbpsi_psi_section_t *p_single, *p_multi;
+    dvbpsi_carousel_table_t *p_table;
+    uint64_t i_due;
+    int i_err = 0;
+
+    if (!p_dvbpsi || !p_carousel)
+        return 1;
+    p_single = GeneratePat(p_dvbpsi, 1);
+    p_multi = GeneratePat(p_dvbpsi, 8);
+    if (!p_single || !p_multi)
+        return 1;
+
+    fprintf(stdout, "carousel timing check:\n");
+
+    /* one section table: a late emit sends one copy then keeps the interval */
+    p_table = dvbpsi_carousel_add(p_carousel, 0, p_single, INTERVAL, 0);
+    if (!p_table)
+        return 1;
+    i_err |= Emit(p_carousel, 0, 1);
+    i_err |= Emit(p_carousel, 50, 0);
+    i_err |= Emit(p_carousel, 100, 1);
+    i_err |= Emit(p_carousel, 1000, 1);
+    i_err |= Emit(p_carousel, 1099, 0);
+    i_err |= Emit(p_carousel, 1100, 1);
+    /* less than one interval late: the cadence is kept */
+    i_err |= Emit(p_carousel, 1250, 1);
+    if (!dvbpsi_carousel_next_due(p_carousel, &i_due) || i_due != 1300)
+    {
+        fprintf(stderr, "  next cycle due at %"PRIu64" instead of 1300\n", i_due);
+        i_err = 1;
+    }
+    dvbpsi_carousel_remove(p_carousel, p_table);
+
+    /* four section table: the sections of a late cycle are spread again
+     * over the interval */
+    p_table = dvbpsi_carousel_add(p_carousel, 0, p_multi, INTERVAL, 2000);
+    if (!p_table)
+        return 1;
+    i_err |= Emit(p_carousel, 2000, 1);
+    i_err |= Emit(p_carousel, 2075, 3);
+    i_err |= Emit(p_carousel, 5000, 1);
+    i_err |= Emit(p_carousel, 5024, 0);
+    i_err |= Emit(p_carousel, 5025, 1);
+    i_err |= Emit(p_carousel, 5099, 2);
+    i_err |= Emit(p_carousel, 5100, 1);
+    dvbpsi_carousel_remove(p_carousel, p_table);
+
+    if (i_err)
+        fprintf(stderr, "carousel timing check FAILED !!!\n");
+    else
+        fprintf(stdout, "carousel timing check succeeded\n");
+
+    dvbpsi_DeletePSISections(p_single);
+    dvbpsi_DeletePSISections(p_multi);
+    dvbpsi_carousel_delete(p_carousel);
+    dvbpsi_delete(p_dvbpsi);
+    return i_err;
+}
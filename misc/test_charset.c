@@ -0,0 +1,222 @@
+/*****************************************************************************
+ * test_charset.c: DVB text conversion edge cases
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/charset.h"
+#else
+#include <dvbpsi/charset.h>
+#endif
+
+typedef struct
+{
+    const char     *psz_name;
+    const uint8_t  *p_text;
+    size_t          i_length;
+    const char     *psz_utf8;
+} text_vector_t;
+
+#define TEXT(name, utf8, ...) \
+    { name, (const uint8_t []){ __VA_ARGS__ }, \
+      sizeof((const uint8_t []){ __VA_ARGS__ }), utf8 }
+
+static const text_vector_t vectors[] =
+{
+    TEXT("ISO/IEC 6937", "Abc", 'A', 'b', 'c'),
+    TEXT("ISO/IEC 6937 diacritic", "\xc3\xa9t\xc3\xa9", 0xc2, 'e', 't', 0xc2, 'e'),
+    TEXT("ISO/IEC 6937 trailing diacritic", "a", 'a', 0xc2),
+    TEXT("ISO/IEC 6937 controls", "a\nb", 0x86, 'a', 0x87, 0x8a, 'b'),
+    TEXT("ISO/IEC 8859-5", "\xd0\xb0", 0x01, 0xd0),
+    TEXT("ISO/IEC 8859-2 by number", "\xc5\x82", 0x10, 0x00, 0x02, 0xb3),
+    TEXT("UCS-2 controls", "a\nb", 0x11, 0x00, 'a', 0xe0, 0x86, 0xe0, 0x8a,
+                                    0x00, 'b', 0xe0, 0x87),
+    TEXT("UCS-2 surrogate pair", "\xf0\x9f\x98\x80", 0x11, 0xd8, 0x3d, 0xde, 0x00),
+    TEXT("UCS-2 lone surrogate", "a", 0x11, 0xd8, 0x3d, 0x00, 'a'),
+    TEXT("UCS-2 odd length", "a", 0x11, 0x00, 'a', 0x00),
+    TEXT("UTF-8 C1 controls", "a\nb", 0x15, 'a', 0xc2, 0x86, 0xc2, 0x8a, 'b'),
+    TEXT("UTF-8 private use controls", "a\nb", 0x15, 'a', 0xee, 0x82, 0x86,
+                                               0xee, 0x82, 0x8a, 'b', 0xee, 0x82, 0x87),
+    TEXT("UTF-8 private use", "\xee\x82\xa0", 0x15, 0xee, 0x82, 0xa0),
+    TEXT("UTF-8 overlong", "\xef\xbf\xbd" "a", 0x15, 0xc0, 'a'),
+    TEXT("UTF-8 surrogate", "\xef\xbf\xbd", 0x15, 0xed, 0xa0, 0x80),
+    TEXT("UTF-8 truncated", "a\xef\xbf\xbd", 0x15, 'a', 0xe2, 0x82),
+    TEXT("UTF-8 bad continuation", "\xef\xbf\xbd" "a", 0x15, 0xe2, 'a'),
+    TEXT("compressed", "", 0x1f, 0x01, 'a'),
+    TEXT("unsupported double byte", "a\xef\xbf\xbd" "b", 0x13, 'a', 0xb0, 0xa1, 'b'),
+};
+
+static int CheckVectors(dvbpsi_text_cache_t *p_cache)
+{
+    char psz_utf8[64];
+    int i_err = 0;
+
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+    {
+        const text_vector_t *p_vector = &vectors[i];
+        size_t i_utf8 = dvbpsi_text_to_utf8(p_vector->p_text, p_vector->i_length,
+                                            psz_utf8, sizeof(psz_utf8));
+        if (i_utf8 != strlen(p_vector->psz_utf8) || strcmp(psz_utf8, p_vector->psz_utf8))
+        {
+            fprintf(stderr, "  %s: \"%s\" instead of \"%s\"\n",
+                    p_vector->psz_name, psz_utf8, p_vector->psz_utf8);
+            i_err = 1;
+        }
+
+        /* twice, converted then cached */
+        for (int j = 0; j < 2; j++)
+        {
+            memset(psz_utf8, 0, sizeof(psz_utf8));
+            i_utf8 = dvbpsi_text_cache_get(p_cache, p_vector->p_text, p_vector->i_length,
+                                           psz_utf8, sizeof(psz_utf8));
+            if (i_utf8 != strlen(p_vector->psz_utf8) || strcmp(psz_utf8, p_vector->psz_utf8))
+            {
+                fprintf(stderr, "  %s: cached \"%s\" instead of \"%s\"\n",
+                        p_vector->psz_name, psz_utf8, p_vector->psz_utf8);
+                i_err = 1;
+            }
+        }
+    }
+    return i_err;
+}
+
+/* The output is cut between two characters */
+static int CheckTruncation(dvbpsi_text_cache_t *p_cache)
+{
+    static const uint8_t p_text[] = { 0xc2, 'e', 0xc2, 'e' };
+    int i_err = 0;
+
+    for (size_t i_size = 0; i_size <= 5; i_size++)
+    {
+        static const char *const expected[] =
+            { "", "", "", "\xc3\xa9", "\xc3\xa9", "\xc3\xa9\xc3\xa9" };
+        char psz_utf8[6];
+        size_t i_utf8;
+
+        for (int j = 0; j < 2; j++)
+        {
+            memset(psz_utf8, 'x', sizeof(psz_utf8));
+            if (j == 0)
+                i_utf8 = dvbpsi_text_to_utf8(p_text, sizeof(p_text), i_size ? psz_utf8 : NULL,
+                                             i_size);
+            else
+                i_utf8 = dvbpsi_text_cache_get(p_cache, p_text, sizeof(p_text),
+                                               i_size ? psz_utf8 : NULL, i_size);
+            if (i_utf8 != 4 || (i_size && strcmp(psz_utf8, expected[i_size])))
+            {
+                fprintf(stderr, "  %s truncated to %zu bytes is wrong\n",
+                        j ? "cached string" : "string", i_size);
+                i_err = 1;
+            }
+        }
+    }
+    return i_err;
+}
+
+/* The cache stays below its size, evicting the least recently used */
+static int CheckEviction(void)
+{
+    dvbpsi_text_cache_t *p_cache = dvbpsi_text_cache_new(2048);
+    size_t i_count, i_bytes;
+    int i_err = 0;
+
+    if (!p_cache)
+        return 1;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        uint8_t p_text[16];
+        char psz_utf8[32], psz_expected[32];
+        int i_length = snprintf((char *)p_text, sizeof(p_text), "name %d", i);
+
+        /* a string used all along is kept */
+        dvbpsi_text_cache_get(p_cache, (const uint8_t *)"kept", 4, psz_utf8, sizeof(psz_utf8));
+        dvbpsi_text_cache_get(p_cache, p_text, i_length, psz_utf8, sizeof(psz_utf8));
+        snprintf(psz_expected, sizeof(psz_expected), "name %d", i);
+        if (strcmp(psz_utf8, psz_expected))
+        {
+            fprintf(stderr, "  \"%s\" instead of \"%s\"\n", psz_utf8, psz_expected);
+            i_err = 1;
+        }
+        i_count = dvbpsi_text_cache_count(p_cache, &i_bytes);
+        if (i_bytes > 2048)
+        {
+            fprintf(stderr, "  %zu strings use %zu bytes, over the limit\n", i_count, i_bytes);
+            i_err = 1;
+            break;
+        }
+    }
+
+    /* "kept" is the second most recently used string */
+    i_count = dvbpsi_text_cache_count(p_cache, &i_bytes);
+    dvbpsi_text_cache_get(p_cache, (const uint8_t *)"name 999", 8, NULL, 0);
+    dvbpsi_text_cache_get(p_cache, (const uint8_t *)"kept", 4, NULL, 0);
+    if (dvbpsi_text_cache_count(p_cache, NULL) != i_count)
+    {
+        fprintf(stderr, "  recently used strings were evicted\n");
+        i_err = 1;
+    }
+
+    dvbpsi_text_cache_clear(p_cache);
+    if (dvbpsi_text_cache_count(p_cache, &i_bytes) != 0 || i_bytes != 0)
+    {
+        fprintf(stderr, "  cache not empty after a clear\n");
+        i_err = 1;
+    }
+    dvbpsi_text_cache_delete(p_cache);
+    return i_err;
+}
+
+int main(void)
+{
+    dvbpsi_text_cache_t *p_cache = dvbpsi_text_cache_new(0);
+    int i_err = 0;
+
+    if (!p_cache)
+        return 1;
+
+    fprintf(stdout, "text conversion check:\n");
+    i_err |= CheckVectors(p_cache);
+    i_err |= CheckTruncation(p_cache);
+    i_err |= CheckEviction();
+    if (i_err)
+        fprintf(stderr, "text conversion check FAILED !!!\n");
+    else
+        fprintf(stdout, "text conversion check succeeded\n");
+
+    dvbpsi_text_cache_delete(p_cache);
+    return i_err;
+}
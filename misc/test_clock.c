@@ -0,0 +1,138 @@
+/*****************************************************************************
+ * test_clock.c: stream clock across drift, wrap and discontinuity
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/clock.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/clock.h>
+#endif
+
+#define WRAP        (INT64_C(300) << 33)
+#define SECOND      INT64_C(1000000)
+/* the PCR runs 80 ppm fast */
+#define DRIFT_PPM   80
+#define PCR_PERIOD  (SECOND / 25)
+
+static int64_t i_time;          /* UTC of the stream */
+static int64_t i_start;
+static int64_t i_pcr_start;
+
+static int64_t Pcr(void)
+{
+    int64_t i_ticks = (i_time - i_start) * 27;
+    return (i_pcr_start + i_ticks + i_ticks / 1000000 * DRIFT_PPM) % WRAP;
+}
+
+/* Run the stream for i_duration, with a UTC time every second or none, and
+ * stop at the time of the last PCR */
+static void Run(dvbpsi_clock_t *p_clock, int64_t i_duration, bool b_utc)
+{
+    for (int64_t i_end = i_time + i_duration; i_time < i_end; )
+    {
+        i_time += PCR_PERIOD;
+        dvbpsi_clock_pcr(p_clock, (uint64_t)Pcr(), false);
+        if (b_utc && i_time % SECOND == 0)
+            dvbpsi_clock_utc(p_clock, i_time);
+    }
+}
+
+static int Check(const char *psz_step, int64_t i_utc, int64_t i_max_error)
+{
+    if (i_utc == DVBPSI_CLOCK_UNDEFINED)
+    {
+        fprintf(stderr, "  %s: clock not synchronized\n", psz_step);
+        return 1;
+    }
+    if (i_utc - i_time > i_max_error || i_time - i_utc > i_max_error)
+    {
+        fprintf(stderr, "  %s: %"PRId64" us off\n", psz_step, i_utc - i_time);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    dvbpsi_clock_t *p_clock = dvbpsi_clock_new(0x100);
+    int64_t i_pcr;
+    int i_err = 0;
+
+    if (!p_clock)
+        return 1;
+
+    fprintf(stdout, "stream clock check:\n");
+
+    /* the PCR wraps 10 minutes after the start */
+    i_start = i_time = INT64_C(1700000000) * SECOND;
+    i_pcr_start = WRAP - INT64_C(27000000) * 600;
+    Run(p_clock, 30 * 60 * SECOND, true);
+    i_err |= Check("across the wrap", dvbpsi_clock_pcr_to_utc(p_clock, (uint64_t)Pcr()), 1000);
+
+    /* without UTC times for one hour, the rate keeps the mapping */
+    Run(p_clock, 60 * 60 * SECOND, false);
+    i_err |= Check("after one hour", dvbpsi_clock_now(p_clock), 5000);
+
+    /* a discontinuity keeps the mapping, within one PCR period */
+    i_pcr_start = (i_pcr_start + INT64_C(1234567890123)) % WRAP;
+    i_time += PCR_PERIOD;
+    dvbpsi_clock_pcr(p_clock, (uint64_t)Pcr(), true);
+    i_err |= Check("at the discontinuity", dvbpsi_clock_now(p_clock), PCR_PERIOD + 5000);
+    Run(p_clock, 10 * 60 * SECOND, true);
+    i_err |= Check("after the discontinuity", dvbpsi_clock_now(p_clock), 1000);
+
+    /* and back to the PCR */
+    i_pcr = dvbpsi_clock_utc_to_pcr(p_clock, i_time) - Pcr();
+    if (i_pcr > WRAP / 2)
+        i_pcr -= WRAP;
+    else if (i_pcr < -WRAP / 2)
+        i_pcr += WRAP;
+    if (i_pcr > 27 * 1000 || i_pcr < -27 * 1000)
+    {
+        fprintf(stderr, "  UTC to PCR: %"PRId64" ticks off\n", i_pcr);
+        i_err = 1;
+    }
+
+    if (i_err)
+        fprintf(stderr, "stream clock check FAILED !!!\n");
+    else
+        fprintf(stdout, "stream clock check succeeded\n");
+
+    dvbpsi_clock_delete(p_clock);
+    return i_err;
+}
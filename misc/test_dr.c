@@ -5,7 +5,10 @@
 #include "config.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <time.h>
 
 #if defined(HAVE_INTTYPES_H)
 #include <inttypes.h>
@@ -39,7 +42,7 @@ static int main_vstream_1(void)
   /* check b_multiple_frame_rate */
   BOZO_init_boolean(b_multiple_frame_rate, 0);
   BOZO_init_integer(i_frame_rate_code, 0);
-  s_decoded.b_mpeg2 = 0;
+  s_decoded.b_mpeg2 = false;
   BOZO_init_boolean(b_constrained_parameter, 0);
   BOZO_init_boolean(b_still_picture, 0);
   BOZO_begin_boolean(b_multiple_frame_rate)
@@ -51,7 +54,7 @@ static int main_vstream_1(void)
   /* check i_frame_rate_code */
   BOZO_init_boolean(b_multiple_frame_rate, 0);
   BOZO_init_integer(i_frame_rate_code, 0);
-  s_decoded.b_mpeg2 = 0;
+  s_decoded.b_mpeg2 = false;
   BOZO_init_boolean(b_constrained_parameter, 0);
   BOZO_init_boolean(b_still_picture, 0);
   BOZO_begin_integer(i_frame_rate_code, 4)
@@ -63,7 +66,7 @@ static int main_vstream_1(void)
   /* check b_constrained_parameter */
   BOZO_init_boolean(b_multiple_frame_rate, 0);
   BOZO_init_integer(i_frame_rate_code, 0);
-  s_decoded.b_mpeg2 = 0;
+  s_decoded.b_mpeg2 = false;
   BOZO_init_boolean(b_constrained_parameter, 0);
   BOZO_init_boolean(b_still_picture, 0);
   BOZO_begin_boolean(b_constrained_parameter)
@@ -75,7 +78,7 @@ static int main_vstream_1(void)
   /* check b_still_picture */
   BOZO_init_boolean(b_multiple_frame_rate, 0);
   BOZO_init_integer(i_frame_rate_code, 0);
-  s_decoded.b_mpeg2 = 0;
+  s_decoded.b_mpeg2 = false;
   BOZO_init_boolean(b_constrained_parameter, 0);
   BOZO_init_boolean(b_still_picture, 0);
   BOZO_begin_boolean(b_still_picture)
@@ -219,6 +222,7 @@ static int main_astream_(void)
   BOZO_init_boolean(b_free_format, 0);
   BOZO_init_integer(i_id, 0);
   BOZO_init_integer(i_layer, 0);
+  BOZO_init_boolean(b_variable_rate_audio_indicator, 0);
   BOZO_begin_boolean(b_free_format)
     BOZO_DOJOB(AStream);
     BOZO_check_boolean(b_free_format)
@@ -229,6 +233,7 @@ static int main_astream_(void)
   BOZO_init_boolean(b_free_format, 0);
   BOZO_init_integer(i_id, 0);
   BOZO_init_integer(i_layer, 0);
+  BOZO_init_boolean(b_variable_rate_audio_indicator, 0);
   BOZO_begin_integer(i_id, 1)
     BOZO_DOJOB(AStream);
     BOZO_check_integer(i_id, 1)
@@ -239,12 +244,24 @@ static int main_astream_(void)
   BOZO_init_boolean(b_free_format, 0);
   BOZO_init_integer(i_id, 0);
   BOZO_init_integer(i_layer, 0);
+  BOZO_init_boolean(b_variable_rate_audio_indicator, 0);
   BOZO_begin_integer(i_layer, 2)
     BOZO_DOJOB(AStream);
     BOZO_check_integer(i_layer, 2)
     BOZO_CLEAN();
   BOZO_end_integer(i_layer, 2)
 
+  /* check b_variable_rate_audio_indicator */
+  BOZO_init_boolean(b_free_format, 0);
+  BOZO_init_integer(i_id, 0);
+  BOZO_init_integer(i_layer, 0);
+  BOZO_init_boolean(b_variable_rate_audio_indicator, 0);
+  BOZO_begin_boolean(b_variable_rate_audio_indicator)
+    BOZO_DOJOB(AStream);
+    BOZO_check_boolean(b_variable_rate_audio_indicator)
+    BOZO_CLEAN();
+  BOZO_end_boolean(b_variable_rate_audio_indicator)
+
 
   BOZO_END(audio stream);
 
@@ -620,6 +637,58 @@ static int main_private_data_(void)
   return i_err;
 }
 
+/* smoothing buffer */
+static int main_smoothing_buffer_(void)
+{
+  BOZO_VARS(smoothing_buffer);
+  BOZO_START(smoothing buffer);
+
+  
+  /* check i_sb_leak_rate */
+  BOZO_init_integer(i_sb_leak_rate, 0);
+  BOZO_init_integer(i_sb_size, 0);
+  BOZO_begin_integer(i_sb_leak_rate, 22)
+    BOZO_DOJOB_NODUP(SmoothingBuffer);
+    BOZO_check_integer(i_sb_leak_rate, 22)
+    BOZO_CLEAN();
+  BOZO_end_integer(i_sb_leak_rate, 22)
+
+  /* check i_sb_size */
+  BOZO_init_integer(i_sb_leak_rate, 0);
+  BOZO_init_integer(i_sb_size, 0);
+  BOZO_begin_integer(i_sb_size, 22)
+    BOZO_DOJOB_NODUP(SmoothingBuffer);
+    BOZO_check_integer(i_sb_size, 22)
+    BOZO_CLEAN();
+  BOZO_end_integer(i_sb_size, 22)
+
+
+  BOZO_END(smoothing buffer);
+
+  return i_err;
+}
+
+/* STD */
+static int main_std_(void)
+{
+  BOZO_VARS(std);
+  BOZO_START(STD);
+
+  
+  /* check b_leak_valid_flag */
+  BOZO_init_boolean(b_leak_valid_flag, 0);
+  BOZO_begin_boolean(b_leak_valid_flag)
+    BOZO_DOJOB_NODUP(STD);
+    BOZO_check_boolean(b_leak_valid_flag)
+    BOZO_CLEAN();
+  BOZO_end_boolean(b_leak_valid_flag)
+
+
+  BOZO_END(STD);
+
+  return i_err;
+}
+
 /* service */
 static int main_service_(void)
 {
@@ -643,6 +712,914 @@ static int main_service_(void)
   return i_err;
 }
 
+BOZO_ROUNDTRIP(vstream, VStream)
+static void bozo_layout_vstream(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    bozo_integer(p_w, 1, 1, 1);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    break;
+  case 1:
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    bozo_integer(p_w, 1, 0, 0);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    bozo_integer(p_w, 2, 0, UINT64_MAX >> 62);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_reserved(p_w, 5);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(astream, AStream)
+static void bozo_layout_astream(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 1, 0, 1);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 2, 0, UINT64_MAX >> 62);
+    bozo_integer(p_w, 1, 0, 1);
+    bozo_reserved(p_w, 3);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(hierarchy, Hierarchy)
+static void bozo_layout_hierarchy(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_reserved(p_w, 4);
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    bozo_reserved(p_w, 2);
+    bozo_integer(p_w, 6, 0, UINT64_MAX >> 58);
+    bozo_reserved(p_w, 2);
+    bozo_integer(p_w, 6, 0, UINT64_MAX >> 58);
+    bozo_reserved(p_w, 2);
+    bozo_integer(p_w, 6, 0, UINT64_MAX >> 58);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(registration, Registration)
+static void bozo_layout_registration(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 32, 0, UINT64_MAX >> 32);
+    bozo_bytes(p_w, 0, 251, 0);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(ds_alignment, DSAlignment)
+static void bozo_layout_ds_alignment(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(target_bg_grid, TargetBgGrid)
+static void bozo_layout_target_bg_grid(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 14, 0, UINT64_MAX >> 50);
+    bozo_integer(p_w, 14, 0, UINT64_MAX >> 50);
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(vwindow, VWindow)
+static void bozo_layout_vwindow(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 14, 0, UINT64_MAX >> 50);
+    bozo_integer(p_w, 14, 0, UINT64_MAX >> 50);
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(ca, CA)
+static void bozo_layout_ca(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_reserved(p_w, 3);
+    bozo_integer(p_w, 13, 0, UINT64_MAX >> 51);
+    bozo_bytes(p_w, 0, 251, 0);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(iso639, ISO639)
+static void bozo_layout_iso639(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 1, 63);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 24, 0, UINT64_MAX >> 40);
+        bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(system_clock, SystemClock)
+static void bozo_layout_system_clock(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 1, 0, 1);
+    bozo_reserved(p_w, 1);
+    bozo_integer(p_w, 6, 0, UINT64_MAX >> 58);
+    bozo_integer(p_w, 3, 0, UINT64_MAX >> 61);
+    bozo_reserved(p_w, 5);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(mx_buff_utilization, MxBuffUtilization)
+static void bozo_layout_mx_buff_utilization(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 1, 0, 1);
+    bozo_integer(p_w, 15, 0, UINT64_MAX >> 49);
+    bozo_integer(p_w, 3, 0, UINT64_MAX >> 61);
+    bozo_reserved(p_w, 5);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(copyright, Copyright)
+static void bozo_layout_copyright(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 32, 0, UINT64_MAX >> 32);
+    bozo_bytes(p_w, 0, 251, 0);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(max_bitrate, MaxBitrate)
+static void bozo_layout_max_bitrate(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_reserved(p_w, 2);
+    bozo_integer(p_w, 22, 0, UINT64_MAX >> 42);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(private_data, PrivateData)
+static void bozo_layout_private_data(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 32, 0, UINT64_MAX >> 32);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP_NODUP(smoothing_buffer, SmoothingBuffer)
+static void bozo_layout_smoothing_buffer(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_reserved(p_w, 2);
+    bozo_integer(p_w, 22, 0, UINT64_MAX >> 42);
+    bozo_reserved(p_w, 2);
+    bozo_integer(p_w, 22, 0, UINT64_MAX >> 42);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP_NODUP(std, STD)
+static void bozo_layout_std(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_reserved(p_w, 7);
+    bozo_integer(p_w, 1, 0, 1);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP_NODUP(ibp, IBP)
+static void bozo_layout_ibp(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 14, 1, UINT64_MAX >> 50);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP_NODUP(mpeg4_video, MPEG4Video)
+static void bozo_layout_mpeg4_video(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP_NODUP(mpeg4_audio, MPEG4Audio)
+static void bozo_layout_mpeg4_audio(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP_NODUP(content_labelling, ContentLabelling)
+static void bozo_layout_content_labelling(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 16, 0, 65534);
+    bozo_integer(p_w, 1, 0, 0);
+    bozo_integer(p_w, 4, 0, 0);
+    bozo_reserved(p_w, 3);
+    bozo_bytes(p_w, 0, 252, 0);
+    break;
+  case 1:
+    bozo_integer(p_w, 16, 65535, 65535);
+    bozo_integer(p_w, 32, 0, UINT64_MAX >> 32);
+    bozo_integer(p_w, 1, 1, 1);
+    bozo_integer(p_w, 4, 1, 1);
+    bozo_reserved(p_w, 3);
+    bozo_bytes(p_w, 1, 100, 8);
+    bozo_reserved(p_w, 7);
+    bozo_integer(p_w, 33, 0, UINT64_MAX >> 31);
+    bozo_reserved(p_w, 7);
+    bozo_integer(p_w, 33, 0, UINT64_MAX >> 31);
+    bozo_bytes(p_w, 0, 100, 0);
+    break;
+  case 2:
+    bozo_integer(p_w, 16, 0, 65534);
+    bozo_integer(p_w, 1, 0, 0);
+    bozo_integer(p_w, 4, 2, 2);
+    bozo_reserved(p_w, 3);
+    bozo_reserved(p_w, 7);
+    bozo_integer(p_w, 33, 0, UINT64_MAX >> 31);
+    bozo_reserved(p_w, 7);
+    bozo_integer(p_w, 33, 0, UINT64_MAX >> 31);
+    bozo_reserved(p_w, 1);
+    bozo_integer(p_w, 7, 0, UINT64_MAX >> 57);
+    bozo_bytes(p_w, 0, 241, 0);
+    break;
+  case 3:
+    bozo_integer(p_w, 16, 0, 65534);
+    bozo_integer(p_w, 1, 1, 1);
+    bozo_integer(p_w, 4, 3, 7);
+    bozo_reserved(p_w, 3);
+    bozo_bytes(p_w, 1, 100, 8);
+    bozo_bytes(p_w, 0, 100, 8);
+    bozo_bytes(p_w, 0, 40, 0);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(network_name, NetworkName)
+static void bozo_layout_network_name(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_bytes(p_w, 0, 255, 0);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(service_list, ServiceList)
+static void bozo_layout_service_list(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 1, 63);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+        bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(stuffing, Stuffing)
+static void bozo_layout_stuffing(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_bytes(p_w, 0, 255, 0);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(sat_deliv_sys, SatDelivSys)
+static void bozo_layout_sat_deliv_sys(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 32, 0, UINT64_MAX >> 32);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 2, 0, UINT64_MAX >> 62);
+    bozo_integer(p_w, 2, 0, UINT64_MAX >> 62);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 2, 0, UINT64_MAX >> 62);
+    bozo_integer(p_w, 28, 0, UINT64_MAX >> 36);
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(cable_deliv_sys, CableDelivSys)
+static void bozo_layout_cable_deliv_sys(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 32, 0, UINT64_MAX >> 32);
+    bozo_reserved(p_w, 12);
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    bozo_integer(p_w, 28, 0, UINT64_MAX >> 36);
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(vbi, VBIData)
+static void bozo_layout_vbi(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 1, 85);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+        {
+          unsigned int i1_pos = bozo_begin(p_w, 8);
+          int i1_count = bozo_count(p_w, 0, 255);
+          for(int i1 = 0; i1 < i1_count; i1++)
+          {
+            bozo_reserved(p_w, 2);
+            bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+            bozo_integer(p_w, 5, 0, UINT64_MAX >> 59);          }
+          bozo_end(p_w, i1_pos, 0, 8, i1_count);
+        }      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(bouquet_name, BouquetName)
+static void bozo_layout_bouquet_name(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_bytes(p_w, 0, 255, 0);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(service, Service)
+static void bozo_layout_service(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    bozo_bytes(p_w, 0, 252, 8);
+    bozo_bytes(p_w, 0, 252, 8);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(country_availability, CountryAvailability)
+static void bozo_layout_country_availability(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_reserved(p_w, 7);
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 0, 83);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 24, 0, UINT64_MAX >> 40);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(linkage, Linkage)
+static void bozo_layout_linkage(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 8, 0, 7);
+    bozo_bytes(p_w, 0, 246, 0);
+    break;
+  case 1:
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 8, 8, 8);
+    bozo_integer(p_w, 4, 1, 3);
+    bozo_reserved(p_w, 3);
+    bozo_integer(p_w, 1, 0, 0);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_bytes(p_w, 0, 242, 0);
+    break;
+  case 2:
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 8, 8, 8);
+    bozo_integer(p_w, 4, 0, 0);
+    bozo_reserved(p_w, 3);
+    bozo_integer(p_w, 1, 1, 1);
+    bozo_bytes(p_w, 0, 246, 0);
+    break;
+  case 3:
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 8, 13, 13);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_reserved(p_w, 6);
+    bozo_bytes(p_w, 0, 245, 0);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(nvod_ref, NVODReference)
+static void bozo_layout_nvod_ref(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 1, 42);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+        bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+        bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(tshifted_service, TimeShiftedService)
+static void bozo_layout_tshifted_service(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(short_event, ShortEvent)
+static void bozo_layout_short_event(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 24, 0, UINT64_MAX >> 40);
+    bozo_bytes(p_w, 0, 250, 8);
+    bozo_bytes(p_w, 0, 250, 8);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(extended_event, ExtendedEvent)
+static void bozo_layout_extended_event(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    bozo_integer(p_w, 24, 0, UINT64_MAX >> 40);
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 8);
+      int i0_count = bozo_count(p_w, 0, 126);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_bytes(p_w, 0, 249, 8);
+        bozo_bytes(p_w, 0, 249, 8);      }
+      bozo_end(p_w, i0_pos, 8, 0, i0_count);
+    }
+    bozo_bytes(p_w, 0, 249, 8);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(tshifted_ev, TimeShiftedEvent)
+static void bozo_layout_tshifted_ev(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(component, Component)
+static void bozo_layout_component(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_reserved(p_w, 4);
+    bozo_integer(p_w, 4, 0, UINT64_MAX >> 60);
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    bozo_integer(p_w, 24, 0, UINT64_MAX >> 40);
+    bozo_bytes(p_w, 0, 249, 0);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(stream_identifier, StreamIdentifier)
+static void bozo_layout_stream_identifier(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(ca_identifier, CAIdentifier)
+static void bozo_layout_ca_identifier(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 1, 127);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(content, Content)
+static void bozo_layout_content(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 0, 64);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+        bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(parental_rating, ParentalRating)
+static void bozo_layout_parental_rating(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 0, 63);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 24, 0, UINT64_MAX >> 40);
+        bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(teletext, Teletext)
+static void bozo_layout_teletext(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 1, 51);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 24, 0, UINT64_MAX >> 40);
+        bozo_integer(p_w, 5, 0, UINT64_MAX >> 59);
+        bozo_integer(p_w, 3, 0, UINT64_MAX >> 61);
+        bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(local_time_offset, LocalTimeOffset)
+static void bozo_layout_local_time_offset(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 0, 19);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 24, 0, UINT64_MAX >> 40);
+        bozo_integer(p_w, 6, 0, UINT64_MAX >> 58);
+        bozo_reserved(p_w, 1);
+        bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+        bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+        bozo_integer(p_w, 40, 0, UINT64_MAX >> 24);
+        bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(subtitling, Subtitling)
+static void bozo_layout_subtitling(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 1, 20);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 24, 0, UINT64_MAX >> 40);
+        bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+        bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+        bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(terr_deliv_sys, TerrDelivSys)
+static void bozo_layout_terr_deliv_sys(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 32, 0, UINT64_MAX >> 32);
+    bozo_integer(p_w, 3, 0, UINT64_MAX >> 61);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_reserved(p_w, 2);
+    bozo_integer(p_w, 2, 0, UINT64_MAX >> 62);
+    bozo_integer(p_w, 3, 0, UINT64_MAX >> 61);
+    bozo_integer(p_w, 3, 0, UINT64_MAX >> 61);
+    bozo_integer(p_w, 3, 0, UINT64_MAX >> 61);
+    bozo_integer(p_w, 2, 0, UINT64_MAX >> 62);
+    bozo_integer(p_w, 2, 0, UINT64_MAX >> 62);
+    bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+    bozo_reserved(p_w, 32);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(PDC, PDC)
+static void bozo_layout_PDC(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_reserved(p_w, 4);
+    bozo_integer(p_w, 20, 0, UINT64_MAX >> 44);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(aac, AAC)
+static void bozo_layout_aac(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    break;
+  case 1:
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    bozo_integer(p_w, 1, 0, 0);
+    bozo_reserved(p_w, 7);
+    bozo_bytes(p_w, 0, 253, 0);
+    break;
+  case 2:
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    bozo_integer(p_w, 1, 1, 1);
+    bozo_reserved(p_w, 7);
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    bozo_bytes(p_w, 0, 252, 0);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(lcn, LCN)
+static void bozo_layout_lcn(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 0);
+      int i0_count = bozo_count(p_w, 0, 63);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 16, 0, UINT64_MAX >> 48);
+        bozo_integer(p_w, 1, 0, UINT64_MAX >> 63);
+        bozo_reserved(p_w, 5);
+        bozo_integer(p_w, 10, 0, UINT64_MAX >> 54);      }
+      bozo_end(p_w, i0_pos, 0, 0, i0_count);
+    }
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(cuei, CUEI)
+static void bozo_layout_cuei(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+    break;
+  }
+}
+
+BOZO_ROUNDTRIP(service_location, ServiceLocation)
+static void bozo_layout_service_location(bozo_writer_t * p_w)
+{
+  switch(p_w->i_layout)
+  {
+  case 0:
+    bozo_reserved(p_w, 3);
+    bozo_integer(p_w, 13, 0, UINT64_MAX >> 51);
+    {
+      unsigned int i0_pos = bozo_begin(p_w, 8);
+      int i0_count = bozo_count(p_w, 0, 42);
+      for(int i0 = 0; i0 < i0_count; i0++)
+      {
+        bozo_integer(p_w, 8, 0, UINT64_MAX >> 56);
+        bozo_reserved(p_w, 3);
+        bozo_integer(p_w, 13, 0, UINT64_MAX >> 51);
+        bozo_integer(p_w, 24, 0, UINT64_MAX >> 40);      }
+      bozo_end(p_w, i0_pos, 0, 8, i0_count);
+    }
+    break;
+  }
+}
+
+
+static const bozo_roundtrip_t p_roundtrips[] =
+{
+  BOZO_ROUNDTRIP_ENTRY("video stream", 0x02, vstream, 2)
+  BOZO_ROUNDTRIP_ENTRY("audio stream", 0x03, astream, 1)
+  BOZO_ROUNDTRIP_ENTRY("hierarchy", 0x04, hierarchy, 1)
+  BOZO_ROUNDTRIP_ENTRY("registration", 0x05, registration, 1)
+  BOZO_ROUNDTRIP_ENTRY("data stream alignment", 0x06, ds_alignment, 1)
+  BOZO_ROUNDTRIP_ENTRY("target background grid", 0x07, target_bg_grid, 1)
+  BOZO_ROUNDTRIP_ENTRY("video window", 0x08, vwindow, 1)
+  BOZO_ROUNDTRIP_ENTRY("conditional access", 0x09, ca, 1)
+  BOZO_ROUNDTRIP_ENTRY("ISO 639 language", 0x0a, iso639, 1)
+  BOZO_ROUNDTRIP_ENTRY("system clock", 0x0b, system_clock, 1)
+  BOZO_ROUNDTRIP_ENTRY("multiplex buffer utilization", 0x0c, mx_buff_utilization, 1)
+  BOZO_ROUNDTRIP_ENTRY("copyright", 0x0d, copyright, 1)
+  BOZO_ROUNDTRIP_ENTRY("maximum bitrate", 0x0e, max_bitrate, 1)
+  BOZO_ROUNDTRIP_ENTRY("private data indicator", 0x0f, private_data, 1)
+  BOZO_ROUNDTRIP_ENTRY("smoothing buffer", 0x10, smoothing_buffer, 1)
+  BOZO_ROUNDTRIP_ENTRY("STD", 0x11, std, 1)
+  BOZO_ROUNDTRIP_ENTRY("IBP", 0x12, ibp, 1)
+  BOZO_ROUNDTRIP_ENTRY("MPEG-4 video", 0x1b, mpeg4_video, 1)
+  BOZO_ROUNDTRIP_ENTRY("MPEG-4 audio", 0x1c, mpeg4_audio, 1)
+  BOZO_ROUNDTRIP_ENTRY("content labelling", 0x24, content_labelling, 4)
+  BOZO_ROUNDTRIP_ENTRY("network name", 0x40, network_name, 1)
+  BOZO_ROUNDTRIP_ENTRY("service list", 0x41, service_list, 1)
+  BOZO_ROUNDTRIP_ENTRY("stuffing", 0x42, stuffing, 1)
+  BOZO_ROUNDTRIP_ENTRY("satellite delivery system", 0x43, sat_deliv_sys, 1)
+  BOZO_ROUNDTRIP_ENTRY("cable delivery system", 0x44, cable_deliv_sys, 1)
+  BOZO_ROUNDTRIP_ENTRY("VBI data", 0x45, vbi, 1)
+  BOZO_ROUNDTRIP_ENTRY("bouquet name", 0x47, bouquet_name, 1)
+  BOZO_ROUNDTRIP_ENTRY("service", 0x48, service, 1)
+  BOZO_ROUNDTRIP_ENTRY("country availability", 0x49, country_availability, 1)
+  BOZO_ROUNDTRIP_ENTRY("linkage", 0x4a, linkage, 4)
+  BOZO_ROUNDTRIP_ENTRY("NVOD reference", 0x4b, nvod_ref, 1)
+  BOZO_ROUNDTRIP_ENTRY("time shifted service", 0x4c, tshifted_service, 1)
+  BOZO_ROUNDTRIP_ENTRY("short event", 0x4d, short_event, 1)
+  BOZO_ROUNDTRIP_ENTRY("extended event", 0x4e, extended_event, 1)
+  BOZO_ROUNDTRIP_ENTRY("time shifted event", 0x4f, tshifted_ev, 1)
+  BOZO_ROUNDTRIP_ENTRY("component", 0x50, component, 1)
+  BOZO_ROUNDTRIP_ENTRY("stream identifier", 0x52, stream_identifier, 1)
+  BOZO_ROUNDTRIP_ENTRY("CA identifier", 0x53, ca_identifier, 1)
+  BOZO_ROUNDTRIP_ENTRY("content", 0x54, content, 1)
+  BOZO_ROUNDTRIP_ENTRY("parental rating", 0x55, parental_rating, 1)
+  BOZO_ROUNDTRIP_ENTRY("teletext", 0x56, teletext, 1)
+  BOZO_ROUNDTRIP_ENTRY("local time offset", 0x58, local_time_offset, 1)
+  BOZO_ROUNDTRIP_ENTRY("subtitling", 0x59, subtitling, 1)
+  BOZO_ROUNDTRIP_ENTRY("terrestrial delivery system", 0x5a, terr_deliv_sys, 1)
+  BOZO_ROUNDTRIP_ENTRY("PDC", 0x69, PDC, 1)
+  BOZO_ROUNDTRIP_ENTRY("AAC", 0x7c, aac, 3)
+  BOZO_ROUNDTRIP_ENTRY("logical channel number", 0x83, lcn, 1)
+  BOZO_ROUNDTRIP_ENTRY("cue identifier", 0x8a, cuei, 1)
+  BOZO_ROUNDTRIP_ENTRY("service location", 0xa1, service_location, 1)
+};
 
 /* main function */
 int main(void)
@@ -663,8 +1640,12 @@ int main(void)
   i_err |= main_copyright_();
   i_err |= main_max_bitrate_();
   i_err |= main_private_data_();
+  i_err |= main_smoothing_buffer_();
+  i_err |= main_std_();
   i_err |= main_service_();
 
+  i_err |= bozo_roundtrips(p_roundtrips, sizeof(p_roundtrips) / sizeof(p_roundtrips[0]));
+
   if(i_err)
     fprintf(stderr, "At least one test has FAILED !!!\n");
   else
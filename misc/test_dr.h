@@ -42,6 +42,14 @@
   p_descriptor = dvbpsi_Gen##fname##Dr(&s_decoded, 0);                  \
   p_new_decoded = dvbpsi_Decode##fname##Dr(p_descriptor);
 
+/* generators without the b_duplicate argument */
+#define BOZO_DOJOB_NODUP(fname)                                         \
+  if(!(i_loop_count & 0xffff))                                          \
+    fprintf(stdout, "\r  iteration count: %22"PRI64d, i_loop_count);       \
+  i_loop_count++;                                                       \
+  p_descriptor = dvbpsi_Gen##fname##Dr(&s_decoded);                     \
+  p_new_decoded = dvbpsi_Decode##fname##Dr(p_descriptor);
+
 #define BOZO_START(name)                                                \
   fprintf(stdout, "\"%s\" descriptor check:\n", #name);
 
@@ -120,3 +128,311 @@
             s_decoded.name, p_new_decoded->name);                       \
     i_err = 1;                                                          \
   }
+
+
+/* round-trips
+ *
+ * Every decoder and generator pair is first fed the payloads built from its
+ * layout in dr.xml: random field values, reserved bits set, and the
+ * variable parts at their minimum and maximum lengths, then at random
+ * lengths. The decoder must accept them all. It is then fed random payloads
+ * of each length from 0 to 255, which it may refuse but must not overrun.
+ * Whenever the decoder accepts a payload, the decoded structure is
+ * generated, decoded again and generated again, and the two generated
+ * descriptors must be identical. */
+typedef struct
+{
+  uint8_t p_data[255];
+  unsigned int i_bits;          /* bits written */
+  bool b_full;                  /* a field did not fit */
+  unsigned int i_layout;        /* layout of the descriptor to build */
+  int i_case;                   /* BOZO_RT_MIN, BOZO_RT_MAX or random */
+  unsigned int i_shift;         /* shrink of the lengths until they fit */
+} bozo_writer_t;
+
+#define BOZO_RT_MIN 0
+#define BOZO_RT_MAX 1
+
+typedef struct
+{
+  const char * psz_name;
+  uint8_t i_tag;
+  void * (* pf_decode)(dvbpsi_descriptor_t *);
+  dvbpsi_descriptor_t * (* pf_gen)(void *);
+  void (* pf_layout)(bozo_writer_t *);
+  unsigned int i_layouts;
+} bozo_roundtrip_t;
+
+#define BOZO_ROUNDTRIP(sname, fname)                                    \
+static void * bozo_decode_##sname(dvbpsi_descriptor_t * p_descriptor)   \
+{                                                                       \
+  return dvbpsi_Decode##fname##Dr(p_descriptor);                        \
+}                                                                       \
+static dvbpsi_descriptor_t * bozo_gen_##sname(void * p_decoded)         \
+{                                                                       \
+  return dvbpsi_Gen##fname##Dr(p_decoded, false);                       \
+}
+
+#define BOZO_ROUNDTRIP_NODUP(sname, fname)                              \
+static void * bozo_decode_##sname(dvbpsi_descriptor_t * p_descriptor)   \
+{                                                                       \
+  return dvbpsi_Decode##fname##Dr(p_descriptor);                        \
+}                                                                       \
+static dvbpsi_descriptor_t * bozo_gen_##sname(void * p_decoded)         \
+{                                                                       \
+  return dvbpsi_Gen##fname##Dr(p_decoded);                              \
+}
+
+#define BOZO_ROUNDTRIP_ENTRY(name, tag, sname, layouts)                 \
+  { name, tag, bozo_decode_##sname, bozo_gen_##sname, bozo_layout_##sname, layouts },
+
+#define BOZO_RT_PAYLOADS 8              /* random payloads per length */
+#define BOZO_RT_CLOCKS (CLOCKS_PER_SEC / 100) /* timing of each figure */
+
+static uint32_t bozo_random(void)
+{
+  /* xorshift, with a fixed seed so that the failures reproduce */
+  static uint32_t i_state = 0x2545f491;
+  i_state ^= i_state << 13;
+  i_state ^= i_state >> 17;
+  i_state ^= i_state << 5;
+  return i_state;
+}
+
+/* layout writer */
+static void bozo_put_at(bozo_writer_t * p_w, unsigned int i_pos, uint64_t i_value,
+                        unsigned int i_bits)
+{
+  for(unsigned int i = i_bits; i-- > 0; i_pos++)
+  {
+    uint8_t i_mask = 0x80 >> (i_pos & 7);
+    if((i_value >> i) & 1)
+      p_w->p_data[i_pos >> 3] |= i_mask;
+    else
+      p_w->p_data[i_pos >> 3] &= ~i_mask;
+  }
+}
+
+static void bozo_put(bozo_writer_t * p_w, uint64_t i_value, unsigned int i_bits)
+{
+  if(p_w->b_full || p_w->i_bits + i_bits > 8 * sizeof(p_w->p_data))
+  {
+    p_w->b_full = true;
+    return;
+  }
+  bozo_put_at(p_w, p_w->i_bits, i_value, i_bits);
+  p_w->i_bits += i_bits;
+}
+
+static void bozo_integer(bozo_writer_t * p_w, unsigned int i_bits, uint64_t i_min,
+                         uint64_t i_max)
+{
+  uint64_t i_value = ((uint64_t)bozo_random() << 32) | bozo_random();
+  if(i_max - i_min != UINT64_MAX)
+    i_value = i_min + i_value % (i_max - i_min + 1);
+  bozo_put(p_w, i_value, i_bits);
+}
+
+static void bozo_reserved(bozo_writer_t * p_w, unsigned int i_bits)
+{
+  bozo_put(p_w, UINT64_MAX, i_bits);
+}
+
+static int bozo_count(bozo_writer_t * p_w, int i_min, int i_max)
+{
+  int i_range = (i_max - i_min) >> p_w->i_shift;
+  if(p_w->i_case == BOZO_RT_MIN)
+    return i_min;
+  if(p_w->i_case == BOZO_RT_MAX)
+    return i_min + i_range;
+  return i_min + bozo_random() % (i_range + 1);
+}
+
+/* Leave room for a length or a count, written by bozo_end() */
+static unsigned int bozo_begin(bozo_writer_t * p_w, unsigned int i_bits)
+{
+  unsigned int i_pos = p_w->i_bits;
+  bozo_put(p_w, 0, i_bits);
+  return i_pos;
+}
+
+static void bozo_end(bozo_writer_t * p_w, unsigned int i_pos, unsigned int i_lengthbits,
+                     unsigned int i_countbits, int i_count)
+{
+  uint64_t i_value = i_countbits ? (uint64_t)i_count
+                   : (p_w->i_bits - i_pos - i_lengthbits) / 8;
+  unsigned int i_bits = i_countbits ? i_countbits : i_lengthbits;
+  if(p_w->b_full || !i_bits)
+    return;
+  if(i_value >> i_bits)
+    p_w->b_full = true;
+  else
+    bozo_put_at(p_w, i_pos, i_value, i_bits);
+}
+
+static void bozo_bytes(bozo_writer_t * p_w, int i_min, int i_max, unsigned int i_lengthbits)
+{
+  unsigned int i_pos = bozo_begin(p_w, i_lengthbits);
+  int i_count = bozo_count(p_w, i_min, i_max);
+  for(int i = 0; i < i_count; i++)
+    bozo_put(p_w, bozo_random(), 8);
+  bozo_end(p_w, i_pos, i_lengthbits, 0, i_count);
+}
+
+/* Build a payload of the layout, shrinking the variable parts until it fits */
+static dvbpsi_descriptor_t * bozo_layout(const bozo_roundtrip_t * p_rt, unsigned int i_layout,
+                                         int i_case)
+{
+  for(unsigned int i_shift = 0; i_shift < 9; i_shift++)
+  {
+    bozo_writer_t w;
+    memset(&w, 0, sizeof(w));
+    w.i_layout = i_layout;
+    w.i_case = i_case;
+    w.i_shift = i_shift;
+    p_rt->pf_layout(&w);
+    if(!w.b_full)
+      return dvbpsi_NewDescriptor(p_rt->i_tag, (w.i_bits + 7) / 8, w.p_data);
+  }
+  return NULL;
+}
+
+static void bozo_dump(const char * psz_what, const dvbpsi_descriptor_t * p_descriptor)
+{
+  fprintf(stderr, "  %s:", psz_what);
+  if(p_descriptor)
+    for(int i = 0; i < p_descriptor->i_length; i++)
+      fprintf(stderr, " %02x", p_descriptor->p_data[i]);
+  else
+    fprintf(stderr, " none");
+  fprintf(stderr, "\n");
+}
+
+static bool bozo_equal(const dvbpsi_descriptor_t * p_a, const dvbpsi_descriptor_t * p_b)
+{
+  return p_a && p_b && p_a->i_tag == p_b->i_tag && p_a->i_length == p_b->i_length
+      && !memcmp(p_a->p_data, p_b->p_data, p_a->i_length);
+}
+
+/* Decode and generate p_descriptor again and again, ns per call */
+static void bozo_time(const bozo_roundtrip_t * p_rt, dvbpsi_descriptor_t * p_descriptor,
+                      double * pf_decode, double * pf_gen)
+{
+  long long unsigned int i_count = 0;
+  clock_t i_start = clock(), i_end;
+  do
+  {
+    for(int i = 0; i < 1000; i++)
+    {
+      free(p_descriptor->p_decoded);
+      p_descriptor->p_decoded = NULL;
+      p_rt->pf_decode(p_descriptor);
+    }
+    i_count += 1000;
+  } while((i_end = clock()) - i_start < BOZO_RT_CLOCKS);
+  *pf_decode = (double)(i_end - i_start) * 1e9 / CLOCKS_PER_SEC / i_count;
+
+  i_count = 0;
+  i_start = clock();
+  do
+  {
+    for(int i = 0; i < 1000; i++)
+      dvbpsi_DeleteDescriptors(p_rt->pf_gen(p_descriptor->p_decoded));
+    i_count += 1000;
+  } while((i_end = clock()) - i_start < BOZO_RT_CLOCKS);
+  *pf_gen = (double)(i_end - i_start) * 1e9 / CLOCKS_PER_SEC / i_count;
+}
+
+/* Decode p_src, which b_layout tells to be built from the layout, then
+ * generate, decode and generate again. The longest generated descriptor is
+ * kept in *pp_sample for the timing. p_src is deleted. */
+static int bozo_check(const bozo_roundtrip_t * p_rt, dvbpsi_descriptor_t * p_src,
+                      bool b_layout, dvbpsi_descriptor_t ** pp_sample,
+                      unsigned int * pi_accepted)
+{
+  dvbpsi_descriptor_t * p_gen1 = NULL, * p_gen2 = NULL;
+  int i_err = 0;
+
+  if(!p_src)
+    return 1;
+  if(p_rt->pf_decode(p_src))
+  {
+    (*pi_accepted)++;
+    p_gen1 = p_rt->pf_gen(p_src->p_decoded);
+    if(p_gen1 && p_rt->pf_decode(p_gen1))
+      p_gen2 = p_rt->pf_gen(p_gen1->p_decoded);
+    if(!bozo_equal(p_gen1, p_gen2))
+    {
+      fflush(stdout);
+      fprintf(stderr, "Error: \"%s\" round-trip, length %d\n", p_rt->psz_name, p_src->i_length);
+      bozo_dump("payload", p_src);
+      bozo_dump("generated", p_gen1);
+      bozo_dump("generated again", p_gen2);
+      i_err = 1;
+    }
+  }
+  else if(b_layout)
+  {
+    fflush(stdout);
+    fprintf(stderr, "Error: \"%s\" decoder refuses a payload of its layout, length %d\n",
+            p_rt->psz_name, p_src->i_length);
+    bozo_dump("payload", p_src);
+    i_err = 1;
+  }
+  dvbpsi_DeleteDescriptors(p_src);
+  dvbpsi_DeleteDescriptors(p_gen2);
+  if(p_gen1 && !i_err && (!*pp_sample || p_gen1->i_length >= (*pp_sample)->i_length))
+  {
+    dvbpsi_DeleteDescriptors(*pp_sample);
+    *pp_sample = p_gen1;
+  }
+  else
+    dvbpsi_DeleteDescriptors(p_gen1);
+  return i_err;
+}
+
+static int bozo_roundtrip(const bozo_roundtrip_t * p_rt)
+{
+  dvbpsi_descriptor_t * p_sample = NULL;
+  unsigned int i_accepted = 0;
+  int i_err = 0;
+
+  for(unsigned int i_layout = 0; i_layout < p_rt->i_layouts && !i_err; i_layout++)
+    for(int i_case = 0; i_case < 2 + BOZO_RT_PAYLOADS && !i_err; i_case++)
+      i_err = bozo_check(p_rt, bozo_layout(p_rt, i_layout, i_case), true,
+                         &p_sample, &i_accepted);
+
+  for(int i_length = 0; i_length < 256 && !i_err; i_length++)
+    for(int i_payload = 0; i_payload < BOZO_RT_PAYLOADS && !i_err; i_payload++)
+    {
+      uint8_t p_data[255];
+      for(int i = 0; i < i_length; i++)
+        p_data[i] = bozo_random();
+      i_err = bozo_check(p_rt, dvbpsi_NewDescriptor(p_rt->i_tag, i_length, p_data), false,
+                         &p_sample, &i_accepted);
+    }
+
+  if(!i_err)
+  {
+    double f_decode, f_gen;
+    bozo_time(p_rt, p_sample, &f_decode, &f_gen);
+    fprintf(stdout, "  0x%02x %-28s %5u accepted, %3u bytes: decode %7.1f ns, generate %7.1f ns\n",
+            p_rt->i_tag, p_rt->psz_name, i_accepted, p_sample->i_length, f_decode, f_gen);
+  }
+  dvbpsi_DeleteDescriptors(p_sample);
+
+  return i_err;
+}
+
+static int bozo_roundtrips(const bozo_roundtrip_t * p_rts, int i_count)
+{
+  int i_err = 0;
+  fprintf(stdout, "round-trips and timings:\n");
+  for(int i = 0; i < i_count; i++)
+    i_err |= bozo_roundtrip(&p_rts[i]);
+  if(i_err)
+    fprintf(stderr, "round-trips FAILED !!!\n\n");
+  else
+    fprintf(stdout, "round-trips succeeded\n\n");
+  return i_err;
+}
@@ -0,0 +1,207 @@
+/*****************************************************************************
+ * test_dvbtime.c: MJD/BCD and GPS time conversions
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbtime.h"
+#else
+#include <dvbpsi/dvbtime.h>
+#endif
+
+#define COUNT 1000
+
+/* Times of the specification and the limits of the MJD */
+static const struct
+{
+    uint64_t    i_mjd_bcd;
+    int64_t     i_time;
+} times[] =
+{
+    /* EN 300 468, annex C: 93/10/13 12:45:00 */
+    { UINT64_C(0xc079124500), INT64_C(750516300) },
+    { UINT64_C(0x9e8b000000), INT64_C(0) },
+    { UINT64_C(0x0000000000), INT64_C(-3506716800) },
+    { UINT64_C(0xfffe235959), INT64_C(2155507199) },
+};
+
+static int CheckTimes(void)
+{
+    int i_err = 0;
+
+    for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); i++)
+    {
+        int64_t i_time = dvbpsi_mjd_to_unix(times[i].i_mjd_bcd);
+        uint64_t i_mjd_bcd = dvbpsi_unix_to_mjd(times[i].i_time);
+
+        if (i_time != times[i].i_time)
+        {
+            fprintf(stderr, "  MJD 0x%010"PRIx64": %"PRId64" instead of %"PRId64"\n",
+                    times[i].i_mjd_bcd, i_time, times[i].i_time);
+            i_err = 1;
+        }
+        if (i_mjd_bcd != times[i].i_mjd_bcd)
+        {
+            fprintf(stderr, "  time %"PRId64": MJD 0x%010"PRIx64" instead of 0x%010"PRIx64"\n",
+                    times[i].i_time, i_mjd_bcd, times[i].i_mjd_bcd);
+            i_err = 1;
+        }
+    }
+
+    if (dvbpsi_mjd_to_unix(UINT64_C(0xffff000000)) != DVBPSI_TIME_UNDEFINED ||
+        dvbpsi_mjd_to_unix(UINT64_C(0xffffffffff)) != DVBPSI_TIME_UNDEFINED)
+    {
+        fprintf(stderr, "  undefined MJD not recognized\n");
+        i_err = 1;
+    }
+    if (dvbpsi_unix_to_mjd(DVBPSI_TIME_UNDEFINED) != UINT64_C(0xffffffffff))
+    {
+        fprintf(stderr, "  undefined time not coded with all its bits set\n");
+        i_err = 1;
+    }
+
+    /* every day of the MJD, at a time changing with the day */
+    for (int64_t i_day = 0; i_day < 0xffff; i_day++)
+    {
+        int64_t i_time = INT64_C(-3506716800) + i_day * 86400 + (i_day * 7919) % 86400;
+        uint64_t i_mjd_bcd = dvbpsi_unix_to_mjd(i_time);
+
+        if ((int64_t)(i_mjd_bcd >> 24) != i_day || dvbpsi_mjd_to_unix(i_mjd_bcd) != i_time)
+        {
+            fprintf(stderr, "  time %"PRId64" coded 0x%010"PRIx64"\n", i_time, i_mjd_bcd);
+            i_err = 1;
+            break;
+        }
+    }
+    return i_err;
+}
+
+static int CheckDurations(void)
+{
+    int i_err = 0;
+
+    if (dvbpsi_bcd_to_seconds(0x014530) != 6330 || dvbpsi_seconds_to_bcd(6330) != 0x014530)
+    {
+        fprintf(stderr, "  duration 01:45:30 not converted\n");
+        i_err = 1;
+    }
+
+    /* every duration up to 99:59:59 */
+    for (uint32_t i_seconds = 0; i_seconds < 100 * 3600; i_seconds++)
+    {
+        uint32_t i_bcd = dvbpsi_seconds_to_bcd(i_seconds);
+        uint32_t i_digits = i_bcd;
+        bool b_bcd = true;
+
+        for (int i = 0; i < 6; i++, i_digits >>= 4)
+            b_bcd &= (i_digits & 0xf) <= 9;
+        b_bcd &= ((i_bcd >> 12) & 0xf) <= 5 && ((i_bcd >> 4) & 0xf) <= 5;
+        if (!b_bcd || dvbpsi_bcd_to_seconds(i_bcd) != i_seconds)
+        {
+            fprintf(stderr, "  duration %"PRIu32" coded 0x%06"PRIx32"\n", i_seconds, i_bcd);
+            i_err = 1;
+            break;
+        }
+    }
+    return i_err;
+}
+
+static int CheckGps(void)
+{
+    int i_err = 0;
+
+    if (dvbpsi_gps_to_unix(0, 0) != DVBPSI_GPS_EPOCH ||
+        dvbpsi_gps_to_unix(1000000000, 18) != INT64_C(1315964782) ||
+        dvbpsi_unix_to_gps(INT64_C(1315964782), 18) != 1000000000 ||
+        dvbpsi_gps_to_unix(UINT32_MAX, 0) != DVBPSI_GPS_EPOCH + UINT32_MAX)
+    {
+        fprintf(stderr, "  GPS time not converted\n");
+        i_err = 1;
+    }
+    return i_err;
+}
+
+/* The array variants give the results of the scalar ones */
+static int CheckArrays(void)
+{
+    uint64_t p_mjd_bcd[COUNT];
+    uint32_t p_bcd[COUNT], p_gps[COUNT], p_seconds[COUNT];
+    int64_t p_time[COUNT], p_gps_time[COUNT];
+    uint32_t i_seed = 1;
+    int i_err = 0;
+
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        i_seed = i_seed * 1103515245 + 12345;
+        p_mjd_bcd[i] = dvbpsi_unix_to_mjd(INT64_C(-3506716800)
+                                        + (int64_t)(i_seed % 0xffff) * 86400 + i_seed % 86400);
+        if (i % 97 == 0)
+            p_mjd_bcd[i] = UINT64_C(0xffffffffff);
+        p_bcd[i] = dvbpsi_seconds_to_bcd(i_seed % (100 * 3600));
+        p_gps[i] = i_seed;
+    }
+
+    dvbpsi_mjd_to_unix_array(p_mjd_bcd, p_time, COUNT);
+    dvbpsi_bcd_to_seconds_array(p_bcd, p_seconds, COUNT);
+    dvbpsi_gps_to_unix_array(p_gps, p_gps_time, COUNT, 18);
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        if (p_time[i] != dvbpsi_mjd_to_unix(p_mjd_bcd[i]) ||
+            p_seconds[i] != dvbpsi_bcd_to_seconds(p_bcd[i]) ||
+            p_gps_time[i] != dvbpsi_gps_to_unix(p_gps[i], 18))
+        {
+            fprintf(stderr, "  array conversion %zu differs\n", i);
+            i_err = 1;
+            break;
+        }
+    }
+    return i_err;
+}
+
+int main(void)
+{
+    int i_err = 0;
+
+    fprintf(stdout, "time conversions check:\n");
+    i_err |= CheckTimes();
+    i_err |= CheckDurations();
+    i_err |= CheckGps();
+    i_err |= CheckArrays();
+    if (i_err)
+        fprintf(stderr, "time conversions check FAILED !!!\n");
+    else
+        fprintf(stdout, "time conversions check succeeded\n");
+    return i_err;
+}
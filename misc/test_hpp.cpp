@@ -0,0 +1,214 @@
+/*****************************************************************************
+ * test_hpp.cpp: C++ binding of the decoders
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.hpp"
+#else
+#include <dvbpsi/dvbpsi.hpp>
+#endif
+
+#define CHECK(cond)                                                 \
+    do {                                                            \
+        if (!(cond))                                                \
+        {                                                           \
+            std::fprintf(stderr, "  %s: %s\n", psz_name, #cond);    \
+            i_err = 1;                                              \
+        }                                                           \
+    } while (0)
+
+/* The bytes of a generated section */
+static std::vector<uint8_t> Bytes(dvbpsi_psi_section_t *p_section)
+{
+    std::vector<uint8_t> bytes(p_section->p_data, p_section->p_payload_end + 4);
+    dvbpsi_DeletePSISections(p_section);
+    return bytes;
+}
+
+static std::vector<uint8_t> PatSection(dvbpsi_t *p_dvbpsi, uint8_t i_version)
+{
+    dvbpsi_pat_t pat;
+    dvbpsi_pat_init(&pat, 1, i_version, true);
+    dvbpsi_pat_program_add(&pat, 1, 0x100);
+    dvbpsi_pat_program_add(&pat, 2, 0x200);
+    std::vector<uint8_t> bytes = Bytes(dvbpsi_pat_sections_generate(p_dvbpsi, &pat, 253));
+    dvbpsi_pat_empty(&pat);
+    return bytes;
+}
+
+/* The section in TS packets of the given PID */
+static std::vector<uint8_t> Packets(const std::vector<uint8_t> &section, uint16_t i_pid)
+{
+    std::vector<uint8_t> packets;
+    uint8_t i_cc = 0;
+
+    for (std::size_t i = 0; i == 0 || i < section.size(); i_cc = (i_cc + 1) & 0xf)
+    {
+        uint8_t packet[188];
+        std::size_t i_header = i == 0 ? 5 : 4;
+        std::size_t i_size = std::min(section.size() - i, sizeof(packet) - i_header);
+
+        std::memset(packet, 0xff, sizeof(packet));
+        packet[0] = 0x47;
+        packet[1] = (i == 0 ? 0x40 : 0x00) | (i_pid >> 8);
+        packet[2] = i_pid & 0xff;
+        packet[3] = 0x10 | i_cc;
+        if (i == 0)
+            packet[4] = 0;
+        std::memcpy(packet + i_header, section.data() + i, i_size);
+        packets.insert(packets.end(), packet, packet + sizeof(packet));
+        i += i_size;
+    }
+    return packets;
+}
+
+/* PAT decoder, move only callback, moved handle */
+static int CheckPat()
+{
+    const char *psz_name = "PAT";
+    int i_err = 0;
+    int i_tables = 0;
+    auto p_count = std::make_unique<int>(0);
+    int *pi_programs = p_count.get();
+
+    dvbpsi::handle h;
+    CHECK(!h.attached());
+    CHECK(h.attach_pat([&i_tables, p_count = std::move(p_count)](dvbpsi::table_ptr<dvbpsi_pat_t> p_pat) {
+        i_tables++;
+        for (dvbpsi_pat_program_t &program : dvbpsi::programs(*p_pat))
+            *p_count += program.i_number;
+    }));
+    CHECK(h.attached());
+    CHECK(!h.attach_cat([](dvbpsi::table_ptr<dvbpsi_cat_t>) {}));
+
+    std::vector<uint8_t> section = PatSection(h.get(), 0);
+    CHECK(h.push_section(section));
+    CHECK(i_tables == 1 && *pi_programs == 3);
+
+    /* the callback moves with the handle */
+    dvbpsi::handle moved(std::move(h));
+    CHECK(h.get() == nullptr && !h.attached());
+    CHECK(moved.attached());
+
+    std::vector<uint8_t> packets = Packets(PatSection(moved.get(), 1), 0);
+    CHECK(moved.push_packets(packets) == packets.size() / 188);
+    CHECK(i_tables == 2 && *pi_programs == 6);
+
+    moved.detach();
+    CHECK(!moved.attached());
+    CHECK(moved.attach_cat([](dvbpsi::table_ptr<dvbpsi_cat_t>) {}));
+    return i_err;
+}
+
+/* Subtable demultiplexor, descriptor ranges and decoders */
+static int CheckSdt()
+{
+    const char *psz_name = "SDT";
+    static const uint8_t service[] = { 0x01, 3, 'p', 'r', 'v', 4, 'n', 'a', 'm', 'e' };
+    int i_err = 0;
+    int i_services = 0;
+    bool b_named = false;
+
+    dvbpsi::handle h;
+    CHECK(h.attach_demux([&](dvbpsi::demux &demux, uint8_t i_table_id, uint16_t i_extension) {
+        if (i_table_id != 0x42)
+            return;
+        demux.attach_sdt(i_table_id, i_extension, [&](dvbpsi::table_ptr<dvbpsi_sdt_t> p_sdt) {
+            for (dvbpsi_sdt_service_t &s : dvbpsi::services(*p_sdt))
+            {
+                i_services++;
+                for (dvbpsi_descriptor_t &d : dvbpsi::descriptors(s))
+                {
+                    dvbpsi_service_dr_t *p_service = dvbpsi::decode<0x48>(d);
+                    if (p_service && p_service->i_service_type == 0x01 &&
+                        p_service->i_service_name_length == 4 &&
+                        !std::memcmp(p_service->i_service_name, "name", 4))
+                        b_named = true;
+                }
+            }
+        });
+    }));
+
+    dvbpsi_sdt_t sdt;
+    dvbpsi_sdt_init(&sdt, 0x42, 1, 0, true, 1);
+    dvbpsi_sdt_service_t *p_service = dvbpsi_sdt_service_add(&sdt, 1, false, true, 4, false);
+    dvbpsi_sdt_service_descriptor_add(p_service, 0x48, sizeof(service),
+                                      const_cast<uint8_t *>(service));
+    dvbpsi_sdt_service_add(&sdt, 2, false, true, 4, false);
+    std::vector<uint8_t> section = Bytes(dvbpsi_sdt_sections_generate(h.get(), &sdt));
+    dvbpsi_sdt_empty(&sdt);
+
+    CHECK(h.push_section(dvbpsi::bytes(section.data(), section.size())));
+    CHECK(i_services == 2 && b_named);
+    return i_err;
+}
+
+/* Splice information, given by reference */
+static int CheckSplice()
+{
+    const char *psz_name = "splice";
+    /* SCTE 35 2019, 14.2 */
+    static const uint8_t splice_insert[] =
+    {
+        0xfc, 0x30, 0x2f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xf0,
+        0x14, 0x05, 0x48, 0x00, 0x00, 0x8f, 0x7f, 0xef, 0xfe, 0x73, 0x69, 0xc0,
+        0x2e, 0xfe, 0x00, 0x52, 0xcc, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a,
+        0x00, 0x08, 0x43, 0x55, 0x45, 0x49, 0x00, 0x00, 0x01, 0x35, 0x62, 0xdb,
+        0xa3, 0x0a
+    };
+    int i_err = 0;
+    uint32_t i_event_id = 0;
+
+    dvbpsi::handle h;
+    CHECK(h.attach_splice([&i_event_id](const dvbpsi_sis_splice_info_t &info) {
+        i_event_id = info.p_events[0].i_splice_event_id;
+    }));
+    CHECK(h.push_section(splice_insert));
+    CHECK(i_event_id == 0x4800008f);
+    return i_err;
+}
+
+int main()
+{
+    int i_err = 0;
+
+    std::fprintf(stdout, "C++ binding check:\n");
+    i_err |= CheckPat();
+    i_err |= CheckSdt();
+    i_err |= CheckSplice();
+    if (i_err)
+        std::fprintf(stderr, "C++ binding check FAILED !!!\n");
+    else
+        std::fprintf(stdout, "C++ binding check succeeded\n");
+    return i_err;
+}
@@ -0,0 +1,288 @@
+/*****************************************************************************
+ * test_sections_cache.c: incremental generation of the EIT and SDT
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/descriptor.h"
+#include "../src/tables/eit.h"
+#include "../src/tables/sdt.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/eit.h>
+#include <dvbpsi/sdt.h>
+#endif
+
+#define CHECK(cond)                                                 \
+    do {                                                            \
+        if (!(cond))                                                \
+        {                                                           \
+            fprintf(stderr, "  %s: %s\n", psz_name, #cond);         \
+            i_err = 1;                                              \
+        }                                                           \
+    } while (0)
+
+/* the first version wraps on the third generation */
+#define FIRST_VERSION   30
+#define DESCRIPTOR_SIZE 200
+
+/* Descriptor data depending on the entry */
+static uint8_t *Descriptor(uint16_t i_id)
+{
+    static uint8_t data[DESCRIPTOR_SIZE];
+
+    for (int i = 0; i < DESCRIPTOR_SIZE; i++)
+        data[i] = (uint8_t)(i_id * 31 + i);
+    return data;
+}
+
+/* CRC_32 of ISO/IEC 13818-1 annex A, computed bit by bit */
+static uint32_t Crc32(const uint8_t *p, size_t i_size)
+{
+    uint32_t i_crc = 0xffffffff;
+
+    for (size_t i = 0; i < i_size; i++)
+    {
+        i_crc ^= (uint32_t)p[i] << 24;
+        for (int j = 0; j < 8; j++)
+            i_crc = (i_crc & 0x80000000) ? (i_crc << 1) ^ 0x04c11db7 : i_crc << 1;
+    }
+    return i_crc;
+}
+
+/* Check the sections of the cache against a full generation of the same table */
+static int Compare(const char *psz_name, const dvbpsi_psi_section_t *p_cached,
+                   const dvbpsi_psi_section_t *p_full, uint8_t i_version)
+{
+    int i_err = 0;
+    int i_number = 0;
+
+    if (!p_cached || !p_full)
+    {
+        fprintf(stderr, "  %s: sections not generated\n", psz_name);
+        return 1;
+    }
+
+    for (; p_cached && p_full; p_cached = p_cached->p_next, p_full = p_full->p_next, i_number++)
+    {
+        size_t i_size = p_cached->p_payload_end + 4 - p_cached->p_data;
+
+        if (Crc32(p_cached->p_data, i_size) != 0)
+        {
+            fprintf(stderr, "  %s: wrong CRC_32 in section %d\n", psz_name, i_number);
+            i_err = 1;
+        }
+        if (((p_cached->p_data[5] >> 1) & 0x1f) != i_version)
+        {
+            fprintf(stderr, "  %s: version %d instead of %d in section %d\n", psz_name,
+                    (p_cached->p_data[5] >> 1) & 0x1f, i_version, i_number);
+            i_err = 1;
+        }
+        if (i_size != (size_t)(p_full->p_payload_end + 4 - p_full->p_data) ||
+            memcmp(p_cached->p_data, p_full->p_data, i_size))
+        {
+            fprintf(stderr, "  %s: section %d differs from the full generation\n",
+                    psz_name, i_number);
+            i_err = 1;
+        }
+    }
+    if (p_cached || p_full)
+    {
+        fprintf(stderr, "  %s: %s sections than the full generation\n", psz_name,
+                p_cached ? "more" : "less");
+        i_err = 1;
+    }
+    return i_err;
+}
+
+static int CompareEit(dvbpsi_t *p_dvbpsi, const char *psz_name,
+                      const dvbpsi_psi_section_t *p_cached, dvbpsi_eit_t *p_eit,
+                      uint8_t i_version)
+{
+    dvbpsi_psi_section_t *p_full = dvbpsi_eit_sections_generate(p_dvbpsi, p_eit, 0x4e);
+    int i_err = Compare(psz_name, p_cached, p_full, i_version);
+
+    dvbpsi_DeletePSISections(p_full);
+    return i_err;
+}
+
+static void AddEvents(dvbpsi_eit_t *p_eit, uint16_t i_first, uint16_t i_count)
+{
+    for (uint16_t i_id = i_first; i_id < i_first + i_count; i_id++)
+    {
+        dvbpsi_eit_event_t *p_event = dvbpsi_eit_event_add(p_eit, i_id,
+                                        UINT64_C(0xc079124500) + i_id, 0x003000, 4, false, 0);
+        if (p_event)
+            dvbpsi_eit_event_descriptor_add(p_event, 0x4d, DESCRIPTOR_SIZE, Descriptor(i_id));
+    }
+}
+
+static int CheckEit(dvbpsi_t *p_dvbpsi)
+{
+    const char *psz_name = "EIT";
+    dvbpsi_sections_cache_t *p_cache = dvbpsi_sections_cache_new();
+    dvbpsi_psi_section_t *p_sections, *p_first;
+    dvbpsi_eit_event_t *p_event;
+    dvbpsi_eit_t eit;
+    int i_err = 0;
+
+    if (!p_cache)
+        return 1;
+
+    /* 50 events of 214 bytes take 3 sections */
+    dvbpsi_eit_init(&eit, 0x4e, 1, FIRST_VERSION, true, 1, 1, 0, 0x4e);
+    AddEvents(&eit, 0, 50);
+    p_sections = dvbpsi_eit_sections_update(p_dvbpsi, p_cache, &eit, 0x4e);
+    i_err |= CompareEit(p_dvbpsi, "EIT first generation", p_sections, &eit, FIRST_VERSION);
+    CHECK(p_sections && p_sections->p_next && p_sections->p_next->p_next);
+    p_first = p_sections;
+
+    /* the same table keeps its version */
+    p_sections = dvbpsi_eit_sections_update(p_dvbpsi, p_cache, &eit, 0x4e);
+    i_err |= CompareEit(p_dvbpsi, "EIT same table", p_sections, &eit, FIRST_VERSION);
+
+    /* one event of the last section changes */
+    p_event = eit.p_first_event;
+    for (int i = 0; p_event && i < 45; i++)
+        p_event = p_event->p_next;
+    if (p_event)
+        p_event->p_first_descriptor->p_data[0] ^= 0xff;
+    p_sections = dvbpsi_eit_sections_update(p_dvbpsi, p_cache, &eit, 0x4e);
+    i_err |= CompareEit(p_dvbpsi, "EIT changed event", p_sections, &eit, FIRST_VERSION + 1);
+    CHECK(p_sections == p_first);
+
+    /* new events, the last section number changes in the reused sections */
+    AddEvents(&eit, 50, 20);
+    p_sections = dvbpsi_eit_sections_update(p_dvbpsi, p_cache, &eit, 0x4e);
+    i_err |= CompareEit(p_dvbpsi, "EIT added events", p_sections, &eit,
+                        (FIRST_VERSION + 2) & 0x1f);
+    CHECK(p_sections == p_first);
+
+    dvbpsi_eit_empty(&eit);
+    dvbpsi_sections_cache_delete(p_cache);
+    return i_err;
+}
+
+static int CompareSdt(dvbpsi_t *p_dvbpsi, const char *psz_name,
+                      const dvbpsi_psi_section_t *p_cached, dvbpsi_sdt_t *p_sdt,
+                      uint8_t i_version)
+{
+    dvbpsi_psi_section_t *p_full = dvbpsi_sdt_sections_generate(p_dvbpsi, p_sdt);
+    int i_err = Compare(psz_name, p_cached, p_full, i_version);
+
+    dvbpsi_DeletePSISections(p_full);
+    return i_err;
+}
+
+static void AddServices(dvbpsi_sdt_t *p_sdt, uint16_t i_first, uint16_t i_count)
+{
+    for (uint16_t i_id = i_first; i_id < i_first + i_count; i_id++)
+    {
+        dvbpsi_sdt_service_t *p_service = dvbpsi_sdt_service_add(p_sdt, i_id, false, true,
+                                                                 4, false);
+        if (p_service)
+            dvbpsi_sdt_service_descriptor_add(p_service, 0x48, DESCRIPTOR_SIZE,
+                                              Descriptor(i_id));
+    }
+}
+
+static int CheckSdt(dvbpsi_t *p_dvbpsi)
+{
+    const char *psz_name = "SDT";
+    dvbpsi_sections_cache_t *p_cache = dvbpsi_sections_cache_new();
+    dvbpsi_psi_section_t *p_sections, *p_first;
+    dvbpsi_sdt_service_t *p_service;
+    dvbpsi_sdt_t sdt;
+    int i_err = 0;
+
+    if (!p_cache)
+        return 1;
+
+    /* 10 services of 207 bytes take 3 sections */
+    dvbpsi_sdt_init(&sdt, 0x42, 1, FIRST_VERSION, true, 1);
+    AddServices(&sdt, 1, 10);
+    p_sections = dvbpsi_sdt_sections_update(p_dvbpsi, p_cache, &sdt);
+    i_err |= CompareSdt(p_dvbpsi, "SDT first generation", p_sections, &sdt, FIRST_VERSION);
+    CHECK(p_sections && p_sections->p_next && p_sections->p_next->p_next);
+    p_first = p_sections;
+
+    p_sections = dvbpsi_sdt_sections_update(p_dvbpsi, p_cache, &sdt);
+    i_err |= CompareSdt(p_dvbpsi, "SDT same table", p_sections, &sdt, FIRST_VERSION);
+
+    /* one service of the second section changes */
+    p_service = sdt.p_first_service;
+    for (int i = 0; p_service && i < 5; i++)
+        p_service = p_service->p_next;
+    if (p_service)
+        p_service->p_first_descriptor->p_data[DESCRIPTOR_SIZE - 1] ^= 0xff;
+    p_sections = dvbpsi_sdt_sections_update(p_dvbpsi, p_cache, &sdt);
+    i_err |= CompareSdt(p_dvbpsi, "SDT changed service", p_sections, &sdt, FIRST_VERSION + 1);
+    CHECK(p_sections == p_first);
+
+    AddServices(&sdt, 11, 6);
+    p_sections = dvbpsi_sdt_sections_update(p_dvbpsi, p_cache, &sdt);
+    i_err |= CompareSdt(p_dvbpsi, "SDT added services", p_sections, &sdt,
+                        (FIRST_VERSION + 2) & 0x1f);
+    CHECK(p_sections == p_first);
+
+    dvbpsi_sdt_empty(&sdt);
+    dvbpsi_sections_cache_delete(p_cache);
+    return i_err;
+}
+
+int main(void)
+{
+    dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+    int i_err = 0;
+
+    if (!p_dvbpsi)
+        return 1;
+
+    fprintf(stdout, "sections cache check:\n");
+    i_err |= CheckEit(p_dvbpsi);
+    i_err |= CheckSdt(p_dvbpsi);
+    if (i_err)
+        fprintf(stderr, "sections cache check FAILED !!!\n");
+    else
+        fprintf(stdout, "sections cache check succeeded\n");
+
+    dvbpsi_delete(p_dvbpsi);
+    return i_err;
+}
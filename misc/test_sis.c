@@ -0,0 +1,295 @@
+/*****************************************************************************
+ * test_sis.c: SCTE 35 splice commands and segmentation descriptors
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/descriptor.h"
+#include "../src/tables/sis.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/descriptor.h>
+#include <dvbpsi/sis.h>
+#endif
+
+#define CHECK(cond)                                                 \
+    do {                                                            \
+        if (!(cond))                                                \
+        {                                                           \
+            fprintf(stderr, "  %s: %s\n", psz_name, #cond);         \
+            i_err = 1;                                              \
+        }                                                           \
+    } while (0)
+
+/* SCTE 35 2019, 14.1: time_signal() with a placement opportunity start */
+static const uint8_t time_signal[] =
+{
+    0xfc, 0x30, 0x34, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xf0,
+    0x05, 0x06, 0xfe, 0x72, 0xbd, 0x00, 0x50, 0x00, 0x1e, 0x02, 0x1c, 0x43,
+    0x55, 0x45, 0x49, 0x48, 0x00, 0x00, 0x8e, 0x7f, 0xcf, 0x00, 0x01, 0xa5,
+    0x99, 0xb0, 0x08, 0x08, 0x00, 0x00, 0x00, 0x00, 0x2c, 0xa0, 0xa1, 0x8a,
+    0x34, 0x02, 0x00, 0x9a, 0xc9, 0xd1, 0x7e
+};
+
+/* SCTE 35 2019, 14.2: splice_insert() of a program, with an avail_descriptor */
+static const uint8_t splice_insert[] =
+{
+    0xfc, 0x30, 0x2f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xf0,
+    0x14, 0x05, 0x48, 0x00, 0x00, 0x8f, 0x7f, 0xef, 0xfe, 0x73, 0x69, 0xc0,
+    0x2e, 0xfe, 0x00, 0x52, 0xcc, 0xf5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a,
+    0x00, 0x08, 0x43, 0x55, 0x45, 0x49, 0x00, 0x00, 0x01, 0x35, 0x62, 0xdb,
+    0xa3, 0x0a
+};
+
+/* splice_insert() of two components, a segmentation of a component with
+ * sub segments and a cancelled segmentation, with the legacy 0xfff
+ * splice_command_length or not */
+static const uint8_t splice_components[2][90] =
+{
+    {
+        0xfc, 0x30, 0x57, 0x00, 0x01, 0x00, 0x00, 0x00, 0x10, 0xff, 0xab, 0xc0,
+        0x13, 0x05, 0x12, 0x34, 0x56, 0x78, 0x7f, 0x0f, 0x02, 0x01, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0x02, 0x7f, 0x01, 0x02, 0x01, 0x02, 0x00, 0x33, 0x02,
+        0x1c, 0x43, 0x55, 0x45, 0x49, 0x00, 0x00, 0x00, 0x2a, 0x7f, 0x3f, 0x01,
+        0x01, 0xfe, 0x00, 0x00, 0x00, 0x2a, 0x0f, 0x04, 0x61, 0x62, 0x63, 0x64,
+        0x34, 0x01, 0x03, 0x02, 0x04, 0x02, 0x09, 0x43, 0x55, 0x45, 0x49, 0x00,
+        0x00, 0x00, 0x2b, 0xff, 0x00, 0x08, 0x43, 0x55, 0x45, 0x49, 0x00, 0x00,
+        0x01, 0x35, 0x7f, 0x2a, 0x85, 0x86
+    },
+    {
+        0xfc, 0x30, 0x57, 0x00, 0x01, 0x00, 0x00, 0x00, 0x10, 0xff, 0xab, 0xcf,
+        0xff, 0x05, 0x12, 0x34, 0x56, 0x78, 0x7f, 0x0f, 0x02, 0x01, 0xff, 0xff,
+        0xff, 0xff, 0xff, 0x02, 0x7f, 0x01, 0x02, 0x01, 0x02, 0x00, 0x33, 0x02,
+        0x1c, 0x43, 0x55, 0x45, 0x49, 0x00, 0x00, 0x00, 0x2a, 0x7f, 0x3f, 0x01,
+        0x01, 0xfe, 0x00, 0x00, 0x00, 0x2a, 0x0f, 0x04, 0x61, 0x62, 0x63, 0x64,
+        0x34, 0x01, 0x03, 0x02, 0x04, 0x02, 0x09, 0x43, 0x55, 0x45, 0x49, 0x00,
+        0x00, 0x00, 0x2b, 0xff, 0x00, 0x08, 0x43, 0x55, 0x45, 0x49, 0x00, 0x00,
+        0x01, 0x35, 0x2d, 0xf0, 0x0b, 0x5c
+    }
+};
+
+#define CUEI 0x43554549
+
+static int CheckTimeSignal(void)
+{
+    const char *psz_name = "time_signal";
+    dvbpsi_sis_splice_info_t info;
+    const dvbpsi_sis_segmentation_info_t *p_seg = &info.p_segmentations[0];
+    static const uint8_t upid[8] = { 0x00, 0x00, 0x00, 0x00, 0x2c, 0xa0, 0xa1, 0x8a };
+    int i_err = 0;
+
+    if (!dvbpsi_sis_splice_decode(time_signal, sizeof(time_signal), &info))
+    {
+        fprintf(stderr, "  %s: not decoded\n", psz_name);
+        return 1;
+    }
+    CHECK(info.i_protocol_version == 0 && !info.b_encrypted_packet);
+    CHECK(info.i_pts_adjustment == 0 && info.i_tier == 0xfff);
+    CHECK(info.i_splice_command_type == 0x06);
+    CHECK(info.b_time_specified_flag && info.i_pts_time == UINT64_C(0x072bd0050));
+    CHECK(info.i_event_count == 0 && !info.b_truncated);
+
+    CHECK(info.i_segmentation_count == 1);
+    CHECK(p_seg->i_identifier == CUEI && p_seg->i_event_id == 0x4800008e);
+    CHECK(!p_seg->b_cancel_indicator);
+    CHECK(p_seg->b_program_segmentation_flag && p_seg->i_component_count == 0);
+    CHECK(!p_seg->b_delivery_not_restricted_flag);
+    CHECK(!p_seg->b_web_delivery_allowed_flag && p_seg->b_no_regional_blackout_flag);
+    CHECK(p_seg->b_archive_allowed_flag && p_seg->i_device_restrictions == 3);
+    CHECK(p_seg->b_duration_flag && p_seg->i_duration == UINT64_C(0x0001a599b0));
+    CHECK(p_seg->i_upid_type == 0x08 && p_seg->i_upid_length == 8);
+    CHECK(!memcmp(p_seg->p_upid, upid, sizeof(upid)));
+    CHECK(p_seg->i_type_id == 0x34);
+    CHECK(p_seg->i_segment_num == 2 && p_seg->i_segments_expected == 0);
+    CHECK(!p_seg->b_sub_segments);
+    return i_err;
+}
+
+static int CheckSpliceInsert(void)
+{
+    const char *psz_name = "splice_insert";
+    dvbpsi_sis_splice_info_t info;
+    const dvbpsi_sis_event_info_t *p_event = &info.p_events[0];
+    int i_err = 0;
+
+    if (!dvbpsi_sis_splice_decode(splice_insert, sizeof(splice_insert), &info))
+    {
+        fprintf(stderr, "  %s: not decoded\n", psz_name);
+        return 1;
+    }
+    CHECK(info.i_splice_command_type == 0x05 && info.i_event_count == 1);
+    CHECK(p_event->i_splice_event_id == 0x4800008f);
+    CHECK(!p_event->b_splice_event_cancel_indicator);
+    CHECK(p_event->b_out_of_network_indicator && p_event->b_program_splice_flag);
+    CHECK(p_event->b_duration_flag && !p_event->b_splice_immediate_flag);
+    CHECK(p_event->b_time_specified_flag && p_event->i_pts_time == UINT64_C(0x07369c02e));
+    CHECK(p_event->b_auto_return && p_event->i_break_duration == UINT64_C(0x00052ccf5));
+    CHECK(p_event->i_unique_program_id == 0);
+    CHECK(p_event->i_avail_num == 0 && p_event->i_avails_expected == 0);
+    /* the avail_descriptor is not a segmentation */
+    CHECK(info.i_segmentation_count == 0 && !info.b_truncated);
+    return i_err;
+}
+
+static int CheckComponents(const uint8_t *p_section, const char *psz_name)
+{
+    dvbpsi_sis_splice_info_t info;
+    const dvbpsi_sis_event_info_t *p_event = &info.p_events[0];
+    const dvbpsi_sis_segmentation_info_t *p_seg = &info.p_segmentations[0];
+    int i_err = 0;
+
+    if (!dvbpsi_sis_splice_decode(p_section, sizeof(splice_components[0]), &info))
+    {
+        fprintf(stderr, "  %s: not decoded\n", psz_name);
+        return 1;
+    }
+    CHECK(info.i_protocol_version == 0 && !info.b_encrypted_packet);
+    CHECK(info.i_pts_adjustment == UINT64_C(0x100000010));
+    CHECK(info.i_cw_index == 0xff && info.i_tier == 0xabc);
+
+    CHECK(info.i_splice_command_type == 0x05 && info.i_event_count == 1);
+    CHECK(p_event->i_splice_event_id == 0x12345678);
+    CHECK(!p_event->b_out_of_network_indicator && !p_event->b_program_splice_flag);
+    CHECK(!p_event->b_duration_flag && !p_event->b_splice_immediate_flag);
+    CHECK(p_event->i_component_count == 2);
+    CHECK(p_event->p_components[0].i_component_tag == 0x01);
+    CHECK(p_event->p_components[0].b_time_specified_flag);
+    CHECK(p_event->p_components[0].i_pts_time == UINT64_C(0x1ffffffff));
+    CHECK(p_event->p_components[1].i_component_tag == 0x02);
+    CHECK(!p_event->p_components[1].b_time_specified_flag);
+    CHECK(p_event->i_unique_program_id == 0x0102);
+    CHECK(p_event->i_avail_num == 1 && p_event->i_avails_expected == 2);
+
+    CHECK(info.i_segmentation_count == 2 && !info.b_truncated);
+    CHECK(p_seg[0].i_event_id == 0x2a && !p_seg[0].b_cancel_indicator);
+    CHECK(!p_seg[0].b_program_segmentation_flag && !p_seg[0].b_duration_flag);
+    /* the delivery restrictions are only coded when restricted */
+    CHECK(p_seg[0].b_delivery_not_restricted_flag);
+    CHECK(!p_seg[0].b_web_delivery_allowed_flag && !p_seg[0].b_no_regional_blackout_flag);
+    CHECK(!p_seg[0].b_archive_allowed_flag && p_seg[0].i_device_restrictions == 0);
+    CHECK(p_seg[0].i_component_count == 1);
+    CHECK(p_seg[0].p_components[0].i_component_tag == 0x01);
+    CHECK(p_seg[0].p_components[0].i_pts_time == 0x2a);
+    CHECK(p_seg[0].i_upid_type == 0x0f && p_seg[0].i_upid_length == 4);
+    CHECK(!memcmp(p_seg[0].p_upid, "abcd", 4));
+    CHECK(p_seg[0].i_type_id == 0x34);
+    CHECK(p_seg[0].i_segment_num == 1 && p_seg[0].i_segments_expected == 3);
+    CHECK(p_seg[0].b_sub_segments);
+    CHECK(p_seg[0].i_sub_segment_num == 2 && p_seg[0].i_sub_segments_expected == 4);
+    CHECK(p_seg[1].i_identifier == CUEI && p_seg[1].i_event_id == 0x2b);
+    CHECK(p_seg[1].b_cancel_indicator);
+    return i_err;
+}
+
+/* The sections cut short or with a wrong length are refused */
+static int CheckInvalid(void)
+{
+    const char *psz_name = "invalid";
+    dvbpsi_sis_splice_info_t info;
+    uint8_t section[sizeof(splice_insert)];
+    int i_err = 0;
+
+    for (size_t i_size = 0; i_size < sizeof(splice_insert); i_size++)
+    {
+        memcpy(section, splice_insert, sizeof(section));
+        section[1] = 0x30 | (uint8_t)((i_size - 3) >> 8 & 0xf);
+        section[2] = (uint8_t)(i_size - 3);
+        if (i_size >= 3 && dvbpsi_sis_splice_decode(section, i_size, &info))
+        {
+            fprintf(stderr, "  %s: section of %zu bytes decoded\n", psz_name, i_size);
+            i_err = 1;
+        }
+    }
+    CHECK(!dvbpsi_sis_splice_decode(splice_insert, sizeof(splice_insert) - 1, &info));
+
+    /* splice_command_length past the section */
+    memcpy(section, splice_insert, sizeof(section));
+    section[12] = 0x40;
+    CHECK(!dvbpsi_sis_splice_decode(section, sizeof(section), &info));
+    return i_err;
+}
+
+/* The decoder checks the CRC and gives every section to its callback */
+static void SpliceCallback(void *p_cb_data, const dvbpsi_sis_splice_info_t *p_info)
+{
+    int *pi_count = p_cb_data;
+    if (p_info->i_splice_command_type == 0x05)
+        (*pi_count)++;
+}
+
+static int CheckDecoder(void)
+{
+    const char *psz_name = "decoder";
+    dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+    uint8_t section[sizeof(splice_insert)];
+    int i_count = 0;
+    int i_err = 0;
+
+    if (!p_dvbpsi || !dvbpsi_sis_splice_attach(p_dvbpsi, SpliceCallback, &i_count))
+        return 1;
+
+    dvbpsi_section_push(p_dvbpsi, splice_insert, sizeof(splice_insert));
+    dvbpsi_section_push(p_dvbpsi, splice_insert, sizeof(splice_insert));
+    memcpy(section, splice_insert, sizeof(section));
+    section[sizeof(section) - 1] ^= 1;
+    dvbpsi_section_push(p_dvbpsi, section, sizeof(section));
+    CHECK(i_count == 2);
+
+    dvbpsi_sis_splice_detach(p_dvbpsi);
+    dvbpsi_delete(p_dvbpsi);
+    return i_err;
+}
+
+int main(void)
+{
+    int i_err = 0;
+
+    fprintf(stdout, "splice information check:\n");
+    i_err |= CheckTimeSignal();
+    i_err |= CheckSpliceInsert();
+    i_err |= CheckComponents(splice_components[0], "components");
+    i_err |= CheckComponents(splice_components[1], "legacy command length");
+    i_err |= CheckInvalid();
+    i_err |= CheckDecoder();
+    if (i_err)
+        fprintf(stderr, "splice information check FAILED !!!\n");
+    else
+        fprintf(stdout, "splice information check succeeded\n");
+    return i_err;
+}
@@ -0,0 +1,231 @@
+/*****************************************************************************
+ * test_tap.c: section taps attached and detached in every order
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+/* the libdvbpsi distribution defines DVBPSI_DIST */
+#ifdef DVBPSI_DIST
+#include "../src/dvbpsi.h"
+#include "../src/psi.h"
+#include "../src/tables/pat.h"
+#include "../src/epg.h"
+#include "../src/metrics.h"
+#include "../src/warmstart.h"
+#else
+#include <dvbpsi/dvbpsi.h>
+#include <dvbpsi/psi.h>
+#include <dvbpsi/pat.h>
+#include <dvbpsi/epg.h>
+#include <dvbpsi/metrics.h>
+#include <dvbpsi/warmstart.h>
+#endif
+
+#define TAPS 3
+
+/* the permutations of 3 elements */
+static const int perms[6][TAPS] =
+{
+    { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 }
+};
+
+static char calls[16];
+static size_t i_calls;
+
+static void Tap(dvbpsi_t *p_dvbpsi, const dvbpsi_psi_section_t *p_section, void *p_cb_data)
+{
+    (void)p_dvbpsi; (void)p_section;
+    if (i_calls < sizeof(calls) - 1)
+        calls[i_calls++] = *(const char *)p_cb_data;
+    calls[i_calls] = '\0';
+}
+
+static void PatCallback(void *p_cb_data, dvbpsi_pat_t *p_pat)
+{
+    (void)p_cb_data;
+    dvbpsi_pat_delete(p_pat);
+}
+
+/* Push the section and return the taps called, in order */
+static const char *Push(dvbpsi_t *p_dvbpsi, const dvbpsi_psi_section_t *p_section)
+{
+    i_calls = 0;
+    calls[0] = '\0';
+    dvbpsi_section_push(p_dvbpsi, p_section->p_data,
+                        p_section->p_payload_end + 4 - p_section->p_data);
+    return calls;
+}
+
+/* Taps added then removed in every order */
+static int CheckTaps(dvbpsi_t *p_dvbpsi, const dvbpsi_psi_section_t *p_section)
+{
+    static char names[TAPS] = { 'a', 'b', 'c' };
+    int i_err = 0;
+
+    for (int i = 0; i < 6; i++)
+    {
+        char expected[TAPS + 1] = "abc";
+        const int *p_perm = perms[i];
+
+        for (int j = 0; j < TAPS; j++)
+            dvbpsi_section_tap_add(p_dvbpsi, Tap, &names[j]);
+        if (strcmp(Push(p_dvbpsi, p_section), expected))
+        {
+            fprintf(stderr, "  taps called \"%s\" instead of \"%s\"\n", calls, expected);
+            i_err = 1;
+        }
+
+        for (int j = 0; j < TAPS; j++)
+        {
+            char *p = strchr(expected, names[p_perm[j]]);
+            memmove(p, p + 1, strlen(p));
+            dvbpsi_section_tap_remove(p_dvbpsi, Tap, &names[p_perm[j]]);
+            if (strcmp(Push(p_dvbpsi, p_section), expected))
+            {
+                fprintf(stderr, "  taps called \"%s\" instead of \"%s\"\n", calls, expected);
+                i_err = 1;
+            }
+        }
+    }
+    return i_err;
+}
+
+/* Modules attached and detached in every order, sharing the handle with a
+ * tap of the caller */
+static int CheckModules(dvbpsi_t *p_dvbpsi, const dvbpsi_psi_section_t *p_section)
+{
+    static char name = 'u';
+    int i_err = 0;
+
+    for (int i = 0; i < 6; i++)
+    {
+        for (int j = 0; j < 6; j++)
+        {
+            dvbpsi_epg_t *p_epg = dvbpsi_epg_new();
+            dvbpsi_metrics_t *p_metrics = dvbpsi_metrics_new();
+            dvbpsi_warmstart_t *p_ws = dvbpsi_warmstart_new();
+            const dvbpsi_section_metrics_t *p_stats;
+            uint64_t i_count;
+
+            if (!p_epg || !p_metrics || !p_ws)
+                return 1;
+
+            for (int k = 0; k < TAPS; k++)
+            {
+                switch (perms[i][k])
+                {
+                case 0: dvbpsi_epg_attach(p_epg, p_dvbpsi); break;
+                case 1: dvbpsi_metrics_attach(p_metrics, p_dvbpsi, 0); break;
+                case 2: dvbpsi_warmstart_attach(p_ws, p_dvbpsi, 0); break;
+                }
+                if (k == 1)
+                    dvbpsi_section_tap_add(p_dvbpsi, Tap, &name);
+            }
+            if (strcmp(Push(p_dvbpsi, p_section), "u"))
+            {
+                fprintf(stderr, "  tap of the caller not called\n");
+                i_err = 1;
+            }
+
+            for (int k = 0; k < TAPS; k++)
+            {
+                switch (perms[j][k])
+                {
+                case 0: dvbpsi_epg_detach(p_epg, p_dvbpsi); break;
+                case 1: dvbpsi_metrics_detach(p_metrics, p_dvbpsi); break;
+                case 2: dvbpsi_warmstart_detach(p_ws, p_dvbpsi); break;
+                }
+                if (strcmp(Push(p_dvbpsi, p_section), "u"))
+                {
+                    fprintf(stderr, "  tap of the caller lost after a detach\n");
+                    i_err = 1;
+                }
+            }
+
+            /* the recorders only saw the sections pushed while attached */
+            p_stats = dvbpsi_metrics_get(p_metrics, 0, 0x00, p_section->i_extension, 0);
+            i_count = 0;
+            for (int k = 0; perms[j][k] != 1; k++)
+                i_count++;
+            if (!p_stats || p_stats->i_count != i_count + 1)
+            {
+                fprintf(stderr, "  metrics saw %"PRIu64" sections instead of %"PRIu64"\n",
+                        p_stats ? p_stats->i_count : 0, i_count + 1);
+                i_err = 1;
+            }
+            if (dvbpsi_warmstart_restore(p_ws, p_dvbpsi, 0) != 1)
+            {
+                fprintf(stderr, "  warm start recorder lost its section\n");
+                i_err = 1;
+            }
+
+            dvbpsi_section_tap_remove(p_dvbpsi, Tap, &name);
+            dvbpsi_warmstart_delete(p_ws);
+            dvbpsi_metrics_delete(p_metrics);
+            dvbpsi_epg_delete(p_epg);
+        }
+    }
+    return i_err;
+}
+
+int main(void)
+{
+    dvbpsi_t *p_dvbpsi = dvbpsi_new(NULL, DVBPSI_MSG_NONE);
+    dvbpsi_psi_section_t *p_section;
+    dvbpsi_pat_t pat;
+    int i_err = 0;
+
+    if (!p_dvbpsi || !dvbpsi_pat_attach(p_dvbpsi, PatCallback, NULL))
+        return 1;
+
+    dvbpsi_pat_init(&pat, 1, 0, true);
+    dvbpsi_pat_program_add(&pat, 1, 0x100);
+    p_section = dvbpsi_pat_sections_generate(p_dvbpsi, &pat, 253);
+    dvbpsi_pat_empty(&pat);
+    if (!p_section)
+        return 1;
+
+    fprintf(stdout, "section taps check:\n");
+    i_err |= CheckTaps(p_dvbpsi, p_section);
+    i_err |= CheckModules(p_dvbpsi, p_section);
+    if (i_err)
+        fprintf(stderr, "section taps check FAILED !!!\n");
+    else
+        fprintf(stdout, "section taps check succeeded\n");
+
+    dvbpsi_DeletePSISections(p_section);
+    dvbpsi_pat_detach(p_dvbpsi);
+    dvbpsi_delete(p_dvbpsi);
+    return i_err;
+}
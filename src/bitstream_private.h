@@ -0,0 +1,304 @@
+/*****************************************************************************
+ * bitstream_private.h: big-endian reader and writer
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#ifndef _DVBPSI_BITSTREAM_PRIVATE_H_
+#define _DVBPSI_BITSTREAM_PRIVATE_H_
+
+/*****************************************************************************
+ * Big-endian loads and stores
+ *****************************************************************************
+ * With GCC and clang on a little-endian target, a single unaligned load and
+ * a byte swap. The includer provides <string.h>.
+ *****************************************************************************/
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) \
+    && (defined(__clang__) || __GNUC__ >= 5)
+# if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  define DVBPSI_BE16(x) __builtin_bswap16(x)
+#  define DVBPSI_BE32(x) __builtin_bswap32(x)
+# else
+#  define DVBPSI_BE16(x) (x)
+#  define DVBPSI_BE32(x) (x)
+# endif
+#endif
+
+static inline uint16_t dvbpsi_get16(const uint8_t *p)
+{
+#ifdef DVBPSI_BE16
+    uint16_t i;
+    memcpy(&i, p, 2);
+    return DVBPSI_BE16(i);
+#else
+    return (uint16_t)p[0] << 8 | p[1];
+#endif
+}
+
+static inline uint32_t dvbpsi_get32(const uint8_t *p)
+{
+#ifdef DVBPSI_BE32
+    uint32_t i;
+    memcpy(&i, p, 4);
+    return DVBPSI_BE32(i);
+#else
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16
+         | (uint32_t)p[2] << 8 | p[3];
+#endif
+}
+
+static inline uint32_t dvbpsi_get24(const uint8_t *p)
+{
+    return (uint32_t)dvbpsi_get16(p) << 8 | p[2];
+}
+
+/* MJD and BCD start times, 33 bits PTS with their reserved bits */
+static inline uint64_t dvbpsi_get40(const uint8_t *p)
+{
+    return (uint64_t)p[0] << 32 | dvbpsi_get32(p + 1);
+}
+
+static inline void dvbpsi_set16(uint8_t *p, uint16_t i)
+{
+#ifdef DVBPSI_BE16
+    i = DVBPSI_BE16(i);
+    memcpy(p, &i, 2);
+#else
+    p[0] = i >> 8;
+    p[1] = i;
+#endif
+}
+
+static inline void dvbpsi_set32(uint8_t *p, uint32_t i)
+{
+#ifdef DVBPSI_BE32
+    i = DVBPSI_BE32(i);
+    memcpy(p, &i, 4);
+#else
+    p[0] = i >> 24;
+    p[1] = i >> 16;
+    p[2] = i >> 8;
+    p[3] = i;
+#endif
+}
+
+static inline void dvbpsi_set24(uint8_t *p, uint32_t i)
+{
+    dvbpsi_set16(p, i >> 8);
+    p[2] = i;
+}
+
+static inline void dvbpsi_set40(uint8_t *p, uint64_t i)
+{
+    p[0] = i >> 32;
+    dvbpsi_set32(p + 1, i);
+}
+
+/*****************************************************************************
+ * dvbpsi_reader_t
+ *****************************************************************************
+ * Bounded cursor. The size is checked once for a whole group of fields,
+ * typically at the top of a loop, then the fields are read without checks:
+ *
+ *   while (dvbpsi_reader_next(&reader, 5))
+ *   {
+ *       i_id = dvbpsi_read16(&reader);
+ *       ...
+ *   }
+ *
+ * A failed check moves the cursor to the end and sets b_error, so that the
+ * following checks fail too.
+ *****************************************************************************/
+typedef struct dvbpsi_reader_s
+{
+    const uint8_t  *p;
+    const uint8_t  *p_end;
+    bool            b_error;
+} dvbpsi_reader_t;
+
+static inline void dvbpsi_reader_init(dvbpsi_reader_t *p_reader,
+                                      const uint8_t *p, const uint8_t *p_end)
+{
+    p_reader->p = p;
+    p_reader->p_end = p_end > p ? p_end : p;
+    p_reader->b_error = false;
+}
+
+static inline size_t dvbpsi_reader_left(const dvbpsi_reader_t *p_reader)
+{
+    return p_reader->p_end - p_reader->p;
+}
+
+/* Check that i_size bytes are left */
+static inline bool dvbpsi_reader_need(dvbpsi_reader_t *p_reader, size_t i_size)
+{
+    if (dvbpsi_reader_left(p_reader) < i_size)
+    {
+        p_reader->b_error = true;
+        p_reader->p = p_reader->p_end;
+        return false;
+    }
+    return true;
+}
+
+/* Loop entry check: false at the end of the data, without error if the
+ * data ends on an entry boundary */
+static inline bool dvbpsi_reader_next(dvbpsi_reader_t *p_reader, size_t i_size)
+{
+    return p_reader->p < p_reader->p_end && dvbpsi_reader_need(p_reader, i_size);
+}
+
+/* Take the next i_size bytes, or what is left, as a reader of their own */
+static inline void dvbpsi_reader_sub(dvbpsi_reader_t *p_reader,
+                                     dvbpsi_reader_t *p_sub, size_t i_size)
+{
+    if (i_size > dvbpsi_reader_left(p_reader))
+        i_size = dvbpsi_reader_left(p_reader);
+    dvbpsi_reader_init(p_sub, p_reader->p, p_reader->p + i_size);
+    p_reader->p += i_size;
+}
+
+/* Current position as a pointer into p_base, the writable buffer the reader
+ * was made from */
+static inline uint8_t *dvbpsi_reader_at(const dvbpsi_reader_t *p_reader,
+                                       uint8_t *p_base)
+{
+    return p_base + (p_reader->p - p_base);
+}
+
+/* The following ones read checked bytes */
+static inline void dvbpsi_reader_skip(dvbpsi_reader_t *p_reader, size_t i_size)
+{
+    p_reader->p += i_size;
+}
+
+static inline uint8_t dvbpsi_read8(dvbpsi_reader_t *p_reader)
+{
+    return *p_reader->p++;
+}
+
+static inline uint16_t dvbpsi_read16(dvbpsi_reader_t *p_reader)
+{
+    p_reader->p += 2;
+    return dvbpsi_get16(p_reader->p - 2);
+}
+
+static inline uint32_t dvbpsi_read24(dvbpsi_reader_t *p_reader)
+{
+    p_reader->p += 3;
+    return dvbpsi_get24(p_reader->p - 3);
+}
+
+static inline uint32_t dvbpsi_read32(dvbpsi_reader_t *p_reader)
+{
+    p_reader->p += 4;
+    return dvbpsi_get32(p_reader->p - 4);
+}
+
+static inline uint64_t dvbpsi_read40(dvbpsi_reader_t *p_reader)
+{
+    p_reader->p += 5;
+    return dvbpsi_get40(p_reader->p - 5);
+}
+
+/*****************************************************************************
+ * dvbpsi_writer_t
+ *****************************************************************************
+ * Bounded cursor writing in a buffer, same rules as dvbpsi_reader_t: check
+ * the room for a group of fields with dvbpsi_writer_need(), then write them.
+ *****************************************************************************/
+typedef struct dvbpsi_writer_s
+{
+    uint8_t        *p;
+    uint8_t        *p_end;
+    bool            b_error;
+} dvbpsi_writer_t;
+
+static inline void dvbpsi_writer_init(dvbpsi_writer_t *p_writer,
+                                      uint8_t *p, uint8_t *p_end)
+{
+    p_writer->p = p;
+    p_writer->p_end = p_end > p ? p_end : p;
+    p_writer->b_error = false;
+}
+
+static inline size_t dvbpsi_writer_left(const dvbpsi_writer_t *p_writer)
+{
+    return p_writer->p_end - p_writer->p;
+}
+
+/* Check that there is room for i_size bytes */
+static inline bool dvbpsi_writer_need(dvbpsi_writer_t *p_writer, size_t i_size)
+{
+    if (dvbpsi_writer_left(p_writer) < i_size)
+    {
+        p_writer->b_error = true;
+        p_writer->p = p_writer->p_end;
+        return false;
+    }
+    return true;
+}
+
+/* The following ones write in checked room */
+static inline void dvbpsi_writer_skip(dvbpsi_writer_t *p_writer, size_t i_size)
+{
+    p_writer->p += i_size;
+}
+
+static inline void dvbpsi_write8(dvbpsi_writer_t *p_writer, uint8_t i)
+{
+    *p_writer->p++ = i;
+}
+
+static inline void dvbpsi_write16(dvbpsi_writer_t *p_writer, uint16_t i)
+{
+    dvbpsi_set16(p_writer->p, i);
+    p_writer->p += 2;
+}
+
+static inline void dvbpsi_write24(dvbpsi_writer_t *p_writer, uint32_t i)
+{
+    dvbpsi_set24(p_writer->p, i);
+    p_writer->p += 3;
+}
+
+static inline void dvbpsi_write32(dvbpsi_writer_t *p_writer, uint32_t i)
+{
+    dvbpsi_set32(p_writer->p, i);
+    p_writer->p += 4;
+}
+
+static inline void dvbpsi_write40(dvbpsi_writer_t *p_writer, uint64_t i)
+{
+    dvbpsi_set40(p_writer->p, i);
+    p_writer->p += 5;
+}
+
+static inline void dvbpsi_write_bytes(dvbpsi_writer_t *p_writer,
+                                      const uint8_t *p, size_t i_size)
+{
+    memcpy(p_writer->p, p, i_size);
+    p_writer->p += i_size;
+}
+
+#else
+#error "Multiple inclusions of bitstream_private.h"
+#endif
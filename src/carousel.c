@@ -0,0 +1,431 @@
+/*****************************************************************************
+ * carousel.c: PSI/SI table carousel
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "psi.h"
+#include "packetizer.h"
+#include "carousel.h"
+
+/* i_heap value of the table being emitted */
+#define NOT_QUEUED ((size_t)-1)
+
+/*****************************************************************************
+ * carousel_cache_t
+ *****************************************************************************
+ * Packetized content of a table, allocated in one block. Sections are not
+ * packed so each one can be scheduled on its own.
+ *****************************************************************************/
+typedef struct carousel_cache_s
+{
+    size_t      i_sections;
+    size_t     *p_section_packet;   /* first packet of each section, the
+                                       last entry is the packet count */
+    uint8_t    *p_packets;
+} carousel_cache_t;
+
+struct dvbpsi_carousel_table_s
+{
+    uint16_t            i_pid;
+    uint64_t            i_order;        /* insertion order, breaks ties */
+
+    uint64_t            i_interval;
+    uint64_t            i_cycle;        /* start of the current cycle */
+    uint64_t            i_due;          /* next section due */
+
+    carousel_cache_t   *p_cache;
+    carousel_cache_t   *p_pending;      /* replacement waiting for the end
+                                           of the section being emitted */
+    size_t              i_section;      /* next section to send */
+    size_t              i_packet;       /* next packet to send */
+
+    size_t              i_heap;         /* position in the heap */
+};
+
+struct dvbpsi_carousel_s
+{
+    uint64_t                    i_now;
+    uint64_t                    i_order;
+
+    dvbpsi_carousel_table_t    *p_active;   /* section being emitted */
+    dvbpsi_carousel_table_t   **pp_heap;    /* other tables, on i_due */
+    size_t                      i_heap;
+    size_t                      i_heap_size;
+
+    uint8_t                     cc[8192];   /* next continuity_counter */
+};
+
+/*****************************************************************************
+ * CacheNew
+ *****************************************************************************/
+static carousel_cache_t *CacheNew(uint16_t i_pid, const dvbpsi_psi_section_t *p_sections)
+{
+    const dvbpsi_psi_section_t *p_section;
+    dvbpsi_packetizer_t packetizer;
+    carousel_cache_t *p_cache;
+    size_t i_sections = 0;
+    size_t i_packets = dvbpsi_packetizer_count(p_sections, false);
+    size_t i_section = 0, i_packet = 0;
+
+    for (p_section = p_sections; p_section; p_section = p_section->p_next)
+        i_sections++;
+    if (i_sections == 0)
+        return NULL;
+
+    p_cache = malloc(sizeof(carousel_cache_t)
+                     + (i_sections + 1) * sizeof(size_t)
+                     + i_packets * DVBPSI_TS_PACKET_SIZE);
+    if (p_cache == NULL)
+        return NULL;
+
+    p_cache->i_sections = i_sections;
+    p_cache->p_section_packet = (size_t *)(p_cache + 1);
+    p_cache->p_packets = (uint8_t *)(p_cache->p_section_packet + i_sections + 1);
+
+    /* continuity counters are set when the packets are emitted */
+    dvbpsi_packetizer_init(&packetizer, i_pid, false);
+    dvbpsi_packetizer_set_sections(&packetizer, p_sections);
+    while (!dvbpsi_packetizer_done(&packetizer))
+    {
+        if (packetizer.i_offset == 0)
+            p_cache->p_section_packet[i_section++] = i_packet;
+        i_packet += dvbpsi_packetize(&packetizer,
+                        p_cache->p_packets + i_packet * DVBPSI_TS_PACKET_SIZE, 1);
+    }
+    p_cache->p_section_packet[i_section] = i_packet;
+    assert(i_section == i_sections && i_packet == i_packets);
+
+    return p_cache;
+}
+
+/*****************************************************************************
+ * Heap of the queued tables, ordered on (i_due, i_order)
+ *****************************************************************************/
+static inline bool Earlier(const dvbpsi_carousel_table_t *a,
+                           const dvbpsi_carousel_table_t *b)
+{
+    return a->i_due < b->i_due || (a->i_due == b->i_due && a->i_order < b->i_order);
+}
+
+static inline void HeapSet(dvbpsi_carousel_t *p_carousel, size_t i,
+                           dvbpsi_carousel_table_t *p_table)
+{
+    p_carousel->pp_heap[i] = p_table;
+    p_table->i_heap = i;
+}
+
+static void HeapUp(dvbpsi_carousel_t *p_carousel, size_t i)
+{
+    dvbpsi_carousel_table_t *p_table = p_carousel->pp_heap[i];
+
+    while (i > 0)
+    {
+        size_t i_parent = (i - 1) / 2;
+        if (!Earlier(p_table, p_carousel->pp_heap[i_parent]))
+            break;
+        HeapSet(p_carousel, i, p_carousel->pp_heap[i_parent]);
+        i = i_parent;
+    }
+    HeapSet(p_carousel, i, p_table);
+}
+
+static void HeapDown(dvbpsi_carousel_t *p_carousel, size_t i)
+{
+    dvbpsi_carousel_table_t *p_table = p_carousel->pp_heap[i];
+
+    for (;;)
+    {
+        size_t i_child = 2 * i + 1;
+        if (i_child >= p_carousel->i_heap)
+            break;
+        if (i_child + 1 < p_carousel->i_heap &&
+            Earlier(p_carousel->pp_heap[i_child + 1], p_carousel->pp_heap[i_child]))
+            i_child++;
+        if (!Earlier(p_carousel->pp_heap[i_child], p_table))
+            break;
+        HeapSet(p_carousel, i, p_carousel->pp_heap[i_child]);
+        i = i_child;
+    }
+    HeapSet(p_carousel, i, p_table);
+}
+
+static void HeapPush(dvbpsi_carousel_t *p_carousel, dvbpsi_carousel_table_t *p_table)
+{
+    assert(p_carousel->i_heap < p_carousel->i_heap_size);
+    HeapSet(p_carousel, p_carousel->i_heap++, p_table);
+    HeapUp(p_carousel, p_table->i_heap);
+}
+
+static void HeapRemove(dvbpsi_carousel_t *p_carousel, dvbpsi_carousel_table_t *p_table)
+{
+    size_t i = p_table->i_heap;
+    dvbpsi_carousel_table_t *p_last = p_carousel->pp_heap[--p_carousel->i_heap];
+
+    p_table->i_heap = NOT_QUEUED;
+    if (p_last == p_table)
+        return;
+    HeapSet(p_carousel, i, p_last);
+    HeapUp(p_carousel, i);
+    HeapDown(p_carousel, p_last->i_heap);
+}
+
+/*****************************************************************************
+ * TableQueue
+ *****************************************************************************
+ * Sections are spread evenly over the repetition interval.
+ *****************************************************************************/
+static void TableQueue(dvbpsi_carousel_t *p_carousel, dvbpsi_carousel_table_t *p_table)
+{
+    if (p_table->i_section >= p_table->p_cache->i_sections)
+    {
+        p_table->i_section = 0;
+        p_table->i_cycle += p_table->i_interval;
+    }
+    p_table->i_due = p_table->i_cycle + p_table->i_interval * p_table->i_section
+                                        / p_table->p_cache->i_sections;
+    HeapPush(p_carousel, p_table);
+}
+
+/*****************************************************************************
+ * TableRestart
+ *****************************************************************************
+ * Switch to new content, starting a cycle now.
+ *****************************************************************************/
+static void TableRestart(dvbpsi_carousel_t *p_carousel, dvbpsi_carousel_table_t *p_table,
+                         carousel_cache_t *p_cache)
+{
+    free(p_table->p_cache);
+    p_table->p_cache = p_cache;
+    p_table->i_section = 0;
+    p_table->i_cycle = p_carousel->i_now;
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_new
+ *****************************************************************************/
+dvbpsi_carousel_t *dvbpsi_carousel_new(void)
+{
+    return calloc(1, sizeof(dvbpsi_carousel_t));
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_delete
+ *****************************************************************************/
+void dvbpsi_carousel_delete(dvbpsi_carousel_t *p_carousel)
+{
+    if (p_carousel == NULL)
+        return;
+
+    if (p_carousel->p_active)
+        dvbpsi_carousel_remove(p_carousel, p_carousel->p_active);
+    while (p_carousel->i_heap)
+        dvbpsi_carousel_remove(p_carousel, p_carousel->pp_heap[0]);
+    free(p_carousel->pp_heap);
+    free(p_carousel);
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_add
+ *****************************************************************************/
+dvbpsi_carousel_table_t *dvbpsi_carousel_add(dvbpsi_carousel_t *p_carousel,
+                                             uint16_t i_pid,
+                                             const dvbpsi_psi_section_t *p_sections,
+                                             uint64_t i_interval, uint64_t i_start)
+{
+    dvbpsi_carousel_table_t *p_table;
+
+    assert(p_carousel);
+    assert(i_pid < 0x1fff);
+
+    /* room for every table, the active one included */
+    if (p_carousel->i_heap + 1 >= p_carousel->i_heap_size)
+    {
+        size_t i_size = p_carousel->i_heap_size ? 2 * p_carousel->i_heap_size : 16;
+        dvbpsi_carousel_table_t **pp_heap = realloc(p_carousel->pp_heap,
+                                        i_size * sizeof(dvbpsi_carousel_table_t *));
+        if (pp_heap == NULL)
+            return NULL;
+        p_carousel->pp_heap = pp_heap;
+        p_carousel->i_heap_size = i_size;
+    }
+
+    p_table = calloc(1, sizeof(dvbpsi_carousel_table_t));
+    if (p_table == NULL)
+        return NULL;
+
+    p_table->p_cache = CacheNew(i_pid, p_sections);
+    if (p_table->p_cache == NULL)
+    {
+        free(p_table);
+        return NULL;
+    }
+    p_table->i_pid = i_pid;
+    p_table->i_order = p_carousel->i_order++;
+    p_table->i_interval = i_interval;
+    p_table->i_cycle = i_start;
+
+    TableQueue(p_carousel, p_table);
+    return p_table;
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_replace
+ *****************************************************************************/
+bool dvbpsi_carousel_replace(dvbpsi_carousel_t *p_carousel,
+                             dvbpsi_carousel_table_t *p_table,
+                             const dvbpsi_psi_section_t *p_sections)
+{
+    carousel_cache_t *p_cache;
+
+    assert(p_carousel && p_table);
+
+    p_cache = CacheNew(p_table->i_pid, p_sections);
+    if (p_cache == NULL)
+        return false;
+
+    if (p_table == p_carousel->p_active)
+    {
+        free(p_table->p_pending);
+        p_table->p_pending = p_cache;
+        return true;
+    }
+
+    HeapRemove(p_carousel, p_table);
+    TableRestart(p_carousel, p_table, p_cache);
+    TableQueue(p_carousel, p_table);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_remove
+ *****************************************************************************/
+void dvbpsi_carousel_remove(dvbpsi_carousel_t *p_carousel,
+                            dvbpsi_carousel_table_t *p_table)
+{
+    assert(p_carousel && p_table);
+
+    if (p_table == p_carousel->p_active)
+        p_carousel->p_active = NULL;
+    else
+        HeapRemove(p_carousel, p_table);
+
+    free(p_table->p_pending);
+    free(p_table->p_cache);
+    free(p_table);
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_next_due
+ *****************************************************************************/
+bool dvbpsi_carousel_next_due(const dvbpsi_carousel_t *p_carousel, uint64_t *pi_due)
+{
+    assert(p_carousel && pi_due);
+
+    if (p_carousel->p_active)
+        *pi_due = p_carousel->p_active->i_due;
+    else if (p_carousel->i_heap)
+        *pi_due = p_carousel->pp_heap[0]->i_due;
+    else
+        return false;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_carousel_emit
+ *****************************************************************************/
+size_t dvbpsi_carousel_emit(dvbpsi_carousel_t *p_carousel, uint64_t i_now,
+                            uint8_t *p_packets, size_t i_packets)
+{
+    dvbpsi_carousel_table_t *p_table;
+    size_t i = 0;
+
+    assert(p_carousel);
+    assert(p_packets || i_packets == 0);
+
+    p_table = p_carousel->p_active;
+
+    if (i_now > p_carousel->i_now)
+        p_carousel->i_now = i_now;
+
+    while (i < i_packets)
+    {
+        uint8_t *p_packet = p_packets + i * DVBPSI_TS_PACKET_SIZE;
+        const carousel_cache_t *p_cache;
+
+        if (p_table == NULL)
+        {
+            if (p_carousel->i_heap == 0 || p_carousel->pp_heap[0]->i_due > i_now)
+                break;
+            p_table = p_carousel->pp_heap[0];
+            HeapRemove(p_carousel, p_table);
+            /* a cycle starting more than one interval late starts now, the
+             * cycles missed are not sent in a burst to catch up */
+            if (p_table->i_section == 0
+             && p_table->i_cycle + p_table->i_interval < i_now)
+            {
+                p_table->i_cycle = i_now;
+                p_table->i_due = i_now;
+            }
+            p_table->i_packet = p_table->p_cache->p_section_packet[p_table->i_section];
+        }
+        p_cache = p_table->p_cache;
+
+        memcpy(p_packet, p_cache->p_packets + p_table->i_packet * DVBPSI_TS_PACKET_SIZE,
+               DVBPSI_TS_PACKET_SIZE);
+        p_packet[3] = 0x10 | p_carousel->cc[p_table->i_pid];
+        p_carousel->cc[p_table->i_pid] = (p_carousel->cc[p_table->i_pid] + 1) & 0x0f;
+        i++;
+
+        if (++p_table->i_packet < p_cache->p_section_packet[p_table->i_section + 1])
+            continue;
+
+        /* end of section */
+        if (p_table->p_pending)
+        {
+            TableRestart(p_carousel, p_table, p_table->p_pending);
+            p_table->p_pending = NULL;
+        }
+        else
+            p_table->i_section++;
+        TableQueue(p_carousel, p_table);
+        p_table = NULL;
+    }
+
+    p_carousel->p_active = p_table;
+    return i;
+}
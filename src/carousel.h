@@ -0,0 +1,193 @@
+/*****************************************************************************
+ * carousel.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <carousel.h>
+ * \brief PSI/SI table carousel.
+ *
+ * Repeats a set of tables on their PIDs at target repetition intervals,
+ * as needed to insert PSI/SI in a transport stream. Each table is
+ * packetized once when it is added or replaced and the TS packets are
+ * kept, emitting a packet then costs a copy and a continuity_counter
+ * update.
+ *
+ * The sections of a table are spread evenly over its repetition interval
+ * and each section is sent as a run of consecutive packets of its PID.
+ * Times are given by the caller in any unit, as long as the intervals and
+ * the times passed to dvbpsi_carousel_emit() use the same one (microseconds
+ * or 27 MHz ticks for example). The output only depends on the sequence of
+ * calls, so the same calls always give the same packets.
+ */
+
+#ifndef _DVBPSI_CAROUSEL_H_
+#define _DVBPSI_CAROUSEL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * dvbpsi_carousel_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_carousel_s dvbpsi_carousel_t
+ * \brief Opaque carousel handle.
+ */
+typedef struct dvbpsi_carousel_s dvbpsi_carousel_t;
+
+/*!
+ * \typedef struct dvbpsi_carousel_table_s dvbpsi_carousel_table_t
+ * \brief Opaque handle of a table in a carousel.
+ */
+typedef struct dvbpsi_carousel_table_s dvbpsi_carousel_table_t;
+
+/*****************************************************************************
+ * dvbpsi_carousel_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_carousel_t *dvbpsi_carousel_new(void)
+ * \brief Create an empty carousel. The current time of the carousel is 0
+ * until the first call to dvbpsi_carousel_emit().
+ * \return the carousel, NULL on allocation failure
+ */
+dvbpsi_carousel_t *dvbpsi_carousel_new(void);
+
+/*****************************************************************************
+ * dvbpsi_carousel_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_carousel_delete(dvbpsi_carousel_t *p_carousel)
+ * \brief Delete a carousel and all its tables.
+ * \param p_carousel the carousel, may be NULL
+ * \return nothing
+ */
+void dvbpsi_carousel_delete(dvbpsi_carousel_t *p_carousel);
+
+/*****************************************************************************
+ * dvbpsi_carousel_add
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_carousel_table_t *dvbpsi_carousel_add(dvbpsi_carousel_t *p_carousel,
+            uint16_t i_pid, const dvbpsi_psi_section_t *p_sections,
+            uint64_t i_interval, uint64_t i_start)
+ * \brief Add a table to the carousel.
+ *
+ * The sections are packetized immediately and may be deleted by the caller
+ * once the function returns. Several tables may share a PID, their
+ * sections are never interleaved.
+ * \param p_carousel the carousel
+ * \param i_pid PID of the table
+ * \param p_sections section chain as returned by the *_sections_generate()
+ * functions, with at least one section
+ * \param i_interval time between two transmissions of the complete table
+ * \param i_start time at which the first section is due, the following ones
+ * are due i_interval / number of sections apart. Giving distinct start
+ * times to the tables avoids sending them all in a burst.
+ * \return the table handle, NULL on allocation failure
+ */
+dvbpsi_carousel_table_t *dvbpsi_carousel_add(dvbpsi_carousel_t *p_carousel,
+                                             uint16_t i_pid,
+                                             const dvbpsi_psi_section_t *p_sections,
+                                             uint64_t i_interval, uint64_t i_start);
+
+/*****************************************************************************
+ * dvbpsi_carousel_replace
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_carousel_replace(dvbpsi_carousel_t *p_carousel,
+            dvbpsi_carousel_table_t *p_table, const dvbpsi_psi_section_t *p_sections)
+ * \brief Replace the content of a table, for instance with a new version.
+ *
+ * The new sections are packetized immediately. A section of the old
+ * content that is partly emitted is completed first, then the new content
+ * starts a new repetition cycle at the current time of the carousel.
+ * \param p_carousel the carousel
+ * \param p_table the table
+ * \param p_sections the new section chain, with at least one section
+ * \return true on success, false on allocation failure in which case the
+ * old content keeps being sent
+ */
+bool dvbpsi_carousel_replace(dvbpsi_carousel_t *p_carousel,
+                             dvbpsi_carousel_table_t *p_table,
+                             const dvbpsi_psi_section_t *p_sections);
+
+/*****************************************************************************
+ * dvbpsi_carousel_remove
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_carousel_remove(dvbpsi_carousel_t *p_carousel,
+                                   dvbpsi_carousel_table_t *p_table)
+ * \brief Remove a table from the carousel and delete it. A section of the
+ * table that is partly emitted is abandoned.
+ * \param p_carousel the carousel
+ * \param p_table the table
+ * \return nothing
+ */
+void dvbpsi_carousel_remove(dvbpsi_carousel_t *p_carousel,
+                            dvbpsi_carousel_table_t *p_table);
+
+/*****************************************************************************
+ * dvbpsi_carousel_next_due
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_carousel_next_due(const dvbpsi_carousel_t *p_carousel,
+                                     uint64_t *pi_due)
+ * \brief Time at which the next packet is due. When a section is partly
+ * emitted this is the time its first packet was due.
+ * \param p_carousel the carousel
+ * \param pi_due filled with the due time
+ * \return false when the carousel has no table
+ */
+bool dvbpsi_carousel_next_due(const dvbpsi_carousel_t *p_carousel, uint64_t *pi_due);
+
+/*****************************************************************************
+ * dvbpsi_carousel_emit
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_carousel_emit(dvbpsi_carousel_t *p_carousel, uint64_t i_now,
+                                   uint8_t *p_packets, size_t i_packets)
+ * \brief Emit the packets due at or before i_now.
+ *
+ * i_packets is the output budget, the number of packet slots the caller
+ * can give to the PSI/SI until its next call. Sections are emitted in the
+ * order of their due times, ties being broken by the order in which the
+ * tables were added. A section that does not fit in the budget is
+ * continued at the next call before any other section. A table whose cycle
+ * is due more than one interval before i_now starts a new cycle at i_now
+ * rather than sending the missed cycles in a burst.
+ * \param p_carousel the carousel
+ * \param i_now current time, must not go backwards between calls
+ * \param p_packets buffer of i_packets * DVBPSI_TS_PACKET_SIZE bytes
+ * \param i_packets number of packets the buffer can hold
+ * \return the number of packets written, less than i_packets when nothing
+ * else is due
+ */
+size_t dvbpsi_carousel_emit(dvbpsi_carousel_t *p_carousel, uint64_t i_now,
+                            uint8_t *p_packets, size_t i_packets);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of carousel.h"
+#endif
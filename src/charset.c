@@ -0,0 +1,1011 @@
+/*****************************************************************************
+ * charset.c: conversion of the DVB text strings to UTF-8
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "charset.h"
+#include "lock_private.h"
+
+/*****************************************************************************
+ * Character tables, upper halves from 0xa0, 0 for the unassigned codes
+ *****************************************************************************/
+/* ISO/IEC 6937 with the euro sign, figure A.1 */
+static const uint16_t iso6937[96] =
+{
+    0x00a0, 0x00a1, 0x00a2, 0x00a3, 0x20ac, 0x00a5, 0x0023, 0x00a7,
+    0x00a4, 0x2018, 0x201c, 0x00ab, 0x2190, 0x2191, 0x2192, 0x2193,
+    0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x00d7, 0x00b5, 0x00b6, 0x00b7,
+    0x00f7, 0x2019, 0x201d, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x00bf,
+    0x0000, 0x0300, 0x0301, 0x0302, 0x0303, 0x0304, 0x0306, 0x0307,
+    0x0308, 0x0308, 0x030a, 0x0327, 0x0000, 0x030b, 0x0328, 0x030c,
+    0x2015, 0x00b9, 0x00ae, 0x00a9, 0x2122, 0x266a, 0x00ac, 0x00a6,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x215b, 0x215c, 0x215d, 0x215e,
+    0x2126, 0x00c6, 0x0110, 0x00aa, 0x0126, 0x0000, 0x0132, 0x013f,
+    0x0141, 0x00d8, 0x0152, 0x00ba, 0x00de, 0x0166, 0x014a, 0x0149,
+    0x0138, 0x00e6, 0x0111, 0x00f0, 0x0127, 0x0131, 0x0133, 0x0140,
+    0x0142, 0x00f8, 0x0153, 0x00df, 0x00fe, 0x0167, 0x014b, 0x00ad
+};
+
+/* ISO/IEC 8859-1 */
+static const uint16_t iso8859_1[96] =
+{
+    0x00a0, 0x00a1, 0x00a2, 0x00a3, 0x00a4, 0x00a5, 0x00a6, 0x00a7,
+    0x00a8, 0x00a9, 0x00aa, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00af,
+    0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+    0x00b8, 0x00b9, 0x00ba, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x00bf,
+    0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x00c7,
+    0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+    0x00d0, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x00d7,
+    0x00d8, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x00dd, 0x00de, 0x00df,
+    0x00e0, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7,
+    0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+    0x00f0, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x00f7,
+    0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x00fd, 0x00fe, 0x00ff
+};
+
+/* ISO/IEC 8859-2 */
+static const uint16_t iso8859_2[96] =
+{
+    0x00a0, 0x0104, 0x02d8, 0x0141, 0x00a4, 0x013d, 0x015a, 0x00a7,
+    0x00a8, 0x0160, 0x015e, 0x0164, 0x0179, 0x00ad, 0x017d, 0x017b,
+    0x00b0, 0x0105, 0x02db, 0x0142, 0x00b4, 0x013e, 0x015b, 0x02c7,
+    0x00b8, 0x0161, 0x015f, 0x0165, 0x017a, 0x02dd, 0x017e, 0x017c,
+    0x0154, 0x00c1, 0x00c2, 0x0102, 0x00c4, 0x0139, 0x0106, 0x00c7,
+    0x010c, 0x00c9, 0x0118, 0x00cb, 0x011a, 0x00cd, 0x00ce, 0x010e,
+    0x0110, 0x0143, 0x0147, 0x00d3, 0x00d4, 0x0150, 0x00d6, 0x00d7,
+    0x0158, 0x016e, 0x00da, 0x0170, 0x00dc, 0x00dd, 0x0162, 0x00df,
+    0x0155, 0x00e1, 0x00e2, 0x0103, 0x00e4, 0x013a, 0x0107, 0x00e7,
+    0x010d, 0x00e9, 0x0119, 0x00eb, 0x011b, 0x00ed, 0x00ee, 0x010f,
+    0x0111, 0x0144, 0x0148, 0x00f3, 0x00f4, 0x0151, 0x00f6, 0x00f7,
+    0x0159, 0x016f, 0x00fa, 0x0171, 0x00fc, 0x00fd, 0x0163, 0x02d9
+};
+
+/* ISO/IEC 8859-3 */
+static const uint16_t iso8859_3[96] =
+{
+    0x00a0, 0x0126, 0x02d8, 0x00a3, 0x00a4, 0x0000, 0x0124, 0x00a7,
+    0x00a8, 0x0130, 0x015e, 0x011e, 0x0134, 0x00ad, 0x0000, 0x017b,
+    0x00b0, 0x0127, 0x00b2, 0x00b3, 0x00b4, 0x00b5, 0x0125, 0x00b7,
+    0x00b8, 0x0131, 0x015f, 0x011f, 0x0135, 0x00bd, 0x0000, 0x017c,
+    0x00c0, 0x00c1, 0x00c2, 0x0000, 0x00c4, 0x010a, 0x0108, 0x00c7,
+    0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+    0x0000, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x0120, 0x00d6, 0x00d7,
+    0x011c, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x016c, 0x015c, 0x00df,
+    0x00e0, 0x00e1, 0x00e2, 0x0000, 0x00e4, 0x010b, 0x0109, 0x00e7,
+    0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+    0x0000, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x0121, 0x00f6, 0x00f7,
+    0x011d, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x016d, 0x015d, 0x02d9
+};
+
+/* ISO/IEC 8859-4 */
+static const uint16_t iso8859_4[96] =
+{
+    0x00a0, 0x0104, 0x0138, 0x0156, 0x00a4, 0x0128, 0x013b, 0x00a7,
+    0x00a8, 0x0160, 0x0112, 0x0122, 0x0166, 0x00ad, 0x017d, 0x00af,
+    0x00b0, 0x0105, 0x02db, 0x0157, 0x00b4, 0x0129, 0x013c, 0x02c7,
+    0x00b8, 0x0161, 0x0113, 0x0123, 0x0167, 0x014a, 0x017e, 0x014b,
+    0x0100, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x012e,
+    0x010c, 0x00c9, 0x0118, 0x00cb, 0x0116, 0x00cd, 0x00ce, 0x012a,
+    0x0110, 0x0145, 0x014c, 0x0136, 0x00d4, 0x00d5, 0x00d6, 0x00d7,
+    0x00d8, 0x0172, 0x00da, 0x00db, 0x00dc, 0x0168, 0x016a, 0x00df,
+    0x0101, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x012f,
+    0x010d, 0x00e9, 0x0119, 0x00eb, 0x0117, 0x00ed, 0x00ee, 0x012b,
+    0x0111, 0x0146, 0x014d, 0x0137, 0x00f4, 0x00f5, 0x00f6, 0x00f7,
+    0x00f8, 0x0173, 0x00fa, 0x00fb, 0x00fc, 0x0169, 0x016b, 0x02d9
+};
+
+/* ISO/IEC 8859-5 */
+static const uint16_t iso8859_5[96] =
+{
+    0x00a0, 0x0401, 0x0402, 0x0403, 0x0404, 0x0405, 0x0406, 0x0407,
+    0x0408, 0x0409, 0x040a, 0x040b, 0x040c, 0x00ad, 0x040e, 0x040f,
+    0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+    0x0418, 0x0419, 0x041a, 0x041b, 0x041c, 0x041d, 0x041e, 0x041f,
+    0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+    0x0428, 0x0429, 0x042a, 0x042b, 0x042c, 0x042d, 0x042e, 0x042f,
+    0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+    0x0438, 0x0439, 0x043a, 0x043b, 0x043c, 0x043d, 0x043e, 0x043f,
+    0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+    0x0448, 0x0449, 0x044a, 0x044b, 0x044c, 0x044d, 0x044e, 0x044f,
+    0x2116, 0x0451, 0x0452, 0x0453, 0x0454, 0x0455, 0x0456, 0x0457,
+    0x0458, 0x0459, 0x045a, 0x045b, 0x045c, 0x00a7, 0x045e, 0x045f
+};
+
+/* ISO/IEC 8859-6 */
+static const uint16_t iso8859_6[96] =
+{
+    0x00a0, 0x0000, 0x0000, 0x0000, 0x00a4, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x060c, 0x00ad, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x061b, 0x0000, 0x0000, 0x0000, 0x061f,
+    0x0000, 0x0621, 0x0622, 0x0623, 0x0624, 0x0625, 0x0626, 0x0627,
+    0x0628, 0x0629, 0x062a, 0x062b, 0x062c, 0x062d, 0x062e, 0x062f,
+    0x0630, 0x0631, 0x0632, 0x0633, 0x0634, 0x0635, 0x0636, 0x0637,
+    0x0638, 0x0639, 0x063a, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0640, 0x0641, 0x0642, 0x0643, 0x0644, 0x0645, 0x0646, 0x0647,
+    0x0648, 0x0649, 0x064a, 0x064b, 0x064c, 0x064d, 0x064e, 0x064f,
+    0x0650, 0x0651, 0x0652, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+};
+
+/* ISO/IEC 8859-7 */
+static const uint16_t iso8859_7[96] =
+{
+    0x00a0, 0x2018, 0x2019, 0x00a3, 0x20ac, 0x20af, 0x00a6, 0x00a7,
+    0x00a8, 0x00a9, 0x037a, 0x00ab, 0x00ac, 0x00ad, 0x0000, 0x2015,
+    0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x0384, 0x0385, 0x0386, 0x00b7,
+    0x0388, 0x0389, 0x038a, 0x00bb, 0x038c, 0x00bd, 0x038e, 0x038f,
+    0x0390, 0x0391, 0x0392, 0x0393, 0x0394, 0x0395, 0x0396, 0x0397,
+    0x0398, 0x0399, 0x039a, 0x039b, 0x039c, 0x039d, 0x039e, 0x039f,
+    0x03a0, 0x03a1, 0x0000, 0x03a3, 0x03a4, 0x03a5, 0x03a6, 0x03a7,
+    0x03a8, 0x03a9, 0x03aa, 0x03ab, 0x03ac, 0x03ad, 0x03ae, 0x03af,
+    0x03b0, 0x03b1, 0x03b2, 0x03b3, 0x03b4, 0x03b5, 0x03b6, 0x03b7,
+    0x03b8, 0x03b9, 0x03ba, 0x03bb, 0x03bc, 0x03bd, 0x03be, 0x03bf,
+    0x03c0, 0x03c1, 0x03c2, 0x03c3, 0x03c4, 0x03c5, 0x03c6, 0x03c7,
+    0x03c8, 0x03c9, 0x03ca, 0x03cb, 0x03cc, 0x03cd, 0x03ce, 0x0000
+};
+
+/* ISO/IEC 8859-8 */
+static const uint16_t iso8859_8[96] =
+{
+    0x00a0, 0x0000, 0x00a2, 0x00a3, 0x00a4, 0x00a5, 0x00a6, 0x00a7,
+    0x00a8, 0x00a9, 0x00d7, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00af,
+    0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+    0x00b8, 0x00b9, 0x00f7, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x2017,
+    0x05d0, 0x05d1, 0x05d2, 0x05d3, 0x05d4, 0x05d5, 0x05d6, 0x05d7,
+    0x05d8, 0x05d9, 0x05da, 0x05db, 0x05dc, 0x05dd, 0x05de, 0x05df,
+    0x05e0, 0x05e1, 0x05e2, 0x05e3, 0x05e4, 0x05e5, 0x05e6, 0x05e7,
+    0x05e8, 0x05e9, 0x05ea, 0x0000, 0x0000, 0x200e, 0x200f, 0x0000
+};
+
+/* ISO/IEC 8859-9 */
+static const uint16_t iso8859_9[96] =
+{
+    0x00a0, 0x00a1, 0x00a2, 0x00a3, 0x00a4, 0x00a5, 0x00a6, 0x00a7,
+    0x00a8, 0x00a9, 0x00aa, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00af,
+    0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x00b4, 0x00b5, 0x00b6, 0x00b7,
+    0x00b8, 0x00b9, 0x00ba, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x00bf,
+    0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x00c7,
+    0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+    0x011e, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x00d7,
+    0x00d8, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x0130, 0x015e, 0x00df,
+    0x00e0, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7,
+    0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+    0x011f, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x00f7,
+    0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x0131, 0x015f, 0x00ff
+};
+
+/* ISO/IEC 8859-10 */
+static const uint16_t iso8859_10[96] =
+{
+    0x00a0, 0x0104, 0x0112, 0x0122, 0x012a, 0x0128, 0x0136, 0x00a7,
+    0x013b, 0x0110, 0x0160, 0x0166, 0x017d, 0x00ad, 0x016a, 0x014a,
+    0x00b0, 0x0105, 0x0113, 0x0123, 0x012b, 0x0129, 0x0137, 0x00b7,
+    0x013c, 0x0111, 0x0161, 0x0167, 0x017e, 0x2015, 0x016b, 0x014b,
+    0x0100, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x012e,
+    0x010c, 0x00c9, 0x0118, 0x00cb, 0x0116, 0x00cd, 0x00ce, 0x00cf,
+    0x00d0, 0x0145, 0x014c, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x0168,
+    0x00d8, 0x0172, 0x00da, 0x00db, 0x00dc, 0x00dd, 0x00de, 0x00df,
+    0x0101, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x012f,
+    0x010d, 0x00e9, 0x0119, 0x00eb, 0x0117, 0x00ed, 0x00ee, 0x00ef,
+    0x00f0, 0x0146, 0x014d, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x0169,
+    0x00f8, 0x0173, 0x00fa, 0x00fb, 0x00fc, 0x00fd, 0x00fe, 0x0138
+};
+
+/* ISO/IEC 8859-11 */
+static const uint16_t iso8859_11[96] =
+{
+    0x00a0, 0x0e01, 0x0e02, 0x0e03, 0x0e04, 0x0e05, 0x0e06, 0x0e07,
+    0x0e08, 0x0e09, 0x0e0a, 0x0e0b, 0x0e0c, 0x0e0d, 0x0e0e, 0x0e0f,
+    0x0e10, 0x0e11, 0x0e12, 0x0e13, 0x0e14, 0x0e15, 0x0e16, 0x0e17,
+    0x0e18, 0x0e19, 0x0e1a, 0x0e1b, 0x0e1c, 0x0e1d, 0x0e1e, 0x0e1f,
+    0x0e20, 0x0e21, 0x0e22, 0x0e23, 0x0e24, 0x0e25, 0x0e26, 0x0e27,
+    0x0e28, 0x0e29, 0x0e2a, 0x0e2b, 0x0e2c, 0x0e2d, 0x0e2e, 0x0e2f,
+    0x0e30, 0x0e31, 0x0e32, 0x0e33, 0x0e34, 0x0e35, 0x0e36, 0x0e37,
+    0x0e38, 0x0e39, 0x0e3a, 0x0000, 0x0000, 0x0000, 0x0000, 0x0e3f,
+    0x0e40, 0x0e41, 0x0e42, 0x0e43, 0x0e44, 0x0e45, 0x0e46, 0x0e47,
+    0x0e48, 0x0e49, 0x0e4a, 0x0e4b, 0x0e4c, 0x0e4d, 0x0e4e, 0x0e4f,
+    0x0e50, 0x0e51, 0x0e52, 0x0e53, 0x0e54, 0x0e55, 0x0e56, 0x0e57,
+    0x0e58, 0x0e59, 0x0e5a, 0x0e5b, 0x0000, 0x0000, 0x0000, 0x0000
+};
+
+/* ISO/IEC 8859-13 */
+static const uint16_t iso8859_13[96] =
+{
+    0x00a0, 0x201d, 0x00a2, 0x00a3, 0x00a4, 0x201e, 0x00a6, 0x00a7,
+    0x00d8, 0x00a9, 0x0156, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00c6,
+    0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x201c, 0x00b5, 0x00b6, 0x00b7,
+    0x00f8, 0x00b9, 0x0157, 0x00bb, 0x00bc, 0x00bd, 0x00be, 0x00e6,
+    0x0104, 0x012e, 0x0100, 0x0106, 0x00c4, 0x00c5, 0x0118, 0x0112,
+    0x010c, 0x00c9, 0x0179, 0x0116, 0x0122, 0x0136, 0x012a, 0x013b,
+    0x0160, 0x0143, 0x0145, 0x00d3, 0x014c, 0x00d5, 0x00d6, 0x00d7,
+    0x0172, 0x0141, 0x015a, 0x016a, 0x00dc, 0x017b, 0x017d, 0x00df,
+    0x0105, 0x012f, 0x0101, 0x0107, 0x00e4, 0x00e5, 0x0119, 0x0113,
+    0x010d, 0x00e9, 0x017a, 0x0117, 0x0123, 0x0137, 0x012b, 0x013c,
+    0x0161, 0x0144, 0x0146, 0x00f3, 0x014d, 0x00f5, 0x00f6, 0x00f7,
+    0x0173, 0x0142, 0x015b, 0x016b, 0x00fc, 0x017c, 0x017e, 0x2019
+};
+
+/* ISO/IEC 8859-14 */
+static const uint16_t iso8859_14[96] =
+{
+    0x00a0, 0x1e02, 0x1e03, 0x00a3, 0x010a, 0x010b, 0x1e0a, 0x00a7,
+    0x1e80, 0x00a9, 0x1e82, 0x1e0b, 0x1ef2, 0x00ad, 0x00ae, 0x0178,
+    0x1e1e, 0x1e1f, 0x0120, 0x0121, 0x1e40, 0x1e41, 0x00b6, 0x1e56,
+    0x1e81, 0x1e57, 0x1e83, 0x1e60, 0x1ef3, 0x1e84, 0x1e85, 0x1e61,
+    0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x00c7,
+    0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+    0x0174, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x1e6a,
+    0x00d8, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x00dd, 0x0176, 0x00df,
+    0x00e0, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7,
+    0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+    0x0175, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x1e6b,
+    0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x00fd, 0x0177, 0x00ff
+};
+
+/* ISO/IEC 8859-15 */
+static const uint16_t iso8859_15[96] =
+{
+    0x00a0, 0x00a1, 0x00a2, 0x00a3, 0x20ac, 0x00a5, 0x0160, 0x00a7,
+    0x0161, 0x00a9, 0x00aa, 0x00ab, 0x00ac, 0x00ad, 0x00ae, 0x00af,
+    0x00b0, 0x00b1, 0x00b2, 0x00b3, 0x017d, 0x00b5, 0x00b6, 0x00b7,
+    0x017e, 0x00b9, 0x00ba, 0x00bb, 0x0152, 0x0153, 0x0178, 0x00bf,
+    0x00c0, 0x00c1, 0x00c2, 0x00c3, 0x00c4, 0x00c5, 0x00c6, 0x00c7,
+    0x00c8, 0x00c9, 0x00ca, 0x00cb, 0x00cc, 0x00cd, 0x00ce, 0x00cf,
+    0x00d0, 0x00d1, 0x00d2, 0x00d3, 0x00d4, 0x00d5, 0x00d6, 0x00d7,
+    0x00d8, 0x00d9, 0x00da, 0x00db, 0x00dc, 0x00dd, 0x00de, 0x00df,
+    0x00e0, 0x00e1, 0x00e2, 0x00e3, 0x00e4, 0x00e5, 0x00e6, 0x00e7,
+    0x00e8, 0x00e9, 0x00ea, 0x00eb, 0x00ec, 0x00ed, 0x00ee, 0x00ef,
+    0x00f0, 0x00f1, 0x00f2, 0x00f3, 0x00f4, 0x00f5, 0x00f6, 0x00f7,
+    0x00f8, 0x00f9, 0x00fa, 0x00fb, 0x00fc, 0x00fd, 0x00fe, 0x00ff
+};
+
+/* Letters with the diacritical marks 0xc1 to 0xcf, from 0x40 to 0x7f */
+static const uint16_t iso6937_compose[15][64] =
+{
+    { /* 0xc1 */
+        0x0000, 0x00c0, 0x0000, 0x0000, 0x0000, 0x00c8, 0x0000, 0x0000,
+        0x0000, 0x00cc, 0x0000, 0x0000, 0x0000, 0x0000, 0x01f8, 0x00d2,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00d9, 0x0000, 0x1e80,
+        0x0000, 0x1ef2, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x00e0, 0x0000, 0x0000, 0x0000, 0x00e8, 0x0000, 0x0000,
+        0x0000, 0x00ec, 0x0000, 0x0000, 0x0000, 0x0000, 0x01f9, 0x00f2,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00f9, 0x0000, 0x1e81,
+        0x0000, 0x1ef3, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xc2 */
+        0x0000, 0x00c1, 0x0000, 0x0106, 0x0000, 0x00c9, 0x0000, 0x01f4,
+        0x0000, 0x00cd, 0x0000, 0x1e30, 0x0139, 0x1e3e, 0x0143, 0x00d3,
+        0x1e54, 0x0000, 0x0154, 0x015a, 0x0000, 0x00da, 0x0000, 0x1e82,
+        0x0000, 0x00dd, 0x0179, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x00e1, 0x0000, 0x0107, 0x0000, 0x00e9, 0x0000, 0x01f5,
+        0x0000, 0x00ed, 0x0000, 0x1e31, 0x013a, 0x1e3f, 0x0144, 0x00f3,
+        0x1e55, 0x0000, 0x0155, 0x015b, 0x0000, 0x00fa, 0x0000, 0x1e83,
+        0x0000, 0x00fd, 0x017a, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xc3 */
+        0x0000, 0x00c2, 0x0000, 0x0108, 0x0000, 0x00ca, 0x0000, 0x011c,
+        0x0124, 0x00ce, 0x0134, 0x0000, 0x0000, 0x0000, 0x0000, 0x00d4,
+        0x0000, 0x0000, 0x0000, 0x015c, 0x0000, 0x00db, 0x0000, 0x0174,
+        0x0000, 0x0176, 0x1e90, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x00e2, 0x0000, 0x0109, 0x0000, 0x00ea, 0x0000, 0x011d,
+        0x0125, 0x00ee, 0x0135, 0x0000, 0x0000, 0x0000, 0x0000, 0x00f4,
+        0x0000, 0x0000, 0x0000, 0x015d, 0x0000, 0x00fb, 0x0000, 0x0175,
+        0x0000, 0x0177, 0x1e91, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xc4 */
+        0x0000, 0x00c3, 0x0000, 0x0000, 0x0000, 0x1ebc, 0x0000, 0x0000,
+        0x0000, 0x0128, 0x0000, 0x0000, 0x0000, 0x0000, 0x00d1, 0x00d5,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0168, 0x1e7c, 0x0000,
+        0x0000, 0x1ef8, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x00e3, 0x0000, 0x0000, 0x0000, 0x1ebd, 0x0000, 0x0000,
+        0x0000, 0x0129, 0x0000, 0x0000, 0x0000, 0x0000, 0x00f1, 0x00f5,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0169, 0x1e7d, 0x0000,
+        0x0000, 0x1ef9, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xc5 */
+        0x0000, 0x0100, 0x0000, 0x0000, 0x0000, 0x0112, 0x0000, 0x1e20,
+        0x0000, 0x012a, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x014c,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x016a, 0x0000, 0x0000,
+        0x0000, 0x0232, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0101, 0x0000, 0x0000, 0x0000, 0x0113, 0x0000, 0x1e21,
+        0x0000, 0x012b, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x014d,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x016b, 0x0000, 0x0000,
+        0x0000, 0x0233, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xc6 */
+        0x0000, 0x0102, 0x0000, 0x0000, 0x0000, 0x0114, 0x0000, 0x011e,
+        0x0000, 0x012c, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x014e,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x016c, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0103, 0x0000, 0x0000, 0x0000, 0x0115, 0x0000, 0x011f,
+        0x0000, 0x012d, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x014f,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x016d, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xc7 */
+        0x0000, 0x0226, 0x1e02, 0x010a, 0x1e0a, 0x0116, 0x1e1e, 0x0120,
+        0x1e22, 0x0130, 0x0000, 0x0000, 0x0000, 0x1e40, 0x1e44, 0x022e,
+        0x1e56, 0x0000, 0x1e58, 0x1e60, 0x1e6a, 0x0000, 0x0000, 0x1e86,
+        0x1e8a, 0x1e8e, 0x017b, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0227, 0x1e03, 0x010b, 0x1e0b, 0x0117, 0x1e1f, 0x0121,
+        0x1e23, 0x0000, 0x0000, 0x0000, 0x0000, 0x1e41, 0x1e45, 0x022f,
+        0x1e57, 0x0000, 0x1e59, 0x1e61, 0x1e6b, 0x0000, 0x0000, 0x1e87,
+        0x1e8b, 0x1e8f, 0x017c, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xc8 */
+        0x0000, 0x00c4, 0x0000, 0x0000, 0x0000, 0x00cb, 0x0000, 0x0000,
+        0x1e26, 0x00cf, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00d6,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00dc, 0x0000, 0x1e84,
+        0x1e8c, 0x0178, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x00e4, 0x0000, 0x0000, 0x0000, 0x00eb, 0x0000, 0x0000,
+        0x1e27, 0x00ef, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00f6,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x1e97, 0x00fc, 0x0000, 0x1e85,
+        0x1e8d, 0x00ff, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xc9 */
+        0x0000, 0x00c4, 0x0000, 0x0000, 0x0000, 0x00cb, 0x0000, 0x0000,
+        0x1e26, 0x00cf, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00d6,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00dc, 0x0000, 0x1e84,
+        0x1e8c, 0x0178, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x00e4, 0x0000, 0x0000, 0x0000, 0x00eb, 0x0000, 0x0000,
+        0x1e27, 0x00ef, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00f6,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x1e97, 0x00fc, 0x0000, 0x1e85,
+        0x1e8d, 0x00ff, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xca */
+        0x0000, 0x00c5, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x016e, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x00e5, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x016f, 0x0000, 0x1e98,
+        0x0000, 0x1e99, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xcb */
+        0x0000, 0x0000, 0x0000, 0x00c7, 0x1e10, 0x0228, 0x0000, 0x0122,
+        0x1e28, 0x0000, 0x0000, 0x0136, 0x013b, 0x0000, 0x0145, 0x0000,
+        0x0000, 0x0000, 0x0156, 0x015e, 0x0162, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x00e7, 0x1e11, 0x0229, 0x0000, 0x0123,
+        0x1e29, 0x0000, 0x0000, 0x0137, 0x013c, 0x0000, 0x0146, 0x0000,
+        0x0000, 0x0000, 0x0157, 0x015f, 0x0163, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xcc */
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xcd */
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0150,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0170, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0151,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0171, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xce */
+        0x0000, 0x0104, 0x0000, 0x0000, 0x0000, 0x0118, 0x0000, 0x0000,
+        0x0000, 0x012e, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x01ea,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0172, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x0105, 0x0000, 0x0000, 0x0000, 0x0119, 0x0000, 0x0000,
+        0x0000, 0x012f, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x01eb,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0173, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    },
+    { /* 0xcf */
+        0x0000, 0x01cd, 0x0000, 0x010c, 0x010e, 0x011a, 0x0000, 0x01e6,
+        0x021e, 0x01cf, 0x0000, 0x01e8, 0x013d, 0x0000, 0x0147, 0x01d1,
+        0x0000, 0x0000, 0x0158, 0x0160, 0x0164, 0x01d3, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x017d, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+        0x0000, 0x01ce, 0x0000, 0x010d, 0x010f, 0x011b, 0x0000, 0x01e7,
+        0x021f, 0x01d0, 0x01f0, 0x01e9, 0x013e, 0x0000, 0x0148, 0x01d2,
+        0x0000, 0x0000, 0x0159, 0x0161, 0x0165, 0x01d4, 0x0000, 0x0000,
+        0x0000, 0x0000, 0x017e, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000
+    }
+};
+
+/* ISO/IEC 8859-n, n from 1 to 15, there is no 8859-12 */
+static const uint16_t *const iso8859[16] =
+{
+    NULL, iso8859_1, iso8859_2, iso8859_3, iso8859_4, iso8859_5, iso8859_6,
+    iso8859_7, iso8859_8, iso8859_9, iso8859_10, iso8859_11, NULL,
+    iso8859_13, iso8859_14, iso8859_15
+};
+
+/*****************************************************************************
+ * Output
+ *****************************************************************************/
+typedef struct text_out_s
+{
+    char           *psz;
+    size_t          i_size;
+    size_t          i_written;      /* bytes in psz */
+    size_t          i_length;       /* bytes of the whole string */
+} text_out_t;
+
+#define TEXT_CR_LF          0x8a
+#define TEXT_REPLACEMENT    0xfffd
+
+static inline void TextPut(text_out_t *p_out, uint32_t i_char)
+{
+    uint8_t p_utf8[4];
+    size_t i_bytes;
+
+    if (i_char < 0x80)
+    {
+        p_utf8[0] = i_char;
+        i_bytes = 1;
+    }
+    else if (i_char < 0x800)
+    {
+        p_utf8[0] = 0xc0 | (i_char >> 6);
+        p_utf8[1] = 0x80 | (i_char & 0x3f);
+        i_bytes = 2;
+    }
+    else if (i_char < 0x10000)
+    {
+        p_utf8[0] = 0xe0 | (i_char >> 12);
+        p_utf8[1] = 0x80 | ((i_char >> 6) & 0x3f);
+        p_utf8[2] = 0x80 | (i_char & 0x3f);
+        i_bytes = 3;
+    }
+    else
+    {
+        p_utf8[0] = 0xf0 | (i_char >> 18);
+        p_utf8[1] = 0x80 | ((i_char >> 12) & 0x3f);
+        p_utf8[2] = 0x80 | ((i_char >> 6) & 0x3f);
+        p_utf8[3] = 0x80 | (i_char & 0x3f);
+        i_bytes = 4;
+    }
+
+    /* stop at the first character which does not fit */
+    if (p_out->i_written == p_out->i_length && p_out->i_length + i_bytes < p_out->i_size)
+    {
+        memcpy(p_out->psz + p_out->i_written, p_utf8, i_bytes);
+        p_out->i_written += i_bytes;
+    }
+    p_out->i_length += i_bytes;
+}
+
+/* The control codes of the single byte tables, 0x80 to 0x9f, and of the
+ * others, U+0080 to U+009F or 0xE080 to 0xE09F: only CR/LF is kept */
+static inline void TextControl(text_out_t *p_out, uint32_t i_code)
+{
+    if (i_code == TEXT_CR_LF)
+        TextPut(p_out, '\n');
+}
+
+/*****************************************************************************
+ * Decoders
+ *****************************************************************************/
+static void TextSingleByte(text_out_t *p_out, const uint8_t *p_text, size_t i_length,
+                           const uint16_t *p_table)
+{
+    for (size_t i = 0; i < i_length; i++)
+    {
+        const uint8_t i_byte = p_text[i];
+        if (i_byte < 0x80)
+        {
+            if (i_byte)
+                TextPut(p_out, i_byte);
+        }
+        else if (i_byte < 0xa0)
+            TextControl(p_out, i_byte);
+        else if (p_table[i_byte - 0xa0])
+            TextPut(p_out, p_table[i_byte - 0xa0]);
+    }
+}
+
+/* ISO/IEC 6937: the diacritical marks 0xc1 to 0xcf precede the letter */
+static void TextIso6937(text_out_t *p_out, const uint8_t *p_text, size_t i_length)
+{
+    for (size_t i = 0; i < i_length; i++)
+    {
+        const uint8_t i_byte = p_text[i];
+        if (i_byte < 0x80)
+        {
+            if (i_byte)
+                TextPut(p_out, i_byte);
+        }
+        else if (i_byte < 0xa0)
+            TextControl(p_out, i_byte);
+        else if (i_byte >= 0xc1 && i_byte <= 0xcf)
+        {
+            const uint16_t i_mark = iso6937[i_byte - 0xa0];
+            uint8_t i_letter;
+            if (!i_mark || i + 1 >= i_length || p_text[i + 1] < 0x20 || p_text[i + 1] >= 0x80)
+                continue;
+            i_letter = p_text[++i];
+            if (i_letter >= 0x40 && iso6937_compose[i_byte - 0xc1][i_letter - 0x40])
+                TextPut(p_out, iso6937_compose[i_byte - 0xc1][i_letter - 0x40]);
+            else
+            {
+                TextPut(p_out, i_letter);
+                TextPut(p_out, i_mark);
+            }
+        }
+        else if (iso6937[i_byte - 0xa0])
+            TextPut(p_out, iso6937[i_byte - 0xa0]);
+    }
+}
+
+/* ISO/IEC 10646 Basic Multilingual Plane, big endian */
+static void TextUcs2(text_out_t *p_out, const uint8_t *p_text, size_t i_length)
+{
+    for (size_t i = 0; i + 1 < i_length; i += 2)
+    {
+        uint32_t i_char = (uint32_t)p_text[i] << 8 | p_text[i + 1];
+        if (i_char >= 0xe080 && i_char <= 0xe09f)
+            TextControl(p_out, i_char & 0xff);
+        else if (i_char >= 0x80 && i_char <= 0x9f)
+            TextControl(p_out, i_char);
+        else if (i_char >= 0xd800 && i_char <= 0xdbff && i + 3 < i_length
+              && p_text[i + 2] >= 0xdc && p_text[i + 2] <= 0xdf)
+        {
+            /* surrogate pair */
+            uint32_t i_low = (uint32_t)p_text[i + 2] << 8 | p_text[i + 3];
+            TextPut(p_out, 0x10000 + ((i_char - 0xd800) << 10) + (i_low - 0xdc00));
+            i += 2;
+        }
+        else if (i_char && (i_char < 0xd800 || i_char > 0xdfff))
+            TextPut(p_out, i_char);
+    }
+}
+
+static void TextUtf8(text_out_t *p_out, const uint8_t *p_text, size_t i_length)
+{
+    size_t i = 0;
+    while (i < i_length)
+    {
+        const uint8_t i_byte = p_text[i];
+        uint32_t i_char, i_min;
+        size_t i_bytes;
+
+        if (i_byte < 0x80)
+        {
+            if (i_byte)
+                TextPut(p_out, i_byte);
+            i++;
+            continue;
+        }
+        if (i_byte >= 0xc2 && i_byte <= 0xdf)
+        {
+            i_char = i_byte & 0x1f;
+            i_bytes = 2;
+            i_min = 0x80;
+        }
+        else if (i_byte >= 0xe0 && i_byte <= 0xef)
+        {
+            i_char = i_byte & 0x0f;
+            i_bytes = 3;
+            i_min = 0x800;
+        }
+        else if (i_byte >= 0xf0 && i_byte <= 0xf4)
+        {
+            i_char = i_byte & 0x07;
+            i_bytes = 4;
+            i_min = 0x10000;
+        }
+        else
+        {
+            TextPut(p_out, TEXT_REPLACEMENT);
+            i++;
+            continue;
+        }
+
+        /* a truncated sequence is replaced, the bytes after it are kept */
+        for (size_t j = 1; j < i_bytes; j++)
+        {
+            if (i + j >= i_length || (p_text[i + j] & 0xc0) != 0x80)
+            {
+                i_bytes = j;
+                i_char = UINT32_MAX;
+                break;
+            }
+            i_char = i_char << 6 | (p_text[i + j] & 0x3f);
+        }
+        i += i_bytes;
+
+        if (i_char < i_min || i_char > 0x10ffff || (i_char >= 0xd800 && i_char <= 0xdfff))
+            TextPut(p_out, TEXT_REPLACEMENT);
+        else if (i_char <= 0x9f)
+            TextControl(p_out, i_char);
+        else if (i_char >= 0xe080 && i_char <= 0xe09f)
+            TextControl(p_out, i_char & 0xff);
+        else
+            TextPut(p_out, i_char);
+    }
+}
+
+/* The unsupported double byte tables: only ASCII is kept */
+static void TextDoubleByte(text_out_t *p_out, const uint8_t *p_text, size_t i_length)
+{
+    for (size_t i = 0; i < i_length; i++)
+    {
+        if (p_text[i] >= 0x80)
+        {
+            TextPut(p_out, TEXT_REPLACEMENT);
+            i++;
+        }
+        else if (p_text[i])
+            TextPut(p_out, p_text[i]);
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_text_to_utf8
+ *****************************************************************************/
+size_t dvbpsi_text_to_utf8(const uint8_t *p_text, size_t i_length,
+                           char *psz_utf8, size_t i_size)
+{
+    text_out_t out = { psz_utf8, i_size, 0, 0 };
+
+    if (i_length == 0)
+        ;
+    else if (p_text[0] >= 0x20)
+        TextIso6937(&out, p_text, i_length);
+    else if (p_text[0] >= 0x01 && p_text[0] <= 0x0b && iso8859[p_text[0] + 4])
+        TextSingleByte(&out, p_text + 1, i_length - 1, iso8859[p_text[0] + 4]);
+    else if (p_text[0] == 0x10)
+    {
+        /* 0x10 0x00 n: ISO/IEC 8859-n */
+        if (i_length >= 3 && p_text[1] == 0x00 && p_text[2] < 16 && iso8859[p_text[2]])
+            TextSingleByte(&out, p_text + 3, i_length - 3, iso8859[p_text[2]]);
+        else if (i_length >= 3)
+            TextDoubleByte(&out, p_text + 3, i_length - 3);
+    }
+    else if (p_text[0] == 0x11)
+        TextUcs2(&out, p_text + 1, i_length - 1);
+    else if (p_text[0] == 0x15)
+        TextUtf8(&out, p_text + 1, i_length - 1);
+    else if (p_text[0] >= 0x12 && p_text[0] <= 0x14)
+        TextDoubleByte(&out, p_text + 1, i_length - 1);
+    else if (p_text[0] == 0x1f)
+        ; /* encoding_type_id: compressed */
+    else
+        TextIso6937(&out, p_text + 1, i_length - 1);    /* reserved */
+
+    if (i_size > 0)
+        psz_utf8[out.i_written] = '\0';
+    return out.i_length;
+}
+
+/*****************************************************************************
+ * Cache
+ *****************************************************************************
+ * The entries are in a hash table and in a list from the most to the least
+ * recently used, the last ones are evicted when the cache is over its size.
+ * The strings are copied out under the lock, an evicted entry is never seen
+ * by the callers.
+ *****************************************************************************/
+#define TEXT_CACHE_BUCKETS  1024
+
+typedef struct text_entry_s
+{
+    struct text_entry_s    *p_next;         /* in the bucket */
+    struct text_entry_s    *p_lru_prev;
+    struct text_entry_s    *p_lru_next;
+    uint32_t                i_hash;
+    size_t                  i_length;       /* of p_text */
+    size_t                  i_utf8;         /* of psz_utf8 */
+    const char             *psz_utf8;       /* after p_text */
+    uint8_t                 p_text[];
+} text_entry_t;
+
+struct dvbpsi_text_cache_s
+{
+    dvbpsi_lock_t           lock;
+
+    text_entry_t          **pp_buckets;
+    size_t                  i_buckets;      /* power of 2 */
+    size_t                  i_count;
+    size_t                  i_bytes;
+    size_t                  i_max_bytes;    /* 0 for no limit */
+
+    text_entry_t           *p_lru_first;    /* most recently used */
+    text_entry_t           *p_lru_last;
+};
+
+/* FNV-1a */
+static uint32_t CacheHash(const uint8_t *p_text, size_t i_length)
+{
+    uint32_t i_hash = UINT32_C(0x811c9dc5);
+    for (size_t i = 0; i < i_length; i++)
+        i_hash = (i_hash ^ p_text[i]) * UINT32_C(0x01000193);
+    return i_hash;
+}
+
+static size_t CacheEntrySize(const text_entry_t *p_entry)
+{
+    return sizeof(text_entry_t) + p_entry->i_length + p_entry->i_utf8 + 1;
+}
+
+static text_entry_t *CacheFind(const dvbpsi_text_cache_t *p_cache, uint32_t i_hash,
+                               const uint8_t *p_text, size_t i_length)
+{
+    text_entry_t *p_entry = p_cache->pp_buckets[i_hash & (p_cache->i_buckets - 1)];
+    while (p_entry && (p_entry->i_hash != i_hash || p_entry->i_length != i_length
+                    || memcmp(p_entry->p_text, p_text, i_length)))
+        p_entry = p_entry->p_next;
+    return p_entry;
+}
+
+/* Called with the lock */
+static void CacheLruUnlink(dvbpsi_text_cache_t *p_cache, text_entry_t *p_entry)
+{
+    if (p_entry->p_lru_prev)
+        p_entry->p_lru_prev->p_lru_next = p_entry->p_lru_next;
+    else
+        p_cache->p_lru_first = p_entry->p_lru_next;
+    if (p_entry->p_lru_next)
+        p_entry->p_lru_next->p_lru_prev = p_entry->p_lru_prev;
+    else
+        p_cache->p_lru_last = p_entry->p_lru_prev;
+}
+
+/* Called with the lock */
+static void CacheLruPush(dvbpsi_text_cache_t *p_cache, text_entry_t *p_entry)
+{
+    p_entry->p_lru_prev = NULL;
+    p_entry->p_lru_next = p_cache->p_lru_first;
+    if (p_cache->p_lru_first)
+        p_cache->p_lru_first->p_lru_prev = p_entry;
+    else
+        p_cache->p_lru_last = p_entry;
+    p_cache->p_lru_first = p_entry;
+}
+
+/* Called with the lock, p_entry is removed from the cache but not freed */
+static void CacheRemove(dvbpsi_text_cache_t *p_cache, text_entry_t *p_entry)
+{
+    text_entry_t **pp_entry = &p_cache->pp_buckets[p_entry->i_hash & (p_cache->i_buckets - 1)];
+
+    while (*pp_entry != p_entry)
+        pp_entry = &(*pp_entry)->p_next;
+    *pp_entry = p_entry->p_next;
+    CacheLruUnlink(p_cache, p_entry);
+    p_cache->i_count--;
+    p_cache->i_bytes -= CacheEntrySize(p_entry);
+}
+
+/* Called with the lock */
+static void CacheGrow(dvbpsi_text_cache_t *p_cache)
+{
+    size_t i_buckets = p_cache->i_buckets * 2;
+    text_entry_t **pp_buckets = calloc(i_buckets, sizeof(text_entry_t *));
+    if (!pp_buckets)
+        return;
+
+    for (size_t i = 0; i < p_cache->i_buckets; i++)
+    {
+        text_entry_t *p_entry = p_cache->pp_buckets[i];
+        while (p_entry)
+        {
+            text_entry_t *p_next = p_entry->p_next;
+            size_t i_new = p_entry->i_hash & (i_buckets - 1);
+            p_entry->p_next = pp_buckets[i_new];
+            pp_buckets[i_new] = p_entry;
+            p_entry = p_next;
+        }
+    }
+    free(p_cache->pp_buckets);
+    p_cache->pp_buckets = pp_buckets;
+    p_cache->i_buckets = i_buckets;
+}
+
+/* Copy a converted string like dvbpsi_text_to_utf8() would have written it */
+static size_t CacheCopy(const text_entry_t *p_entry, char *psz_utf8, size_t i_size)
+{
+    size_t i_copy = p_entry->i_utf8;
+
+    if (i_size == 0)
+        return p_entry->i_utf8;
+    if (i_copy >= i_size)
+    {
+        /* truncate between two characters */
+        i_copy = i_size - 1;
+        while (i_copy > 0 && ((uint8_t)p_entry->psz_utf8[i_copy] & 0xc0) == 0x80)
+            i_copy--;
+    }
+    memcpy(psz_utf8, p_entry->psz_utf8, i_copy);
+    psz_utf8[i_copy] = '\0';
+    return p_entry->i_utf8;
+}
+
+/*****************************************************************************
+ * dvbpsi_text_cache_new
+ *****************************************************************************/
+dvbpsi_text_cache_t *dvbpsi_text_cache_new(size_t i_max_bytes)
+{
+    dvbpsi_text_cache_t *p_cache = calloc(1, sizeof(dvbpsi_text_cache_t));
+    if (!p_cache)
+        return NULL;
+    p_cache->pp_buckets = calloc(TEXT_CACHE_BUCKETS, sizeof(text_entry_t *));
+    if (!p_cache->pp_buckets || !dvbpsi_lock_init(&p_cache->lock))
+    {
+        free(p_cache->pp_buckets);
+        free(p_cache);
+        return NULL;
+    }
+    p_cache->i_buckets = TEXT_CACHE_BUCKETS;
+    p_cache->i_max_bytes = i_max_bytes;
+    return p_cache;
+}
+
+/*****************************************************************************
+ * dvbpsi_text_cache_delete
+ *****************************************************************************/
+void dvbpsi_text_cache_delete(dvbpsi_text_cache_t *p_cache)
+{
+    if (!p_cache)
+        return;
+    dvbpsi_text_cache_clear(p_cache);
+    free(p_cache->pp_buckets);
+    dvbpsi_lock_destroy(&p_cache->lock);
+    free(p_cache);
+}
+
+/*****************************************************************************
+ * dvbpsi_text_cache_get
+ *****************************************************************************/
+size_t dvbpsi_text_cache_get(dvbpsi_text_cache_t *p_cache,
+                             const uint8_t *p_text, size_t i_length,
+                             char *psz_utf8, size_t i_size)
+{
+    const uint32_t i_hash = CacheHash(p_text, i_length);
+    text_entry_t *p_entry, *p_evicted = NULL;
+    size_t i_utf8, i_bucket;
+    char *psz_entry;
+
+    dvbpsi_lock(&p_cache->lock);
+    p_entry = CacheFind(p_cache, i_hash, p_text, i_length);
+    if (p_entry)
+    {
+        CacheLruUnlink(p_cache, p_entry);
+        CacheLruPush(p_cache, p_entry);
+        i_utf8 = CacheCopy(p_entry, psz_utf8, i_size);
+        dvbpsi_unlock(&p_cache->lock);
+        return i_utf8;
+    }
+    dvbpsi_unlock(&p_cache->lock);
+
+    /* convert without the lock */
+    i_utf8 = dvbpsi_text_to_utf8(p_text, i_length, psz_utf8, i_size);
+    p_entry = malloc(sizeof(text_entry_t) + i_length + i_utf8 + 1);
+    if (!p_entry)
+        return i_utf8;
+    p_entry->i_hash = i_hash;
+    p_entry->i_length = i_length;
+    p_entry->i_utf8 = i_utf8;
+    memcpy(p_entry->p_text, p_text, i_length);
+    psz_entry = (char *)p_entry->p_text + i_length;
+    if (i_utf8 < i_size)
+        memcpy(psz_entry, psz_utf8, i_utf8 + 1);
+    else
+        dvbpsi_text_to_utf8(p_text, i_length, psz_entry, i_utf8 + 1);
+    p_entry->psz_utf8 = psz_entry;
+
+    dvbpsi_lock(&p_cache->lock);
+    if (CacheFind(p_cache, i_hash, p_text, i_length))
+    {
+        /* another thread added it meanwhile */
+        dvbpsi_unlock(&p_cache->lock);
+        free(p_entry);
+        return i_utf8;
+    }
+    if (p_cache->i_count >= p_cache->i_buckets)
+        CacheGrow(p_cache);
+    i_bucket = i_hash & (p_cache->i_buckets - 1);
+    p_entry->p_next = p_cache->pp_buckets[i_bucket];
+    p_cache->pp_buckets[i_bucket] = p_entry;
+    CacheLruPush(p_cache, p_entry);
+    p_cache->i_count++;
+    p_cache->i_bytes += CacheEntrySize(p_entry);
+
+    /* evict the least recently used strings, the new one included if it is
+     * larger than the whole cache */
+    while (p_cache->i_max_bytes && p_cache->i_bytes > p_cache->i_max_bytes)
+    {
+        text_entry_t *p_last = p_cache->p_lru_last;
+        CacheRemove(p_cache, p_last);
+        p_last->p_next = p_evicted;
+        p_evicted = p_last;
+    }
+    dvbpsi_unlock(&p_cache->lock);
+
+    while (p_evicted)
+    {
+        text_entry_t *p_next = p_evicted->p_next;
+        free(p_evicted);
+        p_evicted = p_next;
+    }
+    return i_utf8;
+}
+
+/*****************************************************************************
+ * dvbpsi_text_cache_clear
+ *****************************************************************************/
+void dvbpsi_text_cache_clear(dvbpsi_text_cache_t *p_cache)
+{
+    dvbpsi_lock(&p_cache->lock);
+    for (size_t i = 0; i < p_cache->i_buckets; i++)
+    {
+        text_entry_t *p_entry = p_cache->pp_buckets[i];
+        while (p_entry)
+        {
+            text_entry_t *p_next = p_entry->p_next;
+            free(p_entry);
+            p_entry = p_next;
+        }
+        p_cache->pp_buckets[i] = NULL;
+    }
+    p_cache->p_lru_first = NULL;
+    p_cache->p_lru_last = NULL;
+    p_cache->i_count = 0;
+    p_cache->i_bytes = 0;
+    dvbpsi_unlock(&p_cache->lock);
+}
+
+/*****************************************************************************
+ * dvbpsi_text_cache_count
+ *****************************************************************************/
+size_t dvbpsi_text_cache_count(dvbpsi_text_cache_t *p_cache, size_t *pi_bytes)
+{
+    size_t i_count;
+
+    dvbpsi_lock(&p_cache->lock);
+    i_count = p_cache->i_count;
+    if (pi_bytes)
+        *pi_bytes = p_cache->i_bytes;
+    dvbpsi_unlock(&p_cache->lock);
+    return i_count;
+}
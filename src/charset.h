@@ -0,0 +1,157 @@
+/*****************************************************************************
+ * charset.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <charset.h>
+ * \brief Conversion of the DVB text strings to UTF-8.
+ *
+ * The names and texts of the descriptors (service, short and extended
+ * event, network name, bouquet name...) are coded as described in ETSI EN
+ * 300 468 Annex A: the first bytes select the character table, ISO/IEC 6937
+ * by default, ISO/IEC 8859-x, ISO/IEC 10646 (UCS-2) or UTF-8.
+ *
+ * The control codes are converted too: the character emphasis on/off codes
+ * are removed and the CR/LF code becomes '\\n'. The Korean, simplified
+ * Chinese and Big5 tables are not supported, their characters are replaced
+ * by U+FFFD, and compressed strings (0x1F) convert to the empty string.
+ */
+
+#ifndef _DVBPSI_CHARSET_H_
+#define _DVBPSI_CHARSET_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * dvbpsi_text_to_utf8
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_text_to_utf8(const uint8_t *p_text, size_t i_length,
+                                  char *psz_utf8, size_t i_size)
+ * \brief Convert a DVB text string to UTF-8. Like snprintf(), the output is
+ * truncated to i_size bytes, the terminating zero included, between two
+ * characters.
+ * \param p_text the string, from its character table selection bytes
+ * \param i_length size of the string, in bytes
+ * \param psz_utf8 filled with the zero terminated UTF-8 string, may be NULL
+ * if i_size is 0
+ * \param i_size size of psz_utf8
+ * \return the length of the whole UTF-8 string, without the terminating
+ * zero, at most 3 * i_length
+ */
+size_t dvbpsi_text_to_utf8(const uint8_t *p_text, size_t i_length,
+                           char *psz_utf8, size_t i_size);
+
+/*****************************************************************************
+ * dvbpsi_text_cache_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_text_cache_s dvbpsi_text_cache_t
+ * \brief Opaque cache of converted strings.
+ *
+ * The same names repeat in every cycle of the carousel. The cache keeps the
+ * conversion of each distinct string, keyed by its DVB bytes, and copies it
+ * to the caller each time. When the strings take more than the size of the
+ * cache, the least recently used ones are evicted. The cache may be shared
+ * between threads.
+ */
+typedef struct dvbpsi_text_cache_s dvbpsi_text_cache_t;
+
+/*****************************************************************************
+ * dvbpsi_text_cache_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_text_cache_t *dvbpsi_text_cache_new(size_t i_max_bytes)
+ * \brief Create an empty string cache.
+ * \param i_max_bytes memory the strings may use, see
+ * dvbpsi_text_cache_count(), 0 for no limit
+ * \return the cache, NULL on error
+ */
+dvbpsi_text_cache_t *dvbpsi_text_cache_new(size_t i_max_bytes);
+
+/*****************************************************************************
+ * dvbpsi_text_cache_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_text_cache_delete(dvbpsi_text_cache_t *p_cache)
+ * \brief Delete a string cache and all its strings.
+ * \param p_cache the cache, may be NULL
+ * \return nothing
+ */
+void dvbpsi_text_cache_delete(dvbpsi_text_cache_t *p_cache);
+
+/*****************************************************************************
+ * dvbpsi_text_cache_get
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_text_cache_get(dvbpsi_text_cache_t *p_cache,
+                                    const uint8_t *p_text, size_t i_length,
+                                    char *psz_utf8, size_t i_size)
+ * \brief Get the UTF-8 conversion of a DVB text string, converting it the
+ * first time only. The string is copied as dvbpsi_text_to_utf8() writes
+ * it, the cache keeps no reference to psz_utf8. When the string cannot be
+ * cached, it is converted anyway.
+ * \param p_cache the cache
+ * \param p_text the string, from its character table selection bytes
+ * \param i_length size of the string, in bytes
+ * \param psz_utf8 filled with the zero terminated UTF-8 string, may be NULL
+ * if i_size is 0
+ * \param i_size size of psz_utf8
+ * \return the length of the whole UTF-8 string, without the terminating
+ * zero
+ */
+size_t dvbpsi_text_cache_get(dvbpsi_text_cache_t *p_cache,
+                             const uint8_t *p_text, size_t i_length,
+                             char *psz_utf8, size_t i_size);
+
+/*****************************************************************************
+ * dvbpsi_text_cache_clear
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_text_cache_clear(dvbpsi_text_cache_t *p_cache)
+ * \brief Delete all the strings of a cache.
+ * \param p_cache the cache
+ * \return nothing
+ */
+void dvbpsi_text_cache_clear(dvbpsi_text_cache_t *p_cache);
+
+/*****************************************************************************
+ * dvbpsi_text_cache_count
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_text_cache_count(dvbpsi_text_cache_t *p_cache,
+                                      size_t *pi_bytes)
+ * \brief Get the number of strings of a cache.
+ * \param p_cache the cache
+ * \param pi_bytes filled with the memory used by the strings, may be NULL
+ * \return the number of strings
+ */
+size_t dvbpsi_text_cache_count(dvbpsi_text_cache_t *p_cache, size_t *pi_bytes);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of charset.h"
+#endif
@@ -0,0 +1,318 @@
+/*****************************************************************************
+ * clock.c: correlation of the PCR with the UTC time of the time tables
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "psi.h"
+#include "descriptor.h"
+#include "dvbtime.h"
+#include "clock.h"
+#include "lock_private.h"
+#include "tables/tot.h"
+#include "tables/atsc_stt.h"
+
+/* 27 MHz ticks */
+#define CLOCK_TICKS_PER_US  27
+#define CLOCK_WRAP          (INT64_C(300) << 33)
+/* a larger gap between two PCR is a discontinuity */
+#define CLOCK_MAX_GAP       (INT64_C(27000000) * 10)
+/* a UTC time this far from the mapping resets it */
+#define CLOCK_MAX_ERROR     INT64_C(2000000)
+/* weight of a new UTC time in the offset of the mapping */
+#define CLOCK_SMOOTHING     8
+/* the UTC times having a resolution of one second, the rate is only fitted
+ * over five minutes of PCR at least, and over one hour at most */
+#define CLOCK_RATE_SPAN     (INT64_C(27000000) * 300)
+#define CLOCK_RATE_WINDOW   (INT64_C(27000000) * 3600)
+/* bounds of the rate, the PCR being within 30 ppm of 27 MHz */
+#define CLOCK_MAX_DRIFT     0.0001
+
+struct dvbpsi_clock_s
+{
+    dvbpsi_lock_t       lock;
+    uint16_t            i_pcr_pid;
+
+    bool                b_pcr;          /* a PCR was received */
+    int64_t             i_last_pcr;     /* wrapped */
+    int64_t             i_last_ticks;   /* extended, continuous across the
+                                         * discontinuities */
+
+    /* UTC = i_base_utc + (ticks - i_base_ticks) / f_rate */
+    bool                b_synced;
+    int64_t             i_base_ticks;
+    int64_t             i_base_utc;
+    double              f_rate;         /* ticks per microsecond */
+
+    /* least squares fit of the UTC times against the ticks, relative to the
+     * first UTC time of the fit */
+    unsigned int        i_samples;
+    int64_t             i_ref_ticks;
+    int64_t             i_ref_utc;
+    double              f_sx, f_sy, f_sxx, f_sxy;
+};
+
+/* Signed distance from the last PCR, the nearest across the wrap */
+static int64_t ClockDelta(const dvbpsi_clock_t *p_clock, uint64_t i_pcr)
+{
+    int64_t i_delta = ((int64_t)(i_pcr % CLOCK_WRAP) - p_clock->i_last_pcr) % CLOCK_WRAP;
+    if (i_delta >= CLOCK_WRAP / 2)
+        i_delta -= CLOCK_WRAP;
+    else if (i_delta < -CLOCK_WRAP / 2)
+        i_delta += CLOCK_WRAP;
+    return i_delta;
+}
+
+static int64_t ClockToUtc(const dvbpsi_clock_t *p_clock, int64_t i_ticks)
+{
+    return p_clock->i_base_utc + (int64_t)((i_ticks - p_clock->i_base_ticks) / p_clock->f_rate);
+}
+
+/* Add a UTC time to the fit of the rate, and take the rate once the fit is
+ * long enough */
+static void ClockFit(dvbpsi_clock_t *p_clock, int64_t i_utc)
+{
+    double f_x, f_y, f_sxx, f_rate;
+
+    if (p_clock->i_samples == 0
+     || p_clock->i_last_ticks - p_clock->i_ref_ticks > CLOCK_RATE_WINDOW)
+    {
+        p_clock->i_samples = 0;
+        p_clock->i_ref_ticks = p_clock->i_last_ticks;
+        p_clock->i_ref_utc = i_utc;
+        p_clock->f_sx = p_clock->f_sy = p_clock->f_sxx = p_clock->f_sxy = 0.;
+    }
+
+    f_x = (double)(p_clock->i_last_ticks - p_clock->i_ref_ticks);
+    f_y = (double)(i_utc - p_clock->i_ref_utc);
+    p_clock->i_samples++;
+    p_clock->f_sx += f_x;
+    p_clock->f_sy += f_y;
+    p_clock->f_sxx += f_x * f_x;
+    p_clock->f_sxy += f_x * f_y;
+
+    if (p_clock->i_last_ticks - p_clock->i_ref_ticks < CLOCK_RATE_SPAN)
+        return;
+    f_sxx = p_clock->f_sxx - p_clock->f_sx * p_clock->f_sx / p_clock->i_samples;
+    if (f_sxx <= 0.)
+        return;
+    /* microseconds per tick */
+    f_rate = (p_clock->f_sxy - p_clock->f_sx * p_clock->f_sy / p_clock->i_samples) / f_sxx;
+    if (f_rate <= 0.)
+        return;
+    f_rate = 1. / f_rate;
+    if (f_rate < CLOCK_TICKS_PER_US * (1. - CLOCK_MAX_DRIFT))
+        f_rate = CLOCK_TICKS_PER_US * (1. - CLOCK_MAX_DRIFT);
+    else if (f_rate > CLOCK_TICKS_PER_US * (1. + CLOCK_MAX_DRIFT))
+        f_rate = CLOCK_TICKS_PER_US * (1. + CLOCK_MAX_DRIFT);
+    p_clock->f_rate = f_rate;
+}
+
+/*****************************************************************************
+ * dvbpsi_clock_new
+ *****************************************************************************/
+dvbpsi_clock_t *dvbpsi_clock_new(uint16_t i_pcr_pid)
+{
+    dvbpsi_clock_t *p_clock = calloc(1, sizeof(dvbpsi_clock_t));
+    if (!p_clock)
+        return NULL;
+    if (!dvbpsi_lock_init(&p_clock->lock))
+    {
+        free(p_clock);
+        return NULL;
+    }
+    p_clock->i_pcr_pid = i_pcr_pid;
+    p_clock->f_rate = CLOCK_TICKS_PER_US;
+    return p_clock;
+}
+
+/*****************************************************************************
+ * dvbpsi_clock_delete
+ *****************************************************************************/
+void dvbpsi_clock_delete(dvbpsi_clock_t *p_clock)
+{
+    if (!p_clock)
+        return;
+    dvbpsi_lock_destroy(&p_clock->lock);
+    free(p_clock);
+}
+
+/*****************************************************************************
+ * dvbpsi_clock_packet_push
+ *****************************************************************************/
+bool dvbpsi_clock_packet_push(dvbpsi_clock_t *p_clock, const uint8_t *p_packet)
+{
+    uint64_t i_base;
+    uint16_t i_extension;
+
+    /* adaptation field with at least the flags and the PCR */
+    if (p_packet[0] != 0x47
+     || (((uint16_t)(p_packet[1] & 0x1f) << 8) | p_packet[2]) != p_clock->i_pcr_pid
+     || !(p_packet[3] & 0x20) || p_packet[4] < 7 || !(p_packet[5] & 0x10))
+        return false;
+
+    i_base = (uint64_t)p_packet[6] << 25 | (uint64_t)p_packet[7] << 17
+           | (uint64_t)p_packet[8] << 9 | (uint64_t)p_packet[9] << 1 | p_packet[10] >> 7;
+    i_extension = (uint16_t)(p_packet[10] & 0x01) << 8 | p_packet[11];
+    dvbpsi_clock_pcr(p_clock, i_base * 300 + i_extension, (p_packet[5] & 0x80) != 0);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_clock_pcr
+ *****************************************************************************/
+void dvbpsi_clock_pcr(dvbpsi_clock_t *p_clock, uint64_t i_pcr, bool b_discontinuity)
+{
+    dvbpsi_lock(&p_clock->lock);
+    if (!p_clock->b_pcr)
+    {
+        p_clock->b_pcr = true;
+        p_clock->i_last_ticks = (int64_t)(i_pcr % CLOCK_WRAP);
+    }
+    else
+    {
+        /* across a discontinuity the stream time is taken as continuous,
+         * the mapping keeps going and the UTC times correct its offset, but
+         * the fit of the rate restarts */
+        int64_t i_delta = ClockDelta(p_clock, i_pcr);
+        if (b_discontinuity || i_delta < 0 || i_delta > CLOCK_MAX_GAP)
+            p_clock->i_samples = 0;
+        else
+            p_clock->i_last_ticks += i_delta;
+    }
+    p_clock->i_last_pcr = (int64_t)(i_pcr % CLOCK_WRAP);
+    dvbpsi_unlock(&p_clock->lock);
+}
+
+/*****************************************************************************
+ * dvbpsi_clock_utc
+ *****************************************************************************/
+bool dvbpsi_clock_utc(dvbpsi_clock_t *p_clock, int64_t i_utc)
+{
+    bool b_pcr;
+
+    dvbpsi_lock(&p_clock->lock);
+    b_pcr = p_clock->b_pcr;
+    if (b_pcr)
+    {
+        int64_t i_error = 0;
+        if (p_clock->b_synced)
+            i_error = i_utc - ClockToUtc(p_clock, p_clock->i_last_ticks);
+
+        if (!p_clock->b_synced || i_error > CLOCK_MAX_ERROR || i_error < -CLOCK_MAX_ERROR)
+        {
+            p_clock->i_base_utc = i_utc;
+            p_clock->i_samples = 0;
+        }
+        else
+            p_clock->i_base_utc = i_utc - i_error + i_error / CLOCK_SMOOTHING;
+        p_clock->i_base_ticks = p_clock->i_last_ticks;
+        p_clock->b_synced = true;
+        ClockFit(p_clock, i_utc);
+    }
+    dvbpsi_unlock(&p_clock->lock);
+    return b_pcr;
+}
+
+/*****************************************************************************
+ * dvbpsi_clock_tot
+ *****************************************************************************/
+bool dvbpsi_clock_tot(dvbpsi_clock_t *p_clock, const struct dvbpsi_tot_s *p_tot)
+{
+    int64_t i_time = dvbpsi_mjd_to_unix(p_tot->i_utc_time);
+    if (i_time == DVBPSI_TIME_UNDEFINED)
+        return false;
+    /* the time is truncated to the second */
+    return dvbpsi_clock_utc(p_clock, i_time * 1000000 + 500000);
+}
+
+/*****************************************************************************
+ * dvbpsi_clock_stt
+ *****************************************************************************/
+bool dvbpsi_clock_stt(dvbpsi_clock_t *p_clock, const struct dvbpsi_atsc_stt_s *p_stt)
+{
+    int64_t i_time = dvbpsi_gps_to_unix(p_stt->i_system_time, p_stt->i_gps_utc_offset);
+    return dvbpsi_clock_utc(p_clock, i_time * 1000000 + 500000);
+}
+
+/*****************************************************************************
+ * dvbpsi_clock_pcr_to_utc
+ *****************************************************************************/
+int64_t dvbpsi_clock_pcr_to_utc(dvbpsi_clock_t *p_clock, uint64_t i_pcr)
+{
+    int64_t i_utc = DVBPSI_CLOCK_UNDEFINED;
+
+    dvbpsi_lock(&p_clock->lock);
+    if (p_clock->b_synced)
+        i_utc = ClockToUtc(p_clock, p_clock->i_last_ticks + ClockDelta(p_clock, i_pcr));
+    dvbpsi_unlock(&p_clock->lock);
+    return i_utc;
+}
+
+/*****************************************************************************
+ * dvbpsi_clock_utc_to_pcr
+ *****************************************************************************/
+int64_t dvbpsi_clock_utc_to_pcr(dvbpsi_clock_t *p_clock, int64_t i_utc)
+{
+    int64_t i_pcr = DVBPSI_CLOCK_UNDEFINED;
+
+    dvbpsi_lock(&p_clock->lock);
+    if (p_clock->b_synced)
+    {
+        int64_t i_ticks = p_clock->i_base_ticks
+                        + (int64_t)((i_utc - p_clock->i_base_utc) * p_clock->f_rate);
+        i_pcr = (p_clock->i_last_pcr + i_ticks - p_clock->i_last_ticks) % CLOCK_WRAP;
+        if (i_pcr < 0)
+            i_pcr += CLOCK_WRAP;
+    }
+    dvbpsi_unlock(&p_clock->lock);
+    return i_pcr;
+}
+
+/*****************************************************************************
+ * dvbpsi_clock_now
+ *****************************************************************************/
+int64_t dvbpsi_clock_now(dvbpsi_clock_t *p_clock)
+{
+    int64_t i_utc = DVBPSI_CLOCK_UNDEFINED;
+
+    dvbpsi_lock(&p_clock->lock);
+    if (p_clock->b_synced)
+        i_utc = ClockToUtc(p_clock, p_clock->i_last_ticks);
+    dvbpsi_unlock(&p_clock->lock);
+    return i_utc;
+}
@@ -0,0 +1,202 @@
+/*****************************************************************************
+ * clock.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <clock.h>
+ * \brief Correlation of the PCR of a stream with the UTC time of its
+ * TDT, TOT or STT.
+ *
+ * The stream clock takes the PCR of one PID and the UTC times of the time
+ * tables. Each UTC time is matched with the last PCR received before it and
+ * corrects the offset of the PCR to UTC mapping by a fraction of the
+ * difference, smoothing the one second resolution of the tables. The rate of
+ * the PCR is fitted by least squares over the UTC times of the last hour, and
+ * taken once they span five minutes, so that the mapping also follows the
+ * drift of the PCR between two UTC times. The 33 bits wrap of the PCR is
+ * handled by extending the PCR relative to the last one received. Across a
+ * PCR discontinuity the stream time is taken as continuous: the mapping is
+ * kept, and only the fit of the rate restarts.
+ *
+ * The conversions are a few additions and one multiplication or division.
+ * The clock may be shared between threads.
+ */
+
+#ifndef _DVBPSI_CLOCK_H_
+#define _DVBPSI_CLOCK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dvbpsi_tot_s;
+struct dvbpsi_atsc_stt_s;
+
+/*!
+ * \def DVBPSI_CLOCK_UNDEFINED
+ * \brief Time returned when the clock is not synchronized.
+ */
+#define DVBPSI_CLOCK_UNDEFINED  INT64_MIN
+
+/*****************************************************************************
+ * dvbpsi_clock_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_clock_s dvbpsi_clock_t
+ * \brief Opaque stream clock handle.
+ */
+typedef struct dvbpsi_clock_s dvbpsi_clock_t;
+
+/*****************************************************************************
+ * dvbpsi_clock_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_clock_t *dvbpsi_clock_new(uint16_t i_pcr_pid)
+ * \brief Create a stream clock.
+ * \param i_pcr_pid the PID carrying the PCR, see dvbpsi_clock_packet_push()
+ * \return the clock, NULL on error
+ */
+dvbpsi_clock_t *dvbpsi_clock_new(uint16_t i_pcr_pid);
+
+/*****************************************************************************
+ * dvbpsi_clock_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_clock_delete(dvbpsi_clock_t *p_clock)
+ * \brief Delete a stream clock.
+ * \param p_clock the clock, may be NULL
+ * \return nothing
+ */
+void dvbpsi_clock_delete(dvbpsi_clock_t *p_clock);
+
+/*****************************************************************************
+ * dvbpsi_clock_packet_push
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_clock_packet_push(dvbpsi_clock_t *p_clock,
+                                     const uint8_t *p_packet)
+ * \brief Take the PCR of a TS packet of the PCR PID, other packets are
+ * ignored.
+ * \param p_clock the clock
+ * \param p_packet the 188 bytes TS packet
+ * \return true if the packet had a PCR
+ */
+bool dvbpsi_clock_packet_push(dvbpsi_clock_t *p_clock, const uint8_t *p_packet);
+
+/*****************************************************************************
+ * dvbpsi_clock_pcr
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_clock_pcr(dvbpsi_clock_t *p_clock, uint64_t i_pcr,
+                             bool b_discontinuity)
+ * \brief Take a PCR.
+ * \param p_clock the clock
+ * \param i_pcr the PCR in 27 MHz units, base * 300 + extension
+ * \param b_discontinuity the discontinuity_indicator of the packet
+ * \return nothing
+ */
+void dvbpsi_clock_pcr(dvbpsi_clock_t *p_clock, uint64_t i_pcr, bool b_discontinuity);
+
+/*****************************************************************************
+ * dvbpsi_clock_utc
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_clock_utc(dvbpsi_clock_t *p_clock, int64_t i_utc)
+ * \brief Take a UTC time received in the stream, to be matched with the last
+ * PCR.
+ * \param p_clock the clock
+ * \param i_utc the time, in microseconds since the Unix epoch
+ * \return false if no PCR was received yet
+ */
+bool dvbpsi_clock_utc(dvbpsi_clock_t *p_clock, int64_t i_utc);
+
+/*****************************************************************************
+ * dvbpsi_clock_tot
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_clock_tot(dvbpsi_clock_t *p_clock,
+                             const struct dvbpsi_tot_s *p_tot)
+ * \brief Take the UTC time of a TDT or TOT, from its callback.
+ * \param p_clock the clock
+ * \param p_tot the TDT or TOT
+ * \return false if no PCR was received yet
+ */
+bool dvbpsi_clock_tot(dvbpsi_clock_t *p_clock, const struct dvbpsi_tot_s *p_tot);
+
+/*****************************************************************************
+ * dvbpsi_clock_stt
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_clock_stt(dvbpsi_clock_t *p_clock,
+                             const struct dvbpsi_atsc_stt_s *p_stt)
+ * \brief Take the time of an ATSC STT, from its callback.
+ * \param p_clock the clock
+ * \param p_stt the STT
+ * \return false if no PCR was received yet
+ */
+bool dvbpsi_clock_stt(dvbpsi_clock_t *p_clock, const struct dvbpsi_atsc_stt_s *p_stt);
+
+/*****************************************************************************
+ * dvbpsi_clock_pcr_to_utc
+ *****************************************************************************/
+/*!
+ * \fn int64_t dvbpsi_clock_pcr_to_utc(dvbpsi_clock_t *p_clock, uint64_t i_pcr)
+ * \brief Convert a PCR, or a PTS multiplied by 300, to UTC time. The PCR
+ * must be within 13 hours of the last one received.
+ * \param p_clock the clock
+ * \param i_pcr the PCR in 27 MHz units
+ * \return the time, in microseconds since the Unix epoch,
+ * DVBPSI_CLOCK_UNDEFINED if the clock is not synchronized
+ */
+int64_t dvbpsi_clock_pcr_to_utc(dvbpsi_clock_t *p_clock, uint64_t i_pcr);
+
+/*****************************************************************************
+ * dvbpsi_clock_utc_to_pcr
+ *****************************************************************************/
+/*!
+ * \fn int64_t dvbpsi_clock_utc_to_pcr(dvbpsi_clock_t *p_clock, int64_t i_utc)
+ * \brief Convert a UTC time to the PCR of the stream.
+ * \param p_clock the clock
+ * \param i_utc the time, in microseconds since the Unix epoch
+ * \return the PCR in 27 MHz units, wrapped to 33 bits of base,
+ * DVBPSI_CLOCK_UNDEFINED if the clock is not synchronized
+ */
+int64_t dvbpsi_clock_utc_to_pcr(dvbpsi_clock_t *p_clock, int64_t i_utc);
+
+/*****************************************************************************
+ * dvbpsi_clock_now
+ *****************************************************************************/
+/*!
+ * \fn int64_t dvbpsi_clock_now(dvbpsi_clock_t *p_clock)
+ * \brief Get the UTC time of the last PCR received.
+ * \param p_clock the clock
+ * \return the time, in microseconds since the Unix epoch,
+ * DVBPSI_CLOCK_UNDEFINED if the clock is not synchronized
+ */
+int64_t dvbpsi_clock_now(dvbpsi_clock_t *p_clock);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of clock.h"
+#endif
@@ -0,0 +1,481 @@
+/*****************************************************************************
+ * delivery.c: asynchronous delivery of decoded tables
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include "dvbpsi.h"
+#include "dvbpsi_private.h"
+#include "psi.h"
+#include "delivery.h"
+
+#ifdef HAVE_PTHREAD
+
+/* deliveries taken out of the queue at once */
+#define DELIVERY_BATCH 16
+
+typedef struct delivery_item_s
+{
+    uint64_t            i_key;
+    dvbpsi_delivery_cb  pf_deliver;
+    dvbpsi_delivery_cb  pf_discard;
+    void               *p_cb_data;
+    void               *p_object;
+} delivery_item_t;
+
+/* Sections of an ingest handle, see dvbpsi_delivery_sections_attach() */
+typedef struct delivery_tap_s
+{
+    dvbpsi_delivery_t      *p_queue;
+    dvbpsi_t               *p_ingest;
+    dvbpsi_t               *p_decode;
+    uint16_t                i_pid;
+
+    /* held while a section is pushed into p_decode */
+    pthread_mutex_t         lock;
+    bool                    b_attached;
+
+    struct delivery_tap_s  *p_next;
+} delivery_tap_t;
+
+/* Copy of a valid section */
+typedef struct delivery_section_s
+{
+    size_t                  i_size;
+    uint8_t                 p_data[];
+} delivery_section_t;
+
+struct dvbpsi_delivery_s
+{
+    dvbpsi_delivery_policy_t i_policy;
+    bool                b_closed;
+
+    pthread_mutex_t     lock;
+    pthread_cond_t      not_empty;
+    pthread_cond_t      not_full;
+
+    delivery_item_t    *p_items;        /* ring of i_size items */
+    size_t              i_size;
+    size_t              i_first;
+    size_t              i_count;
+
+    dvbpsi_delivery_stats_t stats;
+
+    /* attached and detached taps, freed with the queue since a detached
+     * one may still be in a batch of dvbpsi_delivery_run() */
+    delivery_tap_t     *p_taps;
+};
+
+static void DeliveryDiscard(const delivery_item_t *p_item)
+{
+    if (p_item->pf_discard)
+        p_item->pf_discard(p_item->p_cb_data, p_item->p_object);
+}
+
+/*****************************************************************************
+ * dvbpsi_delivery_new
+ *****************************************************************************/
+dvbpsi_delivery_t *dvbpsi_delivery_new(size_t i_size, dvbpsi_delivery_policy_t i_policy)
+{
+    dvbpsi_delivery_t *p_queue;
+
+    if (i_size == 0)
+        return NULL;
+
+    p_queue = calloc(1, sizeof(dvbpsi_delivery_t));
+    if (!p_queue)
+        return NULL;
+    p_queue->p_items = malloc(i_size * sizeof(delivery_item_t));
+    if (!p_queue->p_items)
+    {
+        free(p_queue);
+        return NULL;
+    }
+    p_queue->i_size = i_size;
+    p_queue->i_policy = i_policy;
+    pthread_mutex_init(&p_queue->lock, NULL);
+    pthread_cond_init(&p_queue->not_empty, NULL);
+    pthread_cond_init(&p_queue->not_full, NULL);
+    return p_queue;
+}
+
+/*****************************************************************************
+ * dvbpsi_delivery_delete
+ *****************************************************************************/
+void dvbpsi_delivery_delete(dvbpsi_delivery_t *p_queue)
+{
+    if (!p_queue)
+        return;
+
+    for (delivery_tap_t *p_tap = p_queue->p_taps; p_tap; p_tap = p_tap->p_next)
+        if (p_tap->b_attached)
+            dvbpsi_delivery_sections_detach(p_queue, p_tap->p_ingest);
+
+    for (size_t i = 0; i < p_queue->i_count; i++)
+        DeliveryDiscard(&p_queue->p_items[(p_queue->i_first + i) % p_queue->i_size]);
+
+    while (p_queue->p_taps)
+    {
+        delivery_tap_t *p_next = p_queue->p_taps->p_next;
+        pthread_mutex_destroy(&p_queue->p_taps->lock);
+        free(p_queue->p_taps);
+        p_queue->p_taps = p_next;
+    }
+
+    pthread_cond_destroy(&p_queue->not_full);
+    pthread_cond_destroy(&p_queue->not_empty);
+    pthread_mutex_destroy(&p_queue->lock);
+    free(p_queue->p_items);
+    free(p_queue);
+}
+
+/*****************************************************************************
+ * dvbpsi_delivery_post
+ *****************************************************************************/
+bool dvbpsi_delivery_post(dvbpsi_delivery_t *p_queue, uint64_t i_key,
+                          dvbpsi_delivery_cb pf_deliver, dvbpsi_delivery_cb pf_discard,
+                          void *p_cb_data, void *p_object)
+{
+    delivery_item_t item = { i_key, pf_deliver, pf_discard, p_cb_data, p_object };
+    delivery_item_t discarded;
+    bool b_discard = false;
+
+    pthread_mutex_lock(&p_queue->lock);
+
+    if (p_queue->i_policy == DVBPSI_DELIVERY_COALESCE &&
+        i_key != DVBPSI_DELIVERY_NO_KEY && !p_queue->b_closed)
+    {
+        for (size_t i = 0; i < p_queue->i_count; i++)
+        {
+            delivery_item_t *p_item =
+                &p_queue->p_items[(p_queue->i_first + i) % p_queue->i_size];
+            if (p_item->i_key == i_key)
+            {
+                /* the newer object takes the place of the older one */
+                discarded = *p_item;
+                *p_item = item;
+                p_queue->stats.i_posted++;
+                p_queue->stats.i_coalesced++;
+                pthread_mutex_unlock(&p_queue->lock);
+
+                DeliveryDiscard(&discarded);
+                return true;
+            }
+        }
+    }
+
+    if (p_queue->i_count == p_queue->i_size && !p_queue->b_closed)
+    {
+        if (p_queue->i_policy == DVBPSI_DELIVERY_BLOCK)
+        {
+            p_queue->stats.i_blocked++;
+            while (p_queue->i_count == p_queue->i_size && !p_queue->b_closed)
+                pthread_cond_wait(&p_queue->not_full, &p_queue->lock);
+        }
+        else
+        {
+            discarded = p_queue->p_items[p_queue->i_first];
+            b_discard = true;
+            p_queue->i_first = (p_queue->i_first + 1) % p_queue->i_size;
+            p_queue->i_count--;
+            p_queue->stats.i_dropped++;
+        }
+    }
+
+    if (p_queue->b_closed)
+    {
+        pthread_mutex_unlock(&p_queue->lock);
+        DeliveryDiscard(&item);
+        return false;
+    }
+
+    p_queue->p_items[(p_queue->i_first + p_queue->i_count) % p_queue->i_size] = item;
+    p_queue->i_count++;
+    p_queue->stats.i_posted++;
+    if (p_queue->i_count > p_queue->stats.i_max_pending)
+        p_queue->stats.i_max_pending = p_queue->i_count;
+    pthread_cond_signal(&p_queue->not_empty);
+    pthread_mutex_unlock(&p_queue->lock);
+
+    if (b_discard)
+        DeliveryDiscard(&discarded);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_delivery_run
+ *****************************************************************************/
+size_t dvbpsi_delivery_run(dvbpsi_delivery_t *p_queue, size_t i_max, bool b_wait)
+{
+    delivery_item_t batch[DELIVERY_BATCH];
+    size_t i_delivered = 0;
+
+    while (i_delivered < i_max)
+    {
+        size_t i_batch, i;
+
+        pthread_mutex_lock(&p_queue->lock);
+        /* only wait for the first delivery */
+        while (b_wait && i_delivered == 0 &&
+               p_queue->i_count == 0 && !p_queue->b_closed)
+            pthread_cond_wait(&p_queue->not_empty, &p_queue->lock);
+
+        i_batch = p_queue->i_count;
+        if (i_batch > DELIVERY_BATCH)
+            i_batch = DELIVERY_BATCH;
+        if (i_batch > i_max - i_delivered)
+            i_batch = i_max - i_delivered;
+        for (i = 0; i < i_batch; i++)
+        {
+            batch[i] = p_queue->p_items[p_queue->i_first];
+            p_queue->i_first = (p_queue->i_first + 1) % p_queue->i_size;
+        }
+        p_queue->i_count -= i_batch;
+        p_queue->stats.i_delivered += i_batch;
+        if (i_batch)
+            pthread_cond_broadcast(&p_queue->not_full);
+        pthread_mutex_unlock(&p_queue->lock);
+
+        if (i_batch == 0)
+            break;
+
+        for (i = 0; i < i_batch; i++)
+            batch[i].pf_deliver(batch[i].p_cb_data, batch[i].p_object);
+        i_delivered += i_batch;
+    }
+
+    return i_delivered;
+}
+
+/*****************************************************************************
+ * dvbpsi_delivery_close
+ *****************************************************************************/
+void dvbpsi_delivery_close(dvbpsi_delivery_t *p_queue)
+{
+    pthread_mutex_lock(&p_queue->lock);
+    p_queue->b_closed = true;
+    pthread_cond_broadcast(&p_queue->not_empty);
+    pthread_cond_broadcast(&p_queue->not_full);
+    pthread_mutex_unlock(&p_queue->lock);
+}
+
+/*****************************************************************************
+ * dvbpsi_delivery_stats
+ *****************************************************************************/
+void dvbpsi_delivery_stats(dvbpsi_delivery_t *p_queue, dvbpsi_delivery_stats_t *p_stats)
+{
+    pthread_mutex_lock(&p_queue->lock);
+    *p_stats = p_queue->stats;
+    p_stats->i_pending = p_queue->i_count;
+    pthread_mutex_unlock(&p_queue->lock);
+}
+
+/*****************************************************************************
+ * dvbpsi_delivery_sections_attach
+ *****************************************************************************/
+static void DeliverySection(void *p_cb_data, void *p_object)
+{
+    delivery_tap_t *p_tap = p_cb_data;
+    delivery_section_t *p_section = p_object;
+
+    pthread_mutex_lock(&p_tap->lock);
+    if (p_tap->b_attached)
+        dvbpsi_section_push(p_tap->p_decode, p_section->p_data, p_section->i_size);
+    pthread_mutex_unlock(&p_tap->lock);
+    free(p_section);
+}
+
+static void DeliveryFree(void *p_cb_data, void *p_object)
+{
+    (void)p_cb_data;
+    free(p_object);
+}
+
+static void DeliveryTap(dvbpsi_t *p_dvbpsi, const dvbpsi_psi_section_t *p_section,
+                        void *p_cb_data)
+{
+    delivery_tap_t *p_tap = p_cb_data;
+    size_t i_size = 3 + p_section->i_length;
+    delivery_section_t *p_copy = malloc(sizeof(delivery_section_t) + i_size);
+
+    if (!p_copy)
+    {
+        dvbpsi_error(p_dvbpsi, "delivery", "out of memory");
+        return;
+    }
+    p_copy->i_size = i_size;
+    memcpy(p_copy->p_data, p_section->p_data, i_size);
+
+    /* a section key never equals the key of a table */
+    dvbpsi_delivery_post(p_tap->p_queue,
+                         DVBPSI_DELIVERY_KEY(p_tap->i_pid, p_section->i_table_id,
+                                             p_section->i_extension)
+                         | (uint64_t)p_section->i_number << 40 | UINT64_C(1) << 48,
+                         DeliverySection, DeliveryFree, p_tap, p_copy);
+}
+
+bool dvbpsi_delivery_sections_attach(dvbpsi_delivery_t *p_queue, dvbpsi_t *p_ingest,
+                                     dvbpsi_t *p_decode, uint16_t i_pid)
+{
+    delivery_tap_t *p_tap;
+
+    if (p_ingest->p_decoder)
+        return false;
+
+    p_tap = malloc(sizeof(delivery_tap_t));
+    if (!p_tap)
+        return false;
+    p_tap->p_queue = p_queue;
+    p_tap->p_ingest = p_ingest;
+    p_tap->p_decode = p_decode;
+    p_tap->i_pid = i_pid;
+    p_tap->b_attached = true;
+
+    /* no gather function: the sections are only reassembled and checked */
+    p_ingest->p_decoder = dvbpsi_decoder_new(NULL, 4096, true, sizeof(dvbpsi_decoder_t));
+    if (!p_ingest->p_decoder)
+    {
+        free(p_tap);
+        return false;
+    }
+    if (!dvbpsi_section_tap_add(p_ingest, DeliveryTap, p_tap))
+    {
+        dvbpsi_decoder_delete(p_ingest->p_decoder);
+        p_ingest->p_decoder = NULL;
+        free(p_tap);
+        return false;
+    }
+    pthread_mutex_init(&p_tap->lock, NULL);
+    p_tap->p_next = p_queue->p_taps;
+    p_queue->p_taps = p_tap;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_delivery_sections_detach
+ *****************************************************************************/
+void dvbpsi_delivery_sections_detach(dvbpsi_delivery_t *p_queue, dvbpsi_t *p_ingest)
+{
+    delivery_tap_t *p_tap = p_queue->p_taps;
+    size_t i_kept = 0;
+
+    while (p_tap && (p_tap->p_ingest != p_ingest || !p_tap->b_attached))
+        p_tap = p_tap->p_next;
+    if (!p_tap)
+        return;
+
+    dvbpsi_section_tap_remove(p_ingest, DeliveryTap, p_tap);
+    dvbpsi_decoder_delete(p_ingest->p_decoder);
+    p_ingest->p_decoder = NULL;
+
+    /* wait for a section being pushed, the ones already taken out of the
+     * queue are then dropped by DeliverySection() */
+    pthread_mutex_lock(&p_tap->lock);
+    p_tap->b_attached = false;
+    pthread_mutex_unlock(&p_tap->lock);
+
+    pthread_mutex_lock(&p_queue->lock);
+    for (size_t i = 0; i < p_queue->i_count; i++)
+    {
+        delivery_item_t *p_item = &p_queue->p_items[(p_queue->i_first + i) % p_queue->i_size];
+        if (p_item->p_cb_data == p_tap && p_item->pf_deliver == DeliverySection)
+            free(p_item->p_object);
+        else
+            p_queue->p_items[(p_queue->i_first + i_kept++) % p_queue->i_size] = *p_item;
+    }
+    p_queue->i_count = i_kept;
+    pthread_cond_broadcast(&p_queue->not_full);
+    pthread_mutex_unlock(&p_queue->lock);
+}
+
+#else /* HAVE_PTHREAD */
+
+dvbpsi_delivery_t *dvbpsi_delivery_new(size_t i_size, dvbpsi_delivery_policy_t i_policy)
+{
+    (void)i_size;
+    (void)i_policy;
+    return NULL;
+}
+
+void dvbpsi_delivery_delete(dvbpsi_delivery_t *p_queue)
+{
+    (void)p_queue;
+}
+
+bool dvbpsi_delivery_post(dvbpsi_delivery_t *p_queue, uint64_t i_key,
+                          dvbpsi_delivery_cb pf_deliver, dvbpsi_delivery_cb pf_discard,
+                          void *p_cb_data, void *p_object)
+{
+    (void)p_queue; (void)i_key; (void)pf_deliver;
+    if (pf_discard)
+        pf_discard(p_cb_data, p_object);
+    return false;
+}
+
+size_t dvbpsi_delivery_run(dvbpsi_delivery_t *p_queue, size_t i_max, bool b_wait)
+{
+    (void)p_queue; (void)i_max; (void)b_wait;
+    return 0;
+}
+
+void dvbpsi_delivery_close(dvbpsi_delivery_t *p_queue)
+{
+    (void)p_queue;
+}
+
+void dvbpsi_delivery_stats(dvbpsi_delivery_t *p_queue, dvbpsi_delivery_stats_t *p_stats)
+{
+    (void)p_queue;
+    memset(p_stats, 0, sizeof(*p_stats));
+}
+
+bool dvbpsi_delivery_sections_attach(dvbpsi_delivery_t *p_queue, dvbpsi_t *p_ingest,
+                                     dvbpsi_t *p_decode, uint16_t i_pid)
+{
+    (void)p_queue; (void)p_ingest; (void)p_decode; (void)i_pid;
+    return false;
+}
+
+void dvbpsi_delivery_sections_detach(dvbpsi_delivery_t *p_queue, dvbpsi_t *p_ingest)
+{
+    (void)p_queue; (void)p_ingest;
+}
+
+#endif /* HAVE_PTHREAD */
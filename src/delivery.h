@@ -0,0 +1,280 @@
+/*****************************************************************************
+ * delivery.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <delivery.h>
+ * \brief Asynchronous delivery of decoded tables.
+ *
+ * The table callbacks run inside dvbpsi_packet_push(), so a slow consumer
+ * stalls the packet input. A delivery queue decouples them: the table
+ * callback only posts the table, which costs a lock and a copy of a few
+ * pointers, and application threads take the tables out of the queue with
+ * dvbpsi_delivery_run(), possibly several at a time.
+ *
+ * \code
+ * static void handle_EIT(void *p_data, dvbpsi_eit_t *p_eit)
+ * {
+ *     dvbpsi_delivery_post(p_queue,
+ *                          DVBPSI_DELIVERY_KEY(0x12, p_eit->i_table_id, p_eit->i_extension),
+ *                          consume_EIT, delete_EIT, p_data, p_eit);
+ * }
+ * \endcode
+ *
+ * Posting decoded tables still leaves the decoding on the packet thread. To
+ * keep only the reassembly and the validation there, the sections of a PID
+ * are handed to the queue with dvbpsi_delivery_sections_attach(): the packet
+ * thread pushes the packets into a handle without table decoder, and the
+ * threads running dvbpsi_delivery_run() push the sections into a second
+ * handle with the table decoders attached, so that the table callbacks run
+ * on these threads.
+ *
+ * \code
+ * dvbpsi_t *p_ingest = dvbpsi_new(NULL, DVBPSI_MSG_WARN);
+ * dvbpsi_t *p_decode = dvbpsi_new(NULL, DVBPSI_MSG_WARN);
+ * dvbpsi_AttachDemux(p_decode, NewSubtable, p_data);
+ * dvbpsi_delivery_sections_attach(p_queue, p_ingest, p_decode, 0x12);
+ * ...
+ * dvbpsi_packet_push(p_ingest, p_packet);
+ * \endcode
+ *
+ * The queue is bounded, what happens when it is full depends on its policy.
+ * The queue needs POSIX threads, without them dvbpsi_delivery_new() returns
+ * NULL.
+ */
+
+#ifndef _DVBPSI_DELIVERY_H_
+#define _DVBPSI_DELIVERY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * dvbpsi_delivery_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_delivery_s dvbpsi_delivery_t
+ * \brief Opaque delivery queue handle.
+ */
+typedef struct dvbpsi_delivery_s dvbpsi_delivery_t;
+
+/*!
+ * \typedef void (* dvbpsi_delivery_cb)(void *p_cb_data, void *p_object)
+ * \brief Delivery or discard callback of a posted object.
+ */
+typedef void (* dvbpsi_delivery_cb)(void *p_cb_data, void *p_object);
+
+/*!
+ * \enum dvbpsi_delivery_policy_e
+ * \brief What dvbpsi_delivery_post() does when the queue is full.
+ */
+enum dvbpsi_delivery_policy_e
+{
+    DVBPSI_DELIVERY_BLOCK,        /*!< wait for a consumer to make room */
+    DVBPSI_DELIVERY_DROP_OLDEST,  /*!< discard the oldest pending object */
+    DVBPSI_DELIVERY_COALESCE,     /*!< a pending object with the same key is
+                                       replaced by the new one whether the
+                                       queue is full or not, the oldest is
+                                       discarded when there is none */
+};
+
+/*!
+ * \typedef enum dvbpsi_delivery_policy_e dvbpsi_delivery_policy_t
+ * \brief Delivery queue policy.
+ */
+typedef enum dvbpsi_delivery_policy_e dvbpsi_delivery_policy_t;
+
+/*!
+ * \def DVBPSI_DELIVERY_KEY(pid, table_id, extension)
+ * \brief Key of a subtable, for the coalescing policy.
+ */
+#define DVBPSI_DELIVERY_KEY(pid, table_id, extension) \
+    (((uint64_t)(pid) << 24) | ((uint64_t)(table_id) << 16) | (uint64_t)(extension))
+
+/*!
+ * \def DVBPSI_DELIVERY_NO_KEY
+ * \brief Key of an object that is never coalesced.
+ */
+#define DVBPSI_DELIVERY_NO_KEY UINT64_MAX
+
+/*!
+ * \struct dvbpsi_delivery_stats_s
+ * \brief Delivery queue counters, since the creation of the queue.
+ */
+/*!
+ * \typedef struct dvbpsi_delivery_stats_s dvbpsi_delivery_stats_t
+ * \brief dvbpsi_delivery_stats_t type definition.
+ */
+typedef struct dvbpsi_delivery_stats_s
+{
+    uint64_t    i_posted;       /*!< objects posted */
+    uint64_t    i_delivered;    /*!< objects delivered */
+    uint64_t    i_dropped;      /*!< objects discarded as the oldest one */
+    uint64_t    i_coalesced;    /*!< objects replaced by a newer one */
+    uint64_t    i_blocked;      /*!< posts that had to wait */
+    size_t      i_pending;      /*!< objects in the queue */
+    size_t      i_max_pending;  /*!< highest number of objects in the queue */
+} dvbpsi_delivery_stats_t;
+
+/*****************************************************************************
+ * dvbpsi_delivery_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_delivery_t *dvbpsi_delivery_new(size_t i_size,
+                                              dvbpsi_delivery_policy_t i_policy)
+ * \brief Create a delivery queue.
+ * \param i_size maximum number of pending objects, at least 1
+ * \param i_policy policy when the queue is full
+ * \return the queue, NULL on error or without POSIX threads support
+ */
+dvbpsi_delivery_t *dvbpsi_delivery_new(size_t i_size, dvbpsi_delivery_policy_t i_policy);
+
+/*****************************************************************************
+ * dvbpsi_delivery_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_delivery_delete(dvbpsi_delivery_t *p_queue)
+ * \brief Delete a queue, discarding the pending objects and detaching the
+ * section handles still attached. No thread may use the queue any more.
+ * \param p_queue the queue, may be NULL
+ * \return nothing
+ */
+void dvbpsi_delivery_delete(dvbpsi_delivery_t *p_queue);
+
+/*****************************************************************************
+ * dvbpsi_delivery_post
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_delivery_post(dvbpsi_delivery_t *p_queue, uint64_t i_key,
+            dvbpsi_delivery_cb pf_deliver, dvbpsi_delivery_cb pf_discard,
+            void *p_cb_data, void *p_object)
+ * \brief Post an object, typically a decoded table from a table callback.
+ *
+ * With the blocking policy, the caller waits while the queue is full, so
+ * it must not be one of the threads calling dvbpsi_delivery_run().
+ * \param p_queue the queue
+ * \param i_key subtable of the object, see DVBPSI_DELIVERY_KEY()
+ * \param pf_deliver called by dvbpsi_delivery_run() with p_cb_data and
+ * p_object
+ * \param pf_discard called with p_cb_data and p_object when the object is
+ * dropped, coalesced or still pending when the queue is deleted, may be NULL
+ * \param p_cb_data private data given to the callbacks
+ * \param p_object the object
+ * \return false when the queue is closed, the object is then discarded
+ */
+bool dvbpsi_delivery_post(dvbpsi_delivery_t *p_queue, uint64_t i_key,
+                          dvbpsi_delivery_cb pf_deliver, dvbpsi_delivery_cb pf_discard,
+                          void *p_cb_data, void *p_object);
+
+/*****************************************************************************
+ * dvbpsi_delivery_run
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_delivery_run(dvbpsi_delivery_t *p_queue, size_t i_max,
+                                  bool b_wait)
+ * \brief Deliver pending objects, oldest first.
+ *
+ * Several threads may run deliveries of the same queue, the deliveries are
+ * then concurrent and their order between threads is not defined.
+ * \param p_queue the queue
+ * \param i_max maximum number of deliveries
+ * \param b_wait wait for an object when the queue is empty
+ * \return the number of objects delivered, 0 when the queue is empty and
+ * b_wait is false or the queue is closed
+ */
+size_t dvbpsi_delivery_run(dvbpsi_delivery_t *p_queue, size_t i_max, bool b_wait);
+
+/*****************************************************************************
+ * dvbpsi_delivery_close
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_delivery_close(dvbpsi_delivery_t *p_queue)
+ * \brief Close a queue: the following posts fail and dvbpsi_delivery_run()
+ * stops waiting once the pending objects are delivered.
+ * \param p_queue the queue
+ * \return nothing
+ */
+void dvbpsi_delivery_close(dvbpsi_delivery_t *p_queue);
+
+/*****************************************************************************
+ * dvbpsi_delivery_stats
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_delivery_stats(dvbpsi_delivery_t *p_queue,
+                                  dvbpsi_delivery_stats_t *p_stats)
+ * \brief Read the counters of a queue.
+ * \param p_queue the queue
+ * \param p_stats filled with the counters
+ * \return nothing
+ */
+void dvbpsi_delivery_stats(dvbpsi_delivery_t *p_queue, dvbpsi_delivery_stats_t *p_stats);
+
+/*****************************************************************************
+ * dvbpsi_delivery_sections_attach
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_delivery_sections_attach(dvbpsi_delivery_t *p_queue,
+            dvbpsi_t *p_ingest, dvbpsi_t *p_decode, uint16_t i_pid)
+ * \brief Hand the sections of a PID to the queue.
+ *
+ * A decoder only reassembling the sections is attached to p_ingest, each
+ * valid section is copied and posted to the queue, and dvbpsi_delivery_run()
+ * pushes it into p_decode with dvbpsi_section_push(). The sections of a
+ * handle are pushed one at a time, in the order of the queue when a single
+ * thread runs the deliveries. With the coalescing policy, a pending section
+ * is replaced by a newer one with the same table_id, extension and number.
+ * A dropped section only delays its table to the next repetition.
+ * \param p_queue the queue
+ * \param p_ingest handle without decoder, for dvbpsi_packet_push()
+ * \param p_decode handle with the table decoders, used by the threads
+ * running dvbpsi_delivery_run() only
+ * \param i_pid PID of the sections, for the coalescing policy
+ * \return false on error, if p_ingest already has a decoder or without
+ * POSIX threads support
+ */
+bool dvbpsi_delivery_sections_attach(dvbpsi_delivery_t *p_queue, dvbpsi_t *p_ingest,
+                                     dvbpsi_t *p_decode, uint16_t i_pid);
+
+/*****************************************************************************
+ * dvbpsi_delivery_sections_detach
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_delivery_sections_detach(dvbpsi_delivery_t *p_queue,
+                                             dvbpsi_t *p_ingest)
+ * \brief Stop handing the sections of p_ingest to the queue.
+ *
+ * The pending sections are discarded and the decoder attached to p_ingest
+ * is deleted. Once it returns, no section is pushed into the p_decode
+ * handle any more, which may then be deleted.
+ * \param p_queue the queue
+ * \param p_ingest handle given to dvbpsi_delivery_sections_attach()
+ * \return nothing
+ */
+void dvbpsi_delivery_sections_detach(dvbpsi_delivery_t *p_queue, dvbpsi_t *p_ingest);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of delivery.h"
+#endif
@@ -120,7 +120,11 @@ void dvbpsi_Demux(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t *p_section)
     }
 
     if (p_subdec)
+    {
+        /* Account the sections of the subtable to the handle */
+        p_subdec->p_decoder->p_dvbpsi = p_dvbpsi;
         p_subdec->pf_gather(p_dvbpsi, p_subdec->p_decoder, p_section);
+    }
     else
         dvbpsi_DeletePSISections(p_section);
 }
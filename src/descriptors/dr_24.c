@@ -163,15 +163,12 @@ dvbpsi_content_labelling_dr_t* dvbpsi_DecodeContentLabellingDr(
     if (p_descriptor->i_length < DR_24_MIN_SIZE)
         return NULL;
 
-    p_decoded = malloc(sizeof(*p_decoded));
+    /* the fields of the absent parts are zero, and so are the pointers,
+     * so we can safely free() them in err: */
+    p_decoded = calloc(1, sizeof(*p_decoded));
     if (!p_decoded)
         return NULL;
 
-    /* set the pointers to NULL so we can safely free() them in err: */
-    p_decoded->p_content_reference_id = NULL;
-    p_decoded->p_time_base_association_data = NULL;
-    p_decoded->p_private_data = NULL;
-
     p_decoded->i_metadata_application_format =
         ((uint16_t)p_data[0] << 8) | (uint16_t)p_data[1];
     i_left -= 2; p_data += 2;
@@ -283,7 +280,7 @@ dvbpsi_descriptor_t * dvbpsi_GenContentLabellingDr(
         return NULL;
 
     size = generate_get_descriptor_size(p_decoded);
-    if(size > 253) /* maximum possible descriptor payload size. */
+    if(size > 255) /* maximum possible descriptor payload size. */
         return NULL;
 
     p_descriptor = dvbpsi_NewDescriptor(0x24, size, NULL);
@@ -306,7 +303,7 @@ dvbpsi_descriptor_t * dvbpsi_GenContentLabellingDr(
     }
 
     *p_data = ((p_decoded->b_content_reference_id_record_flag ? 1 : 0) << 7) |
-        ((p_decoded->i_content_time_base_indicator & 0xf) << 6) |
+        ((p_decoded->i_content_time_base_indicator & 0xf) << 3) |
         0x07;
     p_data++;
 
@@ -346,11 +343,13 @@ dvbpsi_descriptor_t * dvbpsi_GenContentLabellingDr(
         p_decoded->i_content_time_base_indicator <= 7)
     {
         *p_data = p_decoded->i_time_base_association_data_length;
-        memcpy(p_data + 1, p_decoded->p_time_base_association_data,
-            p_decoded->i_time_base_association_data_length);
+        if(p_decoded->i_time_base_association_data_length)
+            memcpy(p_data + 1, p_decoded->p_time_base_association_data,
+                p_decoded->i_time_base_association_data_length);
         p_data += (p_decoded->i_time_base_association_data_length + 1);
     }
 
-    memcpy(p_data, p_decoded->p_private_data, p_decoded->i_private_data_len);
+    if(p_decoded->i_private_data_len)
+        memcpy(p_data, p_decoded->p_private_data, p_decoded->i_private_data_len);
     return p_descriptor;
 }
@@ -57,13 +57,17 @@ dvbpsi_sat_deliv_sys_dr_t * dvbpsi_DecodeSatDelivSysDr(
     if (dvbpsi_IsDescriptorDecoded(p_descriptor))
         return p_descriptor->p_decoded;
 
+    /* Check the length */
+    if (p_descriptor->i_length < 11)
+        return NULL;
+
     /* Allocate memory */
     p_decoded = (dvbpsi_sat_deliv_sys_dr_t*)malloc(sizeof(dvbpsi_sat_deliv_sys_dr_t));
     if (!p_decoded)
             return NULL;
 
     /* Decode data */
-    p_decoded->i_frequency         =   (uint32_t)(p_descriptor->p_data[0] << 24)
+    p_decoded->i_frequency         =   ((uint32_t)p_descriptor->p_data[0] << 24)
                                      | (uint32_t)(p_descriptor->p_data[1] << 16)
                                      | (uint32_t)(p_descriptor->p_data[2] <<  8)
                                      | (uint32_t)(p_descriptor->p_data[3]);
@@ -57,6 +57,10 @@ dvbpsi_cable_deliv_sys_dr_t * dvbpsi_DecodeCableDelivSysDr(
   if (dvbpsi_IsDescriptorDecoded(p_descriptor))
      return p_descriptor->p_decoded;
 
+  /* Check the length */
+  if (p_descriptor->i_length < 11)
+    return NULL;
+
   /* Allocate memory */
   p_decoded =
         (dvbpsi_cable_deliv_sys_dr_t*)malloc(sizeof(dvbpsi_cable_deliv_sys_dr_t));
@@ -64,7 +68,7 @@ dvbpsi_cable_deliv_sys_dr_t * dvbpsi_DecodeCableDelivSysDr(
     return NULL;
 
   /* Decode data */
-  p_decoded->i_frequency         =   (uint32_t)(p_descriptor->p_data[0] << 24)
+  p_decoded->i_frequency         =   ((uint32_t)p_descriptor->p_data[0] << 24)
                                    | (uint32_t)(p_descriptor->p_data[1] << 16)
                                    | (uint32_t)(p_descriptor->p_data[2] <<  8)
                                    | (uint32_t)(p_descriptor->p_data[3] );
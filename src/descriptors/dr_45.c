@@ -55,44 +55,40 @@ dvbpsi_vbi_dr_t * dvbpsi_DecodeVBIDataDr(
         return p_descriptor->p_decoded;
 
     /* Check the length */
-    if (p_descriptor->i_length < 3)
+    if (p_descriptor->i_length < 2)
         return NULL;
-    if (p_descriptor->i_length % 2)
-        return NULL;
-
-    /* */
-    dvbpsi_vbi_dr_t * p_decoded;
-    uint8_t i_services_number = p_descriptor->i_length / 2;
-    if (i_services_number > DVBPSI_VBI_DR_MAX)
-        i_services_number = DVBPSI_VBI_DR_MAX;
 
     /* Allocate memory */
+    dvbpsi_vbi_dr_t * p_decoded;
     p_decoded = (dvbpsi_vbi_dr_t*)malloc(sizeof(dvbpsi_vbi_dr_t));
     if (!p_decoded)
         return NULL;
 
-    p_decoded->i_services_number = i_services_number;
+    /* Each service is its id, the number of lines and a byte per line */
+    const uint8_t *p_data = p_descriptor->p_data;
+    const uint8_t *p_end = p_data + p_descriptor->i_length;
 
-    for (uint8_t i = 0; i < i_services_number; i++)
+    p_decoded->i_services_number = 0;
+    while (p_end - p_data >= 2 && p_decoded->i_services_number < DVBPSI_VBI_DR_MAX)
     {
-        uint8_t i_lines = 0, i_data_service_id;
-
-        i_data_service_id = ((uint8_t)(p_descriptor->p_data[3 * i + 2 + i_lines]));
-        p_decoded->p_services[i].i_data_service_id = i_data_service_id;
+        dvbpsi_vbidata_t *p_service =
+                &p_decoded->p_services[p_decoded->i_services_number++];
 
-        i_lines = ((uint8_t)(p_descriptor->p_data[3 * i + 3]));
-        p_decoded->p_services[i].i_lines = i_lines;
+        p_service->i_data_service_id = p_data[0];
+        p_service->i_lines = p_data[1];
+        p_data += 2;
+        if (p_service->i_lines > p_end - p_data)
+        {
+            free(p_decoded);
+            return NULL;
+        }
 
-        for (uint8_t n = 0; n < i_lines; n++)
+        for (uint8_t n = 0; n < p_service->i_lines; n++)
         {
-            if( (i_data_service_id >= 0x01) && (i_data_service_id <= 0x07) )
-            {
-                p_decoded->p_services[i].p_lines[n].i_parity =
-                        ((uint8_t)((p_descriptor->p_data[3 * i + 3 + n])&0x20)>>5);
-                p_decoded->p_services[i].p_lines[n].i_line_offset =
-                        ((uint8_t)(p_descriptor->p_data[3 * i + 3 + n])&0x1f);
-            }
+            p_service->p_lines[n].i_parity = (p_data[n] >> 5) & 0x01;
+            p_service->p_lines[n].i_line_offset = p_data[n] & 0x1f;
         }
+        p_data += p_service->i_lines;
     }
 
     p_descriptor->p_decoded = (void*)p_decoded;
@@ -110,31 +106,38 @@ dvbpsi_descriptor_t * dvbpsi_GenVBIDataDr(dvbpsi_vbi_dr_t * p_decoded,
         p_decoded->i_services_number = DVBPSI_VBI_DR_MAX;
 
     /* Create the descriptor */
-    uint8_t i_size = (p_decoded->i_services_number * 5) > UINT8_MAX ?
-                        255 : (p_decoded->i_services_number * 5); /* FIXME: */
+    unsigned int i_size = 0;
+    for (uint8_t i = 0; i < p_decoded->i_services_number; i++)
+        i_size += 2 + p_decoded->p_services[i].i_lines;
+    if (i_size > 255)
+        return NULL;
+
     dvbpsi_descriptor_t * p_descriptor =
             dvbpsi_NewDescriptor(0x45, i_size, NULL);
     if (!p_descriptor)
         return NULL;
 
     /* Encode data */
+    uint8_t *p_data = p_descriptor->p_data;
     for (uint8_t i = 0; i < p_decoded->i_services_number; i++)
     {
-        p_descriptor->p_data[5 * i + 3] =
-                ( (uint8_t) p_decoded->p_services[i].i_data_service_id );
+        const dvbpsi_vbidata_t *p_service = &p_decoded->p_services[i];
 
-        p_descriptor->p_data[5 * i + 4] = p_decoded->p_services[i].i_lines;
-        for (uint8_t n=0; n < p_decoded->p_services[i].i_lines; n++ )
+        p_data[0] = p_service->i_data_service_id;
+        p_data[1] = p_service->i_lines;
+        p_data += 2;
+        for (uint8_t n = 0; n < p_service->i_lines; n++)
         {
-            if( (p_decoded->p_services[i].i_data_service_id >= 0x01) &&
-                    (p_decoded->p_services[i].i_data_service_id <= 0x07) )
+            if ((p_service->i_data_service_id >= 0x01) &&
+                (p_service->i_data_service_id <= 0x07))
             {
-                p_descriptor->p_data[5 * i + 4 + n] = (uint8_t)
-                        ( (((uint8_t) p_decoded->p_services[i].p_lines[n].i_parity)&0x20)<<5) |
-                        ( ((uint8_t) p_decoded->p_services[i].p_lines[n].i_line_offset)&0x1f);
+                p_data[n] = 0xc0
+                          | ((p_service->p_lines[n].i_parity & 0x01) << 5)
+                          | (p_service->p_lines[n].i_line_offset & 0x1f);
             }
-            else p_descriptor->p_data[5 * i + 3 + n] = 0xFF; /* Stuffing byte */
+            else p_data[n] = 0xFF; /* Stuffing byte */
         }
+        p_data += p_service->i_lines;
     }
 
     if (b_duplicate)
@@ -67,39 +67,36 @@ dvbpsi_service_dr_t * dvbpsi_DecodeServiceDr(
 
     p_descriptor->p_decoded = (void*)p_decoded;
 
-    p_decoded->i_service_type = p_descriptor->p_data[0];
-    p_decoded->i_service_provider_name_length = p_descriptor->p_data[1];
-    p_decoded->i_service_name_length = 0;
-    p_decoded->i_service_provider_name[0] = 0;
-    p_decoded->i_service_name[0] = 0;
-
+    /* The names are clipped to the descriptor */
+    const uint8_t *p_data = p_descriptor->p_data;
+    unsigned int i_left = p_descriptor->i_length - 2;
+
+    p_decoded->i_service_type = p_data[0];
+    p_decoded->i_service_provider_name_length = p_data[1];
+    if (p_decoded->i_service_provider_name_length > i_left)
+        p_decoded->i_service_provider_name_length = i_left;
     if (p_decoded->i_service_provider_name_length > 252)
         p_decoded->i_service_provider_name_length = 252;
 
-    if (p_decoded->i_service_provider_name_length + 2 > p_descriptor->i_length)
-        return p_decoded;
-
     if (p_decoded->i_service_provider_name_length)
-        memcpy(p_decoded->i_service_provider_name,
-               p_descriptor->p_data + 2,
+        memcpy(p_decoded->i_service_provider_name, p_data + 2,
                p_decoded->i_service_provider_name_length);
+    p_data += 2 + p_decoded->i_service_provider_name_length;
+    i_left -= p_decoded->i_service_provider_name_length;
 
-    if (p_decoded->i_service_provider_name_length + 3 > p_descriptor->i_length)
+    p_decoded->i_service_name_length = 0;
+    if (i_left == 0)
         return p_decoded;
+    i_left--;
 
-    p_decoded->i_service_name_length =
-            p_descriptor->p_data[2+p_decoded->i_service_provider_name_length];
-
+    p_decoded->i_service_name_length = p_data[0];
+    if (p_decoded->i_service_name_length > i_left)
+        p_decoded->i_service_name_length = i_left;
     if (p_decoded->i_service_name_length > 252)
         p_decoded->i_service_name_length = 252;
 
-    if (p_decoded->i_service_provider_name_length + 3 +
-            p_decoded->i_service_name_length > p_descriptor->i_length)
-        return p_decoded;
-
     if (p_decoded->i_service_name_length)
-        memcpy(p_decoded->i_service_name,
-               p_descriptor->p_data + 3 + p_decoded->i_service_provider_name_length,
+        memcpy(p_decoded->i_service_name, p_data + 1,
                p_decoded->i_service_name_length);
 
     return p_decoded;
@@ -116,11 +113,10 @@ dvbpsi_descriptor_t * dvbpsi_GenServiceDr(dvbpsi_service_dr_t * p_decoded,
     if (p_decoded->i_service_name_length > 252)
         p_decoded->i_service_name_length = 252;
 
-    /* FIXME: is this correct? A descriptor cannot be more then 255 bytes due to
-     * the function prototype definition */
-    uint8_t i_size = 0;
-    int i_length = 3 + p_decoded->i_service_name_length + p_decoded->i_service_provider_name_length;
-    i_size = (i_length >= UINT8_MAX) ? 255 : i_length;
+    /* A descriptor cannot be more than 255 bytes */
+    int i_size = 3 + p_decoded->i_service_name_length + p_decoded->i_service_provider_name_length;
+    if (i_size > UINT8_MAX)
+        return NULL;
 
     /* Create the descriptor */
     dvbpsi_descriptor_t *p_descriptor = dvbpsi_NewDescriptor(0x48, i_size, NULL);
@@ -40,9 +40,9 @@
 #include "dr_49.h"
 
 /*****************************************************************************
- * dvbpsi_DecodeCountryAvailability
+ * dvbpsi_DecodeCountryAvailabilityDr
  *****************************************************************************/
-dvbpsi_country_availability_dr_t* dvbpsi_DecodeCountryAvailability(
+dvbpsi_country_availability_dr_t* dvbpsi_DecodeCountryAvailabilityDr(
                                         dvbpsi_descriptor_t * p_descriptor)
 {
     dvbpsi_country_availability_dr_t * p_decoded;
@@ -84,6 +84,15 @@ dvbpsi_country_availability_dr_t* dvbpsi_DecodeCountryAvailability(
 }
 
 
+/*****************************************************************************
+ * dvbpsi_DecodeCountryAvailability
+ *****************************************************************************/
+dvbpsi_country_availability_dr_t* dvbpsi_DecodeCountryAvailability(
+                                        dvbpsi_descriptor_t * p_descriptor)
+{
+    return dvbpsi_DecodeCountryAvailabilityDr(p_descriptor);
+}
+
 /*****************************************************************************
  * dvbpsi_GenCountryAvailabilityDr
  *****************************************************************************/
@@ -97,7 +106,7 @@ dvbpsi_descriptor_t * dvbpsi_GenCountryAvailabilityDr(
 
     /* Create the descriptor */
     dvbpsi_descriptor_t * p_descriptor =
-            dvbpsi_NewDescriptor(0x83, 1+p_decoded->i_code_count*3, NULL);
+            dvbpsi_NewDescriptor(0x49, 1+p_decoded->i_code_count*3, NULL);
     if (!p_descriptor)
         return NULL;
 
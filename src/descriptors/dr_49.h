@@ -72,13 +72,26 @@ typedef struct dvbpsi_country_availability_dr_s
  * dvbpsi_DecodeCountryAvailabilityDr
  *****************************************************************************/
 /*!
- * \fn dvbpsi_country_availability_dr_t * dvbpsi_DecodeCountryAvailability(
+ * \fn dvbpsi_country_availability_dr_t * dvbpsi_DecodeCountryAvailabilityDr(
                                         dvbpsi_descriptor_t * p_descriptor)
  * \brief "country availability" descriptor decoder.
  * \param p_descriptor pointer to the descriptor structure
  * \return a pointer to a new "country availability" descriptor structure
  * which contains the decoded data.
  */
+dvbpsi_country_availability_dr_t* dvbpsi_DecodeCountryAvailabilityDr(
+                                        dvbpsi_descriptor_t * p_descriptor);
+
+/*****************************************************************************
+ * dvbpsi_DecodeCountryAvailability
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_country_availability_dr_t * dvbpsi_DecodeCountryAvailability(
+                                        dvbpsi_descriptor_t * p_descriptor)
+ * \brief Former name of dvbpsi_DecodeCountryAvailabilityDr().
+ * @note deprecated
+ */
+__attribute__((deprecated))
 dvbpsi_country_availability_dr_t* dvbpsi_DecodeCountryAvailability(
                                         dvbpsi_descriptor_t * p_descriptor);
 
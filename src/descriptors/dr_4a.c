@@ -68,10 +68,12 @@ dvbpsi_linkage_dr_t* dvbpsi_DecodeLinkageDr(dvbpsi_descriptor_t * p_descriptor)
         
         handover_type = (p_descriptor->p_data[7] & 0xF0) >> 4;
         origin_type = p_descriptor->p_data[7] & 0x01;
-        if ((( handover_type > 0 ) && ( handover_type < 4 )
-                && ( origin_type == 0 ) && ( p_descriptor->i_length < DR_4A_MIN_SIZE + 5 )) ||
-            (( handover_type > 0 ) && ( handover_type < 4 )
-                && ( origin_type == 1 ) && ( p_descriptor->i_length < DR_4A_MIN_SIZE + 3 )))
+        unsigned int i_size = DR_4A_MIN_SIZE + 1;
+        if (( handover_type > 0 ) && ( handover_type < 4 ))
+            i_size += 2; /* network_id */
+        if (origin_type == 0)
+            i_size += 2; /* initial_service_id */
+        if (p_descriptor->i_length < i_size)
             return NULL;
     }
     if (p_descriptor->p_data[6] == 0x0D &&
@@ -154,7 +156,7 @@ dvbpsi_descriptor_t * dvbpsi_GenLinkageDr(dvbpsi_linkage_dr_t * p_decoded,
         length++;
 
         if ((p_decoded->i_handover_type > 0) &&
-            (p_decoded->i_handover_type < 3))
+            (p_decoded->i_handover_type < 4))
             length+=2;
 
         if (p_decoded->i_origin_type == 0)
@@ -186,7 +188,7 @@ dvbpsi_descriptor_t * dvbpsi_GenLinkageDr(dvbpsi_linkage_dr_t * p_decoded,
     			| 0x0E | ( p_decoded->i_origin_type & 0x01 );
         last_pos = 7;
         if ((p_decoded->i_handover_type > 0) &&
-            (p_decoded->i_handover_type < 3 ))
+            (p_decoded->i_handover_type < 4 ))
         {
     		p_descriptor->p_data[8] = p_decoded->i_network_id >> 8;
     		p_descriptor->p_data[9] = p_decoded->i_network_id;
@@ -195,7 +197,7 @@ dvbpsi_descriptor_t * dvbpsi_GenLinkageDr(dvbpsi_linkage_dr_t * p_decoded,
         if (p_decoded->i_origin_type == 0)
         {
                 if ((p_decoded->i_handover_type > 0) &&
-                    (p_decoded->i_handover_type < 3 ))
+                    (p_decoded->i_handover_type < 4 ))
                 {
         		p_descriptor->p_data[10] = p_decoded->i_initial_service_id >> 8;
         		p_descriptor->p_data[11] = p_decoded->i_initial_service_id;
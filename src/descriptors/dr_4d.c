@@ -60,6 +60,8 @@ dvbpsi_short_event_dr_t * dvbpsi_DecodeShortEventDr(dvbpsi_descriptor_t * p_desc
 
   /* Check length */
   i_len1 = p_descriptor->p_data[3];
+  if (p_descriptor->i_length < 5 + i_len1)
+    return NULL;
   i_len2 = p_descriptor->p_data[4+i_len1];
 
   if (p_descriptor->i_length < 5 + i_len1 + i_len2)
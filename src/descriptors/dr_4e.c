@@ -37,6 +37,7 @@
 #include "../dvbpsi.h"
 #include "../dvbpsi_private.h"
 #include "../descriptor.h"
+#include "../charset.h"
 
 #include "dr_4e.h"
 
@@ -59,6 +60,12 @@ dvbpsi_extended_event_dr_t * dvbpsi_DecodeExtendedEventDr(dvbpsi_descriptor_t *
     if (dvbpsi_IsDescriptorDecoded(p_descriptor))
         return p_descriptor->p_decoded;
 
+    /* Check the lengths of the items loop and of the text */
+    i_len = p_descriptor->p_data[4];
+    if (6 + i_len > p_descriptor->i_length ||
+        6 + i_len + p_descriptor->p_data[5+i_len] > p_descriptor->i_length)
+        return NULL;
+
     /* Allocate memory */
     p_decoded = malloc(sizeof(dvbpsi_extended_event_dr_t));
     if (!p_decoded)
@@ -69,11 +76,18 @@ dvbpsi_extended_event_dr_t * dvbpsi_DecodeExtendedEventDr(dvbpsi_descriptor_t *
     p_decoded->i_last_descriptor_number = p_descriptor->p_data[0]&0x0f;
     memcpy( &p_decoded->i_iso_639_code[0], &p_descriptor->p_data[1], 3 );
     p_decoded->i_entry_count = 0;
-    i_len = p_descriptor->p_data[4];
     i_pos = 0;
     for( p = &p_descriptor->p_data[5]; p < &p_descriptor->p_data[5+i_len]; )
     {
         int idx = p_decoded->i_entry_count;
+        int i_left = &p_descriptor->p_data[5+i_len] - p;
+
+        /* both lengths and the description, then the item */
+        if( i_left < 2 + p[0] || i_left < 2 + p[0] + p[1 + p[0]] )
+        {
+            free( p_decoded );
+            return NULL;
+        }
 
         p_decoded->i_item_description_length[idx] = p[0];
         p_decoded->i_item_description[idx] = &p_decoded->i_buffer[i_pos];
@@ -116,6 +130,8 @@ dvbpsi_descriptor_t * dvbpsi_GenExtendedEventDr(dvbpsi_extended_event_dr_t * p_d
     for (int i = 0; i < p_decoded->i_entry_count; i++)
         i_len2 += 2 + p_decoded->i_item_description_length[i] + p_decoded->i_item_length[i];
     i_len = 1 + 3 + 1 + i_len2 + 1 + p_decoded->i_text_length;
+    if (i_len > 255)
+        return NULL;
 
     /* Create the descriptor */
     p_descriptor = dvbpsi_NewDescriptor(0x4e, i_len, NULL );
@@ -130,7 +146,7 @@ dvbpsi_descriptor_t * dvbpsi_GenExtendedEventDr(dvbpsi_extended_event_dr_t * p_d
     memcpy( &p[1], p_decoded->i_iso_639_code, 3 );
     p[4] = i_len2;
 
-    p += 4;
+    p += 5;
 
     for (int i = 0; i < p_decoded->i_entry_count; i++)
     {
@@ -156,3 +172,224 @@ dvbpsi_descriptor_t * dvbpsi_GenExtendedEventDr(dvbpsi_extended_event_dr_t * p_d
 
     return p_descriptor;
 }
+
+
+/*****************************************************************************
+ * Assembly of the extended event text
+ *****************************************************************************/
+/* The descriptors of the language, by descriptor_number */
+typedef struct extended_event_parts_s
+{
+    bool            b_language;
+    uint8_t         i_iso_639_code[3];
+    const uint8_t  *p_body[16];
+    uint8_t         i_length[16];
+} extended_event_parts_t;
+
+typedef struct extended_event_piece_s
+{
+    uint16_t        i_description;      /* offset in the items buffer */
+    uint16_t        i_description_length;
+    uint16_t        i_item;
+    uint16_t        i_item_length;
+} extended_event_piece_t;
+
+static void ExtendedEventCollect(extended_event_parts_t *p_parts,
+                                 const uint8_t *p_body, uint8_t i_length)
+{
+    uint8_t i_number;
+
+    /* descriptor_number, ISO_639_language_code, length_of_items, text_length */
+    if (i_length < 6 || 5 + p_body[4] + 1 > i_length
+     || 5 + p_body[4] + 1 + p_body[5 + p_body[4]] > i_length)
+        return;
+
+    if (!p_parts->b_language)
+    {
+        memcpy(p_parts->i_iso_639_code, &p_body[1], 3);
+        p_parts->b_language = true;
+    }
+    else if (memcmp(p_parts->i_iso_639_code, &p_body[1], 3))
+        return;
+
+    i_number = p_body[0] >> 4;
+    if (!p_parts->p_body[i_number])
+    {
+        p_parts->p_body[i_number] = p_body;
+        p_parts->i_length[i_number] = i_length;
+    }
+}
+
+/* Size of the character table selection at the start of a string */
+static size_t ExtendedEventTableLength(const uint8_t *p_string, size_t i_length)
+{
+    size_t i_table;
+    if (i_length == 0 || p_string[0] >= 0x20)
+        return 0;
+    i_table = p_string[0] == 0x10 ? 3 : p_string[0] == 0x1f ? 2 : 1;
+    return i_table < i_length ? i_table : i_length;
+}
+
+/* Append a string, without its character table selection if it continues
+ * another one */
+static uint16_t ExtendedEventAppend(uint8_t *p_buffer, uint16_t i_size,
+                                    const uint8_t *p_string, uint8_t i_length,
+                                    bool b_continued)
+{
+    size_t i_skip = b_continued ? ExtendedEventTableLength(p_string, i_length) : 0;
+    memcpy(p_buffer + i_size, p_string + i_skip, i_length - i_skip);
+    return (uint16_t)(i_length - i_skip);
+}
+
+static uint8_t *ExtendedEventString(uint8_t **pp_out, const uint8_t *p_raw, size_t i_raw,
+                                    bool b_utf8, size_t *pi_length)
+{
+    uint8_t *p_string = *pp_out;
+    if (b_utf8)
+        *pi_length = dvbpsi_text_to_utf8(p_raw, i_raw, (char *)p_string, 3 * i_raw + 1);
+    else
+    {
+        memcpy(p_string, p_raw, i_raw);
+        p_string[i_raw] = '\0';
+        *pi_length = i_raw;
+    }
+    *pp_out += *pi_length + 1;
+    return p_string;
+}
+
+static dvbpsi_extended_event_text_t *ExtendedEventAssemble(const extended_event_parts_t *p_parts,
+                                                           bool b_utf8)
+{
+    /* each item takes at least 2 bytes of a descriptor */
+    extended_event_piece_t pieces[16 * 128];
+    uint8_t p_items[16 * 256], p_text[16 * 256];
+    uint16_t i_items_size = 0, i_text_size = 0;
+    int i_pieces = 0;
+    size_t i_size;
+    dvbpsi_extended_event_text_t *p_assembled;
+    uint8_t *p_out;
+
+    if (!p_parts->b_language)
+        return NULL;
+
+    for (int i = 0; i < 16; i++)
+    {
+        const uint8_t *p_body = p_parts->p_body[i];
+        const uint8_t *p, *p_end;
+        if (!p_body)
+            continue;
+
+        p = &p_body[5];
+        p_end = p + p_body[4];
+        while (p + 2 <= p_end && p + 2 + p[0] <= p_end && p + 2 + p[0] + p[1 + p[0]] <= p_end)
+        {
+            const uint8_t *p_description = p + 1, *p_item = p + 2 + p[0];
+            const uint8_t i_description_length = p[0], i_item_length = p[1 + p[0]];
+            p = p_item + i_item_length;
+
+            if (i_description_length == 0 && i_pieces > 0)
+            {
+                /* continuation of the previous item, at the end of p_items */
+                uint16_t i_added = ExtendedEventAppend(p_items, i_items_size, p_item,
+                                                       i_item_length, true);
+                pieces[i_pieces - 1].i_item_length += i_added;
+                i_items_size += i_added;
+                continue;
+            }
+            pieces[i_pieces].i_description = i_items_size;
+            pieces[i_pieces].i_description_length = i_description_length;
+            i_items_size += ExtendedEventAppend(p_items, i_items_size, p_description,
+                                                i_description_length, false);
+            pieces[i_pieces].i_item = i_items_size;
+            pieces[i_pieces].i_item_length = i_item_length;
+            i_items_size += ExtendedEventAppend(p_items, i_items_size, p_item,
+                                                i_item_length, false);
+            i_pieces++;
+        }
+
+        i_text_size += ExtendedEventAppend(p_text, i_text_size, p_end + 1, p_end[0],
+                                           i_text_size > 0);
+    }
+
+    /* one block: the structure, the items and the strings, each of them
+     * taking at most 3 bytes of UTF-8 for each byte */
+    i_size = sizeof(dvbpsi_extended_event_text_t)
+           + i_pieces * sizeof(dvbpsi_extended_event_item_t)
+           + (b_utf8 ? 3 : 1) * ((size_t)i_items_size + i_text_size)
+           + 2 * i_pieces + 1;
+    p_assembled = malloc(i_size);
+    if (!p_assembled)
+        return NULL;
+
+    memcpy(p_assembled->i_iso_639_code, p_parts->i_iso_639_code, 3);
+    p_assembled->i_item_count = i_pieces;
+    p_assembled->p_items = (dvbpsi_extended_event_item_t *)(p_assembled + 1);
+    p_out = (uint8_t *)(p_assembled->p_items + i_pieces);
+    for (int i = 0; i < i_pieces; i++)
+    {
+        dvbpsi_extended_event_item_t *p_item = &p_assembled->p_items[i];
+        p_item->p_description = ExtendedEventString(&p_out, p_items + pieces[i].i_description,
+                                                    pieces[i].i_description_length, b_utf8,
+                                                    &p_item->i_description_length);
+        p_item->p_item = ExtendedEventString(&p_out, p_items + pieces[i].i_item,
+                                             pieces[i].i_item_length, b_utf8,
+                                             &p_item->i_item_length);
+    }
+    p_assembled->p_text = ExtendedEventString(&p_out, p_text, i_text_size, b_utf8,
+                                              &p_assembled->i_text_length);
+    return p_assembled;
+}
+
+/*****************************************************************************
+ * dvbpsi_AssembleExtendedEventDr
+ *****************************************************************************/
+dvbpsi_extended_event_text_t * dvbpsi_AssembleExtendedEventDr(dvbpsi_descriptor_t * p_descriptors,
+                                                              const uint8_t * p_iso_639_code,
+                                                              bool b_utf8)
+{
+    extended_event_parts_t parts;
+
+    memset(&parts, 0, sizeof(parts));
+    if (p_iso_639_code)
+    {
+        memcpy(parts.i_iso_639_code, p_iso_639_code, 3);
+        parts.b_language = true;
+    }
+    for (dvbpsi_descriptor_t *p = p_descriptors; p; p = p->p_next)
+    {
+        if (p->i_tag == 0x4e && p->p_data)
+            ExtendedEventCollect(&parts, p->p_data, p->i_length);
+    }
+    for (int i = 0; i < 16; i++)
+        if (parts.p_body[i])
+            return ExtendedEventAssemble(&parts, b_utf8);
+    return NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_AssembleExtendedEventDrRaw
+ *****************************************************************************/
+dvbpsi_extended_event_text_t * dvbpsi_AssembleExtendedEventDrRaw(const uint8_t * p_loop,
+                                                                 size_t i_length,
+                                                                 const uint8_t * p_iso_639_code,
+                                                                 bool b_utf8)
+{
+    extended_event_parts_t parts;
+
+    memset(&parts, 0, sizeof(parts));
+    if (p_iso_639_code)
+    {
+        memcpy(parts.i_iso_639_code, p_iso_639_code, 3);
+        parts.b_language = true;
+    }
+    for (size_t i = 0; i + 2 <= i_length && i + 2 + p_loop[i + 1] <= i_length;
+         i += 2 + p_loop[i + 1])
+    {
+        if (p_loop[i] == 0x4e)
+            ExtendedEventCollect(&parts, &p_loop[i + 2], p_loop[i + 1]);
+    }
+    for (int i = 0; i < 16; i++)
+        if (parts.p_body[i])
+            return ExtendedEventAssemble(&parts, b_utf8);
+    return NULL;
+}
@@ -102,6 +102,91 @@ dvbpsi_extended_event_dr_t* dvbpsi_DecodeExtendedEventDr(dvbpsi_descriptor_t * p
 dvbpsi_descriptor_t * dvbpsi_GenExtendedEventDr(dvbpsi_extended_event_dr_t * p_decoded,
                                                 bool b_duplicate);
 
+/*****************************************************************************
+ * dvbpsi_extended_event_text_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_extended_event_item_s
+ * \brief An item of an extended event text.
+ */
+/*!
+ * \typedef struct dvbpsi_extended_event_item_s dvbpsi_extended_event_item_t
+ * \brief dvbpsi_extended_event_item_t type definition.
+ */
+typedef struct dvbpsi_extended_event_item_s
+{
+  size_t  i_description_length;             /*!< length of p_description */
+  uint8_t *p_description;                   /*!< zero terminated item
+                                                 description */
+  size_t  i_item_length;                    /*!< length of p_item */
+  uint8_t *p_item;                          /*!< zero terminated item */
+} dvbpsi_extended_event_item_t;
+
+/*!
+ * \struct dvbpsi_extended_event_text_s
+ * \brief The text of an event, assembled from its "extended event"
+ * descriptors.
+ *
+ * The structure and its strings are a single block of memory, freed with
+ * free(). The strings are zero terminated, either UTF-8 or the raw bytes
+ * with the character table selection of the first descriptor only.
+ */
+/*!
+ * \typedef struct dvbpsi_extended_event_text_s dvbpsi_extended_event_text_t
+ * \brief dvbpsi_extended_event_text_t type definition.
+ */
+typedef struct dvbpsi_extended_event_text_s
+{
+  uint8_t i_iso_639_code[3];                /*!< 3 letter ISO 639 language code */
+
+  int     i_item_count;                     /*!< number of items */
+  dvbpsi_extended_event_item_t *p_items;    /*!< the items */
+
+  size_t  i_text_length;                    /*!< length of p_text */
+  uint8_t *p_text;                          /*!< zero terminated text */
+} dvbpsi_extended_event_text_t;
+
+/*****************************************************************************
+ * dvbpsi_AssembleExtendedEventDr
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_extended_event_text_t * dvbpsi_AssembleExtendedEventDr(
+                        dvbpsi_descriptor_t * p_descriptors,
+                        const uint8_t * p_iso_639_code, bool b_utf8)
+ * \brief Assemble the text and items of the "extended event" descriptors of
+ * an event, in the order of their descriptor_number, without decoding them.
+ * An item whose description is empty continues the previous item.
+ * \param p_descriptors the descriptors of the event
+ * \param p_iso_639_code the language to assemble, NULL for the language of
+ * the first "extended event" descriptor
+ * \param b_utf8 if true then convert the strings to UTF-8, see charset.h
+ * \return the text, NULL if there is no such descriptor or on error
+ */
+dvbpsi_extended_event_text_t * dvbpsi_AssembleExtendedEventDr(dvbpsi_descriptor_t * p_descriptors,
+                                                              const uint8_t * p_iso_639_code,
+                                                              bool b_utf8);
+
+/*****************************************************************************
+ * dvbpsi_AssembleExtendedEventDrRaw
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_extended_event_text_t * dvbpsi_AssembleExtendedEventDrRaw(
+                        const uint8_t * p_loop, size_t i_length,
+                        const uint8_t * p_iso_639_code, bool b_utf8)
+ * \brief Same as dvbpsi_AssembleExtendedEventDr() for a descriptors loop
+ * still in its binary form, such as the events of epg.h.
+ * \param p_loop the descriptors loop
+ * \param i_length size of the loop
+ * \param p_iso_639_code the language to assemble, NULL for the language of
+ * the first "extended event" descriptor
+ * \param b_utf8 if true then convert the strings to UTF-8, see charset.h
+ * \return the text, NULL if there is no such descriptor or on error
+ */
+dvbpsi_extended_event_text_t * dvbpsi_AssembleExtendedEventDrRaw(const uint8_t * p_loop,
+                                                                 size_t i_length,
+                                                                 const uint8_t * p_iso_639_code,
+                                                                 bool b_utf8);
+
 
 #ifdef __cplusplus
 };
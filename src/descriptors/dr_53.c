@@ -54,7 +54,8 @@ dvbpsi_ca_identifier_dr_t * dvbpsi_DecodeCAIdentifierDr(dvbpsi_descriptor_t *p_d
     if (dvbpsi_IsDescriptorDecoded(p_descriptor))
         return p_descriptor->p_decoded;
 
-    if (p_descriptor->i_length < 1)
+    /* At least one CA_system_id */
+    if (p_descriptor->i_length < 2)
         return NULL;
 
     /* Allocate memory */
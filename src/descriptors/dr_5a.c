@@ -55,6 +55,10 @@ dvbpsi_terr_deliv_sys_dr_t * dvbpsi_DecodeTerrDelivSysDr(
     if (dvbpsi_IsDescriptorDecoded(p_descriptor))
         return p_descriptor->p_decoded;
 
+    /* Check the length */
+    if (p_descriptor->i_length < 11)
+        return NULL;
+
     /* Allocate memory */
     dvbpsi_terr_deliv_sys_dr_t * p_decoded;
     p_decoded = (dvbpsi_terr_deliv_sys_dr_t*)malloc(sizeof(dvbpsi_terr_deliv_sys_dr_t));
@@ -62,7 +66,7 @@ dvbpsi_terr_deliv_sys_dr_t * dvbpsi_DecodeTerrDelivSysDr(
         return NULL;
 
     /* Decode data */
-    p_decoded->i_centre_frequency      =    (uint32_t)(p_descriptor->p_data[0] << 24)
+    p_decoded->i_centre_frequency      =    ((uint32_t)p_descriptor->p_data[0] << 24)
                                           | (uint32_t)(p_descriptor->p_data[1] << 16)
                                           | (uint32_t)(p_descriptor->p_data[2] <<  8)
                                           | (uint32_t)(p_descriptor->p_data[3]);
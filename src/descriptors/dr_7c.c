@@ -231,7 +231,11 @@ dvbpsi_aac_dr_t *dvbpsi_DecodeAACDr(dvbpsi_descriptor_t *p_descriptor)
     if (dvbpsi_IsDescriptorDecoded(p_descriptor))
         return p_descriptor->p_decoded;
 
-    if (p_descriptor->i_length == 0x01)
+    /* profile_and_level, then the AAC_type if its flag is set */
+    if (p_descriptor->i_length < 1)
+        return NULL;
+    if (p_descriptor->i_length > 1 && (p_descriptor->p_data[1] & 0x80) &&
+        p_descriptor->i_length < 3)
         return NULL;
 
     /* Allocate memory */
@@ -259,6 +263,7 @@ dvbpsi_aac_dr_t *dvbpsi_DecodeAACDr(dvbpsi_descriptor_t *p_descriptor)
             free(p_decoded);
             return NULL;
         }
+        p_decoded = p_tmp;
         p_decoded->p_additional_info = ((uint8_t*)p_tmp + sizeof(dvbpsi_aac_dr_t));
         p_decoded->i_additional_info_length = i_info_length;
 
@@ -278,7 +283,11 @@ dvbpsi_aac_dr_t *dvbpsi_DecodeAACDr(dvbpsi_descriptor_t *p_descriptor)
 dvbpsi_descriptor_t *dvbpsi_GenAACDr(dvbpsi_aac_dr_t *p_decoded, bool b_duplicate)
 {
     /* Create the descriptor */
-    uint8_t i_length = p_decoded->b_type ? 3 + p_decoded->i_additional_info_length : 1;
+    unsigned int i_length = 1;
+    if (p_decoded->b_type || p_decoded->i_additional_info_length)
+        i_length = (p_decoded->b_type ? 3 : 2) + p_decoded->i_additional_info_length;
+    if (i_length > 255)
+        return NULL;
     dvbpsi_descriptor_t *p_descriptor = dvbpsi_NewDescriptor(0x7c, i_length, NULL);
     if (!p_descriptor)
         return NULL;
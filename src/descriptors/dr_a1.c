@@ -61,6 +61,8 @@ dvbpsi_DecodeServiceLocationDr (dvbpsi_descriptor_t * p_descriptor)
     /* Check length */
     if ((p_descriptor->i_length - 3) % 6)
         return NULL;
+    if (p_descriptor->i_length < 3 + buf[2] * 6)
+        return NULL;
 
     /* Allocate memory */
     p_decoded = (dvbpsi_service_location_dr_t *)
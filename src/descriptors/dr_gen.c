@@ -0,0 +1,790 @@
+/*****************************************************************************
+ * dr_gen.c
+ *
+ * This file is generated by applying the dr_codec.xsl stylesheet to the
+ * dr.xml description file. DO NOT EDIT !!!
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include "../dvbpsi.h"
+#include "../dvbpsi_private.h"
+#include "../descriptor.h"
+
+#include "dr_03.h"
+#include "dr_04.h"
+#include "dr_06.h"
+#include "dr_07.h"
+#include "dr_08.h"
+#include "dr_0b.h"
+#include "dr_0c.h"
+#include "dr_0e.h"
+#include "dr_0f.h"
+#include "dr_10.h"
+#include "dr_11.h"
+
+/*****************************************************************************
+ * dvbpsi_DecodeAStreamDr
+ *****************************************************************************/
+dvbpsi_astream_dr_t * dvbpsi_DecodeAStreamDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_astream_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x03))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 1)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_astream_dr_t*)malloc(sizeof(dvbpsi_astream_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->b_free_format = (p_data[0] & 0x80) ? true : false;
+    p_decoded->i_id = (p_data[0] & 0x40) >> 6;
+    p_decoded->i_layer = (p_data[0] & 0x30) >> 4;
+    p_decoded->b_variable_rate_audio_indicator = (p_data[0] & 0x08) ? true : false;
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenAStreamDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenAStreamDr(dvbpsi_astream_dr_t * p_decoded, bool b_duplicate)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x03, 1, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = (p_decoded->b_free_format ? 0x80 : 0)
+              | ((p_decoded->i_id << 6) & 0x40)
+              | ((p_decoded->i_layer << 4) & 0x30)
+              | (p_decoded->b_variable_rate_audio_indicator ? 0x08 : 0)
+              | 0x07;
+
+    if (b_duplicate)
+    {
+        /* Duplicate decoded data */
+        p_descriptor->p_decoded =
+                dvbpsi_DuplicateDecodedDescriptor(p_decoded,
+                                                  sizeof(dvbpsi_astream_dr_t));
+    }
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DecodeHierarchyDr
+ *****************************************************************************/
+dvbpsi_hierarchy_dr_t * dvbpsi_DecodeHierarchyDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_hierarchy_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x04))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 4)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_hierarchy_dr_t*)malloc(sizeof(dvbpsi_hierarchy_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->i_h_type = p_data[0] & 0x0f;
+    p_decoded->i_h_layer_index = p_data[1] & 0x3f;
+    p_decoded->i_h_embedded_layer = p_data[2] & 0x3f;
+    p_decoded->i_h_priority = p_data[3] & 0x3f;
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenHierarchyDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenHierarchyDr(dvbpsi_hierarchy_dr_t * p_decoded, bool b_duplicate)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x04, 4, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = 0xf0
+              | (p_decoded->i_h_type & 0x0f);
+    p_data[1] = 0xc0
+              | (p_decoded->i_h_layer_index & 0x3f);
+    p_data[2] = 0xc0
+              | (p_decoded->i_h_embedded_layer & 0x3f);
+    p_data[3] = 0xc0
+              | (p_decoded->i_h_priority & 0x3f);
+
+    if (b_duplicate)
+    {
+        /* Duplicate decoded data */
+        p_descriptor->p_decoded =
+                dvbpsi_DuplicateDecodedDescriptor(p_decoded,
+                                                  sizeof(dvbpsi_hierarchy_dr_t));
+    }
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DecodeDSAlignmentDr
+ *****************************************************************************/
+dvbpsi_ds_alignment_dr_t * dvbpsi_DecodeDSAlignmentDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_ds_alignment_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x06))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 1)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_ds_alignment_dr_t*)malloc(sizeof(dvbpsi_ds_alignment_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->i_alignment_type = p_data[0];
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenDSAlignmentDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenDSAlignmentDr(dvbpsi_ds_alignment_dr_t * p_decoded, bool b_duplicate)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x06, 1, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = (uint8_t)p_decoded->i_alignment_type;
+
+    if (b_duplicate)
+    {
+        /* Duplicate decoded data */
+        p_descriptor->p_decoded =
+                dvbpsi_DuplicateDecodedDescriptor(p_decoded,
+                                                  sizeof(dvbpsi_ds_alignment_dr_t));
+    }
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DecodeTargetBgGridDr
+ *****************************************************************************/
+dvbpsi_target_bg_grid_dr_t * dvbpsi_DecodeTargetBgGridDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_target_bg_grid_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x07))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 4)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_target_bg_grid_dr_t*)malloc(sizeof(dvbpsi_target_bg_grid_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->i_horizontal_size = ((uint32_t)p_data[0] << 6)
+            | (p_data[1] >> 2);
+    p_decoded->i_vertical_size = ((uint32_t)(p_data[1] & 0x03) << 12)
+            | ((uint32_t)p_data[2] << 4)
+            | (p_data[3] >> 4);
+    p_decoded->i_pel_aspect_ratio = p_data[3] & 0x0f;
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenTargetBgGridDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenTargetBgGridDr(dvbpsi_target_bg_grid_dr_t * p_decoded, bool b_duplicate)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x07, 4, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = (uint8_t)(p_decoded->i_horizontal_size >> 6);
+    p_data[1] = ((p_decoded->i_horizontal_size << 2) & 0xfc)
+              | ((p_decoded->i_vertical_size >> 12) & 0x03);
+    p_data[2] = (uint8_t)(p_decoded->i_vertical_size >> 4);
+    p_data[3] = ((p_decoded->i_vertical_size << 4) & 0xf0)
+              | (p_decoded->i_pel_aspect_ratio & 0x0f);
+
+    if (b_duplicate)
+    {
+        /* Duplicate decoded data */
+        p_descriptor->p_decoded =
+                dvbpsi_DuplicateDecodedDescriptor(p_decoded,
+                                                  sizeof(dvbpsi_target_bg_grid_dr_t));
+    }
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DecodeVWindowDr
+ *****************************************************************************/
+dvbpsi_vwindow_dr_t * dvbpsi_DecodeVWindowDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_vwindow_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x08))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 4)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_vwindow_dr_t*)malloc(sizeof(dvbpsi_vwindow_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->i_horizontal_offset = ((uint32_t)p_data[0] << 6)
+            | (p_data[1] >> 2);
+    p_decoded->i_vertical_offset = ((uint32_t)(p_data[1] & 0x03) << 12)
+            | ((uint32_t)p_data[2] << 4)
+            | (p_data[3] >> 4);
+    p_decoded->i_window_priority = p_data[3] & 0x0f;
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenVWindowDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenVWindowDr(dvbpsi_vwindow_dr_t * p_decoded, bool b_duplicate)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x08, 4, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = (uint8_t)(p_decoded->i_horizontal_offset >> 6);
+    p_data[1] = ((p_decoded->i_horizontal_offset << 2) & 0xfc)
+              | ((p_decoded->i_vertical_offset >> 12) & 0x03);
+    p_data[2] = (uint8_t)(p_decoded->i_vertical_offset >> 4);
+    p_data[3] = ((p_decoded->i_vertical_offset << 4) & 0xf0)
+              | (p_decoded->i_window_priority & 0x0f);
+
+    if (b_duplicate)
+    {
+        /* Duplicate decoded data */
+        p_descriptor->p_decoded =
+                dvbpsi_DuplicateDecodedDescriptor(p_decoded,
+                                                  sizeof(dvbpsi_vwindow_dr_t));
+    }
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DecodeSystemClockDr
+ *****************************************************************************/
+dvbpsi_system_clock_dr_t * dvbpsi_DecodeSystemClockDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_system_clock_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x0b))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 2)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_system_clock_dr_t*)malloc(sizeof(dvbpsi_system_clock_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->b_external_clock_ref = (p_data[0] & 0x80) ? true : false;
+    p_decoded->i_clock_accuracy_integer = p_data[0] & 0x3f;
+    p_decoded->i_clock_accuracy_exponent = (p_data[1] & 0xe0) >> 5;
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenSystemClockDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenSystemClockDr(dvbpsi_system_clock_dr_t * p_decoded, bool b_duplicate)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x0b, 2, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = (p_decoded->b_external_clock_ref ? 0x80 : 0)
+              | 0x40
+              | (p_decoded->i_clock_accuracy_integer & 0x3f);
+    p_data[1] = ((p_decoded->i_clock_accuracy_exponent << 5) & 0xe0)
+              | 0x1f;
+
+    if (b_duplicate)
+    {
+        /* Duplicate decoded data */
+        p_descriptor->p_decoded =
+                dvbpsi_DuplicateDecodedDescriptor(p_decoded,
+                                                  sizeof(dvbpsi_system_clock_dr_t));
+    }
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DecodeMxBuffUtilizationDr
+ *****************************************************************************/
+dvbpsi_mx_buff_utilization_dr_t * dvbpsi_DecodeMxBuffUtilizationDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_mx_buff_utilization_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x0c))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 3)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_mx_buff_utilization_dr_t*)malloc(sizeof(dvbpsi_mx_buff_utilization_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->b_mdv_valid = (p_data[0] & 0x80) ? true : false;
+    p_decoded->i_mx_delay_variation = ((uint32_t)(p_data[0] & 0x7f) << 8)
+            | p_data[1];
+    p_decoded->i_mx_strategy = (p_data[2] & 0xe0) >> 5;
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenMxBuffUtilizationDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenMxBuffUtilizationDr(dvbpsi_mx_buff_utilization_dr_t * p_decoded, bool b_duplicate)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x0c, 3, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = (p_decoded->b_mdv_valid ? 0x80 : 0)
+              | ((p_decoded->i_mx_delay_variation >> 8) & 0x7f);
+    p_data[1] = (uint8_t)p_decoded->i_mx_delay_variation;
+    p_data[2] = ((p_decoded->i_mx_strategy << 5) & 0xe0)
+              | 0x1f;
+
+    if (b_duplicate)
+    {
+        /* Duplicate decoded data */
+        p_descriptor->p_decoded =
+                dvbpsi_DuplicateDecodedDescriptor(p_decoded,
+                                                  sizeof(dvbpsi_mx_buff_utilization_dr_t));
+    }
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DecodeMaxBitrateDr
+ *****************************************************************************/
+dvbpsi_max_bitrate_dr_t * dvbpsi_DecodeMaxBitrateDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_max_bitrate_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x0e))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 3)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_max_bitrate_dr_t*)malloc(sizeof(dvbpsi_max_bitrate_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->i_max_bitrate = ((uint32_t)(p_data[0] & 0x3f) << 16)
+            | ((uint32_t)p_data[1] << 8)
+            | p_data[2];
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenMaxBitrateDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenMaxBitrateDr(dvbpsi_max_bitrate_dr_t * p_decoded, bool b_duplicate)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x0e, 3, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = 0xc0
+              | ((p_decoded->i_max_bitrate >> 16) & 0x3f);
+    p_data[1] = (uint8_t)(p_decoded->i_max_bitrate >> 8);
+    p_data[2] = (uint8_t)p_decoded->i_max_bitrate;
+
+    if (b_duplicate)
+    {
+        /* Duplicate decoded data */
+        p_descriptor->p_decoded =
+                dvbpsi_DuplicateDecodedDescriptor(p_decoded,
+                                                  sizeof(dvbpsi_max_bitrate_dr_t));
+    }
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DecodePrivateDataDr
+ *****************************************************************************/
+dvbpsi_private_data_dr_t * dvbpsi_DecodePrivateDataDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_private_data_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x0f))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 4)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_private_data_dr_t*)malloc(sizeof(dvbpsi_private_data_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->i_private_data = ((uint32_t)p_data[0] << 24)
+            | ((uint32_t)p_data[1] << 16)
+            | ((uint32_t)p_data[2] << 8)
+            | p_data[3];
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenPrivateDataDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenPrivateDataDr(dvbpsi_private_data_dr_t * p_decoded, bool b_duplicate)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x0f, 4, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = (uint8_t)(p_decoded->i_private_data >> 24);
+    p_data[1] = (uint8_t)(p_decoded->i_private_data >> 16);
+    p_data[2] = (uint8_t)(p_decoded->i_private_data >> 8);
+    p_data[3] = (uint8_t)p_decoded->i_private_data;
+
+    if (b_duplicate)
+    {
+        /* Duplicate decoded data */
+        p_descriptor->p_decoded =
+                dvbpsi_DuplicateDecodedDescriptor(p_decoded,
+                                                  sizeof(dvbpsi_private_data_dr_t));
+    }
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DecodeSmoothingBufferDr
+ *****************************************************************************/
+dvbpsi_smoothing_buffer_dr_t * dvbpsi_DecodeSmoothingBufferDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_smoothing_buffer_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x10))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 6)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_smoothing_buffer_dr_t*)malloc(sizeof(dvbpsi_smoothing_buffer_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->i_sb_leak_rate = ((uint32_t)(p_data[0] & 0x3f) << 16)
+            | ((uint32_t)p_data[1] << 8)
+            | p_data[2];
+    p_decoded->i_sb_size = ((uint32_t)(p_data[3] & 0x3f) << 16)
+            | ((uint32_t)p_data[4] << 8)
+            | p_data[5];
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenSmoothingBufferDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenSmoothingBufferDr(dvbpsi_smoothing_buffer_dr_t * p_decoded)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x10, 6, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = 0xc0
+              | ((p_decoded->i_sb_leak_rate >> 16) & 0x3f);
+    p_data[1] = (uint8_t)(p_decoded->i_sb_leak_rate >> 8);
+    p_data[2] = (uint8_t)p_decoded->i_sb_leak_rate;
+    p_data[3] = 0xc0
+              | ((p_decoded->i_sb_size >> 16) & 0x3f);
+    p_data[4] = (uint8_t)(p_decoded->i_sb_size >> 8);
+    p_data[5] = (uint8_t)p_decoded->i_sb_size;
+
+    return p_descriptor;
+}
+
+/*****************************************************************************
+ * dvbpsi_DecodeSTDDr
+ *****************************************************************************/
+dvbpsi_std_dr_t * dvbpsi_DecodeSTDDr(dvbpsi_descriptor_t * p_descriptor)
+{
+    dvbpsi_std_dr_t * p_decoded;
+    const uint8_t * p_data;
+
+    /* Check the tag */
+    if (!dvbpsi_CanDecodeAsDescriptor(p_descriptor, 0x11))
+        return NULL;
+
+    /* Don't decode twice */
+    if (dvbpsi_IsDescriptorDecoded(p_descriptor))
+        return p_descriptor->p_decoded;
+
+    /* The fields have fixed offsets, this is the only check */
+    if (p_descriptor->i_length != 1)
+        return NULL;
+
+    /* Allocate memory */
+    p_decoded = (dvbpsi_std_dr_t*)malloc(sizeof(dvbpsi_std_dr_t));
+    if (!p_decoded)
+        return NULL;
+
+    /* Decode data */
+    p_data = p_descriptor->p_data;
+    p_decoded->b_leak_valid_flag = (p_data[0] & 0x01) ? true : false;
+
+    p_descriptor->p_decoded = (void*)p_decoded;
+
+    return p_decoded;
+}
+
+/*****************************************************************************
+ * dvbpsi_GenSTDDr
+ *****************************************************************************/
+dvbpsi_descriptor_t * dvbpsi_GenSTDDr(dvbpsi_std_dr_t * p_decoded)
+{
+    uint8_t * p_data;
+
+    /* Create the descriptor */
+    dvbpsi_descriptor_t * p_descriptor =
+            dvbpsi_NewDescriptor(0x11, 1, NULL);
+    if (!p_descriptor)
+        return NULL;
+
+    /* Encode data, the reserved bits are set to one */
+    p_data = p_descriptor->p_data;
+    p_data[0] = 0xfe
+              | (p_decoded->b_leak_valid_flag ? 0x01 : 0);
+
+    return p_descriptor;
+}
@@ -45,6 +45,14 @@
 #include "dvbpsi_private.h"
 #include "psi.h"
 
+/* A tap of a handle, see dvbpsi_section_tap_add() */
+struct dvbpsi_section_tap_s
+{
+    dvbpsi_section_tap_cb   pf_tap;
+    void                   *p_cb_data;
+    dvbpsi_section_tap_t   *p_next;
+};
+
 /*****************************************************************************
  * dvbpsi_new
  *****************************************************************************/
@@ -67,11 +75,126 @@ void dvbpsi_delete(dvbpsi_t *p_dvbpsi)
 {
     if (p_dvbpsi) {
         assert(p_dvbpsi->p_decoder == NULL);
+        assert(p_dvbpsi->p_held_first == NULL);
+        while (p_dvbpsi->p_section_taps)
+        {
+            dvbpsi_section_tap_t *p_next = p_dvbpsi->p_section_taps->p_next;
+            free(p_dvbpsi->p_section_taps);
+            p_dvbpsi->p_section_taps = p_next;
+        }
         p_dvbpsi->pf_message = NULL;
     }
     free(p_dvbpsi);
 }
 
+/*****************************************************************************
+ * Memory budget
+ *****************************************************************************
+ * The decoders whose p_sections is not empty are linked in their handle, from
+ * the least to the most recently fed. A section is accounted with the memory
+ * dvbpsi_packet_push() allocated for it.
+ *****************************************************************************/
+static void dvbpsi_HeldUnlink(dvbpsi_t *p_dvbpsi, dvbpsi_decoder_t *p_decoder)
+{
+    if (p_decoder->p_held_prev)
+        p_decoder->p_held_prev->p_held_next = p_decoder->p_held_next;
+    else
+        p_dvbpsi->p_held_first = p_decoder->p_held_next;
+    if (p_decoder->p_held_next)
+        p_decoder->p_held_next->p_held_prev = p_decoder->p_held_prev;
+    else
+        p_dvbpsi->p_held_last = p_decoder->p_held_prev;
+
+    p_decoder->p_held_prev = NULL;
+    p_decoder->p_held_next = NULL;
+    p_dvbpsi->i_held -= p_decoder->i_held;
+}
+
+static void dvbpsi_HeldAppend(dvbpsi_t *p_dvbpsi, dvbpsi_decoder_t *p_decoder)
+{
+    p_decoder->p_held_prev = p_dvbpsi->p_held_last;
+    p_decoder->p_held_next = NULL;
+    if (p_dvbpsi->p_held_last)
+        p_dvbpsi->p_held_last->p_held_next = p_decoder;
+    else
+        p_dvbpsi->p_held_first = p_decoder;
+    p_dvbpsi->p_held_last = p_decoder;
+    p_dvbpsi->i_held += p_decoder->i_held;
+}
+
+/* Memory of a section, allocated by the decoder of the handle */
+static size_t dvbpsi_HeldSize(const dvbpsi_decoder_t *p_decoder)
+{
+    const dvbpsi_t *p_dvbpsi = p_decoder->p_dvbpsi;
+
+    if (p_dvbpsi && p_dvbpsi->p_decoder)
+        p_decoder = p_dvbpsi->p_decoder;
+    return sizeof(dvbpsi_psi_section_t) + p_decoder->i_section_max_size;
+}
+
+/* Forget the sections of a decoder */
+static void dvbpsi_HeldClear(dvbpsi_decoder_t *p_decoder)
+{
+    if (p_decoder->p_dvbpsi && p_decoder->i_held)
+        dvbpsi_HeldUnlink(p_decoder->p_dvbpsi, p_decoder);
+    p_decoder->i_held = 0;
+}
+
+/* Drop the incomplete tables over budget or timed out, but p_keep */
+static void dvbpsi_HeldExpire(dvbpsi_t *p_dvbpsi, const dvbpsi_decoder_t *p_keep)
+{
+    dvbpsi_decoder_t *p_decoder = p_dvbpsi->p_held_first;
+
+    while (p_decoder)
+    {
+        dvbpsi_decoder_t *p_next = p_decoder->p_held_next;
+        const char *psz_reason;
+
+        if (p_decoder == p_keep)
+            psz_reason = NULL;
+        else if (p_dvbpsi->i_budget && p_dvbpsi->i_held > p_dvbpsi->i_budget)
+            psz_reason = "over budget";
+        else if (p_dvbpsi->i_section_timeout > 0
+              && p_dvbpsi->i_time - p_decoder->i_held_time >= p_dvbpsi->i_section_timeout)
+            psz_reason = "timed out";
+        else
+            break;
+
+        if (psz_reason)
+        {
+            dvbpsi_warning(p_dvbpsi, "PSI decoder",
+                           "dropping incomplete table 0x%x extension %d, %s",
+                           p_decoder->p_sections->i_table_id,
+                           p_decoder->p_sections->i_extension, psz_reason);
+            dvbpsi_HeldClear(p_decoder);
+            dvbpsi_DeletePSISections(p_decoder->p_sections);
+            p_decoder->p_sections = NULL;
+            p_dvbpsi->i_evicted++;
+        }
+        p_decoder = p_next;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_set_budget
+ *****************************************************************************/
+void dvbpsi_set_budget(dvbpsi_t *p_dvbpsi, size_t i_budget, int64_t i_timeout)
+{
+    p_dvbpsi->i_budget = i_budget;
+    p_dvbpsi->i_section_timeout = i_timeout;
+    dvbpsi_HeldExpire(p_dvbpsi, NULL);
+}
+
+/*****************************************************************************
+ * dvbpsi_set_time
+ *****************************************************************************/
+void dvbpsi_set_time(dvbpsi_t *p_dvbpsi, int64_t i_time)
+{
+    p_dvbpsi->i_time = i_time;
+    if (p_dvbpsi->p_held_first)
+        dvbpsi_HeldExpire(p_dvbpsi, NULL);
+}
+
 /*****************************************************************************
  * dvbpsi_decoder_new
  *****************************************************************************/
@@ -113,6 +236,7 @@ void dvbpsi_decoder_reset(dvbpsi_decoder_t* p_decoder, const bool b_force)
         p_decoder->b_current_valid = false;
 
     /* Clear the section array */
+    dvbpsi_HeldClear(p_decoder);
     dvbpsi_DeletePSISections(p_decoder->p_sections);
     p_decoder->p_sections = NULL;
 }
@@ -151,19 +275,19 @@ bool dvbpsi_decoder_psi_section_add(dvbpsi_decoder_t *p_decoder, dvbpsi_psi_sect
     assert(p_section);
     assert(p_section->p_next == NULL);
 
+    dvbpsi_psi_section_t *p = p_decoder->p_sections;
+    dvbpsi_psi_section_t *p_prev = NULL;
+    bool b_overwrite = false;
+
     /* Empty list */
     if (!p_decoder->p_sections)
     {
         p_decoder->p_sections = p_section;
         p_section->p_next = NULL;
-        return false;
+        goto out;
     }
 
     /* Insert in right place */
-    dvbpsi_psi_section_t *p = p_decoder->p_sections;
-    dvbpsi_psi_section_t *p_prev = NULL;
-    bool b_overwrite = false;
-
     while (p)
     {
         if (p->i_number == p_section->i_number)
@@ -216,6 +340,17 @@ bool dvbpsi_decoder_psi_section_add(dvbpsi_decoder_t *p_decoder, dvbpsi_psi_sect
     }
 
 out:
+    /* Account the section to the handle, most recently fed last */
+    if (p_decoder->p_dvbpsi && p_decoder->i_held)
+        dvbpsi_HeldUnlink(p_decoder->p_dvbpsi, p_decoder);
+    if (!b_overwrite)
+        p_decoder->i_held += dvbpsi_HeldSize(p_decoder);
+    if (p_decoder->p_dvbpsi)
+    {
+        p_decoder->i_held_time = p_decoder->p_dvbpsi->i_time;
+        dvbpsi_HeldAppend(p_decoder->p_dvbpsi, p_decoder);
+        dvbpsi_HeldExpire(p_decoder->p_dvbpsi, p_decoder);
+    }
     return b_overwrite;
 }
 
@@ -226,6 +361,7 @@ void dvbpsi_decoder_delete(dvbpsi_decoder_t *p_decoder)
 {
     assert(p_decoder);
 
+    dvbpsi_HeldClear(p_decoder);
     if (p_decoder->p_sections)
     {
         dvbpsi_DeletePSISections(p_decoder->p_sections);
@@ -247,6 +383,142 @@ bool dvbpsi_decoder_present(dvbpsi_t *p_dvbpsi)
         return false;
 }
 
+/*****************************************************************************
+ * dvbpsi_SectionComplete
+ *****************************************************************************
+ * Check a complete section, fill its header fields and hand it over to the
+ * decoder, or trash it.
+ *****************************************************************************/
+static void dvbpsi_SectionComplete(dvbpsi_t *p_dvbpsi, dvbpsi_decoder_t *p_decoder,
+                                   dvbpsi_psi_section_t *p_section)
+{
+    bool b_valid_crc32 = false;
+    bool has_crc32;
+
+    p_section->i_table_id = p_section->p_data[0];
+    p_section->b_syntax_indicator = p_section->p_data[1] & 0x80;
+    p_section->b_private_indicator = p_section->p_data[1] & 0x40;
+
+    /* Update the end of the payload if CRC_32 is present */
+    has_crc32 = dvbpsi_has_CRC32(p_section);
+    if (p_section->b_syntax_indicator || has_crc32)
+        p_section->p_payload_end -= 4;
+
+    /* Check CRC32 if present */
+    if (has_crc32)
+        b_valid_crc32 = dvbpsi_ValidPSISection(p_section);
+
+    if (!has_crc32 || b_valid_crc32)
+    {
+        /* PSI section is valid */
+        if (p_section->b_syntax_indicator)
+        {
+            p_section->i_extension =  (p_section->p_data[3] << 8)
+                                     | p_section->p_data[4];
+            p_section->i_version = (p_section->p_data[5] & 0x3e) >> 1;
+            p_section->b_current_next = p_section->p_data[5] & 0x1;
+            p_section->i_number = p_section->p_data[6];
+            p_section->i_last_number = p_section->p_data[7];
+            p_section->p_payload_start = p_section->p_data + 8;
+        }
+        else
+        {
+            p_section->i_extension = 0;
+            p_section->i_version = 0;
+            p_section->b_current_next = true;
+            p_section->i_number = 0;
+            p_section->i_last_number = 0;
+            p_section->p_payload_start = p_section->p_data + 3;
+        }
+        p_decoder->p_dvbpsi = p_dvbpsi;
+        for (dvbpsi_section_tap_t *p_tap = p_dvbpsi->p_section_taps; p_tap; p_tap = p_tap->p_next)
+            p_tap->pf_tap(p_dvbpsi, p_section, p_tap->p_cb_data);
+        if (p_decoder->pf_gather)
+            p_decoder->pf_gather(p_dvbpsi, p_section);
+        else
+            dvbpsi_DeletePSISections(p_section);
+    }
+    else
+    {
+        if (has_crc32 && !b_valid_crc32)
+            dvbpsi_error(p_dvbpsi, "misc PSI", "Bad CRC_32 table 0x%x !!!",
+                                   p_section->p_data[0]);
+        else
+            dvbpsi_error(p_dvbpsi, "misc PSI", "table 0x%x", p_section->p_data[0]);
+
+        /* PSI section isn't valid => trash it */
+        dvbpsi_DeletePSISections(p_section);
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_section_tap_add
+ *****************************************************************************/
+bool dvbpsi_section_tap_add(dvbpsi_t *p_dvbpsi, dvbpsi_section_tap_cb pf_tap, void *p_cb_data)
+{
+    assert(pf_tap);
+
+    dvbpsi_section_tap_t *p_tap = malloc(sizeof(dvbpsi_section_tap_t));
+    if (!p_tap)
+        return false;
+
+    p_tap->pf_tap = pf_tap;
+    p_tap->p_cb_data = p_cb_data;
+    p_tap->p_next = NULL;
+
+    dvbpsi_section_tap_t **pp_last = &p_dvbpsi->p_section_taps;
+    while (*pp_last)
+        pp_last = &(*pp_last)->p_next;
+    *pp_last = p_tap;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_section_tap_remove
+ *****************************************************************************/
+void dvbpsi_section_tap_remove(dvbpsi_t *p_dvbpsi, dvbpsi_section_tap_cb pf_tap, void *p_cb_data)
+{
+    for (dvbpsi_section_tap_t **pp_tap = &p_dvbpsi->p_section_taps; *pp_tap;
+         pp_tap = &(*pp_tap)->p_next)
+    {
+        dvbpsi_section_tap_t *p_tap = *pp_tap;
+        if (p_tap->pf_tap != pf_tap || p_tap->p_cb_data != p_cb_data)
+            continue;
+        *pp_tap = p_tap->p_next;
+        free(p_tap);
+        return;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_section_push
+ *****************************************************************************
+ * Injection of a complete section into a PSI decoder.
+ *****************************************************************************/
+bool dvbpsi_section_push(dvbpsi_t *p_dvbpsi, const uint8_t *p_data, size_t i_size)
+{
+    dvbpsi_decoder_t *p_decoder = p_dvbpsi->p_decoder;
+    dvbpsi_psi_section_t *p_section;
+    assert(p_decoder);
+
+    if (i_size < 3 || i_size > (size_t)p_decoder->i_section_max_size
+     || i_size != 3 + ((((size_t)p_data[1] & 0xf) << 8) | p_data[2]))
+    {
+        dvbpsi_error(p_dvbpsi, "PSI decoder", "invalid section size %zu", i_size);
+        return false;
+    }
+
+    p_section = dvbpsi_NewPSISection(p_decoder->i_section_max_size);
+    if (!p_section)
+        return false;
+    memcpy(p_section->p_data, p_data, i_size);
+    p_section->p_payload_end = p_section->p_data + i_size;
+    p_section->i_length = i_size - 3;
+
+    dvbpsi_SectionComplete(p_dvbpsi, p_decoder, p_section);
+    return true;
+}
+
 /*****************************************************************************
  * dvbpsi_packet_push
  *****************************************************************************
@@ -404,61 +676,9 @@ bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data)
             }
             else
             {
-                bool b_valid_crc32 = false;
-                bool has_crc32;
-
                 /* PSI section is complete */
-                p_section->i_table_id = p_section->p_data[0];
-                p_section->b_syntax_indicator = p_section->p_data[1] & 0x80;
-                p_section->b_private_indicator = p_section->p_data[1] & 0x40;
-
-                /* Update the end of the payload if CRC_32 is present */
-                has_crc32 = dvbpsi_has_CRC32(p_section);
-                if (p_section->b_syntax_indicator || has_crc32)
-                    p_section->p_payload_end -= 4;
-
-                /* Check CRC32 if present */
-                if (has_crc32)
-                    b_valid_crc32 = dvbpsi_ValidPSISection(p_section);
-
-                if (!has_crc32 || b_valid_crc32)
-                {
-                    /* PSI section is valid */
-                    if (p_section->b_syntax_indicator)
-                    {
-                        p_section->i_extension =  (p_section->p_data[3] << 8)
-                                                 | p_section->p_data[4];
-                        p_section->i_version = (p_section->p_data[5] & 0x3e) >> 1;
-                        p_section->b_current_next = p_section->p_data[5] & 0x1;
-                        p_section->i_number = p_section->p_data[6];
-                        p_section->i_last_number = p_section->p_data[7];
-                        p_section->p_payload_start = p_section->p_data + 8;
-                    }
-                    else
-                    {
-                        p_section->i_extension = 0;
-                        p_section->i_version = 0;
-                        p_section->b_current_next = true;
-                        p_section->i_number = 0;
-                        p_section->i_last_number = 0;
-                        p_section->p_payload_start = p_section->p_data + 3;
-                    }
-                    if (p_decoder->pf_gather)
-                        p_decoder->pf_gather(p_dvbpsi, p_section);
-                    p_decoder->p_current_section = NULL;
-                }
-                else
-                {
-                    if (has_crc32 && !dvbpsi_ValidPSISection(p_section))
-                        dvbpsi_error(p_dvbpsi, "misc PSI", "Bad CRC_32 table 0x%x !!!",
-                                               p_section->p_data[0]);
-                    else
-                        dvbpsi_error(p_dvbpsi, "misc PSI", "table 0x%x", p_section->p_data[0]);
-
-                    /* PSI section isn't valid => trash it */
-                    dvbpsi_DeletePSISections(p_section);
-                    p_decoder->p_current_section = NULL;
-                }
+                p_decoder->p_current_section = NULL;
+                dvbpsi_SectionComplete(p_dvbpsi, p_decoder, p_section);
 
                 /* A TS packet may contain any number of sections, only the first
                  * new one is flagged by the pointer_field. If the next payload
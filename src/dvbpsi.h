@@ -65,6 +65,35 @@ extern "C" {
  */
 typedef struct dvbpsi_s dvbpsi_t;
 
+/*****************************************************************************
+ * dvbpsi_psi_section_t
+ *****************************************************************************/
+
+/*!
+ * \typedef struct dvbpsi_psi_section_s dvbpsi_psi_section_t
+ * \brief dvbpsi_psi_section_t type definition.
+ */
+typedef struct dvbpsi_psi_section_s dvbpsi_psi_section_t;
+
+/*****************************************************************************
+ * dvbpsi_section_tap_cb
+ *****************************************************************************/
+/*!
+ * \typedef void (* dvbpsi_section_tap_cb)(dvbpsi_t *p_dvbpsi,
+                        const dvbpsi_psi_section_t *p_section, void *p_cb_data)
+ * \brief Callback seeing the valid sections of a handle, see
+ * dvbpsi_section_tap_add().
+ */
+typedef void (* dvbpsi_section_tap_cb)(dvbpsi_t *p_dvbpsi,
+                                       const dvbpsi_psi_section_t *p_section,
+                                       void *p_cb_data);
+
+/*!
+ * \typedef struct dvbpsi_section_tap_s dvbpsi_section_tap_t
+ * \brief Private tap of a handle, see dvbpsi_section_tap_add().
+ */
+typedef struct dvbpsi_section_tap_s dvbpsi_section_tap_t;
+
 /*!
  * \enum dvbpsi_msg_level
  * \brief DVBPSI message level enumeration type
@@ -152,6 +181,30 @@ struct dvbpsi_s
                                                           from caller. Do not use
                                                           from inside libdvbpsi. It
                                                           will crash any application. */
+
+    /* Section taps, see dvbpsi_section_tap_add() */
+    dvbpsi_section_tap_t         *p_section_taps;       /*!< section taps, in
+                                                          the order they were
+                                                          added */
+
+    /* Memory budget, see dvbpsi_set_budget() */
+    size_t                        i_budget;             /*!< bytes the incomplete
+                                                          tables may hold, 0 for
+                                                          no limit */
+    int64_t                       i_section_timeout;    /*!< time without section
+                                                          before an incomplete
+                                                          table is dropped, 0 for
+                                                          none */
+    int64_t                       i_time;               /*!< current time, see
+                                                          dvbpsi_set_time() */
+    size_t                        i_held;               /*!< bytes held by the
+                                                          incomplete tables */
+    uint64_t                      i_evicted;            /*!< number of incomplete
+                                                          tables dropped */
+    dvbpsi_decoder_t             *p_held_first;         /*!< least recently fed
+                                                          decoder holding sections */
+    dvbpsi_decoder_t             *p_held_last;          /*!< most recently fed
+                                                          decoder holding sections */
 };
 
 /*****************************************************************************
@@ -199,14 +252,93 @@ void dvbpsi_delete(dvbpsi_t *p_dvbpsi);
 bool dvbpsi_packet_push(dvbpsi_t *p_dvbpsi, uint8_t* p_data);
 
 /*****************************************************************************
- * dvbpsi_psi_section_t
+ * dvbpsi_section_push
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_section_push(dvbpsi_t *p_dvbpsi, const uint8_t *p_data,
+                                size_t i_size)
+ * \brief Injection of a complete PSI section into a PSI decoder, for
+ * instance a section saved from an earlier run. The section is checked and
+ * handled as if it had been received in TS packets, without affecting the
+ * section the decoder may be gathering from the packets.
+ * \param p_dvbpsi handle to dvbpsi with attached decoder
+ * \param p_data the section, from its table_id
+ * \param i_size size of the section, matching its section_length
+ * \return false when the section size is invalid or on allocation failure
+ */
+bool dvbpsi_section_push(dvbpsi_t *p_dvbpsi, const uint8_t *p_data, size_t i_size);
+
+/*****************************************************************************
+ * dvbpsi_section_tap_add
  *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_section_tap_add(dvbpsi_t *p_dvbpsi,
+                                   dvbpsi_section_tap_cb pf_tap, void *p_cb_data)
+ * \brief Add a callback called with each valid section of a handle before
+ * it is handed over to the decoder, repetitions included. A handle may have
+ * several taps, called in the order they were added. The section must not
+ * be kept after the callback returns, and the callback must not add or
+ * remove taps of the handle.
+ * \param p_dvbpsi handle to dvbpsi
+ * \param pf_tap the callback
+ * \param p_cb_data private data given to the callback
+ * \return false on allocation failure
+ */
+bool dvbpsi_section_tap_add(dvbpsi_t *p_dvbpsi, dvbpsi_section_tap_cb pf_tap, void *p_cb_data);
 
+/*****************************************************************************
+ * dvbpsi_section_tap_remove
+ *****************************************************************************/
 /*!
- * \typedef struct dvbpsi_psi_section_s dvbpsi_psi_section_t
- * \brief dvbpsi_psi_section_t type definition.
+ * \fn void dvbpsi_section_tap_remove(dvbpsi_t *p_dvbpsi,
+                                      dvbpsi_section_tap_cb pf_tap, void *p_cb_data)
+ * \brief Remove a tap added by dvbpsi_section_tap_add() with the same
+ * callback and private data. The other taps of the handle are kept.
+ * \param p_dvbpsi handle to dvbpsi
+ * \param pf_tap the callback
+ * \param p_cb_data private data given to the callback
+ * \return nothing
  */
-typedef struct dvbpsi_psi_section_s dvbpsi_psi_section_t;
+void dvbpsi_section_tap_remove(dvbpsi_t *p_dvbpsi, dvbpsi_section_tap_cb pf_tap, void *p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_set_budget
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_set_budget(dvbpsi_t *p_dvbpsi, size_t i_budget,
+                              int64_t i_timeout)
+ * \brief Bound the memory held by the incomplete tables of a handle, its
+ * decoder and all the subtable decoders of its demux.
+ *
+ * The sections of a table are kept until the table is complete. When they
+ * take more than i_budget bytes, the sections of the least recently fed
+ * table are dropped until they fit again, and the sections of a table which
+ * has not been fed for i_timeout are dropped too. The table is then gathered
+ * again from its next sections. The table being fed is never dropped, so
+ * that a budget smaller than one table is exceeded by the size of that
+ * table. dvbpsi_t::i_held and dvbpsi_decoder_t::i_held give the memory held
+ * and dvbpsi_t::i_evicted the number of tables dropped.
+ * \param p_dvbpsi handle to dvbpsi
+ * \param i_budget bytes held at most, 0 for no limit
+ * \param i_timeout time without section, in the unit of dvbpsi_set_time(),
+ * 0 to keep the tables until they complete
+ * \return nothing
+ */
+void dvbpsi_set_budget(dvbpsi_t *p_dvbpsi, size_t i_budget, int64_t i_timeout);
+
+/*****************************************************************************
+ * dvbpsi_set_time
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_set_time(dvbpsi_t *p_dvbpsi, int64_t i_time)
+ * \brief Set the arrival time of the next packets or sections of a handle,
+ * for the timeout of dvbpsi_set_budget(), and drop the tables which timed
+ * out.
+ * \param p_dvbpsi handle to dvbpsi
+ * \param i_time the time, for instance in microseconds, never decreasing
+ * \return nothing
+ */
+void dvbpsi_set_time(dvbpsi_t *p_dvbpsi, int64_t i_time);
 
 /*****************************************************************************
  * dvbpsi_callback_gather_t
@@ -245,6 +377,11 @@ typedef void (* dvbpsi_callback_gather_t)(dvbpsi_t *p_dvbpsi,  /*!< pointer to d
     dvbpsi_callback_gather_t  pf_gather;/*!< PSI decoder's callback */            \
     int      i_section_max_size;   /*!< Max size of a section for this decoder */ \
     int      i_need;               /*!< Bytes needed */                           \
+    dvbpsi_t *p_dvbpsi;            /*!< Handle accounting p_sections */           \
+    size_t   i_held;               /*!< Bytes held by p_sections */               \
+    int64_t  i_held_time;          /*!< Time of the last section held */          \
+    dvbpsi_decoder_t *p_held_prev; /*!< Previous decoder holding sections */      \
+    dvbpsi_decoder_t *p_held_next; /*!< Next decoder holding sections */          \
 /**@}*/
 
 /*****************************************************************************
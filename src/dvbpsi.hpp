@@ -0,0 +1,838 @@
+/*****************************************************************************
+ * dvbpsi.hpp: C++ binding
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <dvbpsi.hpp>
+ * \brief Header only C++17 binding of the decoders.
+ *
+ * dvbpsi::handle owns a dvbpsi_t handle and the decoder attached to it, and
+ * detaches and deletes them when it is destroyed. The decoded tables are
+ * given to the callbacks as dvbpsi::table_ptr, which deletes them. The
+ * callbacks may be any invocable, moved into the handle once when the
+ * decoder is attached and called without any other indirection than the C
+ * callback. They run inside push() and must not throw.
+ *
+ * The lists of the tables (programs, elementary streams, services, events,
+ * transport streams, descriptors, sections) are forward ranges, and
+ * dvbpsi::decode<0x48>(d) calls the decoder of the descriptor tag given at
+ * compile time:
+ *
+ *   dvbpsi::handle sdt;
+ *   sdt.attach_demux([](dvbpsi::demux &demux, uint8_t i_table_id,
+ *                       uint16_t i_extension) {
+ *       if (i_table_id == 0x42)
+ *           demux.attach_sdt(i_table_id, i_extension,
+ *                            [](dvbpsi::table_ptr<dvbpsi_sdt_t> p_sdt) {
+ *               for (dvbpsi_sdt_service_t &service : dvbpsi::services(*p_sdt))
+ *                   for (dvbpsi_descriptor_t &d : dvbpsi::descriptors(service))
+ *                       if (auto *p_service = dvbpsi::decode<0x48>(d))
+ *                           ...
+ *           });
+ *   });
+ *   sdt.push_packets(dvbpsi::bytes(p_buffer, i_size));
+ *
+ * Everything is inline: the functions compile to the calls to the C API a
+ * hand written caller would make.
+ */
+
+#ifndef _DVBPSI_DVBPSI_HPP_
+#define _DVBPSI_DVBPSI_HPP_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#if __has_include(<span>)
+# include <span>
+#endif
+
+#include "dvbpsi.h"
+#include "psi.h"
+#include "descriptor.h"
+#include "demux.h"
+
+/* The table and descriptor headers are in subdirectories of the source tree
+ * and next to this one once installed */
+#define DVBPSI_HPP_STR(h) #h
+#if __has_include("tables/pat.h")
+# include "tables/pat.h"
+# include "tables/pmt.h"
+# include "tables/cat.h"
+# include "tables/rst.h"
+# include "tables/sdt.h"
+# include "tables/eit.h"
+# include "tables/nit.h"
+# include "tables/bat.h"
+# include "tables/tot.h"
+# include "tables/sis.h"
+# define DVBPSI_HPP_DR(h) DVBPSI_HPP_STR(descriptors/h)
+#else
+# include "pat.h"
+# include "pmt.h"
+# include "cat.h"
+# include "rst.h"
+# include "sdt.h"
+# include "eit.h"
+# include "nit.h"
+# include "bat.h"
+# include "tot.h"
+# include "sis.h"
+# define DVBPSI_HPP_DR(h) DVBPSI_HPP_STR(h)
+#endif
+
+namespace dvbpsi {
+
+template<typename F> struct demux_callback;
+
+/*****************************************************************************
+ * bytes
+ *****************************************************************************/
+/*!
+ * \typedef bytes
+ * \brief Read-only view of TS packets or of a section: std::span in C++20,
+ * a minimal replacement before.
+ */
+#if defined(__cpp_lib_span)
+using bytes = std::span<const uint8_t>;
+#else
+class bytes
+{
+public:
+    constexpr bytes() noexcept : p_data(nullptr), i_size(0) {}
+    constexpr bytes(const uint8_t *p, std::size_t i) noexcept : p_data(p), i_size(i) {}
+    template<std::size_t N>
+    constexpr bytes(const uint8_t (&p)[N]) noexcept : p_data(p), i_size(N) {}
+    template<typename C, typename = decltype(std::declval<const C &>().data())>
+    constexpr bytes(const C &c) noexcept : p_data(c.data()), i_size(c.size()) {}
+
+    constexpr const uint8_t *data() const noexcept { return p_data; }
+    constexpr std::size_t size() const noexcept { return i_size; }
+    constexpr const uint8_t *begin() const noexcept { return p_data; }
+    constexpr const uint8_t *end() const noexcept { return p_data + i_size; }
+    constexpr bytes subspan(std::size_t i_offset, std::size_t i_count) const noexcept
+    {
+        return bytes(p_data + i_offset, i_count);
+    }
+
+private:
+    const uint8_t *p_data;
+    std::size_t    i_size;
+};
+#endif
+
+/*! \brief Size of a TS packet */
+constexpr std::size_t packet_size = 188;
+
+/*****************************************************************************
+ * table_ptr
+ *****************************************************************************/
+namespace detail {
+inline void table_delete(dvbpsi_pat_t *p) noexcept { dvbpsi_pat_delete(p); }
+inline void table_delete(dvbpsi_pmt_t *p) noexcept { dvbpsi_pmt_delete(p); }
+inline void table_delete(dvbpsi_cat_t *p) noexcept { dvbpsi_cat_delete(p); }
+inline void table_delete(dvbpsi_rst_t *p) noexcept { dvbpsi_rst_delete(p); }
+inline void table_delete(dvbpsi_sdt_t *p) noexcept { dvbpsi_sdt_delete(p); }
+inline void table_delete(dvbpsi_eit_t *p) noexcept { dvbpsi_eit_delete(p); }
+inline void table_delete(dvbpsi_nit_t *p) noexcept { dvbpsi_nit_delete(p); }
+inline void table_delete(dvbpsi_bat_t *p) noexcept { dvbpsi_bat_delete(p); }
+inline void table_delete(dvbpsi_tot_t *p) noexcept { dvbpsi_tot_delete(p); }
+inline void table_delete(dvbpsi_sis_t *p) noexcept { dvbpsi_sis_delete(p); }
+}
+
+/*!
+ * \struct table_deleter
+ * \brief Deleter of the decoded tables, with the dvbpsi_xxx_delete()
+ * function of their type.
+ */
+template<typename T>
+struct table_deleter
+{
+    void operator()(T *p_table) const noexcept { detail::table_delete(p_table); }
+};
+
+/*!
+ * \typedef table_ptr
+ * \brief Owner of a decoded table.
+ */
+template<typename T>
+using table_ptr = std::unique_ptr<T, table_deleter<T>>;
+
+/*****************************************************************************
+ * list
+ *****************************************************************************/
+/*!
+ * \class list
+ * \brief Forward range over a list linked by its p_next members. It refers
+ * to the elements of the table or descriptor loop it was taken from.
+ */
+template<typename T>
+class list
+{
+public:
+    /*! \brief Iterator of the list */
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T *;
+        using reference         = T &;
+
+        constexpr iterator() noexcept : p(nullptr) {}
+        constexpr explicit iterator(T *p_first) noexcept : p(p_first) {}
+
+        constexpr reference operator*() const noexcept { return *p; }
+        constexpr pointer operator->() const noexcept { return p; }
+        constexpr iterator &operator++() noexcept { p = p->p_next; return *this; }
+        constexpr iterator operator++(int) noexcept { iterator i = *this; p = p->p_next; return i; }
+        constexpr bool operator==(const iterator &i) const noexcept { return p == i.p; }
+        constexpr bool operator!=(const iterator &i) const noexcept { return p != i.p; }
+
+    private:
+        T *p;
+    };
+
+    constexpr list() noexcept : p_first(nullptr) {}
+    constexpr explicit list(T *p) noexcept : p_first(p) {}
+
+    constexpr iterator begin() const noexcept { return iterator(p_first); }
+    constexpr iterator end() const noexcept { return iterator(); }
+    constexpr bool empty() const noexcept { return p_first == nullptr; }
+
+private:
+    T *p_first;
+};
+
+/*! \brief Programs of a PAT */
+inline list<dvbpsi_pat_program_t> programs(const dvbpsi_pat_t &pat) noexcept
+{
+    return list<dvbpsi_pat_program_t>(pat.p_first_program);
+}
+
+/*! \brief Elementary streams of a PMT */
+inline list<dvbpsi_pmt_es_t> streams(const dvbpsi_pmt_t &pmt) noexcept
+{
+    return list<dvbpsi_pmt_es_t>(pmt.p_first_es);
+}
+
+/*! \brief Services of an SDT */
+inline list<dvbpsi_sdt_service_t> services(const dvbpsi_sdt_t &sdt) noexcept
+{
+    return list<dvbpsi_sdt_service_t>(sdt.p_first_service);
+}
+
+/*! \brief Events of an EIT */
+inline list<dvbpsi_eit_event_t> events(const dvbpsi_eit_t &eit) noexcept
+{
+    return list<dvbpsi_eit_event_t>(eit.p_first_event);
+}
+
+/*! \brief Events of an RST */
+inline list<dvbpsi_rst_event_t> events(const dvbpsi_rst_t &rst) noexcept
+{
+    return list<dvbpsi_rst_event_t>(rst.p_first_event);
+}
+
+/*! \brief Transport streams of a NIT */
+inline list<dvbpsi_nit_ts_t> transports(const dvbpsi_nit_t &nit) noexcept
+{
+    return list<dvbpsi_nit_ts_t>(nit.p_first_ts);
+}
+
+/*! \brief Transport streams of a BAT */
+inline list<dvbpsi_bat_ts_t> transports(const dvbpsi_bat_t &bat) noexcept
+{
+    return list<dvbpsi_bat_ts_t>(bat.p_first_ts);
+}
+
+/*! \brief Descriptors of a table, or of one of its elements */
+template<typename T>
+inline auto descriptors(const T &t) noexcept -> decltype((void)t.p_first_descriptor, list<dvbpsi_descriptor_t>())
+{
+    return list<dvbpsi_descriptor_t>(t.p_first_descriptor);
+}
+
+/*! \brief Descriptors from the first one of a list */
+inline list<dvbpsi_descriptor_t> descriptors(dvbpsi_descriptor_t *p_first) noexcept
+{
+    return list<dvbpsi_descriptor_t>(p_first);
+}
+
+/*! \brief Sections from the first one of a list */
+inline list<dvbpsi_psi_section_t> sections(dvbpsi_psi_section_t *p_first) noexcept
+{
+    return list<dvbpsi_psi_section_t>(p_first);
+}
+
+} /* namespace dvbpsi */
+
+/*****************************************************************************
+ * Descriptor decoders, by tag
+ *****************************************************************************/
+#include DVBPSI_HPP_DR(dr_02.h)
+#include DVBPSI_HPP_DR(dr_03.h)
+#include DVBPSI_HPP_DR(dr_04.h)
+#include DVBPSI_HPP_DR(dr_05.h)
+#include DVBPSI_HPP_DR(dr_06.h)
+#include DVBPSI_HPP_DR(dr_07.h)
+#include DVBPSI_HPP_DR(dr_08.h)
+#include DVBPSI_HPP_DR(dr_09.h)
+#include DVBPSI_HPP_DR(dr_0a.h)
+#include DVBPSI_HPP_DR(dr_0b.h)
+#include DVBPSI_HPP_DR(dr_0c.h)
+#include DVBPSI_HPP_DR(dr_0d.h)
+#include DVBPSI_HPP_DR(dr_0e.h)
+#include DVBPSI_HPP_DR(dr_0f.h)
+#include DVBPSI_HPP_DR(dr_10.h)
+#include DVBPSI_HPP_DR(dr_11.h)
+#include DVBPSI_HPP_DR(dr_12.h)
+#include DVBPSI_HPP_DR(dr_13.h)
+#include DVBPSI_HPP_DR(dr_14.h)
+#include DVBPSI_HPP_DR(dr_1b.h)
+#include DVBPSI_HPP_DR(dr_1c.h)
+#include DVBPSI_HPP_DR(dr_24.h)
+#include DVBPSI_HPP_DR(dr_40.h)
+#include DVBPSI_HPP_DR(dr_41.h)
+#include DVBPSI_HPP_DR(dr_42.h)
+#include DVBPSI_HPP_DR(dr_43.h)
+#include DVBPSI_HPP_DR(dr_44.h)
+#include DVBPSI_HPP_DR(dr_45.h)
+#include DVBPSI_HPP_DR(dr_47.h)
+#include DVBPSI_HPP_DR(dr_48.h)
+#include DVBPSI_HPP_DR(dr_49.h)
+#include DVBPSI_HPP_DR(dr_4a.h)
+#include DVBPSI_HPP_DR(dr_4b.h)
+#include DVBPSI_HPP_DR(dr_4c.h)
+#include DVBPSI_HPP_DR(dr_4d.h)
+#include DVBPSI_HPP_DR(dr_4e.h)
+#include DVBPSI_HPP_DR(dr_4f.h)
+#include DVBPSI_HPP_DR(dr_50.h)
+#include DVBPSI_HPP_DR(dr_52.h)
+#include DVBPSI_HPP_DR(dr_53.h)
+#include DVBPSI_HPP_DR(dr_54.h)
+#include DVBPSI_HPP_DR(dr_55.h)
+#include DVBPSI_HPP_DR(dr_56.h)
+#include DVBPSI_HPP_DR(dr_58.h)
+#include DVBPSI_HPP_DR(dr_59.h)
+#include DVBPSI_HPP_DR(dr_5a.h)
+#include DVBPSI_HPP_DR(dr_62.h)
+#include DVBPSI_HPP_DR(dr_66.h)
+#include DVBPSI_HPP_DR(dr_69.h)
+#include DVBPSI_HPP_DR(dr_73.h)
+#include DVBPSI_HPP_DR(dr_76.h)
+#include DVBPSI_HPP_DR(dr_7c.h)
+#include DVBPSI_HPP_DR(dr_81.h)
+#include DVBPSI_HPP_DR(dr_83.h)
+#include DVBPSI_HPP_DR(dr_86.h)
+#include DVBPSI_HPP_DR(dr_8a.h)
+#include DVBPSI_HPP_DR(dr_a0.h)
+#include DVBPSI_HPP_DR(dr_a1.h)
+#undef DVBPSI_HPP_DR
+#undef DVBPSI_HPP_STR
+
+namespace dvbpsi {
+
+/*!
+ * \struct descriptor
+ * \brief Decoded type and decoder of a descriptor tag, defined for the tags
+ * libdvbpsi decodes.
+ */
+template<uint8_t Tag>
+struct descriptor;
+
+#define DVBPSI_HPP_DESCRIPTOR(tag, T, decoder)                                  \
+template<>                                                                      \
+struct descriptor<tag>                                                          \
+{                                                                               \
+    using type = T;                                                             \
+    static T *decode(dvbpsi_descriptor_t *p_descriptor) noexcept               \
+    {                                                                           \
+        return decoder(p_descriptor);                                           \
+    }                                                                           \
+};
+
+DVBPSI_HPP_DESCRIPTOR(0x02, dvbpsi_vstream_dr_t, dvbpsi_DecodeVStreamDr)
+DVBPSI_HPP_DESCRIPTOR(0x03, dvbpsi_astream_dr_t, dvbpsi_DecodeAStreamDr)
+DVBPSI_HPP_DESCRIPTOR(0x04, dvbpsi_hierarchy_dr_t, dvbpsi_DecodeHierarchyDr)
+DVBPSI_HPP_DESCRIPTOR(0x05, dvbpsi_registration_dr_t, dvbpsi_DecodeRegistrationDr)
+DVBPSI_HPP_DESCRIPTOR(0x06, dvbpsi_ds_alignment_dr_t, dvbpsi_DecodeDSAlignmentDr)
+DVBPSI_HPP_DESCRIPTOR(0x07, dvbpsi_target_bg_grid_dr_t, dvbpsi_DecodeTargetBgGridDr)
+DVBPSI_HPP_DESCRIPTOR(0x08, dvbpsi_vwindow_dr_t, dvbpsi_DecodeVWindowDr)
+DVBPSI_HPP_DESCRIPTOR(0x09, dvbpsi_ca_dr_t, dvbpsi_DecodeCADr)
+DVBPSI_HPP_DESCRIPTOR(0x0a, dvbpsi_iso639_dr_t, dvbpsi_DecodeISO639Dr)
+DVBPSI_HPP_DESCRIPTOR(0x0b, dvbpsi_system_clock_dr_t, dvbpsi_DecodeSystemClockDr)
+DVBPSI_HPP_DESCRIPTOR(0x0c, dvbpsi_mx_buff_utilization_dr_t, dvbpsi_DecodeMxBuffUtilizationDr)
+DVBPSI_HPP_DESCRIPTOR(0x0d, dvbpsi_copyright_dr_t, dvbpsi_DecodeCopyrightDr)
+DVBPSI_HPP_DESCRIPTOR(0x0e, dvbpsi_max_bitrate_dr_t, dvbpsi_DecodeMaxBitrateDr)
+DVBPSI_HPP_DESCRIPTOR(0x0f, dvbpsi_private_data_dr_t, dvbpsi_DecodePrivateDataDr)
+DVBPSI_HPP_DESCRIPTOR(0x10, dvbpsi_smoothing_buffer_dr_t, dvbpsi_DecodeSmoothingBufferDr)
+DVBPSI_HPP_DESCRIPTOR(0x11, dvbpsi_std_dr_t, dvbpsi_DecodeSTDDr)
+DVBPSI_HPP_DESCRIPTOR(0x12, dvbpsi_ibp_dr_t, dvbpsi_DecodeIBPDr)
+DVBPSI_HPP_DESCRIPTOR(0x13, dvbpsi_carousel_id_dr_t, dvbpsi_DecodeCarouselIdDr)
+DVBPSI_HPP_DESCRIPTOR(0x14, dvbpsi_association_tag_dr_t, dvbpsi_DecodeAssociationTagDr)
+DVBPSI_HPP_DESCRIPTOR(0x1b, dvbpsi_mpeg4_video_dr_t, dvbpsi_DecodeMPEG4VideoDr)
+DVBPSI_HPP_DESCRIPTOR(0x1c, dvbpsi_mpeg4_audio_dr_t, dvbpsi_DecodeMPEG4AudioDr)
+DVBPSI_HPP_DESCRIPTOR(0x24, dvbpsi_content_labelling_dr_t, dvbpsi_DecodeContentLabellingDr)
+DVBPSI_HPP_DESCRIPTOR(0x40, dvbpsi_network_name_dr_t, dvbpsi_DecodeNetworkNameDr)
+DVBPSI_HPP_DESCRIPTOR(0x41, dvbpsi_service_list_dr_t, dvbpsi_DecodeServiceListDr)
+DVBPSI_HPP_DESCRIPTOR(0x42, dvbpsi_stuffing_dr_t, dvbpsi_DecodeStuffingDr)
+DVBPSI_HPP_DESCRIPTOR(0x43, dvbpsi_sat_deliv_sys_dr_t, dvbpsi_DecodeSatDelivSysDr)
+DVBPSI_HPP_DESCRIPTOR(0x44, dvbpsi_cable_deliv_sys_dr_t, dvbpsi_DecodeCableDelivSysDr)
+DVBPSI_HPP_DESCRIPTOR(0x45, dvbpsi_vbi_dr_t, dvbpsi_DecodeVBIDataDr)
+DVBPSI_HPP_DESCRIPTOR(0x47, dvbpsi_bouquet_name_dr_t, dvbpsi_DecodeBouquetNameDr)
+DVBPSI_HPP_DESCRIPTOR(0x48, dvbpsi_service_dr_t, dvbpsi_DecodeServiceDr)
+DVBPSI_HPP_DESCRIPTOR(0x49, dvbpsi_country_availability_dr_t, dvbpsi_DecodeCountryAvailabilityDr)
+DVBPSI_HPP_DESCRIPTOR(0x4a, dvbpsi_linkage_dr_t, dvbpsi_DecodeLinkageDr)
+DVBPSI_HPP_DESCRIPTOR(0x4b, dvbpsi_nvod_ref_dr_t, dvbpsi_DecodeNVODReferenceDr)
+DVBPSI_HPP_DESCRIPTOR(0x4c, dvbpsi_tshifted_service_dr_t, dvbpsi_DecodeTimeShiftedServiceDr)
+DVBPSI_HPP_DESCRIPTOR(0x4d, dvbpsi_short_event_dr_t, dvbpsi_DecodeShortEventDr)
+DVBPSI_HPP_DESCRIPTOR(0x4e, dvbpsi_extended_event_dr_t, dvbpsi_DecodeExtendedEventDr)
+DVBPSI_HPP_DESCRIPTOR(0x4f, dvbpsi_tshifted_ev_dr_t, dvbpsi_DecodeTimeShiftedEventDr)
+DVBPSI_HPP_DESCRIPTOR(0x50, dvbpsi_component_dr_t, dvbpsi_DecodeComponentDr)
+DVBPSI_HPP_DESCRIPTOR(0x52, dvbpsi_stream_identifier_dr_t, dvbpsi_DecodeStreamIdentifierDr)
+DVBPSI_HPP_DESCRIPTOR(0x53, dvbpsi_ca_identifier_dr_t, dvbpsi_DecodeCAIdentifierDr)
+DVBPSI_HPP_DESCRIPTOR(0x54, dvbpsi_content_dr_t, dvbpsi_DecodeContentDr)
+DVBPSI_HPP_DESCRIPTOR(0x55, dvbpsi_parental_rating_dr_t, dvbpsi_DecodeParentalRatingDr)
+DVBPSI_HPP_DESCRIPTOR(0x56, dvbpsi_teletext_dr_t, dvbpsi_DecodeTeletextDr)
+DVBPSI_HPP_DESCRIPTOR(0x58, dvbpsi_local_time_offset_dr_t, dvbpsi_DecodeLocalTimeOffsetDr)
+DVBPSI_HPP_DESCRIPTOR(0x59, dvbpsi_subtitling_dr_t, dvbpsi_DecodeSubtitlingDr)
+DVBPSI_HPP_DESCRIPTOR(0x5a, dvbpsi_terr_deliv_sys_dr_t, dvbpsi_DecodeTerrDelivSysDr)
+DVBPSI_HPP_DESCRIPTOR(0x62, dvbpsi_frequency_list_dr_t, dvbpsi_DecodeFrequencyListDr)
+DVBPSI_HPP_DESCRIPTOR(0x66, dvbpsi_data_broadcast_id_dr_t, dvbpsi_DecodeDataBroadcastIdDr)
+DVBPSI_HPP_DESCRIPTOR(0x69, dvbpsi_PDC_dr_t, dvbpsi_DecodePDCDr)
+DVBPSI_HPP_DESCRIPTOR(0x73, dvbpsi_default_authority_dr_t, dvbpsi_DecodeDefaultAuthorityDr)
+DVBPSI_HPP_DESCRIPTOR(0x76, dvbpsi_content_id_dr_t, dvbpsi_DecodeContentIdDr)
+DVBPSI_HPP_DESCRIPTOR(0x7c, dvbpsi_aac_dr_t, dvbpsi_DecodeAACDr)
+DVBPSI_HPP_DESCRIPTOR(0x81, dvbpsi_ac3_audio_dr_t, dvbpsi_DecodeAc3AudioDr)
+DVBPSI_HPP_DESCRIPTOR(0x83, dvbpsi_lcn_dr_t, dvbpsi_DecodeLCNDr)
+DVBPSI_HPP_DESCRIPTOR(0x86, dvbpsi_caption_service_dr_t, dvbpsi_DecodeCaptionServiceDr)
+DVBPSI_HPP_DESCRIPTOR(0x8a, dvbpsi_cuei_dr_t, dvbpsi_DecodeCUEIDr)
+DVBPSI_HPP_DESCRIPTOR(0xa0, dvbpsi_extended_channel_name_dr_t, dvbpsi_DecodeExtendedChannelNameDr)
+DVBPSI_HPP_DESCRIPTOR(0xa1, dvbpsi_service_location_dr_t, dvbpsi_DecodeServiceLocationDr)
+#undef DVBPSI_HPP_DESCRIPTOR
+
+/*!
+ * \fn decode
+ * \brief Decode a descriptor as the descriptor of tag Tag. The decoded
+ * descriptor belongs to the descriptor.
+ * \return the decoded descriptor, nullptr if it has another tag or is
+ * invalid
+ */
+template<uint8_t Tag>
+inline typename descriptor<Tag>::type *decode(dvbpsi_descriptor_t &d) noexcept
+{
+    return descriptor<Tag>::decode(&d);
+}
+
+/*****************************************************************************
+ * Callbacks
+ *****************************************************************************
+ * A callback is moved into a node, allocated when the decoder is attached
+ * and given to the C callback as its private data.
+ *****************************************************************************/
+namespace detail {
+
+struct node
+{
+    node *p_next = nullptr;
+    virtual ~node() = default;
+};
+
+inline void delete_nodes(node *p_node) noexcept
+{
+    while (p_node)
+    {
+        node *p_next = p_node->p_next;
+        delete p_node;
+        p_node = p_next;
+    }
+}
+
+template<typename F>
+struct callback : node
+{
+    F f;
+    explicit callback(F &&f_) : f(std::move(f_)) {}
+    explicit callback(const F &f_) : f(f_) {}
+};
+
+template<typename T, typename F>
+inline void on_table(void *p_cb_data, T *p_table) noexcept
+{
+    static_cast<callback<F> *>(p_cb_data)->f(table_ptr<T>(p_table));
+}
+
+template<typename F>
+inline void on_splice(void *p_cb_data, const dvbpsi_sis_splice_info_t *p_info) noexcept
+{
+    static_cast<callback<F> *>(p_cb_data)->f(*p_info);
+}
+
+/* Attach with a callback moved into a new node linked to pp_nodes */
+template<typename T, typename F, typename Attach>
+inline bool attach(node **pp_nodes, F &&f, Attach attach_cb)
+{
+    using C = callback<std::decay_t<F>>;
+    C *p_callback = new C(std::forward<F>(f));
+    if (!attach_cb(&on_table<T, std::decay_t<F>>, static_cast<void *>(p_callback)))
+    {
+        delete p_callback;
+        return false;
+    }
+    p_callback->p_next = *pp_nodes;
+    *pp_nodes = p_callback;
+    return true;
+}
+
+} /* namespace detail */
+
+/*****************************************************************************
+ * demux
+ *****************************************************************************/
+/*!
+ * \class demux
+ * \brief Subtable demultiplexor of a handle, given to the new subtable
+ * callback of handle::attach_demux() to attach the subtable decoders. They
+ * are detached with the demux.
+ */
+class demux
+{
+public:
+    /*! \brief The C handle */
+    dvbpsi_t *get() const noexcept { return p_dvbpsi; }
+
+    /*! \brief Attach an SDT decoder, see dvbpsi_sdt_attach() */
+    template<typename F>
+    bool attach_sdt(uint8_t i_table_id, uint16_t i_extension, F &&f)
+    {
+        return attach<dvbpsi_sdt_t>(dvbpsi_sdt_attach, i_table_id, i_extension, std::forward<F>(f));
+    }
+
+    /*! \brief Attach an EIT decoder, see dvbpsi_eit_attach() */
+    template<typename F>
+    bool attach_eit(uint8_t i_table_id, uint16_t i_extension, F &&f)
+    {
+        return attach<dvbpsi_eit_t>(dvbpsi_eit_attach, i_table_id, i_extension, std::forward<F>(f));
+    }
+
+    /*! \brief Attach a NIT decoder, see dvbpsi_nit_attach() */
+    template<typename F>
+    bool attach_nit(uint8_t i_table_id, uint16_t i_extension, F &&f)
+    {
+        return attach<dvbpsi_nit_t>(dvbpsi_nit_attach, i_table_id, i_extension, std::forward<F>(f));
+    }
+
+    /*! \brief Attach a BAT decoder, see dvbpsi_bat_attach() */
+    template<typename F>
+    bool attach_bat(uint8_t i_table_id, uint16_t i_extension, F &&f)
+    {
+        return attach<dvbpsi_bat_t>(dvbpsi_bat_attach, i_table_id, i_extension, std::forward<F>(f));
+    }
+
+    /*! \brief Attach a TDT/TOT decoder, see dvbpsi_tot_attach() */
+    template<typename F>
+    bool attach_tot(uint8_t i_table_id, uint16_t i_extension, F &&f)
+    {
+        return attach<dvbpsi_tot_t>(dvbpsi_tot_attach, i_table_id, i_extension, std::forward<F>(f));
+    }
+
+    /*! \brief Attach an SCTE 35 decoder, see dvbpsi_sis_attach() */
+    template<typename F>
+    bool attach_sis(uint8_t i_table_id, uint16_t i_extension, F &&f)
+    {
+        return attach<dvbpsi_sis_t>(dvbpsi_sis_attach, i_table_id, i_extension, std::forward<F>(f));
+    }
+
+    demux(const demux &) = delete;
+    demux &operator=(const demux &) = delete;
+
+private:
+    template<typename F> friend struct demux_callback;
+
+    explicit demux(dvbpsi_t *p) noexcept : p_dvbpsi(p), p_nodes(nullptr) {}
+    ~demux() { detail::delete_nodes(p_nodes); }
+
+    template<typename T, typename F>
+    bool attach(bool (*pf_attach)(dvbpsi_t *, uint8_t, uint16_t,
+                                  void (*)(void *, T *), void *),
+                uint8_t i_table_id, uint16_t i_extension, F &&f)
+    {
+        dvbpsi_t *p = p_dvbpsi;
+        return detail::attach<T>(&p_nodes, std::forward<F>(f),
+            [=](void (*pf_callback)(void *, T *), void *p_cb_data) {
+                return pf_attach(p, i_table_id, i_extension, pf_callback, p_cb_data);
+            });
+    }
+
+    dvbpsi_t     *p_dvbpsi;
+    detail::node *p_nodes;
+};
+
+/*! \cond */
+template<typename F>
+struct demux_callback : detail::node
+{
+    demux d;
+    F     f;
+    demux_callback(dvbpsi_t *p, F &&f_) : d(p), f(std::move(f_)) {}
+    demux_callback(dvbpsi_t *p, const F &f_) : d(p), f(f_) {}
+
+    static void on_new(dvbpsi_t *, uint8_t i_table_id, uint16_t i_extension,
+                       void *p_cb_data) noexcept
+    {
+        demux_callback *p_self = static_cast<demux_callback *>(p_cb_data);
+        p_self->f(p_self->d, i_table_id, i_extension);
+    }
+};
+/*! \endcond */
+
+/*****************************************************************************
+ * handle
+ *****************************************************************************/
+/*!
+ * \class handle
+ * \brief Owner of a dvbpsi_t handle and of the decoder attached to it, move
+ * only. Only one decoder may be attached at a time.
+ */
+class handle
+{
+public:
+    /*!
+     * \brief Create the handle, see dvbpsi_new().
+     * \throw std::bad_alloc on allocation failure
+     */
+    explicit handle(dvbpsi_msg_level_t level = DVBPSI_MSG_NONE,
+                    dvbpsi_message_cb pf_message = nullptr)
+        : p_dvbpsi(dvbpsi_new(pf_message, level)), pf_detach(nullptr), p_node(nullptr)
+    {
+        if (p_dvbpsi == nullptr)
+            throw std::bad_alloc();
+    }
+
+    ~handle()
+    {
+        detach();
+        dvbpsi_delete(p_dvbpsi);
+    }
+
+    handle(handle &&h) noexcept
+        : p_dvbpsi(std::exchange(h.p_dvbpsi, nullptr)),
+          pf_detach(std::exchange(h.pf_detach, nullptr)),
+          p_node(std::exchange(h.p_node, nullptr))
+    {
+    }
+
+    handle &operator=(handle &&h) noexcept
+    {
+        if (this != &h)
+        {
+            detach();
+            dvbpsi_delete(p_dvbpsi);
+            p_dvbpsi = std::exchange(h.p_dvbpsi, nullptr);
+            pf_detach = std::exchange(h.pf_detach, nullptr);
+            p_node = std::exchange(h.p_node, nullptr);
+        }
+        return *this;
+    }
+
+    handle(const handle &) = delete;
+    handle &operator=(const handle &) = delete;
+
+    /*! \brief The C handle, nullptr once moved from */
+    dvbpsi_t *get() const noexcept { return p_dvbpsi; }
+
+    /*! \brief Whether a decoder is attached */
+    bool attached() const noexcept { return pf_detach != nullptr; }
+
+    /*! \brief Detach the decoder, if any, and delete its callbacks */
+    void detach() noexcept
+    {
+        if (pf_detach)
+            pf_detach(p_dvbpsi);
+        pf_detach = nullptr;
+        detail::delete_nodes(p_node);
+        p_node = nullptr;
+    }
+
+    /*!
+     * \brief Push one TS packet, see dvbpsi_packet_push().
+     * \param packet at least 188 bytes
+     */
+    bool push(bytes packet) noexcept
+    {
+        assert(packet.size() >= packet_size);
+        return dvbpsi_packet_push(p_dvbpsi, const_cast<uint8_t *>(packet.data()));
+    }
+
+    /*!
+     * \brief Push consecutive TS packets, a trailing partial packet is
+     * ignored.
+     * \return the number of packets handled without error
+     */
+    std::size_t push_packets(bytes packets) noexcept
+    {
+        dvbpsi_t *p_handle = p_dvbpsi;
+        std::size_t i_handled = 0;
+        const uint8_t *p = packets.data();
+        for (std::size_t i = packets.size() / packet_size; i > 0; i--, p += packet_size)
+            i_handled += dvbpsi_packet_push(p_handle, const_cast<uint8_t *>(p));
+        return i_handled;
+    }
+
+    /*! \brief Push a complete section, see dvbpsi_section_push() */
+    bool push_section(bytes section) noexcept
+    {
+        return dvbpsi_section_push(p_dvbpsi, section.data(), section.size());
+    }
+
+    /*! \brief See dvbpsi_set_budget() */
+    void set_budget(std::size_t i_budget, int64_t i_timeout) noexcept
+    {
+        dvbpsi_set_budget(p_dvbpsi, i_budget, i_timeout);
+    }
+
+    /*! \brief See dvbpsi_set_time() */
+    void set_time(int64_t i_time) noexcept
+    {
+        dvbpsi_set_time(p_dvbpsi, i_time);
+    }
+
+    /*!
+     * \brief Attach a PAT decoder, see dvbpsi_pat_attach().
+     * \param f callback invocable with a table_ptr<dvbpsi_pat_t>
+     */
+    template<typename F>
+    bool attach_pat(F &&f)
+    {
+        return attach<dvbpsi_pat_t>(dvbpsi_pat_detach, std::forward<F>(f),
+            [this](void (*pf_callback)(void *, dvbpsi_pat_t *), void *p_cb_data) {
+                return dvbpsi_pat_attach(p_dvbpsi, pf_callback, p_cb_data);
+            });
+    }
+
+    /*! \brief Attach a PMT decoder, see dvbpsi_pmt_attach() */
+    template<typename F>
+    bool attach_pmt(uint16_t i_program_number, F &&f)
+    {
+        return attach<dvbpsi_pmt_t>(dvbpsi_pmt_detach, std::forward<F>(f),
+            [this, i_program_number](void (*pf_callback)(void *, dvbpsi_pmt_t *), void *p_cb_data) {
+                return dvbpsi_pmt_attach(p_dvbpsi, i_program_number, pf_callback, p_cb_data);
+            });
+    }
+
+    /*! \brief Attach a CAT decoder, see dvbpsi_cat_attach() */
+    template<typename F>
+    bool attach_cat(F &&f)
+    {
+        return attach<dvbpsi_cat_t>(dvbpsi_cat_detach, std::forward<F>(f),
+            [this](void (*pf_callback)(void *, dvbpsi_cat_t *), void *p_cb_data) {
+                return dvbpsi_cat_attach(p_dvbpsi, pf_callback, p_cb_data);
+            });
+    }
+
+    /*! \brief Attach an RST decoder, see dvbpsi_rst_attach() */
+    template<typename F>
+    bool attach_rst(F &&f)
+    {
+        return attach<dvbpsi_rst_t>(dvbpsi_rst_detach, std::forward<F>(f),
+            [this](void (*pf_callback)(void *, dvbpsi_rst_t *), void *p_cb_data) {
+                return dvbpsi_rst_attach(p_dvbpsi, pf_callback, p_cb_data);
+            });
+    }
+
+    /*!
+     * \brief Attach a splice information decoder, see
+     * dvbpsi_sis_splice_attach().
+     * \param f callback invocable with a const dvbpsi_sis_splice_info_t &
+     */
+    template<typename F>
+    bool attach_splice(F &&f)
+    {
+        using C = detail::callback<std::decay_t<F>>;
+        if (pf_detach)
+            return false;
+        C *p_callback = new C(std::forward<F>(f));
+        if (!dvbpsi_sis_splice_attach(p_dvbpsi, &detail::on_splice<std::decay_t<F>>,
+                                      static_cast<void *>(p_callback)))
+        {
+            delete p_callback;
+            return false;
+        }
+        p_node = p_callback;
+        pf_detach = dvbpsi_sis_splice_detach;
+        return true;
+    }
+
+    /*!
+     * \brief Attach a subtable demultiplexor, see dvbpsi_AttachDemux().
+     * \param f new subtable callback, invocable with a demux &, the table_id
+     * and the table_id_extension, which may attach the subtable decoder
+     */
+    template<typename F>
+    bool attach_demux(F &&f)
+    {
+        using C = demux_callback<std::decay_t<F>>;
+        if (pf_detach)
+            return false;
+        C *p_callback = new C(p_dvbpsi, std::forward<F>(f));
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        if (!dvbpsi_AttachDemux(p_dvbpsi, &C::on_new, static_cast<void *>(p_callback)))
+        {
+            delete p_callback;
+            return false;
+        }
+        p_node = p_callback;
+        pf_detach = dvbpsi_DetachDemux;
+#pragma GCC diagnostic pop
+        return true;
+    }
+
+private:
+    template<typename T, typename F, typename Attach>
+    bool attach(void (*pf_detach_)(dvbpsi_t *), F &&f, Attach attach_cb)
+    {
+        if (pf_detach)
+            return false;
+        if (!detail::attach<T>(&p_node, std::forward<F>(f), attach_cb))
+            return false;
+        pf_detach = pf_detach_;
+        return true;
+    }
+
+    dvbpsi_t      *p_dvbpsi;
+    void         (*pf_detach)(dvbpsi_t *);
+    detail::node  *p_node;
+};
+
+} /* namespace dvbpsi */
+
+#else
+#error "Multiple inclusions of dvbpsi.hpp"
+#endif
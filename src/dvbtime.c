@@ -0,0 +1,155 @@
+/*****************************************************************************
+ * dvbtime.c: conversions of the DVB and ATSC times
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include "dvbtime.h"
+
+/* MJD of 1970-01-01 */
+#define MJD_UNIX_EPOCH  40587
+
+static inline uint32_t BcdSeconds(uint32_t i_bcd)
+{
+    uint32_t i_hours   = ((i_bcd >> 20) & 0xf) * 10 + ((i_bcd >> 16) & 0xf);
+    uint32_t i_minutes = ((i_bcd >> 12) & 0xf) * 10 + ((i_bcd >>  8) & 0xf);
+    uint32_t i_seconds = ((i_bcd >>  4) & 0xf) * 10 + (i_bcd & 0xf);
+    return i_hours * 3600 + i_minutes * 60 + i_seconds;
+}
+
+static inline int64_t MjdUnix(uint64_t i_mjd_bcd)
+{
+    int64_t i_mjd = (int64_t)((i_mjd_bcd >> 24) & 0xffff);
+    int64_t i_time = (i_mjd - MJD_UNIX_EPOCH) * 86400 + BcdSeconds((uint32_t)i_mjd_bcd & 0xffffff);
+    return i_mjd == 0xffff ? DVBPSI_TIME_UNDEFINED : i_time;
+}
+
+static inline uint32_t Bcd2(uint32_t i_value)
+{
+    /* i_value / 10 for i_value < 100 */
+    uint32_t i_tens = (i_value * 205) >> 11;
+    return i_tens << 4 | (i_value - i_tens * 10);
+}
+
+/*****************************************************************************
+ * dvbpsi_mjd_to_unix
+ *****************************************************************************/
+int64_t dvbpsi_mjd_to_unix(uint64_t i_mjd_bcd)
+{
+    return MjdUnix(i_mjd_bcd);
+}
+
+/*****************************************************************************
+ * dvbpsi_unix_to_mjd
+ *****************************************************************************/
+uint64_t dvbpsi_unix_to_mjd(int64_t i_time)
+{
+    int64_t i_days, i_seconds;
+
+    if (i_time == DVBPSI_TIME_UNDEFINED)
+        return UINT64_C(0xffffffffff);
+
+    /* floor division, the dates before 1970 are negative */
+    i_days = i_time / 86400;
+    i_seconds = i_time - i_days * 86400;
+    if (i_seconds < 0)
+    {
+        i_days--;
+        i_seconds += 86400;
+    }
+    return (uint64_t)((i_days + MJD_UNIX_EPOCH) & 0xffff) << 24
+         | dvbpsi_seconds_to_bcd((uint32_t)i_seconds);
+}
+
+/*****************************************************************************
+ * dvbpsi_bcd_to_seconds
+ *****************************************************************************/
+uint32_t dvbpsi_bcd_to_seconds(uint32_t i_bcd)
+{
+    return BcdSeconds(i_bcd);
+}
+
+/*****************************************************************************
+ * dvbpsi_seconds_to_bcd
+ *****************************************************************************/
+uint32_t dvbpsi_seconds_to_bcd(uint32_t i_seconds)
+{
+    uint32_t i_hours = i_seconds / 3600;
+    uint32_t i_minutes = (i_seconds / 60) % 60;
+    return Bcd2(i_hours % 100) << 16 | Bcd2(i_minutes) << 8 | Bcd2(i_seconds % 60);
+}
+
+/*****************************************************************************
+ * dvbpsi_gps_to_unix
+ *****************************************************************************/
+int64_t dvbpsi_gps_to_unix(uint32_t i_gps, uint8_t i_gps_utc_offset)
+{
+    return DVBPSI_GPS_EPOCH + i_gps - i_gps_utc_offset;
+}
+
+/*****************************************************************************
+ * dvbpsi_unix_to_gps
+ *****************************************************************************/
+uint32_t dvbpsi_unix_to_gps(int64_t i_time, uint8_t i_gps_utc_offset)
+{
+    return (uint32_t)(i_time - DVBPSI_GPS_EPOCH + i_gps_utc_offset);
+}
+
+/*****************************************************************************
+ * dvbpsi_mjd_to_unix_array
+ *****************************************************************************/
+void dvbpsi_mjd_to_unix_array(const uint64_t *p_mjd_bcd, int64_t *p_time, size_t i_count)
+{
+    for (size_t i = 0; i < i_count; i++)
+        p_time[i] = MjdUnix(p_mjd_bcd[i]);
+}
+
+/*****************************************************************************
+ * dvbpsi_bcd_to_seconds_array
+ *****************************************************************************/
+void dvbpsi_bcd_to_seconds_array(const uint32_t *p_bcd, uint32_t *p_seconds, size_t i_count)
+{
+    for (size_t i = 0; i < i_count; i++)
+        p_seconds[i] = BcdSeconds(p_bcd[i]);
+}
+
+/*****************************************************************************
+ * dvbpsi_gps_to_unix_array
+ *****************************************************************************/
+void dvbpsi_gps_to_unix_array(const uint32_t *p_gps, int64_t *p_time, size_t i_count,
+                              uint8_t i_gps_utc_offset)
+{
+    const int64_t i_base = DVBPSI_GPS_EPOCH - i_gps_utc_offset;
+    for (size_t i = 0; i < i_count; i++)
+        p_time[i] = i_base + p_gps[i];
+}
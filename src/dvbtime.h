@@ -0,0 +1,181 @@
+/*****************************************************************************
+ * dvbtime.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <dvbtime.h>
+ * \brief Conversions of the DVB and ATSC times.
+ *
+ * The DVB tables code the times on 40 bits, the Modified Julian Date
+ * followed by the hours, minutes and seconds in BCD (EIT start_time,
+ * TDT/TOT UTC_time, local time offset time_of_change), and the durations on
+ * 24 bits of BCD. The ATSC tables count GPS seconds since 1980-01-06, the
+ * STT giving the GPS to UTC offset.
+ *
+ * The conversions from the DVB and GPS times use neither divisions nor
+ * branches on the data, their array variants are loops the compiler can
+ * vectorize.
+ */
+
+#ifndef _DVBPSI_DVBTIME_H_
+#define _DVBPSI_DVBTIME_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \def DVBPSI_TIME_UNDEFINED
+ * \brief Unix time of an undefined DVB time, all its bits set.
+ */
+#define DVBPSI_TIME_UNDEFINED   INT64_MIN
+
+/*!
+ * \def DVBPSI_GPS_EPOCH
+ * \brief Unix time of the GPS epoch, 1980-01-06 00:00:00 UTC.
+ */
+#define DVBPSI_GPS_EPOCH        INT64_C(315964800)
+
+/*****************************************************************************
+ * dvbpsi_mjd_to_unix
+ *****************************************************************************/
+/*!
+ * \fn int64_t dvbpsi_mjd_to_unix(uint64_t i_mjd_bcd)
+ * \brief Convert a 40 bits MJD and BCD time to Unix time.
+ * \param i_mjd_bcd the time
+ * \return the seconds since the Unix epoch, DVBPSI_TIME_UNDEFINED if the
+ * date is undefined (0xFFFF)
+ */
+int64_t dvbpsi_mjd_to_unix(uint64_t i_mjd_bcd);
+
+/*****************************************************************************
+ * dvbpsi_unix_to_mjd
+ *****************************************************************************/
+/*!
+ * \fn uint64_t dvbpsi_unix_to_mjd(int64_t i_time)
+ * \brief Convert a Unix time to a 40 bits MJD and BCD time.
+ * \param i_time the seconds since the Unix epoch, between 1858-11-17 and
+ * 2038-04-21, DVBPSI_TIME_UNDEFINED for an undefined time
+ * \return the time
+ */
+uint64_t dvbpsi_unix_to_mjd(int64_t i_time);
+
+/*****************************************************************************
+ * dvbpsi_bcd_to_seconds
+ *****************************************************************************/
+/*!
+ * \fn uint32_t dvbpsi_bcd_to_seconds(uint32_t i_bcd)
+ * \brief Convert a 24 bits BCD duration, hours, minutes and seconds, to
+ * seconds.
+ * \param i_bcd the duration
+ * \return the seconds
+ */
+uint32_t dvbpsi_bcd_to_seconds(uint32_t i_bcd);
+
+/*****************************************************************************
+ * dvbpsi_seconds_to_bcd
+ *****************************************************************************/
+/*!
+ * \fn uint32_t dvbpsi_seconds_to_bcd(uint32_t i_seconds)
+ * \brief Convert a duration in seconds, less than 100 hours, to 24 bits of
+ * BCD.
+ * \param i_seconds the duration
+ * \return the BCD duration
+ */
+uint32_t dvbpsi_seconds_to_bcd(uint32_t i_seconds);
+
+/*****************************************************************************
+ * dvbpsi_gps_to_unix
+ *****************************************************************************/
+/*!
+ * \fn int64_t dvbpsi_gps_to_unix(uint32_t i_gps, uint8_t i_gps_utc_offset)
+ * \brief Convert an ATSC GPS time to Unix time.
+ * \param i_gps the seconds since the GPS epoch
+ * \param i_gps_utc_offset GPS_UTC_offset of the STT, in seconds
+ * \return the seconds since the Unix epoch
+ */
+int64_t dvbpsi_gps_to_unix(uint32_t i_gps, uint8_t i_gps_utc_offset);
+
+/*****************************************************************************
+ * dvbpsi_unix_to_gps
+ *****************************************************************************/
+/*!
+ * \fn uint32_t dvbpsi_unix_to_gps(int64_t i_time, uint8_t i_gps_utc_offset)
+ * \brief Convert a Unix time, after the GPS epoch, to an ATSC GPS time.
+ * \param i_time the seconds since the Unix epoch
+ * \param i_gps_utc_offset GPS_UTC_offset of the STT, in seconds
+ * \return the seconds since the GPS epoch
+ */
+uint32_t dvbpsi_unix_to_gps(int64_t i_time, uint8_t i_gps_utc_offset);
+
+/*****************************************************************************
+ * dvbpsi_mjd_to_unix_array
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_mjd_to_unix_array(const uint64_t *p_mjd_bcd,
+                                     int64_t *p_time, size_t i_count)
+ * \brief Convert an array of 40 bits MJD and BCD times, see
+ * dvbpsi_mjd_to_unix().
+ * \param p_mjd_bcd the times
+ * \param p_time filled with the seconds since the Unix epoch
+ * \param i_count number of times
+ * \return nothing
+ */
+void dvbpsi_mjd_to_unix_array(const uint64_t *p_mjd_bcd, int64_t *p_time, size_t i_count);
+
+/*****************************************************************************
+ * dvbpsi_bcd_to_seconds_array
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_bcd_to_seconds_array(const uint32_t *p_bcd,
+                                        uint32_t *p_seconds, size_t i_count)
+ * \brief Convert an array of 24 bits BCD durations, see
+ * dvbpsi_bcd_to_seconds().
+ * \param p_bcd the durations
+ * \param p_seconds filled with the seconds
+ * \param i_count number of durations
+ * \return nothing
+ */
+void dvbpsi_bcd_to_seconds_array(const uint32_t *p_bcd, uint32_t *p_seconds, size_t i_count);
+
+/*****************************************************************************
+ * dvbpsi_gps_to_unix_array
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_gps_to_unix_array(const uint32_t *p_gps, int64_t *p_time,
+                                     size_t i_count, uint8_t i_gps_utc_offset)
+ * \brief Convert an array of ATSC GPS times, see dvbpsi_gps_to_unix().
+ * \param p_gps the times
+ * \param p_time filled with the seconds since the Unix epoch
+ * \param i_count number of times
+ * \param i_gps_utc_offset GPS_UTC_offset of the STT, in seconds
+ * \return nothing
+ */
+void dvbpsi_gps_to_unix_array(const uint32_t *p_gps, int64_t *p_time, size_t i_count,
+                              uint8_t i_gps_utc_offset);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of dvbtime.h"
+#endif
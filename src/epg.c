@@ -0,0 +1,617 @@
+/*****************************************************************************
+ * epg.c: electronic programme guide built from the EIT sections
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "psi.h"
+#include "dvbtime.h"
+#include "epg.h"
+#include "bitstream_private.h"
+
+#define EPG_BUCKETS         256
+/* An event takes at least 12 bytes of the section */
+#define EPG_MAX_EVENTS      ((4096 - 14 - 4) / 12)
+
+/* A section of a service, (table_id - 0x4e) << 8 | section_number */
+typedef struct epg_section_s
+{
+    uint16_t                i_key;
+    uint8_t                 i_version;
+    uint32_t                i_crc;
+    uint8_t                *p_data;         /* descriptors of the events */
+} epg_section_t;
+
+typedef struct epg_service_s
+{
+    uint64_t                i_key;          /* onid << 32 | tsid << 16 | sid */
+    struct epg_service_s   *p_next;
+
+    dvbpsi_epg_event_t     *p_events;       /* sorted by i_start */
+    size_t                  i_events;
+    size_t                  i_events_max;
+
+    epg_section_t          *p_sections;     /* sorted by i_key */
+    size_t                  i_sections;
+    size_t                  i_sections_max;
+} epg_service_t;
+
+typedef struct epg_tap_s
+{
+    dvbpsi_epg_t           *p_epg;
+    dvbpsi_t               *p_dvbpsi;
+    struct epg_tap_s       *p_next;
+} epg_tap_t;
+
+struct dvbpsi_epg_s
+{
+    epg_service_t         **pp_buckets;
+    size_t                  i_buckets;
+    size_t                  i_services;
+
+    int64_t                 i_now;
+    epg_tap_t              *p_taps;
+};
+
+/*****************************************************************************
+ * Services
+ *****************************************************************************/
+static uint64_t ServiceKey(uint16_t i_network_id, uint16_t i_ts_id, uint16_t i_service_id)
+{
+    return (uint64_t)i_network_id << 32 | (uint64_t)i_ts_id << 16 | i_service_id;
+}
+
+static size_t ServiceHash(uint64_t i_key, size_t i_buckets)
+{
+    uint32_t i_hash = (uint32_t)(i_key ^ (i_key >> 29)) * UINT32_C(0x9e3779b1);
+    return (size_t)(i_hash >> 8) & (i_buckets - 1);
+}
+
+static epg_service_t *ServiceFind(const dvbpsi_epg_t *p_epg, uint64_t i_key)
+{
+    epg_service_t *p_service = p_epg->pp_buckets[ServiceHash(i_key, p_epg->i_buckets)];
+    while (p_service && p_service->i_key != i_key)
+        p_service = p_service->p_next;
+    return p_service;
+}
+
+static epg_service_t *ServiceGet(dvbpsi_epg_t *p_epg, uint64_t i_key)
+{
+    epg_service_t *p_service = ServiceFind(p_epg, i_key);
+    size_t i_bucket;
+    if (p_service)
+        return p_service;
+
+    if (p_epg->i_services >= p_epg->i_buckets)
+    {
+        size_t i_buckets = p_epg->i_buckets * 2;
+        epg_service_t **pp_buckets = calloc(i_buckets, sizeof(epg_service_t *));
+        if (pp_buckets)
+        {
+            for (size_t i = 0; i < p_epg->i_buckets; i++)
+            {
+                epg_service_t *p_old = p_epg->pp_buckets[i];
+                while (p_old)
+                {
+                    epg_service_t *p_next = p_old->p_next;
+                    size_t i_new = ServiceHash(p_old->i_key, i_buckets);
+                    p_old->p_next = pp_buckets[i_new];
+                    pp_buckets[i_new] = p_old;
+                    p_old = p_next;
+                }
+            }
+            free(p_epg->pp_buckets);
+            p_epg->pp_buckets = pp_buckets;
+            p_epg->i_buckets = i_buckets;
+        }
+    }
+
+    p_service = calloc(1, sizeof(epg_service_t));
+    if (!p_service)
+        return NULL;
+    p_service->i_key = i_key;
+    i_bucket = ServiceHash(i_key, p_epg->i_buckets);
+    p_service->p_next = p_epg->pp_buckets[i_bucket];
+    p_epg->pp_buckets[i_bucket] = p_service;
+    p_epg->i_services++;
+    return p_service;
+}
+
+static void ServiceDelete(epg_service_t *p_service)
+{
+    for (size_t i = 0; i < p_service->i_sections; i++)
+        free(p_service->p_sections[i].p_data);
+    free(p_service->p_sections);
+    free(p_service->p_events);
+    free(p_service);
+}
+
+/* Index of the section i_key, or of where it would be inserted */
+static size_t SectionSearch(const epg_service_t *p_service, uint16_t i_key)
+{
+    size_t i_low = 0, i_high = p_service->i_sections;
+    while (i_low < i_high)
+    {
+        size_t i_mid = i_low + (i_high - i_low) / 2;
+        if (p_service->p_sections[i_mid].i_key < i_key)
+            i_low = i_mid + 1;
+        else
+            i_high = i_mid;
+    }
+    return i_low;
+}
+
+/* Index of the first event starting after i_time */
+static size_t EventSearch(const dvbpsi_epg_event_t *p_events, size_t i_events, int64_t i_time)
+{
+    size_t i_low = 0, i_high = i_events;
+    while (i_low < i_high)
+    {
+        size_t i_mid = i_low + (i_high - i_low) / 2;
+        if (p_events[i_mid].i_start <= i_time)
+            i_low = i_mid + 1;
+        else
+            i_high = i_mid;
+    }
+    return i_low;
+}
+
+static int64_t EventEnd(const dvbpsi_epg_event_t *p_event)
+{
+    return p_event->i_start + p_event->i_duration;
+}
+
+/* Remove the events which ended at i_now: only those which started can */
+static void ServiceExpire(epg_service_t *p_service, int64_t i_now)
+{
+    size_t i_started = EventSearch(p_service->p_events, p_service->i_events, i_now);
+    size_t i_kept = 0;
+
+    for (size_t i = 0; i < i_started; i++)
+    {
+        if (EventEnd(&p_service->p_events[i]) > i_now)
+            p_service->p_events[i_kept++] = p_service->p_events[i];
+    }
+    if (i_kept == i_started)
+        return;
+    memmove(p_service->p_events + i_kept, p_service->p_events + i_started,
+            (p_service->i_events - i_started) * sizeof(dvbpsi_epg_event_t));
+    p_service->i_events -= i_started - i_kept;
+}
+
+/*****************************************************************************
+ * Sections
+ *****************************************************************************/
+/* A new version of a table: drop the sections of the other versions, which
+ * the new one may not have, and their events */
+static void ServiceDropVersions(epg_service_t *p_service, uint8_t i_table, uint8_t i_version)
+{
+    size_t i_first = SectionSearch(p_service, (uint16_t)i_table << 8);
+    size_t i_last = SectionSearch(p_service, (uint16_t)(i_table + 1) << 8);
+    uint32_t p_dropped[256 / 32] = { 0 };
+    size_t i_kept = i_first;
+    bool b_dropped = false;
+
+    for (size_t i = i_first; i < i_last; i++)
+    {
+        epg_section_t *p_section = &p_service->p_sections[i];
+        if (p_section->i_version == i_version)
+        {
+            p_service->p_sections[i_kept++] = *p_section;
+            continue;
+        }
+        p_dropped[(p_section->i_key & 0xff) / 32] |= UINT32_C(1) << (p_section->i_key % 32);
+        free(p_section->p_data);
+        b_dropped = true;
+    }
+    if (!b_dropped)
+        return;
+    memmove(p_service->p_sections + i_kept, p_service->p_sections + i_last,
+            (p_service->i_sections - i_last) * sizeof(epg_section_t));
+    p_service->i_sections -= i_last - i_kept;
+
+    i_kept = 0;
+    for (size_t i = 0; i < p_service->i_events; i++)
+    {
+        const uint16_t i_section = p_service->p_events[i].i_section;
+        if ((i_section >> 8) == i_table
+         && (p_dropped[(i_section & 0xff) / 32] & (UINT32_C(1) << (i_section % 32))))
+            continue;
+        p_service->p_events[i_kept++] = p_service->p_events[i];
+    }
+    p_service->i_events = i_kept;
+}
+
+static bool IdSearch(const uint16_t *p_ids, size_t i_ids, uint16_t i_id)
+{
+    size_t i_low = 0, i_high = i_ids;
+    while (i_low < i_high)
+    {
+        size_t i_mid = i_low + (i_high - i_low) / 2;
+        if (p_ids[i_mid] == i_id)
+            return true;
+        if (p_ids[i_mid] < i_id)
+            i_low = i_mid + 1;
+        else
+            i_high = i_mid;
+    }
+    return false;
+}
+
+/* Parse the events of a section, copied to p_data, sorted by start time.
+ * Events without a start time and events which ended are skipped. */
+static size_t SectionEvents(const uint8_t *p_data, size_t i_size, int64_t i_now,
+                            uint16_t i_section, dvbpsi_epg_event_t *p_events)
+{
+    dvbpsi_reader_t reader;
+    size_t i_events = 0;
+
+    dvbpsi_reader_init(&reader, p_data + 14, p_data + i_size - 4);
+    while (dvbpsi_reader_next(&reader, 12))
+    {
+        dvbpsi_epg_event_t event;
+        uint16_t i_flags;
+        size_t i;
+
+        event.i_event_id = dvbpsi_read16(&reader);
+        event.i_start = dvbpsi_mjd_to_unix(dvbpsi_read40(&reader));
+        event.i_duration = dvbpsi_bcd_to_seconds(dvbpsi_read24(&reader));
+        i_flags = dvbpsi_read16(&reader);
+        event.i_running_status = i_flags >> 13;
+        event.b_free_ca = (i_flags & 0x1000) != 0;
+        event.i_descriptors_length = i_flags & 0x0fff;
+        event.p_descriptors = reader.p;
+        event.i_section = i_section;
+        if (!dvbpsi_reader_need(&reader, event.i_descriptors_length))
+            break;
+        dvbpsi_reader_skip(&reader, event.i_descriptors_length);
+
+        /* undefined start_time of the NVOD reference events */
+        if (event.i_start == DVBPSI_TIME_UNDEFINED || EventEnd(&event) <= i_now)
+            continue;
+
+        for (i = i_events; i > 0 && p_events[i - 1].i_start > event.i_start; i--)
+            p_events[i] = p_events[i - 1];
+        p_events[i] = event;
+        i_events++;
+    }
+    return i_events;
+}
+
+/* Replace the events of section i_key and those with the same event_id by
+ * the new ones, keeping the array sorted */
+static bool ServiceMerge(epg_service_t *p_service, uint16_t i_key,
+                         const dvbpsi_epg_event_t *p_new, size_t i_new)
+{
+    uint16_t p_ids[EPG_MAX_EVENTS];
+    size_t i_kept = 0, i_total;
+
+    for (size_t i = 0; i < i_new; i++)
+    {
+        size_t j;
+        for (j = i; j > 0 && p_ids[j - 1] > p_new[i].i_event_id; j--)
+            p_ids[j] = p_ids[j - 1];
+        p_ids[j] = p_new[i].i_event_id;
+    }
+
+    i_total = p_service->i_events + i_new;
+    if (i_total > p_service->i_events_max)
+    {
+        size_t i_max = p_service->i_events_max ? p_service->i_events_max * 2 : 32;
+        dvbpsi_epg_event_t *p_events;
+        while (i_max < i_total)
+            i_max *= 2;
+        p_events = realloc(p_service->p_events, i_max * sizeof(dvbpsi_epg_event_t));
+        if (!p_events)
+            return false;
+        p_service->p_events = p_events;
+        p_service->i_events_max = i_max;
+    }
+
+    for (size_t i = 0; i < p_service->i_events; i++)
+    {
+        const dvbpsi_epg_event_t *p_event = &p_service->p_events[i];
+        if (p_event->i_section == i_key || IdSearch(p_ids, i_new, p_event->i_event_id))
+            continue;
+        p_service->p_events[i_kept++] = *p_event;
+    }
+
+    /* merge from the end */
+    p_service->i_events = i_kept + i_new;
+    for (size_t i_out = p_service->i_events; i_new > 0; i_out--)
+    {
+        if (i_kept > 0 && p_service->p_events[i_kept - 1].i_start > p_new[i_new - 1].i_start)
+            p_service->p_events[i_out - 1] = p_service->p_events[--i_kept];
+        else
+            p_service->p_events[i_out - 1] = p_new[--i_new];
+    }
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_epg_new
+ *****************************************************************************/
+dvbpsi_epg_t *dvbpsi_epg_new(void)
+{
+    dvbpsi_epg_t *p_epg = calloc(1, sizeof(dvbpsi_epg_t));
+    if (!p_epg)
+        return NULL;
+    p_epg->pp_buckets = calloc(EPG_BUCKETS, sizeof(epg_service_t *));
+    if (!p_epg->pp_buckets)
+    {
+        free(p_epg);
+        return NULL;
+    }
+    p_epg->i_buckets = EPG_BUCKETS;
+    p_epg->i_now = INT64_MIN;
+    return p_epg;
+}
+
+/*****************************************************************************
+ * dvbpsi_epg_delete
+ *****************************************************************************/
+void dvbpsi_epg_delete(dvbpsi_epg_t *p_epg)
+{
+    if (!p_epg)
+        return;
+
+    while (p_epg->p_taps)
+        dvbpsi_epg_detach(p_epg, p_epg->p_taps->p_dvbpsi);
+
+    for (size_t i = 0; i < p_epg->i_buckets; i++)
+    {
+        epg_service_t *p_service = p_epg->pp_buckets[i];
+        while (p_service)
+        {
+            epg_service_t *p_next = p_service->p_next;
+            ServiceDelete(p_service);
+            p_service = p_next;
+        }
+    }
+    free(p_epg->pp_buckets);
+    free(p_epg);
+}
+
+/*****************************************************************************
+ * dvbpsi_epg_attach
+ *****************************************************************************/
+static void EpgTap(dvbpsi_t *p_dvbpsi, const dvbpsi_psi_section_t *p_section,
+                   void *p_cb_data)
+{
+    epg_tap_t *p_tap = p_cb_data;
+    (void)p_dvbpsi;
+
+    if (p_section->i_table_id >= 0x4e && p_section->i_table_id <= 0x6f)
+        dvbpsi_epg_push_section(p_tap->p_epg, p_section->p_data, 3 + p_section->i_length);
+}
+
+bool dvbpsi_epg_attach(dvbpsi_epg_t *p_epg, dvbpsi_t *p_dvbpsi)
+{
+    epg_tap_t *p_tap = malloc(sizeof(epg_tap_t));
+    if (!p_tap)
+        return false;
+
+    dvbpsi_epg_detach(p_epg, p_dvbpsi);
+    p_tap->p_epg = p_epg;
+    p_tap->p_dvbpsi = p_dvbpsi;
+    if (!dvbpsi_section_tap_add(p_dvbpsi, EpgTap, p_tap))
+    {
+        free(p_tap);
+        return false;
+    }
+    p_tap->p_next = p_epg->p_taps;
+    p_epg->p_taps = p_tap;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_epg_detach
+ *****************************************************************************/
+void dvbpsi_epg_detach(dvbpsi_epg_t *p_epg, dvbpsi_t *p_dvbpsi)
+{
+    for (epg_tap_t **pp_tap = &p_epg->p_taps; *pp_tap; pp_tap = &(*pp_tap)->p_next)
+    {
+        epg_tap_t *p_tap = *pp_tap;
+        if (p_tap->p_dvbpsi != p_dvbpsi)
+            continue;
+        dvbpsi_section_tap_remove(p_dvbpsi, EpgTap, p_tap);
+        *pp_tap = p_tap->p_next;
+        free(p_tap);
+        return;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_epg_push_section
+ *****************************************************************************/
+bool dvbpsi_epg_push_section(dvbpsi_epg_t *p_epg, const uint8_t *p_data, size_t i_size)
+{
+    dvbpsi_epg_event_t p_events[EPG_MAX_EVENTS];
+    epg_service_t *p_service;
+    epg_section_t *p_section;
+    uint16_t i_key;
+    uint8_t i_version;
+    uint32_t i_crc;
+    uint8_t *p_copy;
+    size_t i_index, i_events;
+
+    if (i_size < 14 + 4 || i_size > 4096
+     || p_data[0] < 0x4e || p_data[0] > 0x6f
+     || !(p_data[1] & 0x80) || !(p_data[5] & 0x01)
+     || i_size != 3 + (size_t)(dvbpsi_get16(p_data + 1) & 0x0fff))
+        return false;
+
+    p_service = ServiceGet(p_epg, ServiceKey(dvbpsi_get16(p_data + 10),
+                                             dvbpsi_get16(p_data + 8),
+                                             dvbpsi_get16(p_data + 3)));
+    if (!p_service)
+        return false;
+
+    i_key = (uint16_t)(p_data[0] - 0x4e) << 8 | p_data[6];
+    i_version = (p_data[5] & 0x3e) >> 1;
+    ServiceDropVersions(p_service, p_data[0] - 0x4e, i_version);
+    i_crc = dvbpsi_get32(p_data + i_size - 4);
+    i_index = SectionSearch(p_service, i_key);
+    p_section = i_index < p_service->i_sections ? &p_service->p_sections[i_index] : NULL;
+    if (p_section && p_section->i_key != i_key)
+        p_section = NULL;
+
+    /* a repetition, as far as the CRC tells */
+    if (p_section && p_section->i_crc == i_crc)
+        return true;
+
+    if (!p_section && p_service->i_sections == p_service->i_sections_max)
+    {
+        size_t i_max = p_service->i_sections_max ? p_service->i_sections_max * 2 : 16;
+        epg_section_t *p_sections = realloc(p_service->p_sections,
+                                            i_max * sizeof(epg_section_t));
+        if (!p_sections)
+            return false;
+        p_service->p_sections = p_sections;
+        p_service->i_sections_max = i_max;
+    }
+
+    p_copy = malloc(i_size);
+    if (!p_copy)
+        return false;
+    memcpy(p_copy, p_data, i_size);
+
+    i_events = SectionEvents(p_copy, i_size, p_epg->i_now, i_key, p_events);
+    if (!ServiceMerge(p_service, i_key, p_events, i_events))
+    {
+        free(p_copy);
+        return false;
+    }
+
+    if (!p_section)
+    {
+        memmove(p_service->p_sections + i_index + 1, p_service->p_sections + i_index,
+                (p_service->i_sections - i_index) * sizeof(epg_section_t));
+        p_service->i_sections++;
+        p_section = &p_service->p_sections[i_index];
+        p_section->i_key = i_key;
+        p_section->p_data = NULL;
+    }
+    free(p_section->p_data);
+    p_section->p_data = p_copy;
+    p_section->i_version = i_version;
+    p_section->i_crc = i_crc;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_epg_set_time
+ *****************************************************************************/
+void dvbpsi_epg_set_time(dvbpsi_epg_t *p_epg, int64_t i_now)
+{
+    if (i_now <= p_epg->i_now)
+        return;
+    p_epg->i_now = i_now;
+
+    for (size_t i = 0; i < p_epg->i_buckets; i++)
+    {
+        for (epg_service_t *p_service = p_epg->pp_buckets[i]; p_service;
+             p_service = p_service->p_next)
+            ServiceExpire(p_service, i_now);
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_epg_events
+ *****************************************************************************/
+const dvbpsi_epg_event_t *dvbpsi_epg_events(dvbpsi_epg_t *p_epg, uint16_t i_network_id,
+                                            uint16_t i_ts_id, uint16_t i_service_id,
+                                            size_t *pi_count)
+{
+    const epg_service_t *p_service =
+            ServiceFind(p_epg, ServiceKey(i_network_id, i_ts_id, i_service_id));
+
+    *pi_count = p_service ? p_service->i_events : 0;
+    return *pi_count ? p_service->p_events : NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_epg_range
+ *****************************************************************************/
+const dvbpsi_epg_event_t *dvbpsi_epg_range(dvbpsi_epg_t *p_epg, uint16_t i_network_id,
+                                           uint16_t i_ts_id, uint16_t i_service_id,
+                                           int64_t i_from, int64_t i_to, size_t *pi_count)
+{
+    const epg_service_t *p_service =
+            ServiceFind(p_epg, ServiceKey(i_network_id, i_ts_id, i_service_id));
+    size_t i_first, i_last;
+
+    *pi_count = 0;
+    if (!p_service || i_from >= i_to)
+        return NULL;
+
+    /* the events of a service do not overlap: only the last one starting
+     * before i_from may still run */
+    i_first = EventSearch(p_service->p_events, p_service->i_events, i_from);
+    if (i_first > 0 && EventEnd(&p_service->p_events[i_first - 1]) > i_from)
+        i_first--;
+    i_last = EventSearch(p_service->p_events, p_service->i_events, i_to - 1);
+    if (i_last <= i_first)
+        return NULL;
+
+    *pi_count = i_last - i_first;
+    return &p_service->p_events[i_first];
+}
+
+/*****************************************************************************
+ * dvbpsi_epg_now_next
+ *****************************************************************************/
+bool dvbpsi_epg_now_next(dvbpsi_epg_t *p_epg, uint16_t i_network_id,
+                         uint16_t i_ts_id, uint16_t i_service_id, int64_t i_time,
+                         const dvbpsi_epg_event_t **pp_now,
+                         const dvbpsi_epg_event_t **pp_next)
+{
+    const epg_service_t *p_service =
+            ServiceFind(p_epg, ServiceKey(i_network_id, i_ts_id, i_service_id));
+    size_t i_next;
+
+    *pp_now = *pp_next = NULL;
+    if (!p_service)
+        return false;
+
+    i_next = EventSearch(p_service->p_events, p_service->i_events, i_time);
+    if (i_next > 0 && EventEnd(&p_service->p_events[i_next - 1]) > i_time)
+        *pp_now = &p_service->p_events[i_next - 1];
+    if (i_next < p_service->i_events)
+        *pp_next = &p_service->p_events[i_next];
+    return *pp_now || *pp_next;
+}
@@ -0,0 +1,231 @@
+/*****************************************************************************
+ * epg.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <epg.h>
+ * \brief Electronic programme guide built from the EIT sections.
+ *
+ * The EPG database takes the EIT sections, present/following and schedule,
+ * actual and other, of all the services, without decoding them into
+ * dvbpsi_eit_t tables. The events of each service are kept in an array
+ * sorted by start time:
+ * - a section seen again with the same CRC is skipped, a changed section
+ *   replaces the events it carried before;
+ * - an event is listed once even if several sections carry it, the last
+ *   section wins;
+ * - events that ended before the time given to dvbpsi_epg_set_time() are
+ *   removed.
+ *
+ * The queries are binary searches returning pointers into the arrays, they
+ * do not allocate. The returned events are valid until the next call to a
+ * function changing the database. The database is not thread safe.
+ */
+
+#ifndef _DVBPSI_EPG_H_
+#define _DVBPSI_EPG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * dvbpsi_epg_event_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_epg_event_s
+ * \brief An event of the EPG.
+ */
+/*!
+ * \typedef struct dvbpsi_epg_event_s dvbpsi_epg_event_t
+ * \brief dvbpsi_epg_event_t type definition.
+ */
+typedef struct dvbpsi_epg_event_s
+{
+    int64_t         i_start;                /*!< start_time, in seconds since
+                                                 the Unix epoch (UTC) */
+    uint32_t        i_duration;             /*!< duration, in seconds */
+    uint16_t        i_event_id;             /*!< event_id */
+    uint8_t         i_running_status;       /*!< running_status */
+    bool            b_free_ca;              /*!< free_CA_mode */
+    uint16_t        i_descriptors_length;   /*!< descriptors_loop_length */
+    const uint8_t  *p_descriptors;          /*!< raw descriptors loop */
+
+    /* private */
+    uint16_t        i_section;
+} dvbpsi_epg_event_t;
+
+/*****************************************************************************
+ * dvbpsi_epg_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_epg_s dvbpsi_epg_t
+ * \brief Opaque EPG database handle.
+ */
+typedef struct dvbpsi_epg_s dvbpsi_epg_t;
+
+/*****************************************************************************
+ * dvbpsi_epg_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_epg_t *dvbpsi_epg_new(void)
+ * \brief Create an empty EPG database.
+ * \return the database, NULL on error
+ */
+dvbpsi_epg_t *dvbpsi_epg_new(void);
+
+/*****************************************************************************
+ * dvbpsi_epg_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_epg_delete(dvbpsi_epg_t *p_epg)
+ * \brief Detach a database from its handles and delete it.
+ * \param p_epg the database, may be NULL
+ * \return nothing
+ */
+void dvbpsi_epg_delete(dvbpsi_epg_t *p_epg);
+
+/*****************************************************************************
+ * dvbpsi_epg_attach
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_epg_attach(dvbpsi_epg_t *p_epg, dvbpsi_t *p_dvbpsi)
+ * \brief Feed the database with the EIT sections of a handle, through its
+ * section tap. The other taps of the handle, for instance of a warm start
+ * recorder, are kept.
+ * \param p_epg the database
+ * \param p_dvbpsi handle of the EIT PID
+ * \return false on allocation failure
+ */
+bool dvbpsi_epg_attach(dvbpsi_epg_t *p_epg, dvbpsi_t *p_dvbpsi);
+
+/*****************************************************************************
+ * dvbpsi_epg_detach
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_epg_detach(dvbpsi_epg_t *p_epg, dvbpsi_t *p_dvbpsi)
+ * \brief Stop feeding the database with the sections of a handle, removing
+ * its section tap only.
+ * \param p_epg the database
+ * \param p_dvbpsi the handle
+ * \return nothing
+ */
+void dvbpsi_epg_detach(dvbpsi_epg_t *p_epg, dvbpsi_t *p_dvbpsi);
+
+/*****************************************************************************
+ * dvbpsi_epg_push_section
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_epg_push_section(dvbpsi_epg_t *p_epg,
+                                    const uint8_t *p_data, size_t i_size)
+ * \brief Feed the database with an EIT section whose CRC was checked.
+ * \param p_epg the database
+ * \param p_data the section, from its table_id
+ * \param i_size size of the section
+ * \return false when it is not an applicable EIT section or on allocation
+ * failure
+ */
+bool dvbpsi_epg_push_section(dvbpsi_epg_t *p_epg, const uint8_t *p_data, size_t i_size);
+
+/*****************************************************************************
+ * dvbpsi_epg_set_time
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_epg_set_time(dvbpsi_epg_t *p_epg, int64_t i_now)
+ * \brief Set the current time, typically from the TDT, removing the events
+ * which ended. Events which already ended are not added any more.
+ * \param p_epg the database
+ * \param i_now the time, in seconds since the Unix epoch (UTC)
+ * \return nothing
+ */
+void dvbpsi_epg_set_time(dvbpsi_epg_t *p_epg, int64_t i_now);
+
+/*****************************************************************************
+ * dvbpsi_epg_events
+ *****************************************************************************/
+/*!
+ * \fn const dvbpsi_epg_event_t *dvbpsi_epg_events(dvbpsi_epg_t *p_epg,
+            uint16_t i_network_id, uint16_t i_ts_id, uint16_t i_service_id,
+            size_t *pi_count)
+ * \brief Get all the events of a service, sorted by start time.
+ * \param p_epg the database
+ * \param i_network_id original_network_id
+ * \param i_ts_id transport_stream_id
+ * \param i_service_id service_id
+ * \param pi_count filled with the number of events
+ * \return the first event, NULL if there is none
+ */
+const dvbpsi_epg_event_t *dvbpsi_epg_events(dvbpsi_epg_t *p_epg, uint16_t i_network_id,
+                                            uint16_t i_ts_id, uint16_t i_service_id,
+                                            size_t *pi_count);
+
+/*****************************************************************************
+ * dvbpsi_epg_range
+ *****************************************************************************/
+/*!
+ * \fn const dvbpsi_epg_event_t *dvbpsi_epg_range(dvbpsi_epg_t *p_epg,
+            uint16_t i_network_id, uint16_t i_ts_id, uint16_t i_service_id,
+            int64_t i_from, int64_t i_to, size_t *pi_count)
+ * \brief Get the events of a service between two times, sorted by start
+ * time.
+ * \param p_epg the database
+ * \param i_network_id original_network_id
+ * \param i_ts_id transport_stream_id
+ * \param i_service_id service_id
+ * \param i_from the events ending after i_from
+ * \param i_to and starting before i_to
+ * \param pi_count filled with the number of events
+ * \return the first event, NULL if there is none
+ */
+const dvbpsi_epg_event_t *dvbpsi_epg_range(dvbpsi_epg_t *p_epg, uint16_t i_network_id,
+                                           uint16_t i_ts_id, uint16_t i_service_id,
+                                           int64_t i_from, int64_t i_to, size_t *pi_count);
+
+/*****************************************************************************
+ * dvbpsi_epg_now_next
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_epg_now_next(dvbpsi_epg_t *p_epg, uint16_t i_network_id,
+            uint16_t i_ts_id, uint16_t i_service_id, int64_t i_time,
+            const dvbpsi_epg_event_t **pp_now,
+            const dvbpsi_epg_event_t **pp_next)
+ * \brief Get the event of a service running at a time and the next one.
+ * \param p_epg the database
+ * \param i_network_id original_network_id
+ * \param i_ts_id transport_stream_id
+ * \param i_service_id service_id
+ * \param i_time the time, in seconds since the Unix epoch (UTC)
+ * \param pp_now filled with the running event, or NULL
+ * \param pp_next filled with the next event, or NULL
+ * \return false when neither event is known
+ */
+bool dvbpsi_epg_now_next(dvbpsi_epg_t *p_epg, uint16_t i_network_id,
+                         uint16_t i_ts_id, uint16_t i_service_id, int64_t i_time,
+                         const dvbpsi_epg_event_t **pp_now,
+                         const dvbpsi_epg_event_t **pp_next);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of epg.h"
+#endif
@@ -0,0 +1,101 @@
+/*****************************************************************************
+ * lock_private.h: lock of the structures shared between threads
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#ifndef _DVBPSI_LOCK_PRIVATE_H_
+#define _DVBPSI_LOCK_PRIVATE_H_
+
+/*****************************************************************************
+ * dvbpsi_lock_t
+ *****************************************************************************
+ * A POSIX mutex when the threads are available, so that a waiting thread
+ * sleeps instead of spinning while the holder is preempted. Otherwise a
+ * spin lock backing off exponentially, for the GCC compatible compilers.
+ * The critical sections must stay short and must not call back the user.
+ *****************************************************************************/
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+
+typedef pthread_mutex_t dvbpsi_lock_t;
+
+static inline bool dvbpsi_lock_init(dvbpsi_lock_t *p_lock)
+{
+    return pthread_mutex_init(p_lock, NULL) == 0;
+}
+
+static inline void dvbpsi_lock_destroy(dvbpsi_lock_t *p_lock)
+{
+    pthread_mutex_destroy(p_lock);
+}
+
+static inline void dvbpsi_lock(dvbpsi_lock_t *p_lock)
+{
+    pthread_mutex_lock(p_lock);
+}
+
+static inline void dvbpsi_unlock(dvbpsi_lock_t *p_lock)
+{
+    pthread_mutex_unlock(p_lock);
+}
+
+#else /* HAVE_PTHREAD */
+
+typedef bool dvbpsi_lock_t;
+
+static inline bool dvbpsi_lock_init(dvbpsi_lock_t *p_lock)
+{
+    *p_lock = false;
+    return true;
+}
+
+static inline void dvbpsi_lock_destroy(dvbpsi_lock_t *p_lock)
+{
+    (void)p_lock;
+}
+
+static inline void dvbpsi_lock(dvbpsi_lock_t *p_lock)
+{
+    unsigned int i_spins = 1;
+
+    while (__atomic_test_and_set(p_lock, __ATOMIC_ACQUIRE))
+    {
+        do
+        {
+            for (volatile unsigned int i = 0; i < i_spins; i++)
+                ;
+            if (i_spins < 1024)
+                i_spins *= 2;
+        } while (__atomic_load_n(p_lock, __ATOMIC_RELAXED));
+    }
+}
+
+static inline void dvbpsi_unlock(dvbpsi_lock_t *p_lock)
+{
+    __atomic_clear(p_lock, __ATOMIC_RELEASE);
+}
+
+#endif /* HAVE_PTHREAD */
+
+#else
+#error "Multiple inclusions of lock_private.h"
+#endif
@@ -0,0 +1,317 @@
+/*****************************************************************************
+ * metrics.c: repetition intervals of the sections
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "dvbpsi_private.h"
+#include "psi.h"
+#include "metrics.h"
+
+/* Upper limits of the histogram buckets, in microseconds */
+static const int64_t metrics_limits[DVBPSI_METRICS_BUCKETS - 1] =
+{
+    25000, 50000, 100000, 250000, 500000,
+    1000000, 2000000, 5000000, 10000000, 30000000
+};
+
+typedef struct metrics_tap_s
+{
+    dvbpsi_metrics_t       *p_metrics;
+    dvbpsi_t               *p_dvbpsi;
+    uint16_t                i_pid;
+    struct metrics_tap_s   *p_next;
+} metrics_tap_t;
+
+struct dvbpsi_metrics_s
+{
+    /* sections, in their order of first arrival */
+    dvbpsi_section_metrics_t *p_sections;
+    size_t                  i_sections;
+    size_t                  i_sections_max;
+
+    /* open addressing index of p_sections, index + 1 or 0 if free */
+    uint32_t               *p_index;
+    size_t                  i_index_mask;
+
+    int64_t                 i_now;
+    metrics_tap_t          *p_taps;
+};
+
+static inline uint64_t MetricsKey(uint16_t i_pid, uint8_t i_table_id,
+                                  uint16_t i_extension, uint8_t i_section_number)
+{
+    return (uint64_t)i_pid << 32 | (uint64_t)i_table_id << 24
+         | (uint64_t)i_extension << 8 | i_section_number;
+}
+
+static inline uint64_t MetricsSectionKey(const dvbpsi_section_metrics_t *p_section)
+{
+    return MetricsKey(p_section->i_pid, p_section->i_table_id,
+                      p_section->i_extension, p_section->i_section_number);
+}
+
+static inline size_t MetricsHash(uint64_t i_key, size_t i_mask)
+{
+    return (size_t)((i_key * UINT64_C(0x9e3779b97f4a7c15)) >> 32) & i_mask;
+}
+
+/* Slot of a key: the one holding it or the free one where it would go */
+static uint32_t *MetricsSlot(dvbpsi_metrics_t *p_metrics, uint64_t i_key)
+{
+    size_t i = MetricsHash(i_key, p_metrics->i_index_mask);
+    for (;;)
+    {
+        uint32_t *p_slot = &p_metrics->p_index[i];
+        if (*p_slot == 0
+         || MetricsSectionKey(&p_metrics->p_sections[*p_slot - 1]) == i_key)
+            return p_slot;
+        i = (i + 1) & p_metrics->i_index_mask;
+    }
+}
+
+static bool MetricsGrow(dvbpsi_metrics_t *p_metrics)
+{
+    size_t i_max = p_metrics->i_sections_max ? p_metrics->i_sections_max * 2 : 64;
+    dvbpsi_section_metrics_t *p_sections;
+    uint32_t *p_index;
+
+    p_sections = realloc(p_metrics->p_sections, i_max * sizeof(dvbpsi_section_metrics_t));
+    if (!p_sections)
+        return false;
+    p_metrics->p_sections = p_sections;
+
+    /* the index stays at most half full */
+    p_index = calloc(2 * i_max, sizeof(uint32_t));
+    if (!p_index)
+        return false;
+    p_metrics->i_sections_max = i_max;
+    free(p_metrics->p_index);
+    p_metrics->p_index = p_index;
+    p_metrics->i_index_mask = 2 * i_max - 1;
+    for (size_t i = 0; i < p_metrics->i_sections; i++)
+        *MetricsSlot(p_metrics, MetricsSectionKey(&p_sections[i])) = i + 1;
+    return true;
+}
+
+static void MetricsRecord(dvbpsi_metrics_t *p_metrics, uint16_t i_pid, uint8_t i_table_id,
+                          uint16_t i_extension, uint8_t i_section_number, int64_t i_time,
+                          bool *pb_error)
+{
+    const uint64_t i_key = MetricsKey(i_pid, i_table_id, i_extension, i_section_number);
+    dvbpsi_section_metrics_t *p_section;
+    uint32_t *p_slot;
+    int64_t i_interval;
+    unsigned int i_bucket;
+
+    if (p_metrics->i_sections == p_metrics->i_sections_max && !MetricsGrow(p_metrics))
+    {
+        *pb_error = true;
+        return;
+    }
+
+    p_slot = MetricsSlot(p_metrics, i_key);
+    if (*p_slot == 0)
+    {
+        p_section = &p_metrics->p_sections[p_metrics->i_sections++];
+        *p_slot = p_metrics->i_sections;
+        memset(p_section, 0, sizeof(dvbpsi_section_metrics_t));
+        p_section->i_pid = i_pid;
+        p_section->i_table_id = i_table_id;
+        p_section->i_extension = i_extension;
+        p_section->i_section_number = i_section_number;
+        p_section->i_count = 1;
+        p_section->i_last = i_time;
+        return;
+    }
+
+    p_section = &p_metrics->p_sections[*p_slot - 1];
+    i_interval = i_time - p_section->i_last;
+    if (p_section->i_count == 1 || i_interval < p_section->i_min)
+        p_section->i_min = i_interval;
+    if (p_section->i_count == 1 || i_interval > p_section->i_max)
+        p_section->i_max = i_interval;
+    p_section->i_total += i_interval;
+    for (i_bucket = 0; i_bucket < DVBPSI_METRICS_BUCKETS - 1; i_bucket++)
+        if (i_interval <= metrics_limits[i_bucket])
+            break;
+    p_section->p_histogram[i_bucket]++;
+    p_section->i_count++;
+    p_section->i_last = i_time;
+}
+
+/*****************************************************************************
+ * dvbpsi_metrics_new
+ *****************************************************************************/
+dvbpsi_metrics_t *dvbpsi_metrics_new(void)
+{
+    return calloc(1, sizeof(dvbpsi_metrics_t));
+}
+
+/*****************************************************************************
+ * dvbpsi_metrics_delete
+ *****************************************************************************/
+void dvbpsi_metrics_delete(dvbpsi_metrics_t *p_metrics)
+{
+    if (!p_metrics)
+        return;
+    while (p_metrics->p_taps)
+        dvbpsi_metrics_detach(p_metrics, p_metrics->p_taps->p_dvbpsi);
+    free(p_metrics->p_sections);
+    free(p_metrics->p_index);
+    free(p_metrics);
+}
+
+/*****************************************************************************
+ * dvbpsi_metrics_attach
+ *****************************************************************************/
+static void MetricsTap(dvbpsi_t *p_dvbpsi, const dvbpsi_psi_section_t *p_section,
+                       void *p_cb_data)
+{
+    metrics_tap_t *p_tap = p_cb_data;
+    bool b_error = false;
+
+    MetricsRecord(p_tap->p_metrics, p_tap->i_pid, p_section->i_table_id,
+                  p_section->i_extension, p_section->i_number,
+                  p_tap->p_metrics->i_now, &b_error);
+    if (b_error)
+        dvbpsi_error(p_dvbpsi, "metrics", "out of memory");
+}
+
+bool dvbpsi_metrics_attach(dvbpsi_metrics_t *p_metrics, dvbpsi_t *p_dvbpsi, uint16_t i_pid)
+{
+    metrics_tap_t *p_tap = malloc(sizeof(metrics_tap_t));
+    if (!p_tap)
+        return false;
+
+    dvbpsi_metrics_detach(p_metrics, p_dvbpsi);
+    p_tap->p_metrics = p_metrics;
+    p_tap->p_dvbpsi = p_dvbpsi;
+    p_tap->i_pid = i_pid;
+    if (!dvbpsi_section_tap_add(p_dvbpsi, MetricsTap, p_tap))
+    {
+        free(p_tap);
+        return false;
+    }
+    p_tap->p_next = p_metrics->p_taps;
+    p_metrics->p_taps = p_tap;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_metrics_detach
+ *****************************************************************************/
+void dvbpsi_metrics_detach(dvbpsi_metrics_t *p_metrics, dvbpsi_t *p_dvbpsi)
+{
+    for (metrics_tap_t **pp_tap = &p_metrics->p_taps; *pp_tap; pp_tap = &(*pp_tap)->p_next)
+    {
+        metrics_tap_t *p_tap = *pp_tap;
+        if (p_tap->p_dvbpsi != p_dvbpsi)
+            continue;
+        dvbpsi_section_tap_remove(p_dvbpsi, MetricsTap, p_tap);
+        *pp_tap = p_tap->p_next;
+        free(p_tap);
+        return;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_metrics_set_time
+ *****************************************************************************/
+void dvbpsi_metrics_set_time(dvbpsi_metrics_t *p_metrics, int64_t i_time)
+{
+    p_metrics->i_now = i_time;
+}
+
+/*****************************************************************************
+ * dvbpsi_metrics_push_section
+ *****************************************************************************/
+bool dvbpsi_metrics_push_section(dvbpsi_metrics_t *p_metrics, uint16_t i_pid,
+                                 const uint8_t *p_data, size_t i_size, int64_t i_time)
+{
+    bool b_error = false;
+
+    if (i_size < 3)
+        return false;
+    if (p_data[1] & 0x80)
+    {
+        if (i_size < 8)
+            return false;
+        MetricsRecord(p_metrics, i_pid, p_data[0], (uint16_t)p_data[3] << 8 | p_data[4],
+                      p_data[6], i_time, &b_error);
+    }
+    else
+        MetricsRecord(p_metrics, i_pid, p_data[0], 0, 0, i_time, &b_error);
+    return !b_error;
+}
+
+/*****************************************************************************
+ * dvbpsi_metrics_get
+ *****************************************************************************/
+const dvbpsi_section_metrics_t *dvbpsi_metrics_get(dvbpsi_metrics_t *p_metrics,
+                                                   uint16_t i_pid, uint8_t i_table_id,
+                                                   uint16_t i_extension,
+                                                   uint8_t i_section_number)
+{
+    uint32_t *p_slot;
+
+    if (!p_metrics->i_sections)
+        return NULL;
+    p_slot = MetricsSlot(p_metrics, MetricsKey(i_pid, i_table_id, i_extension,
+                                               i_section_number));
+    return *p_slot ? &p_metrics->p_sections[*p_slot - 1] : NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_metrics_list
+ *****************************************************************************/
+const dvbpsi_section_metrics_t *dvbpsi_metrics_list(dvbpsi_metrics_t *p_metrics,
+                                                    size_t *pi_count)
+{
+    *pi_count = p_metrics->i_sections;
+    return p_metrics->p_sections;
+}
+
+/*****************************************************************************
+ * dvbpsi_metrics_reset
+ *****************************************************************************/
+void dvbpsi_metrics_reset(dvbpsi_metrics_t *p_metrics)
+{
+    if (p_metrics->p_index)
+        memset(p_metrics->p_index, 0, (p_metrics->i_index_mask + 1) * sizeof(uint32_t));
+    p_metrics->i_sections = 0;
+}
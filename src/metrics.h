@@ -0,0 +1,228 @@
+/*****************************************************************************
+ * metrics.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <metrics.h>
+ * \brief Repetition intervals of the sections.
+ *
+ * The metrics record the arrival time of each section, repetitions
+ * included, and keep the intervals between two arrivals of the same section:
+ * same PID, table_id, table_id_extension and section_number. The times are
+ * given by the caller, in any unit; the histogram limits below assume
+ * microseconds.
+ *
+ * A section costs a hash lookup and a few additions, the metrics can be left
+ * attached to the handles. They are not thread safe.
+ */
+
+#ifndef _DVBPSI_METRICS_H_
+#define _DVBPSI_METRICS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \def DVBPSI_METRICS_BUCKETS
+ * \brief Number of buckets of the interval histogram. Their upper limits
+ * are 25, 50, 100, 250 and 500 ms, 1, 2, 5, 10 and 30 s, the last bucket
+ * counts the longer intervals.
+ */
+#define DVBPSI_METRICS_BUCKETS 11
+
+/*****************************************************************************
+ * dvbpsi_section_metrics_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_section_metrics_s
+ * \brief Repetition intervals of a section.
+ */
+/*!
+ * \typedef struct dvbpsi_section_metrics_s dvbpsi_section_metrics_t
+ * \brief dvbpsi_section_metrics_t type definition.
+ */
+typedef struct dvbpsi_section_metrics_s
+{
+    uint16_t    i_pid;                  /*!< PID */
+    uint8_t     i_table_id;             /*!< table_id */
+    uint16_t    i_extension;            /*!< table_id_extension, 0 without
+                                             the syntax indicator */
+    uint8_t     i_section_number;       /*!< section_number */
+
+    uint64_t    i_count;                /*!< number of arrivals */
+    int64_t     i_last;                 /*!< time of the last arrival */
+    int64_t     i_min;                  /*!< shortest interval */
+    int64_t     i_max;                  /*!< longest interval */
+    int64_t     i_total;                /*!< sum of the i_count - 1
+                                             intervals */
+    uint32_t    p_histogram[DVBPSI_METRICS_BUCKETS]; /*!< intervals per
+                                                          bucket */
+} dvbpsi_section_metrics_t;
+
+/*****************************************************************************
+ * dvbpsi_metrics_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_metrics_s dvbpsi_metrics_t
+ * \brief Opaque section metrics handle.
+ */
+typedef struct dvbpsi_metrics_s dvbpsi_metrics_t;
+
+/*****************************************************************************
+ * dvbpsi_metrics_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_metrics_t *dvbpsi_metrics_new(void)
+ * \brief Create empty section metrics.
+ * \return the metrics, NULL on error
+ */
+dvbpsi_metrics_t *dvbpsi_metrics_new(void);
+
+/*****************************************************************************
+ * dvbpsi_metrics_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_metrics_delete(dvbpsi_metrics_t *p_metrics)
+ * \brief Detach metrics from their handles and delete them.
+ * \param p_metrics the metrics, may be NULL
+ * \return nothing
+ */
+void dvbpsi_metrics_delete(dvbpsi_metrics_t *p_metrics);
+
+/*****************************************************************************
+ * dvbpsi_metrics_attach
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_metrics_attach(dvbpsi_metrics_t *p_metrics,
+                                  dvbpsi_t *p_dvbpsi, uint16_t i_pid)
+ * \brief Record the sections of a handle, decoder or demux, through its
+ * section tap, the other taps of the handle are kept. The sections are
+ * recorded at the time given to dvbpsi_metrics_set_time().
+ * \param p_metrics the metrics
+ * \param p_dvbpsi the handle
+ * \param i_pid PID of the packets pushed to the handle
+ * \return false on allocation failure
+ */
+bool dvbpsi_metrics_attach(dvbpsi_metrics_t *p_metrics, dvbpsi_t *p_dvbpsi, uint16_t i_pid);
+
+/*****************************************************************************
+ * dvbpsi_metrics_detach
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_metrics_detach(dvbpsi_metrics_t *p_metrics,
+                                  dvbpsi_t *p_dvbpsi)
+ * \brief Stop recording the sections of a handle, removing its section tap
+ * only.
+ * \param p_metrics the metrics
+ * \param p_dvbpsi the handle
+ * \return nothing
+ */
+void dvbpsi_metrics_detach(dvbpsi_metrics_t *p_metrics, dvbpsi_t *p_dvbpsi);
+
+/*****************************************************************************
+ * dvbpsi_metrics_set_time
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_metrics_set_time(dvbpsi_metrics_t *p_metrics,
+                                    int64_t i_time)
+ * \brief Set the time of the sections completed by the next packets pushed
+ * to the attached handles, typically the arrival time of the packet about to
+ * be pushed.
+ * \param p_metrics the metrics
+ * \param i_time the time
+ * \return nothing
+ */
+void dvbpsi_metrics_set_time(dvbpsi_metrics_t *p_metrics, int64_t i_time);
+
+/*****************************************************************************
+ * dvbpsi_metrics_push_section
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_metrics_push_section(dvbpsi_metrics_t *p_metrics,
+            uint16_t i_pid, const uint8_t *p_data, size_t i_size,
+            int64_t i_time)
+ * \brief Record the arrival of a section without an attached handle.
+ * \param p_metrics the metrics
+ * \param i_pid PID of the section
+ * \param p_data the section, from its table_id
+ * \param i_size size of the section
+ * \param i_time arrival time of the section
+ * \return false when the section is too short or on allocation failure
+ */
+bool dvbpsi_metrics_push_section(dvbpsi_metrics_t *p_metrics, uint16_t i_pid,
+                                 const uint8_t *p_data, size_t i_size, int64_t i_time);
+
+/*****************************************************************************
+ * dvbpsi_metrics_get
+ *****************************************************************************/
+/*!
+ * \fn const dvbpsi_section_metrics_t *dvbpsi_metrics_get(
+            dvbpsi_metrics_t *p_metrics, uint16_t i_pid, uint8_t i_table_id,
+            uint16_t i_extension, uint8_t i_section_number)
+ * \brief Get the intervals of a section.
+ * \param p_metrics the metrics
+ * \param i_pid PID
+ * \param i_table_id table_id
+ * \param i_extension table_id_extension
+ * \param i_section_number section_number
+ * \return the intervals, valid until the next section is recorded, NULL if
+ * the section was never seen
+ */
+const dvbpsi_section_metrics_t *dvbpsi_metrics_get(dvbpsi_metrics_t *p_metrics,
+                                                   uint16_t i_pid, uint8_t i_table_id,
+                                                   uint16_t i_extension,
+                                                   uint8_t i_section_number);
+
+/*****************************************************************************
+ * dvbpsi_metrics_list
+ *****************************************************************************/
+/*!
+ * \fn const dvbpsi_section_metrics_t *dvbpsi_metrics_list(
+            dvbpsi_metrics_t *p_metrics, size_t *pi_count)
+ * \brief Get the intervals of all the sections seen, in their order of
+ * first arrival.
+ * \param p_metrics the metrics
+ * \param pi_count filled with the number of sections
+ * \return the first section, valid until the next section is recorded
+ */
+const dvbpsi_section_metrics_t *dvbpsi_metrics_list(dvbpsi_metrics_t *p_metrics,
+                                                    size_t *pi_count);
+
+/*****************************************************************************
+ * dvbpsi_metrics_reset
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_metrics_reset(dvbpsi_metrics_t *p_metrics)
+ * \brief Forget all the sections, for instance at the start of a new
+ * measurement period. The handles stay attached.
+ * \param p_metrics the metrics
+ * \return nothing
+ */
+void dvbpsi_metrics_reset(dvbpsi_metrics_t *p_metrics);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of metrics.h"
+#endif
@@ -0,0 +1,736 @@
+/*****************************************************************************
+ * monitor.c: transport stream monitor, TR 101 290 priority 1 and 2 checks
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "psi.h"
+#include "monitor.h"
+
+#define MONITOR_PIDS            8192
+#define MONITOR_NULL_PID        0x1fff
+#define MONITOR_NO_CC           0x10
+#define MONITOR_TICK            INT64_C(100000)
+#define MONITOR_PSI_INTERVAL    INT64_C(500000)
+#define MONITOR_PCR_INTERVAL    INT64_C(100000)
+#define MONITOR_PCR_WRAP        (INT64_C(300) << 33)
+#define MONITOR_PCR_MAX_DELTA   (INT64_C(27000) * 100)
+/* 500 ns in 27 MHz ticks */
+#define MONITOR_PCR_ACCURACY    13.5
+#define MONITOR_MAX_SECTION     4096
+#define MONITOR_MAX_ES          64
+
+/* Roles of a PID */
+#define PID_PSI     0x01    /* sections checked */
+#define PID_PAT     0x02
+#define PID_PMT     0x04
+#define PID_PCR     0x08
+
+/* State of the PSI/SI and PCR PIDs */
+typedef struct monitor_ext_s
+{
+    /* section being reassembled */
+    bool                b_sync;
+    uint16_t            i_have;
+    uint16_t            i_need;
+    uint8_t             p_section[MONITOR_MAX_SECTION];
+
+    /* PAT and PMT */
+    int64_t             i_last_table;   /* last section of the table */
+    bool                b_version;
+    uint8_t             i_version;
+    uint16_t            i_program;
+    uint16_t            i_pcr_pid;
+    unsigned int        i_es;
+    uint16_t            p_es[MONITOR_MAX_ES];
+
+    /* PCR */
+    int64_t             i_pcr_time;     /* arrival of the last PCR */
+    bool                b_pcr;
+    int64_t             i_pcr;
+    uint64_t            i_pcr_packet;
+    double              f_rate;         /* PCR ticks per packet, 0 if unknown */
+} monitor_ext_t;
+
+typedef struct monitor_pid_s
+{
+    int64_t             i_last_seen;
+    monitor_ext_t      *p_ext;
+    uint8_t             i_flags;
+    uint8_t             i_cc;
+    uint8_t             i_duplicates;
+} monitor_pid_t;
+
+struct dvbpsi_monitor_s
+{
+    dvbpsi_monitor_cb   pf_alarm;
+    void               *p_cb_data;
+    int64_t             i_hold;
+    int64_t             i_pid_timeout;
+
+    bool                b_started;
+    int64_t             i_now;
+    int64_t             i_next_tick;
+    uint64_t            i_packets;
+
+    unsigned int        i_bad_sync;
+    unsigned int        i_good_sync;
+    bool                b_sync_lost;
+
+    uint64_t            p_errors[DVBPSI_MONITOR_CHECKS];
+
+    dvbpsi_monitor_alarm_t *p_alarms;
+    size_t              i_alarms;
+    size_t              i_alarms_max;
+
+    uint16_t           *p_pmt_pids;
+    size_t              i_pmt_pids;
+    size_t              i_pmt_pids_max;
+
+    monitor_pid_t       pids[MONITOR_PIDS];
+};
+
+static const char *const monitor_check_names[DVBPSI_MONITOR_CHECKS] =
+{
+    "1.1 TS_sync_loss",
+    "1.2 Sync_byte_error",
+    "1.3 PAT_error_2",
+    "1.4 Continuity_count_error",
+    "1.5 PMT_error_2",
+    "1.6 PID_error",
+    "2.1 Transport_error",
+    "2.2 CRC_error",
+    "2.3a PCR_repetition_error",
+    "2.3b PCR_discontinuity_indicator_error",
+    "2.4 PCR_accuracy_error",
+};
+
+/*****************************************************************************
+ * Alarms
+ *****************************************************************************/
+/* An error, or a condition lasting in time which only counts once */
+static void MonitorError(dvbpsi_monitor_t *p_monitor, dvbpsi_monitor_check_t i_check,
+                         uint16_t i_pid, bool b_condition)
+{
+    dvbpsi_monitor_alarm_t *p_alarm;
+
+    for (size_t i = 0; i < p_monitor->i_alarms; i++)
+    {
+        p_alarm = &p_monitor->p_alarms[i];
+        if (p_alarm->i_check == i_check && p_alarm->i_pid == i_pid)
+        {
+            if (!b_condition)
+            {
+                p_monitor->p_errors[i_check]++;
+                p_alarm->i_errors++;
+            }
+            p_alarm->i_last_error = p_monitor->i_now;
+            return;
+        }
+    }
+
+    p_monitor->p_errors[i_check]++;
+    if (p_monitor->i_alarms == p_monitor->i_alarms_max)
+    {
+        size_t i_max = p_monitor->i_alarms_max ? p_monitor->i_alarms_max * 2 : 16;
+        p_alarm = realloc(p_monitor->p_alarms, i_max * sizeof(dvbpsi_monitor_alarm_t));
+        if (!p_alarm)
+            return;
+        p_monitor->p_alarms = p_alarm;
+        p_monitor->i_alarms_max = i_max;
+    }
+    p_alarm = &p_monitor->p_alarms[p_monitor->i_alarms++];
+    p_alarm->i_check = i_check;
+    p_alarm->i_pid = i_pid;
+    p_alarm->b_raised = true;
+    p_alarm->i_raised = p_alarm->i_last_error = p_monitor->i_now;
+    p_alarm->i_cleared = 0;
+    p_alarm->i_errors = 1;
+    if (p_monitor->pf_alarm)
+        p_monitor->pf_alarm(p_monitor->p_cb_data, p_alarm);
+}
+
+static void MonitorClearAlarms(dvbpsi_monitor_t *p_monitor)
+{
+    size_t i = 0;
+    while (i < p_monitor->i_alarms)
+    {
+        dvbpsi_monitor_alarm_t *p_alarm = &p_monitor->p_alarms[i];
+        if (p_monitor->i_now - p_alarm->i_last_error < p_monitor->i_hold)
+        {
+            i++;
+            continue;
+        }
+        p_alarm->b_raised = false;
+        p_alarm->i_cleared = p_monitor->i_now;
+        if (p_monitor->pf_alarm)
+            p_monitor->pf_alarm(p_monitor->p_cb_data, p_alarm);
+        *p_alarm = p_monitor->p_alarms[--p_monitor->i_alarms];
+    }
+}
+
+/*****************************************************************************
+ * PID roles
+ *****************************************************************************/
+static monitor_ext_t *MonitorExt(dvbpsi_monitor_t *p_monitor, uint16_t i_pid)
+{
+    monitor_pid_t *p_pid = &p_monitor->pids[i_pid];
+    if (!p_pid->p_ext)
+    {
+        p_pid->p_ext = calloc(1, sizeof(monitor_ext_t));
+        if (p_pid->p_ext)
+        {
+            p_pid->p_ext->i_last_table = p_monitor->i_now;
+            p_pid->p_ext->i_pcr_time = p_monitor->i_now;
+            p_pid->p_ext->i_pcr_pid = MONITOR_NULL_PID;
+        }
+    }
+    return p_pid->p_ext;
+}
+
+static bool MonitorIsSi(uint16_t i_pid)
+{
+    /* PAT, CAT, NIT, SDT/BAT, EIT, TDT/TOT */
+    return i_pid <= 0x01 || (i_pid >= 0x10 && i_pid <= 0x14 && i_pid != 0x13);
+}
+
+/* Move the PCR role of a program to another PID, the previous one keeping
+ * it while another program still carries its PCR there */
+static void MonitorSetPcr(dvbpsi_monitor_t *p_monitor, monitor_ext_t *p_pmt, uint16_t i_pcr_pid)
+{
+    const uint16_t i_old = p_pmt->i_pcr_pid;
+
+    if (i_old == i_pcr_pid)
+        return;
+    p_pmt->i_pcr_pid = i_pcr_pid;
+
+    if (i_old != MONITOR_NULL_PID)
+    {
+        bool b_shared = false;
+        for (size_t i = 0; i < p_monitor->i_pmt_pids && !b_shared; i++)
+            b_shared = p_monitor->pids[p_monitor->p_pmt_pids[i]].p_ext->i_pcr_pid == i_old;
+        if (!b_shared)
+            p_monitor->pids[i_old].i_flags &= ~PID_PCR;
+    }
+    if (i_pcr_pid != MONITOR_NULL_PID && MonitorExt(p_monitor, i_pcr_pid))
+        p_monitor->pids[i_pcr_pid].i_flags |= PID_PCR;
+}
+
+static void MonitorAddPmt(dvbpsi_monitor_t *p_monitor, uint16_t i_program, uint16_t i_pid)
+{
+    monitor_pid_t *p_pid = &p_monitor->pids[i_pid];
+    monitor_ext_t *p_ext;
+
+    if (p_pid->i_flags & PID_PMT)
+        return;
+    if (p_monitor->i_pmt_pids == p_monitor->i_pmt_pids_max)
+    {
+        size_t i_max = p_monitor->i_pmt_pids_max ? p_monitor->i_pmt_pids_max * 2 : 16;
+        uint16_t *p_pids = realloc(p_monitor->p_pmt_pids, i_max * sizeof(uint16_t));
+        if (!p_pids)
+            return;
+        p_monitor->p_pmt_pids = p_pids;
+        p_monitor->i_pmt_pids_max = i_max;
+    }
+    p_ext = MonitorExt(p_monitor, i_pid);
+    if (!p_ext)
+        return;
+
+    p_ext->i_last_table = p_monitor->i_now;
+    p_ext->i_program = i_program;
+    p_ext->b_version = false;
+    p_ext->i_pcr_pid = MONITOR_NULL_PID;
+    p_ext->i_es = 0;
+    p_pid->i_flags |= PID_PSI | PID_PMT;
+    p_monitor->p_pmt_pids[p_monitor->i_pmt_pids++] = i_pid;
+}
+
+static void MonitorClearPmts(dvbpsi_monitor_t *p_monitor)
+{
+    for (size_t i = 0; i < p_monitor->i_pmt_pids; i++)
+    {
+        monitor_pid_t *p_pid = &p_monitor->pids[p_monitor->p_pmt_pids[i]];
+        if (p_pid->p_ext->i_pcr_pid != MONITOR_NULL_PID)
+            p_monitor->pids[p_pid->p_ext->i_pcr_pid].i_flags &= ~PID_PCR;
+        p_pid->i_flags &= ~PID_PMT;
+        if (!MonitorIsSi(p_monitor->p_pmt_pids[i]))
+            p_pid->i_flags &= ~PID_PSI;
+    }
+    p_monitor->i_pmt_pids = 0;
+}
+
+/*****************************************************************************
+ * Sections
+ *****************************************************************************/
+static void MonitorPat(dvbpsi_monitor_t *p_monitor, monitor_ext_t *p_ext,
+                       const uint8_t *p_section, size_t i_size)
+{
+    const uint8_t i_version = (p_section[5] >> 1) & 0x1f;
+
+    if (p_ext->b_version && p_ext->i_version != i_version)
+        MonitorClearPmts(p_monitor);
+    p_ext->b_version = true;
+    p_ext->i_version = i_version;
+
+    for (const uint8_t *p = p_section + 8; p + 4 <= p_section + i_size - 4; p += 4)
+    {
+        uint16_t i_program = (uint16_t)p[0] << 8 | p[1];
+        uint16_t i_pid = ((uint16_t)(p[2] & 0x1f) << 8) | p[3];
+        if (i_program != 0)
+            MonitorAddPmt(p_monitor, i_program, i_pid);
+    }
+}
+
+static void MonitorPmt(dvbpsi_monitor_t *p_monitor, monitor_ext_t *p_ext,
+                       const uint8_t *p_section, size_t i_size)
+{
+    const uint8_t *p_end = p_section + i_size - 4;
+    const uint8_t i_version = (p_section[5] >> 1) & 0x1f;
+    const uint8_t *p;
+
+    if (i_size < 16 || ((uint16_t)p_section[3] << 8 | p_section[4]) != p_ext->i_program)
+        return;
+
+    /* a repetition of the current PMT leaves the roles as they are */
+    if (p_ext->b_version && p_ext->i_version == i_version)
+        return;
+    p_ext->b_version = true;
+    p_ext->i_version = i_version;
+
+    MonitorSetPcr(p_monitor, p_ext, ((uint16_t)(p_section[8] & 0x1f) << 8) | p_section[9]);
+    p_ext->i_es = 0;
+    p = p_section + 12 + (((p_section[10] & 0x0f) << 8) | p_section[11]);
+    for (; p + 5 <= p_end; p += 5 + (((p[3] & 0x0f) << 8) | p[4]))
+    {
+        uint16_t i_pid = ((uint16_t)(p[1] & 0x1f) << 8) | p[2];
+        if (p_ext->i_es == MONITOR_MAX_ES)
+            break;
+        p_ext->p_es[p_ext->i_es++] = i_pid;
+        /* not received yet: the PID_error delay starts now */
+        if (p_monitor->pids[i_pid].i_last_seen == INT64_MIN)
+            p_monitor->pids[i_pid].i_last_seen = p_monitor->i_now;
+    }
+}
+
+static void MonitorSectionStart(dvbpsi_monitor_t *p_monitor, uint16_t i_pid,
+                                monitor_ext_t *p_ext, uint8_t i_table_id)
+{
+    const uint8_t i_flags = p_monitor->pids[i_pid].i_flags;
+
+    if (i_flags & PID_PAT)
+    {
+        if (i_table_id != 0x00)
+            MonitorError(p_monitor, DVBPSI_MONITOR_PAT_ERROR, i_pid, false);
+        else
+            p_ext->i_last_table = p_monitor->i_now;
+    }
+    if (i_flags & PID_PMT)
+    {
+        if (i_table_id != 0x02)
+            MonitorError(p_monitor, DVBPSI_MONITOR_PMT_ERROR, i_pid, false);
+        else
+            p_ext->i_last_table = p_monitor->i_now;
+    }
+}
+
+static void MonitorSectionDone(dvbpsi_monitor_t *p_monitor, uint16_t i_pid,
+                               monitor_ext_t *p_ext)
+{
+    uint8_t *p_data = p_ext->p_section;
+    const size_t i_size = p_ext->i_need;
+    const bool b_syntax = (p_data[1] & 0x80) != 0;
+    const uint8_t i_flags = p_monitor->pids[i_pid].i_flags;
+
+    /* the TOT has a CRC without the syntax indicator */
+    if (b_syntax || p_data[0] == 0x73)
+    {
+        dvbpsi_psi_section_t section;
+        if (i_size < (b_syntax ? 12u : 7u))
+        {
+            MonitorError(p_monitor, DVBPSI_MONITOR_CRC_ERROR, i_pid, false);
+            return;
+        }
+        section.p_data = p_data;
+        section.p_payload_end = p_data + i_size - 4;
+        if (!dvbpsi_ValidPSISection(&section))
+        {
+            MonitorError(p_monitor, DVBPSI_MONITOR_CRC_ERROR, i_pid, false);
+            return;
+        }
+    }
+
+    if (!b_syntax || !(p_data[5] & 0x01))
+        return;
+    if ((i_flags & PID_PAT) && p_data[0] == 0x00)
+        MonitorPat(p_monitor, p_ext, p_data, i_size);
+    else if ((i_flags & PID_PMT) && p_data[0] == 0x02)
+        MonitorPmt(p_monitor, p_ext, p_data, i_size);
+}
+
+static void MonitorSectionFeed(dvbpsi_monitor_t *p_monitor, uint16_t i_pid,
+                               monitor_ext_t *p_ext, const uint8_t *p, size_t i_size)
+{
+    while (i_size > 0)
+    {
+        size_t i_copy;
+
+        if (p_ext->i_have == 0)
+        {
+            /* stuffing until the end of the packet */
+            if (p[0] == 0xff)
+            {
+                p_ext->b_sync = false;
+                return;
+            }
+            p_ext->i_need = 0;
+            MonitorSectionStart(p_monitor, i_pid, p_ext, p[0]);
+        }
+
+        i_copy = p_ext->i_have < 3 ? 3u - p_ext->i_have : (size_t)p_ext->i_need - p_ext->i_have;
+        if (i_copy > i_size)
+            i_copy = i_size;
+        memcpy(p_ext->p_section + p_ext->i_have, p, i_copy);
+        p_ext->i_have += i_copy;
+        p += i_copy;
+        i_size -= i_copy;
+
+        if (p_ext->i_have == 3 && p_ext->i_need == 0)
+        {
+            p_ext->i_need = 3 + ((((uint16_t)p_ext->p_section[1] & 0x0f) << 8)
+                                 | p_ext->p_section[2]);
+            if (p_ext->i_need > MONITOR_MAX_SECTION)
+            {
+                p_ext->b_sync = false;
+                p_ext->i_have = 0;
+                return;
+            }
+        }
+        if (p_ext->i_have >= 3 && p_ext->i_have == p_ext->i_need)
+        {
+            MonitorSectionDone(p_monitor, i_pid, p_ext);
+            p_ext->i_have = 0;
+        }
+    }
+}
+
+/*****************************************************************************
+ * Packets
+ *****************************************************************************/
+static void MonitorPcr(dvbpsi_monitor_t *p_monitor, uint16_t i_pid, monitor_ext_t *p_ext,
+                       const uint8_t *p_packet, bool b_discontinuity)
+{
+    int64_t i_pcr = (int64_t)(((uint64_t)p_packet[6] << 25 | (uint64_t)p_packet[7] << 17
+                             | (uint64_t)p_packet[8] << 9 | (uint64_t)p_packet[9] << 1
+                             | p_packet[10] >> 7) * 300
+                             + (((p_packet[10] & 0x01) << 8) | p_packet[11]));
+
+    if (p_monitor->i_now - p_ext->i_pcr_time > MONITOR_PCR_INTERVAL)
+        MonitorError(p_monitor, DVBPSI_MONITOR_PCR_REPETITION_ERROR, i_pid, false);
+
+    if (p_ext->b_pcr && !b_discontinuity)
+    {
+        int64_t i_delta = (i_pcr - p_ext->i_pcr + MONITOR_PCR_WRAP) % MONITOR_PCR_WRAP;
+        uint64_t i_packets = p_monitor->i_packets - p_ext->i_pcr_packet;
+
+        if (i_delta > MONITOR_PCR_MAX_DELTA)
+        {
+            /* backwards or too far forward */
+            MonitorError(p_monitor, DVBPSI_MONITOR_PCR_DISCONTINUITY_ERROR, i_pid, false);
+            p_ext->f_rate = 0;
+        }
+        else if (i_packets > 0)
+        {
+            /* against the PCR expected at this position of the stream */
+            double f_rate = (double)i_delta / i_packets;
+            if (p_ext->f_rate > 0)
+            {
+                double f_error = i_delta - p_ext->f_rate * i_packets;
+                if (f_error > MONITOR_PCR_ACCURACY || f_error < -MONITOR_PCR_ACCURACY)
+                    MonitorError(p_monitor, DVBPSI_MONITOR_PCR_ACCURACY_ERROR, i_pid, false);
+                f_rate = p_ext->f_rate + (f_rate - p_ext->f_rate) / 16;
+            }
+            p_ext->f_rate = f_rate;
+        }
+    }
+    else
+        p_ext->f_rate = 0;
+
+    p_ext->b_pcr = true;
+    p_ext->i_pcr = i_pcr;
+    p_ext->i_pcr_packet = p_monitor->i_packets;
+    p_ext->i_pcr_time = p_monitor->i_now;
+}
+
+static void MonitorPsi(dvbpsi_monitor_t *p_monitor, uint16_t i_pid, monitor_ext_t *p_ext,
+                       const uint8_t *p_packet, size_t i_offset)
+{
+    const uint8_t *p = p_packet + i_offset;
+    const uint8_t *p_end = p_packet + 188;
+
+    if (p_packet[3] & 0xc0)
+    {
+        if (p_monitor->pids[i_pid].i_flags & PID_PAT)
+            MonitorError(p_monitor, DVBPSI_MONITOR_PAT_ERROR, i_pid, false);
+        if (p_monitor->pids[i_pid].i_flags & PID_PMT)
+            MonitorError(p_monitor, DVBPSI_MONITOR_PMT_ERROR, i_pid, false);
+        return;
+    }
+
+    if (p_packet[1] & 0x40)
+    {
+        uint8_t i_pointer = *p++;
+        if (p + i_pointer > p_end)
+        {
+            p_ext->b_sync = false;
+            p_ext->i_have = 0;
+            return;
+        }
+        /* the end of the previous section */
+        if (p_ext->b_sync && p_ext->i_have > 0)
+            MonitorSectionFeed(p_monitor, i_pid, p_ext, p, i_pointer);
+        p += i_pointer;
+        p_ext->b_sync = true;
+        p_ext->i_have = 0;
+    }
+    if (p_ext->b_sync)
+        MonitorSectionFeed(p_monitor, i_pid, p_ext, p, p_end - p);
+}
+
+static void MonitorTick(dvbpsi_monitor_t *p_monitor)
+{
+    const int64_t i_now = p_monitor->i_now;
+    const monitor_ext_t *p_pat = p_monitor->pids[0].p_ext;
+
+    if (i_now - p_pat->i_last_table > MONITOR_PSI_INTERVAL)
+        MonitorError(p_monitor, DVBPSI_MONITOR_PAT_ERROR, 0, true);
+
+    for (size_t i = 0; i < p_monitor->i_pmt_pids; i++)
+    {
+        const uint16_t i_pmt_pid = p_monitor->p_pmt_pids[i];
+        const monitor_ext_t *p_pmt = p_monitor->pids[i_pmt_pid].p_ext;
+
+        if (i_now - p_pmt->i_last_table > MONITOR_PSI_INTERVAL)
+            MonitorError(p_monitor, DVBPSI_MONITOR_PMT_ERROR, i_pmt_pid, true);
+        for (unsigned int j = 0; j < p_pmt->i_es; j++)
+        {
+            if (i_now - p_monitor->pids[p_pmt->p_es[j]].i_last_seen > p_monitor->i_pid_timeout)
+                MonitorError(p_monitor, DVBPSI_MONITOR_PID_ERROR, p_pmt->p_es[j], true);
+        }
+        if (p_pmt->i_pcr_pid != MONITOR_NULL_PID && p_monitor->pids[p_pmt->i_pcr_pid].p_ext
+         && i_now - p_monitor->pids[p_pmt->i_pcr_pid].p_ext->i_pcr_time > MONITOR_PCR_INTERVAL)
+            MonitorError(p_monitor, DVBPSI_MONITOR_PCR_REPETITION_ERROR, p_pmt->i_pcr_pid, true);
+    }
+
+    MonitorClearAlarms(p_monitor);
+    p_monitor->i_next_tick = i_now + MONITOR_TICK;
+}
+
+/*****************************************************************************
+ * dvbpsi_monitor_new
+ *****************************************************************************/
+dvbpsi_monitor_t *dvbpsi_monitor_new(dvbpsi_monitor_cb pf_alarm, void *p_cb_data)
+{
+    dvbpsi_monitor_t *p_monitor = calloc(1, sizeof(dvbpsi_monitor_t));
+    if (!p_monitor)
+        return NULL;
+
+    p_monitor->pf_alarm = pf_alarm;
+    p_monitor->p_cb_data = p_cb_data;
+    p_monitor->i_hold = INT64_C(1000000);
+    p_monitor->i_pid_timeout = INT64_C(5000000);
+    for (size_t i = 0; i < MONITOR_PIDS; i++)
+    {
+        p_monitor->pids[i].i_last_seen = INT64_MIN;
+        p_monitor->pids[i].i_cc = MONITOR_NO_CC;
+        if (MonitorIsSi(i))
+        {
+            if (!MonitorExt(p_monitor, i))
+            {
+                dvbpsi_monitor_delete(p_monitor);
+                return NULL;
+            }
+            p_monitor->pids[i].i_flags = PID_PSI;
+        }
+    }
+    p_monitor->pids[0].i_flags |= PID_PAT;
+    return p_monitor;
+}
+
+/*****************************************************************************
+ * dvbpsi_monitor_delete
+ *****************************************************************************/
+void dvbpsi_monitor_delete(dvbpsi_monitor_t *p_monitor)
+{
+    if (!p_monitor)
+        return;
+    for (size_t i = 0; i < MONITOR_PIDS; i++)
+        free(p_monitor->pids[i].p_ext);
+    free(p_monitor->p_alarms);
+    free(p_monitor->p_pmt_pids);
+    free(p_monitor);
+}
+
+/*****************************************************************************
+ * dvbpsi_monitor_set_times
+ *****************************************************************************/
+void dvbpsi_monitor_set_times(dvbpsi_monitor_t *p_monitor, int64_t i_hold,
+                              int64_t i_pid_timeout)
+{
+    p_monitor->i_hold = i_hold;
+    p_monitor->i_pid_timeout = i_pid_timeout;
+}
+
+/*****************************************************************************
+ * dvbpsi_monitor_push
+ *****************************************************************************/
+void dvbpsi_monitor_push(dvbpsi_monitor_t *p_monitor, const uint8_t *p_packet,
+                         int64_t i_time)
+{
+    monitor_pid_t *p_pid;
+    uint16_t i_pid;
+    uint8_t i_cc, i_afc;
+    bool b_discontinuity;
+    size_t i_offset;
+
+    p_monitor->i_now = i_time;
+    p_monitor->i_packets++;
+    if (!p_monitor->b_started)
+    {
+        /* the PAT delay starts with the stream */
+        p_monitor->b_started = true;
+        p_monitor->pids[0].p_ext->i_last_table = i_time;
+        p_monitor->i_next_tick = i_time + MONITOR_TICK;
+    }
+    else if (i_time >= p_monitor->i_next_tick)
+        MonitorTick(p_monitor);
+
+    /* sync loss after 2 wrong sync bytes, sync after 5 right ones */
+    if (p_packet[0] != 0x47)
+    {
+        MonitorError(p_monitor, DVBPSI_MONITOR_SYNC_BYTE_ERROR, DVBPSI_MONITOR_STREAM, false);
+        p_monitor->i_good_sync = 0;
+        if (++p_monitor->i_bad_sync >= 2)
+            p_monitor->b_sync_lost = true;
+        if (p_monitor->b_sync_lost)
+            MonitorError(p_monitor, DVBPSI_MONITOR_TS_SYNC_LOSS, DVBPSI_MONITOR_STREAM, true);
+        return;
+    }
+    p_monitor->i_bad_sync = 0;
+    if (p_monitor->b_sync_lost)
+    {
+        if (++p_monitor->i_good_sync < 5)
+            return;
+        p_monitor->b_sync_lost = false;
+    }
+
+    i_pid = ((uint16_t)(p_packet[1] & 0x1f) << 8) | p_packet[2];
+    if (p_packet[1] & 0x80)
+    {
+        MonitorError(p_monitor, DVBPSI_MONITOR_TRANSPORT_ERROR, i_pid, false);
+        return;
+    }
+
+    p_pid = &p_monitor->pids[i_pid];
+    p_pid->i_last_seen = i_time;
+    i_afc = p_packet[3] >> 4 & 0x03;
+    b_discontinuity = (i_afc & 0x02) && p_packet[4] > 0 && (p_packet[5] & 0x80);
+
+    /* a packet may be repeated once, packets without payload keep the count */
+    if ((i_afc & 0x01) && i_pid != MONITOR_NULL_PID)
+    {
+        i_cc = p_packet[3] & 0x0f;
+        if (p_pid->i_cc == MONITOR_NO_CC || b_discontinuity)
+            p_pid->i_duplicates = 0;
+        else if (i_cc == p_pid->i_cc)
+        {
+            if (++p_pid->i_duplicates > 1)
+                MonitorError(p_monitor, DVBPSI_MONITOR_CC_ERROR, i_pid, false);
+        }
+        else
+        {
+            if (i_cc != ((p_pid->i_cc + 1) & 0x0f))
+            {
+                MonitorError(p_monitor, DVBPSI_MONITOR_CC_ERROR, i_pid, false);
+                if (p_pid->p_ext)
+                    p_pid->p_ext->b_sync = false;
+            }
+            p_pid->i_duplicates = 0;
+        }
+        p_pid->i_cc = i_cc;
+    }
+
+    if (!p_pid->i_flags)
+        return;
+
+    if ((p_pid->i_flags & PID_PCR) && (i_afc & 0x02) && p_packet[4] >= 7 && (p_packet[5] & 0x10))
+        MonitorPcr(p_monitor, i_pid, p_pid->p_ext, p_packet, b_discontinuity);
+
+    i_offset = (i_afc & 0x02) ? 5u + p_packet[4] : 4u;
+    if ((p_pid->i_flags & PID_PSI) && (i_afc & 0x01) && i_offset < 188
+     && p_pid->i_duplicates == 0)
+        MonitorPsi(p_monitor, i_pid, p_pid->p_ext, p_packet, i_offset);
+}
+
+/*****************************************************************************
+ * dvbpsi_monitor_counters
+ *****************************************************************************/
+void dvbpsi_monitor_counters(dvbpsi_monitor_t *p_monitor,
+                             uint64_t p_errors[DVBPSI_MONITOR_CHECKS])
+{
+    memcpy(p_errors, p_monitor->p_errors, sizeof(p_monitor->p_errors));
+}
+
+/*****************************************************************************
+ * dvbpsi_monitor_alarms
+ *****************************************************************************/
+size_t dvbpsi_monitor_alarms(dvbpsi_monitor_t *p_monitor,
+                             dvbpsi_monitor_alarm_t *p_alarms, size_t i_max)
+{
+    size_t i_count = p_monitor->i_alarms < i_max ? p_monitor->i_alarms : i_max;
+    memcpy(p_alarms, p_monitor->p_alarms, i_count * sizeof(dvbpsi_monitor_alarm_t));
+    return p_monitor->i_alarms;
+}
+
+/*****************************************************************************
+ * dvbpsi_monitor_check_name
+ *****************************************************************************/
+const char *dvbpsi_monitor_check_name(dvbpsi_monitor_check_t i_check)
+{
+    if ((unsigned int)i_check >= DVBPSI_MONITOR_CHECKS)
+        return "unknown";
+    return monitor_check_names[i_check];
+}
@@ -0,0 +1,227 @@
+/*****************************************************************************
+ * monitor.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <monitor.h>
+ * \brief Transport stream monitor, ETSI TR 101 290 first and second
+ * priority checks.
+ *
+ * The monitor takes all the packets of a transport stream with their
+ * arrival time. It keeps one small state per PID, learns the PMT, PCR and
+ * elementary stream PIDs from the PAT and PMT sections it checks, and
+ * reassembles the sections of the PSI/SI PIDs only.
+ *
+ * An error raises an alarm for its check and PID, or updates it if it is
+ * already raised. The alarm is cleared once the check passed for the hold
+ * time. The conditions lasting in time (a missing PAT, PMT, PCR or PID) are
+ * evaluated every 100 ms of arrival time. A monitor must be used from one
+ * thread.
+ */
+
+#ifndef _DVBPSI_MONITOR_H_
+#define _DVBPSI_MONITOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * dvbpsi_monitor_check_t
+ *****************************************************************************/
+/*!
+ * \enum dvbpsi_monitor_check_e
+ * \brief TR 101 290 checks.
+ */
+/*!
+ * \typedef enum dvbpsi_monitor_check_e dvbpsi_monitor_check_t
+ * \brief dvbpsi_monitor_check_t type definition.
+ */
+typedef enum dvbpsi_monitor_check_e
+{
+    DVBPSI_MONITOR_TS_SYNC_LOSS = 0,        /*!< 1.1 TS_sync_loss */
+    DVBPSI_MONITOR_SYNC_BYTE_ERROR,         /*!< 1.2 Sync_byte_error */
+    DVBPSI_MONITOR_PAT_ERROR,               /*!< 1.3 PAT_error_2 */
+    DVBPSI_MONITOR_CC_ERROR,                /*!< 1.4 Continuity_count_error */
+    DVBPSI_MONITOR_PMT_ERROR,               /*!< 1.5 PMT_error_2 */
+    DVBPSI_MONITOR_PID_ERROR,               /*!< 1.6 PID_error */
+    DVBPSI_MONITOR_TRANSPORT_ERROR,         /*!< 2.1 Transport_error */
+    DVBPSI_MONITOR_CRC_ERROR,               /*!< 2.2 CRC_error */
+    DVBPSI_MONITOR_PCR_REPETITION_ERROR,    /*!< 2.3a PCR_repetition_error */
+    DVBPSI_MONITOR_PCR_DISCONTINUITY_ERROR, /*!< 2.3b PCR_discontinuity_indicator_error */
+    DVBPSI_MONITOR_PCR_ACCURACY_ERROR,      /*!< 2.4 PCR_accuracy_error */
+
+    DVBPSI_MONITOR_CHECKS                   /*!< number of checks */
+} dvbpsi_monitor_check_t;
+
+/*****************************************************************************
+ * dvbpsi_monitor_alarm_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_monitor_alarm_s
+ * \brief An alarm of the monitor.
+ */
+/*!
+ * \typedef struct dvbpsi_monitor_alarm_s dvbpsi_monitor_alarm_t
+ * \brief dvbpsi_monitor_alarm_t type definition.
+ */
+typedef struct dvbpsi_monitor_alarm_s
+{
+    dvbpsi_monitor_check_t  i_check;        /*!< the check */
+    uint16_t                i_pid;          /*!< the PID, 0x2000 for the
+                                                 whole stream */
+    bool                    b_raised;       /*!< false once cleared */
+    int64_t                 i_raised;       /*!< time of the first error */
+    int64_t                 i_last_error;   /*!< time of the last error */
+    int64_t                 i_cleared;      /*!< time it was cleared */
+    uint64_t                i_errors;       /*!< errors while raised */
+} dvbpsi_monitor_alarm_t;
+
+/*!
+ * \def DVBPSI_MONITOR_STREAM
+ * \brief PID of the alarms about the whole stream.
+ */
+#define DVBPSI_MONITOR_STREAM   0x2000
+
+/*****************************************************************************
+ * dvbpsi_monitor_cb
+ *****************************************************************************/
+/*!
+ * \typedef void (*dvbpsi_monitor_cb)(void *p_cb_data,
+                                      const dvbpsi_monitor_alarm_t *p_alarm)
+ * \brief Callback called when an alarm is raised and when it is cleared.
+ */
+typedef void (*dvbpsi_monitor_cb)(void *p_cb_data, const dvbpsi_monitor_alarm_t *p_alarm);
+
+/*****************************************************************************
+ * dvbpsi_monitor_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_monitor_s dvbpsi_monitor_t
+ * \brief Opaque monitor handle.
+ */
+typedef struct dvbpsi_monitor_s dvbpsi_monitor_t;
+
+/*****************************************************************************
+ * dvbpsi_monitor_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_monitor_t *dvbpsi_monitor_new(dvbpsi_monitor_cb pf_alarm,
+                                            void *p_cb_data)
+ * \brief Create a monitor, with a hold time of one second and a PID_error
+ * after five seconds.
+ * \param pf_alarm callback of the alarms, may be NULL
+ * \param p_cb_data private data given to pf_alarm
+ * \return the monitor, NULL on error
+ */
+dvbpsi_monitor_t *dvbpsi_monitor_new(dvbpsi_monitor_cb pf_alarm, void *p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_monitor_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_monitor_delete(dvbpsi_monitor_t *p_monitor)
+ * \brief Delete a monitor, without clearing its alarms.
+ * \param p_monitor the monitor, may be NULL
+ * \return nothing
+ */
+void dvbpsi_monitor_delete(dvbpsi_monitor_t *p_monitor);
+
+/*****************************************************************************
+ * dvbpsi_monitor_set_times
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_monitor_set_times(dvbpsi_monitor_t *p_monitor,
+                                     int64_t i_hold, int64_t i_pid_timeout)
+ * \brief Set the times of the monitor.
+ * \param p_monitor the monitor
+ * \param i_hold time without error before an alarm is cleared, in
+ * microseconds
+ * \param i_pid_timeout time without packet of a PID referred to by a PMT
+ * before a PID_error, in microseconds
+ * \return nothing
+ */
+void dvbpsi_monitor_set_times(dvbpsi_monitor_t *p_monitor, int64_t i_hold,
+                              int64_t i_pid_timeout);
+
+/*****************************************************************************
+ * dvbpsi_monitor_push
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_monitor_push(dvbpsi_monitor_t *p_monitor,
+                                const uint8_t *p_packet, int64_t i_time)
+ * \brief Check a TS packet.
+ * \param p_monitor the monitor
+ * \param p_packet the 188 bytes packet
+ * \param i_time its arrival time, in microseconds, never decreasing
+ * \return nothing
+ */
+void dvbpsi_monitor_push(dvbpsi_monitor_t *p_monitor, const uint8_t *p_packet,
+                         int64_t i_time);
+
+/*****************************************************************************
+ * dvbpsi_monitor_counters
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_monitor_counters(dvbpsi_monitor_t *p_monitor,
+                                    uint64_t p_errors[DVBPSI_MONITOR_CHECKS])
+ * \brief Get the number of errors found by each check.
+ * \param p_monitor the monitor
+ * \param p_errors filled with the number of errors, by check
+ * \return nothing
+ */
+void dvbpsi_monitor_counters(dvbpsi_monitor_t *p_monitor,
+                             uint64_t p_errors[DVBPSI_MONITOR_CHECKS]);
+
+/*****************************************************************************
+ * dvbpsi_monitor_alarms
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_monitor_alarms(dvbpsi_monitor_t *p_monitor,
+                                    dvbpsi_monitor_alarm_t *p_alarms,
+                                    size_t i_max)
+ * \brief Get the raised alarms.
+ * \param p_monitor the monitor
+ * \param p_alarms filled with at most i_max alarms
+ * \param i_max size of p_alarms
+ * \return the number of raised alarms, which may be more than i_max
+ */
+size_t dvbpsi_monitor_alarms(dvbpsi_monitor_t *p_monitor,
+                             dvbpsi_monitor_alarm_t *p_alarms, size_t i_max);
+
+/*****************************************************************************
+ * dvbpsi_monitor_check_name
+ *****************************************************************************/
+/*!
+ * \fn const char *dvbpsi_monitor_check_name(dvbpsi_monitor_check_t i_check)
+ * \brief Get the TR 101 290 name of a check, such as "1.4 Continuity_count_error".
+ * \param i_check the check
+ * \return the name
+ */
+const char *dvbpsi_monitor_check_name(dvbpsi_monitor_check_t i_check);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of monitor.h"
+#endif
@@ -0,0 +1,259 @@
+/*****************************************************************************
+ * packetizer.c: PSI section to TS packet conversion
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "psi.h"
+#include "packetizer.h"
+
+#define TS_PAYLOAD_SIZE   (DVBPSI_TS_PACKET_SIZE - 4)
+
+/* A packed section must at least carry table_id and section_length in the
+ * packet where it starts. */
+#define SECTION_MIN_START 3
+
+/*****************************************************************************
+ * SectionSize
+ *****************************************************************************
+ * Size of the complete section, header and CRC_32 included.
+ *****************************************************************************/
+static inline size_t SectionSize(const dvbpsi_psi_section_t *p_section)
+{
+    return 3 + p_section->i_length;
+}
+
+/*****************************************************************************
+ * WriteHeader
+ *****************************************************************************
+ * TS header without adaptation field, increments the continuity_counter.
+ *****************************************************************************/
+static inline void WriteHeader(dvbpsi_packetizer_t *p_packetizer,
+                               uint8_t *p_header, bool b_unit_start)
+{
+    p_header[0] = 0x47;
+    p_header[1] = (b_unit_start ? 0x40 : 0x00) | ((p_packetizer->i_pid >> 8) & 0x1f);
+    p_header[2] = p_packetizer->i_pid & 0xff;
+    p_header[3] = 0x10 | p_packetizer->i_cc;
+    p_packetizer->i_cc = (p_packetizer->i_cc + 1) & 0x0f;
+}
+
+/*****************************************************************************
+ * PacketizeOne
+ *****************************************************************************
+ * Produce one packet. With p_packet == NULL only the state is updated,
+ * which is used to count packets.
+ *****************************************************************************/
+static void PacketizeOne(dvbpsi_packetizer_t *p_packetizer, uint8_t *p_packet)
+{
+    const dvbpsi_psi_section_t *p_section = p_packetizer->p_section;
+    size_t i_left = SectionSize(p_section) - p_packetizer->i_offset;
+    size_t i_room = TS_PAYLOAD_SIZE;
+    uint8_t *p_pos = NULL;
+    bool b_unit_start;
+
+    /* A packet continuing a section only gets a pointer_field when the
+     * next section starts in it */
+    if (p_packetizer->i_offset == 0)
+        b_unit_start = true;
+    else
+        b_unit_start = p_packetizer->b_pack && p_section->p_next
+                    && i_left + 1 + SECTION_MIN_START <= TS_PAYLOAD_SIZE;
+
+    if (p_packet)
+    {
+        WriteHeader(p_packetizer, p_packet, b_unit_start);
+        p_pos = p_packet + 4;
+        if (b_unit_start)
+            *(p_pos++) = p_packetizer->i_offset ? i_left : 0; /* pointer_field */
+    }
+    else
+        p_packetizer->i_cc = (p_packetizer->i_cc + 1) & 0x0f;
+
+    if (b_unit_start)
+        i_room--;
+
+    for (;;)
+    {
+        size_t i_copy = (i_left < i_room) ? i_left : i_room;
+
+        if (p_packet)
+        {
+            memcpy(p_pos, p_section->p_data + p_packetizer->i_offset, i_copy);
+            p_pos += i_copy;
+        }
+        p_packetizer->i_offset += i_copy;
+        i_room -= i_copy;
+
+        /* packet full, the section continues in the next one */
+        if (i_copy < i_left)
+            break;
+
+        p_section = p_section->p_next;
+        p_packetizer->i_offset = 0;
+
+        if (!p_section || !b_unit_start || !p_packetizer->b_pack
+         || i_room < SECTION_MIN_START)
+            break;
+        i_left = SectionSize(p_section);
+    }
+    p_packetizer->p_section = p_section;
+
+    /* stuffing */
+    if (p_packet)
+        memset(p_pos, 0xff, i_room);
+}
+
+/*****************************************************************************
+ * dvbpsi_packetizer_init
+ *****************************************************************************/
+void dvbpsi_packetizer_init(dvbpsi_packetizer_t *p_packetizer,
+                            uint16_t i_pid, bool b_pack)
+{
+    assert(p_packetizer);
+    assert(i_pid < 0x1fff);
+
+    p_packetizer->i_pid = i_pid;
+    p_packetizer->i_cc = 0;
+    p_packetizer->b_pack = b_pack;
+    p_packetizer->p_section = NULL;
+    p_packetizer->i_offset = 0;
+}
+
+/*****************************************************************************
+ * dvbpsi_packetizer_set_sections
+ *****************************************************************************/
+void dvbpsi_packetizer_set_sections(dvbpsi_packetizer_t *p_packetizer,
+                                    const dvbpsi_psi_section_t *p_sections)
+{
+    assert(p_packetizer);
+
+    p_packetizer->p_section = p_sections;
+    p_packetizer->i_offset = 0;
+}
+
+/*****************************************************************************
+ * dvbpsi_packetizer_done
+ *****************************************************************************/
+bool dvbpsi_packetizer_done(const dvbpsi_packetizer_t *p_packetizer)
+{
+    assert(p_packetizer);
+    return p_packetizer->p_section == NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_packetizer_count
+ *****************************************************************************/
+size_t dvbpsi_packetizer_count(const dvbpsi_psi_section_t *p_sections, bool b_pack)
+{
+    dvbpsi_packetizer_t packetizer;
+    size_t i_packets = 0;
+
+    dvbpsi_packetizer_init(&packetizer, 0, b_pack);
+    dvbpsi_packetizer_set_sections(&packetizer, p_sections);
+    while (packetizer.p_section)
+    {
+        PacketizeOne(&packetizer, NULL);
+        i_packets++;
+    }
+    return i_packets;
+}
+
+/*****************************************************************************
+ * dvbpsi_packetize
+ *****************************************************************************/
+size_t dvbpsi_packetize(dvbpsi_packetizer_t *p_packetizer,
+                        uint8_t *p_packets, size_t i_packets)
+{
+    size_t i;
+
+    assert(p_packetizer);
+    assert(p_packets || i_packets == 0);
+
+    for (i = 0; i < i_packets && p_packetizer->p_section; i++)
+        PacketizeOne(p_packetizer, p_packets + i * DVBPSI_TS_PACKET_SIZE);
+    return i;
+}
+
+/*****************************************************************************
+ * dvbpsi_packetize_iovec
+ *****************************************************************************/
+size_t dvbpsi_packetize_iovec(dvbpsi_packetizer_t *p_packetizer,
+                              dvbpsi_ts_iovec_t *p_iov, size_t i_packets)
+{
+    size_t i;
+
+    assert(p_packetizer);
+    assert(p_iov || i_packets == 0);
+
+    for (i = 0; i < i_packets && p_packetizer->p_section; i++)
+    {
+        const dvbpsi_psi_section_t *p_section = p_packetizer->p_section;
+        size_t i_size = SectionSize(p_section);
+        size_t i_room = TS_PAYLOAD_SIZE;
+        size_t i_copy;
+
+        if (p_packetizer->i_offset == 0)
+        {
+            WriteHeader(p_packetizer, p_iov[i].header, true);
+            p_iov[i].header[4] = 0x00; /* pointer_field */
+            p_iov[i].i_header = 5;
+            i_room--;
+        }
+        else
+        {
+            WriteHeader(p_packetizer, p_iov[i].header, false);
+            p_iov[i].i_header = 4;
+        }
+
+        i_copy = i_size - p_packetizer->i_offset;
+        if (i_copy > i_room)
+            i_copy = i_room;
+
+        p_iov[i].p_payload = p_section->p_data + p_packetizer->i_offset;
+        p_iov[i].i_payload = i_copy;
+        p_iov[i].i_stuffing = i_room - i_copy;
+
+        p_packetizer->i_offset += i_copy;
+        if (p_packetizer->i_offset == i_size)
+        {
+            p_packetizer->p_section = p_section->p_next;
+            p_packetizer->i_offset = 0;
+        }
+    }
+    return i;
+}
@@ -0,0 +1,195 @@
+/*****************************************************************************
+ * packetizer.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <packetizer.h>
+ * \brief PSI section to TS packet conversion.
+ *
+ * Turns the section chains returned by the *_sections_generate() functions
+ * into 188 bytes transport stream packets (ISO/IEC 13818-1 section 2.4.4),
+ * handling the pointer_field, 0xff stuffing and the continuity_counter of
+ * one PID. Packets are written in caller provided buffers, the iovec path
+ * does not copy the section bytes at all.
+ */
+
+#ifndef _DVBPSI_PACKETIZER_H_
+#define _DVBPSI_PACKETIZER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \def DVBPSI_TS_PACKET_SIZE
+ * \brief Size of a transport stream packet.
+ */
+#define DVBPSI_TS_PACKET_SIZE 188
+
+/*****************************************************************************
+ * dvbpsi_packetizer_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_packetizer_s
+ * \brief Packetizer state of one PID.
+ *
+ * The continuity_counter is kept across dvbpsi_packetizer_set_sections()
+ * calls, so one packetizer is used per output PID for the whole stream.
+ * The sections given to the packetizer must stay valid until they are
+ * completely packetized.
+ */
+/*!
+ * \typedef struct dvbpsi_packetizer_s dvbpsi_packetizer_t
+ * \brief dvbpsi_packetizer_t type definition.
+ */
+typedef struct dvbpsi_packetizer_s
+{
+    uint16_t    i_pid;              /*!< PID of the packets */
+    uint8_t     i_cc;               /*!< next continuity_counter */
+    bool        b_pack;             /*!< start a section in the packet
+                                         where the previous one ends */
+
+    const dvbpsi_psi_section_t *p_section;  /*!< section being packetized */
+    uint16_t    i_offset;           /*!< bytes of p_section already sent */
+} dvbpsi_packetizer_t;
+
+/*****************************************************************************
+ * dvbpsi_ts_iovec_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_ts_iovec_s
+ * \brief One TS packet described without copying the section data.
+ *
+ * The packet is the concatenation of the i_header bytes of header[], the
+ * i_payload bytes at p_payload and i_stuffing bytes of 0xff.
+ */
+/*!
+ * \typedef struct dvbpsi_ts_iovec_s dvbpsi_ts_iovec_t
+ * \brief dvbpsi_ts_iovec_t type definition.
+ */
+typedef struct dvbpsi_ts_iovec_s
+{
+    uint8_t         header[5];      /*!< TS header and pointer_field */
+    uint8_t         i_header;       /*!< 4 or 5 */
+    const uint8_t  *p_payload;      /*!< section bytes, in section memory */
+    uint8_t         i_payload;      /*!< number of section bytes */
+    uint8_t         i_stuffing;     /*!< number of trailing 0xff bytes */
+} dvbpsi_ts_iovec_t;
+
+/*****************************************************************************
+ * dvbpsi_packetizer_init
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_packetizer_init(dvbpsi_packetizer_t *p_packetizer,
+                                   uint16_t i_pid, bool b_pack)
+ * \brief Initialize a packetizer, the continuity_counter starts at 0.
+ * \param p_packetizer pointer to the packetizer
+ * \param i_pid PID of the packets
+ * \param b_pack when true a section starts in the same packet as the end
+ * of the previous one if at least its 3 first bytes fit, otherwise every
+ * section starts a new packet
+ * \return nothing
+ */
+void dvbpsi_packetizer_init(dvbpsi_packetizer_t *p_packetizer,
+                            uint16_t i_pid, bool b_pack);
+
+/*****************************************************************************
+ * dvbpsi_packetizer_set_sections
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_packetizer_set_sections(dvbpsi_packetizer_t *p_packetizer,
+                                  const dvbpsi_psi_section_t *p_sections)
+ * \brief Set the section chain to packetize next. Sections still pending
+ * from a previous chain are dropped.
+ * \param p_packetizer pointer to the packetizer
+ * \param p_sections first section of the chain, may be NULL
+ * \return nothing
+ */
+void dvbpsi_packetizer_set_sections(dvbpsi_packetizer_t *p_packetizer,
+                                    const dvbpsi_psi_section_t *p_sections);
+
+/*****************************************************************************
+ * dvbpsi_packetizer_done
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_packetizer_done(const dvbpsi_packetizer_t *p_packetizer)
+ * \brief Tells whether all sections have been packetized.
+ * \param p_packetizer pointer to the packetizer
+ * \return true when there is nothing left to packetize
+ */
+bool dvbpsi_packetizer_done(const dvbpsi_packetizer_t *p_packetizer);
+
+/*****************************************************************************
+ * dvbpsi_packetizer_count
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_packetizer_count(const dvbpsi_psi_section_t *p_sections,
+                                      bool b_pack)
+ * \brief Number of TS packets needed to carry a section chain.
+ * \param p_sections first section of the chain
+ * \param b_pack packing mode, see dvbpsi_packetizer_init()
+ * \return the number of packets
+ */
+size_t dvbpsi_packetizer_count(const dvbpsi_psi_section_t *p_sections, bool b_pack);
+
+/*****************************************************************************
+ * dvbpsi_packetize
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_packetize(dvbpsi_packetizer_t *p_packetizer,
+                               uint8_t *p_packets, size_t i_packets)
+ * \brief Write the next TS packets.
+ * \param p_packetizer pointer to the packetizer
+ * \param p_packets buffer of i_packets * DVBPSI_TS_PACKET_SIZE bytes
+ * \param i_packets number of packets the buffer can hold
+ * \return the number of packets written, less than i_packets when the
+ * section chain is completely packetized
+ */
+size_t dvbpsi_packetize(dvbpsi_packetizer_t *p_packetizer,
+                        uint8_t *p_packets, size_t i_packets);
+
+/*****************************************************************************
+ * dvbpsi_packetize_iovec
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_packetize_iovec(dvbpsi_packetizer_t *p_packetizer,
+                                     dvbpsi_ts_iovec_t *p_iov, size_t i_packets)
+ * \brief Describe the next TS packets without copying the section data.
+ *
+ * Each packet carries bytes of a single section, so sections are never
+ * packed on this path whatever the packing mode of the packetizer. The
+ * p_payload pointers are valid as long as the sections are.
+ * \param p_packetizer pointer to the packetizer
+ * \param p_iov array of i_packets packet descriptions
+ * \param i_packets number of elements in p_iov
+ * \return the number of packets described, less than i_packets when the
+ * section chain is completely packetized
+ */
+size_t dvbpsi_packetize_iovec(dvbpsi_packetizer_t *p_packetizer,
+                              dvbpsi_ts_iovec_t *p_iov, size_t i_packets);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of packetizer.h"
+#endif
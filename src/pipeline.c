@@ -0,0 +1,665 @@
+/*****************************************************************************
+ * pipeline.c: multi-threaded PSI/SI decoding
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ * Every routed packet gets a sequence number. A worker decodes its packets
+ * in order and publishes the sequence number of the last one it decoded,
+ * deliveries are tagged with the sequence number of the packet being
+ * decoded. The router delivers the oldest pending delivery once no worker
+ * can produce an older one any more: each worker either has a pending
+ * delivery, has decoded past it, or has decoded all its packets.
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include "dvbpsi.h"
+#include "pipeline.h"
+
+#ifdef HAVE_PTHREAD
+
+#define PIPELINE_PIDS           8192
+#define PIPELINE_DEFAULT_QUEUE  4096
+#define PIPELINE_PACKET_SIZE    188
+#define PIPELINE_BATCH          64      /* entries between two publications */
+
+#define load_acquire(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define store_release(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+/* sleeping flags and the indexes they guard need a total order */
+#define load_sc(p)          __atomic_load_n(p, __ATOMIC_SEQ_CST)
+#define store_sc(p, v)      __atomic_store_n(p, v, __ATOMIC_SEQ_CST)
+
+/*****************************************************************************
+ * pipeline_item_t: a pending delivery
+ *****************************************************************************/
+typedef struct pipeline_item_s
+{
+    uint64_t                i_seq;
+    dvbpsi_pipeline_cb      pf_deliver;
+    void                   *p_cb_data;
+    void                   *p_object;
+    struct pipeline_item_s *p_next;
+} pipeline_item_t;
+
+/*****************************************************************************
+ * pipeline_entry_t: a packet, or the removal of a PID
+ *****************************************************************************/
+typedef struct pipeline_entry_s
+{
+    uint64_t            i_seq;
+    dvbpsi_t           *p_dvbpsi;
+    pipeline_item_t    *p_release;      /* PID removal when not NULL */
+    uint8_t             p_packet[PIPELINE_PACKET_SIZE];
+} pipeline_entry_t;
+
+typedef struct pipeline_worker_s
+{
+    dvbpsi_pipeline_t  *p_pipeline;
+    pthread_t           thread;
+    pipeline_entry_t   *p_entries;
+    size_t              i_mask;
+
+    /* router side */
+    size_t              i_fill;         /* entries filled */
+    size_t              i_head_seen;    /* last value read from i_head */
+    unsigned int        i_pids;
+    uint64_t            i_done_seen;    /* progress snapshot of the router */
+    bool                b_idle_seen;    /* or has a pending delivery */
+    uint8_t             pad0[64];
+
+    size_t              i_tail;         /* entries published by the router */
+    uint8_t             pad1[64];
+
+    /* worker side */
+    size_t              i_head;         /* entries consumed by the worker */
+    uint64_t            i_done;         /* last decoded sequence number */
+    uint64_t            i_current;      /* sequence number being decoded */
+    uint8_t             pad2[64];
+
+    pthread_mutex_t     lock;
+    pthread_cond_t      wait;
+    bool                b_sleeping;
+    bool                b_quit;
+    pipeline_item_t    *p_first_item;   /* deliveries, oldest first */
+    pipeline_item_t   **pp_last_item;
+    size_t              i_items;
+} pipeline_worker_t;
+
+typedef struct pipeline_pid_s
+{
+    dvbpsi_t           *p_dvbpsi;
+    unsigned int        i_worker;
+} pipeline_pid_t;
+
+struct dvbpsi_pipeline_s
+{
+    unsigned int        i_workers;
+    pipeline_worker_t  *p_workers;
+    pipeline_pid_t      pids[PIPELINE_PIDS];
+
+    uint64_t            i_seq;
+    bool                b_delivering;
+
+    pthread_mutex_t     lock;           /* the router waiting for workers */
+    pthread_cond_t      wait;
+    bool                b_sleeping;
+};
+
+/* worker of the calling thread, for dvbpsi_pipeline_deliver() */
+static pthread_key_t  pipeline_key;
+static pthread_once_t pipeline_once = PTHREAD_ONCE_INIT;
+
+static void PipelineKeyInit(void)
+{
+    pthread_key_create(&pipeline_key, NULL);
+}
+
+/*****************************************************************************
+ * Worker
+ *****************************************************************************/
+static void PipelinePost(pipeline_worker_t *p_worker, pipeline_item_t *p_item)
+{
+    p_item->p_next = NULL;
+
+    pthread_mutex_lock(&p_worker->lock);
+    *p_worker->pp_last_item = p_item;
+    p_worker->pp_last_item = &p_item->p_next;
+    __atomic_add_fetch(&p_worker->i_items, 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&p_worker->lock);
+}
+
+static void PipelineWakeRouter(dvbpsi_pipeline_t *p_pipeline)
+{
+    if (load_sc(&p_pipeline->b_sleeping))
+    {
+        pthread_mutex_lock(&p_pipeline->lock);
+        pthread_cond_signal(&p_pipeline->wait);
+        pthread_mutex_unlock(&p_pipeline->lock);
+    }
+}
+
+static void *PipelineWorker(void *p_data)
+{
+    pipeline_worker_t *p_worker = p_data;
+    dvbpsi_pipeline_t *p_pipeline = p_worker->p_pipeline;
+    size_t i_head = 0;
+
+    pthread_setspecific(pipeline_key, p_worker);
+
+    for (;;)
+    {
+        size_t i_tail = load_acquire(&p_worker->i_tail);
+
+        if (i_head == i_tail)
+        {
+            bool b_quit;
+
+            pthread_mutex_lock(&p_worker->lock);
+            store_sc(&p_worker->b_sleeping, true);
+            while (load_sc(&p_worker->i_tail) == i_head && !p_worker->b_quit)
+                pthread_cond_wait(&p_worker->wait, &p_worker->lock);
+            store_sc(&p_worker->b_sleeping, false);
+            b_quit = p_worker->b_quit && load_acquire(&p_worker->i_tail) == i_head;
+            pthread_mutex_unlock(&p_worker->lock);
+
+            if (b_quit)
+                break;
+            continue;
+        }
+
+        while (i_head != i_tail)
+        {
+            pipeline_entry_t *p_entry = &p_worker->p_entries[i_head & p_worker->i_mask];
+
+            p_worker->i_current = p_entry->i_seq;
+            if (p_entry->p_release)
+            {
+                /* the handle is not used any more */
+                p_entry->p_release->i_seq = p_entry->i_seq;
+                PipelinePost(p_worker, p_entry->p_release);
+            }
+            else
+                dvbpsi_packet_push(p_entry->p_dvbpsi, p_entry->p_packet);
+            store_release(&p_worker->i_done, p_entry->i_seq);
+
+            i_head++;
+            if ((i_head % PIPELINE_BATCH) == 0 || i_head == i_tail)
+            {
+                store_sc(&p_worker->i_head, i_head);
+                PipelineWakeRouter(p_pipeline);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************
+ * Router
+ *****************************************************************************/
+static void PipelinePublish(pipeline_worker_t *p_worker)
+{
+    if (p_worker->i_tail == p_worker->i_fill)
+        return;
+
+    store_sc(&p_worker->i_tail, p_worker->i_fill);
+    if (load_sc(&p_worker->b_sleeping))
+    {
+        pthread_mutex_lock(&p_worker->lock);
+        pthread_cond_signal(&p_worker->wait);
+        pthread_mutex_unlock(&p_worker->lock);
+    }
+}
+
+static bool PipelineFull(pipeline_worker_t *p_worker)
+{
+    return p_worker->i_fill - load_sc(&p_worker->i_head) > p_worker->i_mask;
+}
+
+static bool PipelineIdle(dvbpsi_pipeline_t *p_pipeline)
+{
+    for (unsigned int i = 0; i < p_pipeline->i_workers; i++)
+    {
+        pipeline_worker_t *p_worker = &p_pipeline->p_workers[i];
+        if (load_sc(&p_worker->i_head) != p_worker->i_fill)
+            return false;
+    }
+    return true;
+}
+
+/* Wait for room in the queue of p_worker, or for all the workers to be
+ * idle when p_worker is NULL */
+static void PipelineWait(dvbpsi_pipeline_t *p_pipeline, pipeline_worker_t *p_worker)
+{
+    pthread_mutex_lock(&p_pipeline->lock);
+    store_sc(&p_pipeline->b_sleeping, true);
+    while (p_worker ? PipelineFull(p_worker) : !PipelineIdle(p_pipeline))
+        pthread_cond_wait(&p_pipeline->wait, &p_pipeline->lock);
+    store_sc(&p_pipeline->b_sleeping, false);
+    pthread_mutex_unlock(&p_pipeline->lock);
+}
+
+/* Next free entry of the queue of p_worker */
+static pipeline_entry_t *PipelineEntry(dvbpsi_pipeline_t *p_pipeline,
+                                       pipeline_worker_t *p_worker)
+{
+    if (p_worker->i_fill - p_worker->i_head_seen > p_worker->i_mask)
+    {
+        p_worker->i_head_seen = load_acquire(&p_worker->i_head);
+        if (p_worker->i_fill - p_worker->i_head_seen > p_worker->i_mask)
+        {
+            PipelinePublish(p_worker);
+            PipelineWait(p_pipeline, p_worker);
+            p_worker->i_head_seen = load_acquire(&p_worker->i_head);
+        }
+    }
+    return &p_worker->p_entries[p_worker->i_fill & p_worker->i_mask];
+}
+
+static void PipelineCommit(pipeline_worker_t *p_worker)
+{
+    p_worker->i_fill++;
+    if ((p_worker->i_fill % PIPELINE_BATCH) == 0)
+        PipelinePublish(p_worker);
+}
+
+/*****************************************************************************
+ * Sequencing
+ *****************************************************************************/
+static pipeline_item_t *PipelineFirstItem(pipeline_worker_t *p_worker)
+{
+    pipeline_item_t *p_item = NULL;
+
+    if (load_acquire(&p_worker->i_items))
+    {
+        pthread_mutex_lock(&p_worker->lock);
+        p_item = p_worker->p_first_item;
+        pthread_mutex_unlock(&p_worker->lock);
+    }
+    return p_item;
+}
+
+/* Make the deliveries that no worker can precede any more */
+static void PipelineDrain(dvbpsi_pipeline_t *p_pipeline)
+{
+    p_pipeline->b_delivering = true;
+
+    for (;;)
+    {
+        pipeline_worker_t *p_min = NULL;
+        pipeline_item_t *p_item;
+        uint64_t i_min = 0;
+        unsigned int i;
+
+        /* progress first, so that the deliveries posted before it are seen */
+        for (i = 0; i < p_pipeline->i_workers; i++)
+        {
+            pipeline_worker_t *p_worker = &p_pipeline->p_workers[i];
+            p_worker->i_done_seen = load_acquire(&p_worker->i_done);
+            p_worker->b_idle_seen = load_acquire(&p_worker->i_head) == p_worker->i_fill;
+        }
+
+        for (i = 0; i < p_pipeline->i_workers; i++)
+        {
+            pipeline_worker_t *p_worker = &p_pipeline->p_workers[i];
+            p_item = PipelineFirstItem(p_worker);
+            if (p_item)
+            {
+                /* a worker with a pending delivery cannot precede it */
+                p_worker->b_idle_seen = true;
+                if (!p_min || p_item->i_seq < i_min)
+                {
+                    p_min = p_worker;
+                    i_min = p_item->i_seq;
+                }
+            }
+        }
+        if (!p_min)
+            break;
+
+        for (i = 0; i < p_pipeline->i_workers; i++)
+        {
+            pipeline_worker_t *p_worker = &p_pipeline->p_workers[i];
+            if (!p_worker->b_idle_seen && p_worker->i_done_seen < i_min)
+                break;
+        }
+        if (i < p_pipeline->i_workers)
+            break;
+
+        pthread_mutex_lock(&p_min->lock);
+        p_item = p_min->p_first_item;
+        p_min->p_first_item = p_item->p_next;
+        if (!p_min->p_first_item)
+            p_min->pp_last_item = &p_min->p_first_item;
+        __atomic_sub_fetch(&p_min->i_items, 1, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&p_min->lock);
+
+        if (p_item->pf_deliver)
+            p_item->pf_deliver(p_item->p_cb_data, p_item->p_object);
+        free(p_item);
+    }
+
+    p_pipeline->b_delivering = false;
+}
+
+/*****************************************************************************
+ * dvbpsi_pipeline_new
+ *****************************************************************************/
+dvbpsi_pipeline_t *dvbpsi_pipeline_new(unsigned int i_workers, size_t i_queue_packets)
+{
+    dvbpsi_pipeline_t *p_pipeline;
+    size_t i_queue = 1;
+    unsigned int i;
+
+    if (i_workers == 0 || pthread_once(&pipeline_once, PipelineKeyInit))
+        return NULL;
+    if (i_queue_packets == 0)
+        i_queue_packets = PIPELINE_DEFAULT_QUEUE;
+    while (i_queue < i_queue_packets)
+        i_queue <<= 1;
+
+    p_pipeline = calloc(1, sizeof(dvbpsi_pipeline_t));
+    if (!p_pipeline)
+        return NULL;
+    p_pipeline->p_workers = calloc(i_workers, sizeof(pipeline_worker_t));
+    if (!p_pipeline->p_workers)
+    {
+        free(p_pipeline);
+        return NULL;
+    }
+    pthread_mutex_init(&p_pipeline->lock, NULL);
+    pthread_cond_init(&p_pipeline->wait, NULL);
+
+    for (i = 0; i < i_workers; i++)
+    {
+        pipeline_worker_t *p_worker = &p_pipeline->p_workers[i];
+
+        p_worker->p_pipeline = p_pipeline;
+        p_worker->i_mask = i_queue - 1;
+        p_worker->pp_last_item = &p_worker->p_first_item;
+        p_worker->p_entries = malloc(i_queue * sizeof(pipeline_entry_t));
+        if (!p_worker->p_entries)
+            break;
+        pthread_mutex_init(&p_worker->lock, NULL);
+        pthread_cond_init(&p_worker->wait, NULL);
+        if (pthread_create(&p_worker->thread, NULL, PipelineWorker, p_worker))
+        {
+            pthread_cond_destroy(&p_worker->wait);
+            pthread_mutex_destroy(&p_worker->lock);
+            free(p_worker->p_entries);
+            break;
+        }
+        p_pipeline->i_workers++;
+    }
+
+    if (p_pipeline->i_workers < i_workers)
+    {
+        dvbpsi_pipeline_delete(p_pipeline);
+        return NULL;
+    }
+    return p_pipeline;
+}
+
+/*****************************************************************************
+ * dvbpsi_pipeline_delete
+ *****************************************************************************/
+void dvbpsi_pipeline_delete(dvbpsi_pipeline_t *p_pipeline)
+{
+    if (!p_pipeline)
+        return;
+
+    dvbpsi_pipeline_flush(p_pipeline);
+
+    for (unsigned int i = 0; i < p_pipeline->i_workers; i++)
+    {
+        pipeline_worker_t *p_worker = &p_pipeline->p_workers[i];
+
+        pthread_mutex_lock(&p_worker->lock);
+        p_worker->b_quit = true;
+        pthread_cond_signal(&p_worker->wait);
+        pthread_mutex_unlock(&p_worker->lock);
+        pthread_join(p_worker->thread, NULL);
+
+        assert(!p_worker->p_first_item);
+        pthread_cond_destroy(&p_worker->wait);
+        pthread_mutex_destroy(&p_worker->lock);
+        free(p_worker->p_entries);
+    }
+
+    pthread_cond_destroy(&p_pipeline->wait);
+    pthread_mutex_destroy(&p_pipeline->lock);
+    free(p_pipeline->p_workers);
+    free(p_pipeline);
+}
+
+/*****************************************************************************
+ * dvbpsi_pipeline_pid_add
+ *****************************************************************************/
+int dvbpsi_pipeline_pid_add(dvbpsi_pipeline_t *p_pipeline, uint16_t i_pid,
+                            dvbpsi_t *p_dvbpsi, int i_worker)
+{
+    if (i_pid >= PIPELINE_PIDS || !p_dvbpsi || p_pipeline->pids[i_pid].p_dvbpsi ||
+        i_worker >= (int)p_pipeline->i_workers)
+        return -1;
+
+    if (i_worker < 0)
+    {
+        i_worker = 0;
+        for (unsigned int i = 1; i < p_pipeline->i_workers; i++)
+            if (p_pipeline->p_workers[i].i_pids < p_pipeline->p_workers[i_worker].i_pids)
+                i_worker = i;
+    }
+
+    p_pipeline->pids[i_pid].p_dvbpsi = p_dvbpsi;
+    p_pipeline->pids[i_pid].i_worker = i_worker;
+    p_pipeline->p_workers[i_worker].i_pids++;
+    return i_worker;
+}
+
+/*****************************************************************************
+ * dvbpsi_pipeline_pid_remove
+ *****************************************************************************/
+bool dvbpsi_pipeline_pid_remove(dvbpsi_pipeline_t *p_pipeline, uint16_t i_pid,
+                                dvbpsi_pipeline_cb pf_release, void *p_cb_data)
+{
+    pipeline_pid_t *p_pid;
+    pipeline_worker_t *p_worker;
+    pipeline_item_t *p_item;
+    pipeline_entry_t *p_entry;
+
+    /* without pf_release, the caller could not know when the packets
+     * already queued stop using the handle */
+    if (i_pid >= PIPELINE_PIDS || !p_pipeline->pids[i_pid].p_dvbpsi || !pf_release)
+        return false;
+    p_pid = &p_pipeline->pids[i_pid];
+    p_worker = &p_pipeline->p_workers[p_pid->i_worker];
+
+    p_item = malloc(sizeof(pipeline_item_t));
+    if (!p_item)
+        return false;
+    p_item->pf_deliver = pf_release;
+    p_item->p_cb_data = p_cb_data;
+    p_item->p_object = p_pid->p_dvbpsi;
+
+    p_entry = PipelineEntry(p_pipeline, p_worker);
+    p_entry->i_seq = ++p_pipeline->i_seq;
+    p_entry->p_dvbpsi = p_pid->p_dvbpsi;
+    p_entry->p_release = p_item;
+    PipelineCommit(p_worker);
+    PipelinePublish(p_worker);
+
+    p_pid->p_dvbpsi = NULL;
+    p_worker->i_pids--;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_pipeline_push
+ *****************************************************************************/
+bool dvbpsi_pipeline_push(dvbpsi_pipeline_t *p_pipeline,
+                          const uint8_t *p_packets, size_t i_packets)
+{
+    if (p_pipeline->b_delivering)
+        return false;
+
+    for (size_t i = 0; i < i_packets; i++, p_packets += PIPELINE_PACKET_SIZE)
+    {
+        uint16_t i_pid = ((uint16_t)(p_packets[1] & 0x1f) << 8) | p_packets[2];
+        pipeline_pid_t *p_pid = &p_pipeline->pids[i_pid];
+        pipeline_worker_t *p_worker;
+        pipeline_entry_t *p_entry;
+
+        if (!p_pid->p_dvbpsi)
+            continue;
+
+        p_worker = &p_pipeline->p_workers[p_pid->i_worker];
+        p_entry = PipelineEntry(p_pipeline, p_worker);
+        p_entry->i_seq = ++p_pipeline->i_seq;
+        p_entry->p_dvbpsi = p_pid->p_dvbpsi;
+        p_entry->p_release = NULL;
+        memcpy(p_entry->p_packet, p_packets, PIPELINE_PACKET_SIZE);
+        PipelineCommit(p_worker);
+    }
+
+    for (unsigned int i = 0; i < p_pipeline->i_workers; i++)
+        PipelinePublish(&p_pipeline->p_workers[i]);
+
+    PipelineDrain(p_pipeline);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_pipeline_flush
+ *****************************************************************************/
+bool dvbpsi_pipeline_flush(dvbpsi_pipeline_t *p_pipeline)
+{
+    if (p_pipeline->b_delivering)
+        return false;
+
+    /* deliveries may remove PIDs, which queues more work */
+    for (;;)
+    {
+        bool b_items = false;
+
+        PipelineWait(p_pipeline, NULL);
+        PipelineDrain(p_pipeline);
+
+        for (unsigned int i = 0; i < p_pipeline->i_workers; i++)
+            b_items |= PipelineFirstItem(&p_pipeline->p_workers[i]) != NULL;
+        if (!b_items && PipelineIdle(p_pipeline))
+            break;
+    }
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_pipeline_deliver
+ *****************************************************************************/
+bool dvbpsi_pipeline_deliver(dvbpsi_pipeline_t *p_pipeline, dvbpsi_pipeline_cb pf_deliver,
+                             void *p_cb_data, void *p_object)
+{
+    pipeline_worker_t *p_worker = pthread_getspecific(pipeline_key);
+    pipeline_item_t *p_item;
+
+    if (!p_worker || p_worker->p_pipeline != p_pipeline)
+    {
+        pf_deliver(p_cb_data, p_object);
+        return true;
+    }
+
+    p_item = malloc(sizeof(pipeline_item_t));
+    if (!p_item)
+        return false;
+    p_item->i_seq = p_worker->i_current;
+    p_item->pf_deliver = pf_deliver;
+    p_item->p_cb_data = p_cb_data;
+    p_item->p_object = p_object;
+    PipelinePost(p_worker, p_item);
+    return true;
+}
+
+#else /* HAVE_PTHREAD */
+
+dvbpsi_pipeline_t *dvbpsi_pipeline_new(unsigned int i_workers, size_t i_queue_packets)
+{
+    (void)i_workers;
+    (void)i_queue_packets;
+    return NULL;
+}
+
+void dvbpsi_pipeline_delete(dvbpsi_pipeline_t *p_pipeline)
+{
+    (void)p_pipeline;
+}
+
+int dvbpsi_pipeline_pid_add(dvbpsi_pipeline_t *p_pipeline, uint16_t i_pid,
+                            dvbpsi_t *p_dvbpsi, int i_worker)
+{
+    (void)p_pipeline; (void)i_pid; (void)p_dvbpsi; (void)i_worker;
+    return -1;
+}
+
+bool dvbpsi_pipeline_pid_remove(dvbpsi_pipeline_t *p_pipeline, uint16_t i_pid,
+                                dvbpsi_pipeline_cb pf_release, void *p_cb_data)
+{
+    (void)p_pipeline; (void)i_pid; (void)pf_release; (void)p_cb_data;
+    return false;
+}
+
+bool dvbpsi_pipeline_push(dvbpsi_pipeline_t *p_pipeline,
+                          const uint8_t *p_packets, size_t i_packets)
+{
+    (void)p_pipeline; (void)p_packets; (void)i_packets;
+    return false;
+}
+
+bool dvbpsi_pipeline_flush(dvbpsi_pipeline_t *p_pipeline)
+{
+    (void)p_pipeline;
+    return false;
+}
+
+bool dvbpsi_pipeline_deliver(dvbpsi_pipeline_t *p_pipeline, dvbpsi_pipeline_cb pf_deliver,
+                             void *p_cb_data, void *p_object)
+{
+    (void)p_pipeline;
+    pf_deliver(p_cb_data, p_object);
+    return true;
+}
+
+#endif /* HAVE_PTHREAD */
@@ -0,0 +1,207 @@
+/*****************************************************************************
+ * pipeline.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <pipeline.h>
+ * \brief Multi-threaded decoding of the PSI/SI of a transport stream.
+ *
+ * The PIDs of a transport stream are spread over worker threads, each PID
+ * being decoded by its own dvbpsi_t handle on one worker. The thread calling
+ * dvbpsi_pipeline_push() routes the packets to the workers through a
+ * single-producer single-consumer queue per worker, so that a busy EIT PID
+ * does not delay the PAT and PMT decoding on another worker.
+ *
+ * The table callbacks of the handles run on the workers. To get the tables
+ * back in stream order, a callback hands its table to
+ * dvbpsi_pipeline_deliver(), for instance:
+ *
+ * \code
+ * static void handle_PAT(void *p_data, dvbpsi_pat_t *p_pat)
+ * {
+ *     dvbpsi_pipeline_deliver(p_pipeline, consume_PAT, p_data, p_pat);
+ * }
+ * \endcode
+ *
+ * consume_PAT() is later called on the thread calling dvbpsi_pipeline_push()
+ * or dvbpsi_pipeline_flush(), deliveries being made in the order of the
+ * packets that completed the tables, whatever worker decoded them.
+ *
+ * The pipeline needs POSIX threads, without them dvbpsi_pipeline_new()
+ * returns NULL.
+ */
+
+#ifndef _DVBPSI_PIPELINE_H_
+#define _DVBPSI_PIPELINE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * dvbpsi_pipeline_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_pipeline_s dvbpsi_pipeline_t
+ * \brief Opaque pipeline handle.
+ */
+typedef struct dvbpsi_pipeline_s dvbpsi_pipeline_t;
+
+/*!
+ * \typedef void (* dvbpsi_pipeline_cb)(void *p_cb_data, void *p_object)
+ * \brief Delivery callback, called in stream order by the pipeline.
+ */
+typedef void (* dvbpsi_pipeline_cb)(void *p_cb_data, void *p_object);
+
+/*****************************************************************************
+ * dvbpsi_pipeline_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_pipeline_t *dvbpsi_pipeline_new(unsigned int i_workers,
+                                              size_t i_queue_packets)
+ * \brief Create a pipeline and start its worker threads.
+ * \param i_workers number of worker threads, at least 1
+ * \param i_queue_packets size of the packet queue of each worker, rounded
+ * up to a power of 2, 0 for the default of 4096 packets
+ * \return the pipeline, NULL on error or without POSIX threads support
+ */
+dvbpsi_pipeline_t *dvbpsi_pipeline_new(unsigned int i_workers, size_t i_queue_packets);
+
+/*****************************************************************************
+ * dvbpsi_pipeline_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_pipeline_delete(dvbpsi_pipeline_t *p_pipeline)
+ * \brief Flush the pipeline, stop the workers and delete it. The handles
+ * still attached to a PID are not deleted.
+ * \param p_pipeline the pipeline, may be NULL
+ * \return nothing
+ */
+void dvbpsi_pipeline_delete(dvbpsi_pipeline_t *p_pipeline);
+
+/*****************************************************************************
+ * dvbpsi_pipeline_pid_add
+ *****************************************************************************/
+/*!
+ * \fn int dvbpsi_pipeline_pid_add(dvbpsi_pipeline_t *p_pipeline, uint16_t i_pid,
+                                   dvbpsi_t *p_dvbpsi, int i_worker)
+ * \brief Decode a PID with a handle on a worker.
+ *
+ * Once added, the handle is only used by the worker until the PID is
+ * removed: its decoders must be attached before and must not be changed
+ * from other threads. The subtable decoders of a demux may be attached by
+ * the demux callback, which runs on the worker. A PID added from a delivery
+ * callback, for instance a PMT PID found in a PAT, gets the packets pushed
+ * by the following calls to dvbpsi_pipeline_push().
+ * \param p_pipeline the pipeline
+ * \param i_pid the PID
+ * \param p_dvbpsi handle decoding the PID, not used for other PIDs
+ * \param i_worker worker decoding the PID, or -1 for the worker with the
+ * fewest PIDs
+ * \return the worker, -1 when the PID is already decoded or i_worker is
+ * invalid
+ */
+int dvbpsi_pipeline_pid_add(dvbpsi_pipeline_t *p_pipeline, uint16_t i_pid,
+                            dvbpsi_t *p_dvbpsi, int i_worker);
+
+/*****************************************************************************
+ * dvbpsi_pipeline_pid_remove
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_pipeline_pid_remove(dvbpsi_pipeline_t *p_pipeline,
+            uint16_t i_pid, dvbpsi_pipeline_cb pf_release, void *p_cb_data)
+ * \brief Stop decoding a PID.
+ *
+ * The packets of the PID pushed from now on are dropped. Once the worker
+ * has decoded the ones already pushed, pf_release is delivered like a table
+ * with the handle as p_object, at which point the caller gets the handle
+ * back and may detach its decoders and delete it. May be called from a
+ * delivery callback.
+ * \param p_pipeline the pipeline
+ * \param i_pid the PID
+ * \param pf_release called with p_cb_data and the handle, required since
+ * the packets already pushed still use the handle until then
+ * \param p_cb_data private data given to pf_release
+ * \return false when the PID is not decoded, pf_release is NULL, or on
+ * allocation failure
+ */
+bool dvbpsi_pipeline_pid_remove(dvbpsi_pipeline_t *p_pipeline, uint16_t i_pid,
+                                dvbpsi_pipeline_cb pf_release, void *p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_pipeline_push
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_pipeline_push(dvbpsi_pipeline_t *p_pipeline,
+                                 const uint8_t *p_packets, size_t i_packets)
+ * \brief Route TS packets to the workers, then make the deliveries that are
+ * due. Packets of PIDs that are not decoded are dropped. Blocks while the
+ * queue of a worker is full.
+ * \param p_pipeline the pipeline
+ * \param p_packets i_packets consecutive 188 bytes TS packets
+ * \param i_packets number of packets
+ * \return false when called from a delivery callback
+ */
+bool dvbpsi_pipeline_push(dvbpsi_pipeline_t *p_pipeline,
+                          const uint8_t *p_packets, size_t i_packets);
+
+/*****************************************************************************
+ * dvbpsi_pipeline_flush
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_pipeline_flush(dvbpsi_pipeline_t *p_pipeline)
+ * \brief Wait until all the pushed packets are decoded and make all the
+ * deliveries, for instance at the end of a stream.
+ * \param p_pipeline the pipeline
+ * \return false when called from a delivery callback
+ */
+bool dvbpsi_pipeline_flush(dvbpsi_pipeline_t *p_pipeline);
+
+/*****************************************************************************
+ * dvbpsi_pipeline_deliver
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_pipeline_deliver(dvbpsi_pipeline_t *p_pipeline,
+            dvbpsi_pipeline_cb pf_deliver, void *p_cb_data, void *p_object)
+ * \brief Hand an object, typically a decoded table, over to the thread
+ * pushing the packets.
+ *
+ * Called from a table callback running on a worker, pf_deliver(p_cb_data,
+ * p_object) is queued and called from dvbpsi_pipeline_push() or
+ * dvbpsi_pipeline_flush() after the deliveries of earlier packets of the
+ * stream. Called from any other thread, pf_deliver is called immediately.
+ * \param p_pipeline the pipeline
+ * \param pf_deliver delivery callback
+ * \param p_cb_data private data given to pf_deliver
+ * \param p_object object given to pf_deliver
+ * \return false on allocation failure, p_object then still belongs to the
+ * caller
+ */
+bool dvbpsi_pipeline_deliver(dvbpsi_pipeline_t *p_pipeline, dvbpsi_pipeline_cb pf_deliver,
+                             void *p_cb_data, void *p_object);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of pipeline.h"
+#endif
@@ -193,9 +193,48 @@ static inline bool dvbpsi_has_CRC32(dvbpsi_psi_section_t *p_section)
         (p_section->i_table_id == (uint8_t) 0x7E))/* DIT (has no CRC 32) */
         return false;
 
-    return (p_section->b_syntax_indicator || (p_section->i_table_id == 0x73));
+    /* TOT and SCTE 35 splice_info_section */
+    return (p_section->b_syntax_indicator || (p_section->i_table_id == 0x73)
+            || (p_section->i_table_id == 0xFC));
 }
 
+/*****************************************************************************
+ * dvbpsi_sections_cache_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_sections_cache_s dvbpsi_sections_cache_t
+ * \brief Opaque state of an incremental table generator.
+ *
+ * The *_sections_update() generators of the EIT, SDT, NIT and BAT keep the
+ * sections of the previous generation of one sub-table in a cache, with the
+ * entries (events, services, transport streams) each section carries. On
+ * the next generation only the sections whose entries changed are encoded
+ * again, the other ones are reused with their header and CRC_32 patched.
+ * Use one cache per sub-table.
+ */
+typedef struct dvbpsi_sections_cache_s dvbpsi_sections_cache_t;
+
+/*****************************************************************************
+ * dvbpsi_sections_cache_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_sections_cache_t *dvbpsi_sections_cache_new(void)
+ * \brief Create an empty cache for an incremental table generator.
+ * \return the cache, NULL on allocation failure
+ */
+dvbpsi_sections_cache_t *dvbpsi_sections_cache_new(void);
+
+/*****************************************************************************
+ * dvbpsi_sections_cache_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_sections_cache_delete(dvbpsi_sections_cache_t *p_cache)
+ * \brief Delete a cache and the sections it holds.
+ * \param p_cache the cache, may be NULL
+ * \return nothing
+ */
+void dvbpsi_sections_cache_delete(dvbpsi_sections_cache_t *p_cache);
+
 #ifdef __cplusplus
 };
 #endif
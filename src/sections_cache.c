@@ -0,0 +1,644 @@
+/*****************************************************************************
+ * sections_cache.c: incremental section generation
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ * The entries of a table are laid out in the sections they occupied in the
+ * previous generation whenever they still fit, so that a change in one
+ * entry only changes the section carrying it. Each section is compared
+ * with its previous version while it is laid out, without encoding it.
+ *
+ * Unchanged sections are reused as they are. Only their header changes
+ * (version_number, section numbers, ...), and as the CRC_32 is linear the
+ * new CRC_32 is obtained from the old one and the changed header bytes,
+ * without going through the whole section again.
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "dvbpsi_private.h"
+#include "psi.h"
+#include "descriptor.h"
+#include "sections_cache_private.h"
+#include "bitstream_private.h"
+
+#define CRC32_POLY      0x04c11db7
+#define MAX_HEADER      32
+#define NO_SECTION      ((size_t)-1)
+
+typedef struct cache_section_s
+{
+    dvbpsi_psi_section_t   *p_section;
+    size_t                  i_entries;
+    uint32_t                i_crc_shift;    /* x^(32 + 8 * bytes after the
+                                               header) mod the polynomial */
+} cache_section_t;
+
+typedef struct cache_key_s
+{
+    uint32_t                i_key;
+    uint32_t                i_section;
+} cache_key_t;
+
+struct dvbpsi_sections_cache_s
+{
+    bool                    b_valid;
+    uint8_t                 i_version;
+    uint16_t                i_max_size;
+
+    dvbpsi_psi_section_t   *p_first;
+    cache_section_t        *p_sections;
+    size_t                  i_sections;
+
+    cache_key_t            *p_keys;         /* entry keys in section order */
+    cache_key_t            *p_map;          /* the same, sorted on key */
+    size_t                  i_keys;
+};
+
+/* Section being laid out */
+typedef struct layout_section_s
+{
+    const void             *p_first_entry;
+    size_t                  i_entries;
+    size_t                  i_size;         /* bytes before the CRC_32 */
+    size_t                  i_old;          /* section it replaces */
+    bool                    b_equal;        /* same bytes as i_old so far */
+} layout_section_t;
+
+/*****************************************************************************
+ * CRC_32 arithmetic in GF(2)[x] modulo the CRC_32 polynomial
+ *****************************************************************************/
+static inline uint32_t MulX(uint32_t a)
+{
+    return (a & 0x80000000) ? (a << 1) ^ CRC32_POLY : a << 1;
+}
+
+static uint32_t MulMod(uint32_t a, uint32_t b)
+{
+    uint32_t r = 0;
+    for (int i = 31; i >= 0; i--)
+    {
+        r = MulX(r);
+        if ((a >> i) & 1)
+            r ^= b;
+    }
+    return r;
+}
+
+static uint32_t PowX(uint64_t n)
+{
+    uint32_t r = 1, sq = 2;
+    for (; n; n >>= 1)
+    {
+        if (n & 1)
+            r = MulMod(r, sq);
+        sq = MulMod(sq, sq);
+    }
+    return r;
+}
+
+/*****************************************************************************
+ * Descriptor loops
+ *****************************************************************************/
+static size_t DescriptorsSize(const dvbpsi_descriptor_t *p_descriptor)
+{
+    size_t i_size = 0;
+    for (; p_descriptor; p_descriptor = p_descriptor->p_next)
+        i_size += 2 + p_descriptor->i_length;
+    return i_size;
+}
+
+static void DescriptorsEncode(const dvbpsi_descriptor_t *p_descriptor,
+                              dvbpsi_writer_t *p_writer)
+{
+    for (; p_descriptor; p_descriptor = p_descriptor->p_next)
+    {
+        if (!dvbpsi_writer_need(p_writer, 2 + p_descriptor->i_length))
+            return;
+        dvbpsi_write8(p_writer, p_descriptor->i_tag);
+        dvbpsi_write8(p_writer, p_descriptor->i_length);
+        dvbpsi_write_bytes(p_writer, p_descriptor->p_data, p_descriptor->i_length);
+    }
+}
+
+/* the caller checked the loop fits in the section */
+static bool DescriptorsEqual(const dvbpsi_descriptor_t *p_descriptor, const uint8_t *p)
+{
+    for (; p_descriptor; p_descriptor = p_descriptor->p_next)
+    {
+        if (p[0] != p_descriptor->i_tag || p[1] != p_descriptor->i_length ||
+            memcmp(p + 2, p_descriptor->p_data, p_descriptor->i_length))
+            return false;
+        p += 2 + p_descriptor->i_length;
+    }
+    return true;
+}
+
+/*****************************************************************************
+ * Layout helpers
+ *****************************************************************************/
+static inline size_t HeaderSize(const dvbpsi_sections_layout_t *p_layout)
+{
+    return 8 + p_layout->i_fixed;
+}
+
+/* bytes before the first entry */
+static size_t EntriesStart(const dvbpsi_sections_layout_t *p_layout, size_t i_number)
+{
+    size_t i_start = HeaderSize(p_layout);
+    if (p_layout->b_loops)
+        i_start += 4 + (i_number == 0 ? DescriptorsSize(p_layout->p_first_loop) : 0);
+    return i_start;
+}
+
+static size_t KeyLookup(const dvbpsi_sections_cache_t *p_cache, uint32_t i_key,
+                        size_t i_index)
+{
+    size_t i_min = 0, i_max = p_cache->i_keys;
+
+    /* entries mostly come in the same order as in the previous generation */
+    if (i_index < p_cache->i_keys && p_cache->p_keys[i_index].i_key == i_key)
+        return p_cache->p_keys[i_index].i_section;
+
+    while (i_min < i_max)
+    {
+        size_t i_mid = (i_min + i_max) / 2;
+        if (p_cache->p_map[i_mid].i_key < i_key)
+            i_min = i_mid + 1;
+        else
+            i_max = i_mid;
+    }
+    if (i_min < p_cache->i_keys && p_cache->p_map[i_min].i_key == i_key)
+        return p_cache->p_map[i_min].i_section;
+    return NO_SECTION;
+}
+
+static int KeyCompare(const void *a, const void *b)
+{
+    const cache_key_t *p_a = a, *p_b = b;
+    if (p_a->i_key != p_b->i_key)
+        return p_a->i_key < p_b->i_key ? -1 : 1;
+    return p_a->i_section < p_b->i_section ? -1 : (p_a->i_section > p_b->i_section);
+}
+
+/* Start a new section replacing the old section i_old when possible */
+static void SectionOpen(const dvbpsi_sections_cache_t *p_cache,
+                        const dvbpsi_sections_layout_t *p_layout,
+                        layout_section_t *p_new, size_t i_number,
+                        size_t i_old, size_t *pi_used)
+{
+    p_new->p_first_entry = NULL;
+    p_new->i_entries = 0;
+    p_new->i_size = EntriesStart(p_layout, i_number);
+    p_new->i_old = NO_SECTION;
+    p_new->b_equal = false;
+
+    /* old sections are replaced in order, so each is used once */
+    if (i_old == NO_SECTION || i_old >= p_cache->i_sections ||
+        (*pi_used != NO_SECTION && i_old <= *pi_used))
+        return;
+
+    const dvbpsi_psi_section_t *p_old = p_cache->p_sections[i_old].p_section;
+    p_new->i_old = *pi_used = i_old;
+    p_new->b_equal = (size_t)p_old->i_length + 3 - 4 >= p_new->i_size;
+    if (p_new->b_equal && p_layout->b_loops)
+    {
+        const uint8_t *p = p_old->p_data + HeaderSize(p_layout);
+        size_t i_loop = (i_number == 0) ? DescriptorsSize(p_layout->p_first_loop) : 0;
+
+        p_new->b_equal = (dvbpsi_get16(p) & 0x0fff) == i_loop
+                      && (i_number != 0 || DescriptorsEqual(p_layout->p_first_loop, p + 2));
+    }
+}
+
+/* Compare an entry with the bytes at the same place in the old section */
+static bool EntryEqual(const dvbpsi_sections_cache_t *p_cache,
+                       const dvbpsi_sections_layout_t *p_layout,
+                       const layout_section_t *p_new, const void *p_entry,
+                       size_t i_size)
+{
+    const dvbpsi_psi_section_t *p_old = p_cache->p_sections[p_new->i_old].p_section;
+    const uint8_t *p = p_old->p_data + p_new->i_size;
+    const dvbpsi_descriptor_t *p_descriptors = p_layout->pf_descriptors(p_entry);
+    uint8_t header[MAX_HEADER];
+
+    if (p_new->i_size + i_size > (size_t)p_old->i_length + 3 - 4)
+        return false;
+
+    p_layout->pf_entry_header(p_entry, header, i_size - p_layout->i_entry_header);
+    return !memcmp(header, p, p_layout->i_entry_header)
+        && DescriptorsEqual(p_descriptors, p + p_layout->i_entry_header);
+}
+
+/* Write the section header and the fixed bytes as dvbpsi_BuildPSISection()
+ * would do */
+static void HeaderWrite(const dvbpsi_sections_layout_t *p_layout,
+                        const dvbpsi_psi_section_t *p_section, uint8_t *p)
+{
+    p[0] = p_section->i_table_id;
+    p[1] = 0x80 | (p_section->b_private_indicator ? 0x40 : 0x00) | 0x30
+         | ((p_section->i_length >> 8) & 0x0f);
+    p[2] = p_section->i_length & 0xff;
+    dvbpsi_set16(p + 3, p_section->i_extension);
+    p[5] = 0xc0 | ((p_section->i_version & 0x1f) << 1)
+         | (p_section->b_current_next ? 0x01 : 0x00);
+    p[6] = p_section->i_number;
+    p[7] = p_section->i_last_number;
+    if (p_layout->i_fixed)
+        p_layout->pf_fixed(p_layout->p_table, p + 8, p_section->i_last_number);
+}
+
+static void SectionSetHeader(const dvbpsi_sections_layout_t *p_layout,
+                             dvbpsi_psi_section_t *p_section, uint8_t i_version,
+                             size_t i_number, size_t i_sections)
+{
+    p_section->i_table_id = p_layout->i_table_id;
+    p_section->b_syntax_indicator = true;
+    p_section->b_private_indicator = p_layout->b_private_indicator;
+    p_section->i_extension = p_layout->i_extension;
+    p_section->i_version = i_version;
+    p_section->b_current_next = p_layout->b_current_next;
+    p_section->i_number = i_number;
+    p_section->i_last_number = i_sections - 1;
+}
+
+/* Patch the header of an unchanged section, returns false if it is the same */
+static bool SectionPatch(const dvbpsi_sections_layout_t *p_layout,
+                         dvbpsi_psi_section_t *p_section, uint32_t i_crc_shift)
+{
+    size_t i_header = HeaderSize(p_layout);
+    uint8_t header[MAX_HEADER];
+    uint32_t i_delta = 0;
+
+    HeaderWrite(p_layout, p_section, header);
+    for (size_t i = 0; i < i_header; i++)
+    {
+        for (int j = 0; j < 8; j++)
+            i_delta = MulX(i_delta);
+        i_delta ^= header[i] ^ p_section->p_data[i];
+    }
+    if (i_delta == 0)
+        return false;
+
+    memcpy(p_section->p_data, header, i_header);
+    p_section->i_crc ^= MulMod(i_delta, i_crc_shift);
+    dvbpsi_set32(p_section->p_payload_end, p_section->i_crc);
+    return true;
+}
+
+/* Encode a section, its header is written by dvbpsi_BuildPSISection() */
+static void SectionEncode(const dvbpsi_sections_layout_t *p_layout,
+                          dvbpsi_psi_section_t *p_section,
+                          const layout_section_t *p_new, size_t i_number)
+{
+    dvbpsi_writer_t writer;
+    uint8_t *p_loop_length = NULL;
+    const void *p_entry = p_new->p_first_entry;
+
+    /* the sizes were computed by the layout, the writer only bounds them */
+    dvbpsi_writer_init(&writer, p_section->p_data + HeaderSize(p_layout),
+                       p_section->p_data + p_new->i_size);
+
+    if (p_layout->b_loops && dvbpsi_writer_need(&writer, 2))
+    {
+        const dvbpsi_descriptor_t *p_loop = (i_number == 0) ? p_layout->p_first_loop : NULL;
+
+        dvbpsi_write16(&writer, 0xf000 | DescriptorsSize(p_loop));
+        DescriptorsEncode(p_loop, &writer);
+        if (dvbpsi_writer_need(&writer, 2))
+        {
+            p_loop_length = writer.p;
+            dvbpsi_writer_skip(&writer, 2);
+        }
+    }
+
+    for (size_t i = 0; i < p_new->i_entries; i++, p_entry = p_layout->pf_next(p_entry))
+    {
+        const dvbpsi_descriptor_t *p_descriptors = p_layout->pf_descriptors(p_entry);
+
+        if (!dvbpsi_writer_need(&writer, p_layout->i_entry_header))
+            break;
+        p_layout->pf_entry_header(p_entry, writer.p, DescriptorsSize(p_descriptors));
+        dvbpsi_writer_skip(&writer, p_layout->i_entry_header);
+        DescriptorsEncode(p_descriptors, &writer);
+    }
+
+    if (p_loop_length)
+        dvbpsi_set16(p_loop_length, 0xf000 | (writer.p - p_loop_length - 2));
+
+    assert(!writer.b_error && writer.p == writer.p_end);
+    p_section->p_payload_start = p_section->p_data + 8;
+    p_section->p_payload_end = writer.p;
+    p_section->i_length = p_new->i_size - 3 + 4;
+    p_section->p_next = NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_sections_cache_new
+ *****************************************************************************/
+dvbpsi_sections_cache_t *dvbpsi_sections_cache_new(void)
+{
+    return calloc(1, sizeof(dvbpsi_sections_cache_t));
+}
+
+/*****************************************************************************
+ * dvbpsi_sections_cache_delete
+ *****************************************************************************/
+void dvbpsi_sections_cache_delete(dvbpsi_sections_cache_t *p_cache)
+{
+    if (p_cache == NULL)
+        return;
+
+    dvbpsi_DeletePSISections(p_cache->p_first);
+    free(p_cache->p_sections);
+    free(p_cache->p_keys);
+    free(p_cache->p_map);
+    free(p_cache);
+}
+
+/*****************************************************************************
+ * dvbpsi_sections_cache_version
+ *****************************************************************************/
+uint8_t dvbpsi_sections_cache_version(const dvbpsi_sections_cache_t *p_cache)
+{
+    assert(p_cache);
+    return p_cache->i_version;
+}
+
+/*****************************************************************************
+ * dvbpsi_sections_cache_update
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_sections_cache_update(dvbpsi_t *p_dvbpsi,
+                                        dvbpsi_sections_cache_t *p_cache,
+                                        const dvbpsi_sections_layout_t *p_layout)
+{
+    size_t i_limit = p_layout->i_max_size - 4;
+    layout_section_t *p_new = NULL;
+    cache_section_t *p_sections = NULL;
+    dvbpsi_psi_section_t **pp_alloc = NULL;
+    cache_key_t *p_keys = NULL;
+    cache_key_t *p_map = NULL;
+    size_t i_new = 0, i_new_size = 0, i_keys = 0, i_keys_size = 0;
+    size_t i_used = NO_SECTION;
+    const void *p_entry;
+    bool b_changed;
+    uint8_t i_version;
+
+    assert(p_dvbpsi && p_cache && p_layout);
+    assert(HeaderSize(p_layout) <= MAX_HEADER && p_layout->i_entry_header <= MAX_HEADER);
+
+    /* sections of another size cannot be reused */
+    if (p_cache->b_valid && p_cache->i_max_size != p_layout->i_max_size)
+    {
+        dvbpsi_DeletePSISections(p_cache->p_first);
+        p_cache->p_first = NULL;
+        p_cache->i_sections = p_cache->i_keys = 0;
+    }
+
+    if (EntriesStart(p_layout, 0) > i_limit)
+    {
+        dvbpsi_error(p_dvbpsi, "sections cache", "descriptor loop too long");
+        return NULL;
+    }
+
+    /* Lay out the entries */
+    p_entry = p_layout->p_first_entry;
+    for (;;)
+    {
+        layout_section_t *p_cur = i_new ? &p_new[i_new - 1] : NULL;
+        size_t i_size = 0, i_old = NO_SECTION;
+        uint32_t i_key = 0;
+
+        if (p_entry)
+        {
+            i_size = p_layout->i_entry_header
+                   + DescriptorsSize(p_layout->pf_descriptors(p_entry));
+            if (EntriesStart(p_layout, 1) + i_size > i_limit)
+            {
+                dvbpsi_error(p_dvbpsi, "sections cache", "entry too large for a section");
+                goto error;
+            }
+            i_key = p_layout->pf_key(p_entry);
+            i_old = KeyLookup(p_cache, i_key, i_keys);
+        }
+
+        /* the entry was in a later section or does not fit: next section */
+        if (p_cur && p_entry &&
+            ((i_old != NO_SECTION && (i_used == NO_SECTION || i_old > i_used)) ||
+             p_cur->i_size + i_size > i_limit))
+        {
+            if (p_cur->i_entries == 0 && p_cur->i_size + i_size <= i_limit)
+                /* nothing in this section yet, it takes the place of i_old */
+                SectionOpen(p_cache, p_layout, p_cur, i_new - 1, i_old, &i_used);
+            else
+                p_cur = NULL;
+        }
+
+        if (!p_cur && (p_entry || i_new == 0))
+        {
+            if (i_new == i_new_size)
+            {
+                size_t i_size_new = i_new_size ? 2 * i_new_size : 16;
+                layout_section_t *p_realloc = realloc(p_new, i_size_new * sizeof(*p_new));
+                if (!p_realloc)
+                    goto error;
+                p_new = p_realloc;
+                i_new_size = i_size_new;
+            }
+            if (i_new == 256)
+            {
+                dvbpsi_error(p_dvbpsi, "sections cache", "too many sections");
+                goto error;
+            }
+            p_cur = &p_new[i_new];
+            if (i_old == NO_SECTION || (i_used != NO_SECTION && i_old <= i_used))
+                i_old = (i_used == NO_SECTION) ? 0 : i_used + 1;
+            SectionOpen(p_cache, p_layout, p_cur, i_new, i_old, &i_used);
+            i_new++;
+        }
+
+        if (!p_entry)
+            break;
+
+        if (i_keys == i_keys_size)
+        {
+            size_t i_size_new = i_keys_size ? 2 * i_keys_size : 64;
+            cache_key_t *p_realloc = realloc(p_keys, i_size_new * sizeof(cache_key_t));
+            if (!p_realloc)
+                goto error;
+            p_keys = p_realloc;
+            i_keys_size = i_size_new;
+        }
+        p_keys[i_keys].i_key = i_key;
+        p_keys[i_keys++].i_section = i_new - 1;
+
+        if (p_cur->b_equal)
+            p_cur->b_equal = EntryEqual(p_cache, p_layout, p_cur, p_entry, i_size);
+        if (p_cur->i_entries++ == 0)
+            p_cur->p_first_entry = p_entry;
+        p_cur->i_size += i_size;
+
+        p_entry = p_layout->pf_next(p_entry);
+    }
+
+    /* Allocate everything before touching the old sections */
+    p_sections = calloc(i_new, sizeof(cache_section_t));
+    pp_alloc = calloc(i_new, sizeof(dvbpsi_psi_section_t *));
+    p_map = malloc((i_keys ? i_keys : 1) * sizeof(cache_key_t));
+    if (!p_sections || !pp_alloc || !p_map)
+        goto error;
+
+    b_changed = !p_cache->b_valid || i_new != p_cache->i_sections;
+    for (size_t i = 0; i < i_new; i++)
+    {
+        layout_section_t *p_cur = &p_new[i];
+
+        if (p_cur->b_equal)
+        {
+            const cache_section_t *p_old = &p_cache->p_sections[p_cur->i_old];
+            p_cur->b_equal = p_cur->i_entries == p_old->i_entries
+                          && p_cur->i_size == (size_t)p_old->p_section->i_length + 3 - 4;
+        }
+        if (!p_cur->b_equal || p_cur->i_old != i)
+            b_changed = true;
+        if (p_cur->i_old == NO_SECTION &&
+            !(pp_alloc[i] = dvbpsi_NewPSISection(p_layout->i_max_size)))
+            goto error;
+    }
+
+    /* Take the old sections */
+    for (size_t i = 0; i < i_new; i++)
+    {
+        p_sections[i].i_entries = p_new[i].i_entries;
+        if (p_new[i].i_old != NO_SECTION)
+        {
+            cache_section_t *p_old = &p_cache->p_sections[p_new[i].i_old];
+            p_sections[i].p_section = p_old->p_section;
+            p_sections[i].i_crc_shift = p_old->i_crc_shift;
+            p_old->p_section = NULL;
+        }
+        else
+            p_sections[i].p_section = pp_alloc[i];
+    }
+    for (size_t i = 0; i < p_cache->i_sections; i++)
+    {
+        if (p_cache->p_sections[i].p_section)
+        {
+            p_cache->p_sections[i].p_section->p_next = NULL;
+            dvbpsi_DeletePSISections(p_cache->p_sections[i].p_section);
+        }
+    }
+
+    /* A header change, for instance of the transport_stream_id, is a change too */
+    for (size_t i = 0; i < i_new && !b_changed; i++)
+    {
+        dvbpsi_psi_section_t *p_section = p_sections[i].p_section;
+        uint8_t header[MAX_HEADER];
+
+        SectionSetHeader(p_layout, p_section, p_cache->i_version, i, i_new);
+        HeaderWrite(p_layout, p_section, header);
+        b_changed = memcmp(header, p_section->p_data, HeaderSize(p_layout)) != 0;
+    }
+
+    if (!p_cache->b_valid)
+        i_version = p_layout->i_version & 0x1f;
+    else if (b_changed)
+        i_version = (p_cache->i_version + 1) & 0x1f;
+    else
+        i_version = p_cache->i_version;
+
+    /* Encode the changed sections, patch the others */
+    for (size_t i = 0; i < i_new; i++)
+    {
+        dvbpsi_psi_section_t *p_section = p_sections[i].p_section;
+
+        if (!p_new[i].b_equal)
+            SectionEncode(p_layout, p_section, &p_new[i], i);
+        SectionSetHeader(p_layout, p_section, i_version, i, i_new);
+
+        if (p_new[i].b_equal)
+            SectionPatch(p_layout, p_section, p_sections[i].i_crc_shift);
+        else
+        {
+            if (p_layout->i_fixed)
+                p_layout->pf_fixed(p_layout->p_table, p_section->p_data + 8, i_new - 1);
+            dvbpsi_BuildPSISection(p_dvbpsi, p_section);
+            p_sections[i].i_crc_shift = PowX(32 + 8 * (p_new[i].i_size - HeaderSize(p_layout)));
+        }
+        p_section->p_next = (i + 1 < i_new) ? p_sections[i + 1].p_section : NULL;
+    }
+
+    /* Keep the layout for the next generation */
+    if (i_keys == p_cache->i_keys &&
+        !memcmp(p_keys, p_cache->p_keys, i_keys * sizeof(cache_key_t)))
+    {
+        cache_key_t *p_swap = p_map;
+        p_map = p_cache->p_map;
+        p_cache->p_map = p_swap;
+    }
+    else
+    {
+        memcpy(p_map, p_keys, i_keys * sizeof(cache_key_t));
+        qsort(p_map, i_keys, sizeof(cache_key_t), KeyCompare);
+    }
+
+    free(p_cache->p_sections);
+    free(p_cache->p_keys);
+    free(p_cache->p_map);
+    p_cache->p_first = p_sections[0].p_section;
+    p_cache->p_sections = p_sections;
+    p_cache->i_sections = i_new;
+    p_cache->p_keys = p_keys;
+    p_cache->p_map = p_map;
+    p_cache->i_keys = i_keys;
+    p_cache->i_version = i_version;
+    p_cache->i_max_size = p_layout->i_max_size;
+    p_cache->b_valid = true;
+
+    free(pp_alloc);
+    free(p_new);
+    return p_cache->p_first;
+
+error:
+    if (pp_alloc)
+        for (size_t i = 0; i < i_new; i++)
+            dvbpsi_DeletePSISections(pp_alloc[i]);
+    free(pp_alloc);
+    free(p_sections);
+    free(p_map);
+    free(p_keys);
+    free(p_new);
+    return NULL;
+}
@@ -0,0 +1,94 @@
+/*****************************************************************************
+ * sections_cache_private.h: incremental section generation
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#ifndef _DVBPSI_SECTIONS_CACHE_PRIVATE_H_
+#define _DVBPSI_SECTIONS_CACHE_PRIVATE_H_
+
+/*****************************************************************************
+ * dvbpsi_sections_layout_t
+ *****************************************************************************
+ * Description of a table made of a list of entries, each entry being a
+ * fixed header ending with a 12 bits descriptors_loop_length followed by
+ * its descriptors (EIT events, SDT services, NIT and BAT transport streams).
+ *
+ * A section is:
+ *   8 bytes header, up to last_section_number
+ *   i_fixed bytes written by pf_fixed()
+ *   if b_loops: 4 bits reserved, 12 bits loop length, the p_first_loop
+ *               descriptors in section 0 only, then 4 bits reserved and
+ *               the 12 bits length of the entry loop
+ *   entries
+ *   CRC_32
+ *****************************************************************************/
+typedef struct dvbpsi_sections_layout_s
+{
+    /* section header */
+    uint8_t     i_table_id;
+    bool        b_private_indicator;
+    uint16_t    i_extension;
+    uint8_t     i_version;          /* version of the first generation */
+    bool        b_current_next;
+    uint16_t    i_max_size;         /* section size limit, CRC_32 included */
+
+    const void *p_table;
+    uint8_t     i_fixed;
+    void      (*pf_fixed)(const void *p_table, uint8_t *p_fixed,
+                          uint8_t i_last_number);
+
+    bool        b_loops;
+    const dvbpsi_descriptor_t *p_first_loop;
+
+    const void *p_first_entry;
+    uint8_t     i_entry_header;     /* bytes before the descriptors */
+    const void *(*pf_next)(const void *p_entry);
+    uint32_t    (*pf_key)(const void *p_entry);
+    const dvbpsi_descriptor_t *(*pf_descriptors)(const void *p_entry);
+    /* writes the entry header, descriptors_loop_length included */
+    void        (*pf_entry_header)(const void *p_entry, uint8_t *p_header,
+                                   uint16_t i_descriptors_length);
+} dvbpsi_sections_layout_t;
+
+/*****************************************************************************
+ * dvbpsi_sections_cache_update
+ *****************************************************************************
+ * Generate the sections of the table described by p_layout, reusing the
+ * sections of the previous generation held in p_cache. The version is the
+ * one of p_layout on the first generation, it is incremented once when
+ * anything changed since the previous one. The sections belong to the
+ * cache, NULL is returned on error.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_sections_cache_update(dvbpsi_t *p_dvbpsi,
+                                        dvbpsi_sections_cache_t *p_cache,
+                                        const dvbpsi_sections_layout_t *p_layout);
+
+/*****************************************************************************
+ * dvbpsi_sections_cache_version
+ *****************************************************************************
+ * Version of the last generation.
+ *****************************************************************************/
+uint8_t dvbpsi_sections_cache_version(const dvbpsi_sections_cache_t *p_cache);
+
+#else
+#error "Multiple inclusions of sections_cache_private.h"
+#endif
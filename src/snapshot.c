@@ -0,0 +1,351 @@
+/*****************************************************************************
+ * snapshot.c: reference counted immutable table snapshots
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "snapshot.h"
+#include "lock_private.h"
+
+/* The critical sections of the store are a hash lookup and a pointer swap,
+ * the snapshots themselves are released and freed outside of the lock. */
+
+#define STORE_INITIAL_BUCKETS 64
+
+typedef struct snapshot_slot_s
+{
+    uint64_t                i_key;
+    dvbpsi_snapshot_t      *p_snapshot;     /* NULL once removed */
+    struct snapshot_slot_s *p_next;
+} snapshot_slot_t;
+
+/* A snapshot with its reference count, the public part first */
+typedef struct snapshot_private_s
+{
+    dvbpsi_snapshot_t       snapshot;
+    unsigned int            i_refcount;
+    void                   *p_owned_table;
+    dvbpsi_snapshot_free_cb pf_free;
+} snapshot_private_t;
+
+struct dvbpsi_snapshot_store_s
+{
+    dvbpsi_lock_t       lock;
+
+    snapshot_slot_t   **pp_buckets;
+    size_t              i_buckets;          /* power of 2 */
+    size_t              i_slots;
+    size_t              i_count;            /* slots with a snapshot */
+
+    uint64_t            i_generation;
+};
+
+static size_t StoreHash(uint64_t i_key, size_t i_buckets)
+{
+    i_key *= UINT64_C(0x9e3779b97f4a7c15);
+    return (size_t)(i_key >> 32) & (i_buckets - 1);
+}
+
+static snapshot_slot_t *StoreFind(dvbpsi_snapshot_store_t *p_store, uint64_t i_key)
+{
+    snapshot_slot_t *p_slot = p_store->pp_buckets[StoreHash(i_key, p_store->i_buckets)];
+    while (p_slot && p_slot->i_key != i_key)
+        p_slot = p_slot->p_next;
+    return p_slot;
+}
+
+/* Called without the lock, the new buckets are swapped in under it. */
+static void StoreGrow(dvbpsi_snapshot_store_t *p_store)
+{
+    snapshot_slot_t **pp_buckets, **pp_old;
+    size_t i_buckets;
+
+    dvbpsi_lock(&p_store->lock);
+    i_buckets = p_store->i_buckets * 2;
+    dvbpsi_unlock(&p_store->lock);
+
+    pp_buckets = calloc(i_buckets, sizeof(snapshot_slot_t *));
+    if (!pp_buckets)
+        return; /* the chains just get longer */
+
+    dvbpsi_lock(&p_store->lock);
+    if (p_store->i_buckets * 2 != i_buckets)
+    {
+        /* another thread grew it */
+        dvbpsi_unlock(&p_store->lock);
+        free(pp_buckets);
+        return;
+    }
+    pp_old = p_store->pp_buckets;
+    for (size_t i = 0; i < p_store->i_buckets; i++)
+    {
+        snapshot_slot_t *p_slot = pp_old[i];
+        while (p_slot)
+        {
+            snapshot_slot_t *p_next = p_slot->p_next;
+            size_t i_bucket = StoreHash(p_slot->i_key, i_buckets);
+            p_slot->p_next = pp_buckets[i_bucket];
+            pp_buckets[i_bucket] = p_slot;
+            p_slot = p_next;
+        }
+    }
+    p_store->pp_buckets = pp_buckets;
+    p_store->i_buckets = i_buckets;
+    dvbpsi_unlock(&p_store->lock);
+    free(pp_old);
+}
+
+/*****************************************************************************
+ * dvbpsi_snapshot_hold
+ *****************************************************************************/
+dvbpsi_snapshot_t *dvbpsi_snapshot_hold(dvbpsi_snapshot_t *p_snapshot)
+{
+    snapshot_private_t *p_private = (snapshot_private_t *)p_snapshot;
+
+    __atomic_add_fetch(&p_private->i_refcount, 1, __ATOMIC_RELAXED);
+    return p_snapshot;
+}
+
+/*****************************************************************************
+ * dvbpsi_snapshot_release
+ *****************************************************************************/
+void dvbpsi_snapshot_release(dvbpsi_snapshot_t *p_snapshot)
+{
+    snapshot_private_t *p_private = (snapshot_private_t *)p_snapshot;
+
+    if (!p_snapshot)
+        return;
+    if (__atomic_sub_fetch(&p_private->i_refcount, 1, __ATOMIC_ACQ_REL) != 0)
+        return;
+
+    if (p_private->pf_free)
+        p_private->pf_free(p_private->p_owned_table);
+    free(p_private);
+}
+
+/*****************************************************************************
+ * dvbpsi_snapshot_store_new
+ *****************************************************************************/
+dvbpsi_snapshot_store_t *dvbpsi_snapshot_store_new(void)
+{
+    dvbpsi_snapshot_store_t *p_store = calloc(1, sizeof(dvbpsi_snapshot_store_t));
+    if (!p_store)
+        return NULL;
+    p_store->pp_buckets = calloc(STORE_INITIAL_BUCKETS, sizeof(snapshot_slot_t *));
+    if (!p_store->pp_buckets || !dvbpsi_lock_init(&p_store->lock))
+    {
+        free(p_store->pp_buckets);
+        free(p_store);
+        return NULL;
+    }
+    p_store->i_buckets = STORE_INITIAL_BUCKETS;
+    return p_store;
+}
+
+/*****************************************************************************
+ * dvbpsi_snapshot_store_delete
+ *****************************************************************************/
+void dvbpsi_snapshot_store_delete(dvbpsi_snapshot_store_t *p_store)
+{
+    if (!p_store)
+        return;
+
+    for (size_t i = 0; i < p_store->i_buckets; i++)
+    {
+        snapshot_slot_t *p_slot = p_store->pp_buckets[i];
+        while (p_slot)
+        {
+            snapshot_slot_t *p_next = p_slot->p_next;
+            dvbpsi_snapshot_release(p_slot->p_snapshot);
+            free(p_slot);
+            p_slot = p_next;
+        }
+    }
+    free(p_store->pp_buckets);
+    dvbpsi_lock_destroy(&p_store->lock);
+    free(p_store);
+}
+
+/*****************************************************************************
+ * dvbpsi_snapshot_publish
+ *****************************************************************************/
+bool dvbpsi_snapshot_publish(dvbpsi_snapshot_store_t *p_store, uint64_t i_key,
+                             uint8_t i_version, bool b_current_next,
+                             void *p_table, dvbpsi_snapshot_free_cb pf_free)
+{
+    snapshot_private_t *p_private = malloc(sizeof(snapshot_private_t));
+    dvbpsi_snapshot_t *p_snapshot, *p_old;
+    snapshot_slot_t *p_slot, *p_new_slot = NULL;
+    bool b_grow = false;
+
+    if (!p_private)
+    {
+        if (pf_free)
+            pf_free(p_table);
+        return false;
+    }
+    p_snapshot = &p_private->snapshot;
+    p_snapshot->i_key = i_key;
+    p_snapshot->i_version = i_version;
+    p_snapshot->b_current_next = b_current_next;
+    p_snapshot->p_table = p_table;
+    p_private->p_owned_table = p_table;
+    p_private->i_refcount = 1; /* the store reference */
+    p_private->pf_free = pf_free;
+
+    dvbpsi_lock(&p_store->lock);
+    p_slot = StoreFind(p_store, i_key);
+    if (!p_slot)
+    {
+        dvbpsi_unlock(&p_store->lock);
+        p_new_slot = malloc(sizeof(snapshot_slot_t));
+        if (!p_new_slot)
+        {
+            free(p_private);
+            if (pf_free)
+                pf_free(p_table);
+            return false;
+        }
+        dvbpsi_lock(&p_store->lock);
+        /* the subtable may have been published meanwhile */
+        p_slot = StoreFind(p_store, i_key);
+        if (!p_slot)
+        {
+            size_t i_bucket = StoreHash(i_key, p_store->i_buckets);
+            p_slot = p_new_slot;
+            p_slot->i_key = i_key;
+            p_slot->p_snapshot = NULL;
+            p_slot->p_next = p_store->pp_buckets[i_bucket];
+            p_store->pp_buckets[i_bucket] = p_slot;
+            p_store->i_slots++;
+            b_grow = p_store->i_slots > p_store->i_buckets;
+            p_new_slot = NULL;
+        }
+    }
+
+    p_old = p_slot->p_snapshot;
+    p_snapshot->i_generation = ++p_store->i_generation;
+    p_slot->p_snapshot = p_snapshot;
+    if (!p_old)
+        p_store->i_count++;
+    dvbpsi_unlock(&p_store->lock);
+
+    free(p_new_slot);
+    /* the readers holding the previous version keep it */
+    dvbpsi_snapshot_release(p_old);
+    if (b_grow)
+        StoreGrow(p_store);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_snapshot_get
+ *****************************************************************************/
+dvbpsi_snapshot_t *dvbpsi_snapshot_get(dvbpsi_snapshot_store_t *p_store, uint64_t i_key)
+{
+    dvbpsi_snapshot_t *p_snapshot = NULL;
+    snapshot_slot_t *p_slot;
+
+    dvbpsi_lock(&p_store->lock);
+    p_slot = StoreFind(p_store, i_key);
+    if (p_slot && p_slot->p_snapshot)
+        p_snapshot = dvbpsi_snapshot_hold(p_slot->p_snapshot);
+    dvbpsi_unlock(&p_store->lock);
+
+    return p_snapshot;
+}
+
+/*****************************************************************************
+ * dvbpsi_snapshot_remove
+ *****************************************************************************/
+bool dvbpsi_snapshot_remove(dvbpsi_snapshot_store_t *p_store, uint64_t i_key)
+{
+    dvbpsi_snapshot_t *p_old = NULL;
+    snapshot_slot_t *p_slot;
+
+    dvbpsi_lock(&p_store->lock);
+    p_slot = StoreFind(p_store, i_key);
+    if (p_slot && p_slot->p_snapshot)
+    {
+        /* the slot is kept, the subtable is likely to come back */
+        p_old = p_slot->p_snapshot;
+        p_slot->p_snapshot = NULL;
+        p_store->i_count--;
+        p_store->i_generation++;
+    }
+    dvbpsi_unlock(&p_store->lock);
+
+    dvbpsi_snapshot_release(p_old);
+    return p_old != NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_snapshot_list
+ *****************************************************************************/
+size_t dvbpsi_snapshot_list(dvbpsi_snapshot_store_t *p_store,
+                            dvbpsi_snapshot_t **pp_snapshots, size_t i_max)
+{
+    size_t i_count, i_listed = 0;
+
+    dvbpsi_lock(&p_store->lock);
+    i_count = p_store->i_count;
+    for (size_t i = 0; i < p_store->i_buckets && i_listed < i_max; i++)
+    {
+        for (snapshot_slot_t *p_slot = p_store->pp_buckets[i];
+             p_slot && i_listed < i_max; p_slot = p_slot->p_next)
+        {
+            if (p_slot->p_snapshot)
+                pp_snapshots[i_listed++] = dvbpsi_snapshot_hold(p_slot->p_snapshot);
+        }
+    }
+    dvbpsi_unlock(&p_store->lock);
+
+    return i_count;
+}
+
+/*****************************************************************************
+ * dvbpsi_snapshot_generation
+ *****************************************************************************/
+uint64_t dvbpsi_snapshot_generation(dvbpsi_snapshot_store_t *p_store)
+{
+    uint64_t i_generation;
+
+    dvbpsi_lock(&p_store->lock);
+    i_generation = p_store->i_generation;
+    dvbpsi_unlock(&p_store->lock);
+
+    return i_generation;
+}
@@ -0,0 +1,238 @@
+/*****************************************************************************
+ * snapshot.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <snapshot.h>
+ * \brief Reference counted immutable table snapshots.
+ *
+ * A table callback gets the ownership of a decoded table. Publishing it in
+ * a snapshot store makes it a read only snapshot that any thread can get
+ * and keep as long as it holds a reference, without copying it:
+ *
+ * \code
+ * static void free_EIT(void *p_table)
+ * {
+ *     dvbpsi_eit_delete(p_table);
+ * }
+ *
+ * static void handle_EIT(void *p_data, dvbpsi_eit_t *p_eit)
+ * {
+ *     dvbpsi_snapshot_publish(p_store,
+ *                             DVBPSI_SNAPSHOT_KEY(p_eit->i_table_id, p_eit->i_extension,
+ *                                                 (uint32_t)p_eit->i_network_id << 16 | p_eit->i_ts_id),
+ *                             p_eit->i_version, p_eit->b_current_next,
+ *                             p_eit, free_EIT);
+ * }
+ * \endcode
+ *
+ * A new version of a subtable replaces the previous snapshot in the store,
+ * which is only freed once the last reader has released it. Readers never
+ * wait for a table callback: dvbpsi_snapshot_get() returns the current
+ * snapshot of a subtable at any time.
+ */
+
+#ifndef _DVBPSI_SNAPSHOT_H_
+#define _DVBPSI_SNAPSHOT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ * \typedef void (* dvbpsi_snapshot_free_cb)(void *p_table)
+ * \brief Callback freeing the table of a snapshot, typically calling the
+ * dvbpsi_*_delete() function of the table.
+ */
+typedef void (* dvbpsi_snapshot_free_cb)(void *p_table);
+
+/*!
+ * \def DVBPSI_SNAPSHOT_KEY(table_id, extension, extra)
+ * \brief Key of a subtable: table_id, table_id_extension and 32 more bits
+ * for the tables that need them, such as the original_network_id and
+ * transport_stream_id of an EIT.
+ */
+#define DVBPSI_SNAPSHOT_KEY(table_id, extension, extra) \
+    (((uint64_t)(table_id) << 48) | ((uint64_t)(extension) << 32) | (uint32_t)(extra))
+
+/*****************************************************************************
+ * dvbpsi_snapshot_t
+ *****************************************************************************/
+/*!
+ * \struct dvbpsi_snapshot_s
+ * \brief Immutable snapshot of a decoded table. All the fields are read only.
+ */
+/*!
+ * \typedef struct dvbpsi_snapshot_s dvbpsi_snapshot_t
+ * \brief dvbpsi_snapshot_t type definition.
+ */
+typedef struct dvbpsi_snapshot_s
+{
+    uint64_t            i_key;          /*!< subtable key */
+    uint8_t             i_version;      /*!< version_number */
+    bool                b_current_next; /*!< current_next_indicator */
+    uint64_t            i_generation;   /*!< store generation at publication */
+    const void         *p_table;        /*!< the decoded table */
+} dvbpsi_snapshot_t;
+
+/*****************************************************************************
+ * dvbpsi_snapshot_hold
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_snapshot_t *dvbpsi_snapshot_hold(dvbpsi_snapshot_t *p_snapshot)
+ * \brief Take another reference on a snapshot the caller already holds.
+ * \param p_snapshot the snapshot
+ * \return p_snapshot
+ */
+dvbpsi_snapshot_t *dvbpsi_snapshot_hold(dvbpsi_snapshot_t *p_snapshot);
+
+/*****************************************************************************
+ * dvbpsi_snapshot_release
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_snapshot_release(dvbpsi_snapshot_t *p_snapshot)
+ * \brief Release a reference, freeing the snapshot and its table with the
+ * last one.
+ * \param p_snapshot the snapshot, may be NULL
+ * \return nothing
+ */
+void dvbpsi_snapshot_release(dvbpsi_snapshot_t *p_snapshot);
+
+/*****************************************************************************
+ * dvbpsi_snapshot_store_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_snapshot_store_s dvbpsi_snapshot_store_t
+ * \brief Opaque store of the current snapshot of each subtable. All the
+ * functions of a store may be called from any thread.
+ */
+typedef struct dvbpsi_snapshot_store_s dvbpsi_snapshot_store_t;
+
+/*****************************************************************************
+ * dvbpsi_snapshot_store_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_snapshot_store_t *dvbpsi_snapshot_store_new(void)
+ * \brief Create an empty snapshot store.
+ * \return the store, NULL on error
+ */
+dvbpsi_snapshot_store_t *dvbpsi_snapshot_store_new(void);
+
+/*****************************************************************************
+ * dvbpsi_snapshot_store_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_snapshot_store_delete(dvbpsi_snapshot_store_t *p_store)
+ * \brief Delete a store, releasing its snapshots. The snapshots still held
+ * by readers remain valid.
+ * \param p_store the store, may be NULL
+ * \return nothing
+ */
+void dvbpsi_snapshot_store_delete(dvbpsi_snapshot_store_t *p_store);
+
+/*****************************************************************************
+ * dvbpsi_snapshot_publish
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_snapshot_publish(dvbpsi_snapshot_store_t *p_store,
+            uint64_t i_key, uint8_t i_version, bool b_current_next,
+            void *p_table, dvbpsi_snapshot_free_cb pf_free)
+ * \brief Make a table the current snapshot of its subtable, replacing the
+ * previous one. The store takes the ownership of the table, which must not
+ * be modified any more.
+ * \param p_store the store
+ * \param i_key subtable key, see DVBPSI_SNAPSHOT_KEY()
+ * \param i_version version_number of the table
+ * \param b_current_next current_next_indicator of the table
+ * \param p_table the table
+ * \param pf_free callback freeing the table
+ * \return false on allocation failure, the table is then freed
+ */
+bool dvbpsi_snapshot_publish(dvbpsi_snapshot_store_t *p_store, uint64_t i_key,
+                             uint8_t i_version, bool b_current_next,
+                             void *p_table, dvbpsi_snapshot_free_cb pf_free);
+
+/*****************************************************************************
+ * dvbpsi_snapshot_get
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_snapshot_t *dvbpsi_snapshot_get(dvbpsi_snapshot_store_t *p_store,
+                                             uint64_t i_key)
+ * \brief Get the current snapshot of a subtable.
+ * \param p_store the store
+ * \param i_key subtable key
+ * \return the snapshot, to be released with dvbpsi_snapshot_release(), or
+ * NULL when the subtable has not been published
+ */
+dvbpsi_snapshot_t *dvbpsi_snapshot_get(dvbpsi_snapshot_store_t *p_store, uint64_t i_key);
+
+/*****************************************************************************
+ * dvbpsi_snapshot_remove
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_snapshot_remove(dvbpsi_snapshot_store_t *p_store,
+                                   uint64_t i_key)
+ * \brief Remove the current snapshot of a subtable from the store.
+ * \param p_store the store
+ * \param i_key subtable key
+ * \return false when the subtable has not been published
+ */
+bool dvbpsi_snapshot_remove(dvbpsi_snapshot_store_t *p_store, uint64_t i_key);
+
+/*****************************************************************************
+ * dvbpsi_snapshot_list
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_snapshot_list(dvbpsi_snapshot_store_t *p_store,
+                                   dvbpsi_snapshot_t **pp_snapshots,
+                                   size_t i_max)
+ * \brief Get the current snapshots of all the subtables, in no particular
+ * order.
+ * \param p_store the store
+ * \param pp_snapshots filled with up to i_max snapshots, each to be released
+ * with dvbpsi_snapshot_release()
+ * \param i_max size of pp_snapshots
+ * \return the number of subtables in the store, which may be more than
+ * i_max
+ */
+size_t dvbpsi_snapshot_list(dvbpsi_snapshot_store_t *p_store,
+                            dvbpsi_snapshot_t **pp_snapshots, size_t i_max);
+
+/*****************************************************************************
+ * dvbpsi_snapshot_generation
+ *****************************************************************************/
+/*!
+ * \fn uint64_t dvbpsi_snapshot_generation(dvbpsi_snapshot_store_t *p_store)
+ * \brief Get the generation of a store, incremented by each publication and
+ * removal. A reader comparing it with the generation it last saw knows
+ * whether anything changed without looking up the subtables.
+ * \param p_store the store
+ * \return the generation
+ */
+uint64_t dvbpsi_snapshot_generation(dvbpsi_snapshot_store_t *p_store);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of snapshot.h"
+#endif
@@ -0,0 +1,913 @@
+/*****************************************************************************
+ * state.c: PSI/SI state of a transport stream
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "psi.h"
+#include "descriptor.h"
+#include "snapshot.h"
+#include "state.h"
+#include "lock_private.h"
+#include "tables/pat.h"
+#include "tables/cat.h"
+#include "tables/pmt.h"
+#include "tables/sdt.h"
+#include "tables/nit.h"
+
+#define STATE_PIDS          8192
+#define STATE_NO_PID        0x1fff
+#define STATE_MAP_BUCKETS   64
+
+/* Entries of the service and transport indexes, keyed by service_id and by
+ * original_network_id << 16 | transport_stream_id. They are only freed with
+ * the store. */
+typedef struct state_node_s
+{
+    uint32_t                i_key;
+    struct state_node_s    *p_next;
+} state_node_t;
+
+typedef struct state_map_s
+{
+    state_node_t          **pp_buckets;
+    size_t                  i_buckets;      /* power of 2 */
+    size_t                  i_count;
+} state_map_t;
+
+typedef struct state_service_s
+{
+    state_node_t            node;
+
+    bool                    b_in_pat;
+    uint16_t                i_pmt_pid;      /* STATE_NO_PID if not in the PAT */
+    uint64_t                i_pat_generation;
+    dvbpsi_snapshot_t      *p_pmt;
+    dvbpsi_snapshot_t      *p_sdt;          /* SDT actual listing it */
+    const dvbpsi_sdt_service_t *p_sdt_service;
+    uint64_t                i_generation;
+} state_service_t;
+
+typedef struct state_transport_s
+{
+    state_node_t            node;
+
+    dvbpsi_snapshot_t      *p_nit;          /* NIT listing it */
+    const dvbpsi_nit_ts_t  *p_nit_ts;
+    dvbpsi_snapshot_t      *p_sdt;
+    uint64_t                i_generation;
+} state_transport_t;
+
+struct dvbpsi_state_s
+{
+    dvbpsi_lock_t           lock;
+
+    dvbpsi_snapshot_store_t *p_tables;
+    dvbpsi_snapshot_t      *p_pat;
+    dvbpsi_snapshot_t      *p_cat;
+    dvbpsi_snapshot_t      *p_sdt;          /* SDT actual */
+
+    state_map_t             services;
+    state_map_t             transports;
+
+    dvbpsi_state_pid_t      pids[STATE_PIDS];
+
+    /* PIDs a table change may affect, see StateUpdatePids() */
+    dvbpsi_state_pid_t      new_pids[STATE_PIDS];
+    uint8_t                 marks[STATE_PIDS / 8];
+    uint16_t                marked[STATE_PIDS];
+    size_t                  i_marked;
+
+    uint64_t                i_generation;
+};
+
+/*****************************************************************************
+ * Indexes
+ *****************************************************************************/
+static size_t MapHash(uint32_t i_key, size_t i_buckets)
+{
+    return (size_t)((i_key * UINT32_C(0x9e3779b1)) >> 8) & (i_buckets - 1);
+}
+
+static bool MapInit(state_map_t *p_map)
+{
+    p_map->pp_buckets = calloc(STATE_MAP_BUCKETS, sizeof(state_node_t *));
+    p_map->i_buckets = STATE_MAP_BUCKETS;
+    p_map->i_count = 0;
+    return p_map->pp_buckets != NULL;
+}
+
+static void MapClean(state_map_t *p_map, void (*pf_clean)(state_node_t *))
+{
+    for (size_t i = 0; p_map->pp_buckets && i < p_map->i_buckets; i++)
+    {
+        state_node_t *p_node = p_map->pp_buckets[i];
+        while (p_node)
+        {
+            state_node_t *p_next = p_node->p_next;
+            pf_clean(p_node);
+            free(p_node);
+            p_node = p_next;
+        }
+    }
+    free(p_map->pp_buckets);
+}
+
+static state_node_t *MapFind(const state_map_t *p_map, uint32_t i_key)
+{
+    state_node_t *p_node = p_map->pp_buckets[MapHash(i_key, p_map->i_buckets)];
+    while (p_node && p_node->i_key != i_key)
+        p_node = p_node->p_next;
+    return p_node;
+}
+
+/* Find a node or add a zeroed one of i_size bytes */
+static state_node_t *MapGet(state_map_t *p_map, uint32_t i_key, size_t i_size)
+{
+    state_node_t *p_node = MapFind(p_map, i_key);
+    size_t i_bucket;
+    if (p_node)
+        return p_node;
+
+    if (p_map->i_count >= p_map->i_buckets)
+    {
+        size_t i_buckets = p_map->i_buckets * 2;
+        state_node_t **pp_buckets = calloc(i_buckets, sizeof(state_node_t *));
+        if (pp_buckets)
+        {
+            for (size_t i = 0; i < p_map->i_buckets; i++)
+            {
+                state_node_t *p_old = p_map->pp_buckets[i];
+                while (p_old)
+                {
+                    state_node_t *p_next = p_old->p_next;
+                    size_t i_new = MapHash(p_old->i_key, i_buckets);
+                    p_old->p_next = pp_buckets[i_new];
+                    pp_buckets[i_new] = p_old;
+                    p_old = p_next;
+                }
+            }
+            free(p_map->pp_buckets);
+            p_map->pp_buckets = pp_buckets;
+            p_map->i_buckets = i_buckets;
+        }
+    }
+
+    p_node = calloc(1, i_size);
+    if (!p_node)
+        return NULL;
+    p_node->i_key = i_key;
+    i_bucket = MapHash(i_key, p_map->i_buckets);
+    p_node->p_next = p_map->pp_buckets[i_bucket];
+    p_map->pp_buckets[i_bucket] = p_node;
+    p_map->i_count++;
+    return p_node;
+}
+
+#define MAP_FOREACH(p_map, p_node) \
+    for (size_t i_bucket_ = 0; i_bucket_ < (p_map)->i_buckets; i_bucket_++) \
+        for (state_node_t *p_node = (p_map)->pp_buckets[i_bucket_]; p_node; \
+             p_node = p_node->p_next)
+
+static void ServiceClean(state_node_t *p_node)
+{
+    state_service_t *p_service = (state_service_t *)p_node;
+    dvbpsi_snapshot_release(p_service->p_pmt);
+    dvbpsi_snapshot_release(p_service->p_sdt);
+}
+
+static void TransportClean(state_node_t *p_node)
+{
+    state_transport_t *p_transport = (state_transport_t *)p_node;
+    dvbpsi_snapshot_release(p_transport->p_nit);
+    dvbpsi_snapshot_release(p_transport->p_sdt);
+}
+
+static state_service_t *StateService(dvbpsi_state_t *p_state, uint16_t i_service_id)
+{
+    state_service_t *p_service =
+        (state_service_t *)MapFind(&p_state->services, i_service_id);
+    if (p_service)
+        return p_service;
+
+    p_service = (state_service_t *)MapGet(&p_state->services, i_service_id,
+                                          sizeof(state_service_t));
+    if (p_service)
+        p_service->i_pmt_pid = STATE_NO_PID;
+    return p_service;
+}
+
+/* PIDs usage
+ *
+ * A table change marks the PIDs its old and new versions reference. The
+ * usage of the marked PIDs only is then computed again from the PAT, PMTs
+ * and CAT, so that a change costs the size of the tables rather than a scan
+ * of the 8192 PIDs. */
+static bool StateMarked(const dvbpsi_state_t *p_state, uint16_t i_pid)
+{
+    return p_state->marks[i_pid >> 3] & (1 << (i_pid & 7));
+}
+
+static void StateMarkPid(dvbpsi_state_t *p_state, uint16_t i_pid)
+{
+    i_pid &= 0x1fff;
+    if (StateMarked(p_state, i_pid))
+        return;
+    p_state->marks[i_pid >> 3] |= 1 << (i_pid & 7);
+    p_state->marked[p_state->i_marked++] = i_pid;
+    memset(&p_state->new_pids[i_pid], 0, sizeof(dvbpsi_state_pid_t));
+}
+
+static void StateMarkPat(dvbpsi_state_t *p_state, const dvbpsi_snapshot_t *p_snapshot)
+{
+    const dvbpsi_pat_t *p_pat;
+    if (!p_snapshot)
+        return;
+    p_pat = p_snapshot->p_table;
+    StateMarkPid(p_state, 0x00);
+    for (const dvbpsi_pat_program_t *p_program = p_pat->p_first_program;
+         p_program; p_program = p_program->p_next)
+        StateMarkPid(p_state, p_program->i_pid);
+}
+
+static void StateMarkPmt(dvbpsi_state_t *p_state, const dvbpsi_snapshot_t *p_snapshot)
+{
+    const dvbpsi_pmt_t *p_pmt;
+    if (!p_snapshot)
+        return;
+    p_pmt = p_snapshot->p_table;
+    StateMarkPid(p_state, p_pmt->i_pcr_pid);
+    for (const dvbpsi_pmt_es_t *p_es = p_pmt->p_first_es; p_es; p_es = p_es->p_next)
+        StateMarkPid(p_state, p_es->i_pid);
+}
+
+/* EMM PID of a CA_descriptor: CA_system_ID, then the PID */
+static int CatEmmPid(const dvbpsi_descriptor_t *p_dr)
+{
+    if (p_dr->i_tag != 0x09 || p_dr->i_length < 4)
+        return -1;
+    return ((p_dr->p_data[2] & 0x1f) << 8) | p_dr->p_data[3];
+}
+
+static void StateMarkCat(dvbpsi_state_t *p_state, const dvbpsi_snapshot_t *p_snapshot)
+{
+    const dvbpsi_cat_t *p_cat;
+    if (!p_snapshot)
+        return;
+    p_cat = p_snapshot->p_table;
+    StateMarkPid(p_state, 0x01);
+    for (const dvbpsi_descriptor_t *p_dr = p_cat->p_first_descriptor; p_dr; p_dr = p_dr->p_next)
+    {
+        if (CatEmmPid(p_dr) >= 0)
+            StateMarkPid(p_state, CatEmmPid(p_dr));
+    }
+}
+
+/* Compute what the marked PIDs carry, and stamp those whose usage changed */
+static void StateUpdatePids(dvbpsi_state_t *p_state)
+{
+    dvbpsi_state_pid_t *p_new = p_state->new_pids;
+
+    if (p_state->i_marked == 0)
+        return;
+
+    if (p_state->p_pat)
+    {
+        const dvbpsi_pat_t *p_pat = p_state->p_pat->p_table;
+        if (StateMarked(p_state, 0x00))
+            p_new[0x00].i_flags |= DVBPSI_STATE_PID_PAT;
+        for (const dvbpsi_pat_program_t *p_program = p_pat->p_first_program;
+             p_program; p_program = p_program->p_next)
+        {
+            dvbpsi_state_pid_t *p_pid = &p_new[p_program->i_pid & 0x1fff];
+            if (!StateMarked(p_state, p_program->i_pid & 0x1fff))
+                continue;
+            if (p_program->i_number == 0)
+                p_pid->i_flags |= DVBPSI_STATE_PID_NIT;
+            else
+            {
+                p_pid->i_flags |= DVBPSI_STATE_PID_PMT;
+                p_pid->i_service_id = p_program->i_number;
+            }
+        }
+    }
+
+    MAP_FOREACH(&p_state->services, p_node)
+    {
+        const state_service_t *p_service = (const state_service_t *)p_node;
+        const dvbpsi_pmt_t *p_pmt;
+        dvbpsi_state_pid_t *p_pid;
+        if (!p_service->b_in_pat || !p_service->p_pmt)
+            continue;
+
+        p_pmt = p_service->p_pmt->p_table;
+        p_pid = &p_new[p_pmt->i_pcr_pid & 0x1fff];
+        if (p_pmt->i_pcr_pid != STATE_NO_PID && StateMarked(p_state, p_pmt->i_pcr_pid & 0x1fff))
+        {
+            p_pid->i_flags |= DVBPSI_STATE_PID_PCR;
+            p_pid->i_service_id = p_pmt->i_program_number;
+        }
+        for (const dvbpsi_pmt_es_t *p_es = p_pmt->p_first_es; p_es; p_es = p_es->p_next)
+        {
+            if (!StateMarked(p_state, p_es->i_pid & 0x1fff))
+                continue;
+            p_pid = &p_new[p_es->i_pid & 0x1fff];
+            p_pid->i_flags |= DVBPSI_STATE_PID_ES;
+            p_pid->i_stream_type = p_es->i_type;
+            p_pid->i_service_id = p_pmt->i_program_number;
+        }
+    }
+
+    if (p_state->p_cat)
+    {
+        const dvbpsi_cat_t *p_cat = p_state->p_cat->p_table;
+        if (StateMarked(p_state, 0x01))
+            p_new[0x01].i_flags |= DVBPSI_STATE_PID_CAT;
+        for (const dvbpsi_descriptor_t *p_dr = p_cat->p_first_descriptor;
+             p_dr; p_dr = p_dr->p_next)
+        {
+            const int i_pid = CatEmmPid(p_dr);
+            if (i_pid >= 0 && StateMarked(p_state, i_pid))
+                p_new[i_pid].i_flags |= DVBPSI_STATE_PID_EMM;
+        }
+    }
+
+    for (size_t i = 0; i < p_state->i_marked; i++)
+    {
+        const uint16_t i_pid = p_state->marked[i];
+        dvbpsi_state_pid_t *p_pid = &p_state->pids[i_pid];
+        if (p_pid->i_flags != p_new[i_pid].i_flags
+         || p_pid->i_stream_type != p_new[i_pid].i_stream_type
+         || p_pid->i_service_id != p_new[i_pid].i_service_id)
+        {
+            p_pid->i_flags = p_new[i_pid].i_flags;
+            p_pid->i_stream_type = p_new[i_pid].i_stream_type;
+            p_pid->i_service_id = p_new[i_pid].i_service_id;
+            p_pid->i_generation = p_state->i_generation;
+        }
+        p_state->marks[i_pid >> 3] = 0;
+    }
+    p_state->i_marked = 0;
+}
+
+/* Publish a table and get the snapshot back, called with the lock */
+static dvbpsi_snapshot_t *StatePublish(dvbpsi_state_t *p_state, uint64_t i_key,
+                                       uint8_t i_version, void *p_table,
+                                       dvbpsi_snapshot_free_cb pf_free)
+{
+    if (!dvbpsi_snapshot_publish(p_state->p_tables, i_key, i_version, true,
+                                 p_table, pf_free))
+        return NULL;
+    p_state->i_generation++;
+    return dvbpsi_snapshot_get(p_state->p_tables, i_key);
+}
+
+static void FreePAT(void *p_table)
+{
+    dvbpsi_pat_delete(p_table);
+}
+
+static void FreeCAT(void *p_table)
+{
+    dvbpsi_cat_delete(p_table);
+}
+
+static void FreePMT(void *p_table)
+{
+    dvbpsi_pmt_delete(p_table);
+}
+
+static void FreeSDT(void *p_table)
+{
+    dvbpsi_sdt_delete(p_table);
+}
+
+static void FreeNIT(void *p_table)
+{
+    dvbpsi_nit_delete(p_table);
+}
+
+/*****************************************************************************
+ * dvbpsi_state_new
+ *****************************************************************************/
+dvbpsi_state_t *dvbpsi_state_new(void)
+{
+    dvbpsi_state_t *p_state = calloc(1, sizeof(dvbpsi_state_t));
+    if (!p_state)
+        return NULL;
+    if (!dvbpsi_lock_init(&p_state->lock))
+    {
+        free(p_state);
+        return NULL;
+    }
+
+    p_state->p_tables = dvbpsi_snapshot_store_new();
+    if (!p_state->p_tables
+     || !MapInit(&p_state->services) || !MapInit(&p_state->transports))
+    {
+        dvbpsi_state_delete(p_state);
+        return NULL;
+    }
+    return p_state;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_delete
+ *****************************************************************************/
+void dvbpsi_state_delete(dvbpsi_state_t *p_state)
+{
+    if (!p_state)
+        return;
+
+    MapClean(&p_state->services, ServiceClean);
+    MapClean(&p_state->transports, TransportClean);
+    dvbpsi_snapshot_release(p_state->p_pat);
+    dvbpsi_snapshot_release(p_state->p_cat);
+    dvbpsi_snapshot_release(p_state->p_sdt);
+    dvbpsi_snapshot_store_delete(p_state->p_tables);
+    dvbpsi_lock_destroy(&p_state->lock);
+    free(p_state);
+}
+
+/*****************************************************************************
+ * dvbpsi_state_add_pat
+ *****************************************************************************/
+bool dvbpsi_state_add_pat(dvbpsi_state_t *p_state, dvbpsi_pat_t *p_pat)
+{
+    dvbpsi_snapshot_t *p_snapshot, *p_old;
+    uint64_t i_generation;
+
+    if (!p_pat->b_current_next)
+    {
+        dvbpsi_pat_delete(p_pat);
+        return false;
+    }
+
+    dvbpsi_lock(&p_state->lock);
+    p_old = p_state->p_pat;
+    if (p_old && p_old->i_version == p_pat->i_version
+     && ((const dvbpsi_pat_t *)p_old->p_table)->i_ts_id == p_pat->i_ts_id)
+    {
+        /* a repetition, nothing changes */
+        dvbpsi_unlock(&p_state->lock);
+        dvbpsi_pat_delete(p_pat);
+        return true;
+    }
+    if (p_old && ((const dvbpsi_pat_t *)p_old->p_table)->i_ts_id != p_pat->i_ts_id)
+        dvbpsi_snapshot_remove(p_state->p_tables, p_old->i_key);
+    p_snapshot = StatePublish(p_state, DVBPSI_SNAPSHOT_KEY(0x00, p_pat->i_ts_id, 0),
+                              p_pat->i_version, p_pat, FreePAT);
+    if (!p_snapshot)
+    {
+        dvbpsi_unlock(&p_state->lock);
+        return false;
+    }
+    p_state->p_pat = p_snapshot;
+    i_generation = p_state->i_generation;
+    StateMarkPat(p_state, p_old);
+    StateMarkPat(p_state, p_snapshot);
+
+    for (const dvbpsi_pat_program_t *p_program = p_pat->p_first_program;
+         p_program; p_program = p_program->p_next)
+    {
+        state_service_t *p_service;
+        if (p_program->i_number == 0)
+            continue;
+        p_service = StateService(p_state, p_program->i_number);
+        if (!p_service)
+            continue;
+        if (!p_service->b_in_pat || p_service->i_pmt_pid != p_program->i_pid)
+        {
+            if (!p_service->b_in_pat)
+                StateMarkPmt(p_state, p_service->p_pmt);
+            p_service->b_in_pat = true;
+            p_service->i_pmt_pid = p_program->i_pid;
+            p_service->i_generation = i_generation;
+        }
+        p_service->i_pat_generation = i_generation;
+    }
+    /* services no longer listed, their PMT goes with them */
+    MAP_FOREACH(&p_state->services, p_node)
+    {
+        state_service_t *p_service = (state_service_t *)p_node;
+        if (!p_service->b_in_pat || p_service->i_pat_generation == i_generation)
+            continue;
+        p_service->b_in_pat = false;
+        p_service->i_pmt_pid = STATE_NO_PID;
+        p_service->i_generation = i_generation;
+        if (p_service->p_pmt)
+        {
+            StateMarkPmt(p_state, p_service->p_pmt);
+            dvbpsi_snapshot_remove(p_state->p_tables, p_service->p_pmt->i_key);
+            dvbpsi_snapshot_release(p_service->p_pmt);
+            p_service->p_pmt = NULL;
+        }
+    }
+
+    StateUpdatePids(p_state);
+    dvbpsi_unlock(&p_state->lock);
+
+    dvbpsi_snapshot_release(p_old);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_add_cat
+ *****************************************************************************/
+bool dvbpsi_state_add_cat(dvbpsi_state_t *p_state, dvbpsi_cat_t *p_cat)
+{
+    dvbpsi_snapshot_t *p_snapshot, *p_old;
+
+    if (!p_cat->b_current_next)
+    {
+        dvbpsi_cat_delete(p_cat);
+        return false;
+    }
+
+    dvbpsi_lock(&p_state->lock);
+    p_old = p_state->p_cat;
+    if (p_old && p_old->i_version == p_cat->i_version)
+    {
+        /* a repetition, nothing changes */
+        dvbpsi_unlock(&p_state->lock);
+        dvbpsi_cat_delete(p_cat);
+        return true;
+    }
+    p_snapshot = StatePublish(p_state, DVBPSI_SNAPSHOT_KEY(0x01, 0, 0),
+                              p_cat->i_version, p_cat, FreeCAT);
+    if (!p_snapshot)
+    {
+        dvbpsi_unlock(&p_state->lock);
+        return false;
+    }
+    p_state->p_cat = p_snapshot;
+    StateMarkCat(p_state, p_old);
+    StateMarkCat(p_state, p_snapshot);
+    StateUpdatePids(p_state);
+    dvbpsi_unlock(&p_state->lock);
+
+    dvbpsi_snapshot_release(p_old);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_add_pmt
+ *****************************************************************************/
+bool dvbpsi_state_add_pmt(dvbpsi_state_t *p_state, dvbpsi_pmt_t *p_pmt)
+{
+    state_service_t *p_service;
+    dvbpsi_snapshot_t *p_snapshot, *p_old;
+
+    if (!p_pmt->b_current_next)
+    {
+        dvbpsi_pmt_delete(p_pmt);
+        return false;
+    }
+
+    dvbpsi_lock(&p_state->lock);
+    p_service = StateService(p_state, p_pmt->i_program_number);
+    if (!p_service)
+    {
+        dvbpsi_unlock(&p_state->lock);
+        dvbpsi_pmt_delete(p_pmt);
+        return false;
+    }
+    if (p_service->p_pmt && p_service->p_pmt->i_version == p_pmt->i_version)
+    {
+        /* a repetition, nothing changes */
+        dvbpsi_unlock(&p_state->lock);
+        dvbpsi_pmt_delete(p_pmt);
+        return true;
+    }
+    p_snapshot = StatePublish(p_state, DVBPSI_SNAPSHOT_KEY(0x02, p_pmt->i_program_number, 0),
+                              p_pmt->i_version, p_pmt, FreePMT);
+    if (!p_snapshot)
+    {
+        dvbpsi_unlock(&p_state->lock);
+        return false;
+    }
+    p_old = p_service->p_pmt;
+    p_service->p_pmt = p_snapshot;
+    p_service->i_generation = p_state->i_generation;
+    if (p_service->b_in_pat)
+    {
+        StateMarkPmt(p_state, p_old);
+        StateMarkPmt(p_state, p_snapshot);
+        StateUpdatePids(p_state);
+    }
+    dvbpsi_unlock(&p_state->lock);
+
+    dvbpsi_snapshot_release(p_old);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_add_sdt
+ *****************************************************************************/
+bool dvbpsi_state_add_sdt(dvbpsi_state_t *p_state, dvbpsi_sdt_t *p_sdt)
+{
+    state_transport_t *p_transport;
+    dvbpsi_snapshot_t *p_snapshot, *p_old, *p_old_actual = NULL;
+    uint64_t i_generation;
+
+    if (!p_sdt->b_current_next
+     || (p_sdt->i_table_id != 0x42 && p_sdt->i_table_id != 0x46))
+    {
+        dvbpsi_sdt_delete(p_sdt);
+        return false;
+    }
+
+    dvbpsi_lock(&p_state->lock);
+    p_transport = (state_transport_t *)MapGet(&p_state->transports,
+                                              (uint32_t)p_sdt->i_network_id << 16 | p_sdt->i_extension,
+                                              sizeof(state_transport_t));
+    if (!p_transport)
+    {
+        dvbpsi_unlock(&p_state->lock);
+        dvbpsi_sdt_delete(p_sdt);
+        return false;
+    }
+    p_snapshot = StatePublish(p_state,
+                              DVBPSI_SNAPSHOT_KEY(p_sdt->i_table_id, p_sdt->i_extension,
+                                                  p_sdt->i_network_id),
+                              p_sdt->i_version, p_sdt, FreeSDT);
+    if (!p_snapshot)
+    {
+        dvbpsi_unlock(&p_state->lock);
+        return false;
+    }
+    i_generation = p_state->i_generation;
+    p_old = p_transport->p_sdt;
+    p_transport->p_sdt = p_snapshot;
+    p_transport->i_generation = i_generation;
+
+    if (p_sdt->i_table_id == 0x42)
+    {
+        p_old_actual = p_state->p_sdt;
+        p_state->p_sdt = dvbpsi_snapshot_hold(p_snapshot);
+        if (p_old_actual && p_old_actual->i_key != p_snapshot->i_key)
+            dvbpsi_snapshot_remove(p_state->p_tables, p_old_actual->i_key);
+
+        for (const dvbpsi_sdt_service_t *p_entry = p_sdt->p_first_service;
+             p_entry; p_entry = p_entry->p_next)
+        {
+            state_service_t *p_service = StateService(p_state, p_entry->i_service_id);
+            if (!p_service)
+                continue;
+            dvbpsi_snapshot_release(p_service->p_sdt);
+            p_service->p_sdt = dvbpsi_snapshot_hold(p_snapshot);
+            p_service->p_sdt_service = p_entry;
+            p_service->i_generation = i_generation;
+        }
+        /* services no longer described */
+        MAP_FOREACH(&p_state->services, p_node)
+        {
+            state_service_t *p_service = (state_service_t *)p_node;
+            if (p_service->p_sdt && p_service->p_sdt != p_snapshot)
+            {
+                dvbpsi_snapshot_release(p_service->p_sdt);
+                p_service->p_sdt = NULL;
+                p_service->p_sdt_service = NULL;
+                p_service->i_generation = i_generation;
+            }
+        }
+    }
+    dvbpsi_unlock(&p_state->lock);
+
+    dvbpsi_snapshot_release(p_old);
+    dvbpsi_snapshot_release(p_old_actual);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_add_nit
+ *****************************************************************************/
+bool dvbpsi_state_add_nit(dvbpsi_state_t *p_state, dvbpsi_nit_t *p_nit)
+{
+    dvbpsi_snapshot_t *p_snapshot, *p_old;
+    uint64_t i_key, i_generation;
+
+    if (!p_nit->b_current_next
+     || (p_nit->i_table_id != 0x40 && p_nit->i_table_id != 0x41))
+    {
+        dvbpsi_nit_delete(p_nit);
+        return false;
+    }
+
+    i_key = DVBPSI_SNAPSHOT_KEY(p_nit->i_table_id, p_nit->i_network_id, 0);
+    dvbpsi_lock(&p_state->lock);
+    p_old = dvbpsi_snapshot_get(p_state->p_tables, i_key);
+    p_snapshot = StatePublish(p_state, i_key, p_nit->i_version, p_nit, FreeNIT);
+    if (!p_snapshot)
+    {
+        dvbpsi_unlock(&p_state->lock);
+        dvbpsi_snapshot_release(p_old);
+        return false;
+    }
+    i_generation = p_state->i_generation;
+
+    for (const dvbpsi_nit_ts_t *p_ts = p_nit->p_first_ts; p_ts; p_ts = p_ts->p_next)
+    {
+        state_transport_t *p_transport =
+            (state_transport_t *)MapGet(&p_state->transports,
+                                        (uint32_t)p_ts->i_orig_network_id << 16 | p_ts->i_ts_id,
+                                        sizeof(state_transport_t));
+        if (!p_transport)
+            continue;
+        dvbpsi_snapshot_release(p_transport->p_nit);
+        p_transport->p_nit = dvbpsi_snapshot_hold(p_snapshot);
+        p_transport->p_nit_ts = p_ts;
+        p_transport->i_generation = i_generation;
+    }
+    /* transport streams the previous version listed but not this one */
+    MAP_FOREACH(&p_state->transports, p_node)
+    {
+        state_transport_t *p_transport = (state_transport_t *)p_node;
+        if (p_old && p_transport->p_nit == p_old)
+        {
+            dvbpsi_snapshot_release(p_transport->p_nit);
+            p_transport->p_nit = NULL;
+            p_transport->p_nit_ts = NULL;
+            p_transport->i_generation = i_generation;
+        }
+    }
+    dvbpsi_unlock(&p_state->lock);
+
+    dvbpsi_snapshot_release(p_snapshot);
+    dvbpsi_snapshot_release(p_old);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_add_table
+ *****************************************************************************/
+bool dvbpsi_state_add_table(dvbpsi_state_t *p_state, uint64_t i_key,
+                            uint8_t i_version, bool b_current_next,
+                            void *p_table, dvbpsi_snapshot_free_cb pf_free)
+{
+    dvbpsi_snapshot_t *p_snapshot;
+
+    if (!b_current_next)
+    {
+        if (pf_free)
+            pf_free(p_table);
+        return false;
+    }
+
+    dvbpsi_lock(&p_state->lock);
+    p_snapshot = StatePublish(p_state, i_key, i_version, p_table, pf_free);
+    dvbpsi_unlock(&p_state->lock);
+
+    dvbpsi_snapshot_release(p_snapshot);
+    return p_snapshot != NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_get_service
+ *****************************************************************************/
+bool dvbpsi_state_get_service(dvbpsi_state_t *p_state, uint16_t i_service_id,
+                              dvbpsi_state_service_t *p_service)
+{
+    const state_service_t *p_entry;
+
+    dvbpsi_lock(&p_state->lock);
+    p_entry = (const state_service_t *)MapFind(&p_state->services, i_service_id);
+    if (!p_entry || (!p_entry->b_in_pat && !p_entry->p_pmt && !p_entry->p_sdt))
+    {
+        dvbpsi_unlock(&p_state->lock);
+        return false;
+    }
+    p_service->i_service_id = i_service_id;
+    p_service->i_pmt_pid = p_entry->i_pmt_pid;
+    p_service->p_pmt_snapshot = p_entry->p_pmt ? dvbpsi_snapshot_hold(p_entry->p_pmt) : NULL;
+    p_service->p_pmt = p_entry->p_pmt ? p_entry->p_pmt->p_table : NULL;
+    p_service->p_sdt_snapshot = p_entry->p_sdt ? dvbpsi_snapshot_hold(p_entry->p_sdt) : NULL;
+    p_service->p_sdt_service = p_entry->p_sdt_service;
+    p_service->i_generation = p_entry->i_generation;
+    dvbpsi_unlock(&p_state->lock);
+
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_service_release
+ *****************************************************************************/
+void dvbpsi_state_service_release(dvbpsi_state_service_t *p_service)
+{
+    dvbpsi_snapshot_release(p_service->p_pmt_snapshot);
+    dvbpsi_snapshot_release(p_service->p_sdt_snapshot);
+    p_service->p_pmt_snapshot = p_service->p_sdt_snapshot = NULL;
+    p_service->p_pmt = NULL;
+    p_service->p_sdt_service = NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_get_transport
+ *****************************************************************************/
+bool dvbpsi_state_get_transport(dvbpsi_state_t *p_state, uint16_t i_network_id,
+                                uint16_t i_ts_id, dvbpsi_state_transport_t *p_transport)
+{
+    const state_transport_t *p_entry;
+
+    dvbpsi_lock(&p_state->lock);
+    p_entry = (const state_transport_t *)MapFind(&p_state->transports,
+                                                 (uint32_t)i_network_id << 16 | i_ts_id);
+    if (!p_entry || (!p_entry->p_nit && !p_entry->p_sdt))
+    {
+        dvbpsi_unlock(&p_state->lock);
+        return false;
+    }
+    p_transport->i_network_id = i_network_id;
+    p_transport->i_ts_id = i_ts_id;
+    p_transport->p_nit_snapshot = p_entry->p_nit ? dvbpsi_snapshot_hold(p_entry->p_nit) : NULL;
+    p_transport->p_nit_ts = p_entry->p_nit_ts;
+    p_transport->p_sdt_snapshot = p_entry->p_sdt ? dvbpsi_snapshot_hold(p_entry->p_sdt) : NULL;
+    p_transport->p_sdt = p_entry->p_sdt ? p_entry->p_sdt->p_table : NULL;
+    p_transport->i_generation = p_entry->i_generation;
+    dvbpsi_unlock(&p_state->lock);
+
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_transport_release
+ *****************************************************************************/
+void dvbpsi_state_transport_release(dvbpsi_state_transport_t *p_transport)
+{
+    dvbpsi_snapshot_release(p_transport->p_nit_snapshot);
+    dvbpsi_snapshot_release(p_transport->p_sdt_snapshot);
+    p_transport->p_nit_snapshot = p_transport->p_sdt_snapshot = NULL;
+    p_transport->p_nit_ts = NULL;
+    p_transport->p_sdt = NULL;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_get_pid
+ *****************************************************************************/
+bool dvbpsi_state_get_pid(dvbpsi_state_t *p_state, uint16_t i_pid, dvbpsi_state_pid_t *p_pid)
+{
+    if (i_pid >= STATE_PIDS)
+        return false;
+
+    dvbpsi_lock(&p_state->lock);
+    *p_pid = p_state->pids[i_pid];
+    dvbpsi_unlock(&p_state->lock);
+
+    return p_pid->i_flags != 0;
+}
+
+/*****************************************************************************
+ * dvbpsi_state_get_table
+ *****************************************************************************/
+dvbpsi_snapshot_t *dvbpsi_state_get_table(dvbpsi_state_t *p_state, uint64_t i_key)
+{
+    return dvbpsi_snapshot_get(p_state->p_tables, i_key);
+}
+
+/*****************************************************************************
+ * dvbpsi_state_generation
+ *****************************************************************************/
+uint64_t dvbpsi_state_generation(dvbpsi_state_t *p_state)
+{
+    uint64_t i_generation;
+
+    dvbpsi_lock(&p_state->lock);
+    i_generation = p_state->i_generation;
+    dvbpsi_unlock(&p_state->lock);
+
+    return i_generation;
+}
@@ -0,0 +1,373 @@
+/*****************************************************************************
+ * state.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <state.h>
+ * \brief PSI/SI state of a transport stream.
+ *
+ * A state store keeps the current version of the tables decoded from a
+ * transport stream as snapshots (see snapshot.h) and indexes them, so that
+ * the usual cross-table questions are answered without scanning the tables:
+ * - the PMT PID, PMT and SDT entry of a service_id;
+ * - what a PID carries: PAT, CAT, NIT, PMT, elementary stream, PCR or EMM;
+ * - the NIT entry and SDT of an (original_network_id, transport_stream_id);
+ * - the current table of a table_id and extension.
+ *
+ * The table callbacks hand their tables over to the store:
+ *
+ * \code
+ * static void handle_PAT(void *p_data, dvbpsi_pat_t *p_pat)
+ * {
+ *     dvbpsi_state_add_pat(p_state, p_pat);
+ * }
+ * \endcode
+ *
+ * Each change increments the generation of the store and is stamped with
+ * it, so a consumer compares generations to know whether what it derived
+ * from the store is stale. The store may be read from any thread.
+ *
+ * snapshot.h must be included before this header.
+ */
+
+#ifndef _DVBPSI_STATE_H_
+#define _DVBPSI_STATE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dvbpsi_pat_s;
+struct dvbpsi_cat_s;
+struct dvbpsi_pmt_s;
+struct dvbpsi_sdt_s;
+struct dvbpsi_sdt_service_s;
+struct dvbpsi_nit_s;
+struct dvbpsi_nit_ts_s;
+
+/*****************************************************************************
+ * dvbpsi_state_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_state_s dvbpsi_state_t
+ * \brief Opaque state store handle.
+ */
+typedef struct dvbpsi_state_s dvbpsi_state_t;
+
+/*!
+ * \def DVBPSI_STATE_PID_PAT
+ * \brief The PID carries the PAT.
+ */
+#define DVBPSI_STATE_PID_PAT    0x01
+/*!
+ * \def DVBPSI_STATE_PID_CAT
+ * \brief The PID carries the CAT.
+ */
+#define DVBPSI_STATE_PID_CAT    0x02
+/*!
+ * \def DVBPSI_STATE_PID_NIT
+ * \brief The PID carries the NIT, as listed in the PAT.
+ */
+#define DVBPSI_STATE_PID_NIT    0x04
+/*!
+ * \def DVBPSI_STATE_PID_PMT
+ * \brief The PID carries a PMT.
+ */
+#define DVBPSI_STATE_PID_PMT    0x08
+/*!
+ * \def DVBPSI_STATE_PID_ES
+ * \brief The PID carries an elementary stream.
+ */
+#define DVBPSI_STATE_PID_ES     0x10
+/*!
+ * \def DVBPSI_STATE_PID_PCR
+ * \brief The PID carries a PCR.
+ */
+#define DVBPSI_STATE_PID_PCR    0x20
+/*!
+ * \def DVBPSI_STATE_PID_EMM
+ * \brief The PID carries EMMs, as listed in the CAT.
+ */
+#define DVBPSI_STATE_PID_EMM    0x40
+
+/*!
+ * \struct dvbpsi_state_pid_s
+ * \brief What a PID carries.
+ */
+/*!
+ * \typedef struct dvbpsi_state_pid_s dvbpsi_state_pid_t
+ * \brief dvbpsi_state_pid_t type definition.
+ */
+typedef struct dvbpsi_state_pid_s
+{
+    uint8_t     i_flags;        /*!< DVBPSI_STATE_PID_* flags */
+    uint8_t     i_stream_type;  /*!< stream_type of an elementary stream */
+    uint16_t    i_service_id;   /*!< service of a PMT, elementary stream or
+                                     PCR, one of them when several services
+                                     share the PID */
+    uint64_t    i_generation;   /*!< generation of the last change */
+} dvbpsi_state_pid_t;
+
+/*!
+ * \struct dvbpsi_state_service_s
+ * \brief What the store knows about a service. The tables are valid until
+ * dvbpsi_state_service_release() is called, even if they are replaced in
+ * the store meanwhile.
+ */
+/*!
+ * \typedef struct dvbpsi_state_service_s dvbpsi_state_service_t
+ * \brief dvbpsi_state_service_t type definition.
+ */
+typedef struct dvbpsi_state_service_s
+{
+    uint16_t    i_service_id;   /*!< service_id, or program_number */
+    uint16_t    i_pmt_pid;      /*!< PMT PID, 0x1fff when the service is
+                                     not in the PAT */
+    const struct dvbpsi_pmt_s *p_pmt;   /*!< PMT, NULL if not decoded */
+    const struct dvbpsi_sdt_service_s *p_sdt_service;
+                                /*!< entry in the SDT of the transport
+                                     stream, NULL if not listed */
+    uint64_t    i_generation;   /*!< generation of the last change */
+
+    /* private */
+    dvbpsi_snapshot_t *p_pmt_snapshot;
+    dvbpsi_snapshot_t *p_sdt_snapshot;
+} dvbpsi_state_service_t;
+
+/*!
+ * \struct dvbpsi_state_transport_s
+ * \brief What the store knows about a transport stream of the network. The
+ * tables are valid until dvbpsi_state_transport_release() is called.
+ */
+/*!
+ * \typedef struct dvbpsi_state_transport_s dvbpsi_state_transport_t
+ * \brief dvbpsi_state_transport_t type definition.
+ */
+typedef struct dvbpsi_state_transport_s
+{
+    uint16_t    i_network_id;   /*!< original_network_id */
+    uint16_t    i_ts_id;        /*!< transport_stream_id */
+    const struct dvbpsi_nit_ts_s *p_nit_ts;
+                                /*!< entry in a NIT, NULL if not listed */
+    const struct dvbpsi_sdt_s *p_sdt;   /*!< SDT, NULL if not decoded */
+    uint64_t    i_generation;   /*!< generation of the last change */
+
+    /* private */
+    dvbpsi_snapshot_t *p_nit_snapshot;
+    dvbpsi_snapshot_t *p_sdt_snapshot;
+} dvbpsi_state_transport_t;
+
+/*****************************************************************************
+ * dvbpsi_state_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_state_t *dvbpsi_state_new(void)
+ * \brief Create an empty state store.
+ * \return the store, NULL on error
+ */
+dvbpsi_state_t *dvbpsi_state_new(void);
+
+/*****************************************************************************
+ * dvbpsi_state_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_state_delete(dvbpsi_state_t *p_state)
+ * \brief Delete a state store and the tables no reader holds any more.
+ * \param p_state the store, may be NULL
+ * \return nothing
+ */
+void dvbpsi_state_delete(dvbpsi_state_t *p_state);
+
+/*****************************************************************************
+ * dvbpsi_state_add_*
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_state_add_pat(dvbpsi_state_t *p_state,
+                                 struct dvbpsi_pat_s *p_pat)
+ * \brief Make a PAT the current one. The store takes the ownership of the
+ * table, as for all the dvbpsi_state_add_*() functions. Tables which are
+ * not yet applicable (current_next_indicator 0) are deleted.
+ * \param p_state the store
+ * \param p_pat the PAT
+ * \return false if the table was not stored
+ */
+bool dvbpsi_state_add_pat(dvbpsi_state_t *p_state, struct dvbpsi_pat_s *p_pat);
+
+/*!
+ * \fn bool dvbpsi_state_add_cat(dvbpsi_state_t *p_state,
+                                 struct dvbpsi_cat_s *p_cat)
+ * \brief Make a CAT the current one.
+ * \param p_state the store
+ * \param p_cat the CAT
+ * \return false if the table was not stored
+ */
+bool dvbpsi_state_add_cat(dvbpsi_state_t *p_state, struct dvbpsi_cat_s *p_cat);
+
+/*!
+ * \fn bool dvbpsi_state_add_pmt(dvbpsi_state_t *p_state,
+                                 struct dvbpsi_pmt_s *p_pmt)
+ * \brief Make a PMT the current one of its program.
+ * \param p_state the store
+ * \param p_pmt the PMT
+ * \return false if the table was not stored
+ */
+bool dvbpsi_state_add_pmt(dvbpsi_state_t *p_state, struct dvbpsi_pmt_s *p_pmt);
+
+/*!
+ * \fn bool dvbpsi_state_add_sdt(dvbpsi_state_t *p_state,
+                                 struct dvbpsi_sdt_s *p_sdt)
+ * \brief Make an SDT actual (0x42) or other (0x46) the current one of its
+ * transport stream.
+ * \param p_state the store
+ * \param p_sdt the SDT
+ * \return false if the table was not stored
+ */
+bool dvbpsi_state_add_sdt(dvbpsi_state_t *p_state, struct dvbpsi_sdt_s *p_sdt);
+
+/*!
+ * \fn bool dvbpsi_state_add_nit(dvbpsi_state_t *p_state,
+                                 struct dvbpsi_nit_s *p_nit)
+ * \brief Make a NIT actual (0x40) or other (0x41) the current one of its
+ * network.
+ * \param p_state the store
+ * \param p_nit the NIT
+ * \return false if the table was not stored
+ */
+bool dvbpsi_state_add_nit(dvbpsi_state_t *p_state, struct dvbpsi_nit_s *p_nit);
+
+/*!
+ * \fn bool dvbpsi_state_add_table(dvbpsi_state_t *p_state, uint64_t i_key,
+            uint8_t i_version, bool b_current_next, void *p_table,
+            dvbpsi_snapshot_free_cb pf_free)
+ * \brief Make any other table, an EIT or a TOT for instance, the current
+ * one of its subtable. It is only indexed by its key.
+ * \param p_state the store
+ * \param i_key subtable key, see DVBPSI_SNAPSHOT_KEY()
+ * \param i_version version_number of the table
+ * \param b_current_next current_next_indicator of the table
+ * \param p_table the table
+ * \param pf_free callback freeing the table
+ * \return false if the table was not stored
+ */
+bool dvbpsi_state_add_table(dvbpsi_state_t *p_state, uint64_t i_key,
+                            uint8_t i_version, bool b_current_next,
+                            void *p_table, dvbpsi_snapshot_free_cb pf_free);
+
+/*****************************************************************************
+ * dvbpsi_state_get_service
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_state_get_service(dvbpsi_state_t *p_state,
+            uint16_t i_service_id, dvbpsi_state_service_t *p_service)
+ * \brief Look a service up.
+ * \param p_state the store
+ * \param i_service_id service_id
+ * \param p_service filled with the service, to be released with
+ * dvbpsi_state_service_release()
+ * \return false when the service is neither in the PAT, a PMT nor the SDT
+ */
+bool dvbpsi_state_get_service(dvbpsi_state_t *p_state, uint16_t i_service_id,
+                              dvbpsi_state_service_t *p_service);
+
+/*!
+ * \fn void dvbpsi_state_service_release(dvbpsi_state_service_t *p_service)
+ * \brief Release the tables of a service got with dvbpsi_state_get_service().
+ * \param p_service the service
+ * \return nothing
+ */
+void dvbpsi_state_service_release(dvbpsi_state_service_t *p_service);
+
+/*****************************************************************************
+ * dvbpsi_state_get_transport
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_state_get_transport(dvbpsi_state_t *p_state,
+            uint16_t i_network_id, uint16_t i_ts_id,
+            dvbpsi_state_transport_t *p_transport)
+ * \brief Look a transport stream up.
+ * \param p_state the store
+ * \param i_network_id original_network_id
+ * \param i_ts_id transport_stream_id
+ * \param p_transport filled with the transport stream, to be released with
+ * dvbpsi_state_transport_release()
+ * \return false when the transport stream is neither in a NIT nor an SDT
+ */
+bool dvbpsi_state_get_transport(dvbpsi_state_t *p_state, uint16_t i_network_id,
+                                uint16_t i_ts_id, dvbpsi_state_transport_t *p_transport);
+
+/*!
+ * \fn void dvbpsi_state_transport_release(dvbpsi_state_transport_t *p_transport)
+ * \brief Release the tables of a transport stream got with
+ * dvbpsi_state_get_transport().
+ * \param p_transport the transport stream
+ * \return nothing
+ */
+void dvbpsi_state_transport_release(dvbpsi_state_transport_t *p_transport);
+
+/*****************************************************************************
+ * dvbpsi_state_get_pid
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_state_get_pid(dvbpsi_state_t *p_state, uint16_t i_pid,
+                                 dvbpsi_state_pid_t *p_pid)
+ * \brief Look up what a PID carries, according to the PAT, PMTs and CAT.
+ * \param p_state the store
+ * \param i_pid the PID
+ * \param p_pid filled with the PID usage
+ * \return false when no table references the PID
+ */
+bool dvbpsi_state_get_pid(dvbpsi_state_t *p_state, uint16_t i_pid, dvbpsi_state_pid_t *p_pid);
+
+/*****************************************************************************
+ * dvbpsi_state_get_table
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_snapshot_t *dvbpsi_state_get_table(dvbpsi_state_t *p_state,
+                                               uint64_t i_key)
+ * \brief Get the current table of a subtable. The PAT is keyed by its
+ * transport_stream_id, the CAT by 0, PMTs by their program_number, SDTs by
+ * their transport_stream_id and original_network_id and NITs by their
+ * network_id, see DVBPSI_SNAPSHOT_KEY().
+ * \param p_state the store
+ * \param i_key subtable key
+ * \return the table snapshot, to be released with dvbpsi_snapshot_release(),
+ * or NULL
+ */
+dvbpsi_snapshot_t *dvbpsi_state_get_table(dvbpsi_state_t *p_state, uint64_t i_key);
+
+/*****************************************************************************
+ * dvbpsi_state_generation
+ *****************************************************************************/
+/*!
+ * \fn uint64_t dvbpsi_state_generation(dvbpsi_state_t *p_state)
+ * \brief Get the generation of a store, incremented by each table added.
+ * \param p_state the store
+ * \return the generation
+ */
+uint64_t dvbpsi_state_generation(dvbpsi_state_t *p_state);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of state.h"
+#endif
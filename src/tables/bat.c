@@ -47,6 +47,8 @@
 #include "../psi.h"
 #include "../descriptor.h"
 #include "../demux.h"
+#include "../sections_cache_private.h"
+#include "../bitstream_private.h"
 #include "bat.h"
 #include "bat_private.h"
 
@@ -467,59 +469,57 @@ void dvbpsi_bat_sections_gather(dvbpsi_t *p_dvbpsi,
 void dvbpsi_bat_sections_decode(dvbpsi_bat_t* p_bat,
                               dvbpsi_psi_section_t* p_section)
 {
-    uint8_t* p_byte, * p_end;
-
-    while(p_section)
+    while (p_section)
     {
-        /* - first loop descriptors */
-        p_byte = p_section->p_payload_start + 2;
-        p_end = p_byte + (((uint16_t)(p_section->p_payload_start[0] & 0x0f) << 8)
-                          | p_section->p_payload_start[1]);
-        if (p_end > p_section->p_payload_end)
-            p_end = p_section->p_payload_end;
+        dvbpsi_reader_t reader, loop, descriptors;
 
-        while(p_byte + 2 <= p_end)
+        dvbpsi_reader_init(&reader, p_section->p_payload_start,
+                           p_section->p_payload_end);
+
+        /* - first loop descriptors */
+        if (!dvbpsi_reader_need(&reader, 2))
+            goto next_section;
+        dvbpsi_reader_sub(&reader, &descriptors, dvbpsi_read16(&reader) & 0x0fff);
+        while (dvbpsi_reader_next(&descriptors, 2))
         {
-            uint8_t i_tag = p_byte[0];
-            uint8_t i_length = p_byte[1];
-            if (i_length + 2 <= p_end - p_byte)
-                dvbpsi_bat_bouquet_descriptor_add(p_bat, i_tag, i_length, p_byte + 2);
-            p_byte += 2 + i_length;
+            uint8_t i_tag = dvbpsi_read8(&descriptors);
+            uint8_t i_length = dvbpsi_read8(&descriptors);
+            if (!dvbpsi_reader_need(&descriptors, i_length))
+                break;
+            uint8_t *p_data = dvbpsi_reader_at(&descriptors, p_section->p_data);
+            dvbpsi_bat_bouquet_descriptor_add(p_bat, i_tag, i_length, p_data);
+            dvbpsi_reader_skip(&descriptors, i_length);
         }
 
-        p_end = 2 + p_byte + (((uint16_t)(p_byte[0] & 0x0f) << 8) | p_byte[1]);
-        if (p_end > p_section->p_payload_end)
-            p_end = p_section->p_payload_end;
+        if (!dvbpsi_reader_need(&reader, 2))
+            goto next_section;
+        dvbpsi_reader_sub(&reader, &loop, dvbpsi_read16(&reader) & 0x0fff);
 
         /* - TSs */
-        p_byte += 2;
-        while(p_byte + 6 <= p_end)
+        while (dvbpsi_reader_next(&loop, 6))
         {
-            uint8_t *p_end2;
-            uint16_t i_ts_id = ((uint16_t)p_byte[0] << 8) | p_byte[1];
-            uint16_t i_orig_network_id = ((uint16_t)p_byte[2] << 8) | p_byte[3];
-            uint16_t i_transport_descriptors_length = ((uint16_t)(p_byte[4] & 0x0f) << 8) | p_byte[5];
+            uint16_t i_ts_id = dvbpsi_read16(&loop);
+            uint16_t i_orig_network_id = dvbpsi_read16(&loop);
+            uint16_t i_transport_descriptors_length = dvbpsi_read16(&loop) & 0x0fff;
 
             dvbpsi_bat_ts_t* p_ts = dvbpsi_bat_ts_add(p_bat, i_ts_id, i_orig_network_id);
             if (!p_ts)
                 break;
 
             /* - TS descriptors */
-            p_byte += 6;
-            p_end2 = p_byte + i_transport_descriptors_length;
-            if (p_end2 > p_section->p_payload_end)
-                p_end2 = p_section->p_payload_end;
-
-            while (p_byte + 2 <= p_end2)
+            dvbpsi_reader_sub(&loop, &descriptors, i_transport_descriptors_length);
+            while (dvbpsi_reader_next(&descriptors, 2))
             {
-                uint8_t i_tag = p_byte[0];
-                uint8_t i_length = p_byte[1];
-                if (i_length + 2 <= p_end2 - p_byte)
-                    dvbpsi_bat_ts_descriptor_add(p_ts, i_tag, i_length, p_byte + 2);
-                p_byte += 2 + i_length;
+                uint8_t i_tag = dvbpsi_read8(&descriptors);
+                uint8_t i_length = dvbpsi_read8(&descriptors);
+                if (!dvbpsi_reader_need(&descriptors, i_length))
+                    break;
+                uint8_t *p_data = dvbpsi_reader_at(&descriptors, p_section->p_data);
+                dvbpsi_bat_ts_descriptor_add(p_ts, i_tag, i_length, p_data);
+                dvbpsi_reader_skip(&descriptors, i_length);
             }
         }
-
+    next_section:
         p_section = p_section->p_next;
     }
 }
@@ -567,8 +567,7 @@ dvbpsi_psi_section_t* dvbpsi_bat_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ba
         {
             /* bouquet_descriptors_length */
             i_bouquet_descriptors_length = (p_current->p_payload_end - p_current->p_payload_start) - 2;
-            p_current->p_data[8] = (i_bouquet_descriptors_length >> 8) | 0xf0;
-            p_current->p_data[9] = i_bouquet_descriptors_length;
+            dvbpsi_set16(p_current->p_data + 8, 0xf000 | i_bouquet_descriptors_length);
 
             /* transport_stream_loop_length */
             p_current->p_payload_end[0] = 0;
@@ -612,8 +611,7 @@ dvbpsi_psi_section_t* dvbpsi_bat_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ba
 
     /* bouquet_descriptors_length */
     i_bouquet_descriptors_length = (p_current->p_payload_end - p_current->p_payload_start) - 2;
-    p_current->p_data[8] = (i_bouquet_descriptors_length >> 8) | 0xf0;
-    p_current->p_data[9] = i_bouquet_descriptors_length;
+    dvbpsi_set16(p_current->p_data + 8, 0xf000 | i_bouquet_descriptors_length);
 
     /* Store the position of the transport_stream_loop_length field
        and reserve two bytes for it */
@@ -628,24 +626,21 @@ dvbpsi_psi_section_t* dvbpsi_bat_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ba
 
         /* Can the current section carry all the descriptors ? */
         p_descriptor = p_ts->p_first_descriptor;
-        while(    (p_descriptor != NULL)
-               && ((p_ts_start - p_current->p_data) + i_transport_descriptors_length <= 1020))
+        while(p_descriptor != NULL)
         {
             i_transport_descriptors_length += p_descriptor->i_length + 2;
             p_descriptor = p_descriptor->p_next;
         }
 
         /* If _no_ and the current section isn't empty and an empty section
-           may carry one more descriptor
-           then create a new section */
-        if(    (p_descriptor != NULL)
+           may carry all of them then create a new section */
+        if(    ((p_ts_start - p_current->p_data) + i_transport_descriptors_length > 1020)
             && (p_ts_start - p_current->p_data != 12)
             && (i_transport_descriptors_length <= 1008))
         {
             /* transport_stream_loop_length */
             i_transport_stream_loop_length = (p_current->p_payload_end - p_transport_stream_loop_length) - 2;
-            p_transport_stream_loop_length[0] = (i_transport_stream_loop_length >> 8) | 0xf0;
-            p_transport_stream_loop_length[1] = i_transport_stream_loop_length;
+            dvbpsi_set16(p_transport_stream_loop_length, 0xf000 | i_transport_stream_loop_length);
 
             /* will put more descriptors in an empty section */
             dvbpsi_debug(p_dvbpsi, "BAT generator",
@@ -679,10 +674,8 @@ dvbpsi_psi_section_t* dvbpsi_bat_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ba
         }
 
         /* p_ts_start is where the TS begins */
-        p_ts_start[0] = p_ts->i_ts_id >> 8;
-        p_ts_start[1] = p_ts->i_ts_id & 0xff;
-        p_ts_start[2] = p_ts->i_orig_network_id >> 8;
-        p_ts_start[3] = p_ts->i_orig_network_id & 0xff;
+        dvbpsi_set16(p_ts_start, p_ts->i_ts_id);
+        dvbpsi_set16(p_ts_start + 2, p_ts->i_orig_network_id);
 
         /* Increase the length by 6 */
         p_current->p_payload_end += 6;
@@ -713,16 +706,14 @@ dvbpsi_psi_section_t* dvbpsi_bat_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ba
 
         /* transport_descriptors_length */
         i_transport_descriptors_length = p_current->p_payload_end - p_ts_start - 5;
-        p_ts_start[4] = (i_transport_descriptors_length >> 8) | 0xf0;
-        p_ts_start[5] = i_transport_descriptors_length;
+        dvbpsi_set16(p_ts_start + 4, 0xf000 | i_transport_descriptors_length);
 
         p_ts = p_ts->p_next;
     }
 
     /* transport_stream_loop_length */
     i_transport_stream_loop_length = (p_current->p_payload_end - p_transport_stream_loop_length) - 2;
-    p_transport_stream_loop_length[0] = (i_transport_stream_loop_length >> 8) | 0xf0;
-    p_transport_stream_loop_length[1] = i_transport_stream_loop_length;
+    dvbpsi_set16(p_transport_stream_loop_length, 0xf000 | i_transport_stream_loop_length);
 
     /* Finalization */
     p_prev = p_result;
@@ -740,3 +731,65 @@ error:
     dvbpsi_DeletePSISections(p_prev);
     return NULL;
 }
+
+/*****************************************************************************
+ * Incremental generation
+ *****************************************************************************/
+static const void *BATTSNext(const void *p_entry)
+{
+    return ((const dvbpsi_bat_ts_t *)p_entry)->p_next;
+}
+
+static uint32_t BATTSKey(const void *p_entry)
+{
+    const dvbpsi_bat_ts_t *p_ts = p_entry;
+    return ((uint32_t)p_ts->i_ts_id << 16) | p_ts->i_orig_network_id;
+}
+
+static const dvbpsi_descriptor_t *BATTSDescriptors(const void *p_entry)
+{
+    return ((const dvbpsi_bat_ts_t *)p_entry)->p_first_descriptor;
+}
+
+static void BATTSHeader(const void *p_entry, uint8_t *p, uint16_t i_length)
+{
+    const dvbpsi_bat_ts_t *p_ts = p_entry;
+
+    dvbpsi_set16(p, p_ts->i_ts_id);
+    dvbpsi_set16(p + 2, p_ts->i_orig_network_id);
+    dvbpsi_set16(p + 4, 0xf000 | i_length);
+}
+
+/*****************************************************************************
+ * dvbpsi_bat_sections_update
+ *****************************************************************************
+ * Generate BAT sections, only encoding again the ones that changed.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_bat_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_sections_cache_t *p_cache,
+                                                 dvbpsi_bat_t *p_bat)
+{
+    dvbpsi_sections_layout_t layout =
+    {
+        .i_table_id = 0x4a,
+        .b_private_indicator = false,
+        .i_extension = p_bat->i_extension,
+        .i_version = p_bat->i_version,
+        .b_current_next = p_bat->b_current_next,
+        .i_max_size = 1024,
+        .b_loops = true,
+        .p_first_loop = p_bat->p_first_descriptor,
+        .p_first_entry = p_bat->p_first_ts,
+        .i_entry_header = 6,
+        .pf_next = BATTSNext,
+        .pf_key = BATTSKey,
+        .pf_descriptors = BATTSDescriptors,
+        .pf_entry_header = BATTSHeader,
+    };
+    dvbpsi_psi_section_t *p_sections;
+
+    p_sections = dvbpsi_sections_cache_update(p_dvbpsi, p_cache, &layout);
+    if (p_sections)
+        p_bat->i_version = dvbpsi_sections_cache_version(p_cache);
+    return p_sections;
+}
@@ -260,6 +260,30 @@ dvbpsi_descriptor_t *dvbpsi_bat_ts_descriptor_add(dvbpsi_bat_ts_t *p_bat,
  *****************************************************************************/
 dvbpsi_psi_section_t *dvbpsi_bat_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_bat_t * p_bat);
 
+/*****************************************************************************
+ * dvbpsi_bat_sections_update
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_t *dvbpsi_bat_sections_update(dvbpsi_t *p_dvbpsi,
+            dvbpsi_sections_cache_t *p_cache, dvbpsi_bat_t *p_bat)
+ * \brief Incremental BAT generator.
+ *
+ * Same as dvbpsi_bat_sections_generate() but only the sections carrying
+ * transport streams that changed since the previous call with the same
+ * cache are encoded again. Transport streams are matched on their
+ * transport_stream_id and original_network_id. The bouquet descriptors must fit in the
+ * first section. The version handling is the one of
+ * dvbpsi_eit_sections_update().
+ * \param p_dvbpsi dvbpsi handle
+ * \param p_cache cache of this sub-table, see dvbpsi_sections_cache_new()
+ * \param p_bat BAT structure
+ * \return the sections, which belong to the cache and remain valid until
+ * the next call or the deletion of the cache. NULL on error.
+ */
+dvbpsi_psi_section_t *dvbpsi_bat_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_sections_cache_t *p_cache,
+                                                 dvbpsi_bat_t *p_bat);
+
 #ifdef __cplusplus
 };
 #endif
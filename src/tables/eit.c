@@ -41,11 +41,18 @@
 
 #include <assert.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 #include "../dvbpsi.h"
 #include "../dvbpsi_private.h"
 #include "../psi.h"
 #include "../descriptor.h"
 #include "../demux.h"
+#include "../sections_cache_private.h"
+#include "../bitstream_private.h"
+#include "../dvbtime.h"
 #include "eit.h"
 #include "eit_private.h"
 
@@ -224,6 +231,10 @@ dvbpsi_eit_event_t* dvbpsi_eit_event_add(dvbpsi_eit_t* p_eit,
     p_event->b_free_ca = b_free_ca;
     p_event->b_nvod = ( (i_start_time & 0xFFFFF000) == 0xFFFFF000
 		    && i_running_status == 0x0 );
+    p_event->i_start = p_event->b_nvod ? DVBPSI_TIME_UNDEFINED
+                                       : dvbpsi_mjd_to_unix(i_start_time);
+    p_event->i_end = p_event->i_start == DVBPSI_TIME_UNDEFINED ? DVBPSI_TIME_UNDEFINED
+                   : p_event->i_start + dvbpsi_bcd_to_seconds(i_duration);
     p_event->p_next = NULL;
     p_event->i_descriptors_length = i_event_descriptor_length;
     p_event->p_first_descriptor = NULL;
@@ -517,29 +528,23 @@ void dvbpsi_eit_sections_decode(dvbpsi_t *p_dvbpsi,
                                 dvbpsi_eit_t* p_eit,
                                 dvbpsi_psi_section_t* p_section)
 {
-    uint8_t* p_byte, *p_end;
-
     while (p_section)
     {
+        dvbpsi_reader_t reader, descriptors;
+
         /* EIT Event Descriptions */
-        p_byte = p_section->p_payload_start + 6;
-        p_end  = p_section->p_payload_end;
+        dvbpsi_reader_init(&reader, p_section->p_payload_start + 6,
+                           p_section->p_payload_end);
 
-        while (p_byte < p_end)
+        while (dvbpsi_reader_next(&reader, 12))
         {
-            uint16_t i_event_id = ((uint16_t)(p_byte[0]) << 8) | p_byte[1];
-            uint64_t i_start_time = ((uint64_t)(p_byte[2]) << 32) |
-                                    ((uint64_t)(p_byte[3]) << 24) |
-                                    ((uint64_t)(p_byte[4]) << 16) |
-                                    ((uint64_t)(p_byte[5]) << 8)  |
-                                    ((uint64_t)(p_byte[6]));
-            uint32_t i_duration = ((uint32_t)(p_byte[7]) << 16) |
-                                  ((uint32_t)(p_byte[8]) << 8)  |
-                                              p_byte[9];
-            uint8_t i_running_status = (uint8_t)(p_byte[10]) >> 5;
-            bool b_free_ca = ((p_byte[10] & 0x10) == 0x10) ? true : false;
-            uint16_t i_ev_length = ((uint16_t)(p_byte[10] & 0xf) << 8) |
-                                               p_byte[11];
+            uint16_t i_event_id = dvbpsi_read16(&reader);
+            uint64_t i_start_time = dvbpsi_read40(&reader);
+            uint32_t i_duration = dvbpsi_read24(&reader);
+            uint16_t i_flags = dvbpsi_read16(&reader);
+            uint8_t i_running_status = i_flags >> 13;
+            bool b_free_ca = (i_flags & 0x1000) ? true : false;
+            uint16_t i_ev_length = i_flags & 0x0fff;
             dvbpsi_eit_event_t *p_event = dvbpsi_eit_event_add(p_eit,
                                                 i_event_id, i_start_time, i_duration,
                                                 i_running_status, b_free_ca, i_ev_length);
@@ -547,25 +552,21 @@ void dvbpsi_eit_sections_decode(dvbpsi_t *p_dvbpsi,
                 break;
 
             /* Event Descriptors */
-            p_byte += 12;
-            uint8_t *p_ev_end = p_byte + i_ev_length;
-            if (p_ev_end > p_section->p_payload_end)
-                p_ev_end = p_section->p_payload_end;
-            while (p_byte < p_ev_end)
+            dvbpsi_reader_sub(&reader, &descriptors, i_ev_length);
+            while (dvbpsi_reader_next(&descriptors, 2))
             {
-                uint8_t i_tag = p_byte[0];
-                uint8_t i_length = p_byte[1];
-                if (i_length + 2 <= p_ev_end - p_byte)
-                    dvbpsi_eit_event_descriptor_add(p_event, i_tag, i_length, p_byte + 2);
-                else
+                uint8_t i_tag = dvbpsi_read8(&descriptors);
+                uint8_t i_length = dvbpsi_read8(&descriptors);
+                if (!dvbpsi_reader_need(&descriptors, i_length))
                 {
                     dvbpsi_error(p_dvbpsi, "EIT decoder", "failed decoding "
                         "section %d : descriptor size exceeds event size",
                         p_section->i_number);
                     goto next_section;
                 }
-
-                p_byte += 2 + i_length;
+                uint8_t *p_data = dvbpsi_reader_at(&descriptors, p_section->p_data);
+                dvbpsi_eit_event_descriptor_add(p_event, i_tag, i_length, p_data);
+                dvbpsi_reader_skip(&descriptors, i_length);
             }
         }
     next_section:
@@ -598,12 +599,10 @@ static dvbpsi_psi_section_t* NewEITSection(dvbpsi_eit_t* p_eit, int i_table_id,
   p_result->p_payload_start = p_result->p_data + 8;
 
   /* Transport Stream ID */
-  p_result->p_data[8] = p_eit->i_ts_id >> 8;
-  p_result->p_data[9] = p_eit->i_ts_id;
+  dvbpsi_set16(p_result->p_data + 8, p_eit->i_ts_id);
 
   /* Original Network ID */
-  p_result->p_data[10] = p_eit->i_network_id >> 8;
-  p_result->p_data[11] = p_eit->i_network_id;
+  dvbpsi_set16(p_result->p_data + 10, p_eit->i_network_id);
 
   /* Segment last section number will be filled once we know how many
    * sections we are going to need. */
@@ -619,23 +618,16 @@ static dvbpsi_psi_section_t* NewEITSection(dvbpsi_eit_t* p_eit, int i_table_id,
  *****************************************************************************
  * Helper function which encodes an EIT event header in a byte buffer.
  *****************************************************************************/
-static inline void EncodeEventHeaders(dvbpsi_eit_event_t *p_event, uint8_t *buf)
+static inline void EncodeEventHeaders(const dvbpsi_eit_event_t *p_event, uint8_t *buf)
 {
   /* event_id */
-  buf[0] = p_event->i_event_id >> 8;
-  buf[1] = p_event->i_event_id;
+  dvbpsi_set16(buf, p_event->i_event_id);
 
   /* start_time */
-  buf[2] = p_event->i_start_time >> 32;
-  buf[3] = p_event->i_start_time >> 24;
-  buf[4] = p_event->i_start_time >> 16;
-  buf[5] = p_event->i_start_time >>  8;
-  buf[6] = p_event->i_start_time;
+  dvbpsi_set40(buf + 2, p_event->i_start_time);
 
   /* duration */
-  buf[7] = p_event->i_duration >> 16;
-  buf[8] = p_event->i_duration >>  8;
-  buf[9] = p_event->i_duration;
+  dvbpsi_set24(buf + 7, p_event->i_duration);
 
   /* running_status, free_CA_mode */
   buf[10] = ((p_event->i_running_status & 0x7) << 5) |
@@ -717,8 +709,7 @@ dvbpsi_psi_section_t* dvbpsi_eit_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ei
 
     /* now adjust the descriptors_loop_length */
     i_event_length = p_current->p_payload_end - p_event_start - 12;
-    p_event_start[10] |= ((i_event_length  >> 8) & 0x0f);
-    p_event_start[11] = i_event_length;
+    dvbpsi_set16(p_event_start + 10, p_event_start[10] << 8 | (i_event_length & 0x0fff));
   }
 
   /* Finalization */
@@ -733,3 +724,516 @@ dvbpsi_psi_section_t* dvbpsi_eit_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_ei
 
   return p_result;
 }
+
+/*****************************************************************************
+ * Incremental generation
+ *****************************************************************************/
+static void EITFixed(const void *p_table, uint8_t *p, uint8_t i_last_number)
+{
+  const dvbpsi_eit_t *p_eit = p_table;
+
+  dvbpsi_set16(p, p_eit->i_ts_id);
+  dvbpsi_set16(p + 2, p_eit->i_network_id);
+  p[4] = i_last_number;             /* segment_last_section_number */
+  p[5] = p_eit->i_last_table_id;
+}
+
+static const void *EITEventNext(const void *p_entry)
+{
+  return ((const dvbpsi_eit_event_t *)p_entry)->p_next;
+}
+
+static uint32_t EITEventKey(const void *p_entry)
+{
+  return ((const dvbpsi_eit_event_t *)p_entry)->i_event_id;
+}
+
+static const dvbpsi_descriptor_t *EITEventDescriptors(const void *p_entry)
+{
+  return ((const dvbpsi_eit_event_t *)p_entry)->p_first_descriptor;
+}
+
+static void EITEventHeader(const void *p_entry, uint8_t *p, uint16_t i_length)
+{
+  EncodeEventHeaders(p_entry, p);
+  dvbpsi_set16(p + 10, p[10] << 8 | (i_length & 0x0fff));
+}
+
+/*****************************************************************************
+ * dvbpsi_eit_sections_update
+ *****************************************************************************
+ * Generate EIT sections, only encoding again the ones that changed.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_eit_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_sections_cache_t *p_cache,
+                                                 dvbpsi_eit_t *p_eit, uint8_t i_table_id)
+{
+  dvbpsi_sections_layout_t layout =
+  {
+    .i_table_id = i_table_id,
+    .b_private_indicator = true,
+    .i_extension = p_eit->i_extension,
+    .i_version = p_eit->i_version,
+    .b_current_next = p_eit->b_current_next,
+    .i_max_size = 4094,
+    .p_table = p_eit,
+    .i_fixed = 6,
+    .pf_fixed = EITFixed,
+    .p_first_entry = p_eit->p_first_event,
+    .i_entry_header = 12,
+    .pf_next = EITEventNext,
+    .pf_key = EITEventKey,
+    .pf_descriptors = EITEventDescriptors,
+    .pf_entry_header = EITEventHeader,
+  };
+  dvbpsi_psi_section_t *p_sections;
+
+  p_sections = dvbpsi_sections_cache_update(p_dvbpsi, p_cache, &layout);
+  if (p_sections)
+    p_eit->i_version = dvbpsi_sections_cache_version(p_cache);
+  return p_sections;
+}
+
+/*****************************************************************************
+ * Schedule generation
+ *****************************************************************************
+ * EN 300 468 5.1.5: the events of a service are spread over up to 16 EIT
+ * schedule sub-tables of 4 days each. A sub-table is divided in 32 segments
+ * of 3 hours, segment n carrying sections 8n to 8n + 7 with the events
+ * starting in its 3 hours.
+ *****************************************************************************/
+#define EIT_SCHEDULE_SEGMENT    (3 * 3600)
+#define EIT_SCHEDULE_SEGMENTS   32
+#define EIT_SCHEDULE_TABLES     16
+#define EIT_SCHEDULE_SIZE       4096      /* maximum EIT section size */
+
+typedef struct
+{
+  uint32_t                    i_seconds;  /* start time from i_mjd midnight */
+  uint32_t                    i_index;    /* position in the EIT */
+  const dvbpsi_eit_event_t   *p_event;
+} eit_schedule_event_t;
+
+typedef struct
+{
+  dvbpsi_t                   *p_dvbpsi;
+  const dvbpsi_eit_t         *p_eit;
+  uint8_t                     i_table_id;
+
+  uint8_t                     p_buf[EIT_SCHEDULE_SIZE];
+  size_t                      i_size;     /* bytes of the current section */
+  uint8_t                     i_number;   /* number of the current section */
+
+  dvbpsi_psi_section_t       *p_first;
+  dvbpsi_psi_section_t      **pp_last;
+  bool                        b_error;
+} eit_schedule_writer_t;
+
+static inline unsigned int BCDToInt(uint8_t i_bcd)
+{
+  return (i_bcd >> 4) * 10 + (i_bcd & 0x0f);
+}
+
+/* Returns false when the start time is undefined or before i_mjd */
+static bool EITScheduleSeconds(uint64_t i_start_time, uint16_t i_mjd,
+                               uint32_t *pi_seconds)
+{
+  uint16_t i_event_mjd = i_start_time >> 24;
+
+  if (i_start_time == UINT64_C(0xffffffffff) || i_event_mjd < i_mjd)
+    return false;
+
+  *pi_seconds = (uint32_t)(i_event_mjd - i_mjd) * 86400
+              + BCDToInt(i_start_time >> 16) * 3600
+              + BCDToInt(i_start_time >> 8) * 60
+              + BCDToInt(i_start_time);
+  return true;
+}
+
+static int EITScheduleCompare(const void *p_a, const void *p_b)
+{
+  const eit_schedule_event_t *a = p_a, *b = p_b;
+
+  if (a->i_seconds != b->i_seconds)
+    return a->i_seconds < b->i_seconds ? -1 : 1;
+  return a->i_index < b->i_index ? -1 : a->i_index > b->i_index;
+}
+
+/* Start an empty section in the scratch buffer */
+static void EITScheduleOpen(eit_schedule_writer_t *p_writer, uint8_t i_number)
+{
+  const dvbpsi_eit_t *p_eit = p_writer->p_eit;
+  uint8_t *p = p_writer->p_buf;
+
+  p[8] = p_eit->i_ts_id >> 8;
+  p[9] = p_eit->i_ts_id;
+  p[10] = p_eit->i_network_id >> 8;
+  p[11] = p_eit->i_network_id;
+  /* segment_last_section_number and last_table_id are patched later */
+  p_writer->i_size = 14;
+  p_writer->i_number = i_number;
+}
+
+/* Copy the first i_size bytes of the scratch buffer to a new section */
+static bool EITScheduleClose(eit_schedule_writer_t *p_writer, size_t i_size)
+{
+  const dvbpsi_eit_t *p_eit = p_writer->p_eit;
+  dvbpsi_psi_section_t *p_section = dvbpsi_NewPSISection(i_size + 4);
+
+  if (!p_section)
+  {
+    dvbpsi_error(p_writer->p_dvbpsi, "EIT generator", "out of memory");
+    p_writer->b_error = true;
+    return false;
+  }
+
+  memcpy(p_section->p_data, p_writer->p_buf, i_size);
+  p_section->p_data[0] = p_writer->i_table_id;
+  p_section->p_data[1] = 0xf0 | ((i_size + 1) >> 8);
+  p_section->p_data[2] = i_size + 1;
+  p_section->p_data[3] = p_eit->i_extension >> 8;
+  p_section->p_data[4] = p_eit->i_extension;
+  p_section->p_data[5] = 0xc0 | ((p_eit->i_version & 0x1f) << 1)
+                              | (p_eit->b_current_next ? 0x01 : 0x00);
+  p_section->p_data[6] = p_writer->i_number;
+  /* last_section_number is patched later */
+
+  p_section->i_table_id = p_writer->i_table_id;
+  p_section->b_syntax_indicator = true;
+  p_section->b_private_indicator = true;
+  p_section->i_length = i_size + 4 - 3;
+  p_section->i_extension = p_eit->i_extension;
+  p_section->i_version = p_eit->i_version;
+  p_section->b_current_next = p_eit->b_current_next;
+  p_section->i_number = p_writer->i_number;
+  p_section->p_payload_start = p_section->p_data + 8;
+  p_section->p_payload_end = p_section->p_data + i_size;
+
+  *p_writer->pp_last = p_section;
+  p_writer->pp_last = &p_section->p_next;
+  return true;
+}
+
+/* Encode the events of one segment in sections i_first to i_first + 7, an
+ * empty segment is carried by one section without events. */
+static bool EITScheduleSegment(eit_schedule_writer_t *p_writer, uint8_t i_first,
+                               const eit_schedule_event_t *p_events, size_t i_events)
+{
+  uint8_t *p_buf = p_writer->p_buf;
+  dvbpsi_psi_section_t **pp_segment = p_writer->pp_last;
+  size_t i;
+
+  EITScheduleOpen(p_writer, i_first);
+
+  for (i = 0; i < i_events; i++)
+  {
+    const dvbpsi_eit_event_t *p_event = p_events[i].p_event;
+    const dvbpsi_descriptor_t *p_descriptor;
+    size_t i_event = p_writer->i_size;
+    size_t i_length;
+
+    if (i_event + 12 > EIT_SCHEDULE_SIZE - 4)
+    {
+      if (p_writer->i_number == i_first + 7)
+        break;
+      if (!EITScheduleClose(p_writer, i_event))
+        return false;
+      EITScheduleOpen(p_writer, p_writer->i_number + 1);
+      i_event = p_writer->i_size;
+    }
+
+    EncodeEventHeaders(p_event, p_buf + i_event);
+    p_writer->i_size += 12;
+
+    for (p_descriptor = p_event->p_first_descriptor; p_descriptor;
+         p_descriptor = p_descriptor->p_next)
+    {
+      size_t i_descriptor = 2 + p_descriptor->i_length;
+
+      if (p_writer->i_size + i_descriptor > EIT_SCHEDULE_SIZE - 4)
+      {
+        size_t i_moved = p_writer->i_size - i_event;
+
+        if (i_event == 14 || p_writer->i_number == i_first + 7)
+          break;
+
+        /* move the event to a new section */
+        if (!EITScheduleClose(p_writer, i_event))
+          return false;
+        EITScheduleOpen(p_writer, p_writer->i_number + 1);
+        memmove(p_buf + 14, p_buf + i_event, i_moved);
+        i_event = 14;
+        p_writer->i_size = 14 + i_moved;
+      }
+
+      p_buf[p_writer->i_size] = p_descriptor->i_tag;
+      p_buf[p_writer->i_size + 1] = p_descriptor->i_length;
+      memcpy(p_buf + p_writer->i_size + 2, p_descriptor->p_data,
+             p_descriptor->i_length);
+      p_writer->i_size += i_descriptor;
+    }
+
+    if (p_descriptor)
+    {
+      if (i_event == 14)
+      {
+        dvbpsi_error(p_writer->p_dvbpsi, "EIT generator", "too many descriptors in "
+                     "event %u, unable to carry all the descriptors",
+                     p_event->i_event_id);
+      }
+      else
+      {
+        /* the eight sections of the segment are full */
+        p_writer->i_size = i_event;
+        break;
+      }
+    }
+
+    i_length = p_writer->i_size - i_event - 12;
+    p_buf[i_event + 10] |= (i_length >> 8) & 0x0f;
+    p_buf[i_event + 11] = i_length;
+  }
+
+  if (i < i_events)
+    dvbpsi_error(p_writer->p_dvbpsi, "EIT generator", "segment %u of table 0x%02x "
+                 "overflows its 8 sections, %zu events dropped", i_first / 8,
+                 p_writer->i_table_id, i_events - i);
+
+  if (!EITScheduleClose(p_writer, p_writer->i_size))
+    return false;
+
+  /* segment_last_section_number */
+  for (; *pp_segment; pp_segment = &(*pp_segment)->p_next)
+    (*pp_segment)->p_data[12] = p_writer->i_number;
+
+  return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_eit_schedule_generate
+ *****************************************************************************
+ * Generate the EIT schedule sub-tables of a service, with the events placed
+ * in their segment.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_eit_schedule_generate(dvbpsi_t *p_dvbpsi,
+                                                   const dvbpsi_eit_t *p_eit,
+                                                   uint8_t i_table_id, uint16_t i_mjd)
+{
+  eit_schedule_writer_t *p_writer;
+  eit_schedule_event_t *p_events = NULL;
+  const dvbpsi_eit_event_t *p_event;
+  dvbpsi_psi_section_t *p_result;
+  size_t i_events = 0, i_count = 0, i_next = 0, i_late = 0;
+  bool b_sorted = true;
+  unsigned int i_last_table = 0, i_last_segment = 0, t;
+
+  if (i_table_id != 0x50 && i_table_id != 0x60)
+  {
+    dvbpsi_error(p_dvbpsi, "EIT generator", "invalid schedule table_id 0x%02x",
+                 i_table_id);
+    return NULL;
+  }
+
+  for (p_event = p_eit->p_first_event; p_event; p_event = p_event->p_next)
+    i_count++;
+
+  p_writer = malloc(sizeof(eit_schedule_writer_t));
+  if (i_count)
+    p_events = malloc(i_count * sizeof(eit_schedule_event_t));
+  if (!p_writer || (i_count && !p_events))
+  {
+    dvbpsi_error(p_dvbpsi, "EIT generator", "out of memory");
+    free(p_writer);
+    free(p_events);
+    return NULL;
+  }
+
+  /* Events in the time span of the schedule, by start time */
+  for (p_event = p_eit->p_first_event; p_event; p_event = p_event->p_next)
+  {
+    uint32_t i_seconds;
+
+    if (!EITScheduleSeconds(p_event->i_start_time, i_mjd, &i_seconds)
+     || i_seconds >= EIT_SCHEDULE_TABLES * EIT_SCHEDULE_SEGMENTS * EIT_SCHEDULE_SEGMENT)
+    {
+      i_late++;
+      continue;
+    }
+    if (i_events && i_seconds < p_events[i_events - 1].i_seconds)
+      b_sorted = false;
+    p_events[i_events].i_seconds = i_seconds;
+    p_events[i_events].i_index = i_events;
+    p_events[i_events].p_event = p_event;
+    i_events++;
+  }
+  if (i_late)
+    dvbpsi_debug(p_dvbpsi, "EIT generator", "%zu events outside of the schedule "
+                 "ignored", i_late);
+  if (!b_sorted)
+    qsort(p_events, i_events, sizeof(eit_schedule_event_t), EITScheduleCompare);
+
+  if (i_events)
+  {
+    uint32_t i_segment = p_events[i_events - 1].i_seconds / EIT_SCHEDULE_SEGMENT;
+    i_last_table = i_segment / EIT_SCHEDULE_SEGMENTS;
+    i_last_segment = i_segment % EIT_SCHEDULE_SEGMENTS;
+  }
+
+  p_writer->p_dvbpsi = p_dvbpsi;
+  p_writer->p_eit = p_eit;
+  p_writer->p_first = NULL;
+  p_writer->pp_last = &p_writer->p_first;
+  p_writer->b_error = false;
+
+  for (t = 0; t <= i_last_table && !p_writer->b_error; t++)
+  {
+    dvbpsi_psi_section_t **pp_table = p_writer->pp_last, *p_section;
+    unsigned int i_segments = t == i_last_table ? i_last_segment + 1
+                                                : EIT_SCHEDULE_SEGMENTS;
+    unsigned int s;
+
+    p_writer->i_table_id = i_table_id + t;
+
+    for (s = 0; s < i_segments; s++)
+    {
+      uint32_t i_end = (t * EIT_SCHEDULE_SEGMENTS + s + 1) * EIT_SCHEDULE_SEGMENT;
+      size_t i_first = i_next;
+
+      while (i_next < i_events && p_events[i_next].i_seconds < i_end)
+        i_next++;
+
+      if (!EITScheduleSegment(p_writer, s * 8, p_events + i_first,
+                              i_next - i_first))
+        break;
+    }
+
+    /* last_section_number, last_table_id and CRC_32. The sections are
+     * built here rather than by dvbpsi_BuildPSISection() which computes the
+     * CRC_32 a second time to check it, doubling the cost of a schedule. */
+    for (p_section = *pp_table; p_section; p_section = p_section->p_next)
+    {
+      p_section->i_last_number = p_writer->i_number;
+      p_section->p_data[7] = p_writer->i_number;
+      p_section->p_data[13] = i_table_id + i_last_table;
+      dvbpsi_CalculateCRC32(p_section);
+    }
+  }
+
+  p_result = p_writer->p_first;
+  if (p_writer->b_error)
+  {
+    dvbpsi_DeletePSISections(p_result);
+    p_result = NULL;
+  }
+
+  free(p_events);
+  free(p_writer);
+  return p_result;
+}
+
+/*****************************************************************************
+ * dvbpsi_eit_schedules_generate
+ *****************************************************************************
+ * Generate the EIT schedules of several services, on a pool of threads.
+ *****************************************************************************/
+typedef struct
+{
+  dvbpsi_t                   *p_dvbpsi;
+  dvbpsi_eit_t * const       *pp_eits;
+  dvbpsi_psi_section_t      **pp_sections;
+  size_t                      i_eits;
+  uint8_t                     i_table_id;
+  uint16_t                    i_mjd;
+
+#ifdef HAVE_PTHREAD
+  pthread_mutex_t             lock;
+#endif
+  size_t                      i_next;
+  bool                        b_error;
+} eit_schedule_pool_t;
+
+static void *EITScheduleWorker(void *p_data)
+{
+  eit_schedule_pool_t *p_pool = p_data;
+
+  for (;;)
+  {
+    dvbpsi_psi_section_t *p_sections;
+    size_t i;
+
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&p_pool->lock);
+#endif
+    i = p_pool->i_next++;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&p_pool->lock);
+#endif
+    if (i >= p_pool->i_eits)
+      break;
+
+    p_sections = dvbpsi_eit_schedule_generate(p_pool->p_dvbpsi, p_pool->pp_eits[i],
+                                              p_pool->i_table_id, p_pool->i_mjd);
+    p_pool->pp_sections[i] = p_sections;
+    if (!p_sections)
+    {
+#ifdef HAVE_PTHREAD
+      pthread_mutex_lock(&p_pool->lock);
+#endif
+      p_pool->b_error = true;
+#ifdef HAVE_PTHREAD
+      pthread_mutex_unlock(&p_pool->lock);
+#endif
+    }
+  }
+  return NULL;
+}
+
+bool dvbpsi_eit_schedules_generate(dvbpsi_t *p_dvbpsi, dvbpsi_eit_t * const *pp_eits,
+                                   size_t i_eits, uint8_t i_table_id, uint16_t i_mjd,
+                                   unsigned int i_threads,
+                                   dvbpsi_psi_section_t **pp_sections)
+{
+  eit_schedule_pool_t pool =
+  {
+    .p_dvbpsi = p_dvbpsi,
+    .pp_eits = pp_eits,
+    .pp_sections = pp_sections,
+    .i_eits = i_eits,
+    .i_table_id = i_table_id,
+    .i_mjd = i_mjd,
+    .i_next = 0,
+    .b_error = false,
+  };
+
+#ifdef HAVE_PTHREAD
+  pthread_t *p_threads = NULL;
+  unsigned int i_started = 0, i;
+
+  if (i_threads > i_eits)
+    i_threads = i_eits;
+  if (i_threads > 1)
+    p_threads = malloc((i_threads - 1) * sizeof(pthread_t));
+
+  pthread_mutex_init(&pool.lock, NULL);
+
+  /* the calling thread is the last worker */
+  if (p_threads)
+  {
+    for (; i_started < i_threads - 1; i_started++)
+      if (pthread_create(&p_threads[i_started], NULL, EITScheduleWorker, &pool))
+        break;
+  }
+  EITScheduleWorker(&pool);
+
+  for (i = 0; i < i_started; i++)
+    pthread_join(p_threads[i], NULL);
+
+  pthread_mutex_destroy(&pool.lock);
+  free(p_threads);
+#else
+  (void)i_threads;
+  EITScheduleWorker(&pool);
+#endif
+
+  return !pool.b_error;
+}
@@ -68,6 +68,15 @@ typedef struct dvbpsi_eit_event_s
   struct dvbpsi_eit_event_s * p_next;               /*!< next element of
                                                              the list */
 
+  int64_t                   i_start;                /*!< start_time in seconds
+                                                         since the Unix epoch,
+                                                         DVBPSI_TIME_UNDEFINED
+                                                         if undefined, see
+                                                         dvbtime.h */
+  int64_t                   i_end;                  /*!< end of the event in
+                                                         seconds since the Unix
+                                                         epoch */
+
 } dvbpsi_eit_event_t;
 
 /*****************************************************************************
@@ -296,6 +305,96 @@ dvbpsi_descriptor_t* dvbpsi_eit_event_descriptor_add(
 dvbpsi_psi_section_t *dvbpsi_eit_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_eit_t *p_eit,
                                             uint8_t i_table_id);
 
+/*****************************************************************************
+ * dvbpsi_eit_sections_update
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_t *dvbpsi_eit_sections_update(dvbpsi_t *p_dvbpsi,
+            dvbpsi_sections_cache_t *p_cache, dvbpsi_eit_t *p_eit, uint8_t i_table_id)
+ * \brief Incremental EIT generator.
+ *
+ * Same as dvbpsi_eit_sections_generate() but the sections of the previous
+ * call with the same cache are kept and only the sections carrying events
+ * that changed are encoded again. Events are matched on their event_id.
+ * The version of the first generation is p_eit->i_version, it is then
+ * incremented once each time the content changes and p_eit->i_version is
+ * updated accordingly.
+ * \param p_dvbpsi dvbpsi handle
+ * \param p_cache cache of this sub-table, see dvbpsi_sections_cache_new()
+ * \param p_eit EIT structure
+ * \param i_table_id the EIT table id to use
+ * \return the sections, which belong to the cache and remain valid until
+ * the next call or the deletion of the cache. NULL on error.
+ */
+dvbpsi_psi_section_t *dvbpsi_eit_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_sections_cache_t *p_cache,
+                                                 dvbpsi_eit_t *p_eit, uint8_t i_table_id);
+
+/*****************************************************************************
+ * dvbpsi_eit_schedule_generate
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_t *dvbpsi_eit_schedule_generate(dvbpsi_t *p_dvbpsi,
+            const dvbpsi_eit_t *p_eit, uint8_t i_table_id, uint16_t i_mjd)
+ * \brief EIT schedule generator.
+ *
+ * Generates the EIT schedule sub-tables of a service following the segment
+ * structure of EN 300 468 5.1.5 and TR 101 211 4.1.4: the schedule starts at
+ * midnight UTC of i_mjd, each sub-table covers 4 days in 32 segments of
+ * 3 hours, and the events starting in segment n are carried by sections
+ * 8n to 8n + 7 of the sub-table. Every segment up to the last one holding an
+ * event is carried by at least one section, empty segments by a section
+ * without events. Sub-tables i_table_id to last_table_id are generated,
+ * last_table_id being the one of the last event.
+ *
+ * Events are taken in start time order, events with the same start time
+ * keeping their order in p_eit. Events starting before i_mjd or after the
+ * 64 days of the schedule are ignored. The events of a segment that do not
+ * fit in its 8 sections are dropped with an error.
+ *
+ * The i_last_table_id and i_segment_last_section_number fields of p_eit are
+ * not used.
+ * \param p_dvbpsi dvbpsi handle
+ * \param p_eit EIT structure of the service
+ * \param i_table_id 0x50 for the actual transport stream, 0x60 for other
+ * transport streams
+ * \param i_mjd Modified Julian Date of the first day of the schedule
+ * \return the sections of all the sub-tables, by table_id then
+ * section_number, NULL on error
+ */
+dvbpsi_psi_section_t *dvbpsi_eit_schedule_generate(dvbpsi_t *p_dvbpsi,
+                                                   const dvbpsi_eit_t *p_eit,
+                                                   uint8_t i_table_id, uint16_t i_mjd);
+
+/*****************************************************************************
+ * dvbpsi_eit_schedules_generate
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_eit_schedules_generate(dvbpsi_t *p_dvbpsi,
+            dvbpsi_eit_t * const *pp_eits, size_t i_eits, uint8_t i_table_id,
+            uint16_t i_mjd, unsigned int i_threads, dvbpsi_psi_section_t **pp_sections)
+ * \brief Generate the EIT schedules of several services in parallel.
+ *
+ * Calls dvbpsi_eit_schedule_generate() for each service, on up to i_threads
+ * threads, the calling thread included. Without POSIX threads support the
+ * services are generated one after the other. The messages of p_dvbpsi may
+ * be emitted from any of the threads.
+ * \param p_dvbpsi dvbpsi handle
+ * \param pp_eits the EIT structures, one per service
+ * \param i_eits number of services
+ * \param i_table_id 0x50 for the actual transport stream, 0x60 for other
+ * transport streams
+ * \param i_mjd Modified Julian Date of the first day of the schedules
+ * \param i_threads maximum number of threads
+ * \param pp_sections array of i_eits entries filled with the sections of
+ * each service, NULL for the services that failed
+ * \return false if any service failed
+ */
+bool dvbpsi_eit_schedules_generate(dvbpsi_t *p_dvbpsi, dvbpsi_eit_t * const *pp_eits,
+                                   size_t i_eits, uint8_t i_table_id, uint16_t i_mjd,
+                                   unsigned int i_threads,
+                                   dvbpsi_psi_section_t **pp_sections);
+
 #ifdef __cplusplus
 };
 #endif
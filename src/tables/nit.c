@@ -47,6 +47,8 @@
 #include "../psi.h"
 #include "../descriptor.h"
 #include "../demux.h"
+#include "../sections_cache_private.h"
+#include "../bitstream_private.h"
 #include "nit.h"
 #include "nit_private.h"
 
@@ -453,59 +455,58 @@ void dvbpsi_nit_sections_gather(dvbpsi_t *p_dvbpsi,
 void dvbpsi_nit_sections_decode(dvbpsi_nit_t* p_nit,
                                 dvbpsi_psi_section_t* p_section)
 {
-    uint8_t* p_byte, * p_end;
-
     while (p_section)
     {
-        /* - NIT descriptors */
-        p_byte = p_section->p_payload_start + 2;
-        p_end = p_byte + (((uint16_t)(p_section->p_payload_start[0] & 0x0f) << 8)
-                          | p_section->p_payload_start[1]);
+        dvbpsi_reader_t reader, loop, descriptors;
 
-        while (p_byte + 2 <= p_end)
+        dvbpsi_reader_init(&reader, p_section->p_payload_start,
+                           p_section->p_payload_end);
+
+        /* - NIT descriptors */
+        if (!dvbpsi_reader_need(&reader, 2))
+            goto next_section;
+        dvbpsi_reader_sub(&reader, &descriptors, dvbpsi_read16(&reader) & 0x0fff);
+        while (dvbpsi_reader_next(&descriptors, 2))
         {
-            uint8_t i_tag = p_byte[0];
-            uint8_t i_length = p_byte[1];
-            if (i_length + 2 <= p_end - p_byte)
-                dvbpsi_nit_descriptor_add(p_nit, i_tag, i_length, p_byte + 2);
-            p_byte += 2 + i_length;
+            uint8_t i_tag = dvbpsi_read8(&descriptors);
+            uint8_t i_length = dvbpsi_read8(&descriptors);
+            if (!dvbpsi_reader_need(&descriptors, i_length))
+                break;
+            uint8_t *p_data = dvbpsi_reader_at(&descriptors, p_section->p_data);
+            dvbpsi_nit_descriptor_add(p_nit, i_tag, i_length, p_data);
+            dvbpsi_reader_skip(&descriptors, i_length);
         }
 
         /* Transport stream loop length */
-        p_end = 2 + p_byte + (((uint16_t)(p_byte[0] & 0x0f) << 8) | p_byte[1]);
-        if (p_end > p_section->p_payload_end)
-            p_end = p_section->p_payload_end;
-
-        p_byte += 2;
+        if (!dvbpsi_reader_need(&reader, 2))
+            goto next_section;
+        dvbpsi_reader_sub(&reader, &loop, dvbpsi_read16(&reader) & 0x0fff);
 
         /* - TSs */
-        while(p_byte + 6 <= p_end)
+        while (dvbpsi_reader_next(&loop, 6))
         {
-            uint8_t *p_end2; /* descriptor loop end */
-
-            uint16_t i_ts_id = ((uint16_t)p_byte[0] << 8) | p_byte[1];
-            uint16_t i_orig_network_id = ((uint16_t)p_byte[2] << 8) | p_byte[3];
-            uint16_t i_ts_length = ((uint16_t)(p_byte[4] & 0x0f) << 8) | p_byte[5];
+            uint16_t i_ts_id = dvbpsi_read16(&loop);
+            uint16_t i_orig_network_id = dvbpsi_read16(&loop);
+            uint16_t i_ts_length = dvbpsi_read16(&loop) & 0x0fff;
 
             dvbpsi_nit_ts_t* p_ts = dvbpsi_nit_ts_add(p_nit, i_ts_id, i_orig_network_id);
             if (!p_ts)
                 break;
 
             /* - TS descriptors */
-            p_byte += 6;
-            p_end2 = p_byte + i_ts_length;
-            if (p_end2 > p_section->p_payload_end)
-                p_end2 = p_section->p_payload_end;
-
-            while (p_byte + 2 <= p_end2)
+            dvbpsi_reader_sub(&loop, &descriptors, i_ts_length);
+            while (dvbpsi_reader_next(&descriptors, 2))
             {
-                uint8_t i_tag = p_byte[0];
-                uint8_t i_length = p_byte[1];
-                if (i_length + 2 <= p_end2 - p_byte)
-                    dvbpsi_nit_ts_descriptor_add(p_ts, i_tag, i_length, p_byte + 2);
-                p_byte += 2 + i_length;
+                uint8_t i_tag = dvbpsi_read8(&descriptors);
+                uint8_t i_length = dvbpsi_read8(&descriptors);
+                if (!dvbpsi_reader_need(&descriptors, i_length))
+                    break;
+                uint8_t *p_data = dvbpsi_reader_at(&descriptors, p_section->p_data);
+                dvbpsi_nit_ts_descriptor_add(p_ts, i_tag, i_length, p_data);
+                dvbpsi_reader_skip(&descriptors, i_length);
             }
         }
+    next_section:
         p_section = p_section->p_next;
     }
 }
@@ -547,8 +548,7 @@ dvbpsi_psi_section_t* dvbpsi_nit_sections_generate(dvbpsi_t *p_dvbpsi,
         {
             /* network_descriptors_length */
             i_network_descriptors_length = (p_current->p_payload_end - p_current->p_payload_start) - 2;
-            p_current->p_data[8] = (i_network_descriptors_length >> 8) | 0xf0;
-            p_current->p_data[9] = i_network_descriptors_length;
+            dvbpsi_set16(p_current->p_data + 8, 0xf000 | i_network_descriptors_length);
 
             /* transport_stream_loop_length */
             p_current->p_payload_end[0] = 0;
@@ -587,8 +587,7 @@ dvbpsi_psi_section_t* dvbpsi_nit_sections_generate(dvbpsi_t *p_dvbpsi,
 
     /* network_descriptors_length */
     i_network_descriptors_length = (p_current->p_payload_end - p_current->p_payload_start) - 2;
-    p_current->p_data[8] = (i_network_descriptors_length >> 8) | 0xf0;
-    p_current->p_data[9] = i_network_descriptors_length;
+    dvbpsi_set16(p_current->p_data + 8, 0xf000 | i_network_descriptors_length);
 
     /* Store the position of the transport_stream_loop_length field
        and reserve two bytes for it */
@@ -603,24 +602,21 @@ dvbpsi_psi_section_t* dvbpsi_nit_sections_generate(dvbpsi_t *p_dvbpsi,
 
         /* Can the current section carry all the descriptors ? */
         p_descriptor = p_ts->p_first_descriptor;
-        while(    (p_descriptor != NULL)
-               && ((p_ts_start - p_current->p_data) + i_ts_length <= 1020))
+        while(p_descriptor != NULL)
         {
             i_ts_length += p_descriptor->i_length + 2;
             p_descriptor = p_descriptor->p_next;
         }
 
         /* If _no_ and the current section isn't empty and an empty section
-           may carry one more descriptor
-           then create a new section */
-        if(    (p_descriptor != NULL)
+           may carry all of them then create a new section */
+        if(    ((p_ts_start - p_current->p_data) + i_ts_length > 1020)
             && (p_ts_start - p_current->p_data != 12)
             && (i_ts_length <= 1008))
         {
             /* transport_stream_loop_length */
             i_transport_stream_loop_length = (p_current->p_payload_end - p_transport_stream_loop_length) - 2;
-            p_transport_stream_loop_length[0] = (i_transport_stream_loop_length >> 8) | 0xf0;
-            p_transport_stream_loop_length[1] = i_transport_stream_loop_length;
+            dvbpsi_set16(p_transport_stream_loop_length, 0xf000 | i_transport_stream_loop_length);
 
             /* will put more descriptors in an empty section */
             dvbpsi_debug(p_dvbpsi, "NIT generator",
@@ -654,10 +650,8 @@ dvbpsi_psi_section_t* dvbpsi_nit_sections_generate(dvbpsi_t *p_dvbpsi,
         }
 
         /* p_ts_start is where the TS begins */
-        p_ts_start[0] = p_ts->i_ts_id >> 8;
-        p_ts_start[1] = p_ts->i_ts_id & 0xff;
-        p_ts_start[2] = p_ts->i_orig_network_id >> 8;
-        p_ts_start[3] = p_ts->i_orig_network_id & 0xff;
+        dvbpsi_set16(p_ts_start, p_ts->i_ts_id);
+        dvbpsi_set16(p_ts_start + 2, p_ts->i_orig_network_id);
 
         /* Increase the length by 6 */
         p_current->p_payload_end += 6;
@@ -688,16 +682,14 @@ dvbpsi_psi_section_t* dvbpsi_nit_sections_generate(dvbpsi_t *p_dvbpsi,
 
         /* TS_info_length */
         i_ts_length = p_current->p_payload_end - p_ts_start - 6;
-        p_ts_start[4] = (i_ts_length >> 8) | 0xf0;
-        p_ts_start[5] = i_ts_length;
+        dvbpsi_set16(p_ts_start + 4, 0xf000 | i_ts_length);
 
         p_ts = p_ts->p_next;
     }
 
     /* transport_stream_loop_length */
     i_transport_stream_loop_length = (p_current->p_payload_end - p_transport_stream_loop_length) - 2;
-    p_transport_stream_loop_length[0] = (i_transport_stream_loop_length >> 8) | 0xf0;
-    p_transport_stream_loop_length[1] = i_transport_stream_loop_length;
+    dvbpsi_set16(p_transport_stream_loop_length, 0xf000 | i_transport_stream_loop_length);
 
     /* Finalization */
     p_prev = p_result;
@@ -710,3 +702,65 @@ dvbpsi_psi_section_t* dvbpsi_nit_sections_generate(dvbpsi_t *p_dvbpsi,
 
     return p_result;
 }
+
+/*****************************************************************************
+ * Incremental generation
+ *****************************************************************************/
+static const void *NITTSNext(const void *p_entry)
+{
+    return ((const dvbpsi_nit_ts_t *)p_entry)->p_next;
+}
+
+static uint32_t NITTSKey(const void *p_entry)
+{
+    const dvbpsi_nit_ts_t *p_ts = p_entry;
+    return ((uint32_t)p_ts->i_ts_id << 16) | p_ts->i_orig_network_id;
+}
+
+static const dvbpsi_descriptor_t *NITTSDescriptors(const void *p_entry)
+{
+    return ((const dvbpsi_nit_ts_t *)p_entry)->p_first_descriptor;
+}
+
+static void NITTSHeader(const void *p_entry, uint8_t *p, uint16_t i_length)
+{
+    const dvbpsi_nit_ts_t *p_ts = p_entry;
+
+    dvbpsi_set16(p, p_ts->i_ts_id);
+    dvbpsi_set16(p + 2, p_ts->i_orig_network_id);
+    dvbpsi_set16(p + 4, 0xf000 | i_length);
+}
+
+/*****************************************************************************
+ * dvbpsi_nit_sections_update
+ *****************************************************************************
+ * Generate NIT sections, only encoding again the ones that changed.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_nit_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_sections_cache_t *p_cache,
+                                                 dvbpsi_nit_t *p_nit, uint8_t i_table_id)
+{
+    dvbpsi_sections_layout_t layout =
+    {
+        .i_table_id = i_table_id,
+        .b_private_indicator = false,
+        .i_extension = p_nit->i_network_id,
+        .i_version = p_nit->i_version,
+        .b_current_next = p_nit->b_current_next,
+        .i_max_size = 1024,
+        .b_loops = true,
+        .p_first_loop = p_nit->p_first_descriptor,
+        .p_first_entry = p_nit->p_first_ts,
+        .i_entry_header = 6,
+        .pf_next = NITTSNext,
+        .pf_key = NITTSKey,
+        .pf_descriptors = NITTSDescriptors,
+        .pf_entry_header = NITTSHeader,
+    };
+    dvbpsi_psi_section_t *p_sections;
+
+    p_sections = dvbpsi_sections_cache_update(p_dvbpsi, p_cache, &layout);
+    if (p_sections)
+        p_nit->i_version = dvbpsi_sections_cache_version(p_cache);
+    return p_sections;
+}
@@ -260,6 +260,31 @@ dvbpsi_descriptor_t* dvbpsi_nit_ts_descriptor_add(dvbpsi_nit_ts_t* p_ts,
 dvbpsi_psi_section_t* dvbpsi_nit_sections_generate(dvbpsi_t* p_dvbpsi, dvbpsi_nit_t* p_nit,
                                             uint8_t i_table_id);
 
+/*****************************************************************************
+ * dvbpsi_nit_sections_update
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_t *dvbpsi_nit_sections_update(dvbpsi_t *p_dvbpsi,
+            dvbpsi_sections_cache_t *p_cache, dvbpsi_nit_t *p_nit, uint8_t i_table_id)
+ * \brief Incremental NIT generator.
+ *
+ * Same as dvbpsi_nit_sections_generate() but only the sections carrying
+ * transport streams that changed since the previous call with the same
+ * cache are encoded again. Transport streams are matched on their
+ * transport_stream_id and original_network_id. The network descriptors must fit in the
+ * first section. The version handling is the one of
+ * dvbpsi_eit_sections_update().
+ * \param p_dvbpsi dvbpsi handle
+ * \param p_cache cache of this sub-table, see dvbpsi_sections_cache_new()
+ * \param p_nit NIT structure
+ * \param i_table_id table id, 0x40 = actual network / 0x41 = other network
+ * \return the sections, which belong to the cache and remain valid until
+ * the next call or the deletion of the cache. NULL on error.
+ */
+dvbpsi_psi_section_t *dvbpsi_nit_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_sections_cache_t *p_cache,
+                                                 dvbpsi_nit_t *p_nit, uint8_t i_table_id);
+
 #ifdef __cplusplus
 };
 #endif
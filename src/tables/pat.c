@@ -30,6 +30,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 #if defined(HAVE_INTTYPES_H)
 #include <inttypes.h>
@@ -42,6 +43,7 @@
 #include "../dvbpsi.h"
 #include "../dvbpsi_private.h"
 #include "../psi.h"
+#include "../bitstream_private.h"
 #include "pat.h"
 #include "pat_private.h"
 
@@ -361,12 +363,14 @@ bool dvbpsi_pat_sections_decode(dvbpsi_pat_t* p_pat, dvbpsi_psi_section_t* p_sec
     bool b_valid = false;
     while (p_section)
     {
-        for (uint8_t *p_byte = p_section->p_payload_start;
-            p_byte < p_section->p_payload_end;
-            p_byte += 4)
+        dvbpsi_reader_t reader;
+
+        dvbpsi_reader_init(&reader, p_section->p_payload_start,
+                           p_section->p_payload_end);
+        while (dvbpsi_reader_next(&reader, 4))
         {
-            uint16_t i_program_number = ((uint16_t)(p_byte[0]) << 8) | p_byte[1];
-            uint16_t i_pid = ((uint16_t)(p_byte[2] & 0x1f) << 8) | p_byte[3];
+            uint16_t i_program_number = dvbpsi_read16(&reader);
+            uint16_t i_pid = dvbpsi_read16(&reader) & 0x1fff;
             dvbpsi_pat_program_t* p_program = dvbpsi_pat_program_add(p_pat, i_program_number, i_pid);
             if (p_program)
                 b_valid = true;
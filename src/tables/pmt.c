@@ -44,6 +44,7 @@
 #include "../dvbpsi_private.h"
 #include "../psi.h"
 #include "../descriptor.h"
+#include "../bitstream_private.h"
 #include "pmt.h"
 #include "pmt_private.h"
 
@@ -411,46 +412,53 @@ void dvbpsi_pmt_sections_gather(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t* p_sect
 void dvbpsi_pmt_sections_decode(dvbpsi_pmt_t* p_pmt,
                                 dvbpsi_psi_section_t* p_section)
 {
-    uint8_t* p_byte, * p_end;
-
     while (p_section)
     {
+        dvbpsi_reader_t reader, descriptors;
+
+        dvbpsi_reader_init(&reader, p_section->p_payload_start,
+                           p_section->p_payload_end);
+
         /* - PMT descriptors */
-        p_byte = p_section->p_payload_start + 4;
-        p_end = p_byte + (   ((uint16_t)(p_section->p_payload_start[2] & 0x0f) << 8)
-                           | p_section->p_payload_start[3]);
-        while (p_byte + 2 <= p_end)
+        if (!dvbpsi_reader_need(&reader, 4))
+            goto next_section;
+        dvbpsi_reader_skip(&reader, 2);
+        dvbpsi_reader_sub(&reader, &descriptors, dvbpsi_read16(&reader) & 0x0fff);
+        while (dvbpsi_reader_next(&descriptors, 2))
         {
-            uint8_t i_tag = p_byte[0];
-            uint8_t i_length = p_byte[1];
-            if (i_length + 2 <= p_end - p_byte)
-                dvbpsi_pmt_descriptor_add(p_pmt, i_tag, i_length, p_byte + 2);
-            p_byte += 2 + i_length;
+            uint8_t i_tag = dvbpsi_read8(&descriptors);
+            uint8_t i_length = dvbpsi_read8(&descriptors);
+            if (!dvbpsi_reader_need(&descriptors, i_length))
+                break;
+            uint8_t *p_data = dvbpsi_reader_at(&descriptors, p_section->p_data);
+            dvbpsi_pmt_descriptor_add(p_pmt, i_tag, i_length, p_data);
+            dvbpsi_reader_skip(&descriptors, i_length);
         }
 
         /* - ESs */
-        for (p_byte = p_end; p_byte + 5 <= p_section->p_payload_end;)
+        while (dvbpsi_reader_next(&reader, 5))
         {
-            uint8_t i_type = p_byte[0];
-            uint16_t i_pid = ((uint16_t)(p_byte[1] & 0x1f) << 8) | p_byte[2];
-            uint16_t i_es_length = ((uint16_t)(p_byte[3] & 0x0f) << 8) | p_byte[4];
+            uint8_t i_type = dvbpsi_read8(&reader);
+            uint16_t i_pid = dvbpsi_read16(&reader) & 0x1fff;
+            uint16_t i_es_length = dvbpsi_read16(&reader) & 0x0fff;
             dvbpsi_pmt_es_t* p_es = dvbpsi_pmt_es_add(p_pmt, i_type, i_pid);
+            if (!p_es)
+                break;
+
             /* - ES descriptors */
-            p_byte += 5;
-            p_end = p_byte + i_es_length;
-            if (p_end > p_section->p_payload_end)
-            {
-                p_end = p_section->p_payload_end;
-            }
-            while (p_byte + 2 <= p_end)
+            dvbpsi_reader_sub(&reader, &descriptors, i_es_length);
+            while (dvbpsi_reader_next(&descriptors, 2))
             {
-                uint8_t i_tag = p_byte[0];
-                uint8_t i_length = p_byte[1];
-                if (i_length + 2 <= p_end - p_byte)
-                    dvbpsi_pmt_es_descriptor_add(p_es, i_tag, i_length, p_byte + 2);
-                p_byte += 2 + i_length;
+                uint8_t i_tag = dvbpsi_read8(&descriptors);
+                uint8_t i_length = dvbpsi_read8(&descriptors);
+                if (!dvbpsi_reader_need(&descriptors, i_length))
+                    break;
+                uint8_t *p_data = dvbpsi_reader_at(&descriptors, p_section->p_data);
+                dvbpsi_pmt_es_descriptor_add(p_es, i_tag, i_length, p_data);
+                dvbpsi_reader_skip(&descriptors, i_length);
             }
         }
+    next_section:
         p_section = p_section->p_next;
     }
 }
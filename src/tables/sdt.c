@@ -45,6 +45,8 @@
 #include "../psi.h"
 #include "../descriptor.h"
 #include "../demux.h"
+#include "../sections_cache_private.h"
+#include "../bitstream_private.h"
 #include "sdt.h"
 #include "sdt_private.h"
 
@@ -436,35 +438,44 @@ void dvbpsi_sdt_sections_gather(dvbpsi_t *p_dvbpsi,
 void dvbpsi_sdt_sections_decode(dvbpsi_sdt_t* p_sdt,
                                 dvbpsi_psi_section_t* p_section)
 {
-    uint8_t *p_byte, *p_end;
-
     while (p_section)
     {
-        for (p_byte = p_section->p_payload_start + 3;
-             p_byte + 4 < p_section->p_payload_end;)
+        dvbpsi_reader_t reader, descriptors;
+
+        dvbpsi_reader_init(&reader, p_section->p_payload_start + 3,
+                           p_section->p_payload_end);
+
+        while (dvbpsi_reader_next(&reader, 5))
         {
-            uint16_t i_service_id = ((uint16_t)(p_byte[0]) << 8) | p_byte[1];
-            bool b_eit_schedule = ((p_byte[2] & 0x2) >> 1);
-            bool b_eit_present =  ((p_byte[2]) & 0x1);
-            uint8_t i_running_status = (uint8_t)(p_byte[3]) >> 5;
-            bool b_free_ca = ((p_byte[3] & 0x10) >> 4);
-            uint16_t i_srv_length = ((uint16_t)(p_byte[3] & 0xf) <<8) | p_byte[4];
+            uint16_t i_service_id = dvbpsi_read16(&reader);
+            uint8_t i_eit = dvbpsi_read8(&reader);
+            bool b_eit_schedule = (i_eit & 0x2) ? true : false;
+            bool b_eit_present = (i_eit & 0x1) ? true : false;
+            uint16_t i_flags = dvbpsi_read16(&reader);
+            uint8_t i_running_status = i_flags >> 13;
+            bool b_free_ca = (i_flags & 0x1000) ? true : false;
+            uint16_t i_srv_length = i_flags & 0x0fff;
+
             dvbpsi_sdt_service_t* p_service = dvbpsi_sdt_service_add(p_sdt,
                     i_service_id, b_eit_schedule, b_eit_present,
                     i_running_status, b_free_ca);
+            if (!p_service)
+                break;
 
             /* Service descriptors */
-            p_byte += 5;
-            p_end = p_byte + i_srv_length;
-            if( p_end > p_section->p_payload_end ) break;
+            if (i_srv_length > dvbpsi_reader_left(&reader))
+                break;
 
-            while(p_byte + 2 <= p_end)
+            dvbpsi_reader_sub(&reader, &descriptors, i_srv_length);
+            while (dvbpsi_reader_next(&descriptors, 2))
             {
-                uint8_t i_tag = p_byte[0];
-                uint8_t i_length = p_byte[1];
-                if (i_length + 2 <= p_end - p_byte)
-                    dvbpsi_sdt_service_descriptor_add(p_service, i_tag, i_length, p_byte + 2);
-                p_byte += 2 + i_length;
+                uint8_t i_tag = dvbpsi_read8(&descriptors);
+                uint8_t i_length = dvbpsi_read8(&descriptors);
+                if (!dvbpsi_reader_need(&descriptors, i_length))
+                    break;
+                uint8_t *p_data = dvbpsi_reader_at(&descriptors, p_section->p_data);
+                dvbpsi_sdt_service_descriptor_add(p_service, i_tag, i_length, p_data);
+                dvbpsi_reader_skip(&descriptors, i_length);
             }
         }
         p_section = p_section->p_next;
@@ -484,7 +495,7 @@ dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sd
 
     dvbpsi_sdt_service_t *p_service = p_sdt->p_first_service;
 
-    p_current->i_table_id = 0x42;
+    p_current->i_table_id = p_sdt->i_table_id;
     p_current->b_syntax_indicator = true;
     p_current->b_private_indicator = true;
     p_current->i_length = 12;                    /* header + CRC_32 */
@@ -496,8 +507,7 @@ dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sd
     p_current->p_payload_start = p_current->p_data + 8;
 
     /* Original Network ID */
-    p_current->p_data[8] = (p_sdt->i_network_id >> 8) ;
-    p_current->p_data[9] = p_sdt->i_network_id;
+    dvbpsi_set16(p_current->p_data + 8, p_sdt->i_network_id);
     p_current->p_data[10] = 0xff;
 
     /* SDT service */
@@ -508,13 +518,14 @@ dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sd
 
         dvbpsi_descriptor_t * p_descriptor = p_service->p_first_descriptor;
 
-        while ((p_descriptor != NULL)&& ((p_service_start - p_current->p_data) + i_service_length <= 1020))
+        while (p_descriptor != NULL)
         {
             i_service_length += p_descriptor->i_length + 2;
             p_descriptor = p_descriptor->p_next;
         }
 
-        if ((p_descriptor != NULL) && (p_service_start - p_current->p_data != 11) && (i_service_length <= 1009))
+        if (((p_service_start - p_current->p_data) + i_service_length > 1020)
+            && (p_service_start - p_current->p_data != 11) && (i_service_length <= 1009))
         {
             /* will put more descriptors in an empty section */
             dvbpsi_debug(p_dvbpsi, "SDT generator","create a new section to carry more Service descriptors");
@@ -523,7 +534,7 @@ dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sd
             p_current = dvbpsi_NewPSISection(1024);
             p_prev->p_next = p_current;
 
-            p_current->i_table_id = 0x42;
+            p_current->i_table_id = p_sdt->i_table_id;
             p_current->b_syntax_indicator = true;
             p_current->b_private_indicator = true;
             p_current->i_length = 12;                 /* header + CRC_32 */
@@ -535,15 +546,13 @@ dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sd
             p_current->p_payload_start = p_current->p_data + 8;
 
             /* Original Network ID */
-            p_current->p_data[8] = (p_sdt->i_network_id >> 8) ;
-            p_current->p_data[9] = p_sdt->i_network_id;
+            dvbpsi_set16(p_current->p_data + 8, p_sdt->i_network_id);
             p_current->p_data[10] = 0xff;
 
             p_service_start = p_current->p_payload_end;
         }
 
-        p_service_start[0] = (p_service->i_service_id >>8);
-        p_service_start[1] = (p_service->i_service_id );
+        dvbpsi_set16(p_service_start, p_service->i_service_id);
         p_service_start[2] = 0xfc | (p_service-> b_eit_schedule  ? 0x2 : 0x0) | (p_service->b_eit_present ? 0x01 : 0x00);
         p_service_start[3] = ((p_service->i_running_status & 0x07) << 5 ) | ((p_service->b_free_ca & 0x1) << 4);
 
@@ -570,8 +579,8 @@ dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sd
 
         /* ES_info_length */
         i_service_length = p_current->p_payload_end - p_service_start - 5;
-        p_service_start[3] |= ((i_service_length  >> 8) & 0x0f);
-        p_service_start[4] = i_service_length;
+        dvbpsi_set16(p_service_start + 3,
+                     p_service_start[3] << 8 | (i_service_length & 0x0fff));
 
         p_service = p_service->p_next;
     }
@@ -586,3 +595,76 @@ dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sd
     }
     return p_result;
 }
+
+/*****************************************************************************
+ * Incremental generation
+ *****************************************************************************/
+static void SDTFixed(const void *p_table, uint8_t *p, uint8_t i_last_number)
+{
+    const dvbpsi_sdt_t *p_sdt = p_table;
+    (void)i_last_number;
+
+    dvbpsi_set16(p, p_sdt->i_network_id);
+    p[2] = 0xff;
+}
+
+static const void *SDTServiceNext(const void *p_entry)
+{
+    return ((const dvbpsi_sdt_service_t *)p_entry)->p_next;
+}
+
+static uint32_t SDTServiceKey(const void *p_entry)
+{
+    return ((const dvbpsi_sdt_service_t *)p_entry)->i_service_id;
+}
+
+static const dvbpsi_descriptor_t *SDTServiceDescriptors(const void *p_entry)
+{
+    return ((const dvbpsi_sdt_service_t *)p_entry)->p_first_descriptor;
+}
+
+static void SDTServiceHeader(const void *p_entry, uint8_t *p, uint16_t i_length)
+{
+    const dvbpsi_sdt_service_t *p_service = p_entry;
+
+    dvbpsi_set16(p, p_service->i_service_id);
+    p[2] = 0xfc | (p_service->b_eit_schedule ? 0x2 : 0x0)
+                | (p_service->b_eit_present ? 0x01 : 0x00);
+    dvbpsi_set16(p + 3, (p_service->i_running_status & 0x07) << 13
+                      | (p_service->b_free_ca & 0x1) << 12 | (i_length & 0x0fff));
+}
+
+/*****************************************************************************
+ * dvbpsi_sdt_sections_update
+ *****************************************************************************
+ * Generate SDT sections, only encoding again the ones that changed.
+ *****************************************************************************/
+dvbpsi_psi_section_t *dvbpsi_sdt_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_sections_cache_t *p_cache,
+                                                 dvbpsi_sdt_t *p_sdt)
+{
+    dvbpsi_sections_layout_t layout =
+    {
+        .i_table_id = p_sdt->i_table_id,
+        .b_private_indicator = true,
+        .i_extension = p_sdt->i_extension,
+        .i_version = p_sdt->i_version,
+        .b_current_next = p_sdt->b_current_next,
+        .i_max_size = 1024,
+        .p_table = p_sdt,
+        .i_fixed = 3,
+        .pf_fixed = SDTFixed,
+        .p_first_entry = p_sdt->p_first_service,
+        .i_entry_header = 5,
+        .pf_next = SDTServiceNext,
+        .pf_key = SDTServiceKey,
+        .pf_descriptors = SDTServiceDescriptors,
+        .pf_entry_header = SDTServiceHeader,
+    };
+    dvbpsi_psi_section_t *p_sections;
+
+    p_sections = dvbpsi_sections_cache_update(p_dvbpsi, p_cache, &layout);
+    if (p_sections)
+        p_sdt->i_version = dvbpsi_sections_cache_version(p_cache);
+    return p_sections;
+}
@@ -253,6 +253,28 @@ dvbpsi_descriptor_t *dvbpsi_sdt_service_descriptor_add(
  */
 dvbpsi_psi_section_t *dvbpsi_sdt_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sdt_t * p_sdt);
 
+/*****************************************************************************
+ * dvbpsi_sdt_sections_update
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_psi_section_t *dvbpsi_sdt_sections_update(dvbpsi_t *p_dvbpsi,
+            dvbpsi_sections_cache_t *p_cache, dvbpsi_sdt_t *p_sdt)
+ * \brief Incremental SDT generator.
+ *
+ * Same as dvbpsi_sdt_sections_generate() but only the sections carrying
+ * services that changed since the previous call with the same cache are
+ * encoded again. Services are matched on their service_id. The version
+ * handling is the one of dvbpsi_eit_sections_update().
+ * \param p_dvbpsi dvbpsi handle
+ * \param p_cache cache of this sub-table, see dvbpsi_sections_cache_new()
+ * \param p_sdt SDT structure
+ * \return the sections, which belong to the cache and remain valid until
+ * the next call or the deletion of the cache. NULL on error.
+ */
+dvbpsi_psi_section_t *dvbpsi_sdt_sections_update(dvbpsi_t *p_dvbpsi,
+                                                 dvbpsi_sections_cache_t *p_cache,
+                                                 dvbpsi_sdt_t *p_sdt);
+
 #ifdef __cplusplus
 };
 #endif
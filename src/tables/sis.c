@@ -37,6 +37,7 @@
 #include <stdint.h>
 #endif
 
+#include <stddef.h>
 #include <assert.h>
 
 #include "../dvbpsi.h"
@@ -44,6 +45,7 @@
 #include "../psi.h"
 #include "../descriptor.h"
 #include "../demux.h"
+#include "../bitstream_private.h"
 
 #include "sis.h"
 #include "sis_private.h"
@@ -369,20 +371,7 @@ void dvbpsi_sis_sections_gather(dvbpsi_t *p_dvbpsi,
             if (dvbpsi_CheckSIS(p_dvbpsi, p_sis_decoder, p_section))
                 dvbpsi_ReInitSIS(p_sis_decoder, true);
         }
-        else
-        {
-            if(     (p_sis_decoder->b_current_valid)
-                 && (p_sis_decoder->current_sis.i_version == p_section->i_version)
-                 && (p_sis_decoder->current_sis.b_current_next == p_section->b_current_next))
-             {
-                 /* Don't decode since this version is already decoded */
-                 dvbpsi_debug(p_dvbpsi, "SIT decoder",
-                             "ignoring already decoded section %d",
-                             p_section->i_number);
-                 dvbpsi_DeletePSISections(p_section);
-                 return;
-             }
-        }
+        /* a splice_info_section has no version, each one is a new message */
     }
 
     /* Add section to SIS */
@@ -422,83 +411,429 @@ void dvbpsi_sis_sections_gather(dvbpsi_t *p_dvbpsi,
 void dvbpsi_sis_sections_decode(dvbpsi_t* p_dvbpsi, dvbpsi_sis_t* p_sis,
                               dvbpsi_psi_section_t* p_section)
 {
-    uint8_t *p_byte, *p_end;
+    uint8_t *p_byte, *p_desc, *p_end;
 
     while (p_section)
     {
-        for (p_byte = p_section->p_payload_start + 3;
-             p_byte < p_section->p_payload_end; )
+        p_byte = p_section->p_data;
+        /* CRC_32 excluded, and E_CRC_32 when encrypted */
+        p_end = p_section->p_payload_end;
+        if (p_end - p_byte < 16)
         {
-            p_sis->i_protocol_version = p_byte[3];
-            p_sis->b_encrypted_packet = ((p_byte[4] & 0x80) == 0x80);
-            /* NOTE: cannot handle encrypted packet */
-            assert(p_sis->b_encrypted_packet);
-            p_sis->i_encryption_algorithm = ((p_byte[4] & 0x7E) >> 1);
-            p_sis->i_pts_adjustment = ((((uint64_t)p_byte[4] & 0x01) << 32) |
-                                        ((uint64_t)p_byte[5] << 24) |
-                                        ((uint64_t)p_byte[6] << 16) |
-                                        ((uint64_t)p_byte[7] << 8)  |
-                                         (uint64_t)p_byte[8]);
-            p_sis->cw_index = p_byte[9];
-            p_sis->i_splice_command_length = ((p_byte[11] & 0x0F) << 8) | p_byte[12];
-            p_sis->i_splice_command_type = p_byte[13];
-
-            uint32_t i_splice_command_length = p_sis->i_splice_command_length;
-            if (p_sis->i_splice_command_length == 0xfff)
-            {
-                /* FIXME: size 0xfff of splice_command_section is undefined */
-                assert(p_sis->i_splice_command_length != 0xfff);
-            }
+            dvbpsi_error(p_dvbpsi, "SIS decoder", "splice_info_section too short");
+            break;
+        }
+
+        p_sis->i_protocol_version = p_byte[3];
+        p_sis->b_encrypted_packet = ((p_byte[4] & 0x80) == 0x80);
+        p_sis->i_encryption_algorithm = ((p_byte[4] & 0x7E) >> 1);
+        p_sis->i_pts_adjustment = ((((uint64_t)p_byte[4] & 0x01) << 32) |
+                                    ((uint64_t)p_byte[5] << 24) |
+                                    ((uint64_t)p_byte[6] << 16) |
+                                    ((uint64_t)p_byte[7] << 8)  |
+                                     (uint64_t)p_byte[8]);
+        p_sis->cw_index = p_byte[9];
+        p_sis->i_splice_command_length = ((p_byte[11] & 0x0F) << 8) | p_byte[12];
+        p_sis->i_splice_command_type = p_byte[13];
+
+        if (p_sis->b_encrypted_packet)
+        {
+            /* the command and the descriptors cannot be read */
+            p_sis->i_ecrc = ((uint32_t)p_end[-4] << 24) | ((uint32_t)p_end[-3] << 16)
+                          | ((uint32_t)p_end[-2] << 8) | p_end[-1];
+            p_section = p_section->p_next;
+            continue;
+        }
+        if (p_sis->i_splice_command_length == 0xfff)
+        {
+            /* legacy undefined length, see dvbpsi_sis_splice_decode() */
+            dvbpsi_error(p_dvbpsi, "SIS decoder", "undefined splice_command_length");
+            break;
+        }
+
+        /* splice_command(), decoded by dvbpsi_sis_splice_decode() */
+        switch(p_sis->i_splice_command_type)
+        {
+            case 0x00: /* splice_null */
+            case 0x04: /* splice_schedule */
+            case 0x05: /* splice_insert */
+            case 0x06: /* time_signal */
+            case 0x07: /* bandwidth_reservation */
+            case 0xff: /* private_command */
+                break;
+            default:
+                dvbpsi_error(p_dvbpsi, "SIS decoder", "invalid SIS Command found");
+                break;
+        }
+
+        /* Service descriptors */
+        p_desc = p_byte + 14 + p_sis->i_splice_command_length;
+        if (p_desc + 2 > p_end)
+        {
+            dvbpsi_error(p_dvbpsi, "SIS decoder", "splice command too long");
+            break;
+        }
+        p_sis->i_descriptors_length = (p_desc[0] << 8) | p_desc[1];
+        p_desc += 2;
+        if (p_desc + p_sis->i_descriptors_length > p_end)
+        {
+            dvbpsi_error(p_dvbpsi, "SIS decoder", "descriptor loop too long");
+            break;
+        }
+
+        /* the alignment stuffing follows */
+        p_end = p_desc + p_sis->i_descriptors_length;
+        while (p_desc + 2 <= p_end)
+        {
+            uint8_t i_tag = p_desc[0];
+            uint8_t i_length = p_desc[1];
+            if ((i_length <= 254) &&
+                (i_length + 2 <= p_end - p_desc))
+                dvbpsi_sis_descriptor_add(p_sis, i_tag, i_length, p_desc + 2);
+            p_desc += 2 + i_length;
+        }
+
+        p_section = p_section->p_next;
+    }
+}
+
+/*****************************************************************************
+ * Splice information without allocation
+ *****************************************************************************/
+/* Checked reads, past the end they return zeroes and set b_error */
+static inline uint8_t SisGet8(dvbpsi_reader_t *p_reader)
+{
+    return dvbpsi_reader_need(p_reader, 1) ? dvbpsi_read8(p_reader) : 0;
+}
+
+static inline uint16_t SisGet16(dvbpsi_reader_t *p_reader)
+{
+    return dvbpsi_reader_need(p_reader, 2) ? dvbpsi_read16(p_reader) : 0;
+}
+
+static inline uint32_t SisGet32(dvbpsi_reader_t *p_reader)
+{
+    return dvbpsi_reader_need(p_reader, 4) ? dvbpsi_read32(p_reader) : 0;
+}
+
+/* The 33 bits of a 5 bytes field, reserved bits first */
+static inline uint64_t SisGet33(dvbpsi_reader_t *p_reader)
+{
+    if (!dvbpsi_reader_need(p_reader, 5))
+        return 0;
+    return dvbpsi_read40(p_reader) & UINT64_C(0x1ffffffff);
+}
+
+/* splice_time() */
+static void SisSpliceTime(dvbpsi_reader_t *p_reader, bool *pb_specified, uint64_t *pi_pts)
+{
+    if (!dvbpsi_reader_need(p_reader, 1))
+        return;
+    *pb_specified = (p_reader->p[0] & 0x80) != 0;
+    if (*pb_specified)
+        *pi_pts = SisGet33(p_reader);
+    else
+        p_reader->p++;
+}
+
+/* break_duration() */
+static void SisBreakDuration(dvbpsi_reader_t *p_reader, dvbpsi_sis_event_info_t *p_event)
+{
+    if (!dvbpsi_reader_need(p_reader, 5))
+        return;
+    p_event->b_auto_return = (p_reader->p[0] & 0x80) != 0;
+    p_event->i_break_duration = SisGet33(p_reader);
+}
+
+/* An event of splice_insert() or splice_schedule() */
+static void SisEvent(dvbpsi_reader_t *p_reader, dvbpsi_sis_splice_info_t *p_info,
+                     dvbpsi_sis_event_info_t *p_event, bool b_insert)
+{
+    uint8_t i_flags, i_count;
+
+    p_event->i_splice_event_id = SisGet32(p_reader);
+    p_event->b_splice_event_cancel_indicator = (SisGet8(p_reader) & 0x80) != 0;
+    if (p_event->b_splice_event_cancel_indicator)
+        return;
+
+    i_flags = SisGet8(p_reader);
+    p_event->b_out_of_network_indicator = (i_flags & 0x80) != 0;
+    p_event->b_program_splice_flag = (i_flags & 0x40) != 0;
+    p_event->b_duration_flag = (i_flags & 0x20) != 0;
+    p_event->b_splice_immediate_flag = b_insert && (i_flags & 0x10);
+
+    if (p_event->b_program_splice_flag)
+    {
+        if (!b_insert)
+            p_event->i_utc_splice_time = SisGet32(p_reader);
+        else if (!p_event->b_splice_immediate_flag)
+            SisSpliceTime(p_reader, &p_event->b_time_specified_flag, &p_event->i_pts_time);
+    }
+    else
+    {
+        i_count = SisGet8(p_reader);
+        for (unsigned int i = 0; i < i_count && !p_reader->b_error; i++)
+        {
+            dvbpsi_sis_component_info_t component;
+            memset(&component, 0, sizeof(component));
+            component.i_component_tag = SisGet8(p_reader);
+            if (!b_insert)
+                component.i_utc_splice_time = SisGet32(p_reader);
+            else if (!p_event->b_splice_immediate_flag)
+                SisSpliceTime(p_reader, &component.b_time_specified_flag,
+                              &component.i_pts_time);
+            if (p_event->i_component_count < DVBPSI_SIS_MAX_COMPONENTS)
+                p_event->p_components[p_event->i_component_count++] = component;
+            else
+                p_info->b_truncated = true;
+        }
+    }
+
+    if (p_event->b_duration_flag)
+        SisBreakDuration(p_reader, p_event);
+    p_event->i_unique_program_id = SisGet16(p_reader);
+    p_event->i_avail_num = SisGet8(p_reader);
+    p_event->i_avails_expected = SisGet8(p_reader);
+}
+
+/* splice_command() */
+static void SisCommand(dvbpsi_reader_t *p_reader, dvbpsi_sis_splice_info_t *p_info)
+{
+    dvbpsi_sis_event_info_t event;
+    uint8_t i_count;
 
-            /* FIXME: handle splice_command_sections */
-            switch(p_sis->i_splice_command_type)
+    switch (p_info->i_splice_command_type)
+    {
+        case 0x04: /* splice_schedule */
+            i_count = SisGet8(p_reader);
+            for (unsigned int i = 0; i < i_count && !p_reader->b_error; i++)
             {
-                case 0x00: /* splice_null */
-                case 0x04: /* splice_schedule */
-                case 0x05: /* splice_insert */
-                case 0x06: /* time_signal */
-                case 0x07: /* bandwidth_reservation */
-                    break;
-                default:
-                    dvbpsi_error(p_dvbpsi, "SIS decoder", "invalid SIS Command found");
-                    break;
+                memset(&event, 0, sizeof(event));
+                SisEvent(p_reader, p_info, &event, false);
+                if (p_info->i_event_count < DVBPSI_SIS_MAX_EVENTS)
+                    p_info->p_events[p_info->i_event_count++] = event;
+                else
+                    p_info->b_truncated = true;
             }
+            break;
+        case 0x05: /* splice_insert */
+            SisEvent(p_reader, p_info, &p_info->p_events[0], true);
+            p_info->i_event_count = 1;
+            break;
+        case 0x06: /* time_signal */
+            SisSpliceTime(p_reader, &p_info->b_time_specified_flag, &p_info->i_pts_time);
+            break;
+        case 0xff: /* private_command */
+            p_info->i_private_identifier = SisGet32(p_reader);
+            /* private bytes until the end of the command */
+            p_reader->p = p_reader->p_end;
+            break;
+        default: /* splice_null, bandwidth_reservation, reserved */
+            break;
+    }
+}
 
-            /* Service descriptors */
-            uint8_t *p_desc = p_byte + 13 + i_splice_command_length;
-            p_sis->i_descriptors_length = (p_desc[0] << 8) | p_desc[1];
+/* segmentation_descriptor(), from the identifier */
+static void SisSegmentation(dvbpsi_reader_t *p_reader, dvbpsi_sis_segmentation_info_t *p_seg,
+                            dvbpsi_sis_splice_info_t *p_info)
+{
+    uint8_t i_flags, i_count;
 
-            p_desc += 1;
-            p_end = p_desc + p_sis->i_descriptors_length;
-            if (p_end > p_section->p_payload_end) break;
+    p_seg->i_identifier = SisGet32(p_reader);
+    p_seg->i_event_id = SisGet32(p_reader);
+    p_seg->b_cancel_indicator = (SisGet8(p_reader) & 0x80) != 0;
+    if (p_seg->b_cancel_indicator)
+        return;
 
-            while (p_desc + 2 <= p_end)
+    i_flags = SisGet8(p_reader);
+    p_seg->b_program_segmentation_flag = (i_flags & 0x80) != 0;
+    p_seg->b_duration_flag = (i_flags & 0x40) != 0;
+    p_seg->b_delivery_not_restricted_flag = (i_flags & 0x20) != 0;
+    if (!p_seg->b_delivery_not_restricted_flag)
+    {
+        p_seg->b_web_delivery_allowed_flag = (i_flags & 0x10) != 0;
+        p_seg->b_no_regional_blackout_flag = (i_flags & 0x08) != 0;
+        p_seg->b_archive_allowed_flag = (i_flags & 0x04) != 0;
+        p_seg->i_device_restrictions = i_flags & 0x03;
+    }
+
+    if (!p_seg->b_program_segmentation_flag)
+    {
+        i_count = SisGet8(p_reader);
+        for (unsigned int i = 0; i < i_count && !p_reader->b_error; i++)
+        {
+            uint8_t i_tag = SisGet8(p_reader);
+            uint64_t i_offset = SisGet33(p_reader);
+            if (p_seg->i_component_count < DVBPSI_SIS_MAX_COMPONENTS)
             {
-                uint8_t i_tag = p_desc[0];
-                uint8_t i_length = p_desc[1];
-                if ((i_length <= 254) &&
-                    (i_length + 2 <= p_end - p_desc))
-                    dvbpsi_sis_descriptor_add(p_sis, i_tag, i_length, p_desc + 2);
-                p_desc += 2 + i_length;
+                dvbpsi_sis_component_info_t *p_component =
+                                    &p_seg->p_components[p_seg->i_component_count++];
+                p_component->i_component_tag = i_tag;
+                p_component->i_pts_time = i_offset;
             }
+            else
+                p_info->b_truncated = true;
+        }
+    }
+
+    if (p_seg->b_duration_flag)
+    {
+        uint8_t i_high = SisGet8(p_reader);
+        p_seg->i_duration = (uint64_t)i_high << 32 | SisGet32(p_reader);
+    }
 
-            if (p_sis->b_encrypted_packet)
+    p_seg->i_upid_type = SisGet8(p_reader);
+    p_seg->i_upid_length = SisGet8(p_reader);
+    if (dvbpsi_reader_need(p_reader, p_seg->i_upid_length))
+    {
+        memcpy(p_seg->p_upid, p_reader->p, p_seg->i_upid_length);
+        dvbpsi_reader_skip(p_reader, p_seg->i_upid_length);
+    }
+    p_seg->i_type_id = SisGet8(p_reader);
+    p_seg->i_segment_num = SisGet8(p_reader);
+    p_seg->i_segments_expected = SisGet8(p_reader);
+
+    /* sub segments of the placement opportunities and breaks, optional */
+    switch (p_seg->i_type_id)
+    {
+        case 0x34: case 0x36: case 0x38: case 0x3a: case 0x44: case 0x46:
+            if (p_reader->p_end - p_reader->p >= 2)
             {
-                /* FIXME: Currently ignored */
-                /* Calculate crc32 over decoded
-                 * p_sis->i_splice_command_type till p_sis->i_ecrc,
-                 * the result should be exactly p_sis->i_ecrc and indicates
-                 * a successfull decryption.
-                 */
-                p_desc += 4; /* E CRC 32 */
+                p_seg->b_sub_segments = true;
+                p_seg->i_sub_segment_num = SisGet8(p_reader);
+                p_seg->i_sub_segments_expected = SisGet8(p_reader);
             }
+            break;
+        default:
+            break;
+    }
+}
 
-            /* point to next section */
-            p_byte = p_desc + 4 /* CRC 32 */;
-        }
+/*****************************************************************************
+ * dvbpsi_sis_splice_decode
+ *****************************************************************************/
+bool dvbpsi_sis_splice_decode(const uint8_t *p_data, size_t i_size,
+                              dvbpsi_sis_splice_info_t *p_info)
+{
+    const uint8_t *p_end = p_data + i_size - 4;     /* CRC_32 */
+    dvbpsi_reader_t reader;
+    size_t i_command_length;
+    uint16_t i_loop_length;
 
-        p_section = p_section->p_next;
+    if (i_size < 3 + 17 || p_data[0] != 0xfc
+     || i_size != 3 + (size_t)(dvbpsi_get16(p_data + 1) & 0x0fff))
+        return false;
+
+    /* the arrays are cleared as they are filled */
+    memset(p_info, 0, offsetof(dvbpsi_sis_splice_info_t, p_events));
+    p_info->i_private_identifier = 0;
+    p_info->i_segmentation_count = 0;
+    p_info->b_truncated = false;
+
+    p_info->i_protocol_version = p_data[3];
+    p_info->b_encrypted_packet = (p_data[4] & 0x80) != 0;
+    p_info->i_encryption_algorithm = (p_data[4] & 0x7e) >> 1;
+    p_info->i_pts_adjustment = dvbpsi_get40(p_data + 4) & UINT64_C(0x1ffffffff);
+    p_info->i_cw_index = p_data[9];
+    p_info->i_tier = dvbpsi_get16(p_data + 10) >> 4;
+    i_command_length = dvbpsi_get16(p_data + 11) & 0x0fff;
+    p_info->i_splice_command_type = p_data[13];
+    if (p_info->b_encrypted_packet)
+        return true;
+
+    /* the legacy 0xfff length is found by decoding the command */
+    dvbpsi_reader_init(&reader, p_data + 14, p_end);
+    if (i_command_length != 0xfff)
+    {
+        if (i_command_length > dvbpsi_reader_left(&reader))
+            return false;
+        reader.p_end = reader.p + i_command_length;
     }
+    memset(p_info->p_events, 0, sizeof(p_info->p_events[0]));
+    SisCommand(&reader, p_info);
+    if (reader.b_error)
+        return false;
+    if (i_command_length != 0xfff)
+        reader.p = reader.p_end;
+
+    /* splice_descriptor() loop, then the alignment stuffing */
+    reader.p_end = p_end;
+    i_loop_length = SisGet16(&reader);
+    if (reader.b_error || i_loop_length > dvbpsi_reader_left(&reader))
+        return false;
+    reader.p_end = reader.p + i_loop_length;
+    while (dvbpsi_reader_left(&reader) >= 2)
+    {
+        const uint8_t i_tag = dvbpsi_read8(&reader);
+        const uint8_t i_length = dvbpsi_read8(&reader);
+        dvbpsi_reader_t descriptor;
+
+        if (i_length > dvbpsi_reader_left(&reader))
+            return false;
+        dvbpsi_reader_sub(&reader, &descriptor, i_length);
+
+        if (i_tag != 0x02)
+            continue;
+        if (p_info->i_segmentation_count == DVBPSI_SIS_MAX_SEGMENTATIONS)
+        {
+            p_info->b_truncated = true;
+            continue;
+        }
+        dvbpsi_sis_segmentation_info_t *p_seg =
+                                &p_info->p_segmentations[p_info->i_segmentation_count];
+        memset(p_seg, 0, sizeof(dvbpsi_sis_segmentation_info_t));
+        SisSegmentation(&descriptor, p_seg, p_info);
+        if (!descriptor.b_error)
+            p_info->i_segmentation_count++;
+    }
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_sis_splice_attach
+ *****************************************************************************/
+static void dvbpsi_sis_splice_gather(dvbpsi_t *p_dvbpsi, dvbpsi_psi_section_t *p_section)
+{
+    dvbpsi_sis_splice_decoder_t *p_decoder = (dvbpsi_sis_splice_decoder_t *)p_dvbpsi->p_decoder;
+    dvbpsi_sis_splice_info_t info;
+
+    /* the CRC was checked, a section is a whole table */
+    if (dvbpsi_sis_splice_decode(p_section->p_data, 3 + p_section->i_length, &info))
+        p_decoder->pf_callback(p_decoder->p_cb_data, &info);
+    else
+        dvbpsi_error(p_dvbpsi, "SIS decoder", "invalid splice_info_section");
+    dvbpsi_DeletePSISections(p_section);
+}
+
+bool dvbpsi_sis_splice_attach(dvbpsi_t *p_dvbpsi, dvbpsi_sis_splice_callback pf_callback,
+                              void *p_cb_data)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder == NULL);
+
+    dvbpsi_sis_splice_decoder_t *p_decoder;
+    p_decoder = (dvbpsi_sis_splice_decoder_t *) dvbpsi_decoder_new(&dvbpsi_sis_splice_gather,
+                                            4096, true, sizeof(dvbpsi_sis_splice_decoder_t));
+    if (p_decoder == NULL)
+        return false;
+
+    p_decoder->pf_callback = pf_callback;
+    p_decoder->p_cb_data = p_cb_data;
+
+    p_dvbpsi->p_decoder = DVBPSI_DECODER(p_decoder);
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_sis_splice_detach
+ *****************************************************************************/
+void dvbpsi_sis_splice_detach(dvbpsi_t *p_dvbpsi)
+{
+    assert(p_dvbpsi);
+    assert(p_dvbpsi->p_decoder);
+
+    dvbpsi_decoder_delete(p_dvbpsi->p_decoder);
+    p_dvbpsi->p_decoder = NULL;
 }
 
 /*****************************************************************************
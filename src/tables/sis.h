@@ -463,6 +463,230 @@ dvbpsi_descriptor_t *dvbpsi_sis_descriptor_add(dvbpsi_sis_t *p_sis,
  */
 dvbpsi_psi_section_t *dvbpsi_sis_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_sis_t * p_sis);
 
+/*****************************************************************************
+ * Splice information without allocation
+ *****************************************************************************/
+/*!
+ * \def DVBPSI_SIS_MAX_COMPONENTS
+ * \brief Components kept per event or segmentation, the next ones are
+ * skipped.
+ */
+#define DVBPSI_SIS_MAX_COMPONENTS       16
+/*!
+ * \def DVBPSI_SIS_MAX_EVENTS
+ * \brief Events of a splice_schedule() kept, the next ones are skipped.
+ */
+#define DVBPSI_SIS_MAX_EVENTS           8
+/*!
+ * \def DVBPSI_SIS_MAX_SEGMENTATIONS
+ * \brief Segmentation descriptors kept, the next ones are skipped.
+ */
+#define DVBPSI_SIS_MAX_SEGMENTATIONS    8
+
+/*!
+ * \struct dvbpsi_sis_component_info_s
+ * \brief A component of a splice event or of a segmentation.
+ */
+/*!
+ * \typedef struct dvbpsi_sis_component_info_s dvbpsi_sis_component_info_t
+ * \brief dvbpsi_sis_component_info_t type definition.
+ */
+typedef struct dvbpsi_sis_component_info_s
+{
+    uint8_t     i_component_tag;        /*!< component_tag */
+    bool        b_time_specified_flag;  /*!< splice_insert(): i_pts_time is
+                                             set */
+    uint64_t    i_pts_time;             /*!< splice_insert(): pts_time,
+                                             segmentation: pts_offset */
+    uint32_t    i_utc_splice_time;      /*!< splice_schedule():
+                                             utc_splice_time */
+} dvbpsi_sis_component_info_t;
+
+/*!
+ * \struct dvbpsi_sis_event_info_s
+ * \brief The splice event of a splice_insert(), or an event of a
+ * splice_schedule().
+ */
+/*!
+ * \typedef struct dvbpsi_sis_event_info_s dvbpsi_sis_event_info_t
+ * \brief dvbpsi_sis_event_info_t type definition.
+ */
+typedef struct dvbpsi_sis_event_info_s
+{
+    uint32_t    i_splice_event_id;               /*!< splice_event_id */
+    bool        b_splice_event_cancel_indicator; /*!< the event is cancelled,
+                                                      the next fields are not
+                                                      set */
+    bool        b_out_of_network_indicator;      /*!< out_of_network_indicator */
+    bool        b_program_splice_flag;           /*!< program_splice_flag */
+    bool        b_duration_flag;                 /*!< duration_flag */
+    bool        b_splice_immediate_flag;         /*!< splice_insert():
+                                                      splice_immediate_flag */
+
+    /* program splice */
+    bool        b_time_specified_flag;  /*!< splice_insert(): i_pts_time is
+                                             set */
+    uint64_t    i_pts_time;             /*!< splice_insert(): pts_time, without
+                                             pts_adjustment */
+    uint32_t    i_utc_splice_time;      /*!< splice_schedule():
+                                             utc_splice_time */
+
+    /* component splice */
+    uint8_t     i_component_count;      /*!< number of components in
+                                             p_components */
+    dvbpsi_sis_component_info_t p_components[DVBPSI_SIS_MAX_COMPONENTS];
+                                        /*!< the components */
+
+    /* break_duration() */
+    bool        b_auto_return;          /*!< auto_return */
+    uint64_t    i_break_duration;       /*!< duration, 90 kHz ticks */
+
+    uint16_t    i_unique_program_id;    /*!< unique_program_id */
+    uint8_t     i_avail_num;            /*!< avail_num */
+    uint8_t     i_avails_expected;      /*!< avails_expected */
+} dvbpsi_sis_event_info_t;
+
+/*!
+ * \struct dvbpsi_sis_segmentation_info_s
+ * \brief A segmentation_descriptor() of the splice information.
+ */
+/*!
+ * \typedef struct dvbpsi_sis_segmentation_info_s dvbpsi_sis_segmentation_info_t
+ * \brief dvbpsi_sis_segmentation_info_t type definition.
+ */
+typedef struct dvbpsi_sis_segmentation_info_s
+{
+    uint32_t    i_identifier;           /*!< identifier, "CUEI" */
+    uint32_t    i_event_id;             /*!< segmentation_event_id */
+    bool        b_cancel_indicator;     /*!< segmentation_event_cancel_indicator,
+                                             the next fields are not set */
+    bool        b_program_segmentation_flag;    /*!< program_segmentation_flag */
+    bool        b_duration_flag;        /*!< segmentation_duration_flag */
+    bool        b_delivery_not_restricted_flag; /*!< delivery_not_restricted_flag */
+    bool        b_web_delivery_allowed_flag;    /*!< web_delivery_allowed_flag */
+    bool        b_no_regional_blackout_flag;    /*!< no_regional_blackout_flag */
+    bool        b_archive_allowed_flag; /*!< archive_allowed_flag */
+    uint8_t     i_device_restrictions;  /*!< device_restrictions */
+
+    uint8_t     i_component_count;      /*!< number of components in
+                                             p_components */
+    dvbpsi_sis_component_info_t p_components[DVBPSI_SIS_MAX_COMPONENTS];
+                                        /*!< the components and their
+                                             pts_offset */
+
+    uint64_t    i_duration;             /*!< segmentation_duration, 90 kHz
+                                             ticks */
+    uint8_t     i_upid_type;            /*!< segmentation_upid_type */
+    uint8_t     i_upid_length;          /*!< segmentation_upid_length */
+    uint8_t     p_upid[255];            /*!< segmentation_upid() */
+    uint8_t     i_type_id;              /*!< segmentation_type_id */
+    uint8_t     i_segment_num;          /*!< segment_num */
+    uint8_t     i_segments_expected;    /*!< segments_expected */
+    bool        b_sub_segments;         /*!< the next fields are set */
+    uint8_t     i_sub_segment_num;      /*!< sub_segment_num */
+    uint8_t     i_sub_segments_expected;/*!< sub_segments_expected */
+} dvbpsi_sis_segmentation_info_t;
+
+/*!
+ * \struct dvbpsi_sis_splice_info_s
+ * \brief A splice_info_section, decoded without allocation.
+ *
+ * All the fields are in the structure, it can be copied. The PTS are as
+ * in the section: add i_pts_adjustment modulo 2^33 to get the PTS of the
+ * program.
+ */
+/*!
+ * \typedef struct dvbpsi_sis_splice_info_s dvbpsi_sis_splice_info_t
+ * \brief dvbpsi_sis_splice_info_t type definition.
+ */
+typedef struct dvbpsi_sis_splice_info_s
+{
+    uint8_t     i_protocol_version;     /*!< protocol_version */
+    bool        b_encrypted_packet;     /*!< encrypted_packet, the command and
+                                             the descriptors are not decoded */
+    uint8_t     i_encryption_algorithm; /*!< encryption_algorithm */
+    uint64_t    i_pts_adjustment;       /*!< pts_adjustment */
+    uint8_t     i_cw_index;             /*!< cw_index */
+    uint16_t    i_tier;                 /*!< tier */
+    uint8_t     i_splice_command_type;  /*!< splice_command_type */
+
+    /* time_signal() */
+    bool        b_time_specified_flag;  /*!< i_pts_time is set */
+    uint64_t    i_pts_time;             /*!< pts_time */
+
+    /* splice_insert(), splice_schedule() */
+    uint8_t     i_event_count;          /*!< number of events in p_events, 1
+                                             for splice_insert() */
+    dvbpsi_sis_event_info_t p_events[DVBPSI_SIS_MAX_EVENTS]; /*!< events */
+
+    /* private_command() */
+    uint32_t    i_private_identifier;   /*!< identifier */
+
+    /* segmentation_descriptor() */
+    uint8_t     i_segmentation_count;   /*!< number of segmentations in
+                                             p_segmentations */
+    dvbpsi_sis_segmentation_info_t p_segmentations[DVBPSI_SIS_MAX_SEGMENTATIONS];
+                                        /*!< segmentation descriptors */
+
+    bool        b_truncated;            /*!< events, components or
+                                             segmentations were skipped */
+} dvbpsi_sis_splice_info_t;
+
+/*****************************************************************************
+ * dvbpsi_sis_splice_decode
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_sis_splice_decode(const uint8_t *p_data, size_t i_size,
+                                     dvbpsi_sis_splice_info_t *p_info)
+ * \brief Decode a splice_info_section, its command and its segmentation
+ * descriptors, without allocation. The CRC is not checked.
+ * \param p_data the section, from its table_id
+ * \param i_size size of the section
+ * \param p_info filled with the decoded section
+ * \return false when the section is not a valid splice_info_section
+ */
+bool dvbpsi_sis_splice_decode(const uint8_t *p_data, size_t i_size,
+                              dvbpsi_sis_splice_info_t *p_info);
+
+/*****************************************************************************
+ * dvbpsi_sis_splice_callback
+ *****************************************************************************/
+/*!
+ * \typedef void (* dvbpsi_sis_splice_callback)(void *p_cb_data,
+                        const dvbpsi_sis_splice_info_t *p_info)
+ * \brief Callback type definition, see dvbpsi_sis_splice_attach().
+ */
+typedef void (* dvbpsi_sis_splice_callback)(void *p_cb_data,
+                                            const dvbpsi_sis_splice_info_t *p_info);
+
+/*****************************************************************************
+ * dvbpsi_sis_splice_attach
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_sis_splice_attach(dvbpsi_t *p_dvbpsi,
+            dvbpsi_sis_splice_callback pf_callback, void *p_cb_data)
+ * \brief Attach a splice information decoder to the handle of the SCTE 35
+ * PID. Each section is decoded on the stack as soon as its CRC is checked,
+ * and given to the callback; repeated sections are given again.
+ * \param p_dvbpsi handle without decoder
+ * \param pf_callback called with each splice_info_section
+ * \param p_cb_data private data given in argument to the callback
+ * \return true on success, false on failure
+ */
+bool dvbpsi_sis_splice_attach(dvbpsi_t *p_dvbpsi, dvbpsi_sis_splice_callback pf_callback,
+                              void *p_cb_data);
+
+/*****************************************************************************
+ * dvbpsi_sis_splice_detach
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_sis_splice_detach(dvbpsi_t *p_dvbpsi)
+ * \brief Destroy a splice information decoder.
+ * \param p_dvbpsi handle of the decoder
+ * \return nothing.
+ */
+void dvbpsi_sis_splice_detach(dvbpsi_t *p_dvbpsi);
+
 #ifdef __cplusplus
 };
 #endif
@@ -470,4 +694,3 @@ dvbpsi_psi_section_t *dvbpsi_sis_sections_generate(dvbpsi_t *p_dvbpsi, dvbpsi_si
 #else
 #error "Multiple inclusions of sis.h"
 #endif
-
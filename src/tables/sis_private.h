@@ -45,6 +45,20 @@ typedef struct dvbpsi_sis_decoder_s
 
 } dvbpsi_sis_decoder_t;
 
+/*****************************************************************************
+ * dvbpsi_sis_splice_decoder_t
+ *****************************************************************************
+ * Splice information decoder, see dvbpsi_sis_splice_attach().
+ *****************************************************************************/
+typedef struct dvbpsi_sis_splice_decoder_s
+{
+    DVBPSI_DECODER_COMMON
+
+    dvbpsi_sis_splice_callback    pf_callback;
+    void *                        p_cb_data;
+
+} dvbpsi_sis_splice_decoder_t;
+
 /*****************************************************************************
  * dvbpsi_sis_sections_gather
  *****************************************************************************
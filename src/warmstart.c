@@ -0,0 +1,447 @@
+/*****************************************************************************
+ * warmstart.c: warm start of the PSI/SI decoders from a state file
+ *----------------------------------------------------------------------------
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *----------------------------------------------------------------------------
+ *
+ *****************************************************************************/
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if defined(HAVE_INTTYPES_H)
+#include <inttypes.h>
+#elif defined(HAVE_STDINT_H)
+#include <stdint.h>
+#endif
+
+#include <assert.h>
+
+#include "dvbpsi.h"
+#include "psi.h"
+#include "warmstart.h"
+
+/* File format, big endian:
+ *   "DVBPSIWS", format version (1 byte)
+ *   for each section: PID (2 bytes), size (2 bytes), time the subtable was
+ *   last seen (8 bytes, two's complement), the section
+ *   0xffff
+ */
+static const uint8_t ws_magic[8] = { 'D', 'V', 'B', 'P', 'S', 'I', 'W', 'S' };
+#define WS_FORMAT_VERSION   2
+#define WS_END              0xffff
+#define WS_BUCKETS          4096
+#define WS_MAX_SECTION_SIZE 4096
+
+typedef struct ws_section_s
+{
+    uint16_t                i_size;
+    uint8_t                 p_data[];
+} ws_section_t;
+
+/* A subtable is identified by its PID, table_id, table_id_extension and,
+ * for the SDT and EIT, the ids following the header */
+typedef struct ws_subtable_s
+{
+    uint16_t                i_pid;
+    uint8_t                 i_table_id;
+    uint16_t                i_extension;
+    uint32_t                i_extra;
+
+    uint8_t                 i_version;
+    int64_t                 i_seen;         /* time last recorded */
+    unsigned int            i_sections;     /* size of pp_sections */
+    ws_section_t          **pp_sections;    /* by section_number */
+
+    struct ws_subtable_s   *p_next;
+} ws_subtable_t;
+
+typedef struct ws_tap_s
+{
+    dvbpsi_warmstart_t     *p_ws;
+    dvbpsi_t               *p_dvbpsi;
+    uint16_t                i_pid;
+    struct ws_tap_s        *p_next;
+} ws_tap_t;
+
+struct dvbpsi_warmstart_s
+{
+    ws_subtable_t          *pp_buckets[WS_BUCKETS];
+    ws_tap_t               *p_taps;
+
+    int64_t                 i_now;
+    int64_t                 i_max_age;      /* 0 to keep all the subtables */
+};
+
+static size_t WarmstartHash(uint16_t i_pid, uint8_t i_table_id, uint16_t i_extension,
+                            uint32_t i_extra)
+{
+    uint32_t i_hash = ((uint32_t)i_pid << 16 | i_table_id) * UINT32_C(0x9e3779b1);
+    i_hash ^= ((uint32_t)i_extension << 16 ^ i_extra) * UINT32_C(0x85ebca6b);
+    return (i_hash >> 16) & (WS_BUCKETS - 1);
+}
+
+/* A subtable not seen for longer than the maximum age */
+static bool WarmstartStale(const dvbpsi_warmstart_t *p_ws, int64_t i_seen)
+{
+    return p_ws->i_max_age > 0 && p_ws->i_now - i_seen > p_ws->i_max_age;
+}
+
+static void SubtableClear(ws_subtable_t *p_subtable)
+{
+    for (unsigned int i = 0; i < p_subtable->i_sections; i++)
+    {
+        free(p_subtable->pp_sections[i]);
+        p_subtable->pp_sections[i] = NULL;
+    }
+}
+
+/* Record a section given from its table_id, which is at least 12 bytes long
+ * and has the section_syntax_indicator set, seen at i_seen. A loaded section
+ * does not replace a more recent version of its subtable. */
+static bool WarmstartRecord(dvbpsi_warmstart_t *p_ws, uint16_t i_pid,
+                            const uint8_t *p_data, uint16_t i_size,
+                            int64_t i_seen, bool b_load)
+{
+    const uint8_t i_table_id = p_data[0];
+    const uint16_t i_extension = (uint16_t)p_data[3] << 8 | p_data[4];
+    const uint8_t i_version = (p_data[5] & 0x3e) >> 1;
+    const uint8_t i_number = p_data[6];
+    uint32_t i_extra = 0;
+    ws_subtable_t **pp_bucket, *p_subtable;
+    ws_section_t *p_section;
+
+    /* original_network_id of the SDT, transport_stream_id and
+     * original_network_id of the EIT */
+    if ((i_table_id == 0x42 || i_table_id == 0x46) && i_size >= 14)
+        i_extra = (uint32_t)p_data[8] << 8 | p_data[9];
+    else if (i_table_id >= 0x4e && i_table_id <= 0x6f && i_size >= 16)
+        i_extra = (uint32_t)p_data[8] << 24 | (uint32_t)p_data[9] << 16
+                | (uint32_t)p_data[10] << 8 | p_data[11];
+
+    pp_bucket = &p_ws->pp_buckets[WarmstartHash(i_pid, i_table_id, i_extension, i_extra)];
+    for (p_subtable = *pp_bucket; p_subtable; p_subtable = p_subtable->p_next)
+    {
+        if (p_subtable->i_pid == i_pid && p_subtable->i_table_id == i_table_id
+         && p_subtable->i_extension == i_extension && p_subtable->i_extra == i_extra)
+            break;
+    }
+    if (!p_subtable)
+    {
+        p_subtable = calloc(1, sizeof(ws_subtable_t));
+        if (!p_subtable)
+            return false;
+        p_subtable->i_pid = i_pid;
+        p_subtable->i_table_id = i_table_id;
+        p_subtable->i_extension = i_extension;
+        p_subtable->i_extra = i_extra;
+        p_subtable->i_version = i_version;
+        p_subtable->i_seen = i_seen;
+        p_subtable->p_next = *pp_bucket;
+        *pp_bucket = p_subtable;
+    }
+    else if (p_subtable->i_version != i_version)
+    {
+        if (b_load && p_subtable->i_seen >= i_seen)
+            return true;
+        /* a new version replaces all the sections */
+        SubtableClear(p_subtable);
+        p_subtable->i_version = i_version;
+    }
+    if (i_seen > p_subtable->i_seen)
+        p_subtable->i_seen = i_seen;
+
+    if (i_number >= p_subtable->i_sections)
+    {
+        unsigned int i_sections = (unsigned int)i_number + 1;
+        ws_section_t **pp_sections = realloc(p_subtable->pp_sections,
+                                             i_sections * sizeof(ws_section_t *));
+        if (!pp_sections)
+            return false;
+        memset(pp_sections + p_subtable->i_sections, 0,
+               (i_sections - p_subtable->i_sections) * sizeof(ws_section_t *));
+        p_subtable->pp_sections = pp_sections;
+        p_subtable->i_sections = i_sections;
+    }
+
+    /* a repetition, as far as the CRC tells */
+    p_section = p_subtable->pp_sections[i_number];
+    if (p_section && p_section->i_size == i_size
+     && !memcmp(p_section->p_data + i_size - 4, p_data + i_size - 4, 4))
+        return true;
+
+    if (!p_section || p_section->i_size != i_size)
+    {
+        p_section = realloc(p_section, sizeof(ws_section_t) + i_size);
+        if (!p_section)
+            return false;
+        p_subtable->pp_sections[i_number] = p_section;
+    }
+    p_section->i_size = i_size;
+    memcpy(p_section->p_data, p_data, i_size);
+    return true;
+}
+
+static void WarmstartTap(dvbpsi_t *p_dvbpsi, const dvbpsi_psi_section_t *p_section,
+                         void *p_cb_data)
+{
+    ws_tap_t *p_tap = p_cb_data;
+    const uint16_t i_size = 3 + p_section->i_length;
+    (void)p_dvbpsi;
+
+    if (!p_section->b_syntax_indicator || !p_section->b_current_next || i_size < 12)
+        return;
+    WarmstartRecord(p_tap->p_ws, p_tap->i_pid, p_section->p_data, i_size,
+                    p_tap->p_ws->i_now, false);
+}
+
+/*****************************************************************************
+ * dvbpsi_warmstart_new
+ *****************************************************************************/
+dvbpsi_warmstart_t *dvbpsi_warmstart_new(void)
+{
+    return calloc(1, sizeof(dvbpsi_warmstart_t));
+}
+
+/*****************************************************************************
+ * dvbpsi_warmstart_delete
+ *****************************************************************************/
+void dvbpsi_warmstart_delete(dvbpsi_warmstart_t *p_ws)
+{
+    if (!p_ws)
+        return;
+
+    while (p_ws->p_taps)
+        dvbpsi_warmstart_detach(p_ws, p_ws->p_taps->p_dvbpsi);
+
+    for (size_t i = 0; i < WS_BUCKETS; i++)
+    {
+        ws_subtable_t *p_subtable = p_ws->pp_buckets[i];
+        while (p_subtable)
+        {
+            ws_subtable_t *p_next = p_subtable->p_next;
+            SubtableClear(p_subtable);
+            free(p_subtable->pp_sections);
+            free(p_subtable);
+            p_subtable = p_next;
+        }
+    }
+    free(p_ws);
+}
+
+/*****************************************************************************
+ * dvbpsi_warmstart_attach
+ *****************************************************************************/
+bool dvbpsi_warmstart_attach(dvbpsi_warmstart_t *p_ws, dvbpsi_t *p_dvbpsi, uint16_t i_pid)
+{
+    ws_tap_t *p_tap = malloc(sizeof(ws_tap_t));
+    if (!p_tap)
+        return false;
+
+    dvbpsi_warmstart_detach(p_ws, p_dvbpsi);
+    p_tap->p_ws = p_ws;
+    p_tap->p_dvbpsi = p_dvbpsi;
+    p_tap->i_pid = i_pid;
+    if (!dvbpsi_section_tap_add(p_dvbpsi, WarmstartTap, p_tap))
+    {
+        free(p_tap);
+        return false;
+    }
+    p_tap->p_next = p_ws->p_taps;
+    p_ws->p_taps = p_tap;
+    return true;
+}
+
+/*****************************************************************************
+ * dvbpsi_warmstart_detach
+ *****************************************************************************/
+void dvbpsi_warmstart_detach(dvbpsi_warmstart_t *p_ws, dvbpsi_t *p_dvbpsi)
+{
+    for (ws_tap_t **pp_tap = &p_ws->p_taps; *pp_tap; pp_tap = &(*pp_tap)->p_next)
+    {
+        ws_tap_t *p_tap = *pp_tap;
+        if (p_tap->p_dvbpsi != p_dvbpsi)
+            continue;
+        dvbpsi_section_tap_remove(p_dvbpsi, WarmstartTap, p_tap);
+        *pp_tap = p_tap->p_next;
+        free(p_tap);
+        return;
+    }
+}
+
+/*****************************************************************************
+ * dvbpsi_warmstart_set_time
+ *****************************************************************************/
+void dvbpsi_warmstart_set_time(dvbpsi_warmstart_t *p_ws, int64_t i_now, int64_t i_max_age)
+{
+    p_ws->i_now = i_now;
+    p_ws->i_max_age = i_max_age;
+}
+
+/*****************************************************************************
+ * dvbpsi_warmstart_save
+ *****************************************************************************/
+bool dvbpsi_warmstart_save(dvbpsi_warmstart_t *p_ws, const char *psz_file)
+{
+    size_t i_len = strlen(psz_file);
+    char *psz_tmp = malloc(i_len + sizeof(".tmp"));
+    bool b_ok = true;
+    FILE *p_file;
+
+    if (!psz_tmp)
+        return false;
+    memcpy(psz_tmp, psz_file, i_len);
+    memcpy(psz_tmp + i_len, ".tmp", sizeof(".tmp"));
+
+    p_file = fopen(psz_tmp, "wb");
+    if (!p_file)
+    {
+        free(psz_tmp);
+        return false;
+    }
+
+    b_ok = fwrite(ws_magic, sizeof(ws_magic), 1, p_file) == 1
+        && fputc(WS_FORMAT_VERSION, p_file) != EOF;
+    for (size_t i = 0; b_ok && i < WS_BUCKETS; i++)
+    {
+        for (const ws_subtable_t *p_subtable = p_ws->pp_buckets[i];
+             b_ok && p_subtable; p_subtable = p_subtable->p_next)
+        {
+            if (WarmstartStale(p_ws, p_subtable->i_seen))
+                continue;
+            for (unsigned int j = 0; b_ok && j < p_subtable->i_sections; j++)
+            {
+                const ws_section_t *p_section = p_subtable->pp_sections[j];
+                uint8_t header[12];
+                if (!p_section)
+                    continue;
+                header[0] = p_subtable->i_pid >> 8;
+                header[1] = p_subtable->i_pid & 0xff;
+                header[2] = p_section->i_size >> 8;
+                header[3] = p_section->i_size & 0xff;
+                for (int k = 0; k < 8; k++)
+                    header[4 + k] = (uint64_t)p_subtable->i_seen >> (56 - 8 * k);
+                b_ok = fwrite(header, sizeof(header), 1, p_file) == 1
+                    && fwrite(p_section->p_data, p_section->i_size, 1, p_file) == 1;
+            }
+        }
+    }
+    b_ok = b_ok && fputc(WS_END >> 8, p_file) != EOF && fputc(WS_END & 0xff, p_file) != EOF;
+    b_ok = (fclose(p_file) == 0) && b_ok;
+
+    if (b_ok && rename(psz_tmp, psz_file) != 0)
+    {
+        /* rename() does not replace an existing file everywhere */
+        remove(psz_file);
+        b_ok = rename(psz_tmp, psz_file) == 0;
+    }
+    if (!b_ok)
+        remove(psz_tmp);
+    free(psz_tmp);
+    return b_ok;
+}
+
+/*****************************************************************************
+ * dvbpsi_warmstart_load
+ *****************************************************************************/
+bool dvbpsi_warmstart_load(dvbpsi_warmstart_t *p_ws, const char *psz_file)
+{
+    uint8_t p_buffer[WS_MAX_SECTION_SIZE];
+    uint8_t magic[sizeof(ws_magic)];
+    bool b_ok = false;
+    FILE *p_file = fopen(psz_file, "rb");
+
+    if (!p_file)
+        return false;
+
+    if (fread(magic, sizeof(magic), 1, p_file) != 1
+     || memcmp(magic, ws_magic, sizeof(magic))
+     || fgetc(p_file) != WS_FORMAT_VERSION)
+        goto out;
+
+    for (;;)
+    {
+        uint8_t header[12];
+        uint16_t i_pid, i_size;
+        uint64_t i_seen = 0;
+
+        if (fread(header, 2, 1, p_file) != 1)
+            break;
+        i_pid = (uint16_t)header[0] << 8 | header[1];
+        if (i_pid == WS_END)
+        {
+            b_ok = true;
+            break;
+        }
+        if (fread(header + 2, 10, 1, p_file) != 1)
+            break;
+        i_size = (uint16_t)header[2] << 8 | header[3];
+        for (int k = 0; k < 8; k++)
+            i_seen = i_seen << 8 | header[4 + k];
+        if (i_pid >= 0x2000 || i_size < 12 || i_size > WS_MAX_SECTION_SIZE
+         || fread(p_buffer, i_size, 1, p_file) != 1)
+            break;
+        /* only sections the recorder may have written */
+        if ((size_t)i_size != 3 + ((((size_t)p_buffer[1] & 0xf) << 8) | p_buffer[2])
+         || !(p_buffer[1] & 0x80) || !(p_buffer[5] & 0x01))
+            break;
+        /* drop the subtables not seen for too long */
+        if (WarmstartStale(p_ws, (int64_t)i_seen))
+            continue;
+        if (!WarmstartRecord(p_ws, i_pid, p_buffer, i_size, (int64_t)i_seen, true))
+            break;
+    }
+
+out:
+    fclose(p_file);
+    return b_ok;
+}
+
+/*****************************************************************************
+ * dvbpsi_warmstart_restore
+ *****************************************************************************/
+size_t dvbpsi_warmstart_restore(dvbpsi_warmstart_t *p_ws, dvbpsi_t *p_dvbpsi, uint16_t i_pid)
+{
+    size_t i_pushed = 0;
+
+    if (!dvbpsi_decoder_present(p_dvbpsi))
+        return 0;
+
+    for (size_t i = 0; i < WS_BUCKETS; i++)
+    {
+        for (const ws_subtable_t *p_subtable = p_ws->pp_buckets[i];
+             p_subtable; p_subtable = p_subtable->p_next)
+        {
+            if (p_subtable->i_pid != i_pid)
+                continue;
+            for (unsigned int j = 0; j < p_subtable->i_sections; j++)
+            {
+                const ws_section_t *p_section = p_subtable->pp_sections[j];
+                if (p_section
+                 && dvbpsi_section_push(p_dvbpsi, p_section->p_data, p_section->i_size))
+                    i_pushed++;
+            }
+        }
+    }
+    return i_pushed;
+}
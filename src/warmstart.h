@@ -0,0 +1,182 @@
+/*****************************************************************************
+ * warmstart.h
+ *
+ * Copyright (C) 2026 VideoLAN
+ * $Id$
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ *****************************************************************************/
+
+/*!
+ * \file <warmstart.h>
+ * \brief Warm start of the PSI/SI decoders from a state file.
+ *
+ * A warm start recorder taps the handles of the PIDs to remember, see
+ * dvbpsi_section_tap_add(), and keeps the sections of the latest version of
+ * each subtable. dvbpsi_warmstart_save() writes them to a compact binary
+ * file.
+ *
+ * At the next start, dvbpsi_warmstart_load() reads the file back and
+ * dvbpsi_warmstart_restore() pushes the sections into the handles once
+ * their decoders are attached. The decoders then decode the tables as if
+ * they had been received, call the table callbacks, and ignore the
+ * following repetitions of the same versions in the stream: a full EIT
+ * schedule is available as soon as the file is read instead of after a
+ * whole carousel cycle.
+ *
+ * Only sections with the section_syntax_indicator set are recorded, and
+ * only those of the current (current_next_indicator 1) version. The
+ * recorder is not thread safe: it must be used from the thread pushing the
+ * packets into the handles it taps.
+ */
+
+#ifndef _DVBPSI_WARMSTART_H_
+#define _DVBPSI_WARMSTART_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*****************************************************************************
+ * dvbpsi_warmstart_t
+ *****************************************************************************/
+/*!
+ * \typedef struct dvbpsi_warmstart_s dvbpsi_warmstart_t
+ * \brief Opaque warm start recorder handle.
+ */
+typedef struct dvbpsi_warmstart_s dvbpsi_warmstart_t;
+
+/*****************************************************************************
+ * dvbpsi_warmstart_new
+ *****************************************************************************/
+/*!
+ * \fn dvbpsi_warmstart_t *dvbpsi_warmstart_new(void)
+ * \brief Create an empty warm start recorder.
+ * \return the recorder, NULL on error
+ */
+dvbpsi_warmstart_t *dvbpsi_warmstart_new(void);
+
+/*****************************************************************************
+ * dvbpsi_warmstart_delete
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_warmstart_delete(dvbpsi_warmstart_t *p_ws)
+ * \brief Detach a recorder from the handles it taps and delete it.
+ * \param p_ws the recorder, may be NULL
+ * \return nothing
+ */
+void dvbpsi_warmstart_delete(dvbpsi_warmstart_t *p_ws);
+
+/*****************************************************************************
+ * dvbpsi_warmstart_attach
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_warmstart_attach(dvbpsi_warmstart_t *p_ws,
+                                    dvbpsi_t *p_dvbpsi, uint16_t i_pid)
+ * \brief Record the sections of a handle through a section tap, the other
+ * taps of the handle are kept. The sections are recorded at the time given
+ * to dvbpsi_warmstart_set_time().
+ * \param p_ws the recorder
+ * \param p_dvbpsi handle decoding the PID
+ * \param i_pid the PID, under which the sections are recorded
+ * \return false on allocation failure
+ */
+bool dvbpsi_warmstart_attach(dvbpsi_warmstart_t *p_ws, dvbpsi_t *p_dvbpsi, uint16_t i_pid);
+
+/*****************************************************************************
+ * dvbpsi_warmstart_detach
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_warmstart_detach(dvbpsi_warmstart_t *p_ws,
+                                    dvbpsi_t *p_dvbpsi)
+ * \brief Stop recording the sections of a handle, for instance before
+ * deleting it. The sections already recorded are kept.
+ * \param p_ws the recorder
+ * \param p_dvbpsi the handle
+ * \return nothing
+ */
+void dvbpsi_warmstart_detach(dvbpsi_warmstart_t *p_ws, dvbpsi_t *p_dvbpsi);
+
+/*****************************************************************************
+ * dvbpsi_warmstart_set_time
+ *****************************************************************************/
+/*!
+ * \fn void dvbpsi_warmstart_set_time(dvbpsi_warmstart_t *p_ws,
+                                      int64_t i_now, int64_t i_max_age)
+ * \brief Set the current time and the age after which a subtable which has
+ * not been seen is stale. Stale subtables are neither saved nor loaded, so
+ * that the services and events which left the stream do not stay in the
+ * file forever.
+ * \param p_ws the recorder
+ * \param i_now the time, in seconds since the Unix epoch
+ * \param i_max_age the age in seconds, 0 to keep all the subtables
+ * \return nothing
+ */
+void dvbpsi_warmstart_set_time(dvbpsi_warmstart_t *p_ws, int64_t i_now, int64_t i_max_age);
+
+/*****************************************************************************
+ * dvbpsi_warmstart_save
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_warmstart_save(dvbpsi_warmstart_t *p_ws,
+                                  const char *psz_file)
+ * \brief Write the recorded sections to a file. The file is written next to
+ * psz_file then renamed, so that it is replaced atomically.
+ * \param p_ws the recorder
+ * \param psz_file path of the file
+ * \return false on I/O error
+ */
+bool dvbpsi_warmstart_save(dvbpsi_warmstart_t *p_ws, const char *psz_file);
+
+/*****************************************************************************
+ * dvbpsi_warmstart_load
+ *****************************************************************************/
+/*!
+ * \fn bool dvbpsi_warmstart_load(dvbpsi_warmstart_t *p_ws,
+                                  const char *psz_file)
+ * \brief Read the sections of a file into a recorder, as if they had been
+ * recorded when they were last seen. The stale subtables, see
+ * dvbpsi_warmstart_set_time(), and the versions older than a subtable
+ * already recorded are dropped.
+ * \param p_ws the recorder
+ * \param psz_file path of the file
+ * \return false when the file cannot be read or is not a complete warm
+ * start file, the sections read until then are kept
+ */
+bool dvbpsi_warmstart_load(dvbpsi_warmstart_t *p_ws, const char *psz_file);
+
+/*****************************************************************************
+ * dvbpsi_warmstart_restore
+ *****************************************************************************/
+/*!
+ * \fn size_t dvbpsi_warmstart_restore(dvbpsi_warmstart_t *p_ws,
+                                       dvbpsi_t *p_dvbpsi, uint16_t i_pid)
+ * \brief Push the recorded sections of a PID into a handle with its
+ * decoders attached, subtable after subtable, see dvbpsi_section_push().
+ * \param p_ws the recorder
+ * \param p_dvbpsi handle decoding the PID
+ * \param i_pid the PID
+ * \return the number of sections pushed
+ */
+size_t dvbpsi_warmstart_restore(dvbpsi_warmstart_t *p_ws, dvbpsi_t *p_dvbpsi, uint16_t i_pid);
+
+#ifdef __cplusplus
+};
+#endif
+
+#else
+#error "Multiple inclusions of warmstart.h"
+#endif